@@ -8,7 +8,11 @@ namespace pnkr::assets {
 
     class AssetImporter {
     public:
-        static std::unique_ptr<ImportedModel> loadGLTF(const std::filesystem::path& path, LoadProgress* progress = nullptr, uint32_t maxTextureSize = 4096);
+        // optimizeMeshes runs GeometryProcessor::optimize, generateLods and
+        // buildMeshlets on every primitive before the model is cached; caches
+        // written without it are reimported.
+        static std::unique_ptr<ImportedModel> loadGLTF(const std::filesystem::path& path, LoadProgress* progress = nullptr,
+                                                       uint32_t maxTextureSize = 4096, bool optimizeMeshes = true);
     };
 
 }
@@ -1,22 +1,59 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace pnkr::assets {
 
+enum class BC7Quality : uint8_t {
+  Fastest,
+  Fast,
+  Normal,
+  High,
+  Max,
+  Count
+};
+
+// Compressonator settings behind each BC7Quality level. modeMask restricts the
+// BC7 modes that are searched; the quality scalar drives the partition search
+// and the early-out error threshold.
+struct BC7QualityPreset {
+  const char *name;
+  float quality;
+  uint8_t modeMask;
+  float minThreshold;
+  float maxThreshold;
+};
+
+const BC7QualityPreset &bc7QualityPreset(BC7Quality quality);
+
 struct BC7EncoderConfig {
   bool perceptual = true;
-  int qualityLevel = 0;
+  BC7Quality quality = BC7Quality::Fast;
   bool useSRGB = false;
 };
 
+// One RGBA8 image, rows tightly packed.
+struct BC7SourceImage {
+  const uint8_t *rgba = nullptr;
+  uint32_t width = 0;
+  uint32_t height = 0;
+};
+
 class BC7Encoder {
 public:
   static bool compress(const uint8_t *srcRGBA, uint32_t width, uint32_t height,
                        BC7EncoderConfig config,
                        std::vector<uint8_t> &outCompressedData);
+
+  // Encodes every image in one TaskSystem dispatch over the block rows of all
+  // of them, so the small tail of a mip chain does not run serially after the
+  // base level. outCompressedData receives one block array per image.
+  static bool compressLevels(std::span<const BC7SourceImage> images,
+                             BC7EncoderConfig config,
+                             std::vector<std::vector<uint8_t>> &outCompressedData);
 };
 
 } // namespace pnkr::assets
@@ -2,7 +2,50 @@
 #include "pnkr/assets/ImportedData.hpp"
 
 namespace pnkr::assets {
+    // Before/after figures of GeometryProcessor::optimize. ACMR is the
+    // average number of vertices transformed per triangle with a 16 entry
+    // FIFO cache; overfetch is vertex bytes fetched over the vertex buffer
+    // size (1.0 is ideal).
+    struct MeshOptimizationStats {
+        uint32_t verticesBefore = 0;
+        uint32_t verticesAfter = 0;
+        uint32_t triangles = 0;
+        float acmrBefore = 0.0F;
+        float acmrAfter = 0.0F;
+        float overfetchBefore = 0.0F;
+        float overfetchAfter = 0.0F;
+        bool optimized = false;
+    };
+
+    struct LodSettings {
+        // Each level aims for this fraction of the previous level's triangles.
+        float reduction = 0.5F;
+        // Largest error a level may have, relative to the primitive's extent.
+        float maxError = 0.05F;
+        // No level goes below this many triangles.
+        uint32_t minTriangles = 64;
+    };
+
     struct GeometryProcessor {
         static void generateTangents(ImportedPrimitive& prim);
+
+        // Deduplicates the vertices of an indexed triangle list, reorders
+        // its triangles for the post-transform cache and overdraw, then
+        // reorders its vertices in first-use order. Morph target deltas
+        // follow their vertices and localIndex is rewritten. Primitives
+        // that aren't triangle lists are left alone.
+        static MeshOptimizationStats optimize(ImportedPrimitive& prim);
+
+        // Builds up to kMaxPrimitiveLods - 1 simplified index lists over the
+        // primitive's vertices. The chain stops early once a level can't
+        // shed enough triangles within settings.maxError. Borders are kept
+        // so neighbouring primitives don't crack apart.
+        static void generateLods(ImportedPrimitive& prim, const LodSettings& settings = {});
+
+        // Splits LOD 0 into clusters of at most kMeshletMaxVertices vertices
+        // and kMeshletMaxTriangles triangles and reorders the indices so each
+        // cluster is a contiguous range. Primitives that fit in one cluster
+        // or have morph targets (their bounds would move) get none.
+        static void buildMeshlets(ImportedPrimitive& prim);
     };
 }
@@ -7,9 +7,15 @@
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
+namespace pnkr::core {
+class MemoryMappedFile;
+}
+
 namespace pnkr::assets {
 
 enum class LoadPriority { Thumbnail = 0, Low, Medium, High, Immediate };
@@ -21,9 +27,61 @@ struct ImportedTexture {
   LoadPriority priority = LoadPriority::Medium;
 };
 
+// Levels of detail per primitive, the full-resolution indices included.
+inline constexpr uint32_t kMaxPrimitiveLods = 4;
+
+// A simplified index list of a primitive. It indexes the primitive's own
+// vertices; error is the object-space distance the simplified surface may
+// deviate from the original.
+struct ImportedLod {
+  uint32_t firstIndex = 0; // into ImportedPrimitive::lodIndexData()
+  uint32_t indexCount = 0;
+  float error = 0.0F;
+};
+
+// Meshlet limits; 124 keeps a cluster's triangles a multiple of four.
+inline constexpr uint32_t kMeshletMaxVertices = 64;
+inline constexpr uint32_t kMeshletMaxTriangles = 124;
+
+// A cluster of LOD 0 triangles with object-space culling bounds. The
+// primitive's indices are stored in meshlet order, so a meshlet is a plain
+// range of them. The cluster faces away from every point p with
+// dot(normalize(coneApex - p), coneAxis) >= coneCutoff.
+struct ImportedMeshlet {
+  uint32_t firstIndex = 0; // into ImportedPrimitive::indexData()
+  uint32_t indexCount = 0;
+  glm::vec3 center{0.0F};
+  float radius = 0.0F;
+  glm::vec3 coneApex{0.0F};
+  glm::vec3 coneAxis{0.0F};
+  float coneCutoff = 1.0F;
+};
+
 struct ImportedPrimitive {
   std::vector<renderer::Vertex> vertices;
   std::vector<uint32_t> indices;
+  // Used instead of vertices/indices when loaded from a .pmesh; they point
+  // into ImportedModel::mappedFile.
+  std::span<const renderer::Vertex> mappedVertices;
+  std::span<const uint32_t> mappedIndices;
+
+  // LOD 1 and coarser, finest first; LOD 0 is indices.
+  std::vector<ImportedLod> lods;
+  std::vector<uint32_t> lodIndices;
+  std::span<const uint32_t> mappedLodIndices;
+
+  // Empty when the primitive is drawn whole; see GeometryProcessor::buildMeshlets.
+  std::vector<ImportedMeshlet> meshlets;
+
+  std::span<const renderer::Vertex> vertexData() const {
+    return vertices.empty() ? mappedVertices : std::span(vertices);
+  }
+  std::span<const uint32_t> indexData() const {
+    return indices.empty() ? mappedIndices : std::span(indices);
+  }
+  std::span<const uint32_t> lodIndexData() const {
+    return lodIndices.empty() ? mappedLodIndices : std::span(lodIndices);
+  }
   uint32_t materialIndex = 0;
   glm::vec3 minPos;
   glm::vec3 maxPos;
@@ -124,5 +182,11 @@ struct ImportedModel {
   std::vector<renderer::scene::Light> lights;
   std::vector<renderer::scene::GltfCamera> cameras;
   std::vector<int> rootNodes;
+  // Every primitive went through GeometryProcessor::optimize,
+  // generateLods and buildMeshlets.
+  bool meshesOptimized = false;
+
+  // Keeps mapped primitive geometry alive; null for freshly parsed models.
+  std::shared_ptr<const core::MemoryMappedFile> mappedFile;
 };
 } // namespace pnkr::assets
@@ -1,7 +1,9 @@
 #pragma once
 #include <atomic>
+#include <cstdint>
 #include <string>
 #include <mutex>
+#include <vector>
 
 namespace pnkr::assets {
 
@@ -14,6 +16,23 @@ enum class LoadStage {
     Complete
 };
 
+// Where the import time of one texture went. Stage times are the work done
+// in each stage; totalMs is wall time from reading the file to writing the
+// KTX2, including time spent waiting for a worker. Textures served from the
+// cache only have readMs.
+struct TextureImportStats {
+    uint32_t textureIndex = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool cacheHit = false;
+    double readMs = 0.0;
+    double decodeMs = 0.0;
+    double resizeMs = 0.0;
+    double encodeMs = 0.0;
+    double writeMs = 0.0;
+    double totalMs = 0.0;
+};
+
 struct LoadProgress {
     std::atomic<LoadStage> currentStage{LoadStage::ReadingFile};
     std::atomic<uint32_t> texturesTotal{0};
@@ -35,6 +54,7 @@ struct LoadProgress {
         {
             std::lock_guard<std::mutex> lock(m_messageMutex);
             m_statusMessage.clear();
+            m_textureStats.clear();
         }
     }
 
@@ -101,9 +121,21 @@ struct LoadProgress {
         return m_statusMessage;
     }
 
+    void addTextureStats(const TextureImportStats& stats) {
+        std::lock_guard<std::mutex> lock(m_messageMutex);
+        m_textureStats.push_back(stats);
+    }
+
+    // In completion order.
+    std::vector<TextureImportStats> getTextureStats() const {
+        std::lock_guard<std::mutex> lock(m_messageMutex);
+        return m_textureStats;
+    }
+
 private:
     mutable std::mutex m_messageMutex;
     std::string m_statusMessage;
+    std::vector<TextureImportStats> m_textureStats;
 };
 
 }
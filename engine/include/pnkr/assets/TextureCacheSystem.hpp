@@ -1,14 +1,31 @@
 #pragma once
+#include <algorithm>
 #include <filesystem>
+#include <span>
 #include <string_view>
 #include <vector>
 #include <cstdint>
 
 namespace pnkr::assets {
+    struct TextureMipChain {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t levels = 0;
+
+        uint32_t levelWidth(uint32_t level) const { return std::max(1U, width >> level); }
+        uint32_t levelHeight(uint32_t level) const { return std::max(1U, height >> level); }
+    };
+
     struct TextureCacheSystem {
-        static std::filesystem::path makeTextureCacheDir(const std::filesystem::path& assetPath);
-        static std::filesystem::path getCachedPath(const std::filesystem::path& cacheDir, std::string_view sourceKey, uint32_t maxSize, bool srgb);
         static bool writeKtx2RGBA8MipmappedAtomic(const std::filesystem::path& outFile, const uint8_t* rgba, int origW, int origH, uint32_t maxSize, bool srgb, uint32_t threadnum);
         static bool writeBytesFileAtomic(const std::filesystem::path& outFile, const std::vector<std::uint8_t>& bytes, uint32_t threadnum);
+
+        // The stages of writeKtx2RGBA8MipmappedAtomic, for callers that run
+        // them as separate tasks. Level 0 is resized from the source image,
+        // every other level from the one above it.
+        static TextureMipChain planMipChain(int origW, int origH, uint32_t maxSize);
+        static void resizeLevel(const uint8_t* src, uint32_t srcW, uint32_t srcH, uint8_t* dst, uint32_t dstW, uint32_t dstH, bool srgb);
+        static bool encodeLevelBC7(const uint8_t* rgba, uint32_t width, uint32_t height, bool srgb, std::vector<uint8_t>& out);
+        static bool writeKtx2BC7LevelsAtomic(const std::filesystem::path& outFile, const TextureMipChain& chain, std::span<const std::vector<uint8_t>> levels, bool srgb, uint32_t threadnum);
     };
 }
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "pnkr/assets/BC7Encoder.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+
+namespace pnkr::assets {
+
+    enum class TextureCacheEncoding : uint8_t {
+        BC7Ktx2,      // TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic
+        RGBA8Ktx2,    // KTXUtils::createKTX2Texture
+        Passthrough   // source bytes were already KTX2
+    };
+
+    // Everything besides the source bytes that changes the encoded output.
+    struct TextureCacheSettings {
+        TextureCacheEncoding encoding = TextureCacheEncoding::BC7Ktx2;
+        bool srgb = false;
+        BC7Quality quality = BC7Quality::Fast;
+        uint32_t maxSize = 0;
+    };
+
+    struct TextureCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inserts = 0;
+        uint64_t evictions = 0;
+        uint64_t entries = 0;
+        uint64_t residentBytes = 0;
+    };
+
+    // Content-addressed KTX2 cache shared by every asset. Files are named by
+    // the 64-bit key, so identical source images are encoded once no matter
+    // how many glTFs reference them or where they live.
+    //
+    // Lookups probe an open-addressed slot table with atomics only and are
+    // safe from any number of texture workers. Keys are never removed from
+    // the table; eviction just zeroes the slot size, and the index written by
+    // flush() only keeps resident entries. Entries touched in the current
+    // session are never evicted because their paths may still be queued for
+    // loading.
+    class TextureDiskCache {
+    public:
+        struct Config {
+            std::filesystem::path directory;
+            uint64_t maxBytes = 4ULL << 30;
+            uint32_t capacity = 1U << 16;   // slots, rounded up to a power of two
+        };
+
+        explicit TextureDiskCache(Config config);
+        ~TextureDiskCache();
+
+        TextureDiskCache(const TextureDiskCache&) = delete;
+        TextureDiskCache& operator=(const TextureDiskCache&) = delete;
+
+        // Process-wide cache under defaultDirectory().
+        static TextureDiskCache& global();
+        static std::filesystem::path defaultDirectory();
+
+        static uint64_t hashContent(std::span<const uint8_t> bytes);
+        static uint64_t makeKey(uint64_t contentHash, const TextureCacheSettings& settings);
+
+        // Path of a resident entry, refreshing its LRU stamp. Entries whose file
+        // has gone missing are dropped and reported as misses.
+        std::optional<std::filesystem::path> lookup(uint64_t key);
+
+        // lookup() for a path previously returned by lookup() or pathFor().
+        bool touch(const std::filesystem::path& cachedFile);
+
+        // Where the file for key is written before calling insert().
+        std::filesystem::path pathFor(uint64_t key) const;
+
+        // Registers the file at pathFor(key) and evicts if over maxBytes.
+        bool insert(uint64_t key);
+
+        void flush();
+        void clear();
+
+        TextureCacheStats stats() const;
+        const std::filesystem::path& directory() const { return m_config.directory; }
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> key{0};
+            std::atomic<uint64_t> sizeBytes{0};   // 0 = not resident
+            std::atomic<int64_t> lastUse{0};      // seconds since epoch
+        };
+
+        Slot* find(uint64_t key) const;
+        Slot* findOrInsert(uint64_t key);
+        void admit(Slot& slot, uint64_t sizeBytes, int64_t lastUse);
+        void loadIndex();
+        void rebuildIndex();
+        void evict();
+
+        Config m_config;
+        std::unique_ptr<Slot[]> m_slots;
+        uint32_t m_mask = 0;
+        int64_t m_sessionStart = 0;
+
+        std::atomic<uint64_t> m_residentBytes{0};
+        std::atomic<uint64_t> m_entries{0};
+        std::atomic<uint64_t> m_hits{0};
+        std::atomic<uint64_t> m_misses{0};
+        std::atomic<uint64_t> m_inserts{0};
+        std::atomic<uint64_t> m_evictions{0};
+        std::atomic<bool> m_dirty{false};
+        std::atomic<bool> m_warnedFull{false};
+        bool m_evictExhausted = false;    // guarded by m_evictMutex
+
+        std::mutex m_evictMutex;
+        std::mutex m_flushMutex;
+    };
+
+}
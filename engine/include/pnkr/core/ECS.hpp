@@ -9,8 +9,16 @@
 #include <atomic>
 #include <span>
 #include <concepts>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <unordered_map>
+#include <utility>
 
 #include "pnkr/core/common.hpp"
+#include "pnkr/core/TaskSystem.hpp"
 
 namespace pnkr::ecs {
 
@@ -47,6 +55,7 @@ namespace pnkr::ecs {
         std::vector<T> dense;
         std::vector<Entity> packed;
         std::vector<std::unique_ptr<size_t[]>> sparsePages;
+        uint64_t m_version = 0;
 
         size_t* getSparseIndex(Entity e) const {
             size_t page = e / kPageSize;
@@ -74,11 +83,20 @@ namespace pnkr::ecs {
         }
 
     public:
+        static constexpr size_t npos = kNullIndex;
+
         void reserve(size_t capacity) {
             dense.reserve(capacity);
             packed.reserve(capacity);
         }
 
+        // Position of e's component in the dense array, or npos. Stable while version()
+        // is unchanged.
+        size_t indexOf(Entity e) const {
+            size_t* idx = getSparseIndex(e);
+            return idx ? *idx : kNullIndex;
+        }
+
         template<typename... Args>
         T& emplace(Entity e, Args&&... args) {
             size_t* idx = ensureSparseIndex(e);
@@ -90,6 +108,7 @@ namespace pnkr::ecs {
             }
 
             *idx = dense.size();
+            ++m_version;
             packed.push_back(e);
             dense.emplace_back(std::forward<Args>(args)...);
             return dense.back();
@@ -113,6 +132,7 @@ namespace pnkr::ecs {
             }
 
             *idx = kNullIndex;
+            ++m_version;
 
             dense.pop_back();
             packed.pop_back();
@@ -139,8 +159,12 @@ namespace pnkr::ecs {
             dense.clear();
             packed.clear();
             sparsePages.clear();
+            ++m_version;
         }
 
+        // Bumped by every insertion and removal, i.e. whenever dense indices may move.
+        uint64_t version() const noexcept { return m_version; }
+
         auto begin() { return dense.begin(); }
         auto end() { return dense.end(); }
         auto begin() const { return dense.begin(); }
@@ -154,6 +178,202 @@ namespace pnkr::ecs {
         std::span<T> getDense() { return dense; }
     };
 
+    enum class StorageMode : uint8_t {
+        SparseSet,
+        Archetype
+    };
+
+    constexpr uint32_t kMaxComponentTypes = 128;
+    using ComponentMask = std::bitset<kMaxComponentTypes>;
+
+    struct ComponentTypeInfo {
+        uint32_t id = 0;
+        uint32_t size = 0; // 0 for empty tag types; they occupy no column memory
+        uint32_t alignment = 1;
+        void (*moveConstruct)(void* dst, void* src) = nullptr;
+        void (*destroy)(void* ptr) = nullptr;
+    };
+
+    template <Component T>
+    const ComponentTypeInfo& getComponentTypeInfo() {
+        static const ComponentTypeInfo info{
+            .id = getComponentTypeID<T>(),
+            .size = std::is_empty_v<T> ? 0U : static_cast<uint32_t>(sizeof(T)),
+            .alignment = static_cast<uint32_t>(alignof(T)),
+            .moveConstruct = [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); },
+            .destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); }
+        };
+        return info;
+    }
+
+    struct ArchetypeChunk {
+        static constexpr size_t kSize = 16 * 1024;
+        alignas(64) std::byte data[kSize];
+    };
+
+    // All entities sharing one component signature. Rows are dense across fixed 16 KB
+    // chunks; each chunk stores the entity ids followed by one SoA column per component.
+    class Archetype {
+    public:
+        static constexpr uint32_t kNoColumn = std::numeric_limits<uint32_t>::max();
+
+        Archetype(const ComponentMask& mask, std::vector<const ComponentTypeInfo*> types);
+        ~Archetype();
+
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        const ComponentMask& mask() const noexcept { return m_mask; }
+        const std::vector<const ComponentTypeInfo*>& types() const noexcept { return m_types; }
+        bool contains(uint32_t typeID) const { return m_mask.test(typeID); }
+
+        size_t size() const noexcept { return m_size; }
+        uint32_t rowsPerChunk() const noexcept { return m_rowsPerChunk; }
+        size_t chunkCount() const noexcept { return m_chunks.size(); }
+
+        uint32_t chunkRowCount(size_t chunk) const {
+            const size_t first = chunk * m_rowsPerChunk;
+            if (first >= m_size) return 0;
+            return static_cast<uint32_t>(std::min<size_t>(m_size - first, m_rowsPerChunk));
+        }
+
+        Entity* chunkEntities(size_t chunk) {
+            return reinterpret_cast<Entity*>(m_chunks[chunk]->data);
+        }
+
+        void* chunkColumn(size_t chunk, uint32_t typeID) {
+            const uint32_t offset = m_columnOffsets[typeID];
+            PNKR_ASSERT(offset != kNoColumn, "Archetype has no column for component");
+            return m_chunks[chunk]->data + offset;
+        }
+
+        Entity entity(uint32_t row) const {
+            return reinterpret_cast<const Entity*>(m_chunks[row / m_rowsPerChunk]->data)[row % m_rowsPerChunk];
+        }
+
+        void* component(uint32_t row, uint32_t typeID) {
+            const uint32_t offset = m_columnOffsets[typeID];
+            PNKR_ASSERT(offset != kNoColumn, "Archetype has no column for component");
+            return m_chunks[row / m_rowsPerChunk]->data + offset +
+                   static_cast<size_t>(row % m_rowsPerChunk) * m_typeSizes[typeID];
+        }
+
+        // Appends a row for e; component storage of the new row is left uninitialized.
+        uint32_t allocateRow(Entity e);
+
+        // Swap-removes a row. Components of the removed row are destroyed unless they were
+        // already moved out. Returns the entity relocated into the row, or kNullEntity.
+        Entity removeRow(uint32_t row, bool destroyComponents);
+
+        void clear();
+
+        Archetype* addEdge(uint32_t typeID) const;
+        Archetype* removeEdge(uint32_t typeID) const;
+        void setAddEdge(uint32_t typeID, Archetype* target) { m_addEdges[typeID] = target; }
+        void setRemoveEdge(uint32_t typeID, Archetype* target) { m_removeEdges[typeID] = target; }
+
+    private:
+        ComponentMask m_mask;
+        std::vector<const ComponentTypeInfo*> m_types;
+        std::array<uint32_t, kMaxComponentTypes> m_columnOffsets{};
+        std::array<uint32_t, kMaxComponentTypes> m_typeSizes{};
+        uint32_t m_rowsPerChunk = 0;
+        size_t m_size = 0;
+        std::vector<std::unique_ptr<ArchetypeChunk>> m_chunks;
+        std::unordered_map<uint32_t, Archetype*> m_addEdges;
+        std::unordered_map<uint32_t, Archetype*> m_removeEdges;
+    };
+
+    class ArchetypeStorage {
+    public:
+        void registerType(const ComponentTypeInfo& info);
+
+        bool has(Entity e, uint32_t typeID) const {
+            if (e >= m_locations.size() || !m_locations[e].archetype) return false;
+            return m_locations[e].archetype->contains(typeID);
+        }
+
+        void* get(Entity e, uint32_t typeID) {
+            PNKR_ASSERT(has(e, typeID), "Entity does not have component");
+            const EntityLocation& loc = m_locations[e];
+            return loc.archetype->component(loc.row, typeID);
+        }
+
+        // Moves e into the archetype extended by typeID and returns uninitialized storage
+        // for the new component. If e already has it, returns the live component and sets existed.
+        void* add(Entity e, uint32_t typeID, bool& existed);
+        void remove(Entity e, uint32_t typeID);
+        void destroy(Entity e);
+        void clear();
+
+        size_t count(uint32_t typeID) const;
+
+        template <typename Func>
+        void forEachChunk(const ComponentMask& required, Func&& func) {
+            for (auto& archetype : m_archetypes) {
+                if (archetype->size() == 0 || (archetype->mask() & required) != required) continue;
+                for (size_t chunk = 0; chunk < archetype->chunkCount(); ++chunk) {
+                    if (archetype->chunkRowCount(chunk) > 0) {
+                        func(*archetype, chunk);
+                    }
+                }
+            }
+        }
+
+        const std::vector<std::unique_ptr<Archetype>>& archetypes() const noexcept { return m_archetypes; }
+
+    private:
+        struct EntityLocation {
+            Archetype* archetype = nullptr;
+            uint32_t row = 0;
+        };
+
+        Archetype* findOrCreate(const ComponentMask& mask);
+        void moveEntity(Entity e, Archetype& target);
+
+        std::vector<std::unique_ptr<Archetype>> m_archetypes;
+        std::unordered_map<ComponentMask, Archetype*> m_byMask;
+        std::vector<EntityLocation> m_locations;
+        std::array<const ComponentTypeInfo*, kMaxComponentTypes> m_typeInfos{};
+    };
+
+    namespace detail {
+        // Tag components carry no data, so every entity shares one instance.
+        template <Component T>
+        T& tagInstance() {
+            static T s_tag{};
+            return s_tag;
+        }
+
+        template <Component T>
+        T* columnBase(Archetype& archetype, size_t chunk) {
+            if constexpr (std::is_empty_v<T>) {
+                return &tagInstance<T>();
+            } else {
+                return static_cast<T*>(archetype.chunkColumn(chunk, getComponentTypeID<T>()));
+            }
+        }
+
+        template <Component T>
+        T& columnAt(T* base, uint32_t row) {
+            if constexpr (std::is_empty_v<T>) {
+                return *base;
+            } else {
+                return base[row];
+            }
+        }
+
+        template <Component... Components, typename Func>
+        void eachInChunk(Archetype& archetype, size_t chunk, Func& func) {
+            const uint32_t count = archetype.chunkRowCount(chunk);
+            const Entity* entities = archetype.chunkEntities(chunk);
+            std::tuple<Components*...> columns{columnBase<Components>(archetype, chunk)...};
+            for (uint32_t row = 0; row < count; ++row) {
+                func(entities[row], columnAt<Components>(std::get<Components*>(columns), row)...);
+            }
+        }
+    }
+
     class Registry;
 
     template <Component... Components>
@@ -166,6 +386,16 @@ namespace pnkr::ecs {
         template <typename Func>
         void each(Func func) const;
 
+        // Splits the driving entity span (or the archetype chunks) across TaskSystem workers.
+        // func must only write to the components it is handed for its own entity; debug builds
+        // report structural changes and mutable access to other component types.
+        template <typename Func>
+        void parallelEach(Func func, uint32_t minRange = 256) const;
+
+        // map(entity, components...) -> T per entity, folded with combine into init.
+        template <typename T, typename MapFunc, typename CombineFunc>
+        T parallelReduce(T init, MapFunc map, CombineFunc combine, uint32_t minRange = 256) const;
+
         struct Iterator {
             Registry& reg;
             std::span<const Entity> entities;
@@ -190,20 +420,52 @@ namespace pnkr::ecs {
 
     private:
         std::span<const Entity> smallestEntities() const;
+        std::span<const Entity> archetypeEntities() const;
+
+        template <typename Func>
+        void parallelDispatch(Func func, uint32_t minRange) const;
+
+        mutable std::vector<Entity> m_archetypeEntities;
     };
 
     class Registry {
     private:
         mutable std::vector<std::unique_ptr<ISparseSet>> componentPools;
+        std::unique_ptr<ArchetypeStorage> archetypeStorage;
         std::vector<Entity> freeEntities;
         Entity entityCounter = 0;
+        StorageMode mode = StorageMode::SparseSet;
 
     public:
+        Registry() = default;
+        explicit Registry(StorageMode storageMode);
+
+        StorageMode storageMode() const noexcept { return mode; }
+
+        ArchetypeStorage& archetypes() {
+            PNKR_ASSERT(archetypeStorage, "Registry is not in archetype storage mode");
+            return *archetypeStorage;
+        }
+
         Entity create();
         void destroy(Entity e);
 
+#ifdef PNKR_DEBUG
+        // Bookkeeping for View::parallelEach: while a parallel pass runs, structural changes and
+        // mutable get<T>() of component types the callback was not handed are reported.
+        void beginParallelAccess(const ComponentMask& writable);
+        void endParallelAccess();
+        void checkStructuralChange() const;
+        void checkWriteAccess(uint32_t typeID) const;
+#endif
+
+        // Pools only exist in StorageMode::SparseSet. Code that indexes dense
+        // pool arrays directly (SceneGraphDOD propagation, the ModelDOD cache
+        // chunks) is sparse set only; everything else should go through
+        // view(), count(), has() and get(), which work in both modes.
         template <Component T>
         SparseSet<T>& getPool() {
+            PNKR_ASSERT(mode == StorageMode::SparseSet, "getPool requires sparse set storage");
             uint32_t typeID = getComponentTypeID<T>();
             if (typeID >= componentPools.size()) {
                 componentPools.resize(typeID + 1);
@@ -216,6 +478,7 @@ namespace pnkr::ecs {
 
         template <Component T>
         const SparseSet<T>& getPool() const {
+            PNKR_ASSERT(mode == StorageMode::SparseSet, "getPool requires sparse set storage");
             uint32_t typeID = getComponentTypeID<T>();
             if (typeID >= componentPools.size() || !componentPools[typeID]) {
                 componentPools.resize(std::max<size_t>(componentPools.size(), typeID + 1));
@@ -228,29 +491,69 @@ namespace pnkr::ecs {
 
         template <Component T, typename... Args>
         T& emplace(Entity e, Args&&... args) {
+#ifdef PNKR_DEBUG
+            checkStructuralChange();
+#endif
+            if (mode == StorageMode::Archetype) {
+                const ComponentTypeInfo& info = getComponentTypeInfo<T>();
+                archetypeStorage->registerType(info);
+                bool existed = false;
+                void* storage = archetypeStorage->add(e, info.id, existed);
+                if constexpr (std::is_empty_v<T>) {
+                    return detail::tagInstance<T>();
+                } else if (existed) {
+                    T& component = *static_cast<T*>(storage);
+                    component = T(std::forward<Args>(args)...);
+                    return component;
+                } else {
+                    return *new (storage) T(std::forward<Args>(args)...);
+                }
+            }
             return getPool<T>().emplace(e, std::forward<Args>(args)...);
         }
 
         template <Component T>
         void remove(Entity e) {
+#ifdef PNKR_DEBUG
+            checkStructuralChange();
+#endif
+            if (mode == StorageMode::Archetype) {
+                archetypeStorage->remove(e, getComponentTypeID<T>());
+                return;
+            }
             getPool<T>().remove(e);
         }
 
         template <Component T>
         bool has(Entity e) const {
             uint32_t typeID = getComponentTypeID<T>();
+            if (mode == StorageMode::Archetype) {
+                return archetypeStorage->has(e, typeID);
+            }
             if (typeID >= componentPools.size() || !componentPools[typeID]) return false;
             return componentPools[typeID]->has(e);
         }
 
         template <Component T>
         T& get(Entity e) {
-            return getPool<T>().get(e);
+#ifdef PNKR_DEBUG
+            checkWriteAccess(getComponentTypeID<T>());
+#endif
+            return fetch<T>(e);
         }
 
         template <Component T>
         const T& get(Entity e) const {
-            return getPool<T>().get(e);
+            return const_cast<Registry*>(this)->fetch<T>(e);
+        }
+
+        // Number of entities owning T, valid in either storage mode.
+        template <Component T>
+        size_t count() const {
+            if (mode == StorageMode::Archetype) {
+                return archetypeStorage->count(getComponentTypeID<T>());
+            }
+            return getPool<T>().size();
         }
 
         template <Component... Args>
@@ -264,12 +567,56 @@ namespace pnkr::ecs {
         }
 
         void clear();
+
+    private:
+        template <Component T>
+        T& fetch(Entity e) {
+            if (mode == StorageMode::Archetype) {
+                if constexpr (std::is_empty_v<T>) {
+                    PNKR_ASSERT(has<T>(e), "Entity does not have component");
+                    return detail::tagInstance<T>();
+                } else {
+                    return *static_cast<T*>(archetypeStorage->get(e, getComponentTypeID<T>()));
+                }
+            }
+            return getPool<T>().get(e);
+        }
+
+#ifdef PNKR_DEBUG
+        uint32_t parallelAccessDepth = 0;
+        ComponentMask parallelWritable;
+#endif
+    };
+
+    // Scopes Registry::beginParallelAccess/endParallelAccess; compiles away outside debug builds.
+    class ParallelAccessScope {
+    public:
+#ifdef PNKR_DEBUG
+        ParallelAccessScope(Registry& reg, const ComponentMask& writable) : m_reg(reg) {
+            m_reg.beginParallelAccess(writable);
+        }
+        ~ParallelAccessScope() { m_reg.endParallelAccess(); }
+
+    private:
+        Registry& m_reg;
+#else
+        ParallelAccessScope(Registry&, const ComponentMask&) {}
+#endif
     };
 
     template <Component... Components>
     template <typename Func>
     void View<Components...>::each(Func func) const {
         if constexpr (sizeof...(Components) == 0) return;
+        if (reg.storageMode() == StorageMode::Archetype) {
+            // Structural changes (emplace/remove) inside func are not allowed in this mode.
+            ComponentMask required;
+            (required.set(getComponentTypeID<Components>()), ...);
+            reg.archetypes().forEachChunk(required, [&](Archetype& archetype, size_t chunk) {
+                detail::eachInChunk<Components...>(archetype, chunk, func);
+            });
+            return;
+        }
         const auto entities = smallestEntities();
         for (Entity entity : entities) {
             if ((reg.has<Components>(entity) && ...)) {
@@ -278,6 +625,86 @@ namespace pnkr::ecs {
         }
     }
 
+    template <Component... Components>
+    template <typename Func>
+    void View<Components...>::parallelDispatch(Func func, uint32_t minRange) const {
+        ComponentMask handed;
+        (handed.set(getComponentTypeID<Components>()), ...);
+        ParallelAccessScope accessScope(reg, handed);
+
+        if (reg.storageMode() == StorageMode::Archetype) {
+            std::vector<std::pair<Archetype*, size_t>> chunks;
+            reg.archetypes().forEachChunk(handed, [&](Archetype& archetype, size_t chunk) {
+                chunks.emplace_back(&archetype, chunk);
+            });
+            core::TaskSystem::parallelFor(
+                util::u32(chunks.size()),
+                [&](enki::TaskSetPartition range, uint32_t threadNum) {
+                    auto bound = [&](Entity entity, Components&... components) {
+                        func(threadNum, entity, components...);
+                    };
+                    for (uint32_t i = range.start; i < range.end; ++i) {
+                        detail::eachInChunk<Components...>(*chunks[i].first, chunks[i].second, bound);
+                    }
+                },
+                1);
+            return;
+        }
+
+        const auto entities = smallestEntities();
+        core::TaskSystem::parallelFor(
+            util::u32(entities.size()),
+            [&](enki::TaskSetPartition range, uint32_t threadNum) {
+                for (uint32_t i = range.start; i < range.end; ++i) {
+                    const Entity entity = entities[i];
+                    if ((reg.has<Components>(entity) && ...)) {
+                        func(threadNum, entity, reg.get<Components>(entity)...);
+                    }
+                }
+            },
+            minRange);
+    }
+
+    template <Component... Components>
+    template <typename Func>
+    void View<Components...>::parallelEach(Func func, uint32_t minRange) const {
+        if constexpr (sizeof...(Components) == 0) return;
+        parallelDispatch([&](uint32_t, Entity entity, Components&... components) {
+            func(entity, components...);
+        }, minRange);
+    }
+
+    template <Component... Components>
+    template <typename T, typename MapFunc, typename CombineFunc>
+    T View<Components...>::parallelReduce(T init, MapFunc map, CombineFunc combine, uint32_t minRange) const {
+        if constexpr (sizeof...(Components) == 0) return init;
+
+        struct alignas(64) Partial {
+            std::optional<T> value;
+        };
+        const uint32_t threadCount = core::TaskSystem::isInitialized()
+            ? core::TaskSystem::scheduler().GetNumTaskThreads() : 1U;
+        std::vector<Partial> partials(threadCount);
+
+        parallelDispatch([&](uint32_t threadNum, Entity entity, Components&... components) {
+            PNKR_ASSERT(threadNum < partials.size(), "Task thread index out of range");
+            auto& slot = partials[threadNum].value;
+            if (slot) {
+                slot = combine(std::move(*slot), map(entity, components...));
+            } else {
+                slot = map(entity, components...);
+            }
+        }, minRange);
+
+        T result = std::move(init);
+        for (auto& partial : partials) {
+            if (partial.value) {
+                result = combine(std::move(result), std::move(*partial.value));
+            }
+        }
+        return result;
+    }
+
     template <Component... Components>
     std::span<const Entity> View<Components...>::smallestEntities() const {
         using First = std::tuple_element_t<0, std::tuple<Components...>>;
@@ -298,6 +725,18 @@ namespace pnkr::ecs {
         return smallest;
     }
 
+    template <Component... Components>
+    std::span<const Entity> View<Components...>::archetypeEntities() const {
+        m_archetypeEntities.clear();
+        ComponentMask required;
+        (required.set(getComponentTypeID<Components>()), ...);
+        reg.archetypes().forEachChunk(required, [&](Archetype& archetype, size_t chunk) {
+            const Entity* entities = archetype.chunkEntities(chunk);
+            m_archetypeEntities.insert(m_archetypeEntities.end(), entities, entities + archetype.chunkRowCount(chunk));
+        });
+        return m_archetypeEntities;
+    }
+
     template <Component... Components>
     void View<Components...>::Iterator::validate() {
         while (index < entities.size() && !(reg.has<Components>(entities[index]) && ...)) {
@@ -307,11 +746,17 @@ namespace pnkr::ecs {
 
     template <Component... Components>
     typename View<Components...>::Iterator View<Components...>::begin() {
+        if (reg.storageMode() == StorageMode::Archetype) {
+            return Iterator(reg, archetypeEntities(), 0);
+        }
         return Iterator(reg, smallestEntities(), 0);
     }
 
     template <Component... Components>
     typename View<Components...>::Iterator View<Components...>::end() {
+        if (reg.storageMode() == StorageMode::Archetype) {
+            return Iterator(reg, m_archetypeEntities, m_archetypeEntities.size());
+        }
         auto entities = smallestEntities();
         return Iterator(reg, entities, entities.size());
     }
@@ -321,11 +766,20 @@ namespace pnkr::ecs {
         Registry& m_registry;
         std::vector<Entity> m_toCreate;
         std::vector<Entity> m_toDestroy;
+        std::vector<std::pair<Entity, void (*)(Registry&, Entity)>> m_toRemove;
 
     public:
         EntityCommandBuffer(Registry& reg);
         Entity create();
         void destroy(Entity e);
+
+        // Defers removing T from e until execute(), so it can be queued from inside View::each.
+        template <Component T>
+        void remove(Entity e) {
+            m_toRemove.emplace_back(e, [](Registry& reg, Entity entity) { reg.remove<T>(entity); });
+        }
+
+        void reserve(size_t count) { m_toRemove.reserve(count); }
         void execute();
     };
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define PNKR_HAS_IO_URING 1
+#else
+#define PNKR_HAS_IO_URING 0
+#endif
+
+namespace pnkr::core {
+
+enum class FileReaderBackend : uint8_t {
+  // io_uring where the kernel allows it, otherwise Blocking.
+  Auto,
+  // pread on the calling thread; concurrency comes from the I/O task pool.
+  Blocking,
+  // One io_uring submission per batch; Linux only.
+  IoUring,
+};
+
+struct FileReadRequest {
+  // Must stay valid until read() returns.
+  std::string_view path;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  uint8_t *dst = nullptr;
+  // Bytes read, or a negative errno.
+  int64_t result = 0;
+};
+
+struct FileReaderStats {
+  uint64_t bytesRead = 0;
+  uint64_t requests = 0;
+  uint64_t batches = 0;
+  uint64_t filesOpened = 0;
+  // Every open, read, submit and close made on behalf of callers.
+  uint64_t syscalls = 0;
+  uint64_t readNs = 0;
+};
+
+// Reads byte ranges of files into caller memory, many ranges per call.
+// Requests that share a path open the file once per batch. read() blocks
+// until every request has completed and is safe to call from any thread.
+class FileReader {
+public:
+  virtual ~FileReader() = default;
+
+  static std::unique_ptr<FileReader>
+  create(FileReaderBackend backend = FileReaderBackend::Auto,
+         uint32_t queueDepth = 64);
+
+  virtual FileReaderBackend backend() const = 0;
+  const char *name() const;
+
+  // Lets reads that land inside buffer skip the kernel's per-request page
+  // pinning. Replaces any earlier registration; the memory must outlive it.
+  // Returns false when the backend has no use for it.
+  virtual bool registerBuffer(std::span<uint8_t> buffer) {
+    (void)buffer;
+    return false;
+  }
+
+  // Returns true when every request read its full size.
+  bool read(std::span<FileReadRequest> requests);
+
+  FileReaderStats stats() const;
+
+protected:
+  struct BatchCounters {
+    uint64_t filesOpened = 0;
+    uint64_t syscalls = 0;
+  };
+
+  // Fills every request's result.
+  virtual void readBatch(std::span<FileReadRequest> requests,
+                         BatchCounters &counters) = 0;
+
+private:
+  std::atomic<uint64_t> m_bytesRead{0};
+  std::atomic<uint64_t> m_requests{0};
+  std::atomic<uint64_t> m_batches{0};
+  std::atomic<uint64_t> m_filesOpened{0};
+  std::atomic<uint64_t> m_syscalls{0};
+  std::atomic<uint64_t> m_readNs{0};
+};
+
+} // namespace pnkr::core
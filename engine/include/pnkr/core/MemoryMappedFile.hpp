@@ -23,6 +23,9 @@ public:
   [[nodiscard]] size_t size() const { return m_mSize; }
   [[nodiscard]] bool isValid() const { return m_mData != nullptr; }
 
+  // Asks the OS to start paging in [offset, offset + size) ahead of use.
+  void prefetch(size_t offset, size_t size) const;
+
 private:
   const uint8_t *m_mData = nullptr;
   size_t m_mSize = 0;
@@ -22,6 +22,8 @@ namespace pnkr::renderer
 {
     class RHIRenderer;
     class AsyncLoader;
+    class TextureStreamingScheduler;
+    class UploadPacer;
 
     struct RawTextureParams {
         const unsigned char* data;
@@ -62,6 +64,10 @@ namespace pnkr::renderer
         void unloadAllTextures();
 
         GPUStreamingStatistics getStreamingStatistics() const;
+        // Null when textures load synchronously.
+        TextureStreamingScheduler* textureStreaming();
+        UploadPacer* uploadPacing();
+        AsyncLoader* asyncLoader() { return m_asyncLoader.get(); }
 
         void syncToGPU();
         std::vector<TextureHandle> consumeCompletedTextures();
@@ -72,9 +78,6 @@ namespace pnkr::renderer
         friend class FallbackTextureFactory;
 
     private:
-        std::filesystem::path getCachePath(const std::vector<uint8_t>& encoded, bool srgb);
-        static size_t computeHash(const std::vector<uint8_t> &data);
-
         static rhi::Format resolveKTXFormat(rhi::Format format, bool srgb);
         rhi::TextureDescriptor createKTXDescriptor(const KTXTextureData& ktxData, bool srgb, uint32_t baseMip = 0) const;
         static bool uploadKTXData(rhi::RHITexture *texture,
@@ -87,8 +90,6 @@ namespace pnkr::renderer
         RHIRenderer* m_renderer = nullptr;
         std::unique_ptr<AsyncLoader> m_asyncLoader;
 
-        std::filesystem::path m_cacheDirectory;
-
         TextureCache m_textureCache;
         FallbackTextureFactory m_fallbackFactory;
 
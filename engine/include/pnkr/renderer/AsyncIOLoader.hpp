@@ -1,5 +1,6 @@
 #pragma once
 
+#include "pnkr/core/FileReader.hpp"
 #include "pnkr/renderer/AsyncLoaderTypes.hpp"
 #include <memory>
 #include <vector>
@@ -26,6 +27,10 @@ public:
     // For waiting on shutdown
     void waitAll();
 
+    // Batched reader shared with the transfer queue for streamed mip ranges
+    core::FileReader& fileReader() { return *m_fileReader; }
+    const core::FileReader& fileReader() const { return *m_fileReader; }
+
 private:
     void processFileRequest(const LoadRequest& req);
 
@@ -33,6 +38,7 @@ private:
 
     RHIRenderer* m_renderer = nullptr;
     ResourceRequestManager* m_requestManager = nullptr;
+    std::unique_ptr<core::FileReader> m_fileReader;
 
     std::vector<std::unique_ptr<FileLoadTask>> m_loadingTasks;
     mutable std::mutex m_taskMutex;
@@ -5,6 +5,7 @@
 #include "pnkr/renderer/AsyncIOLoader.hpp"
 #include "pnkr/renderer/GPUTransferQueue.hpp"
 #include "pnkr/renderer/AsyncLoaderStagingManager.hpp"
+#include "pnkr/renderer/TextureStreamingScheduler.hpp"
 #include "pnkr/renderer/profiling/gpu_profiler.hpp"
 #include "pnkr/rhi/rhi_buffer.hpp"
 #include <memory>
@@ -54,7 +55,21 @@ public:
   bool isValidHandle(TextureHandle handle) const;
   GPUStreamingStatistics getStatistics() const;
 
+  // Writes regions of long-lived textures from the transfer thread. Results
+  // come back once the GPU has finished the copies.
+  void uploadTextureRegions(std::vector<TextureRegionUpload> uploads);
+  std::vector<TextureRegionUploadResult> consumeCompletedRegionUploads();
+
+  // Mip residency of every texture requested through this loader.
+  TextureStreamingScheduler &streaming() { return m_streaming; }
+  const TextureStreamingScheduler &streaming() const { return m_streaming; }
+
+  // Sizing of the upload batches recorded by the transfer thread.
+  UploadPacer &uploadPacing() { return m_gpuTransfer->pacer(); }
+  const UploadPacer &uploadPacing() const { return m_gpuTransfer->pacer(); }
+
 private:
+  void scheduleStreaming();
 
 
   RHIRenderer *m_renderer = nullptr;
@@ -65,6 +80,9 @@ private:
   std::unique_ptr<AsyncLoaderStagingManager> m_stagingManager;
   std::shared_ptr<AsyncIOLoader> m_ioLoader;
   std::unique_ptr<GPUTransferQueue> m_gpuTransfer;
+
+  TextureStreamingScheduler m_streaming;
+  std::vector<TextureStreamRequest> m_streamRequests;
   
   // High-level state that doesn't fit into components perfectly yet, 
   // or needs to be accessible by the facade.
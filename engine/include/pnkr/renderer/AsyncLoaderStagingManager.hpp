@@ -1,13 +1,11 @@
 #pragma once
 
 #include "pnkr/renderer/RHIResourceManager.hpp"
+#include "pnkr/renderer/StagingRingAllocator.hpp"
 #include "pnkr/rhi/rhi_buffer.hpp"
 #include <array>
 #include <atomic>
-#include <condition_variable>
 #include <memory>
-#include <mutex>
-#include <vector>
 
 namespace pnkr::renderer {
 
@@ -21,8 +19,10 @@ struct StagingBuffer {
   std::atomic<bool> inUse{false};
 };
 
-struct RingBufferPage {
-  uint64_t lastBatchId = 0;
+struct StagingStatistics {
+  StagingRingStats ring;
+  uint64_t temporaryAllocations = 0;
+  uint64_t failedTemporaryAllocations = 0;
 };
 
 class AsyncLoaderStagingManager {
@@ -36,6 +36,7 @@ public:
   operator=(const AsyncLoaderStagingManager &) = delete;
 
   static constexpr uint64_t kDefaultRingBufferSize = 32 * 1024 * 1024;
+  static constexpr uint64_t kPageSize = 2 * 1024 * 1024;
 
   uint8_t *ringBufferMapped() const { return m_ringBufferMapped; }
   rhi::RHIBuffer *ringBuffer() const { return m_ringBuffer; }
@@ -62,40 +63,36 @@ public:
 
   uint64_t getUsedBytes() const;
 
+  StagingStatistics getStatistics() const;
+
   void cleanup();
 
   bool isInitialized() const { return m_initialized; }
 
 private:
-  bool waitForPages(uint32_t startPage, uint32_t endPage,
-                    uint64_t currentBatchId, bool wait);
+  enum class TemporarySlot : uint8_t { Empty, Creating, Ready };
 
   RHIResourceManager *m_resourceManager = nullptr;
   bool m_initialized = false;
   
-  static constexpr uint64_t kPageSize = 2 * 1024 * 1024;
   static constexpr uint32_t kMaxTemporaryBuffers = 16;
 
   // Configuration
   uint64_t m_ringBufferSize = kDefaultRingBufferSize;
-  uint32_t m_totalPages = 0;
 
   BufferPtr m_ringBufferHandle;
   rhi::RHIBuffer *m_ringBuffer = nullptr;
   uint8_t *m_ringBufferMapped = nullptr;
 
-  std::vector<RingBufferPage> m_pages;
-  uint64_t m_head = 0;
-
-  std::atomic<uint64_t> m_nextBatchId{1};
-  std::atomic<uint64_t> m_completedBatchId{0};
-
-  std::mutex m_batchMutex;
-  std::condition_variable m_batchCv;
+  StagingRingAllocator m_ring;
 
+  // Oversized uploads. A slot's buffer is only touched after the slot is
+  // observed Ready; creating one claims the slot with a compare-exchange.
   std::array<std::unique_ptr<StagingBuffer>, kMaxTemporaryBuffers>
       m_temporaryBuffers;
-  mutable std::mutex m_temporaryMutex;
-  mutable std::mutex m_ringMutex;
+  std::array<std::atomic<TemporarySlot>, kMaxTemporaryBuffers>
+      m_temporarySlots{};
+  std::atomic<uint64_t> m_temporaryAllocations{0};
+  std::atomic<uint64_t> m_failedTemporaryAllocations{0};
 };
 } // namespace pnkr::renderer
@@ -65,4 +65,35 @@ struct UploadRequest {
 // Ensure UploadRequest is noexcept move constructible
 static_assert(std::is_nothrow_move_constructible_v<UploadRequest>);
 
+// A rectangle of a long-lived sampled texture, such as a virtual texture
+// tile or page table, written by the transfer thread. The source is either
+// bytes in memory or rowCount rows of rowBytes read from path, rowPitch
+// apart. Rows are packed in staging, so region.bufferOffset is ignored.
+struct TextureRegionUpload {
+  rhi::RHITexture *target = nullptr;
+  // Layout of target before the copy; it is left in ShaderReadOnly.
+  rhi::ResourceLayout layout = rhi::ResourceLayout::ShaderReadOnly;
+  rhi::BufferTextureCopyRegion region;
+
+  std::vector<uint8_t> data;
+
+  std::string path;
+  uint64_t fileOffset = 0;
+  uint64_t rowBytes = 0;
+  uint64_t rowPitch = 0;
+  uint32_t rowCount = 0;
+
+  // Reported back through TextureRegionUploadResult.
+  uint64_t key = 0;
+
+  uint64_t size() const {
+    return data.empty() ? rowBytes * rowCount : data.size();
+  }
+};
+
+struct TextureRegionUploadResult {
+  uint64_t key = 0;
+  bool success = false;
+};
+
 } // namespace pnkr::renderer
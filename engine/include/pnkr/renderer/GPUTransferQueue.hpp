@@ -1,7 +1,11 @@
 #pragma once
 
+#include "pnkr/core/FileReader.hpp"
 #include "pnkr/renderer/AsyncLoaderTypes.hpp"
 #include "pnkr/renderer/AsyncLoaderStagingManager.hpp"
+#include "pnkr/renderer/TextureStreamer.hpp"
+#include "pnkr/renderer/UploadPacer.hpp"
+#include "pnkr/renderer/ZstdLevelStream.hpp"
 #include "pnkr/rhi/rhi_command_buffer.hpp"
 #include "pnkr/rhi/rhi_sync.hpp"
 #include "pnkr/rhi/rhi_device.hpp"
@@ -11,6 +15,7 @@
 #include <mutex>
 #include <array>
 #include <condition_variable>
+#include <deque>
 #include <span>
 
 namespace pnkr::renderer {
@@ -20,7 +25,8 @@ class ResourceRequestManager;
 
 class GPUTransferQueue {
 public:
-    GPUTransferQueue(RHIRenderer& renderer, ResourceRequestManager& requestManager, AsyncLoaderStagingManager& stagingManager);
+    GPUTransferQueue(RHIRenderer& renderer, ResourceRequestManager& requestManager,
+                     AsyncLoaderStagingManager& stagingManager, core::FileReader& fileReader);
     ~GPUTransferQueue();
 
     void startThread();
@@ -29,6 +35,11 @@ public:
     // Notify thread that new work is available
     void notifyWorkAvailable();
 
+    // Region uploads are recorded in order, on the graphics queue, in the
+    // next batch that has staging room for them.
+    void enqueueRegionUploads(std::vector<TextureRegionUpload> uploads);
+    std::vector<TextureRegionUploadResult> consumeCompletedRegionUploads();
+
     // Accessors for metrics
     uint64_t getBytesUploadedTotal() const { return m_bytesUploadedTotal.load(std::memory_order_relaxed); }
     uint32_t getBatchesSubmitted() const { return m_batchesSubmitted.load(std::memory_order_relaxed); }
@@ -37,6 +48,13 @@ public:
 
     // Per frame accumulators (reset by owner)
     uint64_t getAndResetBytesThisFrame() { return m_bytesThisFrameAccumulator.exchange(0, std::memory_order_relaxed); }
+    uint64_t getBytesInflatedTotal() const { return m_bytesInflatedTotal.load(std::memory_order_relaxed); }
+    uint64_t getCopyCommandsTotal() const { return m_copyCommandsTotal.load(std::memory_order_relaxed); }
+    uint64_t getCopyRegionsTotal() const { return m_copyRegionsTotal.load(std::memory_order_relaxed); }
+
+    // Batch sizing; the owner calls beginFrame() on it once per frame.
+    UploadPacer& pacer() { return m_pacer; }
+    const UploadPacer& pacer() const { return m_pacer; }
     
 private:
     void transferLoop();
@@ -46,22 +64,37 @@ private:
                    rhi::RHIBuffer* srcBuffer, std::span<uint8_t> stagingBuffer,
                    uint64_t& stagingOffset);
     
+    // Inflates a zstd-supercompressed region into staging, page by page
+    bool inflateRegion(const UploadRequest& req, const CopyRegionPlan& plan,
+                       std::span<uint8_t> stagingBuffer, uint64_t offset);
+
+    // Reads and records pending region uploads into the batch's graphics
+    // list. Returns false when nothing was recorded.
+    bool recordRegionUploads(uint32_t slot, rhi::RHICommandList* cmd);
+    bool hasRegionUploads();
+
     // Helper to check validity of texture handle
     bool isValidHandle(TextureHandle handle) const;
 
     RHIRenderer* m_renderer = nullptr;
     ResourceRequestManager* m_requestManager = nullptr;
     AsyncLoaderStagingManager* m_stagingManager = nullptr;
+    core::FileReader* m_fileReader = nullptr;
+    std::vector<core::FileReadRequest> m_fileReads;
+    ZstdLevelStream m_levelStream;
+    UploadPacer m_pacer;
+    // Copy regions of the job being recorded, issued as one command.
+    std::vector<rhi::BufferTextureCopyRegion> m_copyRegions;
 
     static constexpr uint32_t kInFlight = 3;
     static constexpr uint64_t kLargeAssetThreshold = 128 * 1024 * 1024;
-    static constexpr uint64_t kMaxUploadBytesPerFrame = 128 * 1024 * 1024;
-    static constexpr uint32_t kMaxUploadJobsPerFrame = 128;
+    static constexpr uint64_t kMaxRegionBytesPerBatch = 16 * 1024 * 1024;
 
     struct InFlightBatch {
         std::vector<UploadRequest> jobs;
         std::vector<StagingBuffer*> tempStaging;
         std::vector<std::pair<uint64_t, uint64_t>> ringBufferRanges;
+        std::vector<TextureRegionUploadResult> regionResults;
         uint64_t batchId = 0;
     };
     std::array<InFlightBatch, kInFlight> m_inFlightBatches;
@@ -81,12 +114,19 @@ private:
     std::condition_variable m_transferCv;
     std::mutex m_transferMutex;
 
+    std::mutex m_regionMutex;
+    std::deque<TextureRegionUpload> m_regionUploads;
+    std::vector<TextureRegionUploadResult> m_completedRegionUploads;
+
     // Metrics
     std::atomic<uint64_t> m_bytesUploadedTotal{0};
     std::atomic<uint32_t> m_batchesSubmitted{0};
     std::atomic<uint64_t> m_transferActiveNs{0};
     std::atomic<uint64_t> m_transferTotalNs{0};
     std::atomic<uint64_t> m_bytesThisFrameAccumulator{0};
+    std::atomic<uint64_t> m_bytesInflatedTotal{0};
+    std::atomic<uint64_t> m_copyCommandsTotal{0};
+    std::atomic<uint64_t> m_copyRegionsTotal{0};
 };
 
 } // namespace pnkr::renderer
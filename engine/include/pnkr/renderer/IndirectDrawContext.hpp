@@ -4,8 +4,17 @@
 #include "pnkr/renderer/UploadSlice.hpp"
 #include "pnkr/renderer/scene/GLTFUnifiedDOD.hpp"
 
+#include <vector>
+
 namespace pnkr::renderer {
 
+// One skinning dispatch: poses the model's vertices with the palette at
+// jointOffset in GlobalJointBuffer into copy vertexSlot of the skinned buffer.
+struct SkinningDispatch {
+    uint32_t jointOffset = 0;
+    uint32_t vertexSlot = 0;
+};
+
 struct IndirectDrawContext {
     UploadSlice cameraDataSlice;
     UploadSlice sceneDataSlice;
@@ -22,6 +31,9 @@ struct IndirectDrawContext {
     uint64_t shadowDataAddr = 0;
     uint64_t instanceXformAddr = 0;
     uint64_t skinningMeshXformAddr = 0;
+    uint64_t skinnedSlotStride = 0;
+    uint32_t skinnedVertexCount = 0;
+    std::vector<SkinningDispatch> skinningDispatches;
 
     uint32_t lightCount = 0;
     uint32_t visibleMeshCount = 0;
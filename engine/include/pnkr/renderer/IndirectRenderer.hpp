@@ -8,26 +8,32 @@
 #include "pnkr/renderer/debug/DebugLayer.hpp"
 #include "pnkr/renderer/RenderResourceManager.h"
 #include "pnkr/renderer/RenderSettings.hpp"
+#include "pnkr/renderer/geometry/FrustumCull.hpp"
+#include "pnkr/renderer/geometry/OcclusionCull.hpp"
 #include "pnkr/renderer/FrameManager.hpp"
 #include "pnkr/renderer/passes/IRenderPass.hpp"
 #include "pnkr/renderer/framegraph/FrameGraph.hpp"
 #include "pnkr/renderer/gpu_shared/SceneShared.h"
 #include "pnkr/renderer/material/GlobalMaterialHeap.hpp"
 #include "pnkr/renderer/skinning/GlobalJointBuffer.hpp"
+#include "pnkr/renderer/scene/GlobalInstanceBuffer.hpp"
 #include "pnkr/renderer/IndirectDrawContext.hpp"
 #include "pnkr/renderer/ShaderHotReloader.hpp"
 #include "pnkr/renderer/scene/SpriteSystem.hpp"
 
+#include <array>
 #include <memory>
 #include <vector>
 #include <span>
 #include <functional>
+#include <utility>
 
 namespace pnkr::renderer {
 
     namespace physics { class ClothSystem; }
     class EnvironmentProcessor;
 
+    class AnimationInstancer;
     class GlobalResourcePool;
     class SceneUniformProvider;
     class RenderPipeline;
@@ -71,12 +77,25 @@ namespace pnkr::renderer {
         glm::mat4 getShadowProj() const;
         TextureHandle getSSAOTexture() const { return m_resources.ssaoOutput; }
         uint32_t getVisibleMeshCount() const { return m_visibleMeshCount; }
+        uint32_t getTransformNodesTouched() const { return m_transformNodesTouched; }
+        const geometry::OcclusionStats& getOcclusionStats() const { return m_occlusionCuller.stats(); }
+        // Main view draws and triangles per selected LOD in the last frame.
+        const std::array<uint32_t, assets::kMaxPrimitiveLods>& getLodDraws() const { return m_lodDraws; }
+        const std::array<uint64_t, assets::kMaxPrimitiveLods>& getLodTriangles() const { return m_lodTriangles; }
 
         GlobalMaterialHeap& getMaterialHeap() { return m_materialHeap; }
         const GlobalMaterialHeap& getMaterialHeap() const { return m_materialHeap; }
 
         GlobalJointBuffer& getJointBuffer() { return m_jointBuffer; }
         const GlobalJointBuffer& getJointBuffer() const { return m_jointBuffer; }
+        // Uploads the instancer's shared palettes each frame and points the
+        // SkinnedMeshRenderer of every linked instance at its palette. The
+        // instancer must outlive the renderer or be reset to nullptr.
+        void setAnimationInstancer(AnimationInstancer* instancer) { m_animationInstancer = instancer; }
+
+        const InstanceUploadStats& getInstanceUploadStats() const { return m_instanceBuffer.stats(); }
+        // Re-uploads every instance next frame, for edits that bypass the dirty tags.
+        void invalidateInstances() { m_instanceBuffer.invalidate(); }
 
         physics::ClothSystem* getClothSystem() { return m_clothSystem.get(); }
         ShaderHotReloader* getHotReloader() { return m_hotReloader.get(); }
@@ -86,7 +105,7 @@ namespace pnkr::renderer {
         void setSkybox(TextureHandle skybox, bool flipY = false);
 
         static void dispatchSkinning(rhi::RHICommandList *cmd);
-        TransientAllocation updateGlobalTransforms();
+        uint64_t updateGlobalTransforms(rhi::RHICommandList* cmd);
         void uploadEnvironmentData();
  
     private:
@@ -94,8 +113,11 @@ namespace pnkr::renderer {
         void processCompletedTextures();
 
         void updateMorphTargets(rhi::RHICommandList* cmd);
+        void bindInstancedSkins(rhi::RHICommandList* cmd, IndirectDrawContext& ctx);
         void updateLightsAndShadows(IndirectDrawContext& ctx);
         void buildDrawLists(IndirectDrawContext& ctx, const scene::Camera& camera);
+        void cullOccluded();
+        void reportTextureUsage(const scene::Camera& camera, uint32_t height);
 
         static void calculateFrustumPlanes(const glm::mat4& viewProj, glm::vec4(&outPlanes)[6]);
 
@@ -135,13 +157,27 @@ namespace pnkr::renderer {
 
         GlobalMaterialHeap m_materialHeap;
         GlobalJointBuffer m_jointBuffer;
+        GlobalInstanceBuffer m_instanceBuffer;
+        AnimationInstancer* m_animationInstancer = nullptr;
 
         scene::Skybox m_skybox;
         TextureHandle m_sourceSkyboxHandle = INVALID_TEXTURE_HANDLE;
         TextureHandle m_convertedSkyboxHandle = INVALID_TEXTURE_HANDLE;
         bool m_skyboxFlipY = false;
 
+        geometry::FrustumCuller m_frustumCuller;
+        std::vector<ecs::Entity> m_visibleEntities;
+        std::vector<uint8_t> m_debugVisibleSlots;
+        geometry::OcclusionCuller m_occlusionCuller;
+        std::vector<std::pair<float, ecs::Entity>> m_occluderCandidates;
+        std::vector<scene::BoundingBox> m_occludeeBoxes;
+        std::vector<ecs::Entity> m_streamingEntities;
+        std::vector<float> m_materialScreenSizes;
+        std::vector<std::pair<TextureHandle, float>> m_textureScreenSizes;
         uint32_t m_visibleMeshCount = 0;
+        std::array<uint32_t, assets::kMaxPrimitiveLods> m_lodDraws{};
+        std::array<uint64_t, assets::kMaxPrimitiveLods> m_lodTriangles{};
+        uint32_t m_transformNodesTouched = 0;
         uint32_t m_width = 0;
         uint32_t m_height = 0;
         float m_dt = 0.016f;
@@ -153,6 +189,7 @@ namespace pnkr::renderer {
         bool m_hasAsyncComputeWork = false;
 
         glm::mat4 m_cullingViewProj{1.0f};
+        glm::vec3 m_cullingCameraPos{0.0f};
 
     };
 }
@@ -118,6 +118,22 @@ namespace pnkr::renderer
         float skyboxRotation = 0.0f;
         bool drawWireframe = false;
         CullingMode cullingMode = CullingMode::CPU;
+        // CPU culling walks the scene BVH instead of testing every box.
+        bool bvhCulling = true;
+        // CPU culling also rasterizes the largest frustum survivors into a
+        // small depth buffer and drops what they hide.
+        bool occlusionCulling = true;
+        uint32_t maxOccluders = 32;
+        // Report the on-screen size of each visible material's textures so
+        // async-loaded textures stream the mip they need.
+        bool textureStreaming = true;
+        // Draw the coarsest LOD whose simplification error projects to at
+        // most lodErrorPixels, on the CPU and again in GPU culling.
+        bool lodSelection = true;
+        float lodErrorPixels = 1.0f;
+        // GPU culling splits LOD 0 opaque draws into meshlets and culls each
+        // against the frustum and its normal cone.
+        bool clusterCulling = true;
         bool freezeCulling = false;
         bool drawDebugBounds = false;
         bool enableExposureReadback = false;
@@ -20,6 +20,10 @@ public:
     LoadRequest popFileRequest();
     uint32_t getPendingFileCount() const;
 
+    // Re-orders pending file requests: higher LoadPriority first, then higher
+    // score. Stable, so equal requests keep their arrival order.
+    void reorderFileRequests(const std::function<float(const LoadRequest&)>& score);
+
     // Upload Queue Management
     void enqueueLoaded(UploadRequest&& req);
     std::optional<UploadRequest> dequeueLoaded();
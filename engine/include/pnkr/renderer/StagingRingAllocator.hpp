@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace pnkr::renderer {
+
+struct StagingRingStats {
+  uint64_t reservations = 0;
+  uint64_t failedReservations = 0;
+  uint64_t bytesReserved = 0;
+  // Bytes skipped to align a reservation or to avoid straddling the end of
+  // the ring.
+  uint64_t alignmentBytes = 0;
+  uint64_t wrapBytes = 0;
+  // Reservations that had to wait for an older batch to retire its pages.
+  uint64_t stalls = 0;
+  uint64_t stallNs = 0;
+  // Lost compare-exchange races on the head, i.e. producer contention.
+  uint64_t headRetries = 0;
+};
+
+// Lock-free ring of fixed-size pages shared by any number of producers.
+// Reservations advance a virtual head with a compare-exchange and never
+// straddle the end of the ring. Each page carries a fence: the newest batch
+// that wrote to it. A page can be reused on the next lap only once every
+// batch up to that fence has completed. Batches may complete in any order
+// as long as no more than kCompletionWindow are outstanding.
+class StagingRingAllocator {
+public:
+  static constexpr uint64_t kAlignment = 256;
+  static constexpr std::chrono::milliseconds kMaxStall{100};
+  static constexpr uint32_t kCompletionWindow = 1024;
+
+  StagingRingAllocator(uint64_t size, uint64_t pageSize);
+
+  StagingRingAllocator(const StagingRingAllocator &) = delete;
+  StagingRingAllocator &operator=(const StagingRingAllocator &) = delete;
+
+  // Batch ids start at 1 and every id handed out must be completed.
+  uint64_t beginBatch() {
+    return m_nextBatchId.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Returns the ring offset of `size` bytes owned by `batchId` until the
+  // batch completes. With `wait`, blocks up to kMaxStall for older batches to
+  // retire. Fails without waiting when the range is held by `batchId` itself
+  // or a later batch, which can only be freed once `batchId` is submitted.
+  std::optional<uint64_t> reserve(uint64_t size, uint64_t batchId, bool wait);
+
+  void markPages(uint64_t offset, uint64_t size, uint64_t batchId);
+  void notifyBatchComplete(uint64_t batchId);
+
+  uint64_t completedBatchId() const {
+    return m_completedBatchId.load(std::memory_order_acquire);
+  }
+  uint64_t size() const { return m_size; }
+  uint64_t pageSize() const { return m_pageSize; }
+  uint32_t pageCount() const { return m_pageCount; }
+
+  // Bytes in pages still referenced by a batch in flight.
+  uint64_t usedBytes() const;
+  StagingRingStats stats() const;
+
+private:
+  struct Page {
+    std::atomic<uint64_t> fence{0};
+    // Ring lap that owns the page (high bits) and reservations of that lap
+    // that have not published their fence yet (low bits).
+    std::atomic<uint64_t> claim{0};
+  };
+
+  enum class PageState { Free, Busy, OwnBatch, Lapped };
+
+  PageState pageState(uint64_t virtualPage, uint64_t claim,
+                      uint64_t batchId) const;
+  bool claimPage(uint64_t virtualPage, uint64_t batchId, bool wait,
+                 std::chrono::steady_clock::time_point &stallStart);
+
+  uint64_t m_size = 0;
+  uint64_t m_pageSize = 0;
+  uint32_t m_pageCount = 0;
+  std::unique_ptr<Page[]> m_pages;
+
+  alignas(64) std::atomic<uint64_t> m_head{0};
+  alignas(64) std::atomic<uint64_t> m_nextBatchId{1};
+  // Every batch up to this id has completed.
+  alignas(64) std::atomic<uint64_t> m_completedBatchId{0};
+  std::array<std::atomic<uint64_t>, kCompletionWindow> m_completedSlots{};
+
+  std::atomic<uint64_t> m_reservations{0};
+  std::atomic<uint64_t> m_failedReservations{0};
+  std::atomic<uint64_t> m_bytesReserved{0};
+  std::atomic<uint64_t> m_alignmentBytes{0};
+  std::atomic<uint64_t> m_wrapBytes{0};
+  std::atomic<uint64_t> m_stalls{0};
+  std::atomic<uint64_t> m_stallNs{0};
+  std::atomic<uint64_t> m_headRetries{0};
+};
+
+} // namespace pnkr::renderer
@@ -26,6 +26,11 @@ namespace pnkr::renderer
         rhi::BufferTextureCopyRegion m_region;
         uint32_t m_rowsCopied;
         bool m_isMipFinished;
+        // Zstd-supercompressed KTX2: the bytes are inflated from level
+        // m_sourceLevel starting at m_levelOffset of the inflated level.
+        bool m_inflateLevel = false;
+        uint32_t m_sourceLevel = 0;
+        uint64_t m_levelOffset = 0;
     };
 
     class TextureStreamer
@@ -46,7 +51,6 @@ namespace pnkr::renderer
         // Helper to determine initial mip level based on direction
         static int32_t getInitialMipLevel(const KTXTextureData& textureData, uint32_t baseMip, UploadDirection direction);
 
-    private:
         struct BlockInfo
         {
             uint32_t m_width;
@@ -55,6 +59,8 @@ namespace pnkr::renderer
         };
 
         static BlockInfo getFormatBlockInfo(rhi::Format format);
+
+    private:
         static void getBlockDim(rhi::Format format, uint32_t &w, uint32_t &h, uint32_t &bytes);
     };
 }
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "pnkr/assets/ImportedData.hpp"
+#include "pnkr/core/Handle.h"
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pnkr::renderer {
+
+struct TextureStreamingSettings {
+  // Estimated bytes of every streamed texture at its target mip.
+  uint64_t residencyBudgetBytes = 512ULL * 1024 * 1024;
+  // Added to the mip chosen from screen size; positive values trade
+  // sharpness for memory.
+  float mipBias = 0.0f;
+  // The budget never demotes a texture below this many texels on its long side.
+  uint32_t minResidentSize = 64;
+  // Mip changes issued per update(); the rest wait for later frames.
+  uint32_t maxRequestsPerUpdate = 8;
+};
+
+struct TextureStreamRequest {
+  TextureHandle handle;
+  std::string path;
+  bool srgb = true;
+  assets::LoadPriority priority = assets::LoadPriority::Medium;
+  uint32_t baseMip = 0;
+};
+
+struct TextureStreamingStats {
+  uint64_t residentBytes = 0;
+  uint64_t targetBytes = 0;
+  uint64_t budgetBytes = 0;
+  uint32_t textures = 0;
+  uint32_t streamableTextures = 0;
+  // Textures the last update() pushed below their screen-size mip.
+  uint32_t demotedTextures = 0;
+  uint32_t requestsInFlight = 0;
+};
+
+// Decides which mip of each async-loaded texture should be resident. Every
+// frame the renderer reports the largest on-screen size of the surfaces that
+// sample each texture; update() turns that into a target mip, demotes the
+// least recently visible textures while the estimate is over budget, and
+// hands back the mip changes to load, most important first. priorityOf()
+// orders the pending file reads the same way.
+//
+// Only KTX textures with a stored mip chain can stream: they reload from the
+// file starting at the target mip. Everything else stays at its first upload
+// and only counts towards the resident total. Thread-safe.
+class TextureStreamingScheduler {
+public:
+  static constexpr uint32_t kNoMip = ~0U;
+
+  void setSettings(const TextureStreamingSettings &settings);
+  TextureStreamingSettings settings() const;
+
+  // Idempotent; later calls refresh the path, colour space and priority.
+  void registerTexture(TextureHandle handle, const std::string &path, bool srgb,
+                       assets::LoadPriority priority);
+  void unregisterTexture(TextureHandle handle);
+  void clear();
+
+  // An upload of handle finished. The size, mip count and byte total
+  // describe the source file; baseMip is the first source mip uploaded.
+  void onUploaded(TextureHandle handle, uint32_t width, uint32_t height,
+                  uint32_t mipLevels, uint64_t fullBytes, uint32_t baseMip,
+                  bool streamable);
+  // Returns true when an earlier upload is still resident, so the failed
+  // reload should leave the texture alone.
+  bool onFailed(TextureHandle handle);
+
+  // Largest on-screen extent, in pixels, of any surface sampling the texture.
+  void reportScreenSizes(std::span<const std::pair<TextureHandle, float>> sizes);
+
+  // Appends the mip changes to start this frame.
+  void update(std::vector<TextureStreamRequest> &requests);
+
+  // Sort key for pending loads; larger loads sooner.
+  float priorityOf(TextureHandle handle) const;
+
+  uint32_t targetMip(TextureHandle handle) const;
+  uint32_t residentMip(TextureHandle handle) const;
+  TextureStreamingStats stats() const;
+
+private:
+  struct Entry {
+    std::string path;
+    bool srgb = true;
+    assets::LoadPriority priority = assets::LoadPriority::Medium;
+
+    bool loaded = false;
+    bool streamable = false;
+    uint32_t size = 0;
+    uint32_t mipLevels = 1;
+    uint64_t fullBytes = 0;
+
+    uint32_t residentMip = 0;
+    uint32_t targetMip = 0;
+    uint32_t pendingMip = kNoMip;
+
+    float screenSize = 0.0f;
+    float lastScreenSize = 0.0f;
+    uint64_t lastVisibleFrame = 0;
+  };
+
+  static uint64_t bytesAt(const Entry &entry, uint32_t mip);
+  float priorityLocked(const Entry &entry) const;
+
+  mutable std::mutex m_mutex;
+  std::unordered_map<TextureHandle, Entry> m_entries;
+  TextureStreamingSettings m_settings;
+  uint64_t m_frame = 0;
+  uint32_t m_demoted = 0;
+  uint64_t m_targetBytes = 0;
+};
+
+} // namespace pnkr::renderer
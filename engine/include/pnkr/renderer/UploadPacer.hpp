@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace pnkr::renderer {
+
+enum class UploadPacingMode {
+  // Every batch may upload up to maxBytesPerFrame, regardless of frames.
+  Fixed,
+  // The bytes uploaded per frame follow the measured transfer throughput so
+  // the transfer thread spends about targetFrameOverheadMs on each frame.
+  Adaptive
+};
+
+struct UploadPacingSettings {
+  UploadPacingMode mode = UploadPacingMode::Fixed;
+  double targetFrameOverheadMs = 2.0;
+  uint64_t minBytesPerFrame = 1ULL * 1024 * 1024;
+  uint64_t maxBytesPerFrame = 128ULL * 1024 * 1024;
+  // In Adaptive mode, uploads at or below smallUploadBytes only count
+  // against maxSmallJobsPerBatch, so storms of tiny textures share a
+  // submission. Fixed mode counts every upload against maxJobsPerBatch.
+  uint32_t maxJobsPerBatch = 128;
+  uint32_t maxSmallJobsPerBatch = 1024;
+  uint64_t smallUploadBytes = 64 * 1024;
+};
+
+struct UploadPacingStats {
+  uint64_t frameBudgetBytes = 0;
+  uint64_t bytesThisFrame = 0;
+  double throughputMBps = 0.0;
+  // Batches deferred to the next frame because the budget was spent.
+  uint64_t deferredBatches = 0;
+};
+
+// Sizes upload batches for GPUTransferQueue. The renderer calls beginFrame()
+// once per frame; the transfer thread asks for the byte budget before each
+// batch and reports how long recording it took. A frame with no beginFrame()
+// for kMaxFrameInterval counts as elapsed, so uploads never stall when
+// nothing is presenting. Thread-safe.
+class UploadPacer {
+public:
+  static constexpr std::chrono::milliseconds kMaxFrameInterval{50};
+
+  void setSettings(const UploadPacingSettings &settings);
+  UploadPacingSettings settings() const;
+
+  void beginFrame();
+
+  // Bytes the next batch may upload; zero until the next frame when the
+  // adaptive budget of this frame is spent.
+  uint64_t batchBudget();
+  void onBatchRecorded(uint64_t bytes, uint64_t activeNs);
+
+  UploadPacingStats stats() const;
+
+private:
+  uint64_t frameBudgetLocked() const;
+  void rollFrameLocked();
+
+  mutable std::mutex m_mutex;
+  UploadPacingSettings m_settings;
+  std::atomic<uint64_t> m_frame{0};
+  uint64_t m_seenFrame = 0;
+  std::chrono::steady_clock::time_point m_frameStart{};
+  uint64_t m_bytesThisFrame = 0;
+  // Exponential moving average of bytes recorded per nanosecond.
+  double m_bytesPerNs = 0.0;
+  uint64_t m_deferredBatches = 0;
+};
+
+} // namespace pnkr::renderer
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace pnkr::renderer {
+
+// One tile of one mip of a virtual texture. Packs into the 32-bit entries
+// the shaders write to the feedback buffer (see VirtualTexture.slang).
+struct VirtualTileId {
+  static constexpr uint32_t kMaxTextures = 255;
+  static constexpr uint32_t kMaxMips = 16;
+  static constexpr uint32_t kMaxTilesPerAxis = 1024;
+
+  uint32_t texture = 0;
+  uint32_t mip = 0;
+  uint32_t x = 0;
+  uint32_t y = 0;
+
+  uint32_t pack() const {
+    return x | (y << 10) | (mip << 20) | (texture << 24);
+  }
+  static VirtualTileId unpack(uint32_t packed) {
+    return {.texture = packed >> 24,
+            .mip = (packed >> 20) & 0xF,
+            .x = packed & 0x3FF,
+            .y = (packed >> 10) & 0x3FF};
+  }
+  bool operator==(const VirtualTileId &) const = default;
+};
+
+// CPU copy of the page table of one virtual texture: an entry per tile of
+// every mip, pointing at the atlas slot of the finest resident tile that
+// covers it. Entries are RGBA8 texels for the page table texture: slot in
+// R (low byte) and G (high byte), resident mip in B and A = 255 when any
+// ancestor is resident, 0 otherwise.
+class VirtualPageTable {
+public:
+  static constexpr uint32_t kNoSlot = ~0U;
+
+  VirtualPageTable(uint32_t tilesX, uint32_t tilesY, uint32_t mipLevels);
+
+  uint32_t mipLevels() const { return static_cast<uint32_t>(m_mips.size()); }
+  uint32_t tilesX(uint32_t mip) const { return m_mips[mip].tilesX; }
+  uint32_t tilesY(uint32_t mip) const { return m_mips[mip].tilesY; }
+  bool contains(uint32_t mip, uint32_t x, uint32_t y) const;
+
+  // The tile's own slot, or kNoSlot when the tile itself isn't resident.
+  uint32_t slot(uint32_t mip, uint32_t x, uint32_t y) const;
+  uint32_t entry(uint32_t mip, uint32_t x, uint32_t y) const;
+  std::span<const uint32_t> entries(uint32_t mip) const {
+    return m_mips[mip].entries;
+  }
+
+  // Updates the tile and every finer tile that falls back to it.
+  void map(uint32_t mip, uint32_t x, uint32_t y, uint32_t slot);
+  void unmap(uint32_t mip, uint32_t x, uint32_t y);
+
+  static uint32_t makeEntry(uint32_t slot, uint32_t mip) {
+    return (slot & 0xFFFF) | (mip << 16) | (0xFFU << 24);
+  }
+
+  // Set by map/unmap until the GPU copy is refreshed.
+  bool dirty() const { return m_dirty; }
+  void clearDirty() { m_dirty = false; }
+  void markDirty() { m_dirty = true; }
+
+private:
+  struct Mip {
+    uint32_t tilesX = 1;
+    uint32_t tilesY = 1;
+    std::vector<uint32_t> slots;
+    std::vector<uint32_t> entries;
+  };
+
+  void propagate(uint32_t mip, uint32_t x, uint32_t y, uint32_t fallback);
+
+  std::vector<Mip> m_mips;
+  bool m_dirty = true;
+};
+
+// Physical tile slots of the atlas, reused least recently used first.
+// Slots are touched by the frame that requested them. A pinned slot, or one
+// touched within the last framesInFlight frames, is never evicted: a frame
+// the GPU hasn't finished may still sample it.
+class VirtualTileCache {
+public:
+  static constexpr uint32_t kNoTile = ~0U;
+
+  explicit VirtualTileCache(uint32_t slotCount, uint32_t framesInFlight = 1);
+
+  uint32_t capacity() const { return static_cast<uint32_t>(m_slots.size()); }
+  uint32_t usedSlots() const { return m_used; }
+  uint64_t evictions() const { return m_evictions; }
+
+  // Takes a free slot for tile, or evicts the least recently used one and
+  // reports its tile through evictedTile. Returns nullopt when every slot is
+  // pinned or was touched by a frame still in flight.
+  std::optional<uint32_t> allocate(uint32_t tile, uint64_t frame,
+                                   uint32_t &evictedTile);
+  void touch(uint32_t slot, uint64_t frame);
+  void setPinned(uint32_t slot, bool pinned);
+  void release(uint32_t slot);
+
+  uint32_t tileAt(uint32_t slot) const { return m_slots[slot].tile; }
+  bool isPinned(uint32_t slot) const { return m_slots[slot].pinned; }
+
+private:
+  struct Slot {
+    uint32_t tile = kNoTile;
+    uint32_t prev = kNoTile;
+    uint32_t next = kNoTile;
+    uint64_t lastUsed = 0;
+    bool pinned = false;
+  };
+
+  void unlink(uint32_t slot);
+  void pushMostRecent(uint32_t slot);
+
+  std::vector<Slot> m_slots;
+  std::vector<uint32_t> m_free;
+  // Occupied slots, least recently used at the head.
+  uint32_t m_head = kNoTile;
+  uint32_t m_tail = kNoTile;
+  uint32_t m_used = 0;
+  uint32_t m_framesInFlight = 1;
+  uint64_t m_evictions = 0;
+};
+
+} // namespace pnkr::renderer
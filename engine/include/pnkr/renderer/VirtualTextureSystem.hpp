@@ -0,0 +1,141 @@
+#pragma once
+
+#include "pnkr/renderer/AsyncLoaderTypes.hpp"
+#include "pnkr/renderer/VirtualTexture.hpp"
+#include "pnkr/renderer/gpu_shared/VirtualTextureShared.h"
+#include "pnkr/renderer/renderer_config.hpp"
+#include "pnkr/rhi/rhi_types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pnkr::renderer {
+class RHIRenderer;
+class AsyncLoader;
+
+struct VirtualTextureSettings {
+  // Tile and border sizes in texels; both must be multiples of the block
+  // size of the texture format.
+  uint32_t tileSize = 128;
+  uint32_t tileBorder = 4;
+  // The atlas holds atlasTilesPerSide^2 tiles shared by every virtual
+  // texture.
+  uint32_t atlasTilesPerSide = 32;
+  uint32_t maxUploadsPerFrame = 32;
+  uint32_t feedbackCapacity = 16384;
+};
+
+struct VirtualTextureStats {
+  uint32_t textures = 0;
+  uint32_t residentTiles = 0;
+  uint32_t atlasSlots = 0;
+  uint32_t pendingTiles = 0;
+  uint64_t requestedTiles = 0;
+  uint64_t uploadedTiles = 0;
+  uint64_t evictions = 0;
+  // Requests left for a later frame because every slot was in use.
+  uint64_t deferredTiles = 0;
+};
+
+using VirtualTextureId = uint32_t;
+
+// Streams tiles of very large KTX2 textures into a shared atlas on demand.
+// Shaders sample through VirtualTexture.slang, which looks tiles up in a
+// per-texture page table and writes the tiles it wanted into a feedback
+// buffer. update() reads that feedback a few frames later, keeps the tiles
+// in an LRU cache and uploads missing ones through the AsyncLoader.
+//
+// Textures must be uncompressed-on-disk KTX2 2D textures with power of two
+// dimensions of at least tileSize and a mip chain. The coarsest mip is
+// always resident, so every lookup has a fallback.
+class VirtualTextureSystem {
+public:
+  static constexpr VirtualTextureId kInvalidId = ~0U;
+
+  VirtualTextureSystem(RHIRenderer &renderer, AsyncLoader &loader,
+                       const VirtualTextureSettings &settings = {});
+  ~VirtualTextureSystem();
+
+  VirtualTextureSystem(const VirtualTextureSystem &) = delete;
+  VirtualTextureSystem &operator=(const VirtualTextureSystem &) = delete;
+
+  VirtualTextureId registerTexture(const std::filesystem::path &path);
+
+  // Once per frame after RHIRenderer::beginFrame, before recording passes
+  // that sample virtual textures.
+  void update();
+
+  // Shader parameters for the current frame.
+  gpu::VirtualTextureGPU gpuData(VirtualTextureId id) const;
+  TextureHandle pageTable(VirtualTextureId id) const;
+  TextureHandle atlas() const { return m_atlas.handle(); }
+  BufferHandle feedbackBuffer() const;
+
+  const VirtualTextureSettings &settings() const { return m_settings; }
+  VirtualTextureStats stats() const;
+
+private:
+  struct Texture {
+    std::string path;
+    rhi::Format format = rhi::Format::Undefined;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint64_t> mipFileOffsets;
+    VirtualPageTable pageTable;
+    TexturePtr pageTableTexture;
+    // Set once a page table copy has completed; until then uploads start
+    // from an undefined layout and only one is in flight.
+    bool pageTableInitialized = false;
+    bool pageTableInitPending = false;
+  };
+
+  uint32_t slotSize() const {
+    return m_settings.tileSize + 2 * m_settings.tileBorder;
+  }
+  uint32_t feedbackSlot() const;
+
+  void processCompletedUploads();
+  void processFeedback(std::vector<uint32_t> &missing);
+  void requestTile(uint32_t packed, std::vector<uint32_t> &missing);
+  void uploadTiles(const std::vector<uint32_t> &missing, size_t maxTiles);
+  bool isRoot(uint32_t packed) const;
+  TextureRegionUpload makeTileUpload(const Texture &texture,
+                                     const VirtualTileId &tile,
+                                     uint32_t slot) const;
+
+  RHIRenderer &m_renderer;
+  AsyncLoader &m_loader;
+  VirtualTextureSettings m_settings;
+
+  std::vector<Texture> m_textures;
+  VirtualTileCache m_cache;
+  TexturePtr m_atlas;
+  rhi::Format m_atlasFormat = rhi::Format::Undefined;
+  // Same as Texture::pageTableInitialized, for the atlas.
+  bool m_atlasInitialized = false;
+  bool m_atlasInitPending = false;
+
+  // Packed tile id -> slot of uploads not completed yet.
+  std::unordered_map<uint32_t, uint32_t> m_pending;
+  std::vector<uint32_t> m_roots;
+  // Roots that failed or were deferred; update() queues them again first.
+  std::vector<uint32_t> m_rootRetries;
+
+  // Written by the frame using the same frame-in-flight slot, so it is
+  // complete by the time update() reads it again.
+  std::array<BufferPtr, RendererConfig::kFramesInFlight> m_feedback;
+  std::array<uint32_t *, RendererConfig::kFramesInFlight> m_feedbackData{};
+
+  // Counts update() calls; the cache keeps slots touched by the last
+  // kFramesInFlight of them, which frames on the GPU may still sample.
+  uint64_t m_frame = 1;
+  uint64_t m_requestedTiles = 0;
+  uint64_t m_uploadedTiles = 0;
+  uint64_t m_deferredTiles = 0;
+};
+
+} // namespace pnkr::renderer
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "pnkr/core/FileReader.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ZSTD_DCtx_s;
+
+namespace pnkr::renderer {
+
+// Inflates zstd-supercompressed KTX2 mip levels straight into caller memory
+// (the staging ring), reading the compressed level from disk in small chunks
+// so no full-size intermediate is ever allocated. Reads are expected to walk
+// a level front to back; switching level or seeking backwards restarts the
+// level from its first byte.
+class ZstdLevelStream {
+public:
+  static constexpr uint64_t kInputChunkSize = 256 * 1024;
+
+  explicit ZstdLevelStream(core::FileReader &reader);
+  ~ZstdLevelStream();
+
+  ZstdLevelStream(const ZstdLevelStream &) = delete;
+  ZstdLevelStream &operator=(const ZstdLevelStream &) = delete;
+
+  struct Level {
+    std::string_view path;
+    uint32_t index = 0;
+    uint64_t fileOffset = 0;
+    uint64_t compressedSize = 0;
+  };
+
+  // Writes uncompressed bytes [levelOffset, levelOffset + dst.size()) of the
+  // level into dst. Returns false on read or decode errors.
+  bool read(const Level &level, uint64_t levelOffset, std::span<uint8_t> dst);
+
+  uint64_t bytesInflated() const { return m_bytesInflated; }
+  uint32_t levelRestarts() const { return m_levelRestarts; }
+
+private:
+  void restart(const Level &level);
+  bool fillInput();
+  bool inflate(uint8_t *dst, uint64_t size);
+
+  core::FileReader *m_reader = nullptr;
+  ZSTD_DCtx_s *m_ctx = nullptr;
+
+  std::string m_path;
+  uint32_t m_level = 0;
+  uint64_t m_fileOffset = 0;
+  uint64_t m_compressedSize = 0;
+  bool m_valid = false;
+
+  uint64_t m_inputConsumed = 0;
+  uint64_t m_position = 0;
+  std::vector<uint8_t> m_input;
+  size_t m_inputPos = 0;
+  size_t m_inputSize = 0;
+  std::vector<uint8_t> m_scratch;
+
+  uint64_t m_bytesInflated = 0;
+  uint32_t m_levelRestarts = 0;
+};
+
+} // namespace pnkr::renderer
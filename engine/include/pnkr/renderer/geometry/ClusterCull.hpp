@@ -0,0 +1,40 @@
+#pragma once
+
+#include "pnkr/renderer/geometry/Frustum.hpp"
+#include "pnkr/renderer/gpu_shared/CullingShared.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pnkr::renderer::geometry {
+
+    // A meshlet's culling bounds in world space.
+    struct ClusterBounds {
+        glm::vec3 center{0.0f};
+        float radius = 0.0f;
+        glm::vec3 coneApex{0.0f};
+        glm::vec3 coneAxis{0.0f};
+        float coneCutoff = 1.0f;
+    };
+
+    // Longest basis vector of m, for scaling radii and LOD errors.
+    float maxScale(const glm::mat4& m);
+
+    // True when m is a rotation, uniform scale and translation without a
+    // mirror: the transforms under which normal cones stay valid.
+    bool preservesNormalCones(const glm::mat4& m, float tolerance = 1e-3f);
+
+    ClusterBounds transformCluster(const gpu::MeshletGPU& meshlet, const glm::mat4& world);
+
+    bool isSphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius);
+
+    // Every triangle of the cluster faces away from cameraPos.
+    bool isClusterBackfacing(const ClusterBounds& cluster, const glm::vec3& cameraPos);
+
+    // CPU reference of clusterMain in culling.slang: appends to visible the
+    // index of each meshlet that is inside the frustum and, with
+    // coneCulling, not facing away from cameraPos.
+    void cullClusters(const Frustum& frustum, const glm::vec3& cameraPos,
+                      std::span<const gpu::MeshletGPU> meshlets, const glm::mat4& world,
+                      bool coneCulling, std::vector<uint32_t>& visible);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "pnkr/renderer/geometry/Frustum.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pnkr::renderer::geometry {
+
+    // Boxes per kernel iteration: one AVX2 register, or two SSE/NEON registers.
+    inline constexpr uint32_t kCullBatch = 8;
+
+    // World AABBs as center/extent float arrays. Storage is padded to a
+    // multiple of kCullBatch; padding lanes hold an empty box that every plane
+    // rejects, so the kernel has no scalar tail.
+    class AabbSoA {
+    public:
+        uint32_t size() const noexcept { return m_count; }
+        uint32_t paddedSize() const noexcept { return static_cast<uint32_t>(m_cx.size()); }
+
+        void resize(uint32_t count);
+        void clear() noexcept;
+
+        // Invalid boxes (see BoundingBox::isValid) are stored empty and never pass.
+        void set(uint32_t index, const scene::BoundingBox& box);
+        scene::BoundingBox get(uint32_t index) const;
+
+        // Moves the last box into index and shrinks by one.
+        void swapRemove(uint32_t index);
+
+        const float* cx() const noexcept { return m_cx.data(); }
+        const float* cy() const noexcept { return m_cy.data(); }
+        const float* cz() const noexcept { return m_cz.data(); }
+        const float* ex() const noexcept { return m_ex.data(); }
+        const float* ey() const noexcept { return m_ey.data(); }
+        const float* ez() const noexcept { return m_ez.data(); }
+
+    private:
+        void setEmpty(uint32_t index);
+
+        std::vector<float> m_cx, m_cy, m_cz;
+        std::vector<float> m_ex, m_ey, m_ez;
+        uint32_t m_count = 0;
+    };
+
+    // Appends to visible the indices in [first, last) whose box is not fully
+    // behind any frustum plane. first must be a multiple of kCullBatch. This is
+    // the plane test only; unlike isBoxInFrustum it skips the frustum-corner
+    // refinement, so large boxes near a frustum edge may be kept.
+    void cullBoxes(const Frustum& frustum, const AabbSoA& boxes, uint32_t first,
+                   uint32_t last, std::vector<uint32_t>& visible);
+
+    // Same test without SIMD, for reference and benchmarking.
+    void cullBoxesScalar(const Frustum& frustum, const AabbSoA& boxes,
+                         uint32_t first, uint32_t last,
+                         std::vector<uint32_t>& visible);
+
+    // Runs cullBoxes over the whole array on the task system and keeps the
+    // result compact and ascending. Scratch memory is reused between calls.
+    class FrustumCuller {
+    public:
+        std::span<const uint32_t> cull(const Frustum& frustum, const AabbSoA& boxes);
+
+        std::span<const uint32_t> visible() const noexcept {
+            return {m_visible.data(), m_visibleCount};
+        }
+
+    private:
+        std::vector<uint32_t> m_visible;
+        std::vector<uint32_t> m_chunkCounts;
+        uint32_t m_visibleCount = 0;
+    };
+}
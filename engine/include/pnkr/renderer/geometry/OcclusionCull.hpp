@@ -0,0 +1,98 @@
+#pragma once
+
+#include "pnkr/renderer/scene/Bounds.hpp"
+#include <glm/mat4x4.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pnkr::renderer::geometry {
+
+    // Depth tiles of the occlusion buffer. Each keeps the farthest occluder
+    // depth of its pixels so most occludee tests stop at tile level.
+    inline constexpr uint32_t kOcclusionTileWidth = 8;
+    inline constexpr uint32_t kOcclusionTileHeight = 4;
+
+    struct OcclusionStats {
+        uint32_t occluders = 0;
+        uint32_t occluderTriangles = 0;
+        // Triangles that reached the rasterizer after near-plane and size rejection.
+        uint32_t rasterizedTriangles = 0;
+        uint32_t testedBoxes = 0;
+        uint32_t occludedBoxes = 0;
+    };
+
+    // Software occlusion culling on a small depth buffer. Occluder triangles
+    // are rasterized with 4-wide SIMD spans, one band of tile rows per task,
+    // keeping the nearest depth per pixel. Boxes are then tested against the
+    // tile maxima and, where a tile is not conclusive, against its pixels.
+    //
+    // Depth is conservative: occluder depth is the farthest value the
+    // triangle's plane takes over each pixel, occluder triangles that cross
+    // the near plane are dropped, and a box that crosses the near plane is
+    // always visible. Coverage is not: a pixel counts as covered when its
+    // centre is strictly inside a triangle, as in hardware rasterization, so
+    // an occluder's silhouette may grow by up to half a buffer pixel. A box
+    // can therefore be culled while a sliver of it, under half a pixel of
+    // this buffer wide, is still visible past the occluder's edge. Biasing
+    // the edges inward to avoid that would also open holes along every
+    // shared edge of a mesh. Depth is the [0, 1] range of the engine's
+    // projections.
+    class OcclusionCuller {
+    public:
+        // Rounded up to whole tiles.
+        void resize(uint32_t width, uint32_t height);
+        uint32_t width() const noexcept { return m_width; }
+        uint32_t height() const noexcept { return m_height; }
+
+        // Clears depth and the occluder queue for a new view.
+        void begin(const glm::mat4& viewProj);
+
+        // Queues an indexed triangle list with object-space positions.
+        void addOccluder(std::span<const glm::vec3> positions,
+                         std::span<const uint32_t> indices, const glm::mat4& world);
+
+        // Rasterizes everything queued since begin().
+        void rasterize();
+
+        bool isOccluded(const scene::BoundingBox& box) const;
+
+        // Tests every box on the task system and returns the indices of the
+        // ones that stay visible, ascending. Invalid boxes count as visible.
+        std::span<const uint32_t> cull(std::span<const scene::BoundingBox> boxes);
+
+        // Nearest occluder depth per pixel, row-major; 1.0 where nothing was drawn.
+        std::span<const float> depth() const noexcept { return m_depth; }
+
+        const OcclusionStats& stats() const noexcept { return m_stats; }
+
+    private:
+        struct Triangle {
+            float x[3], y[3];
+            // Depth plane z = zx * x + zy * y + z0, evaluated at pixel centres.
+            float zx, zy, z0;
+            float zMax;
+            int32_t minY, maxY;
+        };
+
+        void rasterizeBand(uint32_t band);
+        void rasterizeTriangle(const Triangle& tri, int32_t rowBegin, int32_t rowEnd);
+
+        glm::mat4 m_viewProj{1.0f};
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        uint32_t m_tilesX = 0;
+        uint32_t m_tilesY = 0;
+
+        std::vector<float> m_depth;
+        std::vector<float> m_tileMax;
+        std::vector<glm::vec4> m_clip;
+        std::vector<uint32_t> m_indices;
+        std::vector<Triangle> m_triangles;
+        std::vector<std::vector<uint32_t>> m_bands;
+        std::vector<uint32_t> m_visible;
+        std::vector<uint32_t> m_chunkCounts;
+        uint32_t m_visibleCount = 0;
+        OcclusionStats m_stats;
+    };
+}
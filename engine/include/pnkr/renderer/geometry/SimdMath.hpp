@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PNKR_SIMD_SSE 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PNKR_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace pnkr::renderer::geometry {
+
+    // out = a * b for column-major glm matrices. out may alias a or b.
+    inline void mulMat4(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+#if defined(PNKR_SIMD_SSE)
+        const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+        const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+        const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+        const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+        __m128 cols[4];
+        for (int c = 0; c < 4; ++c) {
+            const float* bc = &b[c][0];
+#if defined(__FMA__)
+            __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+            r = _mm_fmadd_ps(a1, _mm_set1_ps(bc[1]), r);
+            r = _mm_fmadd_ps(a2, _mm_set1_ps(bc[2]), r);
+            r = _mm_fmadd_ps(a3, _mm_set1_ps(bc[3]), r);
+#else
+            __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+            r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+            r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+            r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+#endif
+            cols[c] = r;
+        }
+        for (int c = 0; c < 4; ++c) {
+            _mm_storeu_ps(&out[c][0], cols[c]);
+        }
+#elif defined(PNKR_SIMD_NEON)
+        const float32x4_t a0 = vld1q_f32(&a[0][0]);
+        const float32x4_t a1 = vld1q_f32(&a[1][0]);
+        const float32x4_t a2 = vld1q_f32(&a[2][0]);
+        const float32x4_t a3 = vld1q_f32(&a[3][0]);
+        float32x4_t cols[4];
+        for (int c = 0; c < 4; ++c) {
+            const float32x4_t bc = vld1q_f32(&b[c][0]);
+            float32x4_t r = vmulq_laneq_f32(a0, bc, 0);
+            r = vfmaq_laneq_f32(r, a1, bc, 1);
+            r = vfmaq_laneq_f32(r, a2, bc, 2);
+            r = vfmaq_laneq_f32(r, a3, bc, 3);
+            cols[c] = r;
+        }
+        for (int c = 0; c < 4; ++c) {
+            vst1q_f32(&out[c][0], cols[c]);
+        }
+#else
+        out = a * b;
+#endif
+    }
+
+}
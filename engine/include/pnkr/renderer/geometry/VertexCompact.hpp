@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "pnkr/renderer/geometry/Vertex.h"
+
+namespace pnkr::renderer::geometry {
+
+    enum class VertexFormat : uint8_t {
+        Full,     // gpu::VertexGPU, 144 bytes
+        Compact   // gpu::VertexCompactGPU, 32 bytes; no joints, weights or localIndex
+    };
+
+    inline constexpr uint32_t vertexStride(VertexFormat format) {
+        return format == VertexFormat::Compact ? sizeof(gpu::VertexCompactGPU) : sizeof(gpu::VertexGPU);
+    }
+
+    uint32_t octEncode(const glm::vec3& n);
+    glm::vec3 octDecode(uint32_t packed);
+
+    // Origin in xyz and the step of one unorm16 position unit in w, covering [minPos, maxPos].
+    glm::vec4 positionDequant(const glm::vec3& minPos, const glm::vec3& maxPos);
+
+    gpu::VertexCompactGPU encodeCompactVertex(const Vertex& v, const glm::vec4& posDequant);
+    Vertex decodeCompactVertex(const gpu::VertexCompactGPU& v, const glm::vec4& posDequant);
+
+    // Quantizes a unified vertex array, each vertex against the bounds of the
+    // vertices sharing its meshIndex. meshDequant receives one entry per mesh
+    // and is what InstanceData::posDequant is filled from.
+    void encodeCompactVertices(std::span<const Vertex> vertices,
+                               std::vector<gpu::VertexCompactGPU>& out,
+                               std::vector<glm::vec4>& meshDequant);
+
+}
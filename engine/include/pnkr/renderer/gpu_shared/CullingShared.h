@@ -15,18 +15,62 @@ struct BoundingBox {
 struct CullingData {
     float4 frustumPlanes[6];
     float4 frustumCorners[8];
+    // xyz: eye of the culling view, for cluster cone tests.
+    float4 cameraPos;
     uint numMeshesToCull;
     uint _pad[3];
 };
 
+// LOD chain of one draw, LOD 0 first. error is the simplification error
+// in world units at the instance's scale.
+struct DrawLodGPU {
+    uint4 firstIndex;
+    uint4 indexCount;
+    float4 error;
+    uint lodCount;
+    uint _pad[3];
+};
+
+// One cluster of a primitive's LOD 0 in object space, see
+// assets::ImportedMeshlet.
+struct MeshletGPU {
+    float4 sphere;      // xyz center, w radius
+    float4 coneApex;    // xyz apex
+    float4 coneAxis;    // xyz axis, w cutoff
+    uint firstIndex;    // into the model index buffer
+    uint indexCount;
+    uint _pad[2];
+};
+
+// Meshlets of one draw; meshletCount 0 draws it whole. coneCulling is
+// cleared for double-sided materials and transforms that aren't a
+// rotation plus uniform scale, which would bend the normal cones.
+struct MeshletDrawGPU {
+    uint firstMeshlet;
+    uint meshletCount;
+    uint coneCulling;
+    uint _pad;
+};
+
 struct CullingPushConstants {
     BDA_PTR(DrawIndexedIndirectCommandGPU) inCmds;
     BDA_PTR(DrawIndexedIndirectCommandGPU) outCmds;
     BDA_PTR(BoundingBox) bounds;
     BDA_PTR(CullingData) cullingData;
     BDA_PTR(uint) visibilityBuffer;
+    BDA_PTR(DrawLodGPU) lods;
+    // Cluster culling; a null meshletDraws draws every draw whole.
+    BDA_PTR(MeshletDrawGPU) meshletDraws;
+    BDA_PTR(MeshletGPU) meshlets;
+    BDA_PTR(InstanceData) instances;
+    // Capacity of outCmds: the draws plus every meshlet they may expand to.
     uint drawCount;
-    uint _pad[5];
+    // Width of clusterMain's 2D dispatch in groups; group (x, y) handles
+    // draw y * clusterGroupsX + x.
+    uint clusterGroupsX;
+    // xyz: camera position, w: LOD error scale (see RenderBatcher); a zero
+    // scale or null lods keeps the LOD chosen on the CPU.
+    float4 lodParams;
 };
 
 #ifdef __cplusplus
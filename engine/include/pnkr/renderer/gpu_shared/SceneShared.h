@@ -179,7 +179,16 @@ struct ALIGN_16 InstanceData {
     uint64_t vertexBufferPtr;
     uint materialIndex;
     uint meshIndex;
-    uint _pad[4];
+    float4 posDequant;  // xyz origin, w step; w == 0 means vertexBufferPtr holds VertexGPU
+};
+
+// Sparse update of the persistent instance buffer: src[i] lands at dst[dstIndices[i]].
+struct InstanceScatterPushConstants {
+    BDA_PTR(InstanceData) src;
+    BDA_PTR(uint) dstIndices;
+    BDA_PTR(InstanceData) dst;
+    uint count;
+    uint _pad[1];
 };
 
 struct ALIGN_16 EnvironmentMapDataGPU {
@@ -23,6 +23,20 @@ struct ALIGN_16 VertexGPU {
     PNKR_VERTEX_MEMBERS
 };
 
+// Static-mesh vertex, 32 bytes. Positions are unorm16 relative to the mesh
+// bounds and are expanded with InstanceData::posDequant; normal and tangent
+// are octahedral snorm16 pairs, UVs half floats, color unorm8.
+struct VertexCompactGPU {
+    uint positionXY;
+    uint positionZ;     // low 16 bits: z, bit 31: tangent handedness (1 = -1)
+    uint normal;
+    uint tangent;
+    uint uv0;
+    uint uv1;
+    uint color;
+    uint meshIndex;
+};
+
 #ifdef __cplusplus
 }
 #endif
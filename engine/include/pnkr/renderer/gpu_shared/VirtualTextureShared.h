@@ -0,0 +1,42 @@
+#pragma once
+#include "SlangCppBridge.h"
+
+#ifdef __cplusplus
+namespace gpu {
+#endif
+
+// Feedback buffers hold a request count followed by packed tile ids
+// (x | y << 10 | mip << 20 | texture << 24).
+#define VT_FEEDBACK_HEADER_UINTS 1u
+// One pixel of every VT_FEEDBACK_STRIDE x VT_FEEDBACK_STRIDE block writes
+// feedback, rotating through the block over consecutive frames.
+#define VT_FEEDBACK_STRIDE 8u
+
+struct VirtualTextureGPU {
+    uint pageTableTexture;
+    uint atlasTexture;
+    uint samplerId;
+    uint feedbackBuffer;
+    uint virtualId;
+    uint mipLevels;
+    uint tileSize;
+    uint tileBorder;
+    float2 virtualSize;
+    float atlasTexelSize;
+    uint atlasTilesPerSide;
+    uint feedbackCapacity;
+    uint frameIndex;
+    uint pad0;
+    uint pad1;
+};
+
+// A quad on the XZ plane sampled through one virtual texture; 128 bytes,
+// the smallest push constant range Vulkan guarantees.
+struct VirtualTexturePlanePushConstants {
+    float4x4 mvp;
+    VirtualTextureGPU vt;
+};
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "pnkr/renderer/geometry/VertexCompact.hpp"
+
 #include <filesystem>
 #include <memory>
 
@@ -20,6 +22,7 @@ namespace pnkr::renderer::io
     public:
         static std::unique_ptr<scene::ModelDOD> load(RHIRenderer& renderer,
                                                      const std::filesystem::path& path,
-                                                     bool vertexPulling = false);
+                                                     bool vertexPulling = false,
+                                                     geometry::VertexFormat vertexFormat = geometry::VertexFormat::Full);
     };
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "pnkr/assets/ImportedData.hpp"
+#include "pnkr/renderer/geometry/VertexCompact.hpp"
 #include <memory>
 
 namespace pnkr::renderer {
@@ -16,7 +17,8 @@ namespace pnkr::renderer::io {
     public:
         static std::unique_ptr<scene::ModelDOD> upload(
             RHIRenderer& renderer,
-            assets::ImportedModel&& source);
+            assets::ImportedModel&& source,
+            geometry::VertexFormat vertexFormat = geometry::VertexFormat::Full);
     };
 
 }
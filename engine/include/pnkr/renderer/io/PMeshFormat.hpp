@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/vec3.hpp>
+
+namespace pnkr::renderer::io::pmesh
+{
+    // .pmesh v4: FileHeader, a Section table, then one blob per section at a
+    // 64-byte aligned file offset. Geometry sections are raw arrays that
+    // loadPMESH hands out as spans into the mapped file; the scene metadata
+    // sections keep the length-prefixed stream encoding. An empty OPTM
+    // section marks geometry already optimized at import. v3 added the LOD
+    // chains: LODS records and the LIDX indices they point into. v4 added
+    // MSHL, the meshlets of each primitive's LOD 0.
+    inline constexpr uint32_t kMagic = 0x48534D50; // "PMSH"
+    inline constexpr uint16_t kVersion = 4;
+    inline constexpr uint64_t kBlobAlignment = 64;
+
+    struct FileHeader
+    {
+        uint32_t magic = kMagic;
+        uint16_t version = kVersion;
+        uint16_t endian = 1;
+        uint32_t sectionCount = 0;
+        uint32_t vertexSize = 0;    // sizeof(renderer::Vertex) of the writer
+        uint64_t fileSize = 0;
+    };
+
+    struct Section
+    {
+        uint32_t fourcc = 0;
+        uint32_t elementSize = 0;   // 0 for stream-encoded sections
+        uint64_t offset = 0;
+        uint64_t sizeBytes = 0;
+    };
+
+    struct PrimitiveRecord
+    {
+        uint32_t meshIndex = 0;
+        uint32_t materialIndex = 0;
+        uint64_t firstVertex = 0;   // elements into VERT
+        uint64_t firstIndex = 0;    // elements into INDX
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        glm::vec3 minPos{0.0f};
+        uint32_t firstTarget = 0;   // into MTGT
+        glm::vec3 maxPos{0.0f};
+        uint32_t targetCount = 0;
+    };
+
+    // Deltas are stored back to back in MDLT: positions, normals, tangents.
+    struct MorphTargetRecord
+    {
+        uint64_t firstDelta = 0;
+        uint32_t positionCount = 0;
+        uint32_t normalCount = 0;
+        uint32_t tangentCount = 0;
+        uint32_t _pad = 0;
+    };
+
+    // One simplified level of a primitive; records are grouped by primitive
+    // (in PRIM order) and sorted finest first.
+    struct LodRecord
+    {
+        uint32_t primitive = 0;     // into PRIM
+        uint32_t indexCount = 0;
+        uint64_t firstIndex = 0;    // elements into LIDX
+        float error = 0.0f;
+        uint32_t _pad = 0;
+    };
+
+    // A cluster of LOD 0 triangles (see assets::ImportedMeshlet); grouped by
+    // primitive like LodRecord.
+    struct MeshletRecord
+    {
+        uint32_t primitive = 0;     // into PRIM
+        uint32_t firstIndex = 0;    // into the primitive's indices
+        uint32_t indexCount = 0;
+        float coneCutoff = 1.0f;
+        glm::vec3 center{0.0f};
+        float radius = 0.0f;
+        glm::vec3 coneApex{0.0f};
+        uint32_t _pad0 = 0;
+        glm::vec3 coneAxis{0.0f};
+        uint32_t _pad1 = 0;
+    };
+
+    static_assert(sizeof(FileHeader) == 24);
+    static_assert(sizeof(Section) == 24);
+    static_assert(sizeof(PrimitiveRecord) == 64);
+    static_assert(sizeof(LodRecord) == 24);
+    static_assert(sizeof(MeshletRecord) == 64);
+
+    constexpr uint64_t alignBlob(uint64_t offset)
+    {
+        return (offset + kBlobAlignment - 1) & ~(kBlobAlignment - 1);
+    }
+}
@@ -34,7 +34,12 @@ struct KTXTextureData {
   size_t dataSize = 0;
 
   std::vector<uint8_t> ownedData;
+  // KTX2 level index. Sizes are the on-disk (possibly supercompressed) and
+  // inflated byte counts of each level.
   std::vector<uint64_t> mipFileOffsets;
+  std::vector<uint64_t> mipFileSizes;
+  std::vector<uint64_t> mipUncompressedSizes;
+  uint32_t supercompressionScheme = 0;
   std::shared_ptr<pnkr::core::MemoryMappedFile> mappedFile;
 
   KTXTextureData() = default;
@@ -51,6 +56,9 @@ struct KTXTextureData {
         isArray(other.isArray), dataPtr(other.dataPtr),
         dataSize(other.dataSize), ownedData(std::move(other.ownedData)),
         mipFileOffsets(std::move(other.mipFileOffsets)),
+        mipFileSizes(std::move(other.mipFileSizes)),
+        mipUncompressedSizes(std::move(other.mipUncompressedSizes)),
+        supercompressionScheme(other.supercompressionScheme),
         mappedFile(std::move(other.mappedFile)) {
     other.texture = nullptr;
     other.dataPtr = nullptr;
@@ -82,6 +90,13 @@ public:
 
   static uint64_t getImageFileOffset(const KTXTextureData &data, uint32_t level,
                                      uint32_t layer, uint32_t face);
+  static uint64_t getImageOffsetInLevel(const KTXTextureData &data,
+                                        uint32_t level, uint32_t layer,
+                                        uint32_t face);
+
+  // Zstd-supercompressed KTX2 whose levels can be inflated one at a time
+  // straight into staging memory (see ZstdLevelStream).
+  static bool isZstdStreamable(const KTXTextureData &data);
 
   static rhi::Format mapKtx2VkFormatToRhi(uint32_t vkFormat);
 };
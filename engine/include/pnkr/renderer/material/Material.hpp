@@ -3,6 +3,7 @@
 #include "pnkr/rhi/rhi_types.hpp"
 #include <glm/vec4.hpp>
 #include <glm/vec3.hpp>
+#include <initializer_list>
 
 namespace pnkr::renderer {
 
@@ -78,4 +79,19 @@ struct MaterialData {
     PipelineHandle pipeline{INVALID_PIPELINE_HANDLE};
 };
 
+// Calls fn(const TextureSlot&) for every texture slot of the material.
+template <typename Fn>
+void forEachTextureSlot(const MaterialData& material, Fn&& fn) {
+    for (const TextureSlot* slot :
+         {&material.baseColor, &material.normal, &material.metallicRoughness,
+          &material.occlusion, &material.emissive, &material.clearcoat,
+          &material.clearcoatRoughness, &material.clearcoatNormal,
+          &material.specular, &material.specularColor, &material.transmission,
+          &material.thickness, &material.sheenColor, &material.sheenRoughness,
+          &material.anisotropy, &material.iridescence,
+          &material.iridescenceThickness}) {
+        fn(*slot);
+    }
+}
+
 }
@@ -21,6 +21,10 @@ namespace pnkr::renderer
             BufferPtr visibilityBufferDoubleSided;
             BufferPtr drawIndirectBuffer;
             BufferPtr boundsBuffer;
+            BufferPtr lodBuffer;
+            BufferPtr lodBufferDoubleSided;
+            BufferPtr meshletDrawBuffer;
+            BufferPtr meshletDrawBufferDoubleSided;
         };
 
         const CullingResources& getResources(uint32_t frameIndex) const { return m_cullingResources[frameIndex]; }
@@ -35,6 +39,7 @@ namespace pnkr::renderer
         RHIRenderer* m_renderer = nullptr;
         ShaderHotReloader* m_hotReloader = nullptr;
         PipelinePtr m_cullingPipeline;
+        PipelinePtr m_clusterPipeline;
         std::vector<CullingResources> m_cullingResources;
 
          BufferPtr m_zeroU32Buffer;
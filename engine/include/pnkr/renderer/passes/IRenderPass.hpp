@@ -64,6 +64,8 @@ namespace pnkr::renderer {
         float dt;
         std::function<void(rhi::RHICommandList*)> uiRender;
         glm::mat4 cullingViewProj = glm::mat4(1.0f);
+        // Eye of cullingViewProj; frozen together with it.
+        glm::vec3 cullingCameraPos = glm::vec3(0.0f);
         uint64_t cameraDataAddr = 0;
         uint64_t sceneDataAddr = 0;
         uint64_t transformAddr = 0;
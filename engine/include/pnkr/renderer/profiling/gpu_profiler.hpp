@@ -185,8 +185,33 @@ namespace pnkr::renderer
         double poolUtilizationPercent = 0.0;
         bool poolOverBudget = false;
 
+        // Staging ring allocator: time producers waited for pages, bytes
+        // lost to alignment and wrap-around, and head contention.
+        uint64_t stagingStalls = 0;
+        double stagingStallMs = 0.0;
+        double stagingFragmentationPercent = 0.0;
+        uint64_t stagingFailedReservations = 0;
+        uint64_t stagingHeadRetries = 0;
+        uint64_t temporaryStagingAllocations = 0;
+
+        // Texture residency chosen by the streaming scheduler, estimated
+        // from each texture's mip chain.
+        uint64_t textureResidentBytes = 0;
+        uint64_t textureTargetBytes = 0;
+        uint64_t textureResidencyBudget = 0;
+        uint32_t streamedTextures = 0;
+        uint32_t texturesDemoted = 0;
+        uint32_t mipRequestsInFlight = 0;
+        bool residencyOverBudget = false;
+
         uint64_t totalFileReadBytes = 0;
         double avgFileReadTimeMs = 0.0;
+        // Streamed mip ranges, one batch per upload job.
+        uint64_t fileReadBatches = 0;
+        uint64_t fileReadSyscalls = 0;
+        const char* fileReaderBackend = "";
+        // Zstd KTX2 levels inflated straight into staging.
+        uint64_t bytesInflatedTotal = 0;
         double avgDecodeTimeMs = 0.0;
         uint32_t pendingFileReads = 0;
         uint32_t failedLoads = 0;
@@ -194,6 +219,15 @@ namespace pnkr::renderer
         double transferThreadUtilization = 0.0;
         uint32_t batchesSubmittedTotal = 0;
         double avgBatchSizeMB = 0.0;
+        // Upload pacing: per-frame byte budget and the recording throughput
+        // it is derived from in adaptive mode.
+        bool uploadPacingAdaptive = false;
+        uint64_t uploadFrameBudgetBytes = 0;
+        double uploadThroughputMBps = 0.0;
+        uint64_t uploadDeferredBatches = 0;
+        // Copy commands recorded vs regions they carry.
+        uint64_t copyCommandsTotal = 0;
+        uint64_t copyRegionsTotal = 0;
     };
 
     struct GPUFrameData
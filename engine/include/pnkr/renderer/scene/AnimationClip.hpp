@@ -0,0 +1,107 @@
+#pragma once
+
+#include "pnkr/renderer/scene/Animation.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pnkr::renderer::scene
+{
+    struct LocalTRS;
+
+    struct AnimationTrack
+    {
+        uint32_t target = 0;        // index into targets() for TRS tracks, the entity for weight tracks
+        AnimationPath path = AnimationPath::Translation;
+        InterpolationType interpolation = InterpolationType::Linear;
+        uint32_t firstKey = 0;      // into the clip's key times
+        uint32_t keyCount = 0;
+        uint32_t firstValue = 0;    // into the clip's SoA values; cubic keys store in-tangent, value, out-tangent
+        int32_t samplerIndex = -1;  // source sampler, still used for morph weights
+    };
+
+    struct KeyframeSpan
+    {
+        uint32_t k0 = 0;
+        uint32_t k1 = 0;
+        float factor = 0.0f;
+        float dt = 0.0f;
+    };
+
+    // Per-playback keyframe positions, one per track. Playback moving forward
+    // in time only ever advances a key or two, so locating keys is O(1) amortized.
+    struct AnimationCursor
+    {
+        std::vector<uint32_t> keys;
+        const void* clip = nullptr;
+
+        void reset() { keys.clear(); clip = nullptr; }
+    };
+
+    // Playback-ready form of an Animation: key times and values in flat SoA
+    // arrays, tracks grouped by path, and a sorted list of unique target nodes.
+    class CompiledAnimationClip
+    {
+    public:
+        static constexpr uint32_t kBatchWidth = 8;
+        static constexpr uint8_t kAllChannels = 0b111;
+
+        static constexpr uint8_t channelBit(AnimationPath path)
+        {
+            return static_cast<uint8_t>(1U << static_cast<uint32_t>(path));
+        }
+
+        static CompiledAnimationClip compile(const Animation& anim);
+
+        float duration() const noexcept { return m_duration; }
+
+        // Unique target entities of the TRS tracks, ascending.
+        std::span<const uint32_t> targets() const noexcept { return m_targets; }
+
+        // channelBit() of every path animated per target, indexed like targets().
+        std::span<const uint8_t> channelMasks() const noexcept { return m_channelMasks; }
+
+        // TRS tracks come first, followed by morph weight tracks.
+        std::span<const AnimationTrack> tracks() const noexcept { return m_tracks; }
+        std::span<const AnimationTrack> trsTracks() const noexcept
+        {
+            return std::span(m_tracks).first(m_trsTrackCount);
+        }
+        std::span<const AnimationTrack> weightTracks() const noexcept
+        {
+            return std::span(m_tracks).subspan(m_trsTrackCount);
+        }
+        uint32_t trsTrackCount() const noexcept { return m_trsTrackCount; }
+        uint32_t batchCount() const noexcept { return (m_trsTrackCount + kBatchWidth - 1) / kBatchWidth; }
+
+        // Sizes the cursor for this clip, resetting it if it was used with another one.
+        void bindCursor(AnimationCursor& cursor) const;
+
+        // Finds the keys around `time`, starting from and updating the cached key.
+        KeyframeSpan locate(const AnimationTrack& track, float time, uint32_t& cachedKey) const;
+
+        // Evaluates TRS batches [firstBatch, lastBatch) into `pose`, indexed like targets().
+        // Null entries are skipped. Only the animated channel of each target is written.
+        // The cursor must be bound; distinct batch ranges may be sampled concurrently.
+        void sampleBatches(uint32_t firstBatch, uint32_t lastBatch, float time,
+                           AnimationCursor& cursor, std::span<LocalTRS* const> pose) const;
+
+        void sample(float time, AnimationCursor& cursor, std::span<LocalTRS* const> pose) const
+        {
+            bindCursor(cursor);
+            sampleBatches(0, batchCount(), time, cursor, pose);
+        }
+
+    private:
+        std::vector<AnimationTrack> m_tracks;
+        std::vector<uint32_t> m_targets;
+        std::vector<uint8_t> m_channelMasks;
+        std::vector<float> m_times;
+        std::vector<float> m_valuesX;
+        std::vector<float> m_valuesY;
+        std::vector<float> m_valuesZ;
+        std::vector<float> m_valuesW;
+        uint32_t m_trsTrackCount = 0;
+        float m_duration = 0.0f;
+    };
+}
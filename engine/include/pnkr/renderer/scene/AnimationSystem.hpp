@@ -18,27 +18,32 @@ namespace pnkr::renderer::scene
 
         static BoundingBox calculateSkinnedBounds(const ModelDOD& model);
 
+        // Advances currentTime by dt, looping or stopping at the clip end.
+        static void advanceTime(AnimationState& state, float duration, float dt);
+
+        // Poses the model's local transforms at `time`; world transforms are left to updateTransforms().
+        static void applyAnimation(ModelDOD& model, uint32_t animIndex, AnimationCursor& cursor, float time);
+
     private:
-        static void applyAnimation(ModelDOD& model, const Animation& anim, float time);
 
         static void applyBlending(ModelDOD& model,
-                                  const Animation& animA, float timeA,
-                                  const Animation& animB, float timeB,
+                                  uint32_t animIndexA, AnimationCursor& cursorA, float timeA,
+                                  uint32_t animIndexB, AnimationCursor& cursorB, float timeB,
                                   float weight);
 
-        static size_t getKeyframeIndex(const std::vector<float>& inputs, float time);
-
-        struct InterpolationContext {
-            size_t idx0;
-            size_t idx1;
-            float factor;
-            float dt;
-        };
-        static InterpolationContext getInterpolationContext(const std::vector<float>& inputs, float time);
-
-        static glm::vec3 interpolateTranslation(const AnimationSampler& sampler, float time);
-        static glm::quat interpolateRotation(const AnimationSampler& sampler, float time);
-        static glm::vec3 interpolateScale(const AnimationSampler& sampler, float time);
-        static void interpolateWeights(const AnimationSampler& sampler, float time, uint32_t numTargets, float* outWeights);
+        // Gives every target of clip a LocalTRS. Emplacing can move the LocalTRS pool, so
+        // all clips of an update are prepared before bindTargets takes pointers into it.
+        static void prepareTargets(SceneGraphDOD& scene, const CompiledAnimationClip& clip);
+        static void bindTargets(SceneGraphDOD& scene, const CompiledAnimationClip& clip, std::vector<LocalTRS*>& pose);
+        // Pulls edits made to LocalTransform since the last commit into the channels clip
+        // does not animate, so commitPose leaves them as edited.
+        static void syncEditedChannels(SceneGraphDOD& scene, const CompiledAnimationClip& clip,
+                                       std::span<LocalTRS* const> pose);
+        static void commitPose(SceneGraphDOD& scene, const CompiledAnimationClip& clip, std::span<LocalTRS* const> pose);
+
+        static void applyWeights(ModelDOD& model, const Animation& anim, const CompiledAnimationClip& clip,
+                                 AnimationCursor& cursor, float time);
+        static void interpolateWeights(const AnimationSampler& sampler, const KeyframeSpan& span,
+                                       uint32_t numTargets, float* outWeights);
     };
 }
@@ -58,6 +58,11 @@ namespace pnkr::renderer::scene
 
     void updateWorldBounds(SceneGraphDOD& scene);
 
+    // Union of the valid world bounds of every MeshRenderer with a model
+    // mesh. System meshes (meshID < 0), which include the debug and helper
+    // geometry, do not cast shadows and are left out.
+    BoundingBox shadowCasterBounds(const SceneGraphDOD& scene);
+
     inline BoundingBox transformAabbFast(const BoundingBox& b, const glm::mat4& M)
     {
         const glm::vec3 c = (b.m_min + b.m_max) * 0.5f;
@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <string>
 #include "pnkr/core/ECS.hpp"
 #include "pnkr/renderer/SystemMeshes.hpp"
@@ -48,8 +49,27 @@ namespace pnkr::renderer::scene {
         glm::mat4 matrix{1.0f};
     };
 
+    // Decomposed local transform kept on animated nodes so sampling never has
+    // to decompose LocalTransform; toMatrix() composes T * R * S.
+    struct LocalTRS {
+        glm::vec3 translation{0.0f};
+        glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+        glm::vec3 scale{1.0f};
+
+        glm::mat4 toMatrix() const {
+            glm::mat4 m = glm::mat4_cast(rotation);
+            m[0] *= scale.x;
+            m[1] *= scale.y;
+            m[2] *= scale.z;
+            m[3] = glm::vec4(translation, 1.0f);
+            return m;
+        }
+    };
+
     struct DirtyTag {};
     struct TransformDirtyTag {};
+    // World transform changed since the GPU instance buffer last saw it.
+    struct InstanceDirtyTag {};
     struct VisibleTag {};
     struct StaticTag {};
     struct CastShadowTag {};
@@ -77,6 +97,9 @@ namespace pnkr::renderer::scene {
         uint32_t jointOffset = 0;
         uint32_t jointCount = 0;
         int32_t materialOverride = -1;
+        // Copy of the skinned vertex buffer this renderer draws from; one copy
+        // is skinned per distinct joint palette.
+        uint32_t vertexSlot = 0;
     };
 
     struct LightSource {
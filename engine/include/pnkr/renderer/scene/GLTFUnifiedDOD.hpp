@@ -10,6 +10,7 @@
 #include "pnkr/renderer/scene/SceneBufferPacker.hpp"
 #include "pnkr/renderer/scene/MaterialPipelineMap.hpp"
 
+#include <array>
 #include <bit>
 #include <cstddef>
 #include <vector>
@@ -31,6 +32,15 @@ namespace pnkr::renderer::scene {
 
         BoundingBox* transparentBounds = nullptr;
         uint32_t transparentBoundsCount = 0;
+
+        // Parallel to the opaque bounds; null when the batcher had none.
+        gpu::DrawLodGPU* opaqueLods = nullptr;
+        gpu::DrawLodGPU* opaqueDoubleSidedLods = nullptr;
+        // Also parallel to the opaque bounds, with the total meshlets per bucket.
+        gpu::MeshletDrawGPU* opaqueMeshletDraws = nullptr;
+        gpu::MeshletDrawGPU* opaqueDoubleSidedMeshletDraws = nullptr;
+        uint32_t opaqueMeshletCount = 0;
+        uint32_t opaqueDoubleSidedMeshletCount = 0;
     };
 
     struct GLTFUnifiedDODContext : DrawLists {
@@ -49,6 +59,7 @@ namespace pnkr::renderer::scene {
         uint32_t transformCount = 0;
         uint32_t transformCapacity = 0;
         uint64_t vertexBufferOverride = 0;
+        uint64_t skinnedSlotStride = 0;
 
         gpu::DrawIndexedIndirectCommandGPU* indirectOpaque = nullptr;
         uint32_t opaqueCount = 0;
@@ -84,6 +95,12 @@ namespace pnkr::renderer::scene {
 
         bool mergeByMaterial = true;
         bool ignoreVisibility = false;
+        // Compact CPU-culling output; see RenderBatcher::buildBatches.
+        const std::vector<ecs::Entity>* visibleMeshes = nullptr;
+        // See RenderBatcher::lodErrorScale; 0 always draws LOD 0.
+        float lodErrorScale = 0.0F;
+        std::array<uint32_t, assets::kMaxPrimitiveLods> lodDraws{};
+        std::array<uint64_t, assets::kMaxPrimitiveLods> lodTriangles{};
         bool uploadTransformBuffer = true;
         bool uploadIndirectBuffers = true;
 
@@ -0,0 +1,74 @@
+#pragma once
+#include "pnkr/core/ECS.hpp"
+#include "pnkr/renderer/gpu_shared/SceneShared.h"
+#include "pnkr/renderer/rhi_renderer.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace pnkr::renderer
+{
+    class FrameManager;
+    class RenderResourceManager;
+    namespace scene { class ModelDOD; }
+
+    struct InstanceUploadStats
+    {
+        uint32_t instancesUploaded = 0;
+        uint64_t bytesUploaded = 0;
+        bool fullUpload = false;
+    };
+
+    struct InstanceUpdateRequest
+    {
+        RHIRenderer& renderer;
+        rhi::RHICommandList& cmd;
+        FrameManager& frameManager;
+        scene::ModelDOD& model;
+        uint64_t vertexBufferAddr = 0;
+        uint64_t skinnedVertexBufferAddr = 0;
+    };
+
+    // Persistent GPU copy of the entity-indexed InstanceData array. After the
+    // first frame only entities tagged InstanceDirtyTag (or whose vertex source
+    // moved) are packed into the upload ring and written in place by a small
+    // compute scatter, so a static scene uploads nothing.
+    class GlobalInstanceBuffer
+    {
+    public:
+        GlobalInstanceBuffer();
+        ~GlobalInstanceBuffer();
+
+        void initialize(RHIRenderer* renderer, RenderResourceManager* resourceMgr);
+
+        void update(const InstanceUpdateRequest& request);
+
+        // Forces the next update to rewrite every instance.
+        void invalidate() { m_needsFullUpload = true; }
+
+        uint64_t getDeviceAddress() const;
+        BufferHandle getBufferHandle() const { return m_gpuBuffer; }
+        const InstanceUploadStats& stats() const { return m_stats; }
+
+    private:
+        bool ensureCapacity(uint32_t count);
+        void uploadAll(const InstanceUpdateRequest& request, uint32_t count);
+        void scatterDirty(const InstanceUpdateRequest& request);
+
+        RHIRenderer* m_renderer = nullptr;
+        RenderResourceManager* m_resourceMgr = nullptr;
+        BufferHandle m_gpuBuffer = INVALID_BUFFER_HANDLE;
+        PipelinePtr m_scatterPipeline;
+        uint32_t m_capacity = 0;
+        uint32_t m_slotCount = 0;
+
+        const void* m_scene = nullptr;
+        uint32_t m_topologyVersion = 0;
+        uint64_t m_vertexBufferAddr = 0;
+        uint64_t m_skinnedVertexBufferAddr = 0;
+        bool m_needsFullUpload = true;
+
+        std::vector<ecs::Entity> m_dirty;
+        std::vector<uint8_t> m_queued;
+        InstanceUploadStats m_stats;
+    };
+}
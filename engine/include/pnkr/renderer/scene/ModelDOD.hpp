@@ -38,6 +38,7 @@ namespace pnkr::renderer::scene
         const std::vector<Animation>& animations() const { return m_assets.animations(); }
         std::vector<Skin>& skinsMutable() { return m_assets.skinsMutable(); }
         std::vector<Animation>& animationsMutable() { return m_assets.animationsMutable(); }
+        const CompiledAnimationClip& compiledAnimation(uint32_t index) { return m_assets.compiledAnimation(index); }
         const std::vector<GltfCamera>& cameras() const { return m_assets.cameras(); }
         std::vector<GltfCamera>& camerasMutable() { return m_assets.camerasMutable(); }
 
@@ -57,6 +58,8 @@ namespace pnkr::renderer::scene
         std::vector<MaterialCPU>& materialsCPUMutable() { return m_assets.materialsCPUMutable(); }
         std::vector<Vertex>& cpuVerticesMutable() { return m_assets.cpuVerticesMutable(); }
         std::vector<uint32_t>& cpuIndicesMutable() { return m_assets.cpuIndicesMutable(); }
+        const std::vector<gpu::MeshletGPU>& meshlets() const { return m_assets.meshlets(); }
+        std::vector<gpu::MeshletGPU>& meshletsMutable() { return m_assets.meshletsMutable(); }
         std::vector<std::string>& textureFilesMutable() { return m_assets.textureFilesMutable(); }
         const std::vector<uint8_t>& textureIsSrgb() const { return m_assets.textureIsSrgb(); }
         std::vector<uint8_t>& textureIsSrgbMutable() { return m_assets.textureIsSrgbMutable(); }
@@ -103,6 +106,10 @@ namespace pnkr::renderer::scene
         BufferPtr vertexBuffer() const { return m_assets.vertexBuffer; }
         BufferPtr indexBuffer() const { return m_assets.indexBuffer; }
         BufferPtr boundsBuffer() const { return m_assets.boundsBuffer; }
+        BufferPtr meshletBuffer() const { return m_assets.meshletBuffer; }
+        geometry::VertexFormat vertexFormat() const { return m_assets.vertexFormat(); }
+        void setVertexFormat(geometry::VertexFormat format) { m_assets.setVertexFormat(format); }
+        glm::vec4 positionDequant(uint32_t meshIndex) const { return m_assets.positionDequant(meshIndex); }
         BufferPtr visibleListBuffer() const { return m_visibleListBuffer; }
         BufferPtr morphVertexBuffer() const { return m_state.morphVertexBuffer; }
         BufferPtr morphStateBuffer() const { return m_state.morphStateBuffer; }
@@ -4,8 +4,10 @@
 #include "pnkr/renderer/scene/ModelDOD.hpp"
 #include "pnkr/renderer/scene/Bounds.hpp"
 #include "pnkr/renderer/gpu_shared/SceneShared.h"
+#include "pnkr/renderer/gpu_shared/CullingShared.h"
 #include "pnkr/core/LinearAllocator.hpp"
 #include "pnkr/renderer/scene/SceneTypes.hpp"
+#include <array>
 #include <bit>
 
 namespace pnkr::renderer::scene
@@ -29,6 +31,8 @@ namespace pnkr::renderer::scene
         gpu::DrawIndexedIndirectCommandGPU cmd;
         BoundingBox bounds;
         uint32_t meshIndex;
+        gpu::DrawLodGPU lod;
+        gpu::MeshletDrawGPU meshlets;
     };
 
     struct RenderBatchResult {
@@ -62,12 +66,33 @@ namespace pnkr::renderer::scene
         BoundingBox* transmissionDoubleSidedBounds = nullptr;
         BoundingBox* transparentBounds = nullptr;
 
+        // LOD chains of the opaque buckets, re-selected by the culling pass
+        gpu::DrawLodGPU* opaqueLods = nullptr;
+        gpu::DrawLodGPU* opaqueDoubleSidedLods = nullptr;
+
+        // Meshlet ranges of the opaque buckets, for cluster culling. Draws
+        // without meshlets have meshletCount 0.
+        gpu::MeshletDrawGPU* opaqueMeshletDraws = nullptr;
+        gpu::MeshletDrawGPU* opaqueDoubleSidedMeshletDraws = nullptr;
+        uint32_t opaqueMeshletCount = 0;
+        uint32_t opaqueDoubleSidedMeshletCount = 0;
+
+        // Draws and triangles per selected LOD, for stats
+        std::array<uint32_t, assets::kMaxPrimitiveLods> lodDraws{};
+        std::array<uint64_t, assets::kMaxPrimitiveLods> lodTriangles{};
+
         bool volumetricMaterial = false;
     };
 
     class RenderBatcher
     {
     public:
+        // visibleMeshes, when set, lists the MeshRenderer entities that passed
+        // CPU culling and is used instead of their Visibility component.
+        // lodErrorScale converts a LOD's world-space error into the distance
+        // beyond which it is acceptable (see lodErrorScale()); 0 keeps LOD 0.
+        // Skinned entities draw from vertexBufferOverride plus their
+        // SkinnedMeshRenderer::vertexSlot times skinnedSlotStride.
         static void buildBatches(
             RenderBatchResult& result,
             const ModelDOD& model,
@@ -75,7 +100,18 @@ namespace pnkr::renderer::scene
             const glm::vec3& cameraPos,
             core::LinearAllocator& allocator,
             bool ignoreVisibility,
-            uint64_t vertexBufferOverride = 0
+            uint64_t vertexBufferOverride = 0,
+            const std::vector<ecs::Entity>* visibleMeshes = nullptr,
+            float lodErrorScale = 0.0F,
+            uint64_t skinnedSlotStride = 0
         );
+
+        // Scale for a perspective projection whose [1][1] term is projY
+        // rendered viewportHeight pixels tall, so that a selected LOD's error
+        // projects to at most maxErrorPixels.
+        static float lodErrorScale(float projY, float viewportHeight, float maxErrorPixels)
+        {
+            return maxErrorPixels > 0.0F ? 0.5F * projY * viewportHeight / maxErrorPixels : 0.0F;
+        }
     };
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
@@ -8,12 +9,15 @@
 #include "pnkr/core/Handle.h"
 #include "pnkr/renderer/material/Material.hpp"
 #include "pnkr/renderer/scene/Animation.hpp"
+#include "pnkr/renderer/scene/AnimationClip.hpp"
 #include "pnkr/renderer/scene/GltfCamera.hpp"
 #include "pnkr/renderer/geometry/Vertex.h"
+#include "pnkr/renderer/geometry/VertexCompact.hpp"
 #include "pnkr/renderer/scene/Bounds.hpp"
 #include "pnkr/assets/ImportedData.hpp"
 #include "pnkr/renderer/geometry/GeometryUtils.hpp"
 #include "pnkr/renderer/RHIResourceManager.hpp"
+#include "pnkr/renderer/gpu_shared/CullingShared.h"
 
 namespace pnkr::renderer {
     class RHIRenderer;
@@ -24,12 +28,41 @@ namespace pnkr::renderer::scene
     using MaterialCPU = pnkr::assets::ImportedMaterial;
     using MaterialData = pnkr::renderer::MaterialData;
 
+    struct PrimitiveLod
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        float error = 0.0f;         // object space, see assets::ImportedLod
+    };
+
     struct PrimitiveDOD
     {
         uint32_t firstIndex = 0;
         uint32_t indexCount = 0;
         int32_t vertexOffset = 0;
         uint32_t materialIndex = 0;
+        // Simplified levels, finest first; LOD 0 is firstIndex/indexCount.
+        uint32_t lodCount = 0;
+        std::array<PrimitiveLod, assets::kMaxPrimitiveLods - 1> lods{};
+        // Clusters of LOD 0 in SceneAssetDatabase::meshlets(); none when the
+        // primitive is always drawn whole.
+        uint32_t firstMeshlet = 0;
+        uint32_t meshletCount = 0;
+
+        PrimitiveLod level(uint32_t lod) const
+        {
+            return lod == 0 ? PrimitiveLod{firstIndex, indexCount, 0.0f} : lods[lod - 1];
+        }
+
+        // Coarsest level whose error times errorScale stays within distance.
+        uint32_t selectLod(float errorScale, float distance) const
+        {
+            uint32_t lod = 0;
+            while (lod < lodCount && lods[lod].error * errorScale <= distance) {
+                ++lod;
+            }
+            return lod;
+        }
     };
 
     struct MeshDOD
@@ -38,12 +71,28 @@ namespace pnkr::renderer::scene
         std::string name;
     };
 
+    // Position-only copy of a mesh for the CPU occlusion culler. Empty for
+    // meshes that cannot occlude reliably: too dense, skinned, morphed or
+    // not fully opaque (alpha masked or blended, transmissive, volumetric).
+    struct OccluderMesh
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+    };
+
     struct MorphTargetInfo
     {
         uint32_t meshIndex = ~0u;
         std::vector<uint32_t> targetOffsets;
     };
 
+    struct VertexUploadStats
+    {
+        uint32_t vertexCount = 0;
+        uint64_t bytes = 0;       // size of vertexBuffer
+        uint64_t fullBytes = 0;   // size the same vertices take as VertexGPU
+    };
+
     class SceneAssetDatabase
     {
     public:
@@ -72,6 +121,10 @@ namespace pnkr::renderer::scene
         const std::vector<Animation>& animations() const { return m_animations; }
         std::vector<Animation>& animationsMutable() { return m_animations; }
 
+        // Compiled lazily from animations(); recompiled when the animation count changes.
+        const CompiledAnimationClip& compiledAnimation(uint32_t index);
+        void invalidateCompiledAnimations() { m_compiledAnimations.clear(); }
+
         const std::vector<GltfCamera>& cameras() const { return m_cameras; }
         std::vector<GltfCamera>& camerasMutable() { return m_cameras; }
 
@@ -85,6 +138,14 @@ namespace pnkr::renderer::scene
         const std::vector<uint32_t>& cpuIndices() const { return m_cpuIndices; }
         std::vector<uint32_t>& cpuIndicesMutable() { return m_cpuIndices; }
 
+        // Object-space clusters indexing into the unified index buffer;
+        // uploaded to meshletBuffer and kept for CPU reference culling.
+        const std::vector<gpu::MeshletGPU>& meshlets() const { return m_meshlets; }
+        std::vector<gpu::MeshletGPU>& meshletsMutable() { return m_meshlets; }
+
+        // Built by uploadUnifiedBuffers(); survives dropCpuGeometry().
+        const std::vector<OccluderMesh>& occluderMeshes() const { return m_occluderMeshes; }
+
         // Source Data (likely to be dropped after load)
         const std::vector<MaterialCPU>& materialsCPU() const { return m_materialsCPU; }
         std::vector<MaterialCPU>& materialsCPUMutable() { return m_materialsCPU; }
@@ -102,13 +163,34 @@ namespace pnkr::renderer::scene
 
         void dropCpuGeometry();
 
+        // Layout requested for the next uploadUnifiedBuffers(). Models with
+        // skins or morph targets always upload Full: the skinning pass reads
+        // and writes VertexGPU.
+        void setVertexFormat(geometry::VertexFormat format) { m_requestedVertexFormat = format; }
+        geometry::VertexFormat vertexFormat() const { return m_vertexFormat; }
+        bool hasDeformation() const;
+
+        // Meshes above this stay out of the occlusion culler.
+        static constexpr uint32_t kMaxOccluderTriangles = 4096;
+
+        // InstanceData::posDequant for instances drawing `meshIndex` from vertexBuffer.
+        glm::vec4 positionDequant(uint32_t meshIndex) const
+        {
+            return meshIndex < m_meshDequant.size() ? m_meshDequant[meshIndex] : glm::vec4(0.0f);
+        }
+
+        const VertexUploadStats& vertexUploadStats() const { return m_vertexUploadStats; }
+
         void uploadUnifiedBuffers(RHIRenderer& renderer);
 
         BufferPtr vertexBuffer;
         BufferPtr indexBuffer;
         BufferPtr boundsBuffer;
+        BufferPtr meshletBuffer;
 
     private:
+        void buildOccluderMeshes();
+
         std::vector<MaterialData> m_materials;
         std::vector<TexturePtr> m_textures;
         std::vector<TexturePtr> m_pendingTextures;
@@ -116,11 +198,19 @@ namespace pnkr::renderer::scene
         std::vector<BoundingBox> m_meshBounds;
         std::vector<Skin> m_skins;
         std::vector<Animation> m_animations;
+        std::vector<CompiledAnimationClip> m_compiledAnimations;
         std::vector<GltfCamera> m_cameras;
         std::vector<MorphTargetInfo> m_morphTargetInfos;
 
         std::vector<Vertex> m_cpuVertices;
         std::vector<uint32_t> m_cpuIndices;
+        std::vector<gpu::MeshletGPU> m_meshlets;
+        std::vector<OccluderMesh> m_occluderMeshes;
+
+        geometry::VertexFormat m_requestedVertexFormat = geometry::VertexFormat::Full;
+        geometry::VertexFormat m_vertexFormat = geometry::VertexFormat::Full;
+        std::vector<glm::vec4> m_meshDequant;
+        VertexUploadStats m_vertexUploadStats;
 
         std::vector<MaterialCPU> m_materialsCPU;
         std::vector<std::string> m_textureFiles;
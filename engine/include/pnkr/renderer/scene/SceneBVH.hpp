@@ -0,0 +1,99 @@
+#pragma once
+#include "pnkr/core/ECS.hpp"
+#include "pnkr/renderer/geometry/Frustum.hpp"
+#include "pnkr/renderer/scene/Bounds.hpp"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pnkr::renderer::scene {
+
+    struct BvhStats {
+        uint32_t leafCount = 0;
+        uint32_t nodeCount = 0;
+        // Leaves whose box changed in the most recent refit().
+        uint32_t refitLeaves = 0;
+        // Leaves inserted or removed since the last rebuild().
+        uint32_t churn = 0;
+        uint32_t rebuilds = 0;
+        // Surface-area cost of the tree relative to its root, measured at rebuild.
+        float sahCost = 0.0f;
+    };
+
+    struct BvhRayHit {
+        ecs::Entity entity = ecs::kNullEntity;
+        float t = std::numeric_limits<float>::max();
+
+        bool hit() const noexcept { return entity != ecs::kNullEntity; }
+    };
+
+    // Binary AABB tree with one entity per leaf. Boxes change incrementally:
+    // update() inserts or moves a leaf and refit() walks the changed leaves up
+    // to the root. rebuild() re-partitions every leaf with binned SAH, building
+    // disjoint subtrees in parallel on the task system; refit() calls it by
+    // itself once inserts and removals have churned a quarter of the tree or
+    // moving leaves have doubled the root's surface area.
+    class SceneBVH {
+    public:
+        static constexpr uint32_t kNullNode = std::numeric_limits<uint32_t>::max();
+
+        void clear();
+
+        uint32_t size() const noexcept { return m_stats.leafCount; }
+        bool empty() const noexcept { return m_root == kNullNode; }
+        bool contains(ecs::Entity entity) const noexcept {
+            return entity < m_leafOf.size() && m_leafOf[entity] != kNullNode;
+        }
+
+        // Inserts entity or records its new box. Invalid boxes remove it.
+        // Ancestor boxes catch up in refit().
+        void update(ecs::Entity entity, const BoundingBox& box);
+        void remove(ecs::Entity entity);
+        void refit();
+        void rebuild();
+
+        // Union of every leaf box; empty (invalid) when the tree is empty.
+        BoundingBox bounds() const;
+
+        // Frustum results use the plane test of geometry::cullBoxes, so both
+        // culling paths keep the same set.
+        void queryFrustum(const geometry::Frustum& frustum, std::vector<ecs::Entity>& out) const;
+        void queryAabb(const BoundingBox& box, std::vector<ecs::Entity>& out) const;
+        void querySphere(const glm::vec3& center, float radius, std::vector<ecs::Entity>& out) const;
+
+        // Closest leaf box along the ray. A ray starting inside a box hits at
+        // its exit distance.
+        BvhRayHit raycast(const glm::vec3& origin, const glm::vec3& dir,
+                          float maxT = std::numeric_limits<float>::max()) const;
+
+        const BvhStats& stats() const noexcept { return m_stats; }
+
+    private:
+        struct Node {
+            BoundingBox box;
+            uint32_t parent = kNullNode;
+            uint32_t left = kNullNode;
+            uint32_t right = kNullNode;
+            ecs::Entity entity = ecs::kNullEntity;
+
+            bool isLeaf() const noexcept { return left == kNullNode; }
+        };
+
+        uint32_t allocateNode();
+        void freeNode(uint32_t index);
+        void insertLeaf(uint32_t leaf);
+        void detachLeaf(uint32_t leaf);
+        void refitUpwards(uint32_t index);
+        void appendSubtree(uint32_t index, std::vector<ecs::Entity>& out) const;
+        bool needsRebuild() const noexcept;
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_freeNodes;
+        std::vector<uint32_t> m_leafOf;
+        std::vector<uint32_t> m_changedLeaves;
+        uint32_t m_root = kNullNode;
+        float m_builtRootArea = 0.0f;
+        bool m_rebuildPending = false;
+        BvhStats m_stats;
+    };
+}
@@ -1,10 +1,20 @@
 #pragma once
 #include "pnkr/core/ECS.hpp"
+#include "pnkr/renderer/geometry/FrustumCull.hpp"
 #include "pnkr/renderer/scene/Components.hpp"
+#include "pnkr/renderer/scene/SceneBVH.hpp"
+#include <limits>
+#include <span>
 #include <vector>
 
 namespace pnkr::renderer::scene {
 
+    struct TransformUpdateStats {
+        uint32_t nodesTouched = 0;
+        uint32_t levelsVisited = 0;
+        bool topoRebuilt = false;
+    };
+
     class SceneGraphDOD {
     public:
         ecs::Registry& registry() noexcept { return m_registry; }
@@ -13,8 +23,38 @@ namespace pnkr::renderer::scene {
         ecs::Entity createNode(ecs::Entity parent = ecs::kNullEntity);
         void destroyNode(ecs::Entity entity);
 
+        static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+
+        // Topological order grouped by hierarchy level: level l occupies
+        // [levelOffsets()[l], levelOffsets()[l + 1]) of topoOrder().
         std::vector<ecs::Entity>& topoOrder() noexcept { return m_topoOrder; }
         const std::vector<ecs::Entity>& topoOrder() const noexcept { return m_topoOrder; }
+        std::span<const uint32_t> levelOffsets() const noexcept { return m_levelOffsets; }
+        // Bumped whenever topoOrder() is rebuilt; consumers caching per-entity data resync on change.
+        uint32_t topologyVersion() const noexcept { return m_topologyVersion; }
+
+        // World matrices packed in topoOrder(), mirrored into WorldTransform.
+        std::span<const glm::mat4> worldMatrices() const noexcept { return m_worldMatrices; }
+        uint32_t slotOf(ecs::Entity entity) const noexcept {
+            return entity < m_entitySlots.size() ? m_entitySlots[entity] : kNoSlot;
+        }
+
+        // World AABBs of MeshRenderer entities packed for the SIMD frustum
+        // kernel; box i belongs to cullEntities()[i]. Slots are assigned and
+        // filled by updateWorldBounds and swap-removed by destroyNode.
+        const geometry::AabbSoA& cullBounds() const noexcept { return m_cullBounds; }
+        std::span<const ecs::Entity> cullEntities() const noexcept { return m_cullEntities; }
+        uint32_t cullSlotOf(ecs::Entity entity) const noexcept {
+            return entity < m_cullSlots.size() ? m_cullSlots[entity] : kNoSlot;
+        }
+        uint32_t acquireCullSlot(ecs::Entity entity);
+        // Safe to call concurrently for distinct slots.
+        void setCullBounds(uint32_t slot, const BoundingBox& box) { m_cullBounds.set(slot, box); }
+
+        // The same boxes as a BVH for sub-linear frustum, AABB, sphere and ray
+        // queries. Refit by updateWorldBounds; destroyNode removes leaves.
+        SceneBVH& bvh() noexcept { return m_bvh; }
+        const SceneBVH& bvh() const noexcept { return m_bvh; }
 
         std::vector<ecs::Entity>& roots() noexcept { return m_roots; }
         const std::vector<ecs::Entity>& roots() const noexcept { return m_roots; }
@@ -29,6 +69,9 @@ namespace pnkr::renderer::scene {
 
         void updateTransforms();
 
+        // Counters from the most recent transform update (reset on every call).
+        const TransformUpdateStats& transformStats() const noexcept { return m_transformStats; }
+
         void markAsChanged(ecs::Entity entity);
 
         void setParent(ecs::Entity entity, ecs::Entity parent);
@@ -41,11 +84,36 @@ namespace pnkr::renderer::scene {
 
     private:
         void updateTopoOrder();
+        bool levelsStale() const noexcept {
+            return m_levelOffsets.empty() || m_levelOffsets.back() != m_topoOrder.size();
+        }
+        void resolveComponentSlots();
+        uint32_t seedDirtySlots();
+        uint32_t propagateLevels(uint32_t firstLevel, bool full);
+        // Tags every re-propagated slot with BoundsDirtyTag and InstanceDirtyTag.
+        void markDependentsDirty(uint32_t firstLevel);
+        void releaseCullSlot(ecs::Entity entity);
 
         ecs::Registry m_registry;
         std::vector<ecs::Entity> m_topoOrder;
+        std::vector<uint32_t> m_levelOffsets;
+        std::vector<uint32_t> m_parentSlots;
+        std::vector<uint32_t> m_entitySlots;
+        std::vector<glm::mat4> m_worldMatrices;
+        std::vector<uint8_t> m_dirtySlots;
+        std::vector<size_t> m_localIndices;
+        std::vector<size_t> m_worldIndices;
+        // Pool versions m_localIndices/m_worldIndices were resolved against.
+        uint64_t m_resolvedLocalVersion = ~0ULL;
+        uint64_t m_resolvedWorldVersion = ~0ULL;
+        TransformUpdateStats m_transformStats;
+        geometry::AabbSoA m_cullBounds;
+        std::vector<ecs::Entity> m_cullEntities;
+        std::vector<uint32_t> m_cullSlots;
+        SceneBVH m_bvh;
         std::vector<ecs::Entity> m_roots;
         bool m_hierarchyDirty = false;
+        uint32_t m_topologyVersion = 0;
         ecs::Entity m_root = ecs::kNullEntity;
         uint32_t m_materialBaseIndex = 0;
     };
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <vector>
 #include "pnkr/renderer/gpu_shared/SkinningShared.h"
+#include "pnkr/renderer/scene/AnimationClip.hpp"
 
 namespace pnkr::renderer::scene
 {
@@ -18,6 +19,9 @@ namespace pnkr::renderer::scene
         uint32_t animIndexB = ~0u;
         float currentTimeB = 0.0f;
         float blendWeight = 0.0f;
+
+        AnimationCursor cursor;
+        AnimationCursor cursorB;
     };
 
     class SceneState
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "pnkr/renderer/VirtualTextureSystem.hpp"
+#include "pnkr/renderer/rhi_renderer.hpp"
+#include "pnkr/renderer/scene/Camera.hpp"
+
+namespace pnkr::renderer::scene {
+
+    // Draws a square on the XZ plane textured with one virtual texture.
+    // Sampling writes the shader's tile feedback, so the texture streams in
+    // as the camera moves over it.
+    class VirtualTexturePlane {
+    public:
+
+        void init(RHIRenderer& renderer);
+
+        // A size x size square centred on the origin.
+        void draw(rhi::RHICommandList* cmd, const Camera& camera,
+                  const VirtualTextureSystem& virtualTextures, VirtualTextureId id,
+                  float size) const;
+
+        void destroy();
+
+    private:
+        void createPipeline();
+
+        RHIRenderer* m_renderer = nullptr;
+        PipelinePtr m_pipeline;
+    };
+}
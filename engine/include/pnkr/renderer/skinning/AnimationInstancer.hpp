@@ -0,0 +1,95 @@
+#pragma once
+#include "pnkr/renderer/scene/ModelDOD.hpp"
+#include "pnkr/renderer/skinning/GlobalJointBuffer.hpp"
+#include <glm/mat4x4.hpp>
+#include <span>
+#include <vector>
+
+namespace pnkr::renderer
+{
+    class FrameManager;
+
+    struct AnimationInstancingStats
+    {
+        uint32_t instances = 0;
+        uint32_t uniquePoses = 0;
+        uint32_t jointsEvaluated = 0;   // joints in the unique palettes
+        uint32_t jointsReferenced = 0;  // joints the instances would need without sharing
+    };
+
+    // Shares clip evaluation between many instances of one prototype model.
+    // Instances only carry an AnimationState; every frame they are grouped by
+    // (prototype, clip, quantized time), each group is posed once on the
+    // prototype's scene graph, and the resulting joint palette is uploaded once
+    // to GlobalJointBuffer and referenced by every instance in the group.
+    class AnimationInstancer
+    {
+    public:
+        static constexpr uint32_t kNoPose = ~0u;
+
+        // Instances whose clip times round to the same multiple of this many
+        // seconds share a pose. 0 only shares bit-identical times.
+        void setTimeQuantum(float seconds) { m_timeQuantum = seconds; }
+        float timeQuantum() const { return m_timeQuantum; }
+
+        // entity, when set, is a SkinnedMeshRenderer in the rendered model
+        // that IndirectRenderer points at this instance's palette.
+        uint32_t addInstance(scene::ModelDOD& prototype, const scene::AnimationState& state,
+                             ecs::Entity entity = ecs::kNullEntity);
+        void clear();
+
+        uint32_t instanceCount() const { return static_cast<uint32_t>(m_instances.size()); }
+        scene::AnimationState& state(uint32_t instance) { return m_instances[instance].state; }
+        const scene::AnimationState& state(uint32_t instance) const { return m_instances[instance].state; }
+        ecs::Entity entity(uint32_t instance) const { return m_instances[instance].entity; }
+
+        // Advances every instance and evaluates the unique poses.
+        void update(float dt);
+
+        // Uploads all unique palettes in one copy; call after GlobalJointBuffer::reset().
+        void uploadPalettes(RHIRenderer& renderer, rhi::RHICommandList& cmd,
+                            FrameManager& frameManager, GlobalJointBuffer& jointBuffer);
+
+        uint32_t poseOf(uint32_t instance) const { return m_instances[instance].pose; }
+        std::span<const glm::mat4> palette(uint32_t pose) const;
+
+        // Joint range of the instance's shared palette inside GlobalJointBuffer.
+        JointAllocation jointAllocation(uint32_t instance) const;
+
+        const AnimationInstancingStats& stats() const { return m_stats; }
+
+    private:
+        struct Instance
+        {
+            scene::ModelDOD* prototype = nullptr;
+            scene::AnimationState state;
+            ecs::Entity entity = ecs::kNullEntity;
+            uint32_t pose = kNoPose;
+        };
+
+        struct PoseKey
+        {
+            scene::ModelDOD* prototype = nullptr;
+            uint32_t animIndex = 0;
+            uint64_t tick = 0;
+            uint32_t instance = 0;
+        };
+
+        struct Pose
+        {
+            uint32_t paletteOffset = 0;
+            uint32_t jointCount = 0;
+        };
+
+        uint64_t timeTick(float time) const;
+
+        std::vector<Instance> m_instances;
+        std::vector<PoseKey> m_keys;
+        std::vector<Pose> m_poses;
+        std::vector<glm::mat4> m_palettes;
+        scene::AnimationCursor m_cursor;
+        JointAllocation m_allocation{};
+        float m_timeQuantum = 0.0f;
+        AnimationInstancingStats m_stats;
+    };
+}
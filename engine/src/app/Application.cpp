@@ -1,4 +1,5 @@
 #include "pnkr/app/Application.hpp"
+#include "pnkr/assets/TextureDiskCache.hpp"
 #include "pnkr/core/cvar.hpp"
 #include "pnkr/core/logger.hpp"
 #include "pnkr/filesystem/VFS.hpp"
@@ -298,12 +299,13 @@ int Application::run() {
             std::error_code ec;
             const auto cacheDir = resolveBasePath() / ".cache";
             std::filesystem::remove_all(cacheDir, ec);
+            assets::TextureDiskCache::global().clear();
             pnkr::Log::info(
                 "Asset cache wiped. Restart application to regenerate.");
           }
           if (ImGui::IsItemHovered()) {
-            ImGui::SetTooltip("Deletes cached .pmesh and texture "
-                              "files.\nRestart to rebuild caches.");
+            ImGui::SetTooltip("Deletes cached .pmesh files and the shared "
+                              "texture cache.\nRestart to rebuild caches.");
           }
         }
         ImGui::End();
@@ -1,6 +1,7 @@
 #include "pnkr/assets/AssetImporter.hpp"
 #include "pnkr/assets/GLTFParser.hpp"
 #include "pnkr/assets/GeometryProcessor.hpp"
+#include "pnkr/assets/TextureDiskCache.hpp"
 #include "pnkr/assets/TextureCacheSystem.hpp"
 #include "pnkr/core/MemoryMappedFile.hpp"
 #include "pnkr/core/TaskSystem.hpp"
@@ -18,6 +19,7 @@
 #include <fastgltf/types.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <chrono>
 #include <cmath>
@@ -28,6 +30,8 @@
 #include <fstream>
 #include <functional>
 #include <limits>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <random>
 #include <stb_image.h>
@@ -150,290 +154,605 @@ std::optional<std::size_t> pickImageIndex(const fastgltf::Texture &texture) {
   return std::nullopt;
 }
 
-struct TextureProcessTask : enki::ITaskSet {
-  const fastgltf::Asset *m_gltf{};
-  std::vector<ImportedTexture> *m_textures{};
-  const std::vector<TextureInfo> *m_textureInfo{};
-  std::filesystem::path m_assetPath;
-  std::filesystem::path m_cacheDir;
-  uint32_t m_maxTextureSize{};
-  LoadProgress *m_progress = nullptr;
-  static constexpr uint32_t K_TEXTURES_PER_BATCH = 32;
-  core::ScopeSnapshot m_scopeSnapshot = core::Logger::captureScopes();
-
-  void ExecuteRange(enki::TaskSetPartition range, uint32_t threadnum) override {
-    PNKR_PROFILE_SCOPE("Process Textures Batch");
-    core::Logger::restoreScopes(m_scopeSnapshot);
-
-    for (uint32_t batchIdx = range.start; batchIdx < range.end; ++batchIdx) {
-      const uint32_t startTex = batchIdx * K_TEXTURES_PER_BATCH;
-      const uint32_t endTex =
-          std::min(startTex + K_TEXTURES_PER_BATCH,
-                   static_cast<uint32_t>(m_gltf->textures.size()));
-
-      for (uint32_t texIdx = startTex; texIdx < endTex; ++texIdx) {
-        PNKR_PROFILE_SCOPE("ProcessTexture");
-        const auto texStartTime = std::chrono::high_resolution_clock::now();
-        if (m_progress != nullptr) {
-          m_progress->texturesLoaded.fetch_add(1, std::memory_order_relaxed);
-        }
-        const auto imgIndexOpt = pickImageIndex((*m_gltf).textures[texIdx]);
-        if (!imgIndexOpt) {
-          core::Logger::Asset.warn("[Thread {}] Texture {} has no valid image",
-                                   threadnum, texIdx);
-          const auto texEndTime = std::chrono::high_resolution_clock::now();
-          const double totalTime =
-              std::chrono::duration<double>(texEndTime - texStartTime).count();
-          core::Logger::Asset.info("[Thread {}] Texture {} TOTAL: {:.2f}s\n",
-                                   threadnum, texIdx, totalTime);
-          continue;
-        }
+// A .pmesh stores the resolved texture paths, which may point at shared
+// cache entries evicted since it was written. Also refreshes their LRU stamp.
+bool texturesResident(const ImportedModel &model) {
+  auto &cache = TextureDiskCache::global();
+  for (const auto &tex : model.textures) {
+    if (tex.sourcePath.empty()) {
+      continue;
+    }
+    const std::filesystem::path path(tex.sourcePath);
+    const bool resident = path.parent_path() == cache.directory()
+                              ? cache.touch(path)
+                              : pathExistsNoThrow(path);
+    if (!resident) {
+      return false;
+    }
+  }
+  return true;
+}
 
-        const auto &img = (*m_gltf).images[*imgIndexOpt];
-        std::string sourceKey;
-        std::string uriPath;
-
-        const auto t1 = std::chrono::high_resolution_clock::now();
-        std::visit(fastgltf::visitor{[&](const fastgltf::sources::URI &uriSrc) {
-                                       const auto uri = getUriView(uriSrc);
-                                       if (uri.valid() && uri.isLocalPath()) {
-                                         uriPath =
-                                             normalizePathFast(
-                                                 m_assetPath.parent_path() /
-                                                 uri.fspath())
-                                                 .string();
-                                       }
-                                     },
-                                     [](auto &) {}},
-                   img.data);
-        const auto t2 = std::chrono::high_resolution_clock::now();
-        LOG_TEXTURE_DEBUG(
-            "[Thread {}] URI extraction: {:.3f}ms", threadnum,
-            std::chrono::duration<double, std::milli>(t2 - t1).count());
-
-        const bool srgb = (texIdx < m_textureInfo->size())
-                              ? ((*m_textureInfo)[texIdx].m_isSrgb)
-                              : false;
-        const LoadPriority priority =
-            (texIdx < m_textureInfo->size())
-                ? ((*m_textureInfo)[texIdx].m_priority)
-                : LoadPriority::Medium;
-
-        const bool uriExists = !uriPath.empty() && pathExistsNoThrow(uriPath);
-        const bool uriIsKtx2 =
-            uriExists && hasExtIcase(std::filesystem::path(uriPath), ".ktx2");
-
-        if (uriIsKtx2) {
-          core::Logger::Asset.info(
-              "[Thread {}] Texture {} using existing KTX2: {}", threadnum,
-              texIdx, uriPath);
-          (*m_textures)[texIdx].sourcePath = uriPath;
-          (*m_textures)[texIdx].isKtx = true;
-          (*m_textures)[texIdx].isSrgb = srgb;
-          (*m_textures)[texIdx].priority = priority;
-          const auto texEndTime = std::chrono::high_resolution_clock::now();
-          const double totalTime =
-              std::chrono::duration<double>(texEndTime - texStartTime).count();
-          core::Logger::Asset.info("[Thread {}] Texture {} TOTAL: {:.2f}s\n",
-                                   threadnum, texIdx, totalTime);
-          continue;
-        }
+using StageTask =
+    core::ScopedTask<std::function<void(enki::TaskSetPartition, uint32_t)>>;
 
-        if (uriExists) {
-          sourceKey = uriPath;
-          const auto ktxPath = TextureCacheSystem::getCachedPath(
-              m_cacheDir, sourceKey, m_maxTextureSize, srgb);
-
-          LOG_TEXTURE_INFO("[Thread {}] Texture {} source: {}", threadnum,
-                           texIdx, uriPath);
-          LOG_TEXTURE_DEBUG("[Thread {}] Cache path: {}", threadnum,
-                            ktxPath.string());
-
-          bool cacheValid = false;
-          const auto t3 = std::chrono::high_resolution_clock::now();
-          if (pathExistsNoThrow(ktxPath)) {
-            std::error_code ec;
-            auto sourceMTime = std::filesystem::last_write_time(uriPath, ec);
-            if (!ec) {
-              auto cacheMTime = std::filesystem::last_write_time(ktxPath, ec);
-              if (!ec && cacheMTime >= sourceMTime) {
-                cacheValid = true;
-              }
-            }
-          }
-          const auto t4 = std::chrono::high_resolution_clock::now();
-          LOG_TEXTURE_DEBUG(
-              "[Thread {}] Cache check: {:.3f}ms (valid: {})", threadnum,
-              std::chrono::duration<double, std::milli>(t4 - t3).count(),
-              cacheValid);
-
-          if (cacheValid) {
-            core::Logger::Asset.info("[Thread {}] Texture {} using cache: {}",
-                                     threadnum, texIdx, ktxPath.string());
-            (*m_textures)[texIdx].sourcePath = ktxPath.string();
-            (*m_textures)[texIdx].isKtx = true;
-            (*m_textures)[texIdx].isSrgb = srgb;
-            (*m_textures)[texIdx].priority = priority;
-            const auto texEndTime = std::chrono::high_resolution_clock::now();
-            const double totalTime =
-                std::chrono::duration<double>(texEndTime - texStartTime)
-                    .count();
-            core::Logger::Asset.info("[Thread {}] Texture {} TOTAL: {:.2f}s\n",
-                                     threadnum, texIdx, totalTime);
-            continue;
-          }
+// Budget for the decoded pixels of the encode chains in flight. A chain
+// larger than the budget still runs, alone.
+constexpr uint64_t kMaxInFlightEncodeBytes = 1ULL << 30;
 
-          auto mmapFile =
-              std::make_unique<pnkr::core::MemoryMappedFile>(uriPath);
-          const uint8_t *fileData = nullptr;
-          size_t fileSize = 0;
-          {
-            PNKR_PROFILE_SCOPE("FileRead");
-            const auto t5 = std::chrono::high_resolution_clock::now();
-
-            if (mmapFile->isValid()) {
-              fileData = mmapFile->data();
-              fileSize = mmapFile->size();
-            }
-            const auto t6 = std::chrono::high_resolution_clock::now();
-            LOG_TEXTURE_DEBUG(
-                "[Thread {}] Memory-mapped: {:.3f}ms ({} bytes)", threadnum,
-                std::chrono::duration<double, std::milli>(t6 - t5).count(),
-                fileSize);
-          }
-          if (fileData == nullptr || fileSize == 0) {
-            core::Logger::Asset.error(
-                "[Thread {}] Failed to memory-map texture file: {}", threadnum,
-                uriPath);
-            continue;
-          }
+double msSince(std::chrono::high_resolution_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::high_resolution_clock::now() - start)
+      .count();
+}
 
-          int w = 0;
-          int h = 0;
-          int comp = 0;
-          const auto t7 = std::chrono::high_resolution_clock::now();
-          stbi_uc *rgba = nullptr;
-          {
-            PNKR_PROFILE_SCOPE("STBI_Load");
-            rgba = stbi_load_from_memory(fileData, (int)fileSize, &w, &h, &comp,
-                                         4);
-          }
-          const auto t8 = std::chrono::high_resolution_clock::now();
-          LOG_TEXTURE_INFO(
-              "[Thread {}] Decoded {}x{} in {:.1f}ms", threadnum, w, h,
-              std::chrono::duration<double, std::milli>(t8 - t7).count());
-          if (rgba != nullptr) {
-            PNKR_PROFILE_SCOPE("CacheWrite");
-            (void)TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(
-                ktxPath, rgba, w, h, m_maxTextureSize, srgb, threadnum);
-            stbi_image_free(rgba);
-          } else {
-            core::Logger::Asset.error(
-                "[Thread {}] stbi_load failed for texture {}: {}", threadnum,
-                texIdx, stbi_failure_reason());
-            const uint8_t white[4] = {255, 255, 255, 255};
-            (void)TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(
-                ktxPath, white, 1, 1, 1, srgb, threadnum);
+// A texture that has to be decoded and BC7-encoded. Each stage is a task:
+// decode, then one resize per level (each filtered from the level above),
+// one encode per level as soon as its resize is done, and the KTX2 write
+// once every level is encoded.
+struct TextureEncodeJob {
+  uint32_t textureIndex = 0;
+  bool srgb = false;
+  uint64_t cacheKey = 0;
+  std::filesystem::path ktxPath;
+
+  // The encoded image, mapped from disk or extracted from a buffer view.
+  std::unique_ptr<core::MemoryMappedFile> file;
+  std::vector<uint8_t> embedded;
+  std::span<const uint8_t> source;
+
+  int sourceWidth = 0;
+  int sourceHeight = 0;
+  TextureMipChain chain;
+  stbi_uc *rgba = nullptr;
+  std::vector<std::vector<uint8_t>> levelRGBA;
+  std::vector<std::vector<uint8_t>> levelBC7;
+  std::vector<double> resizeMs;
+  std::vector<double> encodeMs;
+  std::atomic<bool> failed{false};
+
+  // Peak bytes held while the chain runs: the decoded source and the RGBA
+  // mip chain, plus the BC7 levels at a quarter of that.
+  uint64_t footprint() const {
+    const uint64_t source = uint64_t(sourceWidth) * uint64_t(sourceHeight) * 4;
+    const uint64_t levels = uint64_t(chain.width) * uint64_t(chain.height) * 4;
+    return source + levels + levels / 2;
+  }
+
+  std::chrono::high_resolution_clock::time_point start;
+  TextureImportStats stats;
+
+  std::unique_ptr<StageTask> decodeTask;
+  std::vector<std::unique_ptr<StageTask>> resizeTasks;
+  std::vector<std::unique_ptr<StageTask>> encodeTasks;
+  std::unique_ptr<StageTask> writeTask;
+  // enki links dependencies in place: sized once, declared after the tasks
+  // so they unlink before the tasks are destroyed.
+  std::vector<enki::Dependency> resizeDeps;
+  std::vector<enki::Dependency> encodeDeps;
+  std::vector<enki::Dependency> writeDeps;
+};
+
+class TextureImportPipeline {
+public:
+  TextureImportPipeline(const fastgltf::Asset &gltf,
+                        std::filesystem::path assetDir,
+                        std::vector<ImportedTexture> &textures,
+                        const std::vector<TextureInfo> &textureInfo,
+                        uint32_t maxTextureSize, LoadProgress *progress)
+      : m_gltf(gltf), m_assetDir(std::move(assetDir)), m_textures(textures),
+        m_textureInfo(textureInfo), m_maxTextureSize(maxTextureSize),
+        m_progress(progress) {}
+
+  // Reads every texture and probes the cache in parallel, then runs the
+  // remaining encodes largest first, as many at a time as
+  // kMaxInFlightEncodeBytes allows, and waits for them.
+  void run() {
+    PNKR_PROFILE_FUNCTION();
+    core::TaskSystem::parallelFor(
+        static_cast<uint32_t>(m_textures.size()),
+        [this](enki::TaskSetPartition range, uint32_t threadnum) {
+          for (uint32_t texIdx = range.start; texIdx < range.end; ++texIdx) {
+            resolve(texIdx, threadnum);
           }
+        });
+
+    // The biggest textures bound the critical path, so they start first and
+    // keep the highest priority through every stage.
+    std::ranges::sort(m_jobs, std::greater{}, [](const auto &job) {
+      return uint64_t(job->sourceWidth) * uint64_t(job->sourceHeight);
+    });
+    const auto jobCount = static_cast<uint32_t>(m_jobs.size());
+    for (uint32_t i = 0; i < jobCount; ++i) {
+      buildTasks(*m_jobs[i], static_cast<enki::TaskPriority>(
+                                 i * enki::TASK_PRIORITY_NUM / jobCount));
+    }
+    m_nextJob = 0;
+    m_inFlightBytes = 0;
+    launchJobs();
+    // Jobs start in order and a finished one launches the next before its
+    // write task completes, so each job is in the pipe by the time it is
+    // waited on.
+    for (auto &job : m_jobs) {
+      core::TaskSystem::scheduler().WaitforTask(job->writeTask.get());
+    }
+    if (!m_jobs.empty()) {
+      const auto slowest =
+          std::ranges::max_element(m_jobs, {}, [](const auto &job) {
+            return job->stats.totalMs;
+          });
+      core::Logger::Asset.info(
+          "AssetImporter: Encoded {} textures, slowest took {:.2f}ms",
+          m_jobs.size(), (*slowest)->stats.totalMs);
+    }
+    m_jobs.clear();
+  }
 
-          (*m_textures)[texIdx].sourcePath = ktxPath.string();
-          (*m_textures)[texIdx].isKtx = true;
-          (*m_textures)[texIdx].isSrgb = srgb;
-          (*m_textures)[texIdx].priority = priority;
-
-          const auto texEndTime = std::chrono::high_resolution_clock::now();
-          const double totalTime =
-              std::chrono::duration<double>(texEndTime - texStartTime).count();
-          core::Logger::Asset.info("[Thread {}] Texture {} TOTAL: {:.2f}s\n",
-                                   threadnum, texIdx, totalTime);
-          continue;
-        }
+  uint32_t cacheHits() const {
+    return m_cacheHits.load(std::memory_order_relaxed);
+  }
 
-        core::Logger::Asset.warn(
-            "[Thread {}] Texture {} using embedded/bufferView data", threadnum,
-            texIdx);
-        const auto contentHash = renderer::scene::hashImageBytes(
-            *m_gltf, img, m_assetPath.parent_path());
-        if (contentHash == 0) {
-          continue;
+private:
+  // Starts the next chains in order while they fit the memory budget. With
+  // nothing in flight the next one always starts.
+  void launchJobs() {
+    size_t first = 0;
+    size_t last = 0;
+    {
+      std::scoped_lock lock(m_launchMutex);
+      first = last = m_nextJob;
+      while (last < m_jobs.size()) {
+        const uint64_t bytes = m_jobs[last]->footprint();
+        if (m_inFlightBytes > 0 &&
+            m_inFlightBytes + bytes > kMaxInFlightEncodeBytes) {
+          break;
         }
+        m_inFlightBytes += bytes;
+        ++last;
+      }
+      m_nextJob = last;
+    }
+    // Outside the lock: a full pipe runs the task inline, and its chain may
+    // reach write() and come back here.
+    for (size_t i = first; i < last; ++i) {
+      core::TaskSystem::scheduler().AddTaskSetToPipe(
+          m_jobs[i]->decodeTask.get());
+    }
+  }
 
-        const auto encoded = renderer::scene::extractImageBytes(
-            *m_gltf, img, m_assetPath.parent_path());
-        if (encoded.empty()) {
-          continue;
-        }
+  void finishTexture(uint32_t texIdx, const std::string &sourcePath,
+                     TextureImportStats &stats,
+                     std::chrono::high_resolution_clock::time_point start,
+                     uint32_t threadnum) {
+    if (!sourcePath.empty()) {
+      m_textures[texIdx].sourcePath = sourcePath;
+      m_textures[texIdx].isKtx = true;
+    }
+    stats.textureIndex = texIdx;
+    stats.totalMs = msSince(start);
+    core::Logger::Asset.info("[Thread {}] Texture {} TOTAL: {:.2f}ms",
+                             threadnum, texIdx, stats.totalMs);
+    if (m_progress != nullptr) {
+      m_progress->addTextureStats(stats);
+      m_progress->texturesLoaded.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
 
-        char keyBuf[256];
-        const size_t basePathLen = m_assetPath.string().size();
-        if (basePathLen < sizeof(keyBuf) - 64) {
-          int len =
-              std::snprintf(keyBuf, sizeof(keyBuf), "%s#img%zu#tex%u#h%llu",
-                            m_assetPath.string().c_str(), *imgIndexOpt, texIdx,
-                            (unsigned long long)contentHash);
-          sourceKey = std::string(keyBuf, len);
-        } else {
-          sourceKey = m_assetPath.string() + "#img" +
-                      std::to_string(*imgIndexOpt) + "#tex" +
-                      std::to_string(texIdx) + "#h" +
-                      std::to_string((unsigned long long)contentHash);
-        }
+  void resolve(uint32_t texIdx, uint32_t threadnum) {
+    PNKR_PROFILE_SCOPE("ResolveTexture");
+    const auto texStartTime = std::chrono::high_resolution_clock::now();
+    TextureImportStats stats;
+
+    const auto imgIndexOpt = pickImageIndex(m_gltf.textures[texIdx]);
+    if (!imgIndexOpt) {
+      core::Logger::Asset.warn("[Thread {}] Texture {} has no valid image",
+                               threadnum, texIdx);
+      finishTexture(texIdx, {}, stats, texStartTime, threadnum);
+      return;
+    }
 
-        bool sourceIsKtx2 = false;
-        sourceIsKtx2 = isKtx2Magic(encoded);
-
-        std::string ktxPathStr;
-        if (sourceIsKtx2) {
-          const auto ktxPath = TextureCacheSystem::getCachedPath(
-              m_cacheDir, sourceKey, 0U, srgb);
-          if (!pathExistsNoThrow(ktxPath)) {
-            PNKR_PROFILE_SCOPE("CacheWrite_Existing");
-            (void)TextureCacheSystem::writeBytesFileAtomic(ktxPath, encoded,
-                                                           threadnum);
-          }
-          ktxPathStr = ktxPath.string();
-        } else {
-          const auto ktxPath = TextureCacheSystem::getCachedPath(
-              m_cacheDir, sourceKey, m_maxTextureSize, srgb);
-          if (!pathExistsNoThrow(ktxPath)) {
-            int w = 0;
-            int h = 0;
-            int comp = 0;
-            stbi_uc *rgba = stbi_load_from_memory(
-                encoded.data(), (int)encoded.size(), &w, &h, &comp, 4);
-            if (rgba != nullptr) {
-              PNKR_PROFILE_SCOPE("CacheWrite_Embedded");
-              (void)TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(
-                  ktxPath, rgba, w, h, m_maxTextureSize, srgb, threadnum);
-              stbi_image_free(rgba);
-            } else {
-              const uint8_t white[4] = {255, 255, 255, 255};
-              (void)TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(
-                  ktxPath, white, 1, 1, 1, srgb, threadnum);
-            }
-          }
-          ktxPathStr = ktxPath.string();
+    const auto &img = m_gltf.images[*imgIndexOpt];
+    std::string uriPath;
+    std::visit(fastgltf::visitor{[&](const fastgltf::sources::URI &uriSrc) {
+                                   const auto uri = getUriView(uriSrc);
+                                   if (uri.valid() && uri.isLocalPath()) {
+                                     uriPath = normalizePathFast(
+                                                   m_assetDir / uri.fspath())
+                                                   .string();
+                                   }
+                                 },
+                                 [](auto &) {}},
+               img.data);
+
+    const bool srgb = (texIdx < m_textureInfo.size())
+                          ? m_textureInfo[texIdx].m_isSrgb
+                          : false;
+    m_textures[texIdx].isSrgb = srgb;
+    m_textures[texIdx].priority = (texIdx < m_textureInfo.size())
+                                      ? m_textureInfo[texIdx].m_priority
+                                      : LoadPriority::Medium;
+
+    const bool uriExists = !uriPath.empty() && pathExistsNoThrow(uriPath);
+    if (uriExists && hasExtIcase(std::filesystem::path(uriPath), ".ktx2")) {
+      core::Logger::Asset.info("[Thread {}] Texture {} using existing KTX2: {}",
+                               threadnum, texIdx, uriPath);
+      stats.readMs = msSince(texStartTime);
+      finishTexture(texIdx, uriPath, stats, texStartTime, threadnum);
+      return;
+    }
+
+    TextureCacheSettings cacheSettings;
+    cacheSettings.srgb = srgb;
+    cacheSettings.maxSize = m_maxTextureSize;
+
+    auto job = std::make_unique<TextureEncodeJob>();
+    job->textureIndex = texIdx;
+    job->srgb = srgb;
+    job->start = texStartTime;
+
+    if (uriExists) {
+      LOG_TEXTURE_INFO("[Thread {}] Texture {} source: {}", threadnum, texIdx,
+                       uriPath);
+      job->file = std::make_unique<pnkr::core::MemoryMappedFile>(uriPath);
+      if (!job->file->isValid() || job->file->size() == 0) {
+        core::Logger::Asset.error(
+            "[Thread {}] Failed to memory-map texture file: {}", threadnum,
+            uriPath);
+        finishTexture(texIdx, {}, stats, texStartTime, threadnum);
+        return;
+      }
+      job->source = {job->file->data(), job->file->size()};
+
+      // Keyed by content, so a touched-but-unchanged file or the same
+      // image referenced from another asset still hits.
+      job->cacheKey = TextureDiskCache::makeKey(
+          TextureDiskCache::hashContent(job->source), cacheSettings);
+      if (const auto cached = m_cache.lookup(job->cacheKey)) {
+        core::Logger::Asset.info("[Thread {}] Texture {} using cache: {}",
+                                 threadnum, texIdx, cached->string());
+        m_cacheHits.fetch_add(1, std::memory_order_relaxed);
+        stats.cacheHit = true;
+        stats.readMs = msSince(texStartTime);
+        finishTexture(texIdx, cached->string(), stats, texStartTime,
+                      threadnum);
+        return;
+      }
+    } else {
+      core::Logger::Asset.warn(
+          "[Thread {}] Texture {} using embedded/bufferView data", threadnum,
+          texIdx);
+      const auto contentHash =
+          renderer::scene::hashImageBytes(m_gltf, img, m_assetDir);
+      if (contentHash == 0) {
+        finishTexture(texIdx, {}, stats, texStartTime, threadnum);
+        return;
+      }
+
+      // Whether the bytes are KTX2 is only known after extracting them, so
+      // probe both keys before paying for the copy.
+      auto passthroughSettings = cacheSettings;
+      passthroughSettings.encoding = TextureCacheEncoding::Passthrough;
+      passthroughSettings.maxSize = 0;
+      const uint64_t passthroughKey =
+          TextureDiskCache::makeKey(contentHash, passthroughSettings);
+      job->cacheKey = TextureDiskCache::makeKey(contentHash, cacheSettings);
+
+      std::optional<std::filesystem::path> cached =
+          m_cache.lookup(job->cacheKey);
+      if (!cached) {
+        cached = m_cache.lookup(passthroughKey);
+      }
+      if (cached) {
+        m_cacheHits.fetch_add(1, std::memory_order_relaxed);
+        stats.cacheHit = true;
+        stats.readMs = msSince(texStartTime);
+        finishTexture(texIdx, cached->string(), stats, texStartTime,
+                      threadnum);
+        return;
+      }
+
+      job->embedded = renderer::scene::extractImageBytes(m_gltf, img, m_assetDir);
+      if (job->embedded.empty()) {
+        finishTexture(texIdx, {}, stats, texStartTime, threadnum);
+        return;
+      }
+      if (isKtx2Magic(job->embedded)) {
+        PNKR_PROFILE_SCOPE("CacheWrite_Existing");
+        const auto ktxPath = m_cache.pathFor(passthroughKey);
+        if (TextureCacheSystem::writeBytesFileAtomic(ktxPath, job->embedded,
+                                                     threadnum)) {
+          m_cache.insert(passthroughKey);
         }
+        stats.readMs = msSince(texStartTime);
+        finishTexture(texIdx, ktxPath.string(), stats, texStartTime,
+                      threadnum);
+        return;
+      }
+      job->source = job->embedded;
+    }
 
-        (*m_textures)[texIdx].sourcePath = ktxPathStr;
-        (*m_textures)[texIdx].isKtx = true;
-        (*m_textures)[texIdx].isSrgb = srgb;
-        (*m_textures)[texIdx].priority = priority;
+    job->ktxPath = m_cache.pathFor(job->cacheKey);
+    int comp = 0;
+    if (stbi_info_from_memory(job->source.data(), (int)job->source.size(),
+                              &job->sourceWidth, &job->sourceHeight,
+                              &comp) == 0) {
+      core::Logger::Asset.error(
+          "[Thread {}] stbi_load failed for texture {}: {}", threadnum, texIdx,
+          stbi_failure_reason());
+      const uint8_t white[4] = {255, 255, 255, 255};
+      // Not cached: the white stand-in must not outlive a fixed source.
+      (void)TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(
+          job->ktxPath, white, 1, 1, 1, srgb, threadnum);
+      finishTexture(texIdx, job->ktxPath.string(), stats, texStartTime,
+                    threadnum);
+      return;
+    }
+    job->chain = TextureCacheSystem::planMipChain(
+        job->sourceWidth, job->sourceHeight, m_maxTextureSize);
+    job->stats.readMs = msSince(texStartTime);
 
-        const auto texEndTime = std::chrono::high_resolution_clock::now();
-        const double totalTime =
-            std::chrono::duration<double>(texEndTime - texStartTime).count();
-        core::Logger::Asset.info("[Thread {}] Texture {} TOTAL: {:.2f}s\n",
-                                 threadnum, texIdx, totalTime);
+    std::scoped_lock lock(m_jobsMutex);
+    m_jobs.push_back(std::move(job));
+  }
+
+  void buildTasks(TextureEncodeJob &job, enki::TaskPriority priority) {
+    const uint32_t levels = job.chain.levels;
+    job.levelRGBA.resize(levels);
+    job.levelBC7.resize(levels);
+    job.resizeMs.assign(levels, 0.0);
+    job.encodeMs.assign(levels, 0.0);
+
+    auto makeTask = [priority](auto &&fn) {
+      auto task = std::make_unique<StageTask>(
+          std::function<void(enki::TaskSetPartition, uint32_t)>(
+              std::forward<decltype(fn)>(fn)));
+      task->m_Priority = priority;
+      return task;
+    };
+
+    job.decodeTask = makeTask([this, &job](enki::TaskSetPartition, uint32_t) {
+      decode(job);
+    });
+    for (uint32_t level = 0; level < levels; ++level) {
+      job.resizeTasks.push_back(
+          makeTask([this, &job, level](enki::TaskSetPartition, uint32_t) {
+            resize(job, level);
+          }));
+      job.encodeTasks.push_back(
+          makeTask([this, &job, level](enki::TaskSetPartition, uint32_t) {
+            encode(job, level);
+          }));
+    }
+    job.writeTask =
+        makeTask([this, &job](enki::TaskSetPartition, uint32_t threadnum) {
+          write(job, threadnum);
+        });
+
+    job.resizeDeps.resize(levels);
+    job.encodeDeps.resize(levels);
+    job.writeDeps.resize(levels);
+    for (uint32_t level = 0; level < levels; ++level) {
+      job.resizeTasks[level]->SetDependency(
+          job.resizeDeps[level], level == 0
+                                     ? job.decodeTask.get()
+                                     : job.resizeTasks[level - 1].get());
+      job.encodeTasks[level]->SetDependency(job.encodeDeps[level],
+                                            job.resizeTasks[level].get());
+      job.writeTask->SetDependency(job.writeDeps[level],
+                                   job.encodeTasks[level].get());
+    }
+  }
+
+  void decode(TextureEncodeJob &job) {
+    PNKR_PROFILE_SCOPE("STBI_Load");
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    int w = 0;
+    int h = 0;
+    int comp = 0;
+    job.rgba = stbi_load_from_memory(job.source.data(), (int)job.source.size(),
+                                     &w, &h, &comp, 4);
+    if (job.rgba == nullptr || w != job.sourceWidth ||
+        h != job.sourceHeight) {
+      core::Logger::Asset.error("stbi_load failed for texture {}: {}",
+                                job.textureIndex, stbi_failure_reason());
+      job.failed.store(true, std::memory_order_relaxed);
+    }
+    job.source = {};
+    job.file.reset();
+    job.embedded = {};
+    job.stats.decodeMs = msSince(t0);
+  }
+
+  void resize(TextureEncodeJob &job, uint32_t level) {
+    if (job.failed.load(std::memory_order_relaxed)) {
+      return;
+    }
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    const uint32_t w = job.chain.levelWidth(level);
+    const uint32_t h = job.chain.levelHeight(level);
+    job.levelRGBA[level].resize(static_cast<size_t>(w) * h * 4);
+    if (level == 0) {
+      TextureCacheSystem::resizeLevel(
+          job.rgba, (uint32_t)job.sourceWidth, (uint32_t)job.sourceHeight,
+          job.levelRGBA[0].data(), w, h, job.srgb);
+      stbi_image_free(job.rgba);
+      job.rgba = nullptr;
+    } else {
+      TextureCacheSystem::resizeLevel(job.levelRGBA[level - 1].data(),
+                                      job.chain.levelWidth(level - 1),
+                                      job.chain.levelHeight(level - 1),
+                                      job.levelRGBA[level].data(), w, h,
+                                      job.srgb);
+    }
+    job.resizeMs[level] = msSince(t0);
+  }
+
+  void encode(TextureEncodeJob &job, uint32_t level) {
+    if (job.failed.load(std::memory_order_relaxed)) {
+      return;
+    }
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    if (!TextureCacheSystem::encodeLevelBC7(
+            job.levelRGBA[level].data(), job.chain.levelWidth(level),
+            job.chain.levelHeight(level), job.srgb, job.levelBC7[level])) {
+      core::Logger::Asset.error("BC7 compression failed for texture {} level {}",
+                                job.textureIndex, level);
+      job.failed.store(true, std::memory_order_relaxed);
+    }
+    job.encodeMs[level] = msSince(t0);
+  }
+
+  void write(TextureEncodeJob &job, uint32_t threadnum) {
+    PNKR_PROFILE_SCOPE("CacheWrite");
+    const auto t0 = std::chrono::high_resolution_clock::now();
+    if (job.rgba != nullptr) {
+      stbi_image_free(job.rgba);
+      job.rgba = nullptr;
+    }
+    job.levelRGBA.clear();
+
+    if (!job.failed.load(std::memory_order_relaxed)) {
+      if (TextureCacheSystem::writeKtx2BC7LevelsAtomic(
+              job.ktxPath, job.chain, job.levelBC7, job.srgb, threadnum)) {
+        m_cache.insert(job.cacheKey);
       }
+    } else {
+      const uint8_t white[4] = {255, 255, 255, 255};
+      // Not cached: the white stand-in must not outlive a fixed source.
+      (void)TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(
+          job.ktxPath, white, 1, 1, 1, job.srgb, threadnum);
+    }
+    job.levelBC7.clear();
+
+    job.stats.width = job.chain.width;
+    job.stats.height = job.chain.height;
+    job.stats.resizeMs = std::accumulate(job.resizeMs.begin(),
+                                         job.resizeMs.end(), 0.0);
+    job.stats.encodeMs = std::accumulate(job.encodeMs.begin(),
+                                         job.encodeMs.end(), 0.0);
+    job.stats.writeMs = msSince(t0);
+    finishTexture(job.textureIndex, job.ktxPath.string(), job.stats,
+                  job.start, threadnum);
+
+    {
+      std::scoped_lock lock(m_launchMutex);
+      m_inFlightBytes -= job.footprint();
     }
+    launchJobs();
   }
+
+  const fastgltf::Asset &m_gltf;
+  std::filesystem::path m_assetDir;
+  std::vector<ImportedTexture> &m_textures;
+  const std::vector<TextureInfo> &m_textureInfo;
+  uint32_t m_maxTextureSize = 0;
+  LoadProgress *m_progress = nullptr;
+  TextureDiskCache &m_cache = TextureDiskCache::global();
+  std::atomic<uint32_t> m_cacheHits{0};
+
+  std::mutex m_jobsMutex;
+  std::vector<std::unique_ptr<TextureEncodeJob>> m_jobs;
+
+  std::mutex m_launchMutex;
+  size_t m_nextJob = 0;
+  uint64_t m_inFlightBytes = 0;
 };
+
+// Runs GeometryProcessor::optimize and generateLods over every primitive of
+// a freshly parsed model and logs the model-wide figures.
+void optimizeModelGeometry(ImportedModel &model) {
+  PNKR_PROFILE_FUNCTION();
+  const auto start = std::chrono::high_resolution_clock::now();
+
+  std::vector<ImportedPrimitive *> prims;
+  for (auto &mesh : model.meshes) {
+    for (auto &prim : mesh.primitives) {
+      prims.push_back(&prim);
+    }
+  }
+  std::vector<MeshOptimizationStats> stats(prims.size());
+  core::TaskSystem::parallelFor(
+      util::u32(prims.size()), [&](enki::TaskSetPartition range, uint32_t) {
+        for (uint32_t i = range.start; i < range.end; ++i) {
+          stats[i] = GeometryProcessor::optimize(*prims[i]);
+          GeometryProcessor::generateLods(*prims[i]);
+          GeometryProcessor::buildMeshlets(*prims[i]);
+        }
+      });
+  model.meshesOptimized = true;
+
+  // ACMR is averaged per triangle and overfetch per vertex byte, so the
+  // totals match what a single merged mesh would report.
+  double triangles = 0.0;
+  double acmrBefore = 0.0;
+  double acmrAfter = 0.0;
+  double verticesBefore = 0.0;
+  double verticesAfter = 0.0;
+  double overfetchBefore = 0.0;
+  double overfetchAfter = 0.0;
+  size_t skipped = 0;
+  for (const auto &s : stats) {
+    if (!s.optimized) {
+      ++skipped;
+      continue;
+    }
+    triangles += s.triangles;
+    acmrBefore += double(s.acmrBefore) * s.triangles;
+    acmrAfter += double(s.acmrAfter) * s.triangles;
+    verticesBefore += s.verticesBefore;
+    verticesAfter += s.verticesAfter;
+    overfetchBefore += double(s.overfetchBefore) * s.verticesBefore;
+    overfetchAfter += double(s.overfetchAfter) * s.verticesAfter;
+  }
+
+  const double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::high_resolution_clock::now() - start)
+                        .count();
+  core::Logger::Asset.info(
+      "  Mesh optimization: {} primitives ({} skipped) in {:.2f}ms",
+      prims.size(), skipped, ms);
+  if (triangles > 0.0) {
+    core::Logger::Asset.info(
+        "  Vertices {:.0f} -> {:.0f}, ACMR {:.3f} -> {:.3f}, overfetch {:.3f} "
+        "-> {:.3f}",
+        verticesBefore, verticesAfter, acmrBefore / triangles,
+        acmrAfter / triangles, overfetchBefore / verticesBefore,
+        overfetchAfter / std::max(verticesAfter, 1.0));
+  }
+
+  // A primitive without a level of its own draws its coarsest one there.
+  std::array<uint64_t, kMaxPrimitiveLods> lodTriangles{};
+  for (const auto *prim : prims) {
+    uint64_t count = prim->indexData().size() / 3;
+    for (uint32_t level = 0; level < kMaxPrimitiveLods; ++level) {
+      if (level > 0 && level <= prim->lods.size()) {
+        count = prim->lods[level - 1].indexCount / 3;
+      }
+      lodTriangles[level] += count;
+    }
+  }
+  std::string lodSummary;
+  for (uint32_t level = 0; level < kMaxPrimitiveLods; ++level) {
+    lodSummary += std::format("{}LOD{} {}", level > 0 ? ", " : "", level,
+                              lodTriangles[level]);
+  }
+  core::Logger::Asset.info("  Triangles per LOD: {}", lodSummary);
+
+  size_t meshlets = 0;
+  size_t clustered = 0;
+  for (const auto *prim : prims) {
+    meshlets += prim->meshlets.size();
+    clustered += prim->meshlets.empty() ? 0 : 1;
+  }
+  core::Logger::Asset.info("  Meshlets: {} in {} primitives", meshlets,
+                           clustered);
+}
 } // namespace
 
 std::unique_ptr<ImportedModel>
 AssetImporter::loadGLTF(const std::filesystem::path &path,
-                        LoadProgress *progress, uint32_t maxTextureSize) {
+                        LoadProgress *progress, uint32_t maxTextureSize,
+                        bool optimizeMeshes) {
   PNKR_LOG_SCOPE(std::format("AssetImport[{}]", path.filename().string()));
   PNKR_PROFILE_FUNCTION();
   auto startTime = std::chrono::high_resolution_clock::now();
@@ -459,10 +778,22 @@ AssetImporter::loadGLTF(const std::filesystem::path &path,
       if (!ec && cacheMTime >= sourceMTime) {
         PNKR_PROFILE_SCOPE("Load PMESH Cache");
         if (renderer::io::ModelSerializer::loadPMESH(*model, pmeshPath)) {
-          core::Logger::Asset.info(
-              "AssetImporter: Loaded from binary cache '{}'",
-              pmeshPath.string());
-          cacheHit = true;
+          if (optimizeMeshes && !model->meshesOptimized) {
+            core::Logger::Asset.info(
+                "AssetImporter: '{}' holds unoptimized geometry, reimporting",
+                pmeshPath.string());
+            model = std::make_unique<ImportedModel>();
+          } else if (texturesResident(*model)) {
+            core::Logger::Asset.info(
+                "AssetImporter: Loaded from binary cache '{}'",
+                pmeshPath.string());
+            cacheHit = true;
+          } else {
+            core::Logger::Asset.info(
+                "AssetImporter: '{}' references evicted textures, reimporting",
+                pmeshPath.string());
+            model = std::make_unique<ImportedModel>();
+          }
         }
       }
     }
@@ -602,37 +933,16 @@ AssetImporter::loadGLTF(const std::filesystem::path &path,
   }
 
   // Process textures using the TaskSystem
+  size_t texturesCacheHit = 0;
   if (!gltf.textures.empty()) {
-    std::filesystem::path cacheDir = path.parent_path() / ".cache" / "textures";
-    std::error_code ec;
-    if (!std::filesystem::exists(cacheDir)) {
-      std::filesystem::create_directories(cacheDir, ec);
-      if (ec) {
-        core::Logger::Asset.error(
-            "AssetImporter: Failed to create texture cache directory '{}': {}",
-            cacheDir.string(), ec.message());
-      }
-    }
-
     core::Logger::Asset.info("AssetImporter: Processing {} textures...",
                              gltf.textures.size());
 
-    TextureProcessTask textureTask;
-    textureTask.m_gltf = &gltf;
-    textureTask.m_textures = &model->textures;
-    textureTask.m_textureInfo = &textureInfo;
-    textureTask.m_assetPath = path.parent_path();
-    textureTask.m_cacheDir = path.parent_path() / ".cache" / "textures";
-    textureTask.m_maxTextureSize = maxTextureSize;
-    textureTask.m_progress = progress;
-
-    const uint32_t numBatches =
-        (gltf.textures.size() + TextureProcessTask::K_TEXTURES_PER_BATCH - 1) /
-        TextureProcessTask::K_TEXTURES_PER_BATCH;
-    textureTask.m_SetSize = numBatches;
-
-    core::TaskSystem::scheduler().AddTaskSetToPipe(&textureTask);
-    core::TaskSystem::scheduler().WaitforTask(&textureTask);
+    TextureImportPipeline pipeline(gltf, path.parent_path(), model->textures,
+                                   textureInfo, maxTextureSize, progress);
+    pipeline.run();
+    TextureDiskCache::global().flush();
+    texturesCacheHit = pipeline.cacheHits();
 
     core::Logger::Asset.info("AssetImporter: Texture processing complete");
   }
@@ -644,13 +954,9 @@ AssetImporter::loadGLTF(const std::filesystem::path &path,
       std::chrono::duration<double, std::milli>(endTime - startTime).count();
 
   size_t texturesProcessed = 0;
-  size_t texturesCacheHit = 0;
   for (const auto &tex : model->textures) {
     if (!tex.sourcePath.empty()) {
       texturesProcessed++;
-      if (tex.sourcePath.find(".cache") != std::string::npos) {
-        texturesCacheHit++;
-      }
     }
   }
 
@@ -667,12 +973,15 @@ AssetImporter::loadGLTF(const std::filesystem::path &path,
   uint32_t totalIndices = 0;
   for (const auto &mesh : model->meshes) {
     for (const auto &prim : mesh.primitives) {
-      totalVertices += (uint32_t)prim.vertices.size();
-      totalIndices += (uint32_t)prim.indices.size();
+      totalVertices += (uint32_t)prim.vertexData().size();
+      totalIndices += (uint32_t)prim.indexData().size();
     }
   }
   core::Logger::Asset.info("  Geometry: {} vertices, {} indices", totalVertices,
                            totalIndices);
+  if (optimizeMeshes) {
+    optimizeModelGeometry(*model);
+  }
 
   if (progress != nullptr) {
     progress->currentStage.store(LoadStage::Complete,
@@ -1,60 +1,150 @@
 #include "pnkr/assets/BC7Encoder.hpp"
+#include "pnkr/core/TaskSystem.hpp"
 #include "pnkr/core/logger.hpp"
+#include "pnkr/core/profiler.hpp"
 
 #include "cmp_core.h"
 #include <algorithm>
+#include <array>
 #include <cstring>
 
 namespace pnkr::assets {
 
-bool BC7Encoder::compress(const uint8_t *srcRGBA, uint32_t width,
-                          uint32_t height, BC7EncoderConfig config,
-                          std::vector<uint8_t> &outCompressedData) {
-  if (!srcRGBA || width == 0 || height == 0) {
-    return false;
+namespace {
+
+// Fast matches the previous hard-coded qualityLevel = 1 (quality 0.1).
+// Fastest only searches modes 1, 5 and 6, which still covers alpha.
+constexpr std::array<BC7QualityPreset, static_cast<size_t>(BC7Quality::Count)>
+    kQualityPresets = {{
+        {"Fastest", 0.05f, 0x62, 5.0f, 80.0f},
+        {"Fast", 0.10f, 0xFF, 5.0f, 80.0f},
+        {"Normal", 0.30f, 0xFF, 5.0f, 80.0f},
+        {"High", 0.60f, 0xFF, 5.0f, 80.0f},
+        {"Max", 1.00f, 0xFF, 5.0f, 80.0f},
+    }};
+
+struct OptionsBC7 {
+  explicit OptionsBC7(const BC7QualityPreset &preset) {
+    CreateOptionsBC7(&handle);
+    if (handle) {
+      SetErrorThresholdBC7(handle, preset.minThreshold, preset.maxThreshold);
+      SetQualityBC7(handle, preset.quality);
+      SetMaskBC7(handle, preset.modeMask);
+    }
+  }
+  ~OptionsBC7() {
+    if (handle) {
+      DestroyOptionsBC7(handle);
+    }
   }
+  OptionsBC7(const OptionsBC7 &) = delete;
+  OptionsBC7 &operator=(const OptionsBC7 &) = delete;
 
-  // BC7 works on 4x4 blocks
-  uint32_t blocksX = (width + 3) / 4;
-  uint32_t blocksY = (height + 3) / 4;
+  void *handle = nullptr;
+};
 
-  outCompressedData.resize(blocksX * blocksY * 16);
+void compressBlockRow(const BC7SourceImage &image, uint32_t by,
+                      uint8_t *dstRow, const void *options) {
+  const uint32_t blocksX = (image.width + 3) / 4;
+  const uint32_t stride = image.width * 4;
+  const uint32_t y0 = by * 4;
+  const bool fullRow = y0 + 4 <= image.height;
 
-  void *options = nullptr;
-  CreateOptionsBC7(&options);
-  if (options) {
-    float quality = std::clamp((float)config.qualityLevel / 10.0f, 0.0f, 1.0f);
-    if (quality == 0.0f)
-      quality = 0.05f;
-    SetQualityBC7(options, quality);
-  }
+  for (uint32_t bx = 0; bx < blocksX; ++bx) {
+    const uint32_t x0 = bx * 4;
+    uint8_t *dstBlock = dstRow + bx * 16;
 
-  // Compressonator Core BC7 encoder works block by block
-  for (uint32_t by = 0; by < blocksY; ++by) {
-    for (uint32_t bx = 0; bx < blocksX; ++bx) {
-      uint8_t blockRGBA[64]; // 4x4x4
+    // Interior blocks are read in place; CompressBlockBC7 takes a row stride.
+    if (fullRow && x0 + 4 <= image.width) {
+      CompressBlockBC7(image.rgba + y0 * stride + x0 * 4, stride, dstBlock,
+                       options);
+      continue;
+    }
 
-      // Fill 4x4 block, handle padding if image size is not multiple of 4
-      for (uint32_t y = 0; y < 4; ++y) {
-        uint32_t py = std::min(by * 4 + y, height - 1);
-        for (uint32_t x = 0; x < 4; ++x) {
-          uint32_t px = std::min(bx * 4 + x, width - 1);
-          const uint8_t *pixel = srcRGBA + (py * width + px) * 4;
-          memcpy(blockRGBA + (y * 4 + x) * 4, pixel, 4);
-        }
+    // Edge blocks clamp to the last row/column.
+    uint8_t blockRGBA[64];
+    const uint32_t validX = std::min(4U, image.width - x0);
+    for (uint32_t y = 0; y < 4; ++y) {
+      const uint32_t py = std::min(y0 + y, image.height - 1);
+      const uint8_t *srcRow = image.rgba + py * stride + x0 * 4;
+      uint8_t *dst = blockRGBA + y * 16;
+      std::memcpy(dst, srcRow, validX * 4);
+      for (uint32_t x = validX; x < 4; ++x) {
+        std::memcpy(dst + x * 4, srcRow + (validX - 1) * 4, 4);
       }
+    }
+    CompressBlockBC7(blockRGBA, 16, dstBlock, options);
+  }
+}
 
-      uint8_t *dstBlock = outCompressedData.data() + (by * blocksX + bx) * 16;
+} // namespace
+
+const BC7QualityPreset &bc7QualityPreset(BC7Quality quality) {
+  const auto index = std::min(static_cast<size_t>(quality),
+                              kQualityPresets.size() - 1);
+  return kQualityPresets[index];
+}
 
-      // CompressBlockBC7 expects 4x4 block in RGBA8888
-      CompressBlockBC7(blockRGBA, 16, dstBlock, options);
+bool BC7Encoder::compress(const uint8_t *srcRGBA, uint32_t width,
+                          uint32_t height, BC7EncoderConfig config,
+                          std::vector<uint8_t> &outCompressedData) {
+  const BC7SourceImage image{srcRGBA, width, height};
+  std::vector<std::vector<uint8_t>> out;
+  if (!compressLevels({&image, 1}, config, out)) {
+    return false;
+  }
+  outCompressedData = std::move(out[0]);
+  return true;
+}
+
+bool BC7Encoder::compressLevels(
+    std::span<const BC7SourceImage> images, BC7EncoderConfig config,
+    std::vector<std::vector<uint8_t>> &outCompressedData) {
+  PNKR_PROFILE_FUNCTION();
+
+  if (images.empty()) {
+    return false;
+  }
+  for (const auto &image : images) {
+    if (!image.rgba || image.width == 0 || image.height == 0) {
+      return false;
     }
   }
 
-  if (options) {
-    DestroyOptionsBC7(options);
+  // Block rows of all images are flattened into one index space so a single
+  // parallelFor balances the base level against the whole mip tail.
+  std::vector<uint32_t> firstRow(images.size() + 1, 0);
+  outCompressedData.resize(images.size());
+  for (size_t i = 0; i < images.size(); ++i) {
+    const uint32_t blocksX = (images[i].width + 3) / 4;
+    const uint32_t blocksY = (images[i].height + 3) / 4;
+    outCompressedData[i].resize(static_cast<size_t>(blocksX) * blocksY * 16);
+    firstRow[i + 1] = firstRow[i] + blocksY;
+  }
+
+  const OptionsBC7 options(bc7QualityPreset(config.quality));
+  if (!options.handle) {
+    core::Logger::Asset.error("BC7: failed to create encoder options");
+    return false;
   }
 
+  core::TaskSystem::parallelFor(
+      firstRow.back(),
+      [&](enki::TaskSetPartition range, uint32_t) {
+        PNKR_PROFILE_SCOPE("BC7 Block Rows");
+        for (uint32_t row = range.start; row < range.end; ++row) {
+          const auto it =
+              std::upper_bound(firstRow.begin(), firstRow.end(), row) - 1;
+          const auto level = static_cast<size_t>(it - firstRow.begin());
+          const uint32_t by = row - *it;
+          const uint32_t rowBytes = ((images[level].width + 3) / 4) * 16;
+          compressBlockRow(images[level], by,
+                           outCompressedData[level].data() +
+                               static_cast<size_t>(by) * rowBytes,
+                           options.handle);
+        }
+      });
+
   return true;
 }
 
@@ -4,6 +4,7 @@
 #include "pnkr/renderer/scene/GLTFUtils.hpp"
 #include "pnkr/renderer/scene/Light.hpp"
 #include "pnkr/core/logger.hpp"
+#include "pnkr/core/TaskSystem.hpp"
 #include <fastgltf/glm_element_traits.hpp>
 #include <fastgltf/tools.hpp>
 #include <fastgltf/types.hpp>
@@ -188,6 +189,251 @@ namespace pnkr::assets {
             return true;
         }
 
+        // Decodes one glTF primitive into impPrim. Every attribute is written
+        // straight into storage sized from its accessor. Returns false for
+        // primitives without positions, which are dropped.
+        bool decodePrimitive(const fastgltf::Asset& gltf,
+            const fastgltf::Primitive& gPrim, size_t meshIdx,
+            uint32_t defaultMaterialIndex, ImportedPrimitive& impPrim)
+        {
+            impPrim.materialIndex = gPrim.materialIndex.has_value()
+                ? static_cast<uint32_t>(gPrim.materialIndex.value())
+                : defaultMaterialIndex;
+
+            const auto* itPos = gPrim.findAttribute("POSITION");
+            if (itPos == gPrim.attributes.end()) {
+                return false;
+            }
+
+            const auto& posAccessor = gltf.accessors[itPos->accessorIndex];
+            size_t vCount = posAccessor.count;
+            impPrim.vertices.resize(vCount);
+
+            for (size_t i = 0; i < vCount; ++i)
+            {
+                impPrim.vertices[i].position =
+                    glm::vec4(0.0F, 0.0F, 0.0F, 1.0F);
+                impPrim.vertices[i].color = glm::vec4(1.0F);
+                impPrim.vertices[i].normal =
+                    glm::vec4(0.0F, 1.0F, 0.0F, 0.0F);
+                impPrim.vertices[i].meshIndex = (uint32_t)meshIdx;
+                impPrim.vertices[i].localIndex = (uint32_t)i;
+            }
+
+            glm::vec3 pMin(std::numeric_limits<float>::max());
+            glm::vec3 pMax(std::numeric_limits<float>::lowest());
+
+            if (!tryFastPath<glm::vec3, 3>(gltf, posAccessor, impPrim.vertices,
+                offsetof(renderer::Vertex, position)))
+            {
+                fastgltf::iterateAccessorWithIndex<glm::vec3>(
+                    gltf, posAccessor, [&](glm::vec3 pos, size_t idx) {
+                        impPrim.vertices[idx].position =
+                            glm::vec4(pos, 1.0F);
+                        pMin = glm::min(pMin, pos);
+                        pMax = glm::max(pMax, pos);
+                    });
+            }
+            else
+            {
+
+                for (const auto& v : impPrim.vertices)
+                {
+                    pMin = glm::min(pMin, glm::vec3(v.position));
+                    pMax = glm::max(pMax, glm::vec3(v.position));
+                }
+            }
+
+            impPrim.minPos = pMin;
+            impPrim.maxPos = pMax;
+
+            if (const auto* it = gPrim.findAttribute("NORMAL"); it != gPrim.attributes.end())
+            {
+                if (!tryFastPath<glm::vec3, 3>(gltf, gltf.accessors[it->accessorIndex], impPrim.vertices,
+                    offsetof(renderer::Vertex, normal)))
+                {
+                    fastgltf::iterateAccessorWithIndex<glm::vec3>(
+                        gltf, gltf.accessors[it->accessorIndex],
+                        [&](glm::vec3 norm, size_t idx) {
+                            impPrim.vertices[idx].normal =
+                                glm::vec4(norm, 0.0F);
+                        });
+                }
+            }
+            if (const auto* it = gPrim.findAttribute("TEXCOORD_0"); it != gPrim.attributes.end())
+            {
+                if (!tryFastPath<glm::vec2, 2>(gltf, gltf.accessors[it->accessorIndex], impPrim.vertices,
+                    offsetof(renderer::Vertex, uv0)))
+                {
+                    fastgltf::iterateAccessorWithIndex<glm::vec2>(
+                        gltf, gltf.accessors[it->accessorIndex], [&](glm::vec2 uv, size_t idx)
+                        {
+                            impPrim.vertices[idx].uv0 = uv;
+                        });
+                }
+            }
+            if (const auto* it = gPrim.findAttribute("TEXCOORD_1"); it != gPrim.attributes.end())
+            {
+                if (!tryFastPath<glm::vec2, 2>(gltf, gltf.accessors[it->accessorIndex], impPrim.vertices,
+                    offsetof(renderer::Vertex, uv1)))
+                {
+                    fastgltf::iterateAccessorWithIndex<glm::vec2>(
+                        gltf, gltf.accessors[it->accessorIndex], [&](glm::vec2 uv, size_t idx)
+                        {
+                            impPrim.vertices[idx].uv1 = uv;
+                        });
+                }
+            }
+            if (const auto* it = gPrim.findAttribute("COLOR_0"); it != gPrim.attributes.end())
+            {
+                const auto& accessor = gltf.accessors[it->accessorIndex];
+                if (accessor.type == fastgltf::AccessorType::Vec4)
+                {
+                    if (!tryFastPath<glm::vec4, 4>(gltf, accessor, impPrim.vertices,
+                        offsetof(renderer::Vertex, color)))
+                    {
+                        fastgltf::iterateAccessorWithIndex<glm::vec4>(
+                            gltf, accessor,
+                            [&](glm::vec4 col, size_t idx) {
+                                impPrim.vertices[idx].color = col;
+                            });
+                    }
+                }
+                else
+                {
+                    if (!tryFastPath<glm::vec3, 3>(gltf, accessor, impPrim.vertices,
+                        offsetof(renderer::Vertex, color)))
+                    {
+                        fastgltf::iterateAccessorWithIndex<glm::vec3>(
+                            gltf, accessor,
+                            [&](glm::vec3 col, size_t idx) {
+                                impPrim.vertices[idx].color =
+                                    glm::vec4(col, 1.0F);
+                            });
+                    }
+                }
+            }
+            bool hasTangents = false;
+            if (const auto* it = gPrim.findAttribute("TANGENT"); it != gPrim.attributes.end())
+            {
+                hasTangents = true;
+                if (!tryFastPath<glm::vec4, 4>(gltf, gltf.accessors[it->accessorIndex], impPrim.vertices,
+                    offsetof(renderer::Vertex, tangent)))
+                {
+                    fastgltf::iterateAccessorWithIndex<glm::vec4>(
+                        gltf, gltf.accessors[it->accessorIndex], [&](glm::vec4 tan, size_t idx)
+                        {
+                            impPrim.vertices[idx].tangent = tan;
+                        });
+                }
+            }
+            if (const auto* it = gPrim.findAttribute("JOINTS_0"); it != gPrim.attributes.end())
+            {
+                fastgltf::iterateAccessorWithIndex<glm::uvec4>(gltf, gltf.accessors[it->accessorIndex],
+                    [&](glm::uvec4 joints, size_t idx)
+                    {
+                        impPrim.vertices[idx].joints = joints;
+                    });
+            }
+            if (const auto* it = gPrim.findAttribute("WEIGHTS_0"); it != gPrim.attributes.end())
+            {
+                fastgltf::iterateAccessorWithIndex<glm::vec4>(gltf, gltf.accessors[it->accessorIndex],
+                    [&](glm::vec4 weights, size_t idx)
+                    {
+                        impPrim.vertices[idx].weights = weights;
+                    });
+            }
+
+            if (gPrim.indicesAccessor.has_value())
+            {
+                const auto& acc = gltf.accessors[gPrim.indicesAccessor.value()];
+                impPrim.indices.resize(acc.count);
+                if (acc.componentType == fastgltf::ComponentType::UnsignedByte)
+                {
+                    fastgltf::iterateAccessorWithIndex<std::uint8_t>(gltf, acc, [&](std::uint8_t v, size_t i)
+                        {
+                            impPrim.indices[i] = v;
+                        });
+                }
+                else if (acc.componentType == fastgltf::ComponentType::UnsignedShort)
+                {
+                    fastgltf::iterateAccessorWithIndex<std::uint16_t>(gltf, acc, [&](std::uint16_t v, size_t i)
+                        {
+                            impPrim.indices[i] = v;
+                        });
+                }
+                else
+                {
+                    fastgltf::iterateAccessorWithIndex<std::uint32_t>(gltf, acc, [&](std::uint32_t v, size_t i)
+                        {
+                            impPrim.indices[i] = v;
+                        });
+                }
+            }
+            else
+            {
+                impPrim.indices.resize(vCount);
+                for (size_t i = 0; i < vCount; ++i) {
+                    impPrim.indices[i] = static_cast<uint32_t>(i);
+                }
+            }
+
+            if (!hasTangents &&
+                gPrim.findAttribute("NORMAL") != gPrim.attributes.end() &&
+                gPrim.findAttribute("TEXCOORD_0") != gPrim.attributes.end())
+            {
+                GeometryProcessor::generateTangents(impPrim);
+            }
+
+            impPrim.targets.resize(gPrim.targets.size());
+            for (size_t t = 0; t < gPrim.targets.size(); ++t)
+            {
+                const auto& gTarget = gPrim.targets[t];
+                auto& impTarget = impPrim.targets[t];
+                impTarget.positionDeltas.resize(vCount,
+                    glm::vec3(0.0F));
+                impTarget.normalDeltas.resize(vCount,
+                    glm::vec3(0.0F));
+                impTarget.tangentDeltas.resize(vCount,
+                    glm::vec3(0.0F));
+
+                const auto* posIt = std::ranges::find_if(
+                    gTarget, [](const fastgltf::Attribute& a) {
+                        return a.name == "POSITION";
+                    });
+                if (posIt != gTarget.end())
+                {
+                    fastgltf::iterateAccessorWithIndex<glm::vec3>(
+                        gltf, gltf.accessors[posIt->accessorIndex],
+                        [&](glm::vec3 v, size_t idx) { impTarget.positionDeltas[idx] = v; });
+                }
+
+                const auto* normIt = std::ranges::find_if(
+                    gTarget, [](const fastgltf::Attribute& a) {
+                        return a.name == "NORMAL";
+                    });
+                if (normIt != gTarget.end())
+                {
+                    fastgltf::iterateAccessorWithIndex<glm::vec3>(
+                        gltf, gltf.accessors[normIt->accessorIndex],
+                        [&](glm::vec3 v, size_t idx) { impTarget.normalDeltas[idx] = v; });
+                }
+
+                const auto* tangIt = std::ranges::find_if(
+                    gTarget, [](const fastgltf::Attribute& a) {
+                        return a.name == "TANGENT";
+                    });
+                if (tangIt != gTarget.end())
+                {
+                    fastgltf::iterateAccessorWithIndex<glm::vec3>(
+                        gltf, gltf.accessors[tangIt->accessorIndex],
+                        [&](glm::vec3 v, size_t idx) { impTarget.tangentDeltas[idx] = v; });
+                }
+            }
+
+            return true;
+        }
+
     } // namespace
 
     void GLTFParser::populateModel(ImportedModel& model, const fastgltf::Asset& gltf, LoadProgress* progress)
@@ -375,266 +621,59 @@ namespace pnkr::assets {
                     std::memory_order_relaxed);
             }
 
+            // Meshes and their primitive slots are sized up front so the
+            // primitives can be decoded as independent tasks and still land
+            // in glTF order.
+            struct PrimitiveSlot {
+                size_t mesh;
+                size_t primitive;
+            };
+            std::vector<PrimitiveSlot> slots;
+            model.meshes.resize(gltf.meshes.size());
             for (size_t meshIdx = 0; meshIdx < gltf.meshes.size(); ++meshIdx)
             {
                 const auto& gMesh = gltf.meshes[meshIdx];
-                ImportedMesh impMesh;
-                impMesh.name = gMesh.name;
-                impMesh.primitives.reserve(gMesh.primitives.size());
-
-                for (const auto& gPrim : gMesh.primitives)
-                {
-                    if (progress != nullptr) {
-                        progress->meshesProcessed.fetch_add(
-                            1, std::memory_order_relaxed);
-                    }
-                    ImportedPrimitive impPrim;
-                    impPrim.materialIndex = gPrim.materialIndex.has_value()
-                        ? static_cast<uint32_t>(gPrim.materialIndex.value())
-                        : defaultMaterialIndex;
-
-                    const auto* itPos = gPrim.findAttribute("POSITION");
-                    if (itPos == gPrim.attributes.end()) {
-                        continue;
-                    }
-
-                    const auto& posAccessor = gltf.accessors[itPos->accessorIndex];
-                    size_t vCount = posAccessor.count;
-                    impPrim.vertices.resize(vCount);
-
-                    for (size_t i = 0; i < vCount; ++i)
-                    {
-                        impPrim.vertices[i].position =
-                            glm::vec4(0.0F, 0.0F, 0.0F, 1.0F);
-                        impPrim.vertices[i].color = glm::vec4(1.0F);
-                        impPrim.vertices[i].normal =
-                            glm::vec4(0.0F, 1.0F, 0.0F, 0.0F);
-                        impPrim.vertices[i].meshIndex = (uint32_t)meshIdx;
-                        impPrim.vertices[i].localIndex = (uint32_t)i;
-                    }
-
-                    glm::vec3 pMin(std::numeric_limits<float>::max());
-                    glm::vec3 pMax(std::numeric_limits<float>::lowest());
-
-                    if (!tryFastPath<glm::vec3, 3>(gltf, posAccessor, impPrim.vertices,
-                        offsetof(renderer::Vertex, position)))
-                    {
-                        fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                            gltf, posAccessor, [&](glm::vec3 pos, size_t idx) {
-                                impPrim.vertices[idx].position =
-                                    glm::vec4(pos, 1.0F);
-                                pMin = glm::min(pMin, pos);
-                                pMax = glm::max(pMax, pos);
-                            });
-                    }
-                    else
-                    {
-
-                        for (const auto& v : impPrim.vertices)
-                        {
-                            pMin = glm::min(pMin, glm::vec3(v.position));
-                            pMax = glm::max(pMax, glm::vec3(v.position));
-                        }
-                    }
-
-                    impPrim.minPos = pMin;
-                    impPrim.maxPos = pMax;
-
-                    if (const auto* it = gPrim.findAttribute("NORMAL"); it != gPrim.attributes.end())
-                    {
-                        if (!tryFastPath<glm::vec3, 3>(gltf, gltf.accessors[it->accessorIndex], impPrim.vertices,
-                            offsetof(renderer::Vertex, normal)))
-                        {
-                            fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                                gltf, gltf.accessors[it->accessorIndex],
-                                [&](glm::vec3 norm, size_t idx) {
-                                    impPrim.vertices[idx].normal =
-                                        glm::vec4(norm, 0.0F);
-                                });
-                        }
-                    }
-                    if (const auto* it = gPrim.findAttribute("TEXCOORD_0"); it != gPrim.attributes.end())
-                    {
-                        if (!tryFastPath<glm::vec2, 2>(gltf, gltf.accessors[it->accessorIndex], impPrim.vertices,
-                            offsetof(renderer::Vertex, uv0)))
-                        {
-                            fastgltf::iterateAccessorWithIndex<glm::vec2>(
-                                gltf, gltf.accessors[it->accessorIndex], [&](glm::vec2 uv, size_t idx)
-                                {
-                                    impPrim.vertices[idx].uv0 = uv;
-                                });
-                        }
-                    }
-                    if (const auto* it = gPrim.findAttribute("TEXCOORD_1"); it != gPrim.attributes.end())
-                    {
-                        if (!tryFastPath<glm::vec2, 2>(gltf, gltf.accessors[it->accessorIndex], impPrim.vertices,
-                            offsetof(renderer::Vertex, uv1)))
-                        {
-                            fastgltf::iterateAccessorWithIndex<glm::vec2>(
-                                gltf, gltf.accessors[it->accessorIndex], [&](glm::vec2 uv, size_t idx)
-                                {
-                                    impPrim.vertices[idx].uv1 = uv;
-                                });
-                        }
-                    }
-                    if (const auto* it = gPrim.findAttribute("COLOR_0"); it != gPrim.attributes.end())
-                    {
-                        const auto& accessor = gltf.accessors[it->accessorIndex];
-                        if (accessor.type == fastgltf::AccessorType::Vec4)
-                        {
-                            if (!tryFastPath<glm::vec4, 4>(gltf, accessor, impPrim.vertices,
-                                offsetof(renderer::Vertex, color)))
-                            {
-                                fastgltf::iterateAccessorWithIndex<glm::vec4>(
-                                    gltf, accessor,
-                                    [&](glm::vec4 col, size_t idx) {
-                                        if (idx < 5) {
-                                            core::Logger::Scene.info(
-                                                "Loaded Vec4 Color {}: {}, {}, {}, "
-                                                "{}",
-                                                idx, col.r, col.g, col.b, col.a);
-                                        }
-                                        impPrim.vertices[idx].color = col;
-                                    });
-                            }
-                        }
-                        else
-                        {
-                            if (!tryFastPath<glm::vec3, 3>(gltf, accessor, impPrim.vertices,
-                                offsetof(renderer::Vertex, color)))
-                            {
-                                fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                                    gltf, accessor,
-                                    [&](glm::vec3 col, size_t idx) {
-                                        impPrim.vertices[idx].color =
-                                            glm::vec4(col, 1.0F);
-                                    });
-                            }
-                        }
-                    }
-                    bool hasTangents = false;
-                    if (const auto* it = gPrim.findAttribute("TANGENT"); it != gPrim.attributes.end())
-                    {
-                        hasTangents = true;
-                        if (!tryFastPath<glm::vec4, 4>(gltf, gltf.accessors[it->accessorIndex], impPrim.vertices,
-                            offsetof(renderer::Vertex, tangent)))
-                        {
-                            fastgltf::iterateAccessorWithIndex<glm::vec4>(
-                                gltf, gltf.accessors[it->accessorIndex], [&](glm::vec4 tan, size_t idx)
-                                {
-                                    impPrim.vertices[idx].tangent = tan;
-                                });
-                        }
-                    }
-                    if (const auto* it = gPrim.findAttribute("JOINTS_0"); it != gPrim.attributes.end())
-                    {
-                        fastgltf::iterateAccessorWithIndex<glm::uvec4>(gltf, gltf.accessors[it->accessorIndex],
-                            [&](glm::uvec4 joints, size_t idx)
-                            {
-                                impPrim.vertices[idx].joints = joints;
-                            });
-                    }
-                    if (const auto* it = gPrim.findAttribute("WEIGHTS_0"); it != gPrim.attributes.end())
-                    {
-                        fastgltf::iterateAccessorWithIndex<glm::vec4>(gltf, gltf.accessors[it->accessorIndex],
-                            [&](glm::vec4 weights, size_t idx)
-                            {
-                                impPrim.vertices[idx].weights = weights;
-                            });
-                    }
+                model.meshes[meshIdx].name = gMesh.name;
+                model.meshes[meshIdx].primitives.resize(gMesh.primitives.size());
+                for (size_t primIdx = 0; primIdx < gMesh.primitives.size(); ++primIdx) {
+                    slots.push_back({meshIdx, primIdx});
+                }
+            }
 
-                    if (gPrim.indicesAccessor.has_value())
-                    {
-                        const auto& acc = gltf.accessors[gPrim.indicesAccessor.value()];
-                        impPrim.indices.resize(acc.count);
-                        if (acc.componentType == fastgltf::ComponentType::UnsignedByte)
-                        {
-                            fastgltf::iterateAccessorWithIndex<std::uint8_t>(gltf, acc, [&](std::uint8_t v, size_t i)
-                                {
-                                    impPrim.indices[i] = v;
-                                });
-                        }
-                        else if (acc.componentType == fastgltf::ComponentType::UnsignedShort)
-                        {
-                            fastgltf::iterateAccessorWithIndex<std::uint16_t>(gltf, acc, [&](std::uint16_t v, size_t i)
-                                {
-                                    impPrim.indices[i] = v;
-                                });
-                        }
-                        else
-                        {
-                            fastgltf::iterateAccessorWithIndex<std::uint32_t>(gltf, acc, [&](std::uint32_t v, size_t i)
-                                {
-                                    impPrim.indices[i] = v;
-                                });
-                        }
-                    }
-                    else
+            std::vector<uint8_t> decoded(slots.size(), 0);
+            core::TaskSystem::parallelFor(
+                static_cast<uint32_t>(slots.size()),
+                [&](enki::TaskSetPartition range, uint32_t) {
+                    for (uint32_t i = range.start; i < range.end; ++i)
                     {
-                        impPrim.indices.resize(vCount);
-                        for (size_t i = 0; i < vCount; ++i) {
-                            impPrim.indices[i] = static_cast<uint32_t>(i);
+                        const auto& slot = slots[i];
+                        decoded[i] = decodePrimitive(gltf,
+                            gltf.meshes[slot.mesh].primitives[slot.primitive],
+                            slot.mesh, defaultMaterialIndex,
+                            model.meshes[slot.mesh].primitives[slot.primitive]) ? 1 : 0;
+                        if (progress != nullptr) {
+                            progress->meshesProcessed.fetch_add(
+                                1, std::memory_order_relaxed);
                         }
                     }
+                });
 
-                    if (!hasTangents &&
-                        gPrim.findAttribute("NORMAL") != gPrim.attributes.end() &&
-                        gPrim.findAttribute("TEXCOORD_0") != gPrim.attributes.end())
-                    {
-                        GeometryProcessor::generateTangents(impPrim);
+            // Drop primitives without positions, keeping the order of the rest.
+            size_t slotIdx = 0;
+            for (auto& mesh : model.meshes)
+            {
+                size_t kept = 0;
+                for (size_t primIdx = 0; primIdx < mesh.primitives.size(); ++primIdx, ++slotIdx)
+                {
+                    if (decoded[slotIdx] == 0) {
+                        continue;
                     }
-
-                    if (!gPrim.targets.empty())
-                    {
-                        for (const auto& gTarget : gPrim.targets)
-                        {
-                            ImportedPrimitive::MorphTarget impTarget;
-                            impTarget.positionDeltas.resize(vCount,
-                                glm::vec3(0.0F));
-                            impTarget.normalDeltas.resize(vCount,
-                                glm::vec3(0.0F));
-                            impTarget.tangentDeltas.resize(vCount,
-                                glm::vec3(0.0F));
-
-                            const auto* posIt = std::ranges::find_if(
-                                gTarget, [](const fastgltf::Attribute& a) {
-                                    return a.name == "POSITION";
-                                });
-                            if (posIt != gTarget.end())
-                            {
-                                fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                                    gltf, gltf.accessors[posIt->accessorIndex],
-                                    [&](glm::vec3 v, size_t idx) { impTarget.positionDeltas[idx] = v; });
-                            }
-
-                            const auto* normIt = std::ranges::find_if(
-                                gTarget, [](const fastgltf::Attribute& a) {
-                                    return a.name == "NORMAL";
-                                });
-                            if (normIt != gTarget.end())
-                            {
-                                fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                                    gltf, gltf.accessors[normIt->accessorIndex],
-                                    [&](glm::vec3 v, size_t idx) { impTarget.normalDeltas[idx] = v; });
-                            }
-
-                            const auto* tangIt = std::ranges::find_if(
-                                gTarget, [](const fastgltf::Attribute& a) {
-                                    return a.name == "TANGENT";
-                                });
-                            if (tangIt != gTarget.end())
-                            {
-                                fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                                    gltf, gltf.accessors[tangIt->accessorIndex],
-                                    [&](glm::vec3 v, size_t idx) { impTarget.tangentDeltas[idx] = v; });
-                            }
-                            impPrim.targets.push_back(std::move(impTarget));
-                        }
+                    if (kept != primIdx) {
+                        mesh.primitives[kept] = std::move(mesh.primitives[primIdx]);
                     }
-
-                    impMesh.primitives.push_back(std::move(impPrim));
+                    ++kept;
                 }
-                model.meshes.push_back(std::move(impMesh));
+                mesh.primitives.resize(kept);
             }
         }
 
@@ -1,7 +1,11 @@
 #include "pnkr/assets/GeometryProcessor.hpp"
 #include "pnkr/core/logger.hpp"
+#include <meshoptimizer.h>
 #include <mikktspace.h>
 #include <glm/vec4.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace pnkr::assets {
 
@@ -50,6 +54,39 @@ namespace pnkr::assets {
                 user->m_primitive->vertices[index].tangent = glm::vec4(fvTangent[0], fvTangent[1], fvTangent[2], fSign);
             }
         };
+
+        // FIFO size the ACMR figures are reported for.
+        constexpr unsigned int kStatsCacheSize = 16;
+        // Overdraw optimization may make ACMR this much worse.
+        constexpr float kOverdrawThreshold = 1.05F;
+
+        template <typename T>
+        void remapStream(std::vector<T>& data, const std::vector<unsigned int>& remap, size_t newCount) {
+            if (data.empty()) {
+                return;
+            }
+            std::vector<T> remapped(newCount);
+            meshopt_remapVertexBuffer(remapped.data(), data.data(), data.size(), sizeof(T), remap.data());
+            data = std::move(remapped);
+        }
+
+        template <typename Func>
+        void forEachDeltaStream(ImportedPrimitive& prim, Func&& func) {
+            for (auto& target : prim.targets) {
+                func(target.positionDeltas);
+                func(target.normalDeltas);
+                func(target.tangentDeltas);
+            }
+        }
+
+        void remapPrimitive(ImportedPrimitive& prim, const std::vector<unsigned int>& remap, size_t newCount) {
+            meshopt_remapIndexBuffer(prim.indices.data(), prim.indices.data(), prim.indices.size(), remap.data());
+            // LODs only use vertices the full-resolution indices use as well.
+            meshopt_remapIndexBuffer(prim.lodIndices.data(), prim.lodIndices.data(), prim.lodIndices.size(),
+                                     remap.data());
+            remapStream(prim.vertices, remap, newCount);
+            forEachDeltaStream(prim, [&](std::vector<glm::vec3>& deltas) { remapStream(deltas, remap, newCount); });
+        }
     }
 
     void GeometryProcessor::generateTangents(ImportedPrimitive& prim) {
@@ -72,4 +109,172 @@ namespace pnkr::assets {
         genTangSpaceDefault(&context);
     }
 
+    MeshOptimizationStats GeometryProcessor::optimize(ImportedPrimitive& prim) {
+        auto& vertices = prim.vertices;
+        auto& indices = prim.indices;
+
+        MeshOptimizationStats stats{};
+        stats.verticesBefore = static_cast<uint32_t>(vertices.size());
+        stats.verticesAfter = stats.verticesBefore;
+        stats.triangles = static_cast<uint32_t>(indices.size() / 3);
+
+        if (vertices.empty() || indices.empty() || indices.size() % 3 != 0) {
+            return stats;
+        }
+        if (std::ranges::any_of(indices, [&](uint32_t i) { return i >= vertices.size(); })) {
+            return stats;
+        }
+        bool deltasMatch = true;
+        forEachDeltaStream(prim, [&](const std::vector<glm::vec3>& deltas) {
+            deltasMatch &= deltas.empty() || deltas.size() == vertices.size();
+        });
+        if (!deltasMatch) {
+            return stats;
+        }
+
+        stats.acmrBefore = meshopt_analyzeVertexCache(indices.data(), indices.size(), vertices.size(),
+                                                      kStatsCacheSize, 0, 0).acmr;
+        stats.overfetchBefore = meshopt_analyzeVertexFetch(indices.data(), indices.size(), vertices.size(),
+                                                           sizeof(renderer::Vertex)).overfetch;
+
+        // localIndex differs for every vertex and would keep duplicates apart;
+        // it is rewritten once the final order is known.
+        for (auto& v : vertices) {
+            v.localIndex = 0;
+        }
+
+        // Vertices only merge when their morph deltas match as well.
+        std::vector<meshopt_Stream> streams;
+        streams.push_back({vertices.data(), sizeof(renderer::Vertex), sizeof(renderer::Vertex)});
+        forEachDeltaStream(prim, [&](const std::vector<glm::vec3>& deltas) {
+            if (!deltas.empty()) {
+                streams.push_back({deltas.data(), sizeof(glm::vec3), sizeof(glm::vec3)});
+            }
+        });
+
+        std::vector<unsigned int> remap(vertices.size());
+        const size_t uniqueVertices = meshopt_generateVertexRemapMulti(
+            remap.data(), indices.data(), indices.size(), vertices.size(), streams.data(), streams.size());
+        remapPrimitive(prim, remap, uniqueVertices);
+
+        meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+        meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), &vertices[0].position.x,
+                                 vertices.size(), sizeof(renderer::Vertex), kOverdrawThreshold);
+
+        remap.resize(vertices.size());
+        const size_t usedVertices =
+            meshopt_optimizeVertexFetchRemap(remap.data(), indices.data(), indices.size(), vertices.size());
+        remapPrimitive(prim, remap, usedVertices);
+
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            vertices[i].localIndex = static_cast<uint32_t>(i);
+        }
+
+        stats.verticesAfter = static_cast<uint32_t>(vertices.size());
+        stats.acmrAfter = meshopt_analyzeVertexCache(indices.data(), indices.size(), vertices.size(),
+                                                     kStatsCacheSize, 0, 0).acmr;
+        stats.overfetchAfter = meshopt_analyzeVertexFetch(indices.data(), indices.size(), vertices.size(),
+                                                          sizeof(renderer::Vertex)).overfetch;
+        stats.optimized = true;
+        return stats;
+    }
+
+    void GeometryProcessor::generateLods(ImportedPrimitive& prim, const LodSettings& settings) {
+        prim.lods.clear();
+        prim.lodIndices.clear();
+
+        const auto& vertices = prim.vertices;
+        const auto& indices = prim.indices;
+        if (vertices.empty() || indices.size() % 3 != 0 ||
+            indices.size() / 3 < static_cast<size_t>(settings.minTriangles) * 2) {
+            return;
+        }
+
+        const float* positions = &vertices[0].position.x;
+        // meshopt reports errors relative to the mesh extent.
+        const float scale = meshopt_simplifyScale(positions, vertices.size(), sizeof(renderer::Vertex));
+
+        std::vector<uint32_t> simplified(indices.size());
+        size_t previousCount = indices.size();
+        float previousError = 0.0F;
+        for (uint32_t level = 1; level < kMaxPrimitiveLods; ++level) {
+            const size_t target = static_cast<size_t>(static_cast<float>(previousCount) * settings.reduction) / 3 * 3;
+            if (target < static_cast<size_t>(settings.minTriangles) * 3) {
+                break;
+            }
+
+            // Every level simplifies the full-resolution mesh, so errors are
+            // measured against the original surface.
+            float error = 0.0F;
+            const size_t count = meshopt_simplify(simplified.data(), indices.data(), indices.size(), positions,
+                                                  vertices.size(), sizeof(renderer::Vertex), target,
+                                                  settings.maxError, meshopt_SimplifyLockBorder, &error);
+            // A level that barely shrinks costs memory without saving much.
+            const size_t worthwhile = (previousCount + target) / 2;
+            if (count == 0 || count > worthwhile) {
+                break;
+            }
+            meshopt_optimizeVertexCache(simplified.data(), simplified.data(), count, vertices.size());
+
+            previousError = std::max(previousError, error * scale);
+            prim.lods.push_back({.firstIndex = static_cast<uint32_t>(prim.lodIndices.size()),
+                                 .indexCount = static_cast<uint32_t>(count),
+                                 .error = previousError});
+            prim.lodIndices.insert(prim.lodIndices.end(), simplified.begin(),
+                                   simplified.begin() + static_cast<std::ptrdiff_t>(count));
+            previousCount = count;
+        }
+    }
+
+    void GeometryProcessor::buildMeshlets(ImportedPrimitive& prim) {
+        prim.meshlets.clear();
+
+        const auto& vertices = prim.vertices;
+        auto& indices = prim.indices;
+        if (vertices.empty() || indices.size() % 3 != 0 || indices.size() / 3 <= kMeshletMaxTriangles ||
+            !prim.targets.empty()) {
+            return;
+        }
+        if (std::ranges::any_of(indices, [&](uint32_t i) { return i >= vertices.size(); })) {
+            return;
+        }
+
+        const float* positions = &vertices[0].position.x;
+        const size_t maxMeshlets = meshopt_buildMeshletsBound(indices.size(), kMeshletMaxVertices, kMeshletMaxTriangles);
+        std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+        std::vector<unsigned int> meshletVertices(maxMeshlets * kMeshletMaxVertices);
+        std::vector<unsigned char> meshletTriangles(maxMeshlets * kMeshletMaxTriangles * 3);
+        // Some weight on normal cones keeps clusters flat enough to backface cull.
+        constexpr float kConeWeight = 0.25F;
+        const size_t meshletCount = meshopt_buildMeshlets(
+            meshlets.data(), meshletVertices.data(), meshletTriangles.data(), indices.data(), indices.size(),
+            positions, vertices.size(), sizeof(renderer::Vertex), kMeshletMaxVertices, kMeshletMaxTriangles,
+            kConeWeight);
+
+        // Back to primitive-local indices, one range per meshlet.
+        std::vector<uint32_t> ordered;
+        ordered.reserve(indices.size());
+        prim.meshlets.reserve(meshletCount);
+        for (size_t m = 0; m < meshletCount; ++m) {
+            const auto& meshlet = meshlets[m];
+            const auto first = static_cast<uint32_t>(ordered.size());
+            for (uint32_t i = 0; i < meshlet.triangle_count * 3; ++i) {
+                ordered.push_back(meshletVertices[meshlet.vertex_offset + meshletTriangles[meshlet.triangle_offset + i]]);
+            }
+            uint32_t* range = ordered.data() + first;
+            const uint32_t count = meshlet.triangle_count * 3;
+            meshopt_optimizeVertexCache(range, range, count, vertices.size());
+
+            const meshopt_Bounds bounds = meshopt_computeClusterBounds(range, count, positions, vertices.size(),
+                                                                       sizeof(renderer::Vertex));
+            prim.meshlets.push_back({.firstIndex = first,
+                                     .indexCount = count,
+                                     .center = glm::make_vec3(bounds.center),
+                                     .radius = bounds.radius,
+                                     .coneApex = glm::make_vec3(bounds.cone_apex),
+                                     .coneAxis = glm::make_vec3(bounds.cone_axis),
+                                     .coneCutoff = bounds.cone_cutoff});
+        }
+        indices = std::move(ordered);
+    }
 }
@@ -9,7 +9,6 @@
 #include <fstream>
 #include <ktx.h>
 #include <stb_image_resize2.h>
-#include <xxhash.h>
 
 #include "pnkr/assets/BC7Encoder.hpp"
 
@@ -26,8 +25,6 @@ namespace pnkr::assets {
 #endif
 
 namespace {
-uint64_t hash64(std::string_view s) { return XXH3_64bits(s.data(), s.size()); }
-
 bool pathExistsNoThrow(const std::filesystem::path &p) noexcept {
   std::error_code ec;
   return std::filesystem::exists(p, ec);
@@ -105,25 +102,6 @@ void resizeRGBA(const uint8_t *src, int sw, int sh, uint8_t *dst, int dw,
 }
 } // namespace
 
-std::filesystem::path TextureCacheSystem::makeTextureCacheDir(
-    const std::filesystem::path &assetPath) {
-  return assetPath.parent_path() / ".cache" / "textures";
-}
-
-std::filesystem::path
-TextureCacheSystem::getCachedPath(const std::filesystem::path &cacheDir,
-                                  std::string_view sourceKey, uint32_t maxSize,
-                                  bool srgb) {
-  const std::string key = std::string(sourceKey) + "|" +
-                          std::to_string(maxSize) + "|" +
-                          (srgb ? "srgb" : "lin") + "|v2";
-  const uint64_t h = hash64(key);
-
-  char buf[64];
-  std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)h);
-  return cacheDir / (std::string(buf) + ".ktx2");
-}
-
 bool TextureCacheSystem::writeBytesFileAtomic(
     const std::filesystem::path &outFile,
     const std::vector<std::uint8_t> &bytes, uint32_t threadnum) {
@@ -144,93 +122,71 @@ bool TextureCacheSystem::writeBytesFileAtomic(
   return atomicRenameOrDiscard(tmp, outFile);
 }
 
-bool TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(
-    const std::filesystem::path &outFile, const uint8_t *rgba, int origW,
-    int origH, uint32_t maxSize, bool srgb, uint32_t threadnum) {
-  const auto funcStart = std::chrono::high_resolution_clock::now();
-  if ((rgba == nullptr) || origW <= 0 || origH <= 0) {
-    core::Logger::Asset.error("[Thread {}] Invalid input to writeKtx2",
-                              threadnum);
-    return false;
-  }
-
+TextureMipChain TextureCacheSystem::planMipChain(int origW, int origH,
+                                                 uint32_t maxSize) {
   int newW = origW;
   int newH = origH;
   computeMaxDimScaledSize(origW, origH, maxSize, newW, newH);
-  const uint32_t mips = calcMipLevels(newW, newH);
+  return {.width = (uint32_t)newW,
+          .height = (uint32_t)newH,
+          .levels = calcMipLevels(newW, newH)};
+}
 
-  LOG_CACHE_DEBUG("[Thread {}] Resize: {}x{} -> {}x{}, {} mips", threadnum,
-                  origW, origH, newW, newH, mips);
+void TextureCacheSystem::resizeLevel(const uint8_t *src, uint32_t srcW,
+                                     uint32_t srcH, uint8_t *dst,
+                                     uint32_t dstW, uint32_t dstH, bool srgb) {
+  PNKR_PROFILE_FUNCTION();
+  resizeRGBA(src, (int)srcW, (int)srcH, dst, (int)dstW, (int)dstH, srgb);
+}
 
-  const auto t1 = std::chrono::high_resolution_clock::now();
+bool TextureCacheSystem::encodeLevelBC7(const uint8_t *rgba, uint32_t width,
+                                        uint32_t height, bool srgb,
+                                        std::vector<uint8_t> &out) {
+  PNKR_PROFILE_FUNCTION();
+  BC7EncoderConfig encoderConfig;
+  encoderConfig.perceptual = srgb;
+  encoderConfig.useSRGB = srgb;
+  encoderConfig.quality = BC7Quality::Fast;
+  return BC7Encoder::compress(rgba, width, height, encoderConfig, out);
+}
+
+bool TextureCacheSystem::writeKtx2BC7LevelsAtomic(
+    const std::filesystem::path &outFile, const TextureMipChain &chain,
+    std::span<const std::vector<uint8_t>> levels, bool srgb,
+    uint32_t threadnum) {
+  PNKR_PROFILE_FUNCTION();
+  if (levels.size() != chain.levels) {
+    return false;
+  }
 
   // VK_FORMAT_BC7_UNORM_BLOCK = 145, VK_FORMAT_BC7_SRGB_BLOCK = 146
   const uint32_t vkFormatBC7 = srgb ? 146 : 145;
 
   ktxTextureCreateInfo ci{};
   ci.vkFormat = vkFormatBC7;
-  ci.baseWidth = (uint32_t)newW;
-  ci.baseHeight = (uint32_t)newH;
+  ci.baseWidth = chain.width;
+  ci.baseHeight = chain.height;
   ci.baseDepth = 1;
   ci.numDimensions = 2;
-  ci.numLevels = mips;
+  ci.numLevels = chain.levels;
   ci.numLayers = 1;
   ci.numFaces = 1;
   ci.generateMipmaps = KTX_FALSE;
 
   ktxTexture2 *tex = nullptr;
-  const auto createResult =
-      ktxTexture2_Create(&ci, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &tex);
-  const auto t2 = std::chrono::high_resolution_clock::now();
-  if (createResult != KTX_SUCCESS) {
+  if (ktxTexture2_Create(&ci, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &tex) !=
+      KTX_SUCCESS) {
     return false;
   }
 
-  int w = newW;
-  int h = newH;
-
-  const auto t3 = std::chrono::high_resolution_clock::now();
-  std::vector<uint8_t> tempLevelRGBA;
-  std::vector<uint8_t> bc7Blocks;
-
-  BC7EncoderConfig encoderConfig;
-  encoderConfig.perceptual = srgb;
-  encoderConfig.useSRGB = srgb;
-  encoderConfig.qualityLevel = 1;
-
-  for (uint32_t level = 0; level < mips; ++level) {
-    if (level == 0) {
-      tempLevelRGBA.resize(w * h * 4);
-      resizeRGBA(rgba, origW, origH, tempLevelRGBA.data(), w, h, srgb);
-    } else {
-      // For higher mips, we resize from the previous level's RGBA data for
-      // better performance and quality
-      std::vector<uint8_t> prevRGBA = std::move(tempLevelRGBA);
-      const int pw = std::max(1, w * 2);
-      const int ph = std::max(1, h * 2);
-      tempLevelRGBA.resize(w * h * 4);
-      resizeRGBA(prevRGBA.data(), pw, ph, tempLevelRGBA.data(), w, h, srgb);
-    }
-
-    if (BC7Encoder::compress(tempLevelRGBA.data(), w, h, encoderConfig,
-                             bc7Blocks)) {
-      ktxTexture_SetImageFromMemory(ktxTexture(tex), level, 0, 0,
-                                    bc7Blocks.data(), bc7Blocks.size());
-    } else {
-      // Fallback or error
-      core::Logger::Asset.error("BC7 compression failed for level {}", level);
-    }
-
-    w = std::max(1, w / 2);
-    h = std::max(1, h / 2);
+  for (uint32_t level = 0; level < chain.levels; ++level) {
+    ktxTexture_SetImageFromMemory(ktxTexture(tex), level, 0, 0,
+                                  levels[level].data(), levels[level].size());
   }
 
-  const auto t4 = std::chrono::high_resolution_clock::now();
-
   // Supercompression
   ktxTexture2_DeflateZstd(tex, 5);
 
-  const auto t7 = std::chrono::high_resolution_clock::now();
   const auto tmp = makeUniqueTempPath(outFile, threadnum);
   const auto tmpStr = tmp.string();
   const auto wr = ktxTexture_WriteToNamedFile(ktxTexture(tex), tmpStr.c_str());
@@ -244,13 +200,63 @@ bool TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(
     return false;
   }
 
-  const bool renamed = atomicRenameOrDiscard(tmp, outFile);
+  return atomicRenameOrDiscard(tmp, outFile);
+}
+
+bool TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(
+    const std::filesystem::path &outFile, const uint8_t *rgba, int origW,
+    int origH, uint32_t maxSize, bool srgb, uint32_t threadnum) {
+  const auto funcStart = std::chrono::high_resolution_clock::now();
+  if ((rgba == nullptr) || origW <= 0 || origH <= 0) {
+    core::Logger::Asset.error("[Thread {}] Invalid input to writeKtx2",
+                              threadnum);
+    return false;
+  }
+
+  const TextureMipChain chain = planMipChain(origW, origH, maxSize);
+
+  LOG_CACHE_DEBUG("[Thread {}] Resize: {}x{} -> {}x{}, {} mips", threadnum,
+                  origW, origH, chain.width, chain.height, chain.levels);
+
+  // The resize chain is sequential (each mip is filtered from the previous
+  // one), but encoding is not: all levels go to the BC7 encoder together.
+  std::vector<std::vector<uint8_t>> levelRGBA(chain.levels);
+  std::vector<BC7SourceImage> levelImages(chain.levels);
+  for (uint32_t level = 0; level < chain.levels; ++level) {
+    const uint32_t w = chain.levelWidth(level);
+    const uint32_t h = chain.levelHeight(level);
+    levelRGBA[level].resize(static_cast<size_t>(w) * h * 4);
+    if (level == 0) {
+      resizeRGBA(rgba, origW, origH, levelRGBA[level].data(), (int)w, (int)h,
+                 srgb);
+    } else {
+      const auto &prev = levelImages[level - 1];
+      resizeRGBA(prev.rgba, (int)prev.width, (int)prev.height,
+                 levelRGBA[level].data(), (int)w, (int)h, srgb);
+    }
+    levelImages[level] = {levelRGBA[level].data(), w, h};
+  }
+
+  BC7EncoderConfig encoderConfig;
+  encoderConfig.perceptual = srgb;
+  encoderConfig.useSRGB = srgb;
+  encoderConfig.quality = BC7Quality::Fast;
+
+  std::vector<std::vector<uint8_t>> bc7Levels;
+  if (!BC7Encoder::compressLevels(levelImages, encoderConfig, bc7Levels)) {
+    core::Logger::Asset.error("[Thread {}] BC7 compression failed",
+                              threadnum);
+    return false;
+  }
+
+  const bool written =
+      writeKtx2BC7LevelsAtomic(outFile, chain, bc7Levels, srgb, threadnum);
 
   const auto funcEnd = std::chrono::high_resolution_clock::now();
   core::Logger::Asset.info(
       "[Thread {}] writeKtx2 (BC7+Zstd) TOTAL: {:.2f}s", threadnum,
       std::chrono::duration<double>(funcEnd - funcStart).count());
-  return renamed;
+  return written;
 }
 
 } // namespace pnkr::assets
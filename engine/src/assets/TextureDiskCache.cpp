@@ -0,0 +1,439 @@
+#include "pnkr/assets/TextureDiskCache.hpp"
+#include "pnkr/core/logger.hpp"
+#include "pnkr/core/profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include <xxhash.h>
+
+namespace pnkr::assets {
+
+namespace {
+
+// Bump when an encoder change makes existing cache files stale.
+constexpr uint32_t kEncoderVersion = 3;
+
+constexpr uint32_t kIndexMagic = 0x49585450; // "PTXI"
+constexpr uint32_t kIndexVersion = 1;
+constexpr const char *kIndexName = "index.bin";
+
+// Eviction frees down to this fraction of maxBytes so it does not re-run on
+// every following insert.
+constexpr double kEvictLowWater = 0.9;
+
+struct IndexHeader {
+  uint32_t magic = kIndexMagic;
+  uint32_t version = kIndexVersion;
+  uint64_t count = 0;
+};
+
+struct IndexEntry {
+  uint64_t key = 0;
+  uint64_t sizeBytes = 0;
+  int64_t lastUse = 0;
+};
+
+static_assert(sizeof(IndexHeader) == 16);
+static_assert(sizeof(IndexEntry) == 24);
+
+int64_t nowSeconds() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+std::optional<uint64_t> parseKey(const std::filesystem::path &file) {
+  const auto stem = file.stem().string();
+  if (stem.size() != 16 || file.extension() != ".ktx2") {
+    return std::nullopt;
+  }
+  char *end = nullptr;
+  const auto key = std::strtoull(stem.c_str(), &end, 16);
+  if (end != stem.c_str() + stem.size() || key == 0) {
+    return std::nullopt;
+  }
+  return key;
+}
+} // namespace
+
+TextureDiskCache::TextureDiskCache(Config config) : m_config(std::move(config)) {
+  const uint32_t capacity = std::bit_ceil(std::max(m_config.capacity, 64U));
+  m_slots = std::make_unique<Slot[]>(capacity);
+  m_mask = capacity - 1;
+  m_sessionStart = nowSeconds();
+
+  std::error_code ec;
+  std::filesystem::create_directories(m_config.directory, ec);
+  if (ec) {
+    core::Logger::Asset.error("TextureDiskCache: cannot create '{}': {}",
+                              m_config.directory.string(), ec.message());
+    return;
+  }
+
+  loadIndex();
+  evict();
+}
+
+TextureDiskCache::~TextureDiskCache() { flush(); }
+
+TextureDiskCache &TextureDiskCache::global() {
+  static TextureDiskCache cache(Config{.directory = defaultDirectory()});
+  return cache;
+}
+
+std::filesystem::path TextureDiskCache::defaultDirectory() {
+#ifdef _WIN32
+  if (const char *localAppData = std::getenv("LOCALAPPDATA")) {
+    return std::filesystem::path(localAppData) / "pnkr" / "cache" / "ktx2";
+  }
+#else
+  if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+    return std::filesystem::path(xdg) / "pnkr" / "ktx2";
+  }
+  if (const char *home = std::getenv("HOME")) {
+    return std::filesystem::path(home) / ".cache" / "pnkr" / "ktx2";
+  }
+#endif
+  return std::filesystem::current_path() / ".pnkr_cache" / "ktx2";
+}
+
+uint64_t TextureDiskCache::hashContent(std::span<const uint8_t> bytes) {
+  return XXH3_64bits(bytes.data(), bytes.size());
+}
+
+uint64_t TextureDiskCache::makeKey(uint64_t contentHash,
+                               const TextureCacheSettings &settings) {
+  const uint32_t packed[4] = {
+      kEncoderVersion, static_cast<uint32_t>(settings.encoding),
+      (settings.srgb ? 1U : 0U) |
+          (static_cast<uint32_t>(settings.quality) << 8),
+      settings.maxSize};
+  const uint64_t key = XXH3_64bits_withSeed(packed, sizeof(packed), contentHash);
+  // 0 marks an empty slot.
+  return key != 0 ? key : 1;
+}
+
+TextureDiskCache::Slot *TextureDiskCache::find(uint64_t key) const {
+  for (uint32_t i = key & m_mask, n = 0; n <= m_mask; i = (i + 1) & m_mask, ++n) {
+    const uint64_t k = m_slots[i].key.load(std::memory_order_acquire);
+    if (k == key) {
+      return &m_slots[i];
+    }
+    if (k == 0) {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+TextureDiskCache::Slot *TextureDiskCache::findOrInsert(uint64_t key) {
+  for (uint32_t i = key & m_mask, n = 0; n <= m_mask; i = (i + 1) & m_mask, ++n) {
+    uint64_t k = m_slots[i].key.load(std::memory_order_acquire);
+    if (k == 0 && m_slots[i].key.compare_exchange_strong(
+                      k, key, std::memory_order_acq_rel)) {
+      return &m_slots[i];
+    }
+    if (k == key) {
+      return &m_slots[i];
+    }
+  }
+  return nullptr;
+}
+
+void TextureDiskCache::admit(Slot &slot, uint64_t sizeBytes, int64_t lastUse) {
+  slot.lastUse.store(lastUse, std::memory_order_relaxed);
+  const uint64_t prev = slot.sizeBytes.exchange(sizeBytes, std::memory_order_acq_rel);
+  m_residentBytes.fetch_add(sizeBytes - prev, std::memory_order_relaxed);
+  if (prev == 0) {
+    m_entries.fetch_add(1, std::memory_order_relaxed);
+  }
+  m_dirty.store(true, std::memory_order_relaxed);
+}
+
+std::optional<std::filesystem::path> TextureDiskCache::lookup(uint64_t key) {
+  Slot *slot = find(key);
+  if (slot != nullptr) {
+    // Stamp before checking residency; evict() checks in the opposite order,
+    // so one of the two always sees the other (both are seq_cst).
+    slot->lastUse.store(nowSeconds());
+  }
+  if (slot == nullptr || slot->sizeBytes.load() == 0) {
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  // The file may have been deleted behind the index's back; forget it so
+  // the caller re-encodes and inserts it again.
+  auto path = pathFor(key);
+  std::error_code ec;
+  if (!std::filesystem::exists(path, ec)) {
+    if (const uint64_t size = slot->sizeBytes.exchange(0); size != 0) {
+      m_residentBytes.fetch_sub(size, std::memory_order_relaxed);
+      m_entries.fetch_sub(1, std::memory_order_relaxed);
+    }
+    m_dirty.store(true, std::memory_order_relaxed);
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  m_dirty.store(true, std::memory_order_relaxed);
+  m_hits.fetch_add(1, std::memory_order_relaxed);
+  return path;
+}
+
+bool TextureDiskCache::touch(const std::filesystem::path &cachedFile) {
+  const auto key = parseKey(cachedFile);
+  return key && lookup(*key).has_value();
+}
+
+std::filesystem::path TextureDiskCache::pathFor(uint64_t key) const {
+  char name[24];
+  std::snprintf(name, sizeof(name), "%016llx.ktx2",
+                static_cast<unsigned long long>(key));
+  return m_config.directory / name;
+}
+
+bool TextureDiskCache::insert(uint64_t key) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(pathFor(key), ec);
+  if (ec || size == 0) {
+    return false;
+  }
+
+  Slot *slot = findOrInsert(key);
+  if (slot == nullptr) {
+    if (!m_warnedFull.exchange(true, std::memory_order_relaxed)) {
+      core::Logger::Asset.warn(
+          "TextureDiskCache: slot table full ({} entries), new files are not "
+          "tracked until the next session",
+          m_mask + 1);
+    }
+    return false;
+  }
+
+  admit(*slot, size, nowSeconds());
+  m_inserts.fetch_add(1, std::memory_order_relaxed);
+
+  if (m_residentBytes.load(std::memory_order_relaxed) > m_config.maxBytes) {
+    evict();
+  }
+  return true;
+}
+
+void TextureDiskCache::evict() {
+  // Only one evictor at a time; anyone else finds the cache shrinking already.
+  std::unique_lock lock(m_evictMutex, std::try_to_lock);
+  if (!lock.owns_lock() || m_evictExhausted ||
+      m_residentBytes.load(std::memory_order_relaxed) <= m_config.maxBytes) {
+    return;
+  }
+  PNKR_PROFILE_FUNCTION();
+
+  struct Candidate {
+    int64_t lastUse;
+    uint32_t slot;
+  };
+  std::vector<Candidate> candidates;
+  for (uint32_t i = 0; i <= m_mask; ++i) {
+    const Slot &slot = m_slots[i];
+    const int64_t lastUse = slot.lastUse.load(std::memory_order_relaxed);
+    if (slot.sizeBytes.load(std::memory_order_relaxed) != 0 &&
+        lastUse < m_sessionStart) {
+      candidates.push_back({lastUse, i});
+    }
+  }
+  std::ranges::sort(candidates, {}, &Candidate::lastUse);
+
+  const auto target =
+      static_cast<uint64_t>(static_cast<double>(m_config.maxBytes) * kEvictLowWater);
+  uint64_t freed = 0;
+  uint32_t evicted = 0;
+  for (const auto &c : candidates) {
+    if (m_residentBytes.load(std::memory_order_relaxed) <= target) {
+      break;
+    }
+    Slot &slot = m_slots[c.slot];
+    const uint64_t size = slot.sizeBytes.exchange(0);
+    if (size == 0) {
+      continue;
+    }
+    // A lookup may have handed out the path since the scan.
+    if (slot.lastUse.load() >= m_sessionStart) {
+      slot.sizeBytes.store(size);
+      continue;
+    }
+    std::error_code ec;
+    std::filesystem::remove(pathFor(slot.key.load(std::memory_order_relaxed)), ec);
+    m_residentBytes.fetch_sub(size, std::memory_order_relaxed);
+    m_entries.fetch_sub(1, std::memory_order_relaxed);
+    freed += size;
+    ++evicted;
+  }
+
+  // Everything left was used this session, and entries only ever get newer,
+  // so further passes this session cannot free anything.
+  if (m_residentBytes.load(std::memory_order_relaxed) > target) {
+    m_evictExhausted = true;
+    core::Logger::Asset.warn(
+        "TextureDiskCache: {:.1f} MiB in use this session exceeds the {:.1f} MiB "
+        "cap; eviction resumes next session",
+        m_residentBytes.load(std::memory_order_relaxed) / (1024.0 * 1024.0),
+        m_config.maxBytes / (1024.0 * 1024.0));
+  }
+  if (evicted == 0) {
+    return;
+  }
+
+  m_evictions.fetch_add(evicted, std::memory_order_relaxed);
+  m_dirty.store(true, std::memory_order_relaxed);
+  core::Logger::Asset.info(
+      "TextureDiskCache: evicted {} files ({:.1f} MiB), {:.1f} / {:.1f} MiB resident",
+      evicted, freed / (1024.0 * 1024.0),
+      m_residentBytes.load(std::memory_order_relaxed) / (1024.0 * 1024.0),
+      m_config.maxBytes / (1024.0 * 1024.0));
+}
+
+void TextureDiskCache::loadIndex() {
+  PNKR_PROFILE_FUNCTION();
+  const auto indexPath = m_config.directory / kIndexName;
+  std::ifstream is(indexPath, std::ios::binary);
+  IndexHeader header{};
+  if (!is || !is.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      header.magic != kIndexMagic || header.version != kIndexVersion) {
+    rebuildIndex();
+    return;
+  }
+
+  // Size the entry array from the file, not the header, so a corrupt count
+  // can't drive the allocation.
+  std::error_code ec;
+  const auto fileSize = std::filesystem::file_size(indexPath, ec);
+  if (ec || fileSize < sizeof(IndexHeader) ||
+      header.count > (fileSize - sizeof(IndexHeader)) / sizeof(IndexEntry)) {
+    core::Logger::Asset.warn("TextureDiskCache: corrupt index, rescanning '{}'",
+                             m_config.directory.string());
+    rebuildIndex();
+    return;
+  }
+
+  std::vector<IndexEntry> entries(header.count);
+  if (!is.read(reinterpret_cast<char *>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(IndexEntry)))) {
+    core::Logger::Asset.warn("TextureDiskCache: truncated index, rescanning '{}'",
+                             m_config.directory.string());
+    rebuildIndex();
+    return;
+  }
+
+  for (const auto &e : entries) {
+    if (e.key == 0 || e.sizeBytes == 0) {
+      continue;
+    }
+    if (Slot *slot = findOrInsert(e.key)) {
+      admit(*slot, e.sizeBytes, e.lastUse);
+    }
+  }
+  m_dirty.store(false, std::memory_order_relaxed);
+  core::Logger::Asset.info("TextureDiskCache: {} entries, {:.1f} MiB in '{}'",
+                           m_entries.load(std::memory_order_relaxed),
+                           m_residentBytes.load(std::memory_order_relaxed) /
+                               (1024.0 * 1024.0),
+                           m_config.directory.string());
+}
+
+void TextureDiskCache::rebuildIndex() {
+  std::error_code ec;
+  for (const auto &file :
+       std::filesystem::directory_iterator(m_config.directory, ec)) {
+    const auto key = parseKey(file.path());
+    if (!key) {
+      continue;
+    }
+    std::error_code fileEc;
+    const auto size = file.file_size(fileEc);
+    const auto mtime = file.last_write_time(fileEc);
+    if (fileEc || size == 0) {
+      continue;
+    }
+    const auto sysTime = std::chrono::file_clock::to_sys(mtime);
+    if (Slot *slot = findOrInsert(*key)) {
+      admit(*slot, size,
+            std::chrono::duration_cast<std::chrono::seconds>(
+                sysTime.time_since_epoch())
+                .count());
+    }
+  }
+  m_dirty.store(true, std::memory_order_relaxed);
+}
+
+void TextureDiskCache::flush() {
+  if (!m_dirty.exchange(false, std::memory_order_relaxed)) {
+    return;
+  }
+  PNKR_PROFILE_FUNCTION();
+  std::scoped_lock lock(m_flushMutex);
+
+  std::vector<IndexEntry> entries;
+  entries.reserve(m_entries.load(std::memory_order_relaxed));
+  for (uint32_t i = 0; i <= m_mask; ++i) {
+    const Slot &slot = m_slots[i];
+    const uint64_t size = slot.sizeBytes.load(std::memory_order_acquire);
+    if (size != 0) {
+      entries.push_back({slot.key.load(std::memory_order_relaxed), size,
+                         slot.lastUse.load(std::memory_order_relaxed)});
+    }
+  }
+
+  const auto indexPath = m_config.directory / kIndexName;
+  auto tmp = indexPath;
+  tmp += ".tmp";
+  {
+    std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+    const IndexHeader header{.count = entries.size()};
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char *>(entries.data()),
+             static_cast<std::streamsize>(entries.size() * sizeof(IndexEntry)));
+    if (!os.good()) {
+      core::Logger::Asset.error("TextureDiskCache: failed to write '{}'",
+                                tmp.string());
+      m_dirty.store(true, std::memory_order_relaxed);
+      return;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp, indexPath, ec);
+  if (ec) {
+    std::filesystem::remove(tmp, ec);
+    m_dirty.store(true, std::memory_order_relaxed);
+  }
+}
+
+void TextureDiskCache::clear() {
+  std::scoped_lock lock(m_evictMutex, m_flushMutex);
+  for (uint32_t i = 0; i <= m_mask; ++i) {
+    m_slots[i].sizeBytes.store(0, std::memory_order_release);
+  }
+  m_residentBytes.store(0, std::memory_order_relaxed);
+  m_entries.store(0, std::memory_order_relaxed);
+  m_evictExhausted = false;
+
+  std::error_code ec;
+  std::filesystem::remove_all(m_config.directory, ec);
+  std::filesystem::create_directories(m_config.directory, ec);
+  m_dirty.store(false, std::memory_order_relaxed);
+}
+
+TextureCacheStats TextureDiskCache::stats() const {
+  return {.hits = m_hits.load(std::memory_order_relaxed),
+          .misses = m_misses.load(std::memory_order_relaxed),
+          .inserts = m_inserts.load(std::memory_order_relaxed),
+          .evictions = m_evictions.load(std::memory_order_relaxed),
+          .entries = m_entries.load(std::memory_order_relaxed),
+          .residentBytes = m_residentBytes.load(std::memory_order_relaxed)};
+}
+
+} // namespace pnkr::assets
@@ -7,7 +7,257 @@ namespace pnkr::ecs {
         return lastID.fetch_add(1, std::memory_order_relaxed);
     }
 
+    Archetype::Archetype(const ComponentMask& mask, std::vector<const ComponentTypeInfo*> types)
+        : m_mask(mask), m_types(std::move(types)) {
+        std::ranges::sort(m_types, {}, &ComponentTypeInfo::id);
+        m_columnOffsets.fill(kNoColumn);
+
+        size_t rowStride = sizeof(Entity);
+        size_t alignmentSlack = 0;
+        for (const ComponentTypeInfo* type : m_types) {
+            rowStride += type->size;
+            alignmentSlack += type->size > 0 ? type->alignment : 0;
+        }
+        m_rowsPerChunk = static_cast<uint32_t>((ArchetypeChunk::kSize - alignmentSlack) / rowStride);
+        PNKR_ASSERT(m_rowsPerChunk > 0, "Component signature does not fit in an archetype chunk");
+
+        size_t offset = sizeof(Entity) * m_rowsPerChunk;
+        for (const ComponentTypeInfo* type : m_types) {
+            m_typeSizes[type->id] = type->size;
+            if (type->size == 0) {
+                continue;
+            }
+            offset = (offset + type->alignment - 1) & ~(size_t(type->alignment) - 1);
+            m_columnOffsets[type->id] = static_cast<uint32_t>(offset);
+            offset += static_cast<size_t>(type->size) * m_rowsPerChunk;
+        }
+        PNKR_ASSERT(offset <= ArchetypeChunk::kSize, "Archetype chunk layout overflow");
+    }
+
+    Archetype::~Archetype() {
+        clear();
+    }
+
+    uint32_t Archetype::allocateRow(Entity e) {
+        const auto row = static_cast<uint32_t>(m_size);
+        if (row / m_rowsPerChunk >= m_chunks.size()) {
+            m_chunks.emplace_back(new ArchetypeChunk);
+        }
+        chunkEntities(row / m_rowsPerChunk)[row % m_rowsPerChunk] = e;
+        ++m_size;
+        return row;
+    }
+
+    Entity Archetype::removeRow(uint32_t row, bool destroyComponents) {
+        PNKR_ASSERT(row < m_size, "Archetype row out of range");
+        const auto last = static_cast<uint32_t>(m_size - 1);
+
+        for (const ComponentTypeInfo* type : m_types) {
+            if (type->size == 0) {
+                continue;
+            }
+            if (destroyComponents) {
+                type->destroy(component(row, type->id));
+            }
+            if (row != last) {
+                void* src = component(last, type->id);
+                type->moveConstruct(component(row, type->id), src);
+                type->destroy(src);
+            }
+        }
+
+        Entity moved = kNullEntity;
+        if (row != last) {
+            moved = entity(last);
+            chunkEntities(row / m_rowsPerChunk)[row % m_rowsPerChunk] = moved;
+        }
+
+        --m_size;
+        if (m_size % m_rowsPerChunk == 0 && m_chunks.size() > m_size / m_rowsPerChunk + 1) {
+            m_chunks.pop_back();
+        }
+        return moved;
+    }
+
+    void Archetype::clear() {
+        for (const ComponentTypeInfo* type : m_types) {
+            if (type->size == 0) {
+                continue;
+            }
+            for (uint32_t row = 0; row < m_size; ++row) {
+                type->destroy(component(row, type->id));
+            }
+        }
+        m_size = 0;
+        m_chunks.clear();
+    }
+
+    Archetype* Archetype::addEdge(uint32_t typeID) const {
+        auto it = m_addEdges.find(typeID);
+        return it != m_addEdges.end() ? it->second : nullptr;
+    }
+
+    Archetype* Archetype::removeEdge(uint32_t typeID) const {
+        auto it = m_removeEdges.find(typeID);
+        return it != m_removeEdges.end() ? it->second : nullptr;
+    }
+
+    void ArchetypeStorage::registerType(const ComponentTypeInfo& info) {
+        PNKR_ASSERT(info.id < kMaxComponentTypes, "Too many component types for archetype storage");
+        m_typeInfos[info.id] = &info;
+    }
+
+    Archetype* ArchetypeStorage::findOrCreate(const ComponentMask& mask) {
+        if (auto it = m_byMask.find(mask); it != m_byMask.end()) {
+            return it->second;
+        }
+
+        std::vector<const ComponentTypeInfo*> types;
+        for (uint32_t id = 0; id < kMaxComponentTypes; ++id) {
+            if (mask.test(id)) {
+                PNKR_ASSERT(m_typeInfos[id], "Component type was never registered");
+                types.push_back(m_typeInfos[id]);
+            }
+        }
+
+        auto& archetype = m_archetypes.emplace_back(std::make_unique<Archetype>(mask, std::move(types)));
+        m_byMask.emplace(mask, archetype.get());
+        return archetype.get();
+    }
+
+    void ArchetypeStorage::moveEntity(Entity e, Archetype& target) {
+        EntityLocation& loc = m_locations[e];
+        Archetype* source = loc.archetype;
+        const uint32_t newRow = target.allocateRow(e);
+
+        if (source) {
+            for (const ComponentTypeInfo* type : source->types()) {
+                if (type->size == 0) {
+                    continue;
+                }
+                void* src = source->component(loc.row, type->id);
+                if (target.contains(type->id)) {
+                    type->moveConstruct(target.component(newRow, type->id), src);
+                }
+                type->destroy(src);
+            }
+
+            const Entity moved = source->removeRow(loc.row, false);
+            if (moved != kNullEntity) {
+                m_locations[moved].row = loc.row;
+            }
+        }
+
+        loc.archetype = &target;
+        loc.row = newRow;
+    }
+
+    void* ArchetypeStorage::add(Entity e, uint32_t typeID, bool& existed) {
+        if (e >= m_locations.size()) {
+            m_locations.resize(static_cast<size_t>(e) + 1);
+        }
+
+        Archetype* source = m_locations[e].archetype;
+        existed = source && source->contains(typeID);
+        if (!existed) {
+            Archetype* target = source ? source->addEdge(typeID) : nullptr;
+            if (!target) {
+                ComponentMask mask = source ? source->mask() : ComponentMask{};
+                mask.set(typeID);
+                target = findOrCreate(mask);
+                if (source) {
+                    source->setAddEdge(typeID, target);
+                    target->setRemoveEdge(typeID, source);
+                }
+            }
+            moveEntity(e, *target);
+        }
+
+        if (m_typeInfos[typeID]->size == 0) {
+            return nullptr;
+        }
+        const EntityLocation& loc = m_locations[e];
+        return loc.archetype->component(loc.row, typeID);
+    }
+
+    void ArchetypeStorage::remove(Entity e, uint32_t typeID) {
+        if (!has(e, typeID)) {
+            return;
+        }
+
+        Archetype* source = m_locations[e].archetype;
+        Archetype* target = source->removeEdge(typeID);
+        if (!target) {
+            ComponentMask mask = source->mask();
+            mask.reset(typeID);
+            target = findOrCreate(mask);
+            source->setRemoveEdge(typeID, target);
+            target->setAddEdge(typeID, source);
+        }
+        moveEntity(e, *target);
+    }
+
+    void ArchetypeStorage::destroy(Entity e) {
+        if (e >= m_locations.size() || !m_locations[e].archetype) {
+            return;
+        }
+
+        EntityLocation& loc = m_locations[e];
+        const Entity moved = loc.archetype->removeRow(loc.row, true);
+        if (moved != kNullEntity) {
+            m_locations[moved].row = loc.row;
+        }
+        loc = {};
+    }
+
+    void ArchetypeStorage::clear() {
+        m_archetypes.clear();
+        m_byMask.clear();
+        m_locations.clear();
+    }
+
+    size_t ArchetypeStorage::count(uint32_t typeID) const {
+        size_t total = 0;
+        for (const auto& archetype : m_archetypes) {
+            if (archetype->contains(typeID)) {
+                total += archetype->size();
+            }
+        }
+        return total;
+    }
+
+    Registry::Registry(StorageMode storageMode) : mode(storageMode) {
+        if (mode == StorageMode::Archetype) {
+            archetypeStorage = std::make_unique<ArchetypeStorage>();
+        }
+    }
+
+#ifdef PNKR_DEBUG
+    void Registry::beginParallelAccess(const ComponentMask& writable) {
+        PNKR_CHECK(parallelAccessDepth == 0 && "Nested parallel ECS iteration over one registry");
+        ++parallelAccessDepth;
+        parallelWritable = writable;
+    }
+
+    void Registry::endParallelAccess() {
+        --parallelAccessDepth;
+        parallelWritable.reset();
+    }
+
+    void Registry::checkStructuralChange() const {
+        PNKR_CHECK(parallelAccessDepth == 0 && "Structural ECS change inside View::parallelEach");
+    }
+
+    void Registry::checkWriteAccess(uint32_t typeID) const {
+        PNKR_CHECK((parallelAccessDepth == 0 || parallelWritable.test(typeID)) &&
+                   "Mutable access to a component not handed to View::parallelEach");
+    }
+#endif
+
     Entity Registry::create() {
+#ifdef PNKR_DEBUG
+        checkStructuralChange();
+#endif
         if (!freeEntities.empty()) {
             Entity entity = freeEntities.back();
             freeEntities.pop_back();
@@ -17,6 +267,12 @@ namespace pnkr::ecs {
     }
 
     void Registry::destroy(Entity entity) {
+#ifdef PNKR_DEBUG
+        checkStructuralChange();
+#endif
+        if (archetypeStorage) {
+            archetypeStorage->destroy(entity);
+        }
         for (auto& pool : componentPools) {
           if (pool) {
             pool->remove(entity);
@@ -26,6 +282,12 @@ namespace pnkr::ecs {
     }
 
     void Registry::clear() {
+#ifdef PNKR_DEBUG
+        checkStructuralChange();
+#endif
+        if (archetypeStorage) {
+            archetypeStorage->clear();
+        }
         for (auto& pool : componentPools) {
           if (pool) {
             pool->clear();
@@ -48,10 +310,14 @@ namespace pnkr::ecs {
     }
 
     void EntityCommandBuffer::execute() {
+        for (const auto& [entity, removeComponent] : m_toRemove) {
+            removeComponent(m_registry, entity);
+        }
         for (Entity entity : m_toDestroy) {
             m_registry.destroy(entity);
         }
         m_toCreate.clear();
         m_toDestroy.clear();
+        m_toRemove.clear();
     }
 }
@@ -0,0 +1,195 @@
+#include "pnkr/core/FileReader.hpp"
+#include "pnkr/core/logger.hpp"
+#include "pnkr/core/profiler.hpp"
+#include "IoUringFileReader.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace pnkr::core {
+
+namespace {
+
+#ifdef _WIN32
+using NativeFile = HANDLE;
+const NativeFile kInvalidFile = INVALID_HANDLE_VALUE;
+
+NativeFile openFile(std::string_view path) {
+  return CreateFileA(std::string(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                     nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+                     nullptr);
+}
+
+void closeFile(NativeFile file) { CloseHandle(file); }
+
+int64_t readAt(NativeFile file, uint8_t *dst, uint64_t size, uint64_t offset) {
+  OVERLAPPED overlapped{};
+  overlapped.Offset = static_cast<DWORD>(offset);
+  overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  DWORD bytes = 0;
+  const auto chunk = static_cast<DWORD>(std::min<uint64_t>(size, 1U << 30));
+  if (!ReadFile(file, dst, chunk, &bytes, &overlapped)) {
+    return GetLastError() == ERROR_HANDLE_EOF ? 0 : -EIO;
+  }
+  return bytes;
+}
+
+int lastError() { return EIO; }
+#else
+using NativeFile = int;
+const NativeFile kInvalidFile = -1;
+
+NativeFile openFile(std::string_view path) {
+  return ::open(std::string(path).c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+void closeFile(NativeFile file) { ::close(file); }
+
+int64_t readAt(NativeFile file, uint8_t *dst, uint64_t size, uint64_t offset) {
+  const auto chunk = static_cast<size_t>(std::min<uint64_t>(size, 1U << 30));
+  const ssize_t bytes = ::pread(file, dst, chunk, static_cast<off_t>(offset));
+  return bytes < 0 ? -errno : bytes;
+}
+
+int lastError() { return errno; }
+#endif
+
+class BlockingFileReader final : public FileReader {
+public:
+  FileReaderBackend backend() const override {
+    return FileReaderBackend::Blocking;
+  }
+
+protected:
+  void readBatch(std::span<FileReadRequest> requests,
+                 BatchCounters &counters) override {
+    struct OpenFile {
+      std::string_view path;
+      NativeFile file;
+      int error;
+    };
+    // Batches are a handful of files, so a linear lookup beats a map.
+    std::vector<OpenFile> files;
+    for (FileReadRequest &req : requests) {
+      auto it = std::ranges::find(files, req.path, &OpenFile::path);
+      if (it == files.end()) {
+        ++counters.syscalls;
+        ++counters.filesOpened;
+        const NativeFile file = openFile(req.path);
+        files.push_back({req.path, file, file == kInvalidFile ? lastError() : 0});
+        it = files.end() - 1;
+      }
+      if (it->file == kInvalidFile) {
+        req.result = -it->error;
+        continue;
+      }
+
+      int64_t done = 0;
+      while (std::cmp_less(done, req.size)) {
+        ++counters.syscalls;
+        const int64_t bytes =
+            readAt(it->file, req.dst + done, req.size - done, req.offset + done);
+        if (bytes == -EINTR) {
+          continue;
+        }
+        if (bytes <= 0) {
+          // Errors replace the count; end of file leaves a short read.
+          done = bytes < 0 ? bytes : done;
+          break;
+        }
+        done += bytes;
+      }
+      req.result = done;
+    }
+
+    for (const OpenFile &open : files) {
+      if (open.file != kInvalidFile) {
+        ++counters.syscalls;
+        closeFile(open.file);
+      }
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<FileReader> FileReader::create(FileReaderBackend backend,
+                                               uint32_t queueDepth) {
+  if (backend != FileReaderBackend::Blocking) {
+    if (auto reader = createIoUringFileReader(queueDepth)) {
+      return reader;
+    }
+    if (backend == FileReaderBackend::IoUring) {
+      Logger::Core.warn(
+          "FileReader: io_uring unavailable, using blocking reads.");
+    }
+  }
+  return std::make_unique<BlockingFileReader>();
+}
+
+const char *FileReader::name() const {
+  switch (backend()) {
+  case FileReaderBackend::IoUring:
+    return "io_uring";
+  case FileReaderBackend::Blocking:
+    return "blocking";
+  default:
+    return "auto";
+  }
+}
+
+bool FileReader::read(std::span<FileReadRequest> requests) {
+  PNKR_PROFILE_FUNCTION();
+  if (requests.empty()) {
+    return true;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  BatchCounters counters;
+  readBatch(requests, counters);
+  const auto end = std::chrono::steady_clock::now();
+
+  bool complete = true;
+  uint64_t bytes = 0;
+  for (const FileReadRequest &req : requests) {
+    if (req.result > 0) {
+      bytes += static_cast<uint64_t>(req.result);
+    }
+    complete &= req.result == static_cast<int64_t>(req.size);
+  }
+
+  m_bytesRead.fetch_add(bytes, std::memory_order_relaxed);
+  m_requests.fetch_add(requests.size(), std::memory_order_relaxed);
+  m_batches.fetch_add(1, std::memory_order_relaxed);
+  m_filesOpened.fetch_add(counters.filesOpened, std::memory_order_relaxed);
+  m_syscalls.fetch_add(counters.syscalls, std::memory_order_relaxed);
+  m_readNs.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count(),
+      std::memory_order_relaxed);
+  return complete;
+}
+
+FileReaderStats FileReader::stats() const {
+  FileReaderStats stats;
+  stats.bytesRead = m_bytesRead.load(std::memory_order_relaxed);
+  stats.requests = m_requests.load(std::memory_order_relaxed);
+  stats.batches = m_batches.load(std::memory_order_relaxed);
+  stats.filesOpened = m_filesOpened.load(std::memory_order_relaxed);
+  stats.syscalls = m_syscalls.load(std::memory_order_relaxed);
+  stats.readNs = m_readNs.load(std::memory_order_relaxed);
+  return stats;
+}
+
+} // namespace pnkr::core
@@ -0,0 +1,392 @@
+#include "IoUringFileReader.hpp"
+#include "pnkr/core/logger.hpp"
+
+#if PNKR_HAS_IO_URING
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace pnkr::core {
+
+namespace {
+
+// Largest single read; the SQE length field is 32 bits.
+constexpr uint64_t kMaxReadChunk = 1ULL << 30;
+
+// Back-to-back EINTR/EAGAIN/EBUSY results from io_uring_enter before the
+// batch is treated as failed.
+constexpr uint32_t kMaxEnterRetries = 64;
+
+int ioUringSetup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete,
+                 unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit,
+                                  minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void *arg, unsigned count) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// Talks to the kernel through the raw syscalls and the shared rings, so
+// there is no liburing dependency. One submitter at a time: batches from
+// different threads take turns.
+class IoUringFileReader final : public FileReader {
+public:
+  ~IoUringFileReader() override {
+    if (m_sqes != nullptr) {
+      munmap(m_sqes, m_sqesSize);
+    }
+    if (m_cqRing != nullptr && m_cqRing != m_sqRing) {
+      munmap(m_cqRing, m_cqRingSize);
+    }
+    if (m_sqRing != nullptr) {
+      munmap(m_sqRing, m_sqRingSize);
+    }
+    if (m_ringFd >= 0) {
+      close(m_ringFd);
+    }
+  }
+
+  bool init(uint32_t queueDepth) {
+    io_uring_params params{};
+    m_ringFd = ioUringSetup(std::max(1U, queueDepth), &params);
+    if (m_ringFd < 0) {
+      Logger::Core.debug("FileReader: io_uring_setup failed: {}",
+                         std::strerror(errno));
+      return false;
+    }
+
+    m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqRingSize =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+      m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+    }
+
+    m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED) {
+      m_sqRing = nullptr;
+      return false;
+    }
+    if (singleMmap) {
+      m_cqRing = m_sqRing;
+    } else {
+      m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_CQ_RING);
+      if (m_cqRing == MAP_FAILED) {
+        m_cqRing = nullptr;
+        return false;
+      }
+    }
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      return false;
+    }
+    m_sqes = static_cast<io_uring_sqe *>(sqes);
+
+    auto *sq = static_cast<uint8_t *>(m_sqRing);
+    m_sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    m_sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    m_sqEntries = params.sq_entries;
+
+    auto *cq = static_cast<uint8_t *>(m_cqRing);
+    m_cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  FileReaderBackend backend() const override {
+    return FileReaderBackend::IoUring;
+  }
+
+  bool registerBuffer(std::span<uint8_t> buffer) override {
+    std::scoped_lock lock(m_mutex);
+    if (m_fixedBegin != nullptr) {
+      ioUringRegister(m_ringFd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+      m_fixedBegin = m_fixedEnd = nullptr;
+    }
+    if (buffer.empty()) {
+      return false;
+    }
+    const iovec vec{buffer.data(), buffer.size()};
+    if (ioUringRegister(m_ringFd, IORING_REGISTER_BUFFERS, &vec, 1) < 0) {
+      // Usually RLIMIT_MEMLOCK; reads into the buffer still work, unpinned.
+      Logger::Core.warn("FileReader: io_uring buffer registration of {} MB "
+                        "failed: {}",
+                        buffer.size() >> 20, std::strerror(errno));
+      return false;
+    }
+    m_fixedBegin = buffer.data();
+    m_fixedEnd = buffer.data() + buffer.size();
+    return true;
+  }
+
+protected:
+  void readBatch(std::span<FileReadRequest> requests,
+                 BatchCounters &counters) override {
+    std::scoped_lock lock(m_mutex);
+
+    struct OpenFile {
+      std::string_view path;
+      int fd;
+      int error;
+    };
+    std::vector<OpenFile> files;
+    // Tags this batch's SQEs so a completion left over from an abandoned
+    // batch is never matched to a request of this one.
+    ++m_generation;
+    m_fileOf.assign(requests.size(), -1);
+    m_done.assign(requests.size(), 0);
+    m_queue.clear();
+    for (size_t i = 0; i < requests.size(); ++i) {
+      FileReadRequest &req = requests[i];
+      auto it = std::ranges::find(files, req.path, &OpenFile::path);
+      if (it == files.end()) {
+        ++counters.syscalls;
+        ++counters.filesOpened;
+        const int fd = open(std::string(req.path).c_str(), O_RDONLY | O_CLOEXEC);
+        files.push_back({req.path, fd, fd < 0 ? errno : 0});
+        it = files.end() - 1;
+      }
+      req.result = 0;
+      if (it->fd < 0) {
+        req.result = -it->error;
+      } else if (req.size > 0) {
+        m_fileOf[i] = it->fd;
+        m_queue.push_back(static_cast<uint32_t>(i));
+      }
+    }
+
+    uint32_t inFlight = 0;
+    uint32_t unsubmitted = 0;
+    uint32_t retries = 0;
+    while (!m_queue.empty() || inFlight > 0 || unsubmitted > 0) {
+      while (!m_queue.empty() && inFlight + unsubmitted < m_sqEntries) {
+        pushRead(requests, m_queue.front());
+        m_queue.pop_front();
+        ++unsubmitted;
+      }
+
+      ++counters.syscalls;
+      const int submitted = ioUringEnter(m_ringFd, unsubmitted, 1,
+                                         IORING_ENTER_GETEVENTS);
+      if (submitted < 0) {
+        const int error = errno;
+        if ((error == EINTR || error == EAGAIN || error == EBUSY) &&
+            ++retries <= kMaxEnterRetries) {
+          reap(requests, inFlight, counters);
+          continue;
+        }
+        Logger::Core.error("FileReader: io_uring_enter failed: {}",
+                           std::strerror(error));
+        // SQEs the kernel never consumed are dropped; reads already
+        // submitted still target the caller's buffers and fds, so they are
+        // waited out before the batch returns.
+        __atomic_store_n(m_sqTail, __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE),
+                         __ATOMIC_RELEASE);
+        unsubmitted = 0;
+        failRemaining(requests, -error);
+        drain(requests, inFlight, counters);
+        break;
+      }
+      retries = 0;
+      unsubmitted -= static_cast<uint32_t>(submitted);
+      inFlight += static_cast<uint32_t>(submitted);
+      reap(requests, inFlight, counters);
+    }
+
+    for (const OpenFile &file : files) {
+      if (file.fd >= 0) {
+        ++counters.syscalls;
+        close(file.fd);
+      }
+    }
+  }
+
+private:
+  void pushRead(std::span<FileReadRequest> requests, uint32_t index) {
+    const FileReadRequest &req = requests[index];
+    const uint64_t done = m_done[index];
+    uint8_t *dst = req.dst + done;
+    const uint64_t length = std::min(req.size - done, kMaxReadChunk);
+
+    const unsigned tail = *m_sqTail;
+    const unsigned slot = tail & m_sqMask;
+    io_uring_sqe &sqe = m_sqes[slot];
+    std::memset(&sqe, 0, sizeof(sqe));
+    // Reads that land in the registered staging memory skip page pinning.
+    const bool fixed = dst >= m_fixedBegin && dst + length <= m_fixedEnd &&
+                       m_fixedBegin != nullptr;
+    sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe.fd = m_fileOf[index];
+    sqe.off = req.offset + done;
+    sqe.addr = reinterpret_cast<uint64_t>(dst);
+    sqe.len = static_cast<uint32_t>(length);
+    sqe.buf_index = 0;
+    sqe.user_data = (static_cast<uint64_t>(m_generation) << 32) | index;
+    m_sqArray[slot] = slot;
+    __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  void reap(std::span<FileReadRequest> requests, uint32_t &inFlight,
+            BatchCounters &counters) {
+    unsigned head = *m_cqHead;
+    const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const io_uring_cqe &cqe = m_cqes[head & m_cqMask];
+      if (static_cast<uint32_t>(cqe.user_data >> 32) != m_generation) {
+        continue;
+      }
+      const auto index = static_cast<uint32_t>(cqe.user_data);
+      FileReadRequest &req = requests[index];
+      --inFlight;
+
+      if (cqe.res == -EAGAIN || cqe.res == -EINTR) {
+        m_queue.push_back(index);
+      } else if (cqe.res == -EINVAL) {
+        // Kernels before 5.6 have no IORING_OP_READ.
+        finishBlocking(req, index, counters);
+      } else if (cqe.res < 0) {
+        req.result = cqe.res;
+      } else if (cqe.res == 0) {
+        // End of file: report the short read.
+        req.result = static_cast<int64_t>(m_done[index]);
+      } else {
+        m_done[index] += static_cast<uint64_t>(cqe.res);
+        if (m_done[index] < req.size) {
+          m_queue.push_back(index);
+        } else {
+          req.result = static_cast<int64_t>(m_done[index]);
+        }
+      }
+    }
+    __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+  }
+
+  void finishBlocking(FileReadRequest &req, uint32_t index,
+                      BatchCounters &counters) {
+    uint64_t &done = m_done[index];
+    while (done < req.size) {
+      ++counters.syscalls;
+      const ssize_t bytes =
+          pread(m_fileOf[index], req.dst + done,
+                std::min(req.size - done, kMaxReadChunk),
+                static_cast<off_t>(req.offset + done));
+      if (bytes < 0 && errno == EINTR) {
+        continue;
+      }
+      if (bytes <= 0) {
+        req.result = bytes < 0 ? -errno : static_cast<int64_t>(done);
+        return;
+      }
+      done += static_cast<uint64_t>(bytes);
+    }
+    req.result = static_cast<int64_t>(done);
+  }
+
+  // Waits for every submitted read of the batch to complete. Nothing is
+  // resubmitted: reads that end short keep the error failRemaining set.
+  void drain(std::span<FileReadRequest> requests, uint32_t &inFlight,
+             BatchCounters &counters) {
+    uint32_t retries = 0;
+    while (inFlight > 0) {
+      ++counters.syscalls;
+      if (ioUringEnter(m_ringFd, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+          errno != EINTR && ++retries > kMaxEnterRetries) {
+        Logger::Core.error("FileReader: abandoning {} io_uring reads: {}",
+                           inFlight, std::strerror(errno));
+        break;
+      }
+      reap(requests, inFlight, counters);
+      m_queue.clear();
+    }
+  }
+
+  void failRemaining(std::span<FileReadRequest> requests, int error) {
+    for (size_t i = 0; i < requests.size(); ++i) {
+      if (requests[i].result == 0 && requests[i].size > 0) {
+        requests[i].result = error;
+      }
+    }
+    m_queue.clear();
+  }
+
+  std::mutex m_mutex;
+  int m_ringFd = -1;
+
+  void *m_sqRing = nullptr;
+  void *m_cqRing = nullptr;
+  size_t m_sqRingSize = 0;
+  size_t m_cqRingSize = 0;
+  io_uring_sqe *m_sqes = nullptr;
+  size_t m_sqesSize = 0;
+
+  unsigned *m_sqHead = nullptr;
+  unsigned *m_sqTail = nullptr;
+  unsigned *m_sqArray = nullptr;
+  unsigned m_sqMask = 0;
+  unsigned m_sqEntries = 0;
+  unsigned *m_cqHead = nullptr;
+  unsigned *m_cqTail = nullptr;
+  unsigned m_cqMask = 0;
+  io_uring_cqe *m_cqes = nullptr;
+
+  uint8_t *m_fixedBegin = nullptr;
+  uint8_t *m_fixedEnd = nullptr;
+
+  // Per-batch state, reused between batches.
+  std::vector<int> m_fileOf;
+  std::vector<uint64_t> m_done;
+  std::deque<uint32_t> m_queue;
+  uint32_t m_generation = 0;
+};
+
+} // namespace
+
+std::unique_ptr<FileReader> createIoUringFileReader(uint32_t queueDepth) {
+  auto reader = std::make_unique<IoUringFileReader>();
+  if (!reader->init(queueDepth)) {
+    return nullptr;
+  }
+  return reader;
+}
+
+} // namespace pnkr::core
+
+#else
+
+namespace pnkr::core {
+
+std::unique_ptr<FileReader> createIoUringFileReader(uint32_t) {
+  return nullptr;
+}
+
+} // namespace pnkr::core
+
+#endif
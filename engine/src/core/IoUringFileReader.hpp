@@ -0,0 +1,11 @@
+#pragma once
+
+#include "pnkr/core/FileReader.hpp"
+
+namespace pnkr::core {
+
+// Null when the platform or kernel has no usable io_uring, e.g. when a
+// container's seccomp policy blocks io_uring_setup.
+std::unique_ptr<FileReader> createIoUringFileReader(uint32_t queueDepth);
+
+} // namespace pnkr::core
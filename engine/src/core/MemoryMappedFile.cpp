@@ -1,5 +1,7 @@
 #include "pnkr/core/MemoryMappedFile.hpp"
 
+#include <algorithm>
+
 namespace pnkr::core {
 
 MemoryMappedFile::MemoryMappedFile(const std::filesystem::path &path) {
@@ -61,6 +63,24 @@ MemoryMappedFile::MemoryMappedFile(const std::filesystem::path &path) {
 #endif
 }
 
+void MemoryMappedFile::prefetch(size_t offset, size_t size) const {
+  if (m_mData == nullptr || offset >= m_mSize) {
+    return;
+  }
+  size = std::min(size, m_mSize - offset);
+#ifdef _WIN32
+  WIN32_MEMORY_RANGE_ENTRY range{};
+  range.VirtualAddress = const_cast<uint8_t *>(m_mData + offset);
+  range.NumberOfBytes = size;
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+  const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const size_t begin = offset & ~(pageSize - 1);
+  madvise(const_cast<uint8_t *>(m_mData + begin), size + (offset - begin),
+          MADV_WILLNEED);
+#endif
+}
+
 MemoryMappedFile::~MemoryMappedFile() {
 #ifdef _WIN32
   if (m_mData != nullptr) {
@@ -1,4 +1,5 @@
 #include "pnkr/renderer/AssetManager.hpp"
+#include "pnkr/assets/TextureDiskCache.hpp"
 #include "pnkr/renderer/TextureCache.hpp"
 #include "pnkr/renderer/FallbackTextureFactory.hpp"
 
@@ -39,11 +40,20 @@ namespace pnkr::renderer
 
     void AssetManager::unloadTexture(const std::filesystem::path& path, bool srgb)
     {
+      if (m_asyncLoader) {
+        const TexturePtr texture = m_textureCache.get(path, srgb);
+        if (texture.isValid()) {
+          m_asyncLoader->streaming().unregisterTexture(texture.handle());
+        }
+      }
       m_textureCache.remove(path, srgb);
     }
 
     void AssetManager::unloadAllTextures()
     {
+      if (m_asyncLoader) {
+        m_asyncLoader->streaming().clear();
+      }
       m_textureCache.clear();
     }
 
@@ -96,24 +106,6 @@ namespace pnkr::renderer
         }
       }
 
-#ifdef _WIN32
-        const char* localAppData = std::getenv("LOCALAPPDATA");
-        if (localAppData != nullptr) {
-          m_cacheDirectory = std::filesystem::path(localAppData) / "pnkr" /
-                             "cache" / "textures";
-        } else {
-          m_cacheDirectory =
-              std::filesystem::current_path() / ".pnkr_cache" / "textures";
-        }
-#else
-        const char* home = std::getenv("HOME");
-        if (home) {
-            m_cacheDirectory = std::filesystem::path(home) / ".cache" / "pnkr" / "textures";
-        } else {
-            m_cacheDirectory = std::filesystem::current_path() / ".pnkr_cache" / "textures";
-        }
-#endif
-
         if (m_renderer != nullptr) {
             m_fallbackFactory.createDefaults(m_defaultWhite, m_errorTexture, m_loadingTexture,
                                            m_defaultWhiteCube, m_errorCube, m_loadingCube);
@@ -144,6 +136,16 @@ namespace pnkr::renderer
         return {};
     }
 
+    TextureStreamingScheduler* AssetManager::textureStreaming()
+    {
+        return m_asyncLoader ? &m_asyncLoader->streaming() : nullptr;
+    }
+
+    UploadPacer* AssetManager::uploadPacing()
+    {
+        return m_asyncLoader ? &m_asyncLoader->uploadPacing() : nullptr;
+    }
+
     std::vector<TextureHandle> AssetManager::consumeCompletedTextures()
     {
         if (m_asyncLoader && m_asyncLoader->isInitialized())
@@ -162,29 +164,6 @@ namespace pnkr::renderer
         return std::memcmp(data.data(), ktx2Identifier, 12) == 0;
     }
 
-    size_t AssetManager::computeHash(const std::vector<uint8_t>& data)
-    {
-
-        size_t hash = 0x811c9dc5;
-        for (auto b : data)
-        {
-            hash ^= b;
-            hash *= 0x01000193;
-        }
-        return hash;
-    }
-
-    std::filesystem::path AssetManager::getCachePath(const std::vector<uint8_t>& encoded, bool srgb)
-    {
-        size_t hash = computeHash(encoded);
-
-        hash ^= std::hash<bool>{}(srgb) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-
-        char filename[32];
-        snprintf(filename, sizeof(filename), "%016llx.ktx2", static_cast<unsigned long long>(hash));
-        return m_cacheDirectory / filename;
-    }
-
     TexturePtr AssetManager::createTextureWithCache(const std::vector<uint8_t>& encoded, bool srgb)
     {
       if (encoded.empty()) {
@@ -196,10 +175,13 @@ namespace pnkr::renderer
             return loadTextureKTXFromMemory(std::span<const std::byte>(reinterpret_cast<const std::byte*>(encoded.data()), encoded.size()), srgb);
         }
 
-        std::filesystem::path cachePath = getCachePath(encoded, srgb);
-        if (std::filesystem::exists(cachePath))
+        auto& diskCache = assets::TextureDiskCache::global();
+        const uint64_t cacheKey = assets::TextureDiskCache::makeKey(
+            assets::TextureDiskCache::hashContent(encoded),
+            {.encoding = assets::TextureCacheEncoding::RGBA8Ktx2, .srgb = srgb});
+        if (const auto cachePath = diskCache.lookup(cacheKey))
         {
-            std::ifstream file(cachePath, std::ios::binary);
+            std::ifstream file(*cachePath, std::ios::binary);
             if (file)
             {
                 std::vector<uint8_t> cachedData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
@@ -229,14 +211,9 @@ namespace pnkr::renderer
           return m_errorTexture;
         }
 
-        if (!m_cacheDirectory.empty())
+        if (KTXUtils::saveToFile(diskCache.pathFor(cacheKey), ktxTex, &error))
         {
-            std::error_code ec;
-            std::filesystem::create_directories(m_cacheDirectory, ec);
-            if (!ec)
-            {
-                KTXUtils::saveToFile(cachePath, ktxTex, &error);
-            }
+            diskCache.insert(cacheKey);
         }
 
         ktx_uint8_t *outData = nullptr;
@@ -6,6 +6,7 @@
 #include "pnkr/renderer/TextureStreamer.hpp"
 #include "pnkr/renderer/ktx_utils.hpp"
 #include "pnkr/renderer/rhi_renderer.hpp"
+#include <algorithm>
 
 namespace pnkr::renderer {
 
@@ -23,7 +24,11 @@ struct AsyncIOLoader::FileLoadTask : enki::ITaskSet {
 
 AsyncIOLoader::AsyncIOLoader(RHIRenderer &renderer,
                              ResourceRequestManager &requestManager)
-    : m_renderer(&renderer), m_requestManager(&requestManager) {}
+    : m_renderer(&renderer), m_requestManager(&requestManager),
+      m_fileReader(core::FileReader::create()) {
+  core::Logger::Asset.info("AsyncIOLoader: Using {} file reads",
+                           m_fileReader->name());
+}
 
 AsyncIOLoader::~AsyncIOLoader() {
   waitAll();
@@ -125,14 +130,27 @@ void AsyncIOLoader::processFileRequest(const LoadRequest &req) {
     uploadReq.textureData = std::move(result.textureData);
     uploadReq.isRawImage = result.isRawImage;
     uploadReq.totalSize = result.totalSize;
-    uploadReq.targetMipLevels = result.targetMipLevels;
+
+    // Only stored mip chains can start below level 0; the texture is then
+    // created at the size of its base mip.
+    const uint32_t baseMip =
+        uploadReq.isRawImage
+            ? 0U
+            : std::min(req.baseMip,
+                       std::max(1U, uploadReq.textureData.mipLevels) - 1);
+    uploadReq.state.baseMip = baseMip;
+    uploadReq.targetMipLevels =
+        std::max(1U, result.targetMipLevels - baseMip);
 
     uploadReq.state.currentLevel = TextureStreamer::getInitialMipLevel(
         uploadReq.textureData, uploadReq.state.baseMip,
         uploadReq.state.direction);
 
+    const rhi::Extent3D &extent = uploadReq.textureData.extent;
     rhi::TextureDescriptor desc{};
-    desc.extent = uploadReq.textureData.extent;
+    desc.extent = {.width = std::max(1U, extent.width >> baseMip),
+                   .height = std::max(1U, extent.height >> baseMip),
+                   .depth = std::max(1U, extent.depth >> baseMip)};
     desc.format = uploadReq.textureData.format;
     desc.mipLevels = uploadReq.targetMipLevels;
     desc.arrayLayers = uploadReq.textureData.arrayLayers;
@@ -19,7 +19,8 @@ AsyncLoader::AsyncLoader(RHIRenderer &renderer, uint64_t stagingBufferSize) : m_
 
   m_ioLoader = std::make_shared<AsyncIOLoader>(*m_renderer, *m_requestManager);
   m_gpuTransfer = std::make_unique<GPUTransferQueue>(
-      *m_renderer, *m_requestManager, *m_stagingManager);
+      *m_renderer, *m_requestManager, *m_stagingManager,
+      m_ioLoader->fileReader());
 
   m_gpuTransfer->startThread();
   m_metrics.lastBandwidthUpdate = std::chrono::steady_clock::now();
@@ -72,16 +73,45 @@ void AsyncLoader::requestTexture(const std::string &path, TextureHandle handle,
                   .baseMip = baseMip,
                   .timestampStart = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count()};
 
+  m_streaming.registerTexture(handle, path, srgb, priority);
   m_requestManager->addFileRequest(req);
 }
 
+void AsyncLoader::scheduleStreaming() {
+  PNKR_PROFILE_FUNCTION();
+
+  m_streamRequests.clear();
+  m_streaming.update(m_streamRequests);
+  const double now = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count();
+  for (const TextureStreamRequest &stream : m_streamRequests) {
+    core::Logger::Asset.debug("AsyncLoader: Streaming '{}' at mip {}",
+                              stream.path, stream.baseMip);
+    m_requestManager->addFileRequest(LoadRequest{.path = stream.path,
+                                                 .targetHandle = stream.handle,
+                                                 .srgb = stream.srgb,
+                                                 .priority = stream.priority,
+                                                 .baseMip = stream.baseMip,
+                                                 .timestampStart = now});
+  }
+
+  // Largest and most recently visible textures are read first.
+  m_requestManager->reorderFileRequests([this](const LoadRequest &req) {
+    return m_streaming.priorityOf(req.targetHandle);
+  });
+}
+
 void AsyncLoader::syncToGPU() {
   PNKR_PROFILE_FUNCTION();
   if (!m_initialized)
     return;
 
   try {
-    // 1. Schedule IO Tasks
+    m_gpuTransfer->pacer().beginFrame();
+
+    // 1. Pick mip changes and order pending reads, then schedule IO Tasks
+    scheduleStreaming();
     m_ioLoader->scheduleRequests();
 
     // 2. Process Pending Creations (on Render Thread)
@@ -129,8 +159,10 @@ void AsyncLoader::syncToGPU() {
           m_renderer->destroyTexture(req.intermediateTexture);
         }
 
-        // Assign error texture to visual target to indicate failure
-        if (m_errorTexture.isValid()) {
+        // A failed mip change keeps the mips already resident; otherwise
+        // assign error texture to visual target to indicate failure
+        const bool keepResident = m_streaming.onFailed(req.req.targetHandle);
+        if (!keepResident && m_errorTexture.isValid()) {
           core::Logger::Render.trace("AsyncLoader: Failure path replaceTexture start");
           m_renderer->replaceTexture(req.req.targetHandle, m_errorTexture);
           core::Logger::Render.trace("AsyncLoader: Failure path replaceTexture end");
@@ -169,6 +201,20 @@ void AsyncLoader::syncToGPU() {
         core::Logger::Render.trace("AsyncLoader: Success path replaceTexture end (error)");
       }
 
+      if (req.intermediateTexture.isValid()) {
+        // Raw images get their mips generated, so only the KTX chain streams.
+        const rhi::Extent3D &extent = req.textureData.extent;
+        const uint64_t fullBytes =
+            req.isRawImage ? req.totalSize * 4 / 3 : req.totalSize;
+        m_streaming.onUploaded(req.req.targetHandle, extent.width,
+                               extent.height,
+                               req.isRawImage ? req.targetMipLevels
+                                              : req.textureData.mipLevels,
+                               fullBytes, req.state.baseMip, !req.isRawImage);
+      } else {
+        m_streaming.onFailed(req.req.targetHandle);
+      }
+
       if (req.textureData.dataPtr != nullptr || !req.textureData.ownedData.empty()) {
           KTXUtils::destroy(req.textureData);
       }
@@ -228,6 +274,22 @@ std::vector<TextureHandle> AsyncLoader::consumeCompletedTextures() {
   return result;
 }
 
+void AsyncLoader::uploadTextureRegions(
+    std::vector<TextureRegionUpload> uploads) {
+  if (!m_initialized || uploads.empty()) {
+    return;
+  }
+  m_gpuTransfer->enqueueRegionUploads(std::move(uploads));
+}
+
+std::vector<TextureRegionUploadResult>
+AsyncLoader::consumeCompletedRegionUploads() {
+  if (!m_initialized) {
+    return {};
+  }
+  return m_gpuTransfer->consumeCompletedRegionUploads();
+}
+
 bool AsyncLoader::isValidHandle(TextureHandle handle) const {
   if ((m_renderer == nullptr) || handle == INVALID_TEXTURE_HANDLE) {
     return false;
@@ -258,6 +320,56 @@ GPUStreamingStatistics AsyncLoader::getStatistics() const {
   stats.streamingPoolBudget = stats.stagingTotalBytes;
   stats.streamingPoolUsed = stats.stagingUsedBytes;
   stats.poolUtilizationPercent = (stats.streamingPoolBudget > 0) ? (double(stats.streamingPoolUsed) / stats.streamingPoolBudget) * 100.0 : 0.0;
+
+  const StagingStatistics staging = m_stagingManager->getStatistics();
+  const uint64_t wastedBytes = staging.ring.alignmentBytes + staging.ring.wrapBytes;
+  stats.stagingStalls = staging.ring.stalls;
+  stats.stagingStallMs = double(staging.ring.stallNs) / 1e6;
+  stats.stagingFragmentationPercent =
+      (staging.ring.bytesReserved + wastedBytes) > 0
+          ? double(wastedBytes) / double(staging.ring.bytesReserved + wastedBytes) * 100.0
+          : 0.0;
+  stats.stagingFailedReservations = staging.ring.failedReservations;
+  stats.stagingHeadRetries = staging.ring.headRetries;
+  stats.temporaryStagingAllocations = staging.temporaryAllocations;
+
+  const TextureStreamingStats residency = m_streaming.stats();
+  stats.textureResidentBytes = residency.residentBytes;
+  stats.textureTargetBytes = residency.targetBytes;
+  stats.textureResidencyBudget = residency.budgetBytes;
+  stats.streamedTextures = residency.streamableTextures;
+  stats.texturesDemoted = residency.demotedTextures;
+  stats.mipRequestsInFlight = residency.requestsInFlight;
+  stats.residencyOverBudget = residency.residentBytes > residency.budgetBytes;
+
+  const core::FileReaderStats reads = m_ioLoader->fileReader().stats();
+  stats.totalFileReadBytes = reads.bytesRead;
+  stats.avgFileReadTimeMs =
+      reads.batches > 0 ? double(reads.readNs) / reads.batches / 1e6 : 0.0;
+  stats.fileReadBatches = reads.batches;
+  stats.fileReadSyscalls = reads.syscalls;
+  stats.fileReaderBackend = m_ioLoader->fileReader().name();
+  stats.bytesInflatedTotal = m_gpuTransfer->getBytesInflatedTotal();
+
+  const uint64_t transferTotalNs = m_gpuTransfer->getTransferTotalNs();
+  stats.batchesSubmittedTotal = m_gpuTransfer->getBatchesSubmitted();
+  stats.transferThreadUtilization =
+      transferTotalNs > 0
+          ? double(m_gpuTransfer->getTransferActiveNs()) / transferTotalNs * 100.0
+          : 0.0;
+  stats.avgBatchSizeMB =
+      stats.batchesSubmittedTotal > 0
+          ? double(stats.bytesUploadedTotal) / stats.batchesSubmittedTotal /
+                (1024.0 * 1024.0)
+          : 0.0;
+  const UploadPacingStats pacing = m_gpuTransfer->pacer().stats();
+  stats.uploadPacingAdaptive =
+      m_gpuTransfer->pacer().settings().mode == UploadPacingMode::Adaptive;
+  stats.uploadFrameBudgetBytes = pacing.frameBudgetBytes;
+  stats.uploadThroughputMBps = pacing.throughputMBps;
+  stats.uploadDeferredBatches = pacing.deferredBatches;
+  stats.copyCommandsTotal = m_gpuTransfer->getCopyCommandsTotal();
+  stats.copyRegionsTotal = m_gpuTransfer->getCopyRegionsTotal();
   
   return stats;
 }
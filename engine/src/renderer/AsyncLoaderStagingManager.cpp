@@ -4,13 +4,11 @@
 
 namespace pnkr::renderer {
 AsyncLoaderStagingManager::AsyncLoaderStagingManager(RHIResourceManager *resourceManager, uint64_t ringBufferSize)
-    : m_resourceManager(resourceManager), m_ringBufferSize(ringBufferSize) {
+    : m_resourceManager(resourceManager), m_ringBufferSize(ringBufferSize),
+      m_ring(ringBufferSize, kPageSize) {
   
-  // Align size to page size
-  if (m_ringBufferSize % kPageSize != 0) {
-      m_ringBufferSize = ((m_ringBufferSize + kPageSize - 1) / kPageSize) * kPageSize;
-  }
-  m_totalPages = static_cast<uint32_t>(m_ringBufferSize / kPageSize);
+  // The ring rounds the size up to whole pages
+  m_ringBufferSize = m_ring.size();
 
   rhi::BufferDescriptor desc{};
   desc.size = m_ringBufferSize;
@@ -26,7 +24,8 @@ AsyncLoaderStagingManager::AsyncLoaderStagingManager(RHIResourceManager *resourc
       m_initialized = true;
       core::Logger::Asset.info("AsyncLoaderStagingManager: Initialized ring "
                                "buffer ({} MB, {} pages)",
-                               m_ringBufferSize / (1024 * 1024), m_totalPages);
+                               m_ringBufferSize / (1024 * 1024),
+                               m_ring.pageCount());
     } else {
       core::Logger::Asset.error(
           "AsyncLoaderStagingManager: Failed to map ring buffer memory");
@@ -37,48 +36,12 @@ AsyncLoaderStagingManager::AsyncLoaderStagingManager(RHIResourceManager *resourc
         "This may be due to insufficient GPU memory.",
         m_ringBufferSize / (1024 * 1024));
   }
-
-  m_pages.resize(m_totalPages);
 }
 
 AsyncLoaderStagingManager::~AsyncLoaderStagingManager() { cleanup(); }
 
 uint64_t AsyncLoaderStagingManager::beginBatch() {
-  return m_nextBatchId.fetch_add(1, std::memory_order_relaxed);
-}
-
-bool AsyncLoaderStagingManager::waitForPages(uint32_t startPage,
-                                             uint32_t endPage,
-                                             uint64_t currentBatchId,
-                                             bool wait) {
-  std::unique_lock<std::mutex> lock(m_batchMutex);
-
-  for (uint32_t i = startPage; i < endPage && i < m_totalPages; ++i) {
-    const uint64_t pageBatchId = m_pages[i].lastBatchId;
-
-    if (pageBatchId == 0) {
-      continue;
-    }
-
-    if (pageBatchId >= currentBatchId) {
-      // This page is already being used by a newer or current batch.
-      // If it's the current batch, we are just overwriting which is fine in
-      // some cases but here it shouldn't happen.
-      continue;
-    }
-
-    if (m_completedBatchId.load(std::memory_order_acquire) < pageBatchId) {
-      if (!wait) {
-        return false;
-      }
-      m_batchCv.wait(lock, [&]() {
-        return m_completedBatchId.load(std::memory_order_acquire) >=
-               pageBatchId;
-      });
-    }
-  }
-
-  return true;
+  return m_ring.beginBatch();
 }
 
 AsyncLoaderStagingManager::Allocation
@@ -98,32 +61,14 @@ AsyncLoaderStagingManager::reserve(uint64_t size, uint64_t batchId, bool wait) {
     return {};
   }
 
-  std::unique_lock<std::mutex> lock(m_ringMutex);
-
-  uint64_t start = (m_head + 255) & ~255;
-
-  if (start + size > m_ringBufferSize) {
-    start = 0;
-  }
-
-  uint32_t startPage = static_cast<uint32_t>(start / kPageSize);
-  uint32_t endPage =
-      static_cast<uint32_t>((start + size + kPageSize - 1) / kPageSize);
-  endPage = std::min(endPage, m_totalPages);
-
-  lock.unlock();
-
-  if (!waitForPages(startPage, endPage, batchId, wait)) {
+  const std::optional<uint64_t> start = m_ring.reserve(size, batchId, wait);
+  if (!start) {
     return {};
   }
 
-  lock.lock();
-
-  m_head = start + size;
-
   Allocation alloc{};
-  alloc.offset = start;
-  alloc.systemPtr = m_ringBufferMapped + start;
+  alloc.offset = *start;
+  alloc.systemPtr = m_ringBufferMapped + *start;
   alloc.buffer = m_ringBuffer;
   alloc.isTemporary = false;
   alloc.tempHandle = nullptr;
@@ -133,29 +78,11 @@ AsyncLoaderStagingManager::reserve(uint64_t size, uint64_t batchId, bool wait) {
 
 void AsyncLoaderStagingManager::markPages(uint64_t offset, uint64_t size,
                                           uint64_t batchId) {
-  std::unique_lock<std::mutex> lock(m_ringMutex);
-
-  uint32_t startPage = static_cast<uint32_t>(offset / kPageSize);
-  uint32_t endPage =
-      static_cast<uint32_t>((offset + size + kPageSize - 1) / kPageSize);
-
-  for (uint32_t i = startPage; i < endPage && i < m_totalPages; ++i) {
-    m_pages[i].lastBatchId = batchId;
-  }
+  m_ring.markPages(offset, size, batchId);
 }
 
 void AsyncLoaderStagingManager::notifyBatchComplete(uint64_t batchId) {
-  uint64_t current = m_completedBatchId.load(std::memory_order_acquire);
-
-  while (batchId > current) {
-    if (m_completedBatchId.compare_exchange_weak(current, batchId,
-                                                 std::memory_order_release,
-                                                 std::memory_order_acquire)) {
-      break;
-    }
-  }
-
-  m_batchCv.notify_all();
+  m_ring.notifyBatchComplete(batchId);
 }
 
 void AsyncLoaderStagingManager::cleanup() {
@@ -169,8 +96,9 @@ void AsyncLoaderStagingManager::cleanup() {
     m_ringBuffer = nullptr;
   }
 
-  std::scoped_lock lock(m_temporaryMutex);
-  for (auto &staging : m_temporaryBuffers) {
+  for (size_t i = 0; i < kMaxTemporaryBuffers; ++i) {
+    auto &staging = m_temporaryBuffers[i];
+    m_temporarySlots[i].store(TemporarySlot::Empty, std::memory_order_relaxed);
     if (staging && staging->handle.isValid()) {
       // Should not happen with new logic, but keep for fallback
       if (staging->buffer != nullptr && staging->mapped != nullptr) {
@@ -192,56 +120,57 @@ void AsyncLoaderStagingManager::cleanup() {
 
 StagingBuffer *
 AsyncLoaderStagingManager::allocateTemporaryBuffer(uint64_t size) {
-  for (auto &staging : m_temporaryBuffers) {
-    bool expected = false;
-    if (staging && staging->size >= size &&
-        staging->inUse.compare_exchange_strong(expected, true,
-                                               std::memory_order_acquire)) {
-      return staging.get();
+  for (size_t i = 0; i < kMaxTemporaryBuffers; ++i) {
+    if (m_temporarySlots[i].load(std::memory_order_acquire) !=
+        TemporarySlot::Ready) {
+      continue;
     }
-  }
-
-  std::scoped_lock lock(m_temporaryMutex);
-
-  for (auto &staging : m_temporaryBuffers) {
+    StagingBuffer *staging = m_temporaryBuffers[i].get();
     bool expected = false;
-    if (staging && staging->size >= size &&
+    if (staging->size >= size &&
         staging->inUse.compare_exchange_strong(expected, true,
                                                std::memory_order_acquire)) {
-      return staging.get();
+      m_temporaryAllocations.fetch_add(1, std::memory_order_relaxed);
+      return staging;
     }
   }
 
-  for (auto &stagingSlot : m_temporaryBuffers) {
-    if (!stagingSlot) {
-      auto staging = std::make_unique<StagingBuffer>();
-      staging->size = size;
+  for (size_t i = 0; i < kMaxTemporaryBuffers; ++i) {
+    auto expectedSlot = TemporarySlot::Empty;
+    if (!m_temporarySlots[i].compare_exchange_strong(
+            expectedSlot, TemporarySlot::Creating, std::memory_order_acq_rel)) {
+      continue;
+    }
 
-      rhi::BufferDescriptor desc{};
-      desc.size = size;
-      desc.usage = rhi::BufferUsage::TransferSrc;
-      desc.memoryUsage = rhi::MemoryUsage::CPUToGPU;
+    auto staging = std::make_unique<StagingBuffer>();
+    staging->size = size;
 
-      // Use raw device creation to bypass Thread Thread assertion in RHIResourceManager
-      staging->rawBuffer = m_resourceManager->getDevice()->createBuffer("AsyncLoader_TemporaryStaging", desc);
-      staging->buffer = staging->rawBuffer.get();
-      
-      // Old way:
-      // staging->handle = m_resourceManager->createBuffer("AsyncLoader_TemporaryStaging", desc);
-      // staging->buffer = m_resourceManager->getBuffer(staging->handle);
+    rhi::BufferDescriptor desc{};
+    desc.size = size;
+    desc.usage = rhi::BufferUsage::TransferSrc;
+    desc.memoryUsage = rhi::MemoryUsage::CPUToGPU;
 
-      if (staging->buffer != nullptr) {
-        staging->mapped = reinterpret_cast<uint8_t *>(staging->buffer->map());
-        staging->inUse.store(true, std::memory_order_release);
+    // Use raw device creation to bypass Thread Thread assertion in RHIResourceManager
+    staging->rawBuffer = m_resourceManager->getDevice()->createBuffer("AsyncLoader_TemporaryStaging", desc);
+    staging->buffer = staging->rawBuffer.get();
 
-        StagingBuffer *ptr = staging.get();
-        stagingSlot = std::move(staging);
-        return ptr;
-      }
+    if (staging->buffer == nullptr) {
+      m_temporarySlots[i].store(TemporarySlot::Empty, std::memory_order_release);
+      m_failedTemporaryAllocations.fetch_add(1, std::memory_order_relaxed);
       return nullptr;
     }
+
+    staging->mapped = reinterpret_cast<uint8_t *>(staging->buffer->map());
+    staging->inUse.store(true, std::memory_order_relaxed);
+
+    StagingBuffer *ptr = staging.get();
+    m_temporaryBuffers[i] = std::move(staging);
+    m_temporarySlots[i].store(TemporarySlot::Ready, std::memory_order_release);
+    m_temporaryAllocations.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
   }
 
+  m_failedTemporaryAllocations.fetch_add(1, std::memory_order_relaxed);
   core::Logger::Asset.warn(
       "AsyncLoaderStagingManager: Maximum temporary staging buffers reached");
   return nullptr;
@@ -249,9 +178,10 @@ AsyncLoaderStagingManager::allocateTemporaryBuffer(uint64_t size) {
 
 uint32_t AsyncLoaderStagingManager::getActiveTemporaryBufferCount() const {
   uint32_t count = 0;
-  std::scoped_lock lock(m_temporaryMutex);
-  for (const auto &b : m_temporaryBuffers) {
-    if (b && b->inUse.load(std::memory_order_relaxed)) {
+  for (size_t i = 0; i < kMaxTemporaryBuffers; ++i) {
+    if (m_temporarySlots[i].load(std::memory_order_acquire) ==
+            TemporarySlot::Ready &&
+        m_temporaryBuffers[i]->inUse.load(std::memory_order_relaxed)) {
       count++;
     }
   }
@@ -265,17 +195,16 @@ void AsyncLoaderStagingManager::releaseTemporaryBuffer(StagingBuffer *buffer) {
 }
 
 uint64_t AsyncLoaderStagingManager::getUsedBytes() const {
-  std::unique_lock<std::mutex> lock(m_ringMutex);
-  uint64_t completed = m_completedBatchId.load(std::memory_order_acquire);
-  uint64_t used = 0;
-  
-  // This is an estimation based on pages. 
-  // Ideally we would track bytes, but since we mark pages, we count pages that have pending batches.
-  for (const auto& page : m_pages) {
-     if (page.lastBatchId > completed) {
-         used += kPageSize;
-     }
-  }
-  return used;
+  return m_ring.usedBytes();
+}
+
+StagingStatistics AsyncLoaderStagingManager::getStatistics() const {
+  StagingStatistics stats;
+  stats.ring = m_ring.stats();
+  stats.temporaryAllocations =
+      m_temporaryAllocations.load(std::memory_order_relaxed);
+  stats.failedTemporaryAllocations =
+      m_failedTemporaryAllocations.load(std::memory_order_relaxed);
+  return stats;
 }
 } // namespace pnkr::renderer
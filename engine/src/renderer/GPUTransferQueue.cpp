@@ -6,16 +6,25 @@
 #include "pnkr/renderer/rhi_renderer.hpp"
 #include <format>
 #include <imgui.h>
-#include <fstream>
 #include <pnkr/renderer/TextureStreamer.hpp>
 
 namespace pnkr::renderer {
 
 GPUTransferQueue::GPUTransferQueue(RHIRenderer &renderer,
                                    ResourceRequestManager &requestManager,
-                                   AsyncLoaderStagingManager &stagingManager)
+                                   AsyncLoaderStagingManager &stagingManager,
+                                   core::FileReader &fileReader)
     : m_renderer(&renderer), m_requestManager(&requestManager),
-      m_stagingManager(&stagingManager) {
+      m_stagingManager(&stagingManager), m_fileReader(&fileReader),
+      m_levelStream(fileReader) {
+  // Streamed texel data is read straight into the staging ring.
+  if (m_stagingManager->ringBufferMapped() != nullptr &&
+      m_fileReader->registerBuffer({m_stagingManager->ringBufferMapped(),
+                                    m_stagingManager->ringBufferSize()})) {
+    core::Logger::Asset.debug(
+        "GPUTransferQueue: Staging ring registered with the {} file reader",
+        m_fileReader->name());
+  }
 
   rhi::CommandPoolDescriptor poolDesc{};
   poolDesc.queueFamilyIndex = m_renderer->device()->transferQueueFamily();
@@ -77,6 +86,7 @@ void GPUTransferQueue::stopThread() {
     }
     b.tempStaging.clear();
     b.ringBufferRanges.clear();
+    b.regionResults.clear();
   }
 }
 
@@ -85,6 +95,28 @@ void GPUTransferQueue::notifyWorkAvailable() {
   m_transferCv.notify_one();
 }
 
+void GPUTransferQueue::enqueueRegionUploads(
+    std::vector<TextureRegionUpload> uploads) {
+  {
+    std::scoped_lock lock(m_regionMutex);
+    for (auto &upload : uploads) {
+      m_regionUploads.push_back(std::move(upload));
+    }
+  }
+  notifyWorkAvailable();
+}
+
+std::vector<TextureRegionUploadResult>
+GPUTransferQueue::consumeCompletedRegionUploads() {
+  std::scoped_lock lock(m_regionMutex);
+  return std::exchange(m_completedRegionUploads, {});
+}
+
+bool GPUTransferQueue::hasRegionUploads() {
+  std::scoped_lock lock(m_regionMutex);
+  return !m_regionUploads.empty();
+}
+
 bool GPUTransferQueue::isValidHandle(TextureHandle handle) const {
   if ((m_renderer == nullptr) || handle == INVALID_TEXTURE_HANDLE) {
     return false;
@@ -107,7 +139,7 @@ void GPUTransferQueue::transferLoop() {
 
       // If we had graphics work (mipmaps), we must also wait for the graphics
       // fence
-      bool graphicsPending = false;
+      bool graphicsPending = !m_inFlightBatches[slot].regionResults.empty();
       for (const auto &job : m_inFlightBatches[slot].jobs) {
         if (job.needsMipmapGeneration) {
           graphicsPending = true;
@@ -136,6 +168,14 @@ void GPUTransferQueue::transferLoop() {
       m_inFlightBatches[slot].tempStaging.clear();
       m_inFlightBatches[slot].ringBufferRanges.clear();
 
+      if (!m_inFlightBatches[slot].regionResults.empty()) {
+        std::scoped_lock lock(m_regionMutex);
+        auto &results = m_inFlightBatches[slot].regionResults;
+        m_completedRegionUploads.insert(m_completedRegionUploads.end(),
+                                        results.begin(), results.end());
+        results.clear();
+      }
+
       std::vector<UploadRequest> requeuedRequests;
 
       for (auto &req : batchJobs) {
@@ -186,8 +226,15 @@ void GPUTransferQueue::transferLoop() {
       continue;
     }
 
-    // Start a new batch
-    m_inFlightBatches[slotToUse].batchId = m_stagingManager->beginBatch();
+    // In adaptive pacing the frame's upload budget may already be spent.
+    const uint64_t byteBudget = m_pacer.batchBudget();
+    if (byteBudget == 0) {
+      std::unique_lock<std::mutex> lock(m_transferMutex);
+      m_transferCv.wait_for(lock, std::chrono::milliseconds(1),
+                            [this] { return !m_running; });
+      continue;
+    }
+    const UploadPacingSettings pacing = m_pacer.settings();
 
     std::optional<UploadRequest> reqOpt = m_requestManager->dequeueUpload();
 
@@ -195,7 +242,7 @@ void GPUTransferQueue::transferLoop() {
       std::unique_lock<std::mutex> lock(m_transferMutex);
       m_transferCv.wait_for(lock, std::chrono::milliseconds(10), [this] {
         return !m_running || m_requestManager->getHighPriorityQueueSize() > 0 ||
-               m_requestManager->getUploadQueueSize() > 0;
+               m_requestManager->getUploadQueueSize() > 0 || hasRegionUploads();
       });
 
       if (!m_running) {
@@ -206,10 +253,14 @@ void GPUTransferQueue::transferLoop() {
       reqOpt = m_requestManager->dequeueUpload();
     }
 
-    if (!reqOpt) {
+    if (!reqOpt && !hasRegionUploads()) {
       continue;
     }
 
+    // Start a new batch. Every id taken from the staging ring must be
+    // completed, so only take one once there is work for it.
+    m_inFlightBatches[slotToUse].batchId = m_stagingManager->beginBatch();
+
     auto *cmd = m_transferCmd[slotToUse].get();
     auto loopStart = std::chrono::steady_clock::now();
 
@@ -219,6 +270,7 @@ void GPUTransferQueue::transferLoop() {
 
     uint64_t bytesThisBatch = 0;
     uint32_t jobsThisBatch = 0;
+    uint32_t smallJobsThisBatch = 0;
     auto workStart = std::chrono::steady_clock::now();
 
     bool firstRequest = true;
@@ -231,9 +283,9 @@ void GPUTransferQueue::transferLoop() {
         firstRequest = false;
       } else {
         currentReqOpt = m_requestManager->dequeueUpload();
-        if (!currentReqOpt) {
-          break;
-        }
+      }
+      if (!currentReqOpt) {
+        break;
       }
 
       UploadRequest req = std::move(*currentReqOpt);
@@ -300,7 +352,14 @@ void GPUTransferQueue::transferLoop() {
       }
 
       bytesThisBatch += req.totalSize;
-      jobsThisBatch++;
+      // Fixed pacing keeps the single job cap; only adaptive pacing lets
+      // small uploads count against their own cap.
+      if (pacing.mode == UploadPacingMode::Adaptive &&
+          req.totalSize <= pacing.smallUploadBytes) {
+        smallJobsThisBatch++;
+      } else {
+        jobsThisBatch++;
+      }
 
       m_bytesUploadedTotal.fetch_add(req.totalSize, std::memory_order_relaxed);
       m_bytesThisFrameAccumulator.fetch_add(req.totalSize,
@@ -308,13 +367,14 @@ void GPUTransferQueue::transferLoop() {
 
       m_inFlightBatches[slotToUse].jobs.push_back(std::move(req));
 
-      if (bytesThisBatch >= kMaxUploadBytesPerFrame ||
-          jobsThisBatch >= kMaxUploadJobsPerFrame) {
+      if (bytesThisBatch >= byteBudget ||
+          jobsThisBatch >= pacing.maxJobsPerBatch ||
+          smallJobsThisBatch >= pacing.maxSmallJobsPerBatch) {
         break;
       }
     }
 
-    if (m_inFlightBatches[slotToUse].jobs.empty()) {
+    if (m_inFlightBatches[slotToUse].jobs.empty() && !hasRegionUploads()) {
       cmd->end();
       m_stagingManager->notifyBatchComplete(
           m_inFlightBatches[slotToUse].batchId);
@@ -322,11 +382,12 @@ void GPUTransferQueue::transferLoop() {
       continue;
     }
 
-    bool graphicsWorkNeeded = false;
     auto *graphicsCmd = m_graphicsCmd[slotToUse].get();
 
     graphicsCmd->begin();
 
+    bool graphicsWorkNeeded = recordRegionUploads(slotToUse, graphicsCmd);
+
     std::vector<rhi::RHIMemoryBarrier> acquireBarriers;
 
     uint32_t transferFamily = m_renderer->device()->transferQueueFamily();
@@ -367,11 +428,12 @@ void GPUTransferQueue::transferLoop() {
     cmd->end();
 
     auto workEnd = std::chrono::steady_clock::now();
-    m_transferActiveNs.fetch_add(
+    const auto activeNs = static_cast<uint64_t>(
         std::chrono::duration_cast<std::chrono::nanoseconds>(workEnd -
                                                              workStart)
-            .count(),
-        std::memory_order_relaxed);
+            .count());
+    m_transferActiveNs.fetch_add(activeNs, std::memory_order_relaxed);
+    m_pacer.onBatchRecorded(bytesThisBatch, activeNs);
     m_batchesSubmitted.fetch_add(1, std::memory_order_relaxed);
 
     {
@@ -427,6 +489,171 @@ void GPUTransferQueue::transferLoop() {
   }
 }
 
+bool GPUTransferQueue::recordRegionUploads(uint32_t slot,
+                                           rhi::RHICommandList *cmd) {
+  PNKR_PROFILE_FUNCTION();
+  auto &batch = m_inFlightBatches[slot];
+
+  std::vector<TextureRegionUpload> uploads;
+  std::vector<uint64_t> offsets;
+  uint64_t totalSize = 0;
+  {
+    std::scoped_lock lock(m_regionMutex);
+    while (!m_regionUploads.empty()) {
+      const uint64_t offset = (totalSize + 15) & ~15ULL;
+      const uint64_t size = m_regionUploads.front().size();
+      if (!uploads.empty() && offset + size > kMaxRegionBytesPerBatch) {
+        break;
+      }
+      offsets.push_back(offset);
+      totalSize = offset + size;
+      uploads.push_back(std::move(m_regionUploads.front()));
+      m_regionUploads.pop_front();
+    }
+  }
+  if (uploads.empty()) {
+    return false;
+  }
+
+  auto allocation =
+      m_stagingManager->reserve(totalSize, batch.batchId, false);
+  if (allocation.systemPtr == nullptr) {
+    // Retry in a later batch, still ahead of anything queued since.
+    std::scoped_lock lock(m_regionMutex);
+    for (auto it = uploads.rbegin(); it != uploads.rend(); ++it) {
+      m_regionUploads.push_front(std::move(*it));
+    }
+    return false;
+  }
+  if (allocation.isTemporary) {
+    batch.tempStaging.push_back(allocation.tempHandle);
+  } else {
+    batch.ringBufferRanges.emplace_back(allocation.offset, totalSize);
+  }
+
+  // Every row of every file-backed region goes into one read batch.
+  m_fileReads.clear();
+  std::vector<uint32_t> readOwners;
+  for (uint32_t i = 0; i < uploads.size(); ++i) {
+    const auto &upload = uploads[i];
+    uint8_t *dst = allocation.systemPtr + offsets[i];
+    if (!upload.data.empty()) {
+      std::ranges::copy(upload.data, dst);
+      continue;
+    }
+    for (uint32_t row = 0; row < upload.rowCount; ++row) {
+      m_fileReads.push_back({.path = upload.path,
+                             .offset = upload.fileOffset + row * upload.rowPitch,
+                             .size = upload.rowBytes,
+                             .dst = dst + row * upload.rowBytes});
+      readOwners.push_back(i);
+    }
+  }
+
+  std::vector<bool> succeeded(uploads.size(), true);
+  if (!m_fileReads.empty()) {
+    PNKR_PROFILE_SCOPE("FileRead");
+    if (!m_fileReader->read(m_fileReads)) {
+      for (size_t r = 0; r < m_fileReads.size(); ++r) {
+        const auto &read = m_fileReads[r];
+        if (read.result != static_cast<int64_t>(read.size) &&
+            succeeded[readOwners[r]]) {
+          succeeded[readOwners[r]] = false;
+          core::Logger::Asset.error(
+              "GPUTransferQueue: Region read failed for '{}' at offset {} ({})",
+              read.path, read.offset, read.result);
+        }
+      }
+    }
+  }
+
+  // One copy per target texture, in the order the targets first appear.
+  const rhi::ShaderStageFlags shaderStages =
+      rhi::ShaderStage::Vertex | rhi::ShaderStage::Fragment |
+      rhi::ShaderStage::Compute;
+  std::vector<bool> recorded(uploads.size(), false);
+  std::vector<rhi::BufferTextureCopyRegion> regions;
+  for (size_t i = 0; i < uploads.size(); ++i) {
+    if (recorded[i]) {
+      continue;
+    }
+    rhi::RHITexture *target = uploads[i].target;
+    regions.clear();
+    for (size_t j = i; j < uploads.size(); ++j) {
+      if (uploads[j].target != target) {
+        continue;
+      }
+      recorded[j] = true;
+      // Nothing is copied into a missing target.
+      const bool success = succeeded[j] && target != nullptr;
+      batch.regionResults.push_back({.key = uploads[j].key, .success = success});
+      if (success) {
+        rhi::BufferTextureCopyRegion region = uploads[j].region;
+        region.bufferOffset = allocation.offset + offsets[j];
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        regions.push_back(region);
+      }
+    }
+    if (regions.empty() || target == nullptr) {
+      continue;
+    }
+
+    rhi::RHIMemoryBarrier barrier{};
+    barrier.texture = target;
+    barrier.srcAccessStage = shaderStages;
+    barrier.dstAccessStage = rhi::ShaderStage::Transfer;
+    barrier.oldLayout = uploads[i].layout;
+    barrier.newLayout = rhi::ResourceLayout::TransferDst;
+    cmd->pipelineBarrier(shaderStages, rhi::ShaderStage::Transfer, barrier);
+
+    cmd->copyBufferToTexture(allocation.buffer, target, regions);
+    m_copyCommandsTotal.fetch_add(1, std::memory_order_relaxed);
+    m_copyRegionsTotal.fetch_add(regions.size(), std::memory_order_relaxed);
+
+    barrier.srcAccessStage = rhi::ShaderStage::Transfer;
+    barrier.dstAccessStage = shaderStages;
+    barrier.oldLayout = rhi::ResourceLayout::TransferDst;
+    barrier.newLayout = rhi::ResourceLayout::ShaderReadOnly;
+    cmd->pipelineBarrier(rhi::ShaderStage::Transfer, shaderStages, barrier);
+  }
+
+  m_bytesUploadedTotal.fetch_add(totalSize, std::memory_order_relaxed);
+  m_bytesThisFrameAccumulator.fetch_add(totalSize, std::memory_order_relaxed);
+  return true;
+}
+
+bool GPUTransferQueue::inflateRegion(const UploadRequest &req,
+                                     const CopyRegionPlan &plan,
+                                     std::span<uint8_t> stagingBuffer,
+                                     uint64_t offset) {
+  PNKR_PROFILE_FUNCTION();
+  const ZstdLevelStream::Level level{
+      .path = req.req.path,
+      .index = plan.m_sourceLevel,
+      .fileOffset = req.textureData.mipFileOffsets[plan.m_sourceLevel],
+      .compressedSize = req.textureData.mipFileSizes[plan.m_sourceLevel]};
+
+  // Fill the reserved staging space one ring page at a time.
+  constexpr uint64_t kPageSize = AsyncLoaderStagingManager::kPageSize;
+  uint64_t done = 0;
+  while (done < plan.m_copySize) {
+    const uint64_t pageEnd = ((offset + done) / kPageSize + 1) * kPageSize;
+    const uint64_t chunk =
+        std::min(plan.m_copySize - done, pageEnd - (offset + done));
+    if (!m_levelStream.read(level, plan.m_levelOffset + done,
+                            stagingBuffer.subspan(offset + done, chunk))) {
+      core::Logger::Asset.error(
+          "AsyncLoader: Inflating level {} of '{}' failed at offset {}",
+          plan.m_sourceLevel, req.req.path, plan.m_levelOffset + done);
+      return false;
+    }
+    done += chunk;
+  }
+  m_bytesInflatedTotal.fetch_add(plan.m_copySize, std::memory_order_relaxed);
+  return true;
+}
+
 bool GPUTransferQueue::processJob(UploadRequest &req, rhi::RHICommandList *cmd,
                                   rhi::RHIBuffer *srcBuffer,
                                   std::span<uint8_t> stagingBuffer,
@@ -468,8 +695,23 @@ bool GPUTransferQueue::processJob(UploadRequest &req, rhi::RHICommandList *cmd,
   const uint64_t stagingCapacity = stagingBuffer.size();
   bool collectedAnyRegion = false;
   uint64_t initialStagingOffset = stagingOffset;
-
-  std::ifstream fileStream;
+  const StreamRequestState initialState = req.state;
+
+  // Regions that are not in memory are read from the file in one batch
+  // before the copies are submitted.
+  m_fileReads.clear();
+  m_copyRegions.clear();
+
+  // Nothing of a failed pass is copied and the stream position is rolled
+  // back; the request goes to finalization as failed.
+  const auto failPass = [&]() {
+    req.state = initialState;
+    stagingOffset = initialStagingOffset;
+    req.stateMachine.tryTransition(ResourceState::Failed);
+    req.layoutFinalized = true;
+    req.needsMipmapGeneration = false;
+    return true;
+  };
 
   while (true) {
     uint64_t alignedStart = (stagingOffset + 15) & ~15;
@@ -512,34 +754,49 @@ bool GPUTransferQueue::processJob(UploadRequest &req, rhi::RHICommandList *cmd,
       if (plan.m_sourcePtr != nullptr) {
         std::copy_n(plan.m_sourcePtr, plan.m_copySize,
                     stagingBuffer.data() + alignedStart);
-      } else {
-        if (!fileStream.is_open()) {
-            fileStream.open(req.req.path, std::ios::binary);
-        }
-        if (fileStream.is_open()) {
-            fileStream.seekg(plan.m_fileOffset);
-            fileStream.read(reinterpret_cast<char*>(stagingBuffer.data() + alignedStart), plan.m_copySize);
-            if (!fileStream) {
-                core::Logger::Asset.error("AsyncLoader: File read failed for '{}' at offset {}", req.req.path, plan.m_fileOffset);
-                break;
-            }
-        } else {
-            core::Logger::Asset.error("AsyncLoader: Failed to open file for streaming '{}'", req.req.path);
-            break;
+      } else if (plan.m_inflateLevel) {
+        if (!inflateRegion(req, plan, stagingBuffer, alignedStart)) {
+          return failPass();
         }
+      } else {
+        m_fileReads.push_back({.path = req.req.path,
+                               .offset = plan.m_fileOffset,
+                               .size = plan.m_copySize,
+                               .dst = stagingBuffer.data() + alignedStart});
       }
     }
 
-    // Record copy command
+    // Every mip, layer and face of the job goes into a single copy below.
     rhi::BufferTextureCopyRegion region = plan.m_region;
     region.bufferOffset = alignedStart;
-
-    cmd->copyBufferToTexture(srcBuffer, rhiTex, {region});
+    m_copyRegions.push_back(region);
 
     stagingOffset = alignedStart + plan.m_copySize;
     TextureStreamer::advanceRequestState(req.state, req.textureData);
   }
 
+  if (!m_fileReads.empty()) {
+    PNKR_PROFILE_SCOPE("FileRead");
+    if (!m_fileReader->read(m_fileReads)) {
+      for (const auto &read : m_fileReads) {
+        if (read.result != static_cast<int64_t>(read.size)) {
+          core::Logger::Asset.error(
+              "AsyncLoader: File read failed for '{}' at offset {} ({})",
+              req.req.path, read.offset, read.result);
+          break;
+        }
+      }
+      return failPass();
+    }
+  }
+
+  if (!m_copyRegions.empty()) {
+    cmd->copyBufferToTexture(srcBuffer, rhiTex, m_copyRegions);
+    m_copyCommandsTotal.fetch_add(1, std::memory_order_relaxed);
+    m_copyRegionsTotal.fetch_add(m_copyRegions.size(),
+                                 std::memory_order_relaxed);
+  }
+
   // Check if done
   const uint32_t effectiveMipLevels =
       std::max(1U, req.textureData.mipLevels - req.state.baseMip);
@@ -66,8 +66,8 @@ void IndirectPipeline::setup(FrameGraph& frameGraph,
 
     addClothPass(frameGraph, passCtx);
  
-    addShadowPass(frameGraph, passCtx, drawCtx);
     addSkinningPass(frameGraph, passCtx, drawCtx);
+    addShadowPass(frameGraph, passCtx, drawCtx);
     addGeometryPasses(frameGraph, passCtx, drawCtx);
     addPostProcessPasses(frameGraph, passCtx);
 
@@ -166,10 +166,9 @@ void IndirectPipeline::addShadowPass(FrameGraph& fg, const RenderPassContext& ct
 }
 
 void IndirectPipeline::addSkinningPass(FrameGraph& fg,
-                                       const RenderPassContext& ctx,
-                                       const IndirectDrawContext& /*drawCtx*/)
+                                       const RenderPassContext& /*ctx*/,
+                                       const IndirectDrawContext& drawCtx)
 {
-    (void)(ctx);
     struct SkinData {
         FGHandle m_vertexBuffer;
         FGHandle m_skinnedVertexBuffer;
@@ -188,7 +187,8 @@ void IndirectPipeline::addSkinningPass(FrameGraph& fg,
                 (m_deps.model->morphVertexBuffer() != INVALID_BUFFER_HANDLE &&
                  frame.morphStateBuffer.isValid());
 
-            if (!hasSkinning && !hasMorphing) {
+            if ((!hasSkinning && !hasMorphing) ||
+                drawCtx.skinningDispatches.empty()) {
                 return;
             }
 
@@ -236,7 +236,7 @@ void IndirectPipeline::addSkinningPass(FrameGraph& fg,
                     FGAccess::StorageRead);
             }
         },
-        [&](const SkinData& /*data*/, const FrameGraphResources&,
+        [&, drawCtx](const SkinData& /*data*/, const FrameGraphResources&,
             rhi::RHICommandList* c) {
             using namespace passes::utils;
 
@@ -245,36 +245,61 @@ void IndirectPipeline::addSkinningPass(FrameGraph& fg,
             bool hasMorphing =
                 (m_deps.model->morphVertexBuffer().isValid() &&
                  frame.morphStateBuffer.isValid());
-            if (!hasSkinning && !hasMorphing) {
+            if ((!hasSkinning && !hasMorphing) ||
+                drawCtx.skinningDispatches.empty()) {
                 return;
             }
 
-            auto passCtxCopy = ctx;
-            passCtxCopy.cmd = c;
             ScopedGpuMarker scope(c, "SkinningPass");
 
-            [[maybe_unused]] gpu::SkinningPushConstants pc{};
-            // pc.vertices = m_deps.renderer->getBuffer(m_deps.model->vertexBuffer())
-            //                   ->getDeviceAddress();
-            // pc.skinnedVertices =
-            //     m_deps.renderer->getBuffer(frame.skinnedVertexBuffer.handle())
-            //         ->getDeviceAddress();
-            // pc.jointMatrices = m_deps.frameManager->getCurrentFrameBuffers()
-            //                        .jointMatricesDeviceAddr;
-            // pc.morphVertices = (m_deps.model->morphVertexBuffer() != INVALID_BUFFER_HANDLE)
-            //                        ? m_deps.renderer
-            //                              ->getBuffer(m_deps.model->morphVertexBuffer())
-            //                              ->getDeviceAddress()
-            //                        : 0;
-            // pc.morphStates = frame.morphStateDeviceAddr;
-            // pc.meshXforms = drawCtx.skinningMeshXformAddr;
-
-            // const uint32_t meshCount =
-            //     static_cast<uint32_t>(m_deps.model->meshes().size());
-            // pc.meshCount = meshCount;
-
-            // dispatchCompute(m_deps.renderer, c, m_deps.skinningPipeline, pc,
-            //                 meshCount, 1, 1);
+            const uint64_t jointsAddr =
+                hasSkinning ? m_deps.renderer
+                                  ->getBuffer(frame.jointMatricesBuffer.handle())
+                                  ->getDeviceAddress()
+                            : 0;
+            auto* skinnedBuffer =
+                m_deps.renderer->getBuffer(frame.skinnedVertexBuffer.handle());
+            const uint64_t skinnedAddr = skinnedBuffer->getDeviceAddress();
+
+            gpu::SkinningPushConstants pc{};
+            pc.inVertices = m_deps.renderer->getBuffer(m_deps.model->vertexBuffer())
+                                ->getDeviceAddress();
+            pc.morphDeltas = hasMorphing
+                                 ? m_deps.renderer
+                                       ->getBuffer(m_deps.model->morphVertexBuffer())
+                                       ->getDeviceAddress()
+                                 : 0;
+            pc.morphStates = hasMorphing ? frame.morphStateDeviceAddr : 0;
+            pc.meshXforms = drawCtx.skinningMeshXformAddr;
+            pc.vertexCount = drawCtx.skinnedVertexCount;
+            pc.hasSkinning = hasSkinning ? 1U : 0U;
+            pc.hasMorphing = hasMorphing ? 1U : 0U;
+            pc.numMorphStates =
+                static_cast<uint32_t>(m_deps.model->morphStates().size());
+
+            c->bindPipeline(
+                m_deps.renderer->getPipeline(m_deps.skinningPipeline.handle()));
+
+            // Every distinct palette poses its own copy of the vertices; the
+            // copies are disjoint, so the dispatches need no barriers.
+            const uint32_t groupCount = (drawCtx.skinnedVertexCount + 63) / 64;
+            for (const SkinningDispatch& dispatch : drawCtx.skinningDispatches) {
+                pc.jointMatrices =
+                    jointsAddr + (dispatch.jointOffset * sizeof(glm::mat4));
+                pc.outVertices =
+                    skinnedAddr + (dispatch.vertexSlot * drawCtx.skinnedSlotStride);
+                c->pushConstants(rhi::ShaderStage::Compute, pc);
+                c->dispatch(groupCount, 1, 1);
+            }
+
+            // The draws fetch skinned vertices through device addresses the
+            // frame graph does not track.
+            rhi::RHIMemoryBarrier barrier;
+            barrier.buffer = skinnedBuffer;
+            barrier.srcAccessStage = rhi::ShaderStage::Compute;
+            barrier.dstAccessStage = rhi::ShaderStage::Vertex;
+            c->pipelineBarrier(rhi::ShaderStage::Compute,
+                               rhi::ShaderStage::Vertex, barrier);
         });
 }
 void IndirectPipeline::addCullingPass(FrameGraph& fg, const RenderPassContext& ctx)
@@ -6,8 +6,11 @@
 #include "pnkr/renderer/GlobalResourcePool.hpp"
 #include "pnkr/renderer/IndirectPipeline.hpp"
 #include "pnkr/renderer/SceneUniformProvider.hpp"
+#include "pnkr/renderer/TextureStreamingScheduler.hpp"
 #include "pnkr/renderer/framegraph/FrameGraph.hpp"
 #include "pnkr/renderer/geometry/Frustum.hpp"
+#include "pnkr/renderer/geometry/FrustumCull.hpp"
+#include "pnkr/renderer/geometry/OcclusionCull.hpp"
 #include "pnkr/renderer/gpu_shared/SceneShared.h"
 #include "pnkr/renderer/passes/CullingPass.hpp"
 #include "pnkr/renderer/passes/GeometryPass.hpp"
@@ -22,6 +25,8 @@
 #include "pnkr/renderer/scene/Bounds.hpp"
 #include "pnkr/renderer/scene/GLTFUnifiedDOD.hpp"
 #include "pnkr/renderer/shader_payload_helpers.hpp"
+#include "pnkr/renderer/skinning/AnimationInstancer.hpp"
+#include <algorithm>
 #include <mutex>
 #include <span>
 #include <utility>
@@ -36,6 +41,16 @@ using namespace gpu;
 using namespace pnkr::renderer::scene;
 using pnkr::core::Logger;
 
+namespace {
+// CPU occlusion buffer; small enough to clear and rasterize in well under a
+// millisecond, fine enough for wall- and building-sized occluders.
+constexpr uint32_t kOcclusionWidth = 320;
+constexpr uint32_t kOcclusionHeight = 180;
+// Bounding radius over clip-space w below which a mesh is not worth
+// rasterizing as an occluder.
+constexpr float kMinOccluderSize = 0.1F;
+} // namespace
+
 AUTO_CVAR_FLOAT(rShadowBias, "Constant depth bias for shadow mapping", 0.005F);
 AUTO_CVAR_INT(r_msaa, "MSAA sample count (1, 2, 4)", 1, core::CVarFlags::save);
 AUTO_CVAR_BOOL(r_msaaSampleShading, "Enable MSAA per-sample shading", false,
@@ -198,6 +213,7 @@ void IndirectRenderer::init(RHIRenderer *renderer,
 
   m_materialHeap.initialize(m_renderer, 10000);
   m_jointBuffer.initialize(m_renderer, 65536);
+  m_instanceBuffer.initialize(m_renderer, &m_resourceMgr);
 
   if (m_model) {
     const auto &materials = m_model->materials();
@@ -267,6 +283,8 @@ void IndirectRenderer::update(float dt) {
   if (m_model) {
     AnimationSystem::update(*m_model, dt);
     m_model->scene().updateTransforms();
+    m_transformNodesTouched =
+        m_model->scene().transformStats().nodesTouched;
 
     if (!m_model->skins().empty()) {
       auto skinnedBounds = AnimationSystem::calculateSkinnedBounds(*m_model);
@@ -312,86 +330,162 @@ void IndirectRenderer::update(float dt) {
   }
 }
 
-TransientAllocation IndirectRenderer::updateGlobalTransforms() {
-  const auto &scene = m_model->scene();
-  if (scene.topoOrder().empty()) {
-    return {};
+void IndirectRenderer::cullOccluded() {
+  PNKR_PROFILE_FUNCTION();
+
+  const auto &registry = m_model->scene().registry();
+  const auto &occluderMeshes = m_model->assets().occluderMeshes();
+  if (m_occlusionCuller.width() == 0) {
+    m_occlusionCuller.resize(kOcclusionWidth, kOcclusionHeight);
+  }
+  m_occlusionCuller.begin(m_cullingViewProj);
+
+  // Occluders are the frustum survivors that can cover the most of the view.
+  m_occluderCandidates.clear();
+  for (const ecs::Entity entity : m_visibleEntities) {
+    const int32_t meshId = registry.get<MeshRenderer>(entity).meshID;
+    if (meshId < 0 || static_cast<size_t>(meshId) >= occluderMeshes.size() ||
+        occluderMeshes[meshId].indices.empty()) {
+      continue;
+    }
+    const auto &box = registry.get<WorldBounds>(entity).aabb;
+    const glm::vec3 center = (box.m_min + box.m_max) * 0.5F;
+    const float radius = glm::length(box.m_max - box.m_min) * 0.5F;
+    const float w = (m_cullingViewProj * glm::vec4(center, 1.0F)).w;
+    const float size = radius / std::max(w, 1e-3F);
+    if (size >= kMinOccluderSize) {
+      m_occluderCandidates.emplace_back(size, entity);
+    }
+  }
+  const size_t occluderCount =
+      std::min<size_t>(m_occluderCandidates.size(), m_settings.maxOccluders);
+  std::partial_sort(m_occluderCandidates.begin(),
+                    m_occluderCandidates.begin() + occluderCount,
+                    m_occluderCandidates.end(),
+                    [](const auto &a, const auto &b) { return a.first > b.first; });
+  if (occluderCount == 0) {
+    return;
+  }
+
+  for (size_t i = 0; i < occluderCount; ++i) {
+    const ecs::Entity entity = m_occluderCandidates[i].second;
+    const auto &mesh = occluderMeshes[registry.get<MeshRenderer>(entity).meshID];
+    m_occlusionCuller.addOccluder(mesh.positions, mesh.indices,
+                                  registry.get<WorldTransform>(entity).matrix);
   }
+  m_occlusionCuller.rasterize();
 
-  uint32_t maxEntityId = 0;
-  for (ecs::Entity e : scene.topoOrder()) {
-    maxEntityId = std::max(maxEntityId, (uint32_t)e);
+  m_occludeeBoxes.resize(m_visibleEntities.size());
+  for (size_t i = 0; i < m_visibleEntities.size(); ++i) {
+    m_occludeeBoxes[i] = registry.get<WorldBounds>(m_visibleEntities[i]).aabb;
+  }
+  const auto survivors = m_occlusionCuller.cull(m_occludeeBoxes);
+  // Survivors are ascending, so compacting in place keeps the order.
+  for (size_t i = 0; i < survivors.size(); ++i) {
+    m_visibleEntities[i] = m_visibleEntities[survivors[i]];
   }
-  size_t nodeCount = maxEntityId + 1;
-  size_t dataSize = nodeCount * sizeof(gpu::InstanceData);
+  m_visibleEntities.resize(survivors.size());
+}
 
-  auto alloc = m_frameManager.allocateUpload(dataSize, 16);
+void IndirectRenderer::reportTextureUsage(const scene::Camera &camera,
+                                          uint32_t height) {
+  PNKR_PROFILE_FUNCTION();
+  auto *streaming = m_renderer->assets()->textureStreaming();
+  if (streaming == nullptr) {
+    return;
+  }
 
-  if (alloc.mappedPtr != nullptr) {
-    auto *dst = reinterpret_cast<::gpu::InstanceData *>(alloc.mappedPtr);
-    auto &registry = m_model->scene().registry();
+  // The real camera decides what gets sharp, even with culling frozen.
+  const auto &sceneGraph = m_model->scene();
+  const auto &registry = sceneGraph.registry();
+  const glm::mat4 viewProj = camera.viewProj();
+  const std::vector<ecs::Entity> *entities = &m_visibleEntities;
+  if (m_settings.cullingMode != CullingMode::CPU || m_settings.freezeCulling) {
+    m_streamingEntities.clear();
+    sceneGraph.bvh().queryFrustum(geometry::createFrustum(viewProj),
+                                  m_streamingEntities);
+    entities = &m_streamingEntities;
+  }
 
-    uint64_t vertexBufferAddr = 0;
-    if (m_model->vertexBuffer() != INVALID_BUFFER_HANDLE) {
-      vertexBufferAddr =
-          m_renderer->getBuffer(m_model->vertexBuffer())->getDeviceAddress();
+  // Largest projected bounding-sphere diameter per material, in pixels.
+  const auto &materials = m_model->materials();
+  const auto &meshes = m_model->meshes();
+  const float pixelScale = camera.proj()[1][1] * static_cast<float>(height);
+  m_materialScreenSizes.assign(materials.size(), 0.0F);
+  for (const ecs::Entity entity : *entities) {
+    const auto &renderer = registry.get<MeshRenderer>(entity);
+    if (renderer.meshID < 0 ||
+        static_cast<size_t>(renderer.meshID) >= meshes.size()) {
+      continue;
     }
-
-    uint64_t skinnedVertexBufferAddr = 0;
-    auto &frame = m_frameManager.getCurrentFrameBuffers();
-    if (frame.skinnedVertexBuffer.isValid()) {
-      skinnedVertexBufferAddr =
-          m_renderer->getBuffer(frame.skinnedVertexBuffer.handle())
-              ->getDeviceAddress();
+    const auto &box = registry.get<WorldBounds>(entity).aabb;
+    const glm::vec3 center = (box.m_min + box.m_max) * 0.5F;
+    const float radius = glm::length(box.m_max - box.m_min) * 0.5F;
+    const float w = (viewProj * glm::vec4(center, 1.0F)).w;
+    // Inside the bounds, assume the surface fills the view.
+    const float pixels = w > radius ? radius / w * pixelScale
+                                    : static_cast<float>(height);
+
+    const auto raise = [&](uint32_t material) {
+      if (material < m_materialScreenSizes.size()) {
+        m_materialScreenSizes[material] =
+            std::max(m_materialScreenSizes[material], pixels);
+      }
+    };
+    if (renderer.materialOverride >= 0) {
+      raise(static_cast<uint32_t>(renderer.materialOverride));
+    } else {
+      for (const auto &prim : meshes[renderer.meshID].primitives) {
+        raise(prim.materialIndex);
+      }
     }
+  }
 
-    if (skinnedVertexBufferAddr == 0) {
-      skinnedVertexBufferAddr = vertexBufferAddr;
+  m_textureScreenSizes.clear();
+  for (size_t i = 0; i < materials.size(); ++i) {
+    if (m_materialScreenSizes[i] <= 0.0F) {
+      continue;
     }
+    forEachTextureSlot(materials[i], [&](const TextureSlot &slot) {
+      if (slot.hasTexture()) {
+        m_textureScreenSizes.emplace_back(slot.texture,
+                                          m_materialScreenSizes[i]);
+      }
+    });
+  }
+  streaming->reportScreenSizes(m_textureScreenSizes);
+}
 
-    const auto &topoOrder = m_model->scene().topoOrder();
-    core::TaskSystem::parallelFor(
-        (uint32_t)topoOrder.size(),
-        [&](enki::TaskSetPartition range, uint32_t) {
-          for (uint32_t i = range.start; i < range.end; ++i) {
-            ecs::Entity e = topoOrder[i];
-            auto &inst = dst[e];
-
-            inst.world = glm::mat4(1.0F);
-            inst.worldIT = glm::mat4(1.0F);
-            inst.vertexBufferPtr = 0;
-            inst.materialIndex = 0;
-            inst.meshIndex = 0;
-
-            if (registry.has<WorldTransform>(e)) {
-              const auto &wt = registry.get<WorldTransform>(e);
-              inst.world = wt.matrix;
-              inst.worldIT = glm::transpose(glm::inverse(wt.matrix));
-            }
+uint64_t IndirectRenderer::updateGlobalTransforms(rhi::RHICommandList *cmd) {
+  if (cmd == nullptr) {
+    return m_instanceBuffer.getDeviceAddress();
+  }
 
-            if (registry.has<MeshRenderer>(e)) {
-              const auto &mr = registry.get<MeshRenderer>(e);
-              inst.materialIndex =
-                  (mr.materialOverride >= 0)
-                      ? static_cast<uint32_t>(mr.materialOverride)
-                      : 0;
-              inst.meshIndex =
-                  (mr.meshID >= 0) ? static_cast<uint32_t>(mr.meshID) : 0;
-              inst.vertexBufferPtr = vertexBufferAddr;
-            } else if (registry.has<SkinnedMeshRenderer>(e)) {
-              const auto &smr = registry.get<SkinnedMeshRenderer>(e);
-              inst.materialIndex =
-                  (smr.materialOverride >= 0)
-                      ? static_cast<uint32_t>(smr.materialOverride)
-                      : 0;
-              inst.meshIndex = 0;
-              inst.vertexBufferPtr = skinnedVertexBufferAddr;
-            }
-          }
-        });
+  uint64_t vertexBufferAddr = 0;
+  if (m_model->vertexBuffer() != INVALID_BUFFER_HANDLE) {
+    vertexBufferAddr =
+        m_renderer->getBuffer(m_model->vertexBuffer())->getDeviceAddress();
   }
 
-  return alloc;
+  uint64_t skinnedVertexBufferAddr = 0;
+  auto &frame = m_frameManager.getCurrentFrameBuffers();
+  if (frame.skinnedVertexBuffer.isValid()) {
+    skinnedVertexBufferAddr =
+        m_renderer->getBuffer(frame.skinnedVertexBuffer.handle())
+            ->getDeviceAddress();
+  }
+
+  if (skinnedVertexBufferAddr == 0) {
+    skinnedVertexBufferAddr = vertexBufferAddr;
+  }
+
+  m_instanceBuffer.update({.renderer = *m_renderer,
+                           .cmd = *cmd,
+                           .frameManager = m_frameManager,
+                           .model = *m_model,
+                           .vertexBufferAddr = vertexBufferAddr,
+                           .skinnedVertexBufferAddr = skinnedVertexBufferAddr});
+  return m_instanceBuffer.getDeviceAddress();
 }
 
 void IndirectRenderer::processCompletedTextures() {
@@ -526,6 +620,50 @@ void IndirectRenderer::updateMorphTargets(rhi::RHICommandList *) {
   frame.morphStateDeviceAddr = alloc.deviceAddress;
 }
 
+void IndirectRenderer::bindInstancedSkins(rhi::RHICommandList *cmd,
+                                          IndirectDrawContext &ctx) {
+  if (m_animationInstancer == nullptr) {
+    return;
+  }
+  PNKR_PROFILE_FUNCTION();
+
+  auto &instancer = *m_animationInstancer;
+  instancer.uploadPalettes(*m_renderer, *cmd, m_frameManager, m_jointBuffer);
+
+  // Slot 0 of the skinned vertex buffer holds the model's own pose; every
+  // shared palette is skinned once into the slot after it.
+  auto &registry = m_model->scene().registry();
+  std::vector<uint8_t> dispatched(instancer.stats().uniquePoses, 0);
+  for (uint32_t i = 0; i < instancer.instanceCount(); ++i) {
+    const ecs::Entity entity = instancer.entity(i);
+    if (entity == ecs::kNullEntity || !registry.has<SkinnedMeshRenderer>(entity)) {
+      continue;
+    }
+
+    auto &smr = registry.get<SkinnedMeshRenderer>(entity);
+    const JointAllocation joints = instancer.jointAllocation(i);
+    smr.jointOffset = joints.offset;
+    smr.jointCount = joints.count;
+    if (joints.count == 0) {
+      smr.vertexSlot = 0;
+      continue;
+    }
+
+    const uint32_t pose = instancer.poseOf(i);
+    smr.vertexSlot = pose + 1;
+    if (dispatched[pose] == 0) {
+      dispatched[pose] = 1;
+      ctx.skinningDispatches.push_back(
+          {.jointOffset = joints.offset, .vertexSlot = smr.vertexSlot});
+    }
+  }
+
+  if (!ctx.skinningDispatches.empty()) {
+    m_frameManager.getCurrentFrameBuffers().jointMatricesBuffer =
+        BufferPtr(nullptr, m_jointBuffer.getBufferHandle());
+  }
+}
+
 void IndirectRenderer::buildDrawLists(IndirectDrawContext &ctx,
                                       const scene::Camera &camera) {
   ctx.dodContext.renderer = m_renderer;
@@ -536,6 +674,15 @@ void IndirectRenderer::buildDrawLists(IndirectDrawContext &ctx,
   ctx.dodContext.systemMeshCount = static_cast<uint32_t>(SystemMeshType::Count);
   ctx.dodContext.ignoreVisibility =
       (m_settings.cullingMode == CullingMode::GPU);
+  ctx.dodContext.visibleMeshes =
+      (m_settings.cullingMode == CullingMode::CPU) ? &m_visibleEntities
+                                                   : nullptr;
+  ctx.dodContext.lodErrorScale =
+      m_settings.lodSelection
+          ? scene::RenderBatcher::lodErrorScale(camera.proj()[1][1],
+                                                static_cast<float>(m_height),
+                                                m_settings.lodErrorPixels)
+          : 0.0F;
 
   ctx.shadowDodContext.renderer = m_renderer;
   ctx.shadowDodContext.model = m_model.get();
@@ -554,6 +701,8 @@ void IndirectRenderer::buildDrawLists(IndirectDrawContext &ctx,
             ->getDeviceAddress();
     ctx.shadowDodContext.vertexBufferOverride =
         ctx.dodContext.vertexBufferOverride;
+    ctx.dodContext.skinnedSlotStride = ctx.skinnedSlotStride;
+    ctx.shadowDodContext.skinnedSlotStride = ctx.skinnedSlotStride;
   }
 
   static core::LinearAllocator cpuTempAllocator(
@@ -722,13 +871,13 @@ IndirectRenderer::prepareFrame(rhi::RHICommandList *cmd,
                                const scene::Camera &camera, uint32_t width,
                                uint32_t height, debug::DebugLayer *debugLayer) {
   (void)width;
-  (void)height;
   (void)debugLayer;
   IndirectDrawContext ctx;
   auto &frame = m_frameManager.getCurrentFrameBuffers();
 
   if (!m_settings.freezeCulling) {
     m_cullingViewProj = camera.viewProj();
+    m_cullingCameraPos = camera.position();
   }
 
   m_jointBuffer.reset();
@@ -766,10 +915,18 @@ IndirectRenderer::prepareFrame(rhi::RHICommandList *cmd,
       m_jointBuffer.uploadJoints(uploadRequest);
       frame.jointMatricesBuffer =
           BufferPtr(nullptr, m_jointBuffer.getBufferHandle());
+      ctx.skinningDispatches.push_back(
+          {.jointOffset = alloc.offset, .vertexSlot = 0});
     }
   }
 
+  bindInstancedSkins(cmd, ctx);
+
   if (!m_model->skins().empty() || !m_model->morphStates().empty()) {
+    if (ctx.skinningDispatches.empty()) {
+      // Morph-only models still run the pass once into slot 0.
+      ctx.skinningDispatches.push_back({});
+    }
     {
       auto &registry = m_model->scene().registry();
       auto view = registry.view<MeshRenderer, WorldTransform>();
@@ -780,8 +937,13 @@ IndirectRenderer::prepareFrame(rhi::RHICommandList *cmd,
         mx.normalWorldToLocal = glm::mat4(1.0F);
       }
 
-      view.each([&](ecs::Entity, const MeshRenderer &mr,
+      // Instanced copies share their mesh with the node it was loaded from,
+      // whose transform is the one the skinned vertices must be local to.
+      view.each([&](ecs::Entity entity, const MeshRenderer &mr,
                     const WorldTransform &wt) {
+        if (registry.has<SkinnedMeshRenderer>(entity)) {
+          return;
+        }
         if (mr.meshID >= 0 && (size_t)mr.meshID < meshXforms.size()) {
           meshXforms[mr.meshID].invModel = glm::inverse(wt.matrix);
           meshXforms[mr.meshID].normalWorldToLocal = glm::transpose(wt.matrix);
@@ -796,13 +958,22 @@ IndirectRenderer::prepareFrame(rhi::RHICommandList *cmd,
       }
       ctx.skinningMeshXformAddr = xformAlloc.deviceAddress;
     }
+    const uint64_t slotBytes =
+        m_renderer->getBuffer(m_model->vertexBuffer())->size();
+    uint32_t slotCount = 1;
+    for (const SkinningDispatch &dispatch : ctx.skinningDispatches) {
+      slotCount = std::max(slotCount, dispatch.vertexSlot + 1);
+    }
+    ctx.skinnedSlotStride = slotBytes;
+    ctx.skinnedVertexCount =
+        static_cast<uint32_t>(slotBytes / sizeof(gpu::VertexGPU));
+
     if (!frame.skinnedVertexBuffer.isValid() ||
         m_renderer->getBuffer(frame.skinnedVertexBuffer.handle())->size() <
-            m_renderer->getBuffer(m_model->vertexBuffer())->size()) {
-      auto *srcBuf = m_renderer->getBuffer(m_model->vertexBuffer());
+            slotBytes * slotCount) {
       frame.skinnedVertexBuffer = m_renderer->createBuffer(
           "SkinnedVertexBuffer",
-          {.size = srcBuf->size(),
+          {.size = slotBytes * slotCount,
            .usage = rhi::BufferUsage::StorageBuffer |
                     rhi::BufferUsage::VertexBuffer |
                     rhi::BufferUsage::ShaderDeviceAddress,
@@ -824,10 +995,9 @@ IndirectRenderer::prepareFrame(rhi::RHICommandList *cmd,
   ctx.sceneDataAddr = ctx.cameraDataAddr;
 
   {
-    auto alloc = updateGlobalTransforms();
-    ctx.transformSlice = {.offset = alloc.offset, .size = alloc.size};
-    ctx.transformAddr = alloc.deviceAddress;
-    ctx.instanceXformAddr = alloc.deviceAddress;
+    const uint64_t instanceAddr = updateGlobalTransforms(cmd);
+    ctx.transformAddr = instanceAddr;
+    ctx.instanceXformAddr = instanceAddr;
   }
 
   m_materialHeap.flushUpdates(m_renderer, cmd, m_frameManager);
@@ -836,57 +1006,42 @@ IndirectRenderer::prepareFrame(rhi::RHICommandList *cmd,
   if (m_settings.cullingMode == CullingMode::CPU) {
     PNKR_PROFILE_SCOPE("CPU_Culling");
 
-    auto frustum = geometry::createFrustum(m_cullingViewProj);
-    auto cullView = m_model->scene()
-                        .registry()
-                        .view<MeshRenderer, WorldBounds, Visibility>();
+    const auto &sceneGraph = m_model->scene();
+    const auto frustum = geometry::createFrustum(m_cullingViewProj);
+    const auto cullEntities = sceneGraph.cullEntities();
 
-    std::vector<ecs::Entity> cullEntities;
-    for (ecs::Entity entity : cullView) {
-      cullEntities.push_back(entity);
+    if (m_settings.bvhCulling) {
+      // Sub-linear in scene size; output is in traversal order.
+      m_visibleEntities.clear();
+      sceneGraph.bvh().queryFrustum(frustum, m_visibleEntities);
+    } else {
+      const auto visible =
+          m_frustumCuller.cull(frustum, sceneGraph.cullBounds());
+      m_visibleEntities.resize(visible.size());
+      for (size_t i = 0; i < visible.size(); ++i) {
+        m_visibleEntities[i] = cullEntities[visible[i]];
+      }
     }
-
-    std::atomic<uint32_t> visibleCount{0};
-    core::TaskSystem::parallelFor(
-        static_cast<uint32_t>(cullEntities.size()),
-        [&](enki::TaskSetPartition range, uint32_t) {
-          for (uint32_t i = range.start; i < range.end; ++i) {
-            ecs::Entity entity = cullEntities[i];
-            const auto &wb =
-                m_model->scene().registry().get<WorldBounds>(entity);
-            auto &vis = m_model->scene().registry().get<Visibility>(entity);
-
-            bool visible = geometry::isBoxInFrustum(frustum, wb.aabb);
-            vis.visible = visible ? 1 : 0;
-            if (visible) {
-              visibleCount.fetch_add(1, std::memory_order_relaxed);
-            }
-          }
-        },
-        1024);
-
-    m_visibleMeshCount = visibleCount.load(std::memory_order_relaxed);
+    if (m_settings.occlusionCulling) {
+      cullOccluded();
+    }
+    m_visibleMeshCount = static_cast<uint32_t>(m_visibleEntities.size());
 
     if (m_settings.drawDebugBounds && debugLayer) {
-      for (ecs::Entity entity : cullEntities) {
-        const auto &wb = m_model->scene().registry().get<WorldBounds>(entity);
-        const auto &vis = m_model->scene().registry().get<Visibility>(entity);
-        glm::vec3 color = (vis.visible != 0) ? glm::vec3(0.0F, 1.0F, 0.0F)
-                                             : glm::vec3(1.0F, 0.0F, 0.0F);
+      m_debugVisibleSlots.assign(cullEntities.size(), 0);
+      for (const ecs::Entity entity : m_visibleEntities) {
+        m_debugVisibleSlots[sceneGraph.cullSlotOf(entity)] = 1;
+      }
+      for (uint32_t i = 0; i < cullEntities.size(); ++i) {
+        const auto &wb = sceneGraph.registry().get<WorldBounds>(cullEntities[i]);
+        glm::vec3 color = m_debugVisibleSlots[i] != 0
+                              ? glm::vec3(0.0F, 1.0F, 0.0F)
+                              : glm::vec3(1.0F, 0.0F, 0.0F);
         debugLayer->box(wb.aabb.m_min, wb.aabb.m_max, color);
       }
-    }
 
-    // Draw the combined scene AABB in purple for shadow debugging
-    if (m_settings.drawDebugBounds && debugLayer) {
-      scene::BoundingBox sceneAABB;
-      for (ecs::Entity entity : cullEntities) {
-        const auto &mr = m_model->scene().registry().get<MeshRenderer>(entity);
-        const auto &wb = m_model->scene().registry().get<WorldBounds>(entity);
-        if (mr.meshID >= 0 && wb.aabb.isValid()) {
-          sceneAABB.combine(wb.aabb);
-        }
-      }
+      // Draw the combined scene AABB in purple for shadow debugging
+      const auto sceneAABB = shadowCasterBounds(sceneGraph);
       if (sceneAABB.isValid()) {
         debugLayer->box(sceneAABB.m_min, sceneAABB.m_max,
                         glm::vec3(0.8f, 0.0f, 0.8f)); // Purple
@@ -897,6 +1052,10 @@ IndirectRenderer::prepareFrame(rhi::RHICommandList *cmd,
     visView.each([](ecs::Entity, Visibility &vis) { vis.visible = 1; });
   }
 
+  if (m_settings.textureStreaming) {
+    reportTextureUsage(camera, height);
+  }
+
   buildDrawLists(ctx, camera);
 
   auto uploadIndirect = [&](const DrawIndexedIndirectCommandGPU *commands,
@@ -1028,6 +1187,8 @@ void IndirectRenderer::draw(
                        drawCtx.dodContext.transmissionCount +
                        drawCtx.dodContext.transmissionDoubleSidedCount +
                        drawCtx.dodContext.transparentCount;
+  m_lodDraws = drawCtx.dodContext.lodDraws;
+  m_lodTriangles = drawCtx.dodContext.lodTriangles;
 
   if (m_transmissionPassPtr != nullptr) {
     m_resources.transmissionTexture = m_transmissionPassPtr->getTextureHandle();
@@ -1066,6 +1227,7 @@ void IndirectRenderer::draw(
       .shadowDodContext = drawCtx.shadowDodContext};
 
   passCtx.cullingViewProj = m_cullingViewProj;
+  passCtx.cullingCameraPos = m_cullingCameraPos;
 
   passCtx.resources.drawLists = &drawCtx.dodContext;
   passCtx.resources.shadowIndirectOpaqueBuffer =
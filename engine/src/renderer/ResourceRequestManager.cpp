@@ -1,4 +1,5 @@
 #include "pnkr/renderer/ResourceRequestManager.hpp"
+#include <algorithm>
 #include <mutex>
 
 namespace pnkr::renderer {
@@ -28,6 +29,34 @@ uint32_t ResourceRequestManager::getPendingFileCount() const {
     return (uint32_t)m_pendingFileRequests.size();
 }
 
+void ResourceRequestManager::reorderFileRequests(const std::function<float(const LoadRequest&)>& score) {
+    std::lock_guard<std::mutex> lock(m_fileRequestMutex);
+    if (m_pendingFileRequests.size() < 2) {
+        return;
+    }
+
+    struct Keyed {
+        float score;
+        LoadRequest req;
+    };
+    std::vector<Keyed> keyed;
+    keyed.reserve(m_pendingFileRequests.size());
+    for (auto& req : m_pendingFileRequests) {
+        keyed.push_back({score(req), std::move(req)});
+    }
+    std::ranges::stable_sort(keyed, [](const Keyed& a, const Keyed& b) {
+        if (a.req.priority != b.req.priority) {
+            return a.req.priority > b.req.priority;
+        }
+        return a.score > b.score;
+    });
+
+    m_pendingFileRequests.clear();
+    for (auto& k : keyed) {
+        m_pendingFileRequests.push_back(std::move(k.req));
+    }
+}
+
 void ResourceRequestManager::enqueueLoaded(UploadRequest&& req) {
     m_pendingCreationQueue.enqueue(std::move(req));
 }
@@ -0,0 +1,231 @@
+#include "pnkr/renderer/StagingRingAllocator.hpp"
+#include "pnkr/core/profiler.hpp"
+
+#include <thread>
+
+namespace pnkr::renderer {
+
+namespace {
+constexpr uint32_t kPendingBits = 16;
+constexpr uint64_t kPendingMask = (1ULL << kPendingBits) - 1;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return ((value + alignment - 1) / alignment) * alignment;
+}
+
+void fetchMax(std::atomic<uint64_t> &value, uint64_t candidate) {
+  uint64_t current = value.load(std::memory_order_relaxed);
+  while (current < candidate &&
+         !value.compare_exchange_weak(current, candidate,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+void backoff(uint32_t spins) {
+  if (spins < 64) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(20));
+  }
+}
+} // namespace
+
+StagingRingAllocator::StagingRingAllocator(uint64_t size, uint64_t pageSize)
+    : m_size(alignUp(size, pageSize)), m_pageSize(pageSize),
+      m_pageCount(static_cast<uint32_t>(m_size / pageSize)),
+      m_pages(std::make_unique<Page[]>(m_pageCount)) {}
+
+StagingRingAllocator::PageState
+StagingRingAllocator::pageState(uint64_t virtualPage, uint64_t claim,
+                                uint64_t batchId) const {
+  const uint64_t lap = virtualPage / m_pageCount + 1;
+  const uint64_t owner = claim >> kPendingBits;
+  if (owner == lap) {
+    // Another reservation of this lap already holds the page; share it.
+    return PageState::Free;
+  }
+  if (owner > lap) {
+    return PageState::Lapped;
+  }
+  if ((claim & kPendingMask) != 0) {
+    return PageState::Busy;
+  }
+
+  const uint64_t fence =
+      m_pages[virtualPage % m_pageCount].fence.load(std::memory_order_acquire);
+  if (fence <= m_completedBatchId.load(std::memory_order_acquire)) {
+    return PageState::Free;
+  }
+  // A fence at or past our own batch cannot retire before we submit.
+  return fence >= batchId ? PageState::OwnBatch : PageState::Busy;
+}
+
+bool StagingRingAllocator::claimPage(
+    uint64_t virtualPage, uint64_t batchId, bool wait,
+    std::chrono::steady_clock::time_point &stallStart) {
+  Page &page = m_pages[virtualPage % m_pageCount];
+  const uint64_t lap = virtualPage / m_pageCount + 1;
+  uint64_t claim = page.claim.load(std::memory_order_acquire);
+  uint32_t spins = 0;
+
+  while (true) {
+    const PageState state = pageState(virtualPage, claim, batchId);
+    if (state == PageState::Free) {
+      const uint64_t next = (claim >> kPendingBits) == lap
+                                ? claim + 1
+                                : (lap << kPendingBits) | 1;
+      if (page.claim.compare_exchange_weak(claim, next,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+        // Publish the fence before dropping the pending count, so the next
+        // lap never sees a free page without its newest batch.
+        fetchMax(page.fence, batchId);
+        page.claim.fetch_sub(1, std::memory_order_release);
+        return true;
+      }
+      continue;
+    }
+    if (state != PageState::Busy || !wait) {
+      return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (stallStart == std::chrono::steady_clock::time_point{}) {
+      stallStart = now;
+    } else if (now - stallStart > kMaxStall) {
+      return false;
+    }
+    backoff(spins++);
+    claim = page.claim.load(std::memory_order_acquire);
+  }
+}
+
+std::optional<uint64_t> StagingRingAllocator::reserve(uint64_t size,
+                                                      uint64_t batchId,
+                                                      bool wait) {
+  PNKR_PROFILE_FUNCTION();
+  if (size == 0 || size > m_size) {
+    m_failedReservations.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  uint64_t head = m_head.load(std::memory_order_relaxed);
+  uint64_t aligned = 0;
+  uint64_t start = 0;
+  while (true) {
+    aligned = alignUp(head, kAlignment);
+    start = aligned;
+    if (start % m_size + size > m_size) {
+      start = alignUp(start, m_size);
+    }
+
+    // Check the pages before taking the range so a reservation that cannot
+    // succeed doesn't burn ring space.
+    bool lapped = false;
+    for (uint64_t vp = start / m_pageSize; vp <= (start + size - 1) / m_pageSize;
+         ++vp) {
+      const uint64_t claim =
+          m_pages[vp % m_pageCount].claim.load(std::memory_order_acquire);
+      const PageState state = pageState(vp, claim, batchId);
+      if (state == PageState::OwnBatch ||
+          (state == PageState::Busy && !wait)) {
+        m_failedReservations.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+      }
+      lapped |= state == PageState::Lapped;
+    }
+
+    if (!lapped &&
+        m_head.compare_exchange_weak(head, start + size,
+                                     std::memory_order_acq_rel,
+                                     std::memory_order_relaxed)) {
+      break;
+    }
+    if (lapped) {
+      head = m_head.load(std::memory_order_relaxed);
+    }
+    m_headRetries.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  m_alignmentBytes.fetch_add(aligned - head, std::memory_order_relaxed);
+  m_wrapBytes.fetch_add(start - aligned, std::memory_order_relaxed);
+
+  std::chrono::steady_clock::time_point stallStart{};
+  bool claimed = true;
+  for (uint64_t vp = start / m_pageSize; claimed && vp <= (start + size - 1) / m_pageSize;
+       ++vp) {
+    claimed = claimPage(vp, batchId, wait, stallStart);
+  }
+
+  if (stallStart != std::chrono::steady_clock::time_point{}) {
+    m_stalls.fetch_add(1, std::memory_order_relaxed);
+    m_stallNs.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - stallStart)
+            .count(),
+        std::memory_order_relaxed);
+  }
+  if (!claimed) {
+    // Pages claimed so far keep this batch's fence and free up with it.
+    m_failedReservations.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  m_reservations.fetch_add(1, std::memory_order_relaxed);
+  m_bytesReserved.fetch_add(size, std::memory_order_relaxed);
+  return start % m_size;
+}
+
+void StagingRingAllocator::markPages(uint64_t offset, uint64_t size,
+                                     uint64_t batchId) {
+  const uint64_t endPage = (offset + size + m_pageSize - 1) / m_pageSize;
+  for (uint64_t page = offset / m_pageSize;
+       page < endPage && page < m_pageCount; ++page) {
+    fetchMax(m_pages[page].fence, batchId);
+  }
+}
+
+void StagingRingAllocator::notifyBatchComplete(uint64_t batchId) {
+  if (batchId <= m_completedBatchId.load()) {
+    return;
+  }
+  m_completedSlots[batchId % kCompletionWindow].store(batchId);
+
+  // Advance the watermark over every batch that has completed in order.
+  // Whoever completes the gap carries the watermark past later batches.
+  uint64_t completed = m_completedBatchId.load();
+  while (m_completedSlots[(completed + 1) % kCompletionWindow].load() ==
+         completed + 1) {
+    m_completedBatchId.compare_exchange_weak(completed, completed + 1);
+    completed = m_completedBatchId.load();
+  }
+}
+
+uint64_t StagingRingAllocator::usedBytes() const {
+  const uint64_t completed = completedBatchId();
+  uint64_t used = 0;
+  for (uint32_t i = 0; i < m_pageCount; ++i) {
+    if (m_pages[i].fence.load(std::memory_order_relaxed) > completed ||
+        (m_pages[i].claim.load(std::memory_order_relaxed) & kPendingMask) != 0) {
+      used += m_pageSize;
+    }
+  }
+  return used;
+}
+
+StagingRingStats StagingRingAllocator::stats() const {
+  StagingRingStats stats;
+  stats.reservations = m_reservations.load(std::memory_order_relaxed);
+  stats.failedReservations =
+      m_failedReservations.load(std::memory_order_relaxed);
+  stats.bytesReserved = m_bytesReserved.load(std::memory_order_relaxed);
+  stats.alignmentBytes = m_alignmentBytes.load(std::memory_order_relaxed);
+  stats.wrapBytes = m_wrapBytes.load(std::memory_order_relaxed);
+  stats.stalls = m_stalls.load(std::memory_order_relaxed);
+  stats.stallNs = m_stallNs.load(std::memory_order_relaxed);
+  stats.headRetries = m_headRetries.load(std::memory_order_relaxed);
+  return stats;
+}
+
+} // namespace pnkr::renderer
@@ -117,6 +117,14 @@ TextureStreamer::loadTexture(const std::string &path, bool srgb,
         }
       }
 
+      if (needsTranscode && headerOnly &&
+          KTXUtils::isZstdStreamable(result.textureData)) {
+        // Levels are inflated straight into staging by the transfer queue,
+        // so the whole inflated image never sits in memory.
+        core::Logger::Asset.debug("Streaming zstd levels for: {}", path);
+        needsTranscode = false;
+      }
+
       if (needsTranscode && headerOnly) {
         core::Logger::Asset.warn(
             "Asset '{}' is compressed/supercompressed (Scheme: {}). Streaming "
@@ -145,7 +153,12 @@ TextureStreamer::loadTexture(const std::string &path, bool srgb,
       } else {
         result.isRawImage = false;
 
-        if (result.textureData.dataSize > 0) {
+        if (KTXUtils::isZstdStreamable(result.textureData)) {
+          for (uint64_t levelSize :
+               result.textureData.mipUncompressedSizes) {
+            result.totalSize += levelSize;
+          }
+        } else if (result.textureData.dataSize > 0) {
           result.totalSize = result.textureData.dataSize;
         } else if (!result.textureData.ownedData.empty()) {
           result.totalSize = result.textureData.ownedData.size();
@@ -301,6 +314,8 @@ std::optional<CopyRegionPlan> TextureStreamer::planNextCopy(
 
   const uint8_t *memoryPtr = nullptr;
   uint64_t fileOff = 0;
+  const bool inflateLevel = !isRawImage && textureData.dataPtr == nullptr &&
+                            KTXUtils::isZstdStreamable(textureData);
 
   if (isRawImage) {
     memoryPtr = textureData.ownedData.data();
@@ -309,6 +324,9 @@ std::optional<CopyRegionPlan> TextureStreamer::planNextCopy(
     ktxTexture_GetImageOffset(textureData.texture, sourceLevel,
                               state.currentLayer, state.currentFace, &offset);
     memoryPtr = textureData.dataPtr + offset;
+  } else if (inflateLevel) {
+    fileOff = KTXUtils::getImageOffsetInLevel(
+        textureData, sourceLevel, state.currentLayer, state.currentFace);
   } else if (textureData.mappedFile && textureData.mappedFile->isValid()) {
     fileOff = KTXUtils::getImageFileOffset(
         textureData, sourceLevel, state.currentLayer, state.currentFace);
@@ -330,7 +348,13 @@ std::optional<CopyRegionPlan> TextureStreamer::planNextCopy(
   }
 
   CopyRegionPlan plan{};
-  if (memoryPtr != nullptr) {
+  if (inflateLevel) {
+    plan.m_sourcePtr = nullptr;
+    plan.m_fileOffset = 0;
+    plan.m_inflateLevel = true;
+    plan.m_sourceLevel = sourceLevel;
+    plan.m_levelOffset = fileOff + bytesAlreadyCopied;
+  } else if (memoryPtr != nullptr) {
     plan.m_sourcePtr = memoryPtr + bytesAlreadyCopied;
     plan.m_fileOffset = 0;
   } else {
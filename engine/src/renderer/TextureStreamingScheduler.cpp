@@ -0,0 +1,257 @@
+#include "pnkr/renderer/TextureStreamingScheduler.hpp"
+#include "pnkr/core/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pnkr::renderer {
+
+namespace {
+uint32_t mipForRatio(float ratio, uint32_t mipLevels) {
+  if (!(ratio > 1.0f)) {
+    return 0;
+  }
+  const auto mip = static_cast<uint32_t>(std::floor(std::log2(ratio)));
+  return std::min(mip, mipLevels - 1);
+}
+} // namespace
+
+void TextureStreamingScheduler::setSettings(
+    const TextureStreamingSettings &settings) {
+  std::scoped_lock lock(m_mutex);
+  m_settings = settings;
+}
+
+TextureStreamingSettings TextureStreamingScheduler::settings() const {
+  std::scoped_lock lock(m_mutex);
+  return m_settings;
+}
+
+void TextureStreamingScheduler::registerTexture(TextureHandle handle,
+                                                const std::string &path,
+                                                bool srgb,
+                                                assets::LoadPriority priority) {
+  std::scoped_lock lock(m_mutex);
+  Entry &entry = m_entries[handle];
+  entry.path = path;
+  entry.srgb = srgb;
+  entry.priority = priority;
+}
+
+void TextureStreamingScheduler::unregisterTexture(TextureHandle handle) {
+  std::scoped_lock lock(m_mutex);
+  m_entries.erase(handle);
+}
+
+void TextureStreamingScheduler::clear() {
+  std::scoped_lock lock(m_mutex);
+  m_entries.clear();
+}
+
+void TextureStreamingScheduler::onUploaded(TextureHandle handle, uint32_t width,
+                                           uint32_t height, uint32_t mipLevels,
+                                           uint64_t fullBytes, uint32_t baseMip,
+                                           bool streamable) {
+  std::scoped_lock lock(m_mutex);
+  auto it = m_entries.find(handle);
+  if (it == m_entries.end()) {
+    return;
+  }
+  Entry &entry = it->second;
+  entry.loaded = true;
+  entry.streamable = streamable && mipLevels > 1;
+  entry.size = std::max(width, height);
+  entry.mipLevels = std::max(1U, mipLevels);
+  entry.fullBytes = fullBytes;
+  entry.residentMip = std::min(baseMip, entry.mipLevels - 1);
+  entry.pendingMip = kNoMip;
+  if (!entry.streamable) {
+    entry.targetMip = entry.residentMip;
+  }
+}
+
+bool TextureStreamingScheduler::onFailed(TextureHandle handle) {
+  std::scoped_lock lock(m_mutex);
+  auto it = m_entries.find(handle);
+  if (it == m_entries.end()) {
+    return false;
+  }
+  Entry &entry = it->second;
+  entry.pendingMip = kNoMip;
+  if (entry.loaded) {
+    // Keep what is resident and stop retrying the failed mip.
+    entry.streamable = false;
+    entry.targetMip = entry.residentMip;
+    return true;
+  }
+  return false;
+}
+
+void TextureStreamingScheduler::reportScreenSizes(
+    std::span<const std::pair<TextureHandle, float>> sizes) {
+  std::scoped_lock lock(m_mutex);
+  for (const auto &[handle, pixels] : sizes) {
+    auto it = m_entries.find(handle);
+    if (it != m_entries.end()) {
+      it->second.screenSize = std::max(it->second.screenSize, pixels);
+    }
+  }
+}
+
+uint64_t TextureStreamingScheduler::bytesAt(const Entry &entry, uint32_t mip) {
+  // Each mip step quarters the remaining chain.
+  return mip * 2 < 64 ? entry.fullBytes >> (mip * 2) : 0;
+}
+
+float TextureStreamingScheduler::priorityLocked(const Entry &entry) const {
+  const auto age = static_cast<float>(m_frame - entry.lastVisibleFrame);
+  return entry.lastScreenSize / (1.0f + age);
+}
+
+void TextureStreamingScheduler::update(
+    std::vector<TextureStreamRequest> &requests) {
+  PNKR_PROFILE_FUNCTION();
+  std::scoped_lock lock(m_mutex);
+  ++m_frame;
+
+  // 1. Screen-size mip for every texture seen this frame. Unseen textures
+  // keep their target until the budget needs the memory.
+  uint64_t total = 0;
+  for (auto &[handle, entry] : m_entries) {
+    if (entry.screenSize > 0.0f) {
+      entry.lastVisibleFrame = m_frame;
+      entry.lastScreenSize = entry.screenSize;
+      if (entry.loaded && entry.streamable) {
+        const float ratio = static_cast<float>(entry.size) / entry.screenSize *
+                            std::exp2(m_settings.mipBias);
+        entry.targetMip = mipForRatio(ratio, entry.mipLevels);
+      }
+    }
+    entry.screenSize = 0.0f;
+    if (entry.loaded) {
+      total += bytesAt(entry, entry.targetMip);
+    }
+  }
+
+  // 2. Over budget: push the least recently visible, then the smallest on
+  // screen, down to their floor mip one texture at a time.
+  m_demoted = 0;
+  if (total > m_settings.residencyBudgetBytes) {
+    std::vector<Entry *> candidates;
+    for (auto &[handle, entry] : m_entries) {
+      if (entry.loaded && entry.streamable) {
+        candidates.push_back(&entry);
+      }
+    }
+    std::ranges::sort(candidates, [](const Entry *a, const Entry *b) {
+      if (a->lastVisibleFrame != b->lastVisibleFrame) {
+        return a->lastVisibleFrame < b->lastVisibleFrame;
+      }
+      return a->lastScreenSize < b->lastScreenSize;
+    });
+    const auto minSize = static_cast<float>(std::max(1U, m_settings.minResidentSize));
+    for (Entry *entry : candidates) {
+      if (total <= m_settings.residencyBudgetBytes) {
+        break;
+      }
+      const uint32_t floorMip =
+          mipForRatio(static_cast<float>(entry->size) / minSize, entry->mipLevels);
+      if (entry->targetMip >= floorMip) {
+        continue;
+      }
+      while (entry->targetMip < floorMip &&
+             total > m_settings.residencyBudgetBytes) {
+        total -= bytesAt(*entry, entry->targetMip) -
+                 bytesAt(*entry, entry->targetMip + 1);
+        ++entry->targetMip;
+      }
+      ++m_demoted;
+    }
+  }
+  m_targetBytes = total;
+
+  // 3. Mip changes: demotions first while resident memory is over budget,
+  // then by on-screen importance.
+  uint64_t resident = 0;
+  std::vector<std::pair<float, TextureHandle>> changes;
+  for (const auto &[handle, entry] : m_entries) {
+    if (!entry.loaded) {
+      continue;
+    }
+    resident += bytesAt(entry, entry.residentMip);
+    if (entry.streamable && entry.pendingMip == kNoMip &&
+        entry.targetMip != entry.residentMip) {
+      changes.emplace_back(priorityLocked(entry), handle);
+    }
+  }
+  const bool overBudget = resident > m_settings.residencyBudgetBytes;
+  const auto isDemotion = [this](TextureHandle h) {
+    const Entry &e = m_entries.at(h);
+    return e.targetMip > e.residentMip;
+  };
+  std::ranges::sort(changes, [&](const auto &a, const auto &b) {
+    if (overBudget) {
+      const bool da = isDemotion(a.second);
+      const bool db = isDemotion(b.second);
+      if (da != db) {
+        return da;
+      }
+    }
+    return a.first > b.first;
+  });
+
+  const size_t count =
+      std::min<size_t>(changes.size(), m_settings.maxRequestsPerUpdate);
+  for (size_t i = 0; i < count; ++i) {
+    const TextureHandle handle = changes[i].second;
+    Entry &entry = m_entries.at(handle);
+    entry.pendingMip = entry.targetMip;
+    requests.push_back({.handle = handle,
+                        .path = entry.path,
+                        .srgb = entry.srgb,
+                        .priority = entry.priority,
+                        .baseMip = entry.targetMip});
+  }
+}
+
+float TextureStreamingScheduler::priorityOf(TextureHandle handle) const {
+  std::scoped_lock lock(m_mutex);
+  auto it = m_entries.find(handle);
+  return it != m_entries.end() ? priorityLocked(it->second) : 0.0f;
+}
+
+uint32_t TextureStreamingScheduler::targetMip(TextureHandle handle) const {
+  std::scoped_lock lock(m_mutex);
+  auto it = m_entries.find(handle);
+  return it != m_entries.end() ? it->second.targetMip : kNoMip;
+}
+
+uint32_t TextureStreamingScheduler::residentMip(TextureHandle handle) const {
+  std::scoped_lock lock(m_mutex);
+  auto it = m_entries.find(handle);
+  return it != m_entries.end() && it->second.loaded ? it->second.residentMip
+                                                     : kNoMip;
+}
+
+TextureStreamingStats TextureStreamingScheduler::stats() const {
+  std::scoped_lock lock(m_mutex);
+  TextureStreamingStats stats{};
+  stats.budgetBytes = m_settings.residencyBudgetBytes;
+  stats.targetBytes = m_targetBytes;
+  stats.demotedTextures = m_demoted;
+  for (const auto &[handle, entry] : m_entries) {
+    ++stats.textures;
+    if (entry.loaded) {
+      stats.residentBytes += bytesAt(entry, entry.residentMip);
+    }
+    if (entry.streamable) {
+      ++stats.streamableTextures;
+    }
+    if (entry.pendingMip != kNoMip) {
+      ++stats.requestsInFlight;
+    }
+  }
+  return stats;
+}
+
+} // namespace pnkr::renderer
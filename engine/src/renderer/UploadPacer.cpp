@@ -0,0 +1,88 @@
+#include "pnkr/renderer/UploadPacer.hpp"
+
+#include <algorithm>
+
+namespace pnkr::renderer {
+
+namespace {
+constexpr double kThroughputSmoothing = 0.25;
+} // namespace
+
+void UploadPacer::setSettings(const UploadPacingSettings &settings) {
+  std::scoped_lock lock(m_mutex);
+  m_settings = settings;
+  m_settings.minBytesPerFrame =
+      std::min(m_settings.minBytesPerFrame, m_settings.maxBytesPerFrame);
+}
+
+UploadPacingSettings UploadPacer::settings() const {
+  std::scoped_lock lock(m_mutex);
+  return m_settings;
+}
+
+void UploadPacer::beginFrame() {
+  m_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t UploadPacer::frameBudgetLocked() const {
+  if (m_settings.mode == UploadPacingMode::Fixed) {
+    return m_settings.maxBytesPerFrame;
+  }
+  if (m_bytesPerNs <= 0.0) {
+    // Start small and let the first batches calibrate the throughput.
+    return m_settings.minBytesPerFrame;
+  }
+  const double bytes = m_bytesPerNs * m_settings.targetFrameOverheadMs * 1e6;
+  return std::clamp(static_cast<uint64_t>(bytes), m_settings.minBytesPerFrame,
+                    m_settings.maxBytesPerFrame);
+}
+
+void UploadPacer::rollFrameLocked() {
+  const uint64_t frame = m_frame.load(std::memory_order_relaxed);
+  const auto now = std::chrono::steady_clock::now();
+  if (frame != m_seenFrame || now - m_frameStart > kMaxFrameInterval) {
+    m_seenFrame = frame;
+    m_frameStart = now;
+    m_bytesThisFrame = 0;
+  }
+}
+
+uint64_t UploadPacer::batchBudget() {
+  std::scoped_lock lock(m_mutex);
+  if (m_settings.mode == UploadPacingMode::Fixed) {
+    return m_settings.maxBytesPerFrame;
+  }
+
+  rollFrameLocked();
+  const uint64_t budget = frameBudgetLocked();
+  if (m_bytesThisFrame >= budget) {
+    ++m_deferredBatches;
+    return 0;
+  }
+  return budget - m_bytesThisFrame;
+}
+
+void UploadPacer::onBatchRecorded(uint64_t bytes, uint64_t activeNs) {
+  std::scoped_lock lock(m_mutex);
+  m_bytesThisFrame += bytes;
+  if (bytes == 0 || activeNs == 0) {
+    return;
+  }
+  const double sample = double(bytes) / double(activeNs);
+  m_bytesPerNs = m_bytesPerNs <= 0.0
+                     ? sample
+                     : m_bytesPerNs + (sample - m_bytesPerNs) *
+                                          kThroughputSmoothing;
+}
+
+UploadPacingStats UploadPacer::stats() const {
+  std::scoped_lock lock(m_mutex);
+  UploadPacingStats stats;
+  stats.frameBudgetBytes = frameBudgetLocked();
+  stats.bytesThisFrame = m_bytesThisFrame;
+  stats.throughputMBps = m_bytesPerNs * 1e9 / (1024.0 * 1024.0);
+  stats.deferredBatches = m_deferredBatches;
+  return stats;
+}
+
+} // namespace pnkr::renderer
@@ -0,0 +1,166 @@
+#include "pnkr/renderer/VirtualTexture.hpp"
+
+#include <algorithm>
+
+namespace pnkr::renderer {
+
+VirtualPageTable::VirtualPageTable(uint32_t tilesX, uint32_t tilesY,
+                                   uint32_t mipLevels) {
+  m_mips.resize(std::max(1U, mipLevels));
+  for (uint32_t mip = 0; mip < m_mips.size(); ++mip) {
+    Mip &m = m_mips[mip];
+    m.tilesX = std::max(1U, tilesX >> mip);
+    m.tilesY = std::max(1U, tilesY >> mip);
+    m.slots.assign(size_t(m.tilesX) * m.tilesY, kNoSlot);
+    m.entries.assign(size_t(m.tilesX) * m.tilesY, 0);
+  }
+}
+
+bool VirtualPageTable::contains(uint32_t mip, uint32_t x, uint32_t y) const {
+  return mip < m_mips.size() && x < m_mips[mip].tilesX &&
+         y < m_mips[mip].tilesY;
+}
+
+uint32_t VirtualPageTable::slot(uint32_t mip, uint32_t x, uint32_t y) const {
+  const Mip &m = m_mips[mip];
+  return m.slots[size_t(y) * m.tilesX + x];
+}
+
+uint32_t VirtualPageTable::entry(uint32_t mip, uint32_t x, uint32_t y) const {
+  const Mip &m = m_mips[mip];
+  return m.entries[size_t(y) * m.tilesX + x];
+}
+
+void VirtualPageTable::map(uint32_t mip, uint32_t x, uint32_t y,
+                           uint32_t slot) {
+  Mip &m = m_mips[mip];
+  m.slots[size_t(y) * m.tilesX + x] = slot;
+  const uint32_t fallback =
+      mip + 1 < m_mips.size() ? entry(mip + 1, x >> 1, y >> 1) : 0;
+  propagate(mip, x, y, fallback);
+  m_dirty = true;
+}
+
+void VirtualPageTable::unmap(uint32_t mip, uint32_t x, uint32_t y) {
+  map(mip, x, y, kNoSlot);
+}
+
+void VirtualPageTable::propagate(uint32_t mip, uint32_t x, uint32_t y,
+                                 uint32_t fallback) {
+  Mip &m = m_mips[mip];
+  const size_t index = size_t(y) * m.tilesX + x;
+  const uint32_t value =
+      m.slots[index] != kNoSlot ? makeEntry(m.slots[index], mip) : fallback;
+  m.entries[index] = value;
+  if (mip == 0) {
+    return;
+  }
+
+  const Mip &child = m_mips[mip - 1];
+  for (uint32_t cy = y * 2; cy < std::min(y * 2 + 2, child.tilesY); ++cy) {
+    for (uint32_t cx = x * 2; cx < std::min(x * 2 + 2, child.tilesX); ++cx) {
+      const size_t childIndex = size_t(cy) * child.tilesX + cx;
+      // A resident child keeps its own subtree; an unchanged one already
+      // falls back to value.
+      if (child.slots[childIndex] == kNoSlot &&
+          child.entries[childIndex] != value) {
+        propagate(mip - 1, cx, cy, value);
+      }
+    }
+  }
+}
+
+VirtualTileCache::VirtualTileCache(uint32_t slotCount, uint32_t framesInFlight)
+    : m_slots(slotCount), m_framesInFlight(std::max(framesInFlight, 1U)) {
+  m_free.reserve(slotCount);
+  for (uint32_t i = slotCount; i > 0; --i) {
+    m_free.push_back(i - 1);
+  }
+}
+
+void VirtualTileCache::unlink(uint32_t slot) {
+  Slot &s = m_slots[slot];
+  if (s.prev != kNoTile) {
+    m_slots[s.prev].next = s.next;
+  } else {
+    m_head = s.next;
+  }
+  if (s.next != kNoTile) {
+    m_slots[s.next].prev = s.prev;
+  } else {
+    m_tail = s.prev;
+  }
+  s.prev = kNoTile;
+  s.next = kNoTile;
+}
+
+void VirtualTileCache::pushMostRecent(uint32_t slot) {
+  Slot &s = m_slots[slot];
+  s.prev = m_tail;
+  s.next = kNoTile;
+  if (m_tail != kNoTile) {
+    m_slots[m_tail].next = slot;
+  } else {
+    m_head = slot;
+  }
+  m_tail = slot;
+}
+
+std::optional<uint32_t> VirtualTileCache::allocate(uint32_t tile,
+                                                   uint64_t frame,
+                                                   uint32_t &evictedTile) {
+  evictedTile = kNoTile;
+  uint32_t slot = kNoTile;
+  if (!m_free.empty()) {
+    slot = m_free.back();
+    m_free.pop_back();
+    ++m_used;
+  } else {
+    // The list is ordered by last use, so the first slot touched by a frame
+    // still in flight ends the search.
+    for (uint32_t s = m_head;
+         s != kNoTile && m_slots[s].lastUsed + m_framesInFlight <= frame;
+         s = m_slots[s].next) {
+      if (!m_slots[s].pinned) {
+        slot = s;
+        break;
+      }
+    }
+    if (slot == kNoTile) {
+      return std::nullopt;
+    }
+    evictedTile = m_slots[slot].tile;
+    unlink(slot);
+    ++m_evictions;
+  }
+
+  m_slots[slot].tile = tile;
+  m_slots[slot].lastUsed = frame;
+  m_slots[slot].pinned = false;
+  pushMostRecent(slot);
+  return slot;
+}
+
+void VirtualTileCache::touch(uint32_t slot, uint64_t frame) {
+  m_slots[slot].lastUsed = frame;
+  if (m_tail != slot) {
+    unlink(slot);
+    pushMostRecent(slot);
+  }
+}
+
+void VirtualTileCache::setPinned(uint32_t slot, bool pinned) {
+  m_slots[slot].pinned = pinned;
+}
+
+void VirtualTileCache::release(uint32_t slot) {
+  if (m_slots[slot].tile == kNoTile) {
+    return;
+  }
+  unlink(slot);
+  m_slots[slot] = Slot{};
+  m_free.push_back(slot);
+  --m_used;
+}
+
+} // namespace pnkr::renderer
@@ -0,0 +1,488 @@
+#include "pnkr/renderer/VirtualTextureSystem.hpp"
+
+#include "pnkr/core/logger.hpp"
+#include "pnkr/core/profiler.hpp"
+#include "pnkr/renderer/AsyncLoader.hpp"
+#include "pnkr/renderer/TextureStreamer.hpp"
+#include "pnkr/renderer/ktx_utils.hpp"
+#include "pnkr/renderer/rhi_renderer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+
+namespace pnkr::renderer {
+
+namespace {
+// Keys of page table uploads; tile uploads use the packed tile id.
+constexpr uint64_t kPageTableKey = 1ULL << 32;
+} // namespace
+
+VirtualTextureSystem::VirtualTextureSystem(
+    RHIRenderer &renderer, AsyncLoader &loader,
+    const VirtualTextureSettings &settings)
+    : m_renderer(renderer), m_loader(loader), m_settings(settings),
+      m_cache(std::min(settings.atlasTilesPerSide * settings.atlasTilesPerSide,
+                       0x10000U),
+              RendererConfig::kFramesInFlight) {
+  const uint64_t feedbackSize =
+      (uint64_t(VT_FEEDBACK_HEADER_UINTS) + m_settings.feedbackCapacity) *
+      sizeof(uint32_t);
+  for (uint32_t i = 0; i < m_feedback.size(); ++i) {
+    m_feedback[i] = m_renderer.createBuffer(
+        "VirtualTextureFeedback",
+        {.size = feedbackSize,
+         .usage = rhi::BufferUsage::StorageBuffer,
+         .memoryUsage = rhi::MemoryUsage::GPUToCPU,
+         .debugName = "VirtualTextureFeedback"});
+    auto *buffer = m_renderer.getBuffer(m_feedback[i].handle());
+    if (buffer != nullptr) {
+      m_feedbackData[i] = reinterpret_cast<uint32_t *>(buffer->map());
+      if (m_feedbackData[i] != nullptr) {
+        m_feedbackData[i][0] = 0;
+        buffer->flush(0, sizeof(uint32_t));
+      }
+    }
+  }
+}
+
+VirtualTextureSystem::~VirtualTextureSystem() {
+  for (uint32_t i = 0; i < m_feedback.size(); ++i) {
+    auto *buffer = m_renderer.getBuffer(m_feedback[i].handle());
+    if (buffer != nullptr && m_feedbackData[i] != nullptr) {
+      buffer->unmap();
+    }
+  }
+}
+
+VirtualTextureId
+VirtualTextureSystem::registerTexture(const std::filesystem::path &path) {
+  PNKR_PROFILE_FUNCTION();
+  if (m_textures.size() >= VirtualTileId::kMaxTextures) {
+    core::Logger::Render.error(
+        "VirtualTextureSystem: At most {} virtual textures are supported",
+        VirtualTileId::kMaxTextures);
+    return kInvalidId;
+  }
+
+  KTXTextureData data;
+  std::string error;
+  if (!KTXUtils::loadFromFile(path, data, &error, true)) {
+    core::Logger::Render.error("VirtualTextureSystem: Failed to open '{}': {}",
+                               path.string(), error);
+    return kInvalidId;
+  }
+
+  const uint32_t tileSize = m_settings.tileSize;
+  const auto block = TextureStreamer::getFormatBlockInfo(data.format);
+  const uint32_t width = data.extent.width;
+  const uint32_t height = data.extent.height;
+  const char *reason = nullptr;
+  if (data.type != rhi::TextureType::Texture2D || data.numLayers != 1 ||
+      data.numFaces != 1) {
+    reason = "only single-layer 2D textures can be virtual";
+  } else if (data.supercompressionScheme != 0 ||
+             data.mipFileOffsets.size() != data.mipLevels) {
+    reason = "tiles are read straight from disk, so levels can't be "
+             "supercompressed";
+  } else if (!std::has_single_bit(width) || !std::has_single_bit(height) ||
+             width < tileSize || height < tileSize) {
+    reason = "dimensions must be powers of two of at least the tile size";
+  } else if (tileSize % block.m_width != 0 || tileSize % block.m_height != 0 ||
+             m_settings.tileBorder % block.m_width != 0 ||
+             m_settings.tileBorder % block.m_height != 0) {
+    reason = "tile size and border must be whole blocks of the format";
+  } else if (width / tileSize > VirtualTileId::kMaxTilesPerAxis ||
+             height / tileSize > VirtualTileId::kMaxTilesPerAxis) {
+    reason = "too many tiles";
+  } else if (m_atlas.isValid() && data.format != m_atlasFormat) {
+    reason = "all virtual textures share the atlas format";
+  }
+
+  // Every virtual mip is at least one tile; coarser levels aren't used.
+  const uint32_t tilesX = width / tileSize;
+  const uint32_t tilesY = height / tileSize;
+  const uint32_t mipLevels =
+      std::min({uint32_t(std::bit_width(std::min(tilesX, tilesY))),
+                data.mipLevels, VirtualTileId::kMaxMips});
+  if (reason == nullptr && std::max(tilesX, tilesY) >> (mipLevels - 1) > 4) {
+    reason = "the mip chain must end within a few tiles";
+  }
+  if (reason != nullptr) {
+    core::Logger::Render.error("VirtualTextureSystem: Can't use '{}': {}",
+                               path.string(), reason);
+    return kInvalidId;
+  }
+
+  if (!m_atlas.isValid()) {
+    const uint32_t atlasSize = m_settings.atlasTilesPerSide * slotSize();
+    rhi::TextureDescriptor desc{};
+    desc.extent = {.width = atlasSize, .height = atlasSize, .depth = 1};
+    desc.format = data.format;
+    desc.usage = rhi::TextureUsage::Sampled | rhi::TextureUsage::TransferDst;
+    desc.mipLevels = 1;
+    desc.arrayLayers = 1;
+    desc.debugName = "VirtualTextureAtlas";
+    m_atlas = m_renderer.createTexture("VirtualTextureAtlas", desc);
+    if (!m_atlas.isValid()) {
+      return kInvalidId;
+    }
+    m_atlasFormat = data.format;
+  }
+
+  rhi::TextureDescriptor desc{};
+  desc.extent = {.width = tilesX, .height = tilesY, .depth = 1};
+  desc.format = rhi::Format::R8G8B8A8_UNORM;
+  desc.usage = rhi::TextureUsage::Sampled | rhi::TextureUsage::TransferDst;
+  desc.mipLevels = mipLevels;
+  desc.arrayLayers = 1;
+  desc.debugName = "VirtualTexturePageTable";
+  TexturePtr pageTableTexture =
+      m_renderer.createTexture("VirtualTexturePageTable", desc);
+  if (!pageTableTexture.isValid()) {
+    return kInvalidId;
+  }
+
+  const auto id = static_cast<VirtualTextureId>(m_textures.size());
+  m_textures.push_back({.path = path.string(),
+                        .format = data.format,
+                        .width = width,
+                        .height = height,
+                        .mipFileOffsets = std::move(data.mipFileOffsets),
+                        .pageTable = VirtualPageTable(tilesX, tilesY, mipLevels),
+                        .pageTableTexture = std::move(pageTableTexture)});
+
+  // The coarsest mip stays resident as the fallback of every lookup.
+  const VirtualPageTable &pageTable = m_textures.back().pageTable;
+  const uint32_t top = mipLevels - 1;
+  std::vector<uint32_t> roots;
+  for (uint32_t y = 0; y < pageTable.tilesY(top); ++y) {
+    for (uint32_t x = 0; x < pageTable.tilesX(top); ++x) {
+      roots.push_back(VirtualTileId{.texture = id, .mip = top, .x = x, .y = y}
+                          .pack());
+    }
+  }
+  m_roots.insert(m_roots.end(), roots.begin(), roots.end());
+  uploadTiles(roots, roots.size());
+
+  core::Logger::Render.info(
+      "VirtualTextureSystem: Registered '{}' ({}x{}, {} tiles, {} mips)",
+      path.string(), width, height, tilesX * tilesY, mipLevels);
+  return id;
+}
+
+uint32_t VirtualTextureSystem::feedbackSlot() const {
+  return m_renderer.getFrameIndex() % RendererConfig::kFramesInFlight;
+}
+
+void VirtualTextureSystem::update() {
+  PNKR_PROFILE_FUNCTION();
+  ++m_frame;
+  processCompletedUploads();
+
+  std::vector<uint32_t> missing;
+  processFeedback(missing);
+  // Roots are the fallback of every lookup, so retries go ahead of feedback.
+  missing.insert(missing.begin(), m_rootRetries.begin(), m_rootRetries.end());
+  m_rootRetries.clear();
+  uploadTiles(missing, m_settings.maxUploadsPerFrame);
+}
+
+bool VirtualTextureSystem::isRoot(uint32_t packed) const {
+  return std::ranges::find(m_roots, packed) != m_roots.end();
+}
+
+void VirtualTextureSystem::processCompletedUploads() {
+  for (const auto &result : m_loader.consumeCompletedRegionUploads()) {
+    if ((result.key & kPageTableKey) != 0) {
+      Texture &texture =
+          m_textures[static_cast<uint32_t>(result.key & ~kPageTableKey)];
+      texture.pageTableInitPending = false;
+      if (result.success) {
+        texture.pageTableInitialized = true;
+      } else {
+        // The CPU copy is still current; send all of it again.
+        texture.pageTable.markDirty();
+      }
+      continue;
+    }
+    const auto packed = static_cast<uint32_t>(result.key);
+    auto it = m_pending.find(packed);
+    if (it == m_pending.end()) {
+      continue;
+    }
+    const uint32_t slot = it->second;
+    m_pending.erase(it);
+
+    if (!m_atlasInitialized) {
+      m_atlasInitPending = false;
+      m_atlasInitialized = result.success;
+    }
+
+    const VirtualTileId tile = VirtualTileId::unpack(packed);
+    if (!result.success) {
+      core::Logger::Render.warn(
+          "VirtualTextureSystem: Tile {}/{},{} of '{}' failed to load",
+          tile.mip, tile.x, tile.y, m_textures[tile.texture].path);
+      m_cache.release(slot);
+      if (isRoot(packed)) {
+        m_rootRetries.push_back(packed);
+      }
+      continue;
+    }
+
+    m_textures[tile.texture].pageTable.map(tile.mip, tile.x, tile.y, slot);
+    m_cache.setPinned(slot, isRoot(packed));
+    ++m_uploadedTiles;
+  }
+}
+
+void VirtualTextureSystem::processFeedback(std::vector<uint32_t> &missing) {
+  const uint32_t frameSlot = feedbackSlot();
+  uint32_t *feedback = m_feedbackData[frameSlot];
+  if (feedback == nullptr) {
+    return;
+  }
+  auto *buffer = m_renderer.getBuffer(m_feedback[frameSlot].handle());
+  buffer->invalidate(0, buffer->size());
+
+  const uint32_t count = std::min(feedback[0], m_settings.feedbackCapacity);
+  std::vector<uint32_t> requests(feedback + VT_FEEDBACK_HEADER_UINTS,
+                                 feedback + VT_FEEDBACK_HEADER_UINTS + count);
+  // Reset for the frame about to reuse this buffer.
+  feedback[0] = 0;
+  buffer->flush(0, sizeof(uint32_t));
+
+  std::ranges::sort(requests);
+  const auto [first, last] = std::ranges::unique(requests);
+  requests.erase(first, last);
+  m_requestedTiles += requests.size();
+
+  for (uint32_t packed : requests) {
+    requestTile(packed, missing);
+  }
+
+  // Coarse tiles first so every finer tile has a fallback when it lands.
+  std::ranges::sort(missing, [](uint32_t a, uint32_t b) {
+    const VirtualTileId ta = VirtualTileId::unpack(a);
+    const VirtualTileId tb = VirtualTileId::unpack(b);
+    return ta.mip != tb.mip ? ta.mip > tb.mip : a < b;
+  });
+  const auto [dupFirst, dupLast] = std::ranges::unique(missing);
+  missing.erase(dupFirst, dupLast);
+}
+
+void VirtualTextureSystem::requestTile(uint32_t packed,
+                                       std::vector<uint32_t> &missing) {
+  VirtualTileId tile = VirtualTileId::unpack(packed);
+  if (tile.texture >= m_textures.size()) {
+    return;
+  }
+  const VirtualPageTable &pageTable = m_textures[tile.texture].pageTable;
+  if (!pageTable.contains(tile.mip, tile.x, tile.y)) {
+    return;
+  }
+
+  // Keep the tile and its resident ancestors hot; request whatever is
+  // missing on the way up.
+  for (; tile.mip < pageTable.mipLevels();
+       ++tile.mip, tile.x >>= 1, tile.y >>= 1) {
+    const uint32_t slot = pageTable.slot(tile.mip, tile.x, tile.y);
+    if (slot != VirtualPageTable::kNoSlot) {
+      m_cache.touch(slot, m_frame);
+    } else if (!m_pending.contains(tile.pack())) {
+      missing.push_back(tile.pack());
+    }
+  }
+}
+
+TextureRegionUpload
+VirtualTextureSystem::makeTileUpload(const Texture &texture,
+                                     const VirtualTileId &tile,
+                                     uint32_t slot) const {
+  const auto block = TextureStreamer::getFormatBlockInfo(texture.format);
+  const uint32_t tileSize = m_settings.tileSize;
+  const uint32_t border = m_settings.tileBorder;
+  const uint32_t levelWidth = texture.width >> tile.mip;
+  const uint32_t levelHeight = texture.height >> tile.mip;
+
+  // The tile plus its border, clamped to the level. Everything here is a
+  // whole number of blocks.
+  const uint32_t x0 = tile.x * tileSize;
+  const uint32_t y0 = tile.y * tileSize;
+  const uint32_t srcX0 = x0 > border ? x0 - border : 0;
+  const uint32_t srcY0 = y0 > border ? y0 - border : 0;
+  const uint32_t srcX1 = std::min(levelWidth, x0 + tileSize + border);
+  const uint32_t srcY1 = std::min(levelHeight, y0 + tileSize + border);
+
+  const uint64_t rowPitch = uint64_t(levelWidth / block.m_width) * block.m_bytes;
+
+  TextureRegionUpload upload;
+  upload.target = m_renderer.getTexture(m_atlas.handle());
+  upload.layout = m_atlasInitialized ? rhi::ResourceLayout::ShaderReadOnly
+                                     : rhi::ResourceLayout::Undefined;
+  upload.path = texture.path;
+  upload.fileOffset = texture.mipFileOffsets[tile.mip] +
+                      (srcY0 / block.m_height) * rowPitch +
+                      uint64_t(srcX0 / block.m_width) * block.m_bytes;
+  upload.rowBytes = uint64_t((srcX1 - srcX0) / block.m_width) * block.m_bytes;
+  upload.rowPitch = rowPitch;
+  upload.rowCount = (srcY1 - srcY0) / block.m_height;
+  upload.key = tile.pack();
+
+  const uint32_t slotX = (slot % m_settings.atlasTilesPerSide) * slotSize();
+  const uint32_t slotY = (slot / m_settings.atlasTilesPerSide) * slotSize();
+  upload.region.textureOffset = {
+      .x = static_cast<int32_t>(slotX + border - (x0 - srcX0)),
+      .y = static_cast<int32_t>(slotY + border - (y0 - srcY0)),
+      .z = 0};
+  upload.region.textureExtent = {
+      .width = srcX1 - srcX0, .height = srcY1 - srcY0, .depth = 1};
+  return upload;
+}
+
+void VirtualTextureSystem::uploadTiles(const std::vector<uint32_t> &missing,
+                                       size_t maxTiles) {
+  // Tiles from first onwards wait for a later update; roots among them are
+  // kept for a retry, the rest come back through feedback.
+  const auto defer = [&](size_t first) {
+    m_deferredTiles += missing.size() - first;
+    for (size_t i = first; i < missing.size(); ++i) {
+      if (isRoot(missing[i])) {
+        m_rootRetries.push_back(missing[i]);
+      }
+    }
+  };
+
+  std::vector<TextureRegionUpload> tiles;
+  for (size_t i = 0; i < missing.size(); ++i) {
+    const uint32_t packed = missing[i];
+    if (m_pending.contains(packed)) {
+      continue;
+    }
+    // Until a copy has completed, the atlas layout is undefined and a
+    // second transition from it could discard the first tile.
+    const bool atlasBusy =
+        !m_atlasInitialized && (m_atlasInitPending || !tiles.empty());
+    if (tiles.size() >= maxTiles || atlasBusy) {
+      defer(i);
+      break;
+    }
+
+    uint32_t evicted = VirtualTileCache::kNoTile;
+    const auto slot = m_cache.allocate(packed, m_frame, evicted);
+    if (!slot) {
+      defer(i);
+      break;
+    }
+    if (evicted != VirtualTileCache::kNoTile) {
+      const VirtualTileId victim = VirtualTileId::unpack(evicted);
+      m_textures[victim.texture].pageTable.unmap(victim.mip, victim.x,
+                                                 victim.y);
+    }
+    // Pinned until the upload completes, so the slot can't be handed out
+    // twice.
+    m_cache.setPinned(*slot, true);
+    m_pending[packed] = *slot;
+
+    const VirtualTileId tile = VirtualTileId::unpack(packed);
+    tiles.push_back(makeTileUpload(m_textures[tile.texture], tile, *slot));
+    m_atlasInitPending = !m_atlasInitialized;
+  }
+
+  // Page tables go first: an evicted tile must stop being referenced before
+  // its slot is overwritten.
+  std::vector<TextureRegionUpload> uploads;
+  for (uint32_t id = 0; id < m_textures.size(); ++id) {
+    Texture &texture = m_textures[id];
+    if (!texture.pageTable.dirty() ||
+        (!texture.pageTableInitialized && texture.pageTableInitPending)) {
+      continue;
+    }
+    rhi::RHITexture *target =
+        m_renderer.getTexture(texture.pageTableTexture.handle());
+    for (uint32_t mip = 0; mip < texture.pageTable.mipLevels(); ++mip) {
+      const auto entries = texture.pageTable.entries(mip);
+      TextureRegionUpload upload;
+      upload.target = target;
+      upload.layout = texture.pageTableInitialized
+                          ? rhi::ResourceLayout::ShaderReadOnly
+                          : rhi::ResourceLayout::Undefined;
+      upload.region.textureSubresource.mipLevel = mip;
+      upload.region.textureExtent = {.width = texture.pageTable.tilesX(mip),
+                                     .height = texture.pageTable.tilesY(mip),
+                                     .depth = 1};
+      upload.data.resize(entries.size_bytes());
+      std::memcpy(upload.data.data(), entries.data(), entries.size_bytes());
+      upload.key = kPageTableKey | id;
+      uploads.push_back(std::move(upload));
+    }
+    texture.pageTableInitPending = !texture.pageTableInitialized;
+    texture.pageTable.clearDirty();
+  }
+
+  if (uploads.empty() && tiles.empty()) {
+    return;
+  }
+  std::ranges::move(tiles, std::back_inserter(uploads));
+  m_loader.uploadTextureRegions(std::move(uploads));
+}
+
+gpu::VirtualTextureGPU
+VirtualTextureSystem::gpuData(VirtualTextureId id) const {
+  gpu::VirtualTextureGPU data{};
+  data.pageTableTexture = BINDLESS_INVALID_TEXTURE;
+  data.atlasTexture = BINDLESS_INVALID_TEXTURE;
+  if (id >= m_textures.size()) {
+    return data;
+  }
+
+  const Texture &texture = m_textures[id];
+  const uint32_t atlasSize = m_settings.atlasTilesPerSide * slotSize();
+  data.pageTableTexture =
+      m_renderer.getTextureBindlessIndex(texture.pageTableTexture.handle())
+          .index();
+  data.atlasTexture =
+      m_renderer.getTextureBindlessIndex(m_atlas.handle()).index();
+  data.samplerId = m_renderer
+                       .getBindlessSamplerIndex(rhi::Filter::Linear,
+                                                rhi::SamplerAddressMode::ClampToEdge)
+                       .index();
+  data.feedbackBuffer =
+      m_renderer.getBufferBindlessIndex(feedbackBuffer()).index();
+  data.virtualId = id;
+  data.mipLevels = texture.pageTable.mipLevels();
+  data.tileSize = m_settings.tileSize;
+  data.tileBorder = m_settings.tileBorder;
+  data.virtualSize = {float(texture.width), float(texture.height)};
+  data.atlasTexelSize = 1.0F / float(atlasSize);
+  data.atlasTilesPerSide = m_settings.atlasTilesPerSide;
+  data.feedbackCapacity = m_settings.feedbackCapacity;
+  data.frameIndex = static_cast<uint32_t>(m_frame);
+  return data;
+}
+
+TextureHandle VirtualTextureSystem::pageTable(VirtualTextureId id) const {
+  return id < m_textures.size() ? m_textures[id].pageTableTexture.handle()
+                                : TextureHandle{};
+}
+
+BufferHandle VirtualTextureSystem::feedbackBuffer() const {
+  return m_feedback[feedbackSlot()].handle();
+}
+
+VirtualTextureStats VirtualTextureSystem::stats() const {
+  VirtualTextureStats stats;
+  stats.textures = static_cast<uint32_t>(m_textures.size());
+  stats.pendingTiles = static_cast<uint32_t>(m_pending.size());
+  stats.residentTiles = m_cache.usedSlots() - stats.pendingTiles;
+  stats.atlasSlots = m_cache.capacity();
+  stats.requestedTiles = m_requestedTiles;
+  stats.uploadedTiles = m_uploadedTiles;
+  stats.evictions = m_cache.evictions();
+  stats.deferredTiles = m_deferredTiles;
+  return stats;
+}
+
+} // namespace pnkr::renderer
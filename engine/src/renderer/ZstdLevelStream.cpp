@@ -0,0 +1,124 @@
+#include "pnkr/renderer/ZstdLevelStream.hpp"
+#include "pnkr/core/logger.hpp"
+#include "pnkr/core/profiler.hpp"
+
+#include <algorithm>
+#include <zstd.h>
+
+namespace pnkr::renderer {
+
+namespace {
+constexpr size_t kScratchSize = 64 * 1024;
+} // namespace
+
+ZstdLevelStream::ZstdLevelStream(core::FileReader &reader)
+    : m_reader(&reader), m_ctx(ZSTD_createDCtx()) {
+  m_input.resize(kInputChunkSize);
+  if (m_ctx == nullptr) {
+    core::Logger::Asset.error("ZstdLevelStream: Failed to create zstd context");
+  }
+}
+
+ZstdLevelStream::~ZstdLevelStream() { ZSTD_freeDCtx(m_ctx); }
+
+void ZstdLevelStream::restart(const Level &level) {
+  if (m_valid) {
+    ++m_levelRestarts;
+  }
+  ZSTD_DCtx_reset(m_ctx, ZSTD_reset_session_only);
+  m_path.assign(level.path);
+  m_level = level.index;
+  m_fileOffset = level.fileOffset;
+  m_compressedSize = level.compressedSize;
+  m_inputConsumed = 0;
+  m_position = 0;
+  m_inputPos = 0;
+  m_inputSize = 0;
+  m_valid = true;
+}
+
+bool ZstdLevelStream::read(const Level &level, uint64_t levelOffset,
+                           std::span<uint8_t> dst) {
+  PNKR_PROFILE_FUNCTION();
+  if (m_ctx == nullptr) {
+    return false;
+  }
+
+  if (!m_valid || level.path != m_path || level.index != m_level ||
+      level.fileOffset != m_fileOffset || levelOffset < m_position) {
+    restart(level);
+  }
+
+  // Bytes of this level that were never requested (a job that restarted
+  // mid-level) are inflated into scratch and dropped.
+  while (m_position < levelOffset) {
+    if (m_scratch.empty()) {
+      m_scratch.resize(kScratchSize);
+    }
+    const uint64_t skip =
+        std::min<uint64_t>(levelOffset - m_position, m_scratch.size());
+    if (!inflate(m_scratch.data(), skip)) {
+      return false;
+    }
+  }
+  return inflate(dst.data(), dst.size());
+}
+
+bool ZstdLevelStream::fillInput() {
+  const uint64_t size =
+      std::min<uint64_t>(kInputChunkSize, m_compressedSize - m_inputConsumed);
+  core::FileReadRequest request{.path = m_path,
+                                .offset = m_fileOffset + m_inputConsumed,
+                                .size = size,
+                                .dst = m_input.data()};
+  if (!m_reader->read({&request, 1})) {
+    core::Logger::Asset.error(
+        "ZstdLevelStream: Read failed for '{}' level {} at offset {} ({})",
+        m_path, m_level, request.offset, request.result);
+    return false;
+  }
+  m_inputConsumed += size;
+  m_inputPos = 0;
+  m_inputSize = static_cast<size_t>(size);
+  return true;
+}
+
+bool ZstdLevelStream::inflate(uint8_t *dst, uint64_t size) {
+  ZSTD_outBuffer out{dst, static_cast<size_t>(size), 0};
+  while (out.pos < out.size) {
+    if (m_inputPos == m_inputSize && m_inputConsumed < m_compressedSize &&
+        !fillInput()) {
+      m_valid = false;
+      return false;
+    }
+
+    ZSTD_inBuffer in{m_input.data(), m_inputSize, m_inputPos};
+    const size_t outBefore = out.pos;
+    const size_t ret = ZSTD_decompressStream(m_ctx, &out, &in);
+    const bool consumed = in.pos != m_inputPos;
+    m_inputPos = in.pos;
+
+    if (ZSTD_isError(ret) != 0U) {
+      core::Logger::Asset.error("ZstdLevelStream: '{}' level {}: {}", m_path,
+                                m_level, ZSTD_getErrorName(ret));
+      m_valid = false;
+      return false;
+    }
+    const bool inputDone =
+        m_inputPos == m_inputSize && m_inputConsumed == m_compressedSize;
+    const bool stalled = !consumed && out.pos == outBefore;
+    if (out.pos < out.size && inputDone && (ret == 0 || stalled)) {
+      core::Logger::Asset.error(
+          "ZstdLevelStream: '{}' level {} ends at {} bytes, {} requested",
+          m_path, m_level, m_position + out.pos, m_position + out.size);
+      m_valid = false;
+      return false;
+    }
+  }
+
+  m_position += size;
+  m_bytesInflated += size;
+  return true;
+}
+
+} // namespace pnkr::renderer
@@ -0,0 +1,77 @@
+#include "pnkr/renderer/geometry/ClusterCull.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pnkr::renderer::geometry {
+
+    float maxScale(const glm::mat4& m) {
+        const float sx = glm::dot(glm::vec3(m[0]), glm::vec3(m[0]));
+        const float sy = glm::dot(glm::vec3(m[1]), glm::vec3(m[1]));
+        const float sz = glm::dot(glm::vec3(m[2]), glm::vec3(m[2]));
+        return std::sqrt(std::max({sx, sy, sz}));
+    }
+
+    bool preservesNormalCones(const glm::mat4& m, float tolerance) {
+        const glm::vec3 x(m[0]);
+        const glm::vec3 y(m[1]);
+        const glm::vec3 z(m[2]);
+        const float lx = glm::length(x);
+        const float ly = glm::length(y);
+        const float lz = glm::length(z);
+        if (lx <= 0.0f || ly <= 0.0f || lz <= 0.0f) {
+            return false;
+        }
+        const float scale = std::max({lx, ly, lz});
+        const bool uniform = (scale - std::min({lx, ly, lz})) <= tolerance * scale;
+        const bool orthogonal = std::abs(glm::dot(x, y)) <= tolerance * lx * ly &&
+                                std::abs(glm::dot(y, z)) <= tolerance * ly * lz &&
+                                std::abs(glm::dot(z, x)) <= tolerance * lz * lx;
+        return uniform && orthogonal && glm::dot(glm::cross(x, y), z) > 0.0f;
+    }
+
+    ClusterBounds transformCluster(const gpu::MeshletGPU& meshlet, const glm::mat4& world) {
+        ClusterBounds out;
+        out.center = glm::vec3(world * glm::vec4(glm::vec3(meshlet.sphere), 1.0f));
+        out.radius = meshlet.sphere.w * maxScale(world);
+        out.coneApex = glm::vec3(world * glm::vec4(glm::vec3(meshlet.coneApex), 1.0f));
+        const glm::vec3 axis = glm::mat3(world) * glm::vec3(meshlet.coneAxis);
+        const float length = glm::length(axis);
+        out.coneAxis = length > 0.0f ? axis / length : axis;
+        out.coneCutoff = meshlet.coneAxis.w;
+        return out;
+    }
+
+    bool isSphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius) {
+        for (const glm::vec4& plane : frustum.planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isClusterBackfacing(const ClusterBounds& cluster, const glm::vec3& cameraPos) {
+        const glm::vec3 view = cluster.coneApex - cameraPos;
+        const float distance = glm::length(view);
+        if (distance <= 0.0f) {
+            return false;
+        }
+        return glm::dot(view / distance, cluster.coneAxis) >= cluster.coneCutoff;
+    }
+
+    void cullClusters(const Frustum& frustum, const glm::vec3& cameraPos,
+                      std::span<const gpu::MeshletGPU> meshlets, const glm::mat4& world,
+                      bool coneCulling, std::vector<uint32_t>& visible) {
+        for (uint32_t i = 0; i < meshlets.size(); ++i) {
+            const ClusterBounds cluster = transformCluster(meshlets[i], world);
+            if (!isSphereInFrustum(frustum, cluster.center, cluster.radius)) {
+                continue;
+            }
+            if (coneCulling && isClusterBackfacing(cluster, cameraPos)) {
+                continue;
+            }
+            visible.push_back(i);
+        }
+    }
+}
@@ -0,0 +1,314 @@
+#include "pnkr/renderer/geometry/FrustumCull.hpp"
+
+#include "pnkr/core/TaskSystem.hpp"
+#include "pnkr/core/profiler.hpp"
+#include "pnkr/renderer/geometry/SimdMath.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace pnkr::renderer::geometry {
+
+    namespace {
+        // Large enough that |n|.e swamps any plane distance, small enough that
+        // the dot product stays finite under fast-math.
+        constexpr float kEmptyExtent = -std::numeric_limits<float>::max() * 0.25F;
+
+        // Boxes per task; a multiple of kCullBatch so every chunk starts aligned.
+        constexpr uint32_t kChunkBoxes = 4096;
+
+        uint32_t paddedCount(uint32_t count) {
+            return (count + kCullBatch - 1) & ~(kCullBatch - 1);
+        }
+
+        struct PlaneSet {
+            float nx[6], ny[6], nz[6], d[6];
+            float ax[6], ay[6], az[6];
+        };
+
+        PlaneSet splitPlanes(const Frustum& frustum) {
+            PlaneSet p{};
+            for (int i = 0; i < 6; ++i) {
+                const glm::vec4& plane = frustum.planes[i];
+                p.nx[i] = plane.x;
+                p.ny[i] = plane.y;
+                p.nz[i] = plane.z;
+                p.d[i] = plane.w;
+                p.ax[i] = std::abs(plane.x);
+                p.ay[i] = std::abs(plane.y);
+                p.az[i] = std::abs(plane.z);
+            }
+            return p;
+        }
+
+        inline uint32_t emitMask(uint32_t mask, uint32_t base, uint32_t* out) {
+            uint32_t n = 0;
+            while (mask != 0) {
+                out[n++] = base + static_cast<uint32_t>(std::countr_zero(mask));
+                mask &= mask - 1;
+            }
+            return n;
+        }
+
+        // A box is outside a plane when its most positive corner is behind it:
+        // dot(n, c) + dot(|n|, e) + d < 0.
+        uint32_t cullRangeScalar(const PlaneSet& p, const AabbSoA& boxes,
+                                 uint32_t first, uint32_t last, uint32_t* out) {
+            const float* cx = boxes.cx();
+            const float* cy = boxes.cy();
+            const float* cz = boxes.cz();
+            const float* ex = boxes.ex();
+            const float* ey = boxes.ey();
+            const float* ez = boxes.ez();
+
+            uint32_t n = 0;
+            for (uint32_t i = first; i < last; ++i) {
+                bool inside = true;
+                for (int k = 0; k < 6 && inside; ++k) {
+                    const float dist = p.nx[k] * cx[i] + p.ny[k] * cy[i] + p.nz[k] * cz[i] +
+                                       p.ax[k] * ex[i] + p.ay[k] * ey[i] + p.az[k] * ez[i] + p.d[k];
+                    inside = dist >= 0.0F;
+                }
+                if (inside) {
+                    out[n++] = i;
+                }
+            }
+            return n;
+        }
+
+        uint32_t cullRange(const PlaneSet& p, const AabbSoA& boxes, uint32_t first,
+                           uint32_t last, uint32_t* out) {
+#if !defined(__AVX2__) && !defined(PNKR_SIMD_SSE) && !defined(PNKR_SIMD_NEON)
+            return cullRangeScalar(p, boxes, first, last, out);
+#else
+            const float* cx = boxes.cx();
+            const float* cy = boxes.cy();
+            const float* cz = boxes.cz();
+            const float* ex = boxes.ex();
+            const float* ey = boxes.ey();
+            const float* ez = boxes.ez();
+
+            uint32_t n = 0;
+#if defined(__AVX2__)
+            const auto madd = [](__m256 a, __m256 b, __m256 c) {
+#if defined(__FMA__) || defined(_MSC_VER)
+                return _mm256_fmadd_ps(a, b, c);
+#else
+                return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+            };
+            for (uint32_t base = first; base < last; base += kCullBatch) {
+                const __m256 vcx = _mm256_loadu_ps(cx + base);
+                const __m256 vcy = _mm256_loadu_ps(cy + base);
+                const __m256 vcz = _mm256_loadu_ps(cz + base);
+                const __m256 vex = _mm256_loadu_ps(ex + base);
+                const __m256 vey = _mm256_loadu_ps(ey + base);
+                const __m256 vez = _mm256_loadu_ps(ez + base);
+
+                __m256 outside = _mm256_setzero_ps();
+                for (int k = 0; k < 6; ++k) {
+                    __m256 dist = madd(vcx, _mm256_set1_ps(p.nx[k]), _mm256_set1_ps(p.d[k]));
+                    dist = madd(vcy, _mm256_set1_ps(p.ny[k]), dist);
+                    dist = madd(vcz, _mm256_set1_ps(p.nz[k]), dist);
+                    dist = madd(vex, _mm256_set1_ps(p.ax[k]), dist);
+                    dist = madd(vey, _mm256_set1_ps(p.ay[k]), dist);
+                    dist = madd(vez, _mm256_set1_ps(p.az[k]), dist);
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, _mm256_setzero_ps(), _CMP_LT_OQ));
+                }
+
+                uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFFU;
+                if (last - base < kCullBatch) {
+                    mask &= (1U << (last - base)) - 1U;
+                }
+                n += emitMask(mask, base, out + n);
+            }
+#elif defined(PNKR_SIMD_SSE)
+            for (uint32_t base = first; base < last; base += 4) {
+                const __m128 vcx = _mm_loadu_ps(cx + base);
+                const __m128 vcy = _mm_loadu_ps(cy + base);
+                const __m128 vcz = _mm_loadu_ps(cz + base);
+                const __m128 vex = _mm_loadu_ps(ex + base);
+                const __m128 vey = _mm_loadu_ps(ey + base);
+                const __m128 vez = _mm_loadu_ps(ez + base);
+
+                __m128 outside = _mm_setzero_ps();
+                for (int k = 0; k < 6; ++k) {
+                    __m128 dist = _mm_add_ps(_mm_mul_ps(vcx, _mm_set1_ps(p.nx[k])), _mm_set1_ps(p.d[k]));
+                    dist = _mm_add_ps(dist, _mm_mul_ps(vcy, _mm_set1_ps(p.ny[k])));
+                    dist = _mm_add_ps(dist, _mm_mul_ps(vcz, _mm_set1_ps(p.nz[k])));
+                    dist = _mm_add_ps(dist, _mm_mul_ps(vex, _mm_set1_ps(p.ax[k])));
+                    dist = _mm_add_ps(dist, _mm_mul_ps(vey, _mm_set1_ps(p.ay[k])));
+                    dist = _mm_add_ps(dist, _mm_mul_ps(vez, _mm_set1_ps(p.az[k])));
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_setzero_ps()));
+                }
+
+                uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xFU;
+                if (last - base < 4) {
+                    mask &= (1U << (last - base)) - 1U;
+                }
+                n += emitMask(mask, base, out + n);
+            }
+#elif defined(PNKR_SIMD_NEON)
+            static const uint32_t kLaneBits[4] = {1U, 2U, 4U, 8U};
+            const uint32x4_t laneBits = vld1q_u32(kLaneBits);
+            for (uint32_t base = first; base < last; base += 4) {
+                const float32x4_t vcx = vld1q_f32(cx + base);
+                const float32x4_t vcy = vld1q_f32(cy + base);
+                const float32x4_t vcz = vld1q_f32(cz + base);
+                const float32x4_t vex = vld1q_f32(ex + base);
+                const float32x4_t vey = vld1q_f32(ey + base);
+                const float32x4_t vez = vld1q_f32(ez + base);
+
+                uint32x4_t outside = vdupq_n_u32(0);
+                for (int k = 0; k < 6; ++k) {
+                    float32x4_t dist = vfmaq_n_f32(vdupq_n_f32(p.d[k]), vcx, p.nx[k]);
+                    dist = vfmaq_n_f32(dist, vcy, p.ny[k]);
+                    dist = vfmaq_n_f32(dist, vcz, p.nz[k]);
+                    dist = vfmaq_n_f32(dist, vex, p.ax[k]);
+                    dist = vfmaq_n_f32(dist, vey, p.ay[k]);
+                    dist = vfmaq_n_f32(dist, vez, p.az[k]);
+                    outside = vorrq_u32(outside, vcltq_f32(dist, vdupq_n_f32(0.0F)));
+                }
+
+                uint32_t mask = vaddvq_u32(vbicq_u32(laneBits, outside));
+                if (last - base < 4) {
+                    mask &= (1U << (last - base)) - 1U;
+                }
+                n += emitMask(mask, base, out + n);
+            }
+#endif
+            return n;
+#endif
+        }
+    }
+
+    void AabbSoA::resize(uint32_t count) {
+        const uint32_t keep = std::min(count, m_count);
+        const uint32_t padded = paddedCount(count);
+        for (auto* v : {&m_cx, &m_cy, &m_cz, &m_ex, &m_ey, &m_ez}) {
+            v->resize(padded);
+        }
+        // Grown slots stay empty until set(); the padding tail always is.
+        for (uint32_t i = keep; i < padded; ++i) {
+            setEmpty(i);
+        }
+        m_count = count;
+    }
+
+    void AabbSoA::clear() noexcept {
+        for (auto* v : {&m_cx, &m_cy, &m_cz, &m_ex, &m_ey, &m_ez}) {
+            v->clear();
+        }
+        m_count = 0;
+    }
+
+    void AabbSoA::setEmpty(uint32_t index) {
+        m_cx[index] = m_cy[index] = m_cz[index] = 0.0F;
+        m_ex[index] = m_ey[index] = m_ez[index] = kEmptyExtent;
+    }
+
+    void AabbSoA::set(uint32_t index, const scene::BoundingBox& box) {
+        if (!box.isValid()) {
+            setEmpty(index);
+            return;
+        }
+        const glm::vec3 c = (box.m_min + box.m_max) * 0.5F;
+        const glm::vec3 e = (box.m_max - box.m_min) * 0.5F;
+        m_cx[index] = c.x;
+        m_cy[index] = c.y;
+        m_cz[index] = c.z;
+        m_ex[index] = e.x;
+        m_ey[index] = e.y;
+        m_ez[index] = e.z;
+    }
+
+    scene::BoundingBox AabbSoA::get(uint32_t index) const {
+        scene::BoundingBox box{};
+        if (m_ex[index] < 0.0F) {
+            return box;
+        }
+        const glm::vec3 c(m_cx[index], m_cy[index], m_cz[index]);
+        const glm::vec3 e(m_ex[index], m_ey[index], m_ez[index]);
+        box.m_min = c - e;
+        box.m_max = c + e;
+        return box;
+    }
+
+    void AabbSoA::swapRemove(uint32_t index) {
+        const uint32_t last = m_count - 1;
+        if (index != last) {
+            m_cx[index] = m_cx[last];
+            m_cy[index] = m_cy[last];
+            m_cz[index] = m_cz[last];
+            m_ex[index] = m_ex[last];
+            m_ey[index] = m_ey[last];
+            m_ez[index] = m_ez[last];
+        }
+        resize(last);
+    }
+
+    void cullBoxes(const Frustum& frustum, const AabbSoA& boxes, uint32_t first,
+                   uint32_t last, std::vector<uint32_t>& visible) {
+        last = std::min(last, boxes.size());
+        if (first >= last) {
+            return;
+        }
+        const size_t base = visible.size();
+        visible.resize(base + (last - first));
+        const uint32_t n = cullRange(splitPlanes(frustum), boxes, first, last, visible.data() + base);
+        visible.resize(base + n);
+    }
+
+    void cullBoxesScalar(const Frustum& frustum, const AabbSoA& boxes,
+                         uint32_t first, uint32_t last,
+                         std::vector<uint32_t>& visible) {
+        last = std::min(last, boxes.size());
+        if (first >= last) {
+            return;
+        }
+        const size_t base = visible.size();
+        visible.resize(base + (last - first));
+        const uint32_t n = cullRangeScalar(splitPlanes(frustum), boxes, first, last, visible.data() + base);
+        visible.resize(base + n);
+    }
+
+    std::span<const uint32_t> FrustumCuller::cull(const Frustum& frustum, const AabbSoA& boxes) {
+        PNKR_PROFILE_FUNCTION();
+
+        const uint32_t count = boxes.size();
+        const uint32_t chunkCount = (count + kChunkBoxes - 1) / kChunkBoxes;
+        if (m_visible.size() < count) {
+            m_visible.resize(count);
+        }
+        m_chunkCounts.assign(chunkCount, 0);
+
+        // Each chunk writes its survivors at its own offset, then the runs
+        // are slid down into one ascending list.
+        const PlaneSet planes = splitPlanes(frustum);
+        core::TaskSystem::parallelFor(
+            chunkCount,
+            [&](enki::TaskSetPartition range, uint32_t) {
+                for (uint32_t c = range.start; c < range.end; ++c) {
+                    const uint32_t first = c * kChunkBoxes;
+                    const uint32_t last = std::min(first + kChunkBoxes, count);
+                    m_chunkCounts[c] = cullRange(planes, boxes, first, last, m_visible.data() + first);
+                }
+            },
+            1);
+
+        uint32_t write = 0;
+        for (uint32_t c = 0; c < chunkCount; ++c) {
+            const uint32_t first = c * kChunkBoxes;
+            if (write != first && m_chunkCounts[c] != 0) {
+                std::memmove(m_visible.data() + write, m_visible.data() + first,
+                             m_chunkCounts[c] * sizeof(uint32_t));
+            }
+            write += m_chunkCounts[c];
+        }
+        m_visibleCount = write;
+        return visible();
+    }
+}
@@ -0,0 +1,433 @@
+#include "pnkr/renderer/geometry/OcclusionCull.hpp"
+
+#include "pnkr/core/TaskSystem.hpp"
+#include "pnkr/core/profiler.hpp"
+#include "pnkr/renderer/geometry/SimdMath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace pnkr::renderer::geometry {
+
+    namespace {
+        // Tile rows rasterized by one task.
+        constexpr uint32_t kBandTileRows = 4;
+        constexpr uint32_t kBandHeight = kBandTileRows * kOcclusionTileHeight;
+
+        // Occludee tests per task; they cost far more than a plane test.
+        constexpr uint32_t kChunkBoxes = 256;
+
+        constexpr float kFarDepth = 1.0F;
+        constexpr float kMinArea = 1e-6F;
+
+        // Four pixels of a row per step. Depth and coverage only need a
+        // handful of operations, so the three back ends share one kernel.
+#if defined(PNKR_SIMD_SSE)
+        using F4 = __m128;
+        inline F4 splat(float v) { return _mm_set1_ps(v); }
+        inline F4 ramp(float v) { return _mm_setr_ps(v, v + 1.0F, v + 2.0F, v + 3.0F); }
+        inline F4 load(const float* p) { return _mm_loadu_ps(p); }
+        inline void store(float* p, F4 v) { _mm_storeu_ps(p, v); }
+        inline F4 add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+        inline F4 mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+        inline F4 vmin(F4 a, F4 b) { return _mm_min_ps(a, b); }
+        inline F4 vmax(F4 a, F4 b) { return _mm_max_ps(a, b); }
+        inline F4 insideMask(F4 e0, F4 e1, F4 e2) {
+            return _mm_cmpgt_ps(vmin(vmin(e0, e1), e2), _mm_setzero_ps());
+        }
+        inline F4 select(F4 mask, F4 a, F4 b) {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+        inline float hmax(F4 v) {
+            v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+            v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtss_f32(v);
+        }
+#elif defined(PNKR_SIMD_NEON)
+        using F4 = float32x4_t;
+        inline F4 splat(float v) { return vdupq_n_f32(v); }
+        inline F4 ramp(float v) {
+            const float lanes[4] = {v, v + 1.0F, v + 2.0F, v + 3.0F};
+            return vld1q_f32(lanes);
+        }
+        inline F4 load(const float* p) { return vld1q_f32(p); }
+        inline void store(float* p, F4 v) { vst1q_f32(p, v); }
+        inline F4 add(F4 a, F4 b) { return vaddq_f32(a, b); }
+        inline F4 mul(F4 a, F4 b) { return vmulq_f32(a, b); }
+        inline F4 vmin(F4 a, F4 b) { return vminq_f32(a, b); }
+        inline F4 vmax(F4 a, F4 b) { return vmaxq_f32(a, b); }
+        inline F4 insideMask(F4 e0, F4 e1, F4 e2) {
+            return vreinterpretq_f32_u32(vcgtq_f32(vmin(vmin(e0, e1), e2), vdupq_n_f32(0.0F)));
+        }
+        inline F4 select(F4 mask, F4 a, F4 b) {
+            return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+        }
+        inline float hmax(F4 v) { return vmaxvq_f32(v); }
+#else
+        struct F4 {
+            float v[4];
+        };
+        template <typename Op>
+        inline F4 lanes(F4 a, F4 b, Op op) {
+            return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+        }
+        inline F4 splat(float v) { return {{v, v, v, v}}; }
+        inline F4 ramp(float v) { return {{v, v + 1.0F, v + 2.0F, v + 3.0F}}; }
+        inline F4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+        inline void store(float* p, F4 v) { std::memcpy(p, v.v, sizeof(v.v)); }
+        inline F4 add(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return x + y; }); }
+        inline F4 mul(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return x * y; }); }
+        inline F4 vmin(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return std::min(x, y); }); }
+        inline F4 vmax(F4 a, F4 b) { return lanes(a, b, [](float x, float y) { return std::max(x, y); }); }
+        // Lanes are all-ones or zero as a float; only select() reads them.
+        inline F4 insideMask(F4 e0, F4 e1, F4 e2) {
+            F4 m{};
+            for (int i = 0; i < 4; ++i) {
+                m.v[i] = (e0.v[i] > 0.0F && e1.v[i] > 0.0F && e2.v[i] > 0.0F) ? 1.0F : 0.0F;
+            }
+            return m;
+        }
+        inline F4 select(F4 mask, F4 a, F4 b) {
+            F4 r{};
+            for (int i = 0; i < 4; ++i) {
+                r.v[i] = mask.v[i] != 0.0F ? a.v[i] : b.v[i];
+            }
+            return r;
+        }
+        inline float hmax(F4 v) { return std::max(std::max(v.v[0], v.v[1]), std::max(v.v[2], v.v[3])); }
+#endif
+
+        // Edge i runs from vertex i to vertex i+1; e(px, py) = a*px + b*py + c
+        // is positive inside a triangle with positive area. Coverage is
+        // sampled at pixel centres; see OcclusionCuller for the error.
+        struct Edge {
+            float a, b, c;
+        };
+
+        Edge makeEdge(float x0, float y0, float x1, float y1) {
+            return {y0 - y1, x1 - x0, (y1 - y0) * x0 - (x1 - x0) * y0};
+        }
+
+        uint32_t roundUp(uint32_t value, uint32_t multiple) {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+    }
+
+    void OcclusionCuller::resize(uint32_t width, uint32_t height) {
+        m_width = roundUp(std::max(width, 1U), kOcclusionTileWidth);
+        m_height = roundUp(std::max(height, 1U), kOcclusionTileHeight);
+        m_tilesX = m_width / kOcclusionTileWidth;
+        m_tilesY = m_height / kOcclusionTileHeight;
+        m_depth.assign(static_cast<size_t>(m_width) * m_height, kFarDepth);
+        m_tileMax.assign(static_cast<size_t>(m_tilesX) * m_tilesY, kFarDepth);
+        m_bands.resize((m_tilesY + kBandTileRows - 1) / kBandTileRows);
+    }
+
+    void OcclusionCuller::begin(const glm::mat4& viewProj) {
+        m_viewProj = viewProj;
+        std::fill(m_depth.begin(), m_depth.end(), kFarDepth);
+        std::fill(m_tileMax.begin(), m_tileMax.end(), kFarDepth);
+        m_clip.clear();
+        m_indices.clear();
+        m_stats = {};
+    }
+
+    void OcclusionCuller::addOccluder(std::span<const glm::vec3> positions,
+                                      std::span<const uint32_t> indices,
+                                      const glm::mat4& world) {
+        if (positions.empty() || indices.size() < 3) {
+            return;
+        }
+        glm::mat4 toClip;
+        mulMat4(m_viewProj, world, toClip);
+
+        const auto base = static_cast<uint32_t>(m_clip.size());
+        m_clip.reserve(m_clip.size() + positions.size());
+        for (const glm::vec3& p : positions) {
+            m_clip.push_back(toClip * glm::vec4(p, 1.0F));
+        }
+        const size_t triIndices = indices.size() - indices.size() % 3;
+        m_indices.reserve(m_indices.size() + triIndices);
+        for (size_t i = 0; i < triIndices; ++i) {
+            m_indices.push_back(base + indices[i]);
+        }
+        ++m_stats.occluders;
+        m_stats.occluderTriangles += static_cast<uint32_t>(triIndices / 3);
+    }
+
+    void OcclusionCuller::rasterize() {
+        PNKR_PROFILE_FUNCTION();
+
+        const auto triCount = static_cast<uint32_t>(m_indices.size() / 3);
+        m_triangles.resize(triCount);
+        const auto width = static_cast<float>(m_width);
+        const auto height = static_cast<float>(m_height);
+
+        // Setup writes one slot per triangle; rejected ones get an empty row range.
+        core::TaskSystem::parallelFor(
+            triCount,
+            [&](enki::TaskSetPartition range, uint32_t) {
+                for (uint32_t t = range.start; t < range.end; ++t) {
+                    Triangle& tri = m_triangles[t];
+                    tri.minY = 1;
+                    tri.maxY = 0;
+
+                    float z[3];
+                    bool clipped = false;
+                    for (int k = 0; k < 3; ++k) {
+                        const uint32_t index = m_indices[t * 3 + k];
+                        if (index >= m_clip.size()) {
+                            clipped = true;
+                            break;
+                        }
+                        const glm::vec4& c = m_clip[index];
+                        // Dropping triangles that cross the near plane only loses occlusion.
+                        if (c.w <= 0.0F || c.z < 0.0F) {
+                            clipped = true;
+                            break;
+                        }
+                        const float invW = 1.0F / c.w;
+                        tri.x[k] = (c.x * invW * 0.5F + 0.5F) * width;
+                        tri.y[k] = (c.y * invW * 0.5F + 0.5F) * height;
+                        z[k] = c.z * invW;
+                    }
+                    if (clipped) {
+                        continue;
+                    }
+
+                    float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) -
+                                 (tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+                    if (std::abs(area) < kMinArea) {
+                        continue;
+                    }
+                    if (area < 0.0F) {
+                        std::swap(tri.x[1], tri.x[2]);
+                        std::swap(tri.y[1], tri.y[2]);
+                        std::swap(z[1], z[2]);
+                        area = -area;
+                    }
+
+                    // Pixels whose centre lies in the triangle's bounds.
+                    const float minX = std::min({tri.x[0], tri.x[1], tri.x[2]});
+                    const float maxX = std::max({tri.x[0], tri.x[1], tri.x[2]});
+                    const float minY = std::min({tri.y[0], tri.y[1], tri.y[2]});
+                    const float maxY = std::max({tri.y[0], tri.y[1], tri.y[2]});
+                    if (maxX <= 0.5F || maxY <= 0.5F || minX >= width - 0.5F || minY >= height - 0.5F) {
+                        continue;
+                    }
+                    const auto rowBegin = static_cast<int32_t>(std::max(std::ceil(minY - 0.5F), 0.0F));
+                    const auto rowEnd = static_cast<int32_t>(std::min(std::floor(maxY - 0.5F), height - 1.0F));
+                    const auto colBegin = static_cast<int32_t>(std::max(std::ceil(minX - 0.5F), 0.0F));
+                    const auto colEnd = static_cast<int32_t>(std::min(std::floor(maxX - 0.5F), width - 1.0F));
+                    if (rowBegin > rowEnd || colBegin > colEnd) {
+                        continue;
+                    }
+
+                    // The plane is sampled at pixel centres; adding half a
+                    // pixel of slope makes it the farthest depth in the pixel.
+                    const float invArea = 1.0F / area;
+                    tri.zx = ((z[1] - z[0]) * (tri.y[2] - tri.y[0]) - (z[2] - z[0]) * (tri.y[1] - tri.y[0])) * invArea;
+                    tri.zy = ((z[2] - z[0]) * (tri.x[1] - tri.x[0]) - (z[1] - z[0]) * (tri.x[2] - tri.x[0])) * invArea;
+                    tri.z0 = z[0] - tri.zx * tri.x[0] - tri.zy * tri.y[0] +
+                             0.5F * (std::abs(tri.zx) + std::abs(tri.zy));
+                    tri.zMax = std::max({z[0], z[1], z[2]});
+                    tri.minY = rowBegin;
+                    tri.maxY = rowEnd;
+                }
+            },
+            256);
+
+        for (auto& band : m_bands) {
+            band.clear();
+        }
+        for (uint32_t t = 0; t < triCount; ++t) {
+            const Triangle& tri = m_triangles[t];
+            if (tri.minY > tri.maxY) {
+                continue;
+            }
+            ++m_stats.rasterizedTriangles;
+            const uint32_t first = static_cast<uint32_t>(tri.minY) / kBandHeight;
+            const uint32_t last = static_cast<uint32_t>(tri.maxY) / kBandHeight;
+            for (uint32_t b = first; b <= last; ++b) {
+                m_bands[b].push_back(t);
+            }
+        }
+
+        // Bands own disjoint rows, and the nearest depth wins in any order,
+        // so the result does not depend on scheduling.
+        core::TaskSystem::parallelFor(
+            static_cast<uint32_t>(m_bands.size()),
+            [&](enki::TaskSetPartition range, uint32_t) {
+                for (uint32_t b = range.start; b < range.end; ++b) {
+                    rasterizeBand(b);
+                }
+            },
+            1);
+    }
+
+    void OcclusionCuller::rasterizeBand(uint32_t band) {
+        const auto rowBegin = static_cast<int32_t>(band * kBandHeight);
+        const auto rowEnd = static_cast<int32_t>(std::min((band + 1) * kBandHeight, m_height));
+        for (const uint32_t t : m_bands[band]) {
+            const Triangle& tri = m_triangles[t];
+            rasterizeTriangle(tri, std::max(rowBegin, tri.minY), std::min(rowEnd - 1, tri.maxY));
+        }
+
+        const uint32_t tileRowEnd = static_cast<uint32_t>(rowEnd) / kOcclusionTileHeight;
+        for (uint32_t ty = static_cast<uint32_t>(rowBegin) / kOcclusionTileHeight; ty < tileRowEnd; ++ty) {
+            for (uint32_t tx = 0; tx < m_tilesX; ++tx) {
+                F4 farthest = splat(0.0F);
+                for (uint32_t y = 0; y < kOcclusionTileHeight; ++y) {
+                    const float* row = m_depth.data() +
+                                       static_cast<size_t>(ty * kOcclusionTileHeight + y) * m_width +
+                                       tx * kOcclusionTileWidth;
+                    for (uint32_t x = 0; x < kOcclusionTileWidth; x += 4) {
+                        farthest = vmax(farthest, load(row + x));
+                    }
+                }
+                m_tileMax[static_cast<size_t>(ty) * m_tilesX + tx] = hmax(farthest);
+            }
+        }
+    }
+
+    void OcclusionCuller::rasterizeTriangle(const Triangle& tri, int32_t rowBegin, int32_t rowEnd) {
+        const Edge edges[3] = {
+            makeEdge(tri.x[0], tri.y[0], tri.x[1], tri.y[1]),
+            makeEdge(tri.x[1], tri.y[1], tri.x[2], tri.y[2]),
+            makeEdge(tri.x[2], tri.y[2], tri.x[0], tri.y[0]),
+        };
+        const float minX = std::min({tri.x[0], tri.x[1], tri.x[2]});
+        const float maxX = std::max({tri.x[0], tri.x[1], tri.x[2]});
+        const auto colBegin = static_cast<int32_t>(std::max(std::ceil(minX - 0.5F), 0.0F)) & ~3;
+        const auto colEnd = static_cast<int32_t>(std::min(std::floor(maxX - 0.5F), static_cast<float>(m_width) - 1.0F));
+
+        const F4 ea0 = splat(edges[0].a), ea1 = splat(edges[1].a), ea2 = splat(edges[2].a);
+        const F4 za = splat(tri.zx);
+        const F4 zMax = splat(tri.zMax);
+        const F4 step = splat(4.0F);
+
+        for (int32_t y = rowBegin; y <= rowEnd; ++y) {
+            const float py = static_cast<float>(y) + 0.5F;
+            const F4 px0 = ramp(static_cast<float>(colBegin) + 0.5F);
+            F4 e0 = add(mul(ea0, px0), splat(edges[0].b * py + edges[0].c));
+            F4 e1 = add(mul(ea1, px0), splat(edges[1].b * py + edges[1].c));
+            F4 e2 = add(mul(ea2, px0), splat(edges[2].b * py + edges[2].c));
+            F4 z = add(mul(za, px0), splat(tri.zy * py + tri.z0));
+            const F4 de0 = mul(ea0, step), de1 = mul(ea1, step), de2 = mul(ea2, step);
+            const F4 dz = mul(za, step);
+
+            float* row = m_depth.data() + static_cast<size_t>(y) * m_width;
+            for (int32_t x = colBegin; x <= colEnd; x += 4) {
+                const F4 inside = insideMask(e0, e1, e2);
+                const F4 old = load(row + x);
+                store(row + x, select(inside, vmin(old, vmin(z, zMax)), old));
+                e0 = add(e0, de0);
+                e1 = add(e1, de1);
+                e2 = add(e2, de2);
+                z = add(z, dz);
+            }
+        }
+    }
+
+    bool OcclusionCuller::isOccluded(const scene::BoundingBox& box) const {
+        if (!box.isValid() || m_depth.empty()) {
+            return false;
+        }
+
+        const auto width = static_cast<float>(m_width);
+        const auto height = static_cast<float>(m_height);
+        float minX = width, maxX = 0.0F, minY = height, maxY = 0.0F;
+        float nearest = kFarDepth;
+        for (int i = 0; i < 8; ++i) {
+            const glm::vec4 corner((i & 1) != 0 ? box.m_max.x : box.m_min.x,
+                                   (i & 2) != 0 ? box.m_max.y : box.m_min.y,
+                                   (i & 4) != 0 ? box.m_max.z : box.m_min.z, 1.0F);
+            const glm::vec4 c = m_viewProj * corner;
+            if (c.w <= 0.0F || c.z < 0.0F) {
+                return false;
+            }
+            const float invW = 1.0F / c.w;
+            const float sx = (c.x * invW * 0.5F + 0.5F) * width;
+            const float sy = (c.y * invW * 0.5F + 0.5F) * height;
+            minX = std::min(minX, sx);
+            maxX = std::max(maxX, sx);
+            minY = std::min(minY, sy);
+            maxY = std::max(maxY, sy);
+            nearest = std::min(nearest, c.z * invW);
+        }
+        // Off-screen boxes are left to the frustum test.
+        if (maxX <= 0.0F || maxY <= 0.0F || minX >= width || minY >= height) {
+            return false;
+        }
+
+        // Every pixel the rect touches, not just the ones whose centre it covers.
+        const auto x0 = static_cast<uint32_t>(std::max(std::floor(minX), 0.0F));
+        const auto x1 = static_cast<uint32_t>(std::min(std::ceil(maxX), width) - 1.0F);
+        const auto y0 = static_cast<uint32_t>(std::max(std::floor(minY), 0.0F));
+        const auto y1 = static_cast<uint32_t>(std::min(std::ceil(maxY), height) - 1.0F);
+
+        for (uint32_t ty = y0 / kOcclusionTileHeight; ty <= y1 / kOcclusionTileHeight; ++ty) {
+            for (uint32_t tx = x0 / kOcclusionTileWidth; tx <= x1 / kOcclusionTileWidth; ++tx) {
+                if (m_tileMax[static_cast<size_t>(ty) * m_tilesX + tx] < nearest) {
+                    continue;
+                }
+                const uint32_t py0 = std::max(y0, ty * kOcclusionTileHeight);
+                const uint32_t py1 = std::min(y1, ty * kOcclusionTileHeight + kOcclusionTileHeight - 1);
+                const uint32_t px0 = std::max(x0, tx * kOcclusionTileWidth);
+                const uint32_t px1 = std::min(x1, tx * kOcclusionTileWidth + kOcclusionTileWidth - 1);
+                for (uint32_t y = py0; y <= py1; ++y) {
+                    const float* row = m_depth.data() + static_cast<size_t>(y) * m_width;
+                    for (uint32_t x = px0; x <= px1; ++x) {
+                        if (row[x] >= nearest) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    std::span<const uint32_t> OcclusionCuller::cull(std::span<const scene::BoundingBox> boxes) {
+        PNKR_PROFILE_FUNCTION();
+
+        const auto count = static_cast<uint32_t>(boxes.size());
+        const uint32_t chunkCount = (count + kChunkBoxes - 1) / kChunkBoxes;
+        if (m_visible.size() < count) {
+            m_visible.resize(count);
+        }
+        m_chunkCounts.assign(chunkCount, 0);
+
+        core::TaskSystem::parallelFor(
+            chunkCount,
+            [&](enki::TaskSetPartition range, uint32_t) {
+                for (uint32_t c = range.start; c < range.end; ++c) {
+                    const uint32_t first = c * kChunkBoxes;
+                    const uint32_t last = std::min(first + kChunkBoxes, count);
+                    uint32_t n = 0;
+                    for (uint32_t i = first; i < last; ++i) {
+                        if (!isOccluded(boxes[i])) {
+                            m_visible[first + n++] = i;
+                        }
+                    }
+                    m_chunkCounts[c] = n;
+                }
+            },
+            1);
+
+        uint32_t write = 0;
+        for (uint32_t c = 0; c < chunkCount; ++c) {
+            const uint32_t first = c * kChunkBoxes;
+            if (write != first && m_chunkCounts[c] != 0) {
+                std::memmove(m_visible.data() + write, m_visible.data() + first,
+                             m_chunkCounts[c] * sizeof(uint32_t));
+            }
+            write += m_chunkCounts[c];
+        }
+        m_visibleCount = write;
+        m_stats.testedBoxes = count;
+        m_stats.occludedBoxes = count - write;
+        return {m_visible.data(), m_visibleCount};
+    }
+}
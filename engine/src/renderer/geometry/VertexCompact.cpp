@@ -0,0 +1,127 @@
+#include "pnkr/renderer/geometry/VertexCompact.hpp"
+
+#include "pnkr/core/TaskSystem.hpp"
+#include "pnkr/core/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/gtc/packing.hpp>
+
+namespace pnkr::renderer::geometry {
+
+    namespace {
+        constexpr float kPositionSteps = 65535.0F;
+        constexpr uint32_t kTangentSignBit = 1U << 31;
+
+        glm::vec2 signNotZero(const glm::vec2& v) {
+            return {v.x >= 0.0F ? 1.0F : -1.0F, v.y >= 0.0F ? 1.0F : -1.0F};
+        }
+
+        uint32_t quantizePosition(float value, float origin, float step) {
+            const float q = std::round((value - origin) / step);
+            return static_cast<uint32_t>(std::clamp(q, 0.0F, kPositionSteps));
+        }
+    }
+
+    uint32_t octEncode(const glm::vec3& n) {
+        const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if (l1 <= 0.0F) {
+            return glm::packSnorm2x16(glm::vec2(0.0F));
+        }
+        glm::vec2 p = glm::vec2(n) / l1;
+        if (n.z < 0.0F) {
+            p = (1.0F - glm::abs(glm::vec2(p.y, p.x))) * signNotZero(p);
+        }
+        return glm::packSnorm2x16(p);
+    }
+
+    glm::vec3 octDecode(uint32_t packed) {
+        const glm::vec2 e = glm::unpackSnorm2x16(packed);
+        glm::vec3 n(e, 1.0F - std::abs(e.x) - std::abs(e.y));
+        if (n.z < 0.0F) {
+            const glm::vec2 xy = (1.0F - glm::abs(glm::vec2(n.y, n.x))) * signNotZero(glm::vec2(n));
+            n.x = xy.x;
+            n.y = xy.y;
+        }
+        return glm::normalize(n);
+    }
+
+    glm::vec4 positionDequant(const glm::vec3& minPos, const glm::vec3& maxPos) {
+        const glm::vec3 extent = glm::max(maxPos - minPos, glm::vec3(0.0F));
+        // Never 0: a zero step is what marks a full-layout instance.
+        const float range = std::max({extent.x, extent.y, extent.z, 1e-6F});
+        return {minPos, range / kPositionSteps};
+    }
+
+    gpu::VertexCompactGPU encodeCompactVertex(const Vertex& v, const glm::vec4& posDequant) {
+        const glm::vec3 origin(posDequant);
+        const float step = posDequant.w;
+
+        gpu::VertexCompactGPU out{};
+        out.positionXY = quantizePosition(v.position.x, origin.x, step) |
+                         (quantizePosition(v.position.y, origin.y, step) << 16);
+        out.positionZ = quantizePosition(v.position.z, origin.z, step);
+        if (v.tangent.w < 0.0F) {
+            out.positionZ |= kTangentSignBit;
+        }
+        out.normal = octEncode(glm::vec3(v.normal));
+        out.tangent = octEncode(glm::vec3(v.tangent));
+        out.uv0 = glm::packHalf2x16(v.uv0);
+        out.uv1 = glm::packHalf2x16(v.uv1);
+        out.color = glm::packUnorm4x8(v.color);
+        out.meshIndex = v.meshIndex;
+        return out;
+    }
+
+    Vertex decodeCompactVertex(const gpu::VertexCompactGPU& v, const glm::vec4& posDequant) {
+        const glm::vec3 q(static_cast<float>(v.positionXY & 0xFFFFU),
+                          static_cast<float>(v.positionXY >> 16),
+                          static_cast<float>(v.positionZ & 0xFFFFU));
+
+        Vertex out{};
+        out.position = glm::vec4(glm::vec3(posDequant) + q * posDequant.w, 1.0F);
+        out.normal = glm::vec4(octDecode(v.normal), 0.0F);
+        out.tangent = glm::vec4(octDecode(v.tangent), (v.positionZ & kTangentSignBit) != 0 ? -1.0F : 1.0F);
+        out.uv0 = glm::unpackHalf2x16(v.uv0);
+        out.uv1 = glm::unpackHalf2x16(v.uv1);
+        out.color = glm::unpackUnorm4x8(v.color);
+        out.meshIndex = v.meshIndex;
+        return out;
+    }
+
+    void encodeCompactVertices(std::span<const Vertex> vertices,
+                               std::vector<gpu::VertexCompactGPU>& out,
+                               std::vector<glm::vec4>& meshDequant)
+    {
+        PNKR_PROFILE_FUNCTION();
+
+        std::vector<glm::vec3> meshMin;
+        std::vector<glm::vec3> meshMax;
+        for (const auto& v : vertices) {
+            if (v.meshIndex >= meshMin.size()) {
+                meshMin.resize(v.meshIndex + 1, glm::vec3(std::numeric_limits<float>::max()));
+                meshMax.resize(v.meshIndex + 1, glm::vec3(std::numeric_limits<float>::lowest()));
+            }
+            meshMin[v.meshIndex] = glm::min(meshMin[v.meshIndex], glm::vec3(v.position));
+            meshMax[v.meshIndex] = glm::max(meshMax[v.meshIndex], glm::vec3(v.position));
+        }
+
+        meshDequant.resize(meshMin.size());
+        for (size_t i = 0; i < meshMin.size(); ++i) {
+            meshDequant[i] = meshMin[i].x <= meshMax[i].x ? positionDequant(meshMin[i], meshMax[i])
+                                                          : positionDequant(glm::vec3(0.0F), glm::vec3(0.0F));
+        }
+
+        out.resize(vertices.size());
+        core::TaskSystem::parallelFor(static_cast<uint32_t>(vertices.size()),
+            [&](enki::TaskSetPartition range, uint32_t) {
+                for (uint32_t i = range.start; i < range.end; ++i) {
+                    out[i] = encodeCompactVertex(vertices[i], meshDequant[vertices[i].meshIndex]);
+                }
+            },
+            4096);
+    }
+
+}
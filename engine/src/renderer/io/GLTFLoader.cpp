@@ -6,7 +6,8 @@
 
 namespace pnkr::renderer::io
 {
-    std::unique_ptr<scene::ModelDOD> GLTFLoader::load(RHIRenderer& renderer, const std::filesystem::path& path, bool vertexPulling)
+    std::unique_ptr<scene::ModelDOD> GLTFLoader::load(RHIRenderer& renderer, const std::filesystem::path& path, bool vertexPulling,
+                                                     geometry::VertexFormat vertexFormat)
     {
         PNKR_PROFILE_FUNCTION();
         (void)vertexPulling;
@@ -16,6 +17,6 @@ namespace pnkr::renderer::io
             return nullptr;
         }
 
-        return ModelUploader::upload(renderer, std::move(*importedModel));
+        return ModelUploader::upload(renderer, std::move(*importedModel), vertexFormat);
     }
 }
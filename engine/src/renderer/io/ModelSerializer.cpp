@@ -1,13 +1,23 @@
 #include "pnkr/renderer/io/ModelSerializer.hpp"
 #include "pnkr/renderer/scene/ModelDOD.hpp"
 #include "pnkr/renderer/AssetManager.hpp"
+#include "pnkr/renderer/io/PMeshFormat.hpp"
 #include "pnkr/core/cache.hpp"
 #include "pnkr/core/common.hpp"
+#include "pnkr/core/MemoryMappedFile.hpp"
+#include "pnkr/core/profiler.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <fstream>
+#include <functional>
 #include <istream>
 #include <limits>
 #include <ostream>
+#include <span>
+#include <sstream>
+#include <streambuf>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -24,12 +34,25 @@ namespace pnkr::renderer::io
     using namespace pnkr::assets;
 
     namespace {
-    constexpr uint16_t PMESH_VERSION = 6;
-
     struct MeshRange {
       uint32_t m_primCount;
     };
 
+    // PrimitiveDOD before LOD chains, MPRI version 1.
+    struct PrimitiveDODV1 {
+      uint32_t firstIndex;
+      uint32_t indexCount;
+      int32_t vertexOffset;
+      uint32_t materialIndex;
+    };
+
+    // PrimitiveDOD before meshlets, MPRI version 2.
+    struct PrimitiveDODV2 {
+      PrimitiveDODV1 base;
+      uint32_t lodCount;
+      std::array<PrimitiveLod, assets::kMaxPrimitiveLods - 1> lods;
+    };
+
         struct TextureMetaCPU {
           uint8_t m_isSrgb = 1;
           uint8_t m_pad[3] = {};
@@ -142,44 +165,61 @@ namespace pnkr::renderer::io
           readVal(is, t.priority);
         }
 
-        void serializeImportedMesh(std::ostream &os, const ImportedMesh &m) {
+        // Geometry lives in the PRIM/VERT/INDX sections; MESH only names the
+        // meshes and says how many consecutive PRIM records each one owns.
+        void serializeMeshHeader(std::ostream &os, const ImportedMesh &m) {
           writeStr(os, m.name);
-          uint64_t primCount = m.primitives.size();
-          writeVal(os, primCount);
-          for (const auto &p : m.primitives) {
-            writeVec(os, p.vertices);
-            writeVec(os, p.indices);
-            writeVal(os, p.materialIndex);
-            writeVal(os, p.minPos);
-            writeVal(os, p.maxPos);
-            uint64_t targetCount = p.targets.size();
-            writeVal(os, targetCount);
-            for (const auto &t : p.targets) {
-              writeVec(os, t.positionDeltas);
-              writeVec(os, t.normalDeltas);
-            }
-          }
+          writeVal(os, static_cast<uint64_t>(m.primitives.size()));
         }
 
-        void deserializeImportedMesh(std::istream &is, ImportedMesh &m) {
+        void deserializeMeshHeader(std::istream &is, ImportedMesh &m) {
           readStr(is, m.name);
           uint64_t primCount = 0;
           readVal(is, primCount);
+          if (primCount > std::numeric_limits<uint32_t>::max()) {
+            is.setstate(std::ios::failbit);
+            return;
+          }
           m.primitives.resize(primCount);
-          for (auto &p : m.primitives) {
-            readVec(is, p.vertices);
-            readVec(is, p.indices);
-            readVal(is, p.materialIndex);
-            readVal(is, p.minPos);
-            readVal(is, p.maxPos);
-            uint64_t targetCount = 0;
-            readVal(is, targetCount);
-            p.targets.resize(targetCount);
-            for (auto &t : p.targets) {
-              readVec(is, t.positionDeltas);
-              readVec(is, t.normalDeltas);
+        }
+
+        // Read-only istream over a mapped blob, for the stream-encoded sections.
+        class BlobStreamBuf : public std::streambuf {
+        public:
+          explicit BlobStreamBuf(std::span<const uint8_t> bytes) {
+            auto *begin = const_cast<char *>(reinterpret_cast<const char *>(bytes.data()));
+            setg(begin, begin, begin + bytes.size());
+          }
+        };
+
+        template <typename T, typename Serializer>
+        std::string serializeListBlob(const std::vector<T> &list, Serializer serializer) {
+          std::ostringstream os(std::ios::binary);
+          writeVal(os, static_cast<uint64_t>(list.size()));
+          for (const auto &item : list) {
+            serializer(os, item);
+          }
+          return std::move(os).str();
+        }
+
+        template <typename T, typename Deserializer>
+        bool deserializeListBlob(std::span<const uint8_t> bytes, Deserializer deserializer,
+                                 std::vector<T> &list) {
+          BlobStreamBuf buf(bytes);
+          std::istream is(&buf);
+          uint64_t count = 0;
+          readVal(is, count);
+          if (!is || count > bytes.size()) {
+            return false;
+          }
+          list.resize(count);
+          for (auto &item : list) {
+            deserializer(is, item);
+            if (!is) {
+              return false;
             }
           }
+          return true;
         }
 
         void serializeImportedNode(std::ostream &os, const ImportedNode &n) {
@@ -292,120 +332,360 @@ namespace pnkr::renderer::io
 
     bool ModelSerializer::savePMESH(const assets::ImportedModel& model, const std::filesystem::path& path)
     {
-        CacheWriter writer(path.string());
-        if (!writer.isOpen()) {
-          return false;
+        PNKR_PROFILE_FUNCTION();
+
+        std::vector<pmesh::PrimitiveRecord> prims;
+        std::vector<pmesh::MorphTargetRecord> targets;
+        std::vector<pmesh::LodRecord> lods;
+        std::vector<pmesh::MeshletRecord> meshlets;
+        uint64_t vertexCount = 0;
+        uint64_t indexCount = 0;
+        uint64_t deltaCount = 0;
+        uint64_t lodIndexCount = 0;
+        for (size_t meshIdx = 0; meshIdx < model.meshes.size(); ++meshIdx) {
+            for (const auto& p : model.meshes[meshIdx].primitives) {
+                pmesh::PrimitiveRecord rec{};
+                rec.meshIndex = util::u32(meshIdx);
+                rec.materialIndex = p.materialIndex;
+                rec.firstVertex = vertexCount;
+                rec.firstIndex = indexCount;
+                rec.vertexCount = util::u32(p.vertexData().size());
+                rec.indexCount = util::u32(p.indexData().size());
+                rec.minPos = p.minPos;
+                rec.maxPos = p.maxPos;
+                rec.firstTarget = util::u32(targets.size());
+                rec.targetCount = util::u32(p.targets.size());
+                for (const auto& t : p.targets) {
+                    targets.push_back({.firstDelta = deltaCount,
+                                       .positionCount = util::u32(t.positionDeltas.size()),
+                                       .normalCount = util::u32(t.normalDeltas.size()),
+                                       .tangentCount = util::u32(t.tangentDeltas.size())});
+                    deltaCount += t.positionDeltas.size() + t.normalDeltas.size() + t.tangentDeltas.size();
+                }
+                for (const auto& lod : p.lods) {
+                    lods.push_back({.primitive = util::u32(prims.size()),
+                                    .indexCount = lod.indexCount,
+                                    .firstIndex = lodIndexCount + lod.firstIndex,
+                                    .error = lod.error});
+                }
+                for (const auto& m : p.meshlets) {
+                    meshlets.push_back({.primitive = util::u32(prims.size()),
+                                        .firstIndex = m.firstIndex,
+                                        .indexCount = m.indexCount,
+                                        .coneCutoff = m.coneCutoff,
+                                        .center = m.center,
+                                        .radius = m.radius,
+                                        .coneApex = m.coneApex,
+                                        .coneAxis = m.coneAxis});
+                }
+                vertexCount += rec.vertexCount;
+                indexCount += rec.indexCount;
+                lodIndexCount += p.lodIndexData().size();
+                prims.push_back(rec);
+            }
         }
 
-        writer.setHeaderVersion(PMESH_VERSION);
-
-        auto serializeList = [&](uint32_t fcc, auto serializer, const auto& list) {
-            uint64_t count = list.size();
-            size_t headerPos = 0;
-            writer.beginChunk(fcc, 1, headerPos);
+        struct PendingSection {
+            pmesh::Section section;
+            std::function<void(std::ostream&)> write;
+        };
+        std::vector<PendingSection> sections;
 
-            writeVal(writer.getStream(), count);
-            for (const auto &item : list) {
-              serializer(writer.getStream(), item);
+        auto addBlob = [&](const char* fcc, uint32_t elementSize, uint64_t sizeBytes,
+                           std::function<void(std::ostream&)> write) {
+            sections.push_back({.section = {.fourcc = makeFourCC(fcc), .elementSize = elementSize, .sizeBytes = sizeBytes},
+                                .write = std::move(write)});
+        };
+        auto addStream = [&](const char* fcc, std::string blob) {
+            const uint64_t size = blob.size();
+            addBlob(fcc, 0, size, [blob = std::move(blob)](std::ostream& os) { os.write(blob.data(), blob.size()); });
+        };
+        auto addArray = [&]<typename T>(const char* fcc, const std::vector<T>& data) {
+            static_assert(std::is_trivially_copyable_v<T>, "PMESH array sections must be trivially copyable");
+            addBlob(fcc, sizeof(T), data.size() * sizeof(T), [&data](std::ostream& os) {
+                os.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+            });
+        };
+        auto forEachPrimitive = [&model](auto&& func) {
+            for (const auto& mesh : model.meshes) {
+                for (const auto& p : mesh.primitives) {
+                    func(p);
+                }
             }
-
-            writer.endChunk(headerPos);
         };
 
-        serializeList(makeFourCC("TEXS"), serializeImportedTexture, model.textures);
-        writer.writeChunk(makeFourCC("MATS"), 1, model.materials);
-        serializeList(makeFourCC("MESH"), serializeImportedMesh, model.meshes);
-        serializeList(makeFourCC("NODE"), serializeImportedNode, model.nodes);
-        serializeList(makeFourCC("ANIM"), serializeAnimation, model.animations);
-        serializeList(makeFourCC("SKIN"), serializeSkin, model.skins);
-        serializeList(makeFourCC("LIGT"), serializeLight, model.lights);
-        serializeList(makeFourCC("CAMS"), serializeCamera, model.cameras);
-        writer.writeChunk(makeFourCC("ROOT"), 1, model.rootNodes);
+        static_assert(std::is_trivially_copyable_v<Vertex>, "Vertex must be trivially copyable for serialization");
+        addStream("TEXS", serializeListBlob(model.textures, serializeImportedTexture));
+        addArray("MATS", model.materials);
+        addStream("MESH", serializeListBlob(model.meshes, serializeMeshHeader));
+        addArray("PRIM", prims);
+        addBlob("VERT", sizeof(Vertex), vertexCount * sizeof(Vertex), [&](std::ostream& os) {
+            forEachPrimitive([&](const ImportedPrimitive& p) {
+                const auto bytes = std::as_bytes(p.vertexData());
+                os.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            });
+        });
+        addBlob("INDX", sizeof(uint32_t), indexCount * sizeof(uint32_t), [&](std::ostream& os) {
+            forEachPrimitive([&](const ImportedPrimitive& p) {
+                const auto bytes = std::as_bytes(p.indexData());
+                os.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            });
+        });
+        addArray("LODS", lods);
+        addBlob("LIDX", sizeof(uint32_t), lodIndexCount * sizeof(uint32_t), [&](std::ostream& os) {
+            forEachPrimitive([&](const ImportedPrimitive& p) {
+                const auto bytes = std::as_bytes(p.lodIndexData());
+                os.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            });
+        });
+        addArray("MSHL", meshlets);
+        addArray("MTGT", targets);
+        addBlob("MDLT", sizeof(glm::vec3), deltaCount * sizeof(glm::vec3), [&](std::ostream& os) {
+            forEachPrimitive([&](const ImportedPrimitive& p) {
+                for (const auto& t : p.targets) {
+                    for (const auto* deltas : {&t.positionDeltas, &t.normalDeltas, &t.tangentDeltas}) {
+                        os.write(reinterpret_cast<const char*>(deltas->data()), deltas->size() * sizeof(glm::vec3));
+                    }
+                }
+            });
+        });
+        addStream("NODE", serializeListBlob(model.nodes, serializeImportedNode));
+        addStream("ANIM", serializeListBlob(model.animations, serializeAnimation));
+        addStream("SKIN", serializeListBlob(model.skins, serializeSkin));
+        addStream("LIGT", serializeListBlob(model.lights, serializeLight));
+        addStream("CAMS", serializeListBlob(model.cameras, serializeCamera));
+        addArray("ROOT", model.rootNodes);
+        if (model.meshesOptimized) {
+            addBlob("OPTM", 0, 0, [](std::ostream&) {});
+        }
 
-        return true;
+        pmesh::FileHeader header{};
+        header.sectionCount = util::u32(sections.size());
+        header.vertexSize = sizeof(Vertex);
+        uint64_t offset = pmesh::alignBlob(sizeof(header) + sections.size() * sizeof(pmesh::Section));
+        for (auto& s : sections) {
+            s.section.offset = offset;
+            offset = pmesh::alignBlob(offset + s.section.sizeBytes);
+        }
+        header.fileSize = offset;
+
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        if (!os) {
+            return false;
+        }
+
+        writeVal(os, header);
+        for (const auto& s : sections) {
+            writeVal(os, s.section);
+        }
+
+        static constexpr char kZeros[pmesh::kBlobAlignment] = {};
+        uint64_t pos = sizeof(header) + sections.size() * sizeof(pmesh::Section);
+        for (const auto& s : sections) {
+            os.write(kZeros, static_cast<std::streamsize>(s.section.offset - pos));
+            s.write(os);
+            pos = s.section.offset + s.section.sizeBytes;
+        }
+        os.write(kZeros, static_cast<std::streamsize>(header.fileSize - pos));
+        return static_cast<bool>(os);
     }
 
     bool ModelSerializer::loadPMESH(assets::ImportedModel& model, const std::filesystem::path& path)
     {
-        CacheReader reader(path.string());
-        if (!reader.isOpen()) {
-          return false;
+        PNKR_PROFILE_FUNCTION();
+
+        auto file = std::make_shared<MemoryMappedFile>(path);
+        if (!file->isValid() || file->size() < sizeof(pmesh::FileHeader)) {
+            return false;
         }
 
-        if (reader.header().version != PMESH_VERSION) {
-            core::Logger::Asset.warn("PMESH version mismatch for {}: expected {}, got {}",
-                               path.string(), PMESH_VERSION, reader.header().version);
+        pmesh::FileHeader header{};
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.magic != pmesh::kMagic || header.version != pmesh::kVersion ||
+            header.vertexSize != sizeof(Vertex)) {
+            core::Logger::Asset.warn("PMESH cache {} is not a v{} cache, re-importing",
+                                     path.string(), pmesh::kVersion);
             return false;
         }
 
-        auto chunks = reader.listChunks();
-        if (!reader.isValid() || chunks.empty()) {
-            core::Logger::Asset.error("PMESH cache corrupted or empty, deleting: {}", path.string());
+        auto discard = [&](const char* reason) {
+            core::Logger::Asset.error("PMESH cache '{}' is corrupted ({}). Deleting...", path.string(), reason);
+            model = {};
+            file.reset();
             std::error_code ec;
-            reader.getStream().close();
             std::filesystem::remove(path, ec);
             return false;
+        };
+
+        const uint64_t fileSize = file->size();
+        const uint64_t tableEnd = sizeof(header) + static_cast<uint64_t>(header.sectionCount) * sizeof(pmesh::Section);
+        if (header.fileSize != fileSize || tableEnd > fileSize) {
+            return discard("truncated");
         }
 
-        auto deserializeList = [&](const auto& chunk, auto deserializer, auto& list) -> bool {
-            auto& stream = reader.getStream();
-            stream.seekg(chunk.offset + sizeof(ChunkHeader));
-            uint64_t count = 0;
-            readVal(stream, count);
-            if (!stream) {
-              return false;
+        const std::span<const pmesh::Section> sections(
+            reinterpret_cast<const pmesh::Section*>(file->data() + sizeof(header)), header.sectionCount);
+        for (const auto& s : sections) {
+            if (s.offset % pmesh::kBlobAlignment != 0 || s.offset < tableEnd ||
+                s.sizeBytes > fileSize || s.offset > fileSize - s.sizeBytes) {
+                return discard("section out of bounds");
             }
-            list.resize(count);
-            for (auto& item : list) {
-                deserializer(stream, item);
-                if (!stream) {
-                  return false;
-                }
+        }
+
+        auto find = [&](const char* fcc) -> const pmesh::Section* {
+            const uint32_t fourcc = makeFourCC(fcc);
+            const auto it = std::ranges::find(sections, fourcc, &pmesh::Section::fourcc);
+            return it != sections.end() ? &*it : nullptr;
+        };
+        auto arrayOf = [&]<typename T>(const char* fcc, std::span<const T>& out) {
+            out = {};
+            const auto* s = find(fcc);
+            if (s == nullptr) {
+                return true;
             }
+            if (s->elementSize != sizeof(T) || s->sizeBytes % sizeof(T) != 0) {
+                return false;
+            }
+            out = {reinterpret_cast<const T*>(file->data() + s->offset), static_cast<size_t>(s->sizeBytes / sizeof(T))};
             return true;
         };
+        auto readList = [&](const char* fcc, auto deserializer, auto& list) {
+            const auto* s = find(fcc);
+            return s == nullptr ||
+                   deserializeListBlob(std::span(file->data() + s->offset, s->sizeBytes), deserializer, list);
+        };
 
-        bool success = true;
-        for (const auto& c : chunks) {
-            uint32_t fcc = c.header.fourcc;
-            bool chunkOk = true;
-            if (fcc == makeFourCC("TEXS")) {
-              chunkOk = deserializeList(c, deserializeImportedTexture,
-                                        model.textures);
-            } else if (fcc == makeFourCC("MATS")) {
-              chunkOk = reader.readChunk(c, model.materials);
-            } else if (fcc == makeFourCC("MESH")) {
-              chunkOk =
-                  deserializeList(c, deserializeImportedMesh, model.meshes);
-            } else if (fcc == makeFourCC("NODE")) {
-              chunkOk =
-                  deserializeList(c, deserializeImportedNode, model.nodes);
-            } else if (fcc == makeFourCC("ANIM")) {
-              chunkOk =
-                  deserializeList(c, deserializeAnimation, model.animations);
-            } else if (fcc == makeFourCC("SKIN")) {
-              chunkOk = deserializeList(c, deserializeSkin, model.skins);
-            } else if (fcc == makeFourCC("LIGT")) {
-              chunkOk = deserializeList(c, deserializeLight, model.lights);
-            } else if (fcc == makeFourCC("CAMS")) {
-              chunkOk = deserializeList(c, deserializeCamera, model.cameras);
-            } else if (fcc == makeFourCC("ROOT")) {
-              chunkOk = reader.readChunk(c, model.rootNodes);
-            }
-            if (!chunkOk) {
-                success = false;
-                break;
-            }
+        std::span<const ImportedMaterial> materials;
+        std::span<const pmesh::PrimitiveRecord> prims;
+        std::span<const Vertex> vertices;
+        std::span<const uint32_t> indices;
+        std::span<const pmesh::MorphTargetRecord> targets;
+        std::span<const glm::vec3> deltas;
+        std::span<const int> roots;
+        std::span<const pmesh::LodRecord> lods;
+        std::span<const uint32_t> lodIndices;
+        std::span<const pmesh::MeshletRecord> meshlets;
+        if (!arrayOf("MATS", materials) || !arrayOf("PRIM", prims) || !arrayOf("VERT", vertices) ||
+            !arrayOf("INDX", indices) || !arrayOf("MTGT", targets) || !arrayOf("MDLT", deltas) ||
+            !arrayOf("ROOT", roots) || !arrayOf("LODS", lods) || !arrayOf("LIDX", lodIndices) ||
+            !arrayOf("MSHL", meshlets)) {
+            return discard("element size mismatch");
         }
 
-        if (!success) {
-            core::Logger::Asset.error("PMESH cache '{}' is obsolete or corrupted. Deleting...", path.string());
-            std::error_code ec;
-            reader.getStream().close();
-            std::filesystem::remove(path, ec);
-            return false;
+        // Start paging geometry in while the metadata is parsed.
+        if (const auto* s = find("VERT")) {
+            file->prefetch(s->offset, s->sizeBytes);
+        }
+        if (const auto* s = find("INDX")) {
+            file->prefetch(s->offset, s->sizeBytes);
+        }
+
+        const bool listsOk = readList("TEXS", deserializeImportedTexture, model.textures) &&
+                             readList("MESH", deserializeMeshHeader, model.meshes) &&
+                             readList("NODE", deserializeImportedNode, model.nodes) &&
+                             readList("ANIM", deserializeAnimation, model.animations) &&
+                             readList("SKIN", deserializeSkin, model.skins) &&
+                             readList("LIGT", deserializeLight, model.lights) &&
+                             readList("CAMS", deserializeCamera, model.cameras);
+        if (!listsOk) {
+            return discard("bad metadata");
+        }
+        model.materials.assign(materials.begin(), materials.end());
+        model.rootNodes.assign(roots.begin(), roots.end());
+        model.meshesOptimized = find("OPTM") != nullptr;
+
+        size_t primCursor = 0;
+        size_t lodCursor = 0;
+        size_t meshletCursor = 0;
+        for (size_t meshIdx = 0; meshIdx < model.meshes.size(); ++meshIdx) {
+            for (auto& p : model.meshes[meshIdx].primitives) {
+                if (primCursor >= prims.size()) {
+                    return discard("missing primitives");
+                }
+                const auto& rec = prims[primCursor++];
+                if (rec.meshIndex != meshIdx ||
+                    rec.firstVertex + rec.vertexCount > vertices.size() ||
+                    rec.firstIndex + rec.indexCount > indices.size() ||
+                    static_cast<size_t>(rec.firstTarget) + rec.targetCount > targets.size()) {
+                    return discard("primitive out of bounds");
+                }
+
+                p.materialIndex = rec.materialIndex;
+                p.minPos = rec.minPos;
+                p.maxPos = rec.maxPos;
+                p.mappedVertices = vertices.subspan(rec.firstVertex, rec.vertexCount);
+                p.mappedIndices = indices.subspan(rec.firstIndex, rec.indexCount);
+
+                // The primitive's LOD indices are contiguous in LIDX.
+                const size_t primIndex = primCursor - 1;
+                const size_t firstLod = lodCursor;
+                while (lodCursor < lods.size() && lods[lodCursor].primitive == primIndex) {
+                    ++lodCursor;
+                }
+                if (lodCursor - firstLod >= kMaxPrimitiveLods) {
+                    return discard("too many LODs");
+                }
+                if (lodCursor > firstLod) {
+                    const uint64_t lodBase = lods[firstLod].firstIndex;
+                    uint64_t lodEnd = lodBase;
+                    p.lods.clear();
+                    for (size_t l = firstLod; l < lodCursor; ++l) {
+                        const auto& lr = lods[l];
+                        if (lr.firstIndex < lodBase || lr.firstIndex + lr.indexCount > lodIndices.size()) {
+                            return discard("LOD out of bounds");
+                        }
+                        lodEnd = std::max(lodEnd, lr.firstIndex + lr.indexCount);
+                        p.lods.push_back({.firstIndex = util::u32(lr.firstIndex - lodBase),
+                                          .indexCount = lr.indexCount,
+                                          .error = lr.error});
+                    }
+                    p.mappedLodIndices = lodIndices.subspan(lodBase, lodEnd - lodBase);
+                }
+
+                p.meshlets.clear();
+                for (; meshletCursor < meshlets.size() && meshlets[meshletCursor].primitive == primIndex;
+                     ++meshletCursor) {
+                    const auto& mr = meshlets[meshletCursor];
+                    if (uint64_t(mr.firstIndex) + mr.indexCount > rec.indexCount) {
+                        return discard("meshlet out of bounds");
+                    }
+                    p.meshlets.push_back({.firstIndex = mr.firstIndex,
+                                          .indexCount = mr.indexCount,
+                                          .center = mr.center,
+                                          .radius = mr.radius,
+                                          .coneApex = mr.coneApex,
+                                          .coneAxis = mr.coneAxis,
+                                          .coneCutoff = mr.coneCutoff});
+                }
+
+                p.targets.resize(rec.targetCount);
+                for (uint32_t t = 0; t < rec.targetCount; ++t) {
+                    const auto& tr = targets[rec.firstTarget + t];
+                    const uint64_t count = uint64_t(tr.positionCount) + tr.normalCount + tr.tangentCount;
+                    if (tr.firstDelta + count > deltas.size()) {
+                        return discard("morph target out of bounds");
+                    }
+                    auto d = deltas.subspan(tr.firstDelta, count);
+                    auto& target = p.targets[t];
+                    target.positionDeltas.assign(d.begin(), d.begin() + tr.positionCount);
+                    d = d.subspan(tr.positionCount);
+                    target.normalDeltas.assign(d.begin(), d.begin() + tr.normalCount);
+                    d = d.subspan(tr.normalCount);
+                    target.tangentDeltas.assign(d.begin(), d.end());
+                }
+            }
+        }
+        if (primCursor != prims.size()) {
+            return discard("unreferenced primitives");
+        }
+        if (lodCursor != lods.size()) {
+            return discard("unreferenced LODs");
+        }
+        if (meshletCursor != meshlets.size()) {
+            return discard("unreferenced meshlets");
         }
 
+        model.mappedFile = std::move(file);
         return true;
     }
 
@@ -587,6 +867,9 @@ namespace pnkr::renderer::io
         writer.writeChunk(makeFourCC("TXMD"), 1, texMeta);
 
         auto& reg = model.scene().registry();
+        // The component chunks are the sparse sets' dense arrays as stored.
+        PNKR_ASSERT(reg.storageMode() == ecs::StorageMode::SparseSet,
+                    "ModelDOD caches require sparse set storage");
         writer.writeSparseSet(makeFourCC("SLOC"), 1, reg.getPool<LocalTransform>());
         writer.writeSparseSet(makeFourCC("SGLO"), 1, reg.getPool<WorldTransform>());
         writer.writeSparseSet(makeFourCC("SHIE"), 1, reg.getPool<Relationship>());
@@ -615,7 +898,7 @@ namespace pnkr::renderer::io
             }
         }
         writer.writeChunk(makeFourCC("MRNG"), 1, meshRanges);
-        writer.writeChunk(makeFourCC("MPRI"), 1, allPrims);
+        writer.writeChunk(makeFourCC("MPRI"), 3, allPrims);
         writer.writeStringListChunk(makeFourCC("MNAM"), 1, meshNames);
 
         auto serializeList = [&](uint32_t fcc, auto serializer, const auto& list) {
@@ -640,6 +923,7 @@ namespace pnkr::renderer::io
         writer.writeChunk(makeFourCC("INDXS"), 1, model.cpuIndicesMutable());
 
         writer.writeChunk(makeFourCC("MBND"), 1, model.meshBoundsMutable());
+        writer.writeChunk(makeFourCC("MSLT"), 1, model.meshletsMutable());
 
         const auto& morphInfos = model.morphTargetInfos();
         {
@@ -674,6 +958,9 @@ namespace pnkr::renderer::io
                 "ModelDOD cache corrupted or empty: " + path.string());
         }
 
+        PNKR_ASSERT(model.scene().registry().storageMode() == ecs::StorageMode::SparseSet,
+                    "ModelDOD caches require sparse set storage");
+
         std::vector<MaterialCPU> matsCPU;
         std::vector<MeshRange> meshRanges;
         std::vector<PrimitiveDOD> allPrims;
@@ -751,7 +1038,31 @@ namespace pnkr::renderer::io
             } else if (fcc == makeFourCC("MRNG")) {
               success &= reader.readChunk(c, meshRanges);
             } else if (fcc == makeFourCC("MPRI")) {
-              success &= reader.readChunk(c, allPrims);
+              if (c.header.version == 1) {
+                std::vector<PrimitiveDODV1> legacy;
+                success &= reader.readChunk(c, legacy);
+                allPrims.resize(legacy.size());
+                for (size_t i = 0; i < legacy.size(); ++i) {
+                  allPrims[i] = {.firstIndex = legacy[i].firstIndex,
+                                 .indexCount = legacy[i].indexCount,
+                                 .vertexOffset = legacy[i].vertexOffset,
+                                 .materialIndex = legacy[i].materialIndex};
+                }
+              } else if (c.header.version == 2) {
+                std::vector<PrimitiveDODV2> legacy;
+                success &= reader.readChunk(c, legacy);
+                allPrims.resize(legacy.size());
+                for (size_t i = 0; i < legacy.size(); ++i) {
+                  allPrims[i] = {.firstIndex = legacy[i].base.firstIndex,
+                                 .indexCount = legacy[i].base.indexCount,
+                                 .vertexOffset = legacy[i].base.vertexOffset,
+                                 .materialIndex = legacy[i].base.materialIndex,
+                                 .lodCount = legacy[i].lodCount,
+                                 .lods = legacy[i].lods};
+                }
+              } else {
+                success &= reader.readChunk(c, allPrims);
+              }
             } else if (fcc == makeFourCC("MNAM")) {
               success &= reader.readStringListChunk(c, meshNames);
 
@@ -762,6 +1073,8 @@ namespace pnkr::renderer::io
               success &= reader.readChunk(c, model.cpuIndicesMutable());
             } else if (fcc == makeFourCC("MBND")) {
               success &= reader.readChunk(c, model.meshBoundsMutable());
+            } else if (fcc == makeFourCC("MSLT")) {
+              success &= reader.readChunk(c, model.meshletsMutable());
             } else if (fcc == makeFourCC("MORI")) {
 
               auto &stream = reader.getStream();
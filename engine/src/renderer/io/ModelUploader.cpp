@@ -7,6 +7,7 @@
 #include "pnkr/core/TaskSystem.hpp"
 
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
 #include <cstring>
 
 #include "pnkr/renderer/gpu_shared/SkinningShared.h"
@@ -17,7 +18,8 @@ namespace pnkr::renderer::io {
 
     std::unique_ptr<ModelDOD> ModelUploader::upload(
         RHIRenderer& renderer,
-        assets::ImportedModel&& source)
+        assets::ImportedModel&& source,
+        geometry::VertexFormat vertexFormat)
     {
         auto model = std::make_unique<ModelDOD>();
 
@@ -135,6 +137,7 @@ namespace pnkr::renderer::io {
         auto& globalIndices = model->cpuIndicesMutable();
         auto& meshes = model->meshesMutable();
         auto& meshBounds = model->meshBoundsMutable();
+        auto& meshlets = model->meshletsMutable();
         auto& morphInfos = model->morphTargetInfos();
         auto& morphStates = model->morphStates();
 
@@ -144,20 +147,25 @@ namespace pnkr::renderer::io {
         std::vector<size_t> meshVertexOffsets(meshCount);
         std::vector<size_t> meshIndexOffsets(meshCount);
         std::vector<uint32_t> meshVertexCounts(meshCount);
+        std::vector<size_t> meshMeshletOffsets(meshCount);
 
         size_t totalVertices = 0;
         size_t totalIndices = 0;
+        size_t totalMeshlets = 0;
 
         for (size_t meshIdx = 0; meshIdx < meshCount; ++meshIdx) {
             const auto& impMesh = source.meshes[meshIdx];
             meshVertexOffsets[meshIdx] = totalVertices;
             meshIndexOffsets[meshIdx] = totalIndices;
+            meshMeshletOffsets[meshIdx] = totalMeshlets;
 
             uint32_t meshVertexCount = 0;
             uint32_t meshIndexCount = 0;
             for (const auto& impPrim : impMesh.primitives) {
-                meshVertexCount += static_cast<uint32_t>(impPrim.vertices.size());
-                meshIndexCount += static_cast<uint32_t>(impPrim.indices.size());
+                meshVertexCount += static_cast<uint32_t>(impPrim.vertexData().size());
+                meshIndexCount += static_cast<uint32_t>(impPrim.indexData().size() +
+                                                        impPrim.lodIndexData().size());
+                totalMeshlets += impPrim.meshlets.size();
             }
 
             meshVertexCounts[meshIdx] = meshVertexCount;
@@ -167,6 +175,7 @@ namespace pnkr::renderer::io {
 
         globalVertices.resize(totalVertices);
         globalIndices.resize(totalIndices);
+        meshlets.resize(totalMeshlets);
         meshes.resize(meshCount);
         meshBounds.resize(meshCount);
         morphInfos.resize(meshCount);
@@ -189,6 +198,7 @@ namespace pnkr::renderer::io {
                         const size_t meshIndexStart = meshIndexOffsets[meshIdx];
                         size_t currentVOffset = meshVertexStart;
                         size_t currentIOffset = meshIndexStart;
+                        size_t currentMeshlet = meshMeshletOffsets[meshIdx];
 
                         for (size_t primIdx = 0; primIdx < impMesh.primitives.size(); ++primIdx) {
                             const auto& impPrim = impMesh.primitives[primIdx];
@@ -197,25 +207,54 @@ namespace pnkr::renderer::io {
                             primDOD.firstIndex = static_cast<uint32_t>(currentIOffset);
                             primDOD.vertexOffset = static_cast<int32_t>(currentVOffset);
                             primDOD.materialIndex = impPrim.materialIndex;
-                            primDOD.indexCount = static_cast<uint32_t>(impPrim.indices.size());
+                            // Straight from the mapped .pmesh on a cache hit.
+                            const auto vertices = impPrim.vertexData();
+                            const auto indices = impPrim.indexData();
+                            primDOD.indexCount = static_cast<uint32_t>(indices.size());
 
-                            if (!impPrim.vertices.empty()) {
+                            if (!vertices.empty()) {
                                 std::memcpy(globalVertices.data() + currentVOffset,
-                                            impPrim.vertices.data(),
-                                            impPrim.vertices.size() * sizeof(Vertex));
+                                            vertices.data(), vertices.size_bytes());
                             }
-                            if (!impPrim.indices.empty()) {
+                            if (!indices.empty()) {
                                 std::memcpy(globalIndices.data() + currentIOffset,
-                                            impPrim.indices.data(),
-                                            impPrim.indices.size() * sizeof(uint32_t));
+                                            indices.data(), indices.size_bytes());
+                            }
+
+                            // LOD indices follow the primitive's own.
+                            const auto lodIndices = impPrim.lodIndexData();
+                            const size_t lodBase = currentIOffset + indices.size();
+                            if (!lodIndices.empty()) {
+                                std::memcpy(globalIndices.data() + lodBase,
+                                            lodIndices.data(), lodIndices.size_bytes());
+                            }
+                            primDOD.lodCount = static_cast<uint32_t>(
+                                std::min<size_t>(impPrim.lods.size(), primDOD.lods.size()));
+                            for (uint32_t l = 0; l < primDOD.lodCount; ++l) {
+                                const auto& lod = impPrim.lods[l];
+                                primDOD.lods[l] = {
+                                    .firstIndex = static_cast<uint32_t>(lodBase + lod.firstIndex),
+                                    .indexCount = lod.indexCount,
+                                    .error = lod.error};
+                            }
+
+                            primDOD.firstMeshlet = static_cast<uint32_t>(currentMeshlet);
+                            primDOD.meshletCount = static_cast<uint32_t>(impPrim.meshlets.size());
+                            for (const auto& m : impPrim.meshlets) {
+                                meshlets[currentMeshlet++] = {
+                                    .sphere = glm::vec4(m.center, m.radius),
+                                    .coneApex = glm::vec4(m.coneApex, 0.0F),
+                                    .coneAxis = glm::vec4(m.coneAxis, m.coneCutoff),
+                                    .firstIndex = static_cast<uint32_t>(currentIOffset + m.firstIndex),
+                                    .indexCount = m.indexCount};
                             }
 
                             meshMin = glm::min(meshMin, impPrim.minPos);
                             meshMax = glm::max(meshMax, impPrim.maxPos);
                             hasBounds = true;
 
-                            currentVOffset += impPrim.vertices.size();
-                            currentIOffset += impPrim.indices.size();
+                            currentVOffset += vertices.size();
+                            currentIOffset += indices.size() + lodIndices.size();
                         }
 
                         const uint32_t meshVertexCount = meshVertexCounts[meshIdx];
@@ -272,7 +311,7 @@ namespace pnkr::renderer::io {
                         }
                       }
                     }
-                    currentPrimVOffset += (uint32_t)impPrim.vertices.size();
+                    currentPrimVOffset += (uint32_t)impPrim.vertexData().size();
                   }
                 }
             }
@@ -280,6 +319,13 @@ namespace pnkr::renderer::io {
             morphStates[meshIdx] = {};
         }
 
+        // Skins are attached after the scene graph is built, so the database
+        // cannot see them yet; skinned models keep the layout the skinning pass reads.
+        if (vertexFormat == geometry::VertexFormat::Compact && !source.skins.empty()) {
+            core::Logger::Asset.info("ModelUploader: skinned model, keeping the full vertex layout");
+            vertexFormat = geometry::VertexFormat::Full;
+        }
+        model->setVertexFormat(vertexFormat);
         model->uploadUnifiedBuffers(renderer);
 
         if (!allMorphVertices.empty()) {
@@ -384,6 +430,7 @@ namespace pnkr::renderer::io {
                 }
             }
         }
+        model->assets().invalidateCompiledAnimations();
 
         model->scene().recalculateGlobalTransformsFull();
 
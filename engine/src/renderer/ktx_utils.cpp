@@ -286,12 +286,18 @@ bool loadFromTexture(ktxTexture *texture, KTXTextureData &out,
 
       if (sanitizedLevelCount == std::max(1U, texture->numLevels)) {
         out.mipFileOffsets.resize(sanitizedLevelCount);
+        out.mipFileSizes.resize(sanitizedLevelCount);
+        out.mipUncompressedSizes.resize(sanitizedLevelCount);
+        out.supercompressionScheme =
+            reinterpret_cast<ktxTexture2 *>(texture)->supercompressionScheme;
         file.seekg(80);
 
         for (uint32_t i = 0; i < sanitizedLevelCount; ++i) {
           KTX2LevelIndexEntry entry{};
           file.read(reinterpret_cast<char *>(&entry), sizeof(entry));
           out.mipFileOffsets[i] = entry.m_byteOffset;
+          out.mipFileSizes[i] = entry.m_byteLength;
+          out.mipUncompressedSizes[i] = entry.m_uncompressedByteLength;
         }
         core::Logger::Asset.trace("KTX2 Partial I/O: Parsed {} levels for '{}'",
                                   sanitizedLevelCount, label);
@@ -430,18 +436,38 @@ uint64_t KTXUtils::getImageFileOffset(const KTXTextureData &data,
       return 0;
     }
 
-    uint64_t levelStart = data.mipFileOffsets[level];
-    size_t imageSize = ktxTexture_GetImageSize(data.texture, level);
-
-    uint32_t numFaces = data.texture->numFaces;
-    uint32_t numDepth = std::max(1U, data.texture->baseDepth >> level);
+    return data.mipFileOffsets[level] +
+           getImageOffsetInLevel(data, level, layer, face);
+  }
 
-    uint64_t imageIndex = (layer * (numFaces * numDepth)) + (face * numDepth);
+  return 0;
+}
 
-    return levelStart + (imageIndex * imageSize);
+uint64_t KTXUtils::getImageOffsetInLevel(const KTXTextureData &data,
+                                         uint32_t level, uint32_t layer,
+                                         uint32_t face) {
+  if (data.texture == nullptr) {
+    return 0;
   }
 
-  return 0;
+  size_t imageSize = ktxTexture_GetImageSize(data.texture, level);
+
+  uint32_t numFaces = data.texture->numFaces;
+  uint32_t numDepth = std::max(1U, data.texture->baseDepth >> level);
+
+  uint64_t imageIndex = (layer * (numFaces * numDepth)) + (face * numDepth);
+
+  return imageIndex * imageSize;
+}
+
+bool KTXUtils::isZstdStreamable(const KTXTextureData &data) {
+  if (data.texture == nullptr || data.texture->classId != ktxTexture2_c ||
+      data.supercompressionScheme != KTX_SS_ZSTD ||
+      data.mipFileSizes.size() != data.mipLevels) {
+    return false;
+  }
+  return ktxTexture2_NeedsTranscoding(
+             reinterpret_cast<ktxTexture2 *>(data.texture)) != KTX_TRUE;
 }
 
 rhi::Format KTXUtils::mapKtx2VkFormatToRhi(uint32_t vkFormat) {
@@ -467,6 +493,9 @@ KTXTextureData &KTXTextureData::operator=(KTXTextureData &&other) noexcept {
     dataSize = other.dataSize;
     ownedData = std::move(other.ownedData);
     mipFileOffsets = std::move(other.mipFileOffsets);
+    mipFileSizes = std::move(other.mipFileSizes);
+    mipUncompressedSizes = std::move(other.mipUncompressedSizes);
+    supercompressionScheme = other.supercompressionScheme;
 
     other.texture = nullptr;
     other.dataPtr = nullptr;
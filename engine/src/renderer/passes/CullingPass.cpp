@@ -16,6 +16,12 @@
 
 namespace pnkr::renderer
 {
+namespace {
+// maxComputeWorkGroupCount[0] every Vulkan device supports; the RHI does
+// not expose the device's own limit.
+constexpr uint32_t kMaxComputeGroupsX = 65535;
+} // namespace
+
 void CullingPass::init(RHIRenderer *renderer, uint32_t ,
                        uint32_t , ShaderHotReloader* hotReloader) {
   m_renderer = renderer;
@@ -39,21 +45,26 @@ void CullingPass::init(RHIRenderer *renderer, uint32_t ,
     }
   }
 
-  auto sCull =
-      rhi::Shader::load(rhi::ShaderStage::Compute, "shaders/culling.spv");
-  rhi::RHIPipelineBuilder builder;
-  auto desc =
-      builder.setComputeShader(sCull.get()).setName("GPU_Culling").buildCompute();
-  if (m_hotReloader != nullptr) {
-    ShaderSourceInfo source{
-        .path = "/shaders/renderer/indirect/culling.slang",
-        .entryPoint = "computeMain",
-        .stage = rhi::ShaderStage::Compute,
-        .dependencies = {}};
-    m_cullingPipeline = m_hotReloader->createComputePipeline(desc, source);
-  } else {
-    m_cullingPipeline = m_renderer->createComputePipeline(desc);
-  }
+  auto loadPipeline = [&](const char *spv, const char *name,
+                          const char *entryPoint) {
+    auto shader = rhi::Shader::load(rhi::ShaderStage::Compute, spv);
+    rhi::RHIPipelineBuilder builder;
+    auto desc =
+        builder.setComputeShader(shader.get()).setName(name).buildCompute();
+    if (m_hotReloader != nullptr) {
+      ShaderSourceInfo source{
+          .path = "/shaders/renderer/indirect/culling.slang",
+          .entryPoint = entryPoint,
+          .stage = rhi::ShaderStage::Compute,
+          .dependencies = {}};
+      return m_hotReloader->createComputePipeline(desc, source);
+    }
+    return m_renderer->createComputePipeline(desc);
+  };
+  m_cullingPipeline =
+      loadPipeline("shaders/culling.spv", "GPU_Culling", "computeMain");
+  m_clusterPipeline = loadPipeline("shaders/cluster_culling.spv",
+                                   "GPU_ClusterCulling", "clusterMain");
 
   uint32_t flightCount = m_renderer->getSwapchain()->framesInFlight();
   m_cullingResources.resize(flightCount);
@@ -76,6 +87,14 @@ void CullingPass::prepare(const RenderPassContext &ctx) {
 
   auto &res = m_cullingResources[ctx.frameIndex];
 
+  // Draws split into meshlets append one command per visible meshlet.
+  uint32_t meshletCount = 0;
+  uint32_t meshletCountDS = 0;
+  if (ctx.settings.clusterCulling) {
+    meshletCount = ctx.resources.drawLists->opaqueMeshletCount;
+    meshletCountDS = ctx.resources.drawLists->opaqueDoubleSidedMeshletCount;
+  }
+
   auto ensureCompactedBuffer = [&](GPUBufferSlice &slice, uint32_t count,
                                    const char *name) {
     const uint64_t outBytes =
@@ -104,12 +123,13 @@ void CullingPass::prepare(const RenderPassContext &ctx) {
   };
 
   if (drawCount > 0) {
-    ensureCompactedBuffer(ctx.frameBuffers.opaqueCompactedSlice, drawCount,
-                          "OpaqueCompactedBuffer");
+    ensureCompactedBuffer(ctx.frameBuffers.opaqueCompactedSlice,
+                          drawCount + meshletCount, "OpaqueCompactedBuffer");
   }
   if (drawCountDS > 0) {
     ensureCompactedBuffer(ctx.frameBuffers.opaqueDoubleSidedCompactedSlice,
-                          drawCountDS, "OpaqueDSCompactedBuffer");
+                          drawCountDS + meshletCountDS,
+                          "OpaqueDSCompactedBuffer");
   }
 
   auto
@@ -175,11 +195,88 @@ void CullingPass::prepare(const RenderPassContext &ctx) {
                  "WorldBoundsDSBuffer");
   }
 
+  // The shader re-selects each draw's LOD from its chain; without chains
+  // it keeps the command the batcher chose.
+  auto uploadLods = [&](BufferPtr &buf, const gpu::DrawLodGPU *lods,
+                        uint32_t count, const char *name) {
+    if (lods == nullptr) {
+      buf = {};
+      return;
+    }
+    const uint64_t bytes = (uint64_t)count * sizeof(gpu::DrawLodGPU);
+    auto *lBuf =
+        (buf.isValid()) ? m_renderer->getBuffer(buf.handle()) : nullptr;
+    if (!buf.isValid() || !lBuf || lBuf->size() < bytes) {
+      buf = m_renderer->createBuffer(
+          name, {.size = bytes,
+                 .usage = rhi::BufferUsage::StorageBuffer |
+                          rhi::BufferUsage::ShaderDeviceAddress,
+                 .memoryUsage = rhi::MemoryUsage::CPUToGPU,
+                 .debugName = name});
+      lBuf = m_renderer->getBuffer(buf.handle());
+    }
+
+    if (lBuf && bytes > 0) {
+      lBuf->uploadData(
+          std::span(reinterpret_cast<const std::byte *>(lods), bytes));
+    }
+  };
+
+  if (drawCount > 0) {
+    uploadLods(res.lodBuffer, ctx.resources.drawLists->opaqueLods, drawCount,
+               "CullingLodBuffer");
+  }
+  if (drawCountDS > 0) {
+    uploadLods(res.lodBufferDoubleSided,
+               ctx.resources.drawLists->opaqueDoubleSidedLods, drawCountDS,
+               "CullingLodDSBuffer");
+  }
+
+  auto uploadMeshletDraws = [&](BufferPtr &buf,
+                                const gpu::MeshletDrawGPU *draws,
+                                uint32_t count, uint32_t meshlets,
+                                const char *name) {
+    if (draws == nullptr || meshlets == 0) {
+      buf = {};
+      return;
+    }
+    const uint64_t bytes = (uint64_t)count * sizeof(gpu::MeshletDrawGPU);
+    auto *mBuf =
+        (buf.isValid()) ? m_renderer->getBuffer(buf.handle()) : nullptr;
+    if (!buf.isValid() || !mBuf || mBuf->size() < bytes) {
+      buf = m_renderer->createBuffer(
+          name, {.size = bytes,
+                 .usage = rhi::BufferUsage::StorageBuffer |
+                          rhi::BufferUsage::ShaderDeviceAddress,
+                 .memoryUsage = rhi::MemoryUsage::CPUToGPU,
+                 .debugName = name});
+      mBuf = m_renderer->getBuffer(buf.handle());
+    }
+
+    if (mBuf && bytes > 0) {
+      mBuf->uploadData(
+          std::span(reinterpret_cast<const std::byte *>(draws), bytes));
+    }
+  };
+
+  if (drawCount > 0) {
+    uploadMeshletDraws(res.meshletDrawBuffer,
+                       ctx.resources.drawLists->opaqueMeshletDraws, drawCount,
+                       meshletCount, "CullingMeshletDrawBuffer");
+  }
+  if (drawCountDS > 0) {
+    uploadMeshletDraws(res.meshletDrawBufferDoubleSided,
+                       ctx.resources.drawLists->opaqueDoubleSidedMeshletDraws,
+                       drawCountDS, meshletCountDS,
+                       "CullingMeshletDrawDSBuffer");
+  }
+
   gpu::CullingData gpuData{};
   auto frustum =
       geometry::createFrustum(ctx.cullingViewProj);
   std::ranges::copy(frustum.planes, gpuData.frustumPlanes);
   std::ranges::copy(frustum.corners, gpuData.frustumCorners);
+  gpuData.cameraPos = glm::vec4(ctx.cullingCameraPos, 1.0f);
 
   auto
       uploadCullingData =
@@ -228,7 +325,9 @@ void CullingPass::prepare(const RenderPassContext &ctx) {
         auto cullBucket = [&](uint32_t count, const GPUBufferSlice &inSlice,
                               const GPUBufferSlice &outSlice,
                               BufferPtr &boundsBuf, BufferPtr &cullBuf,
-                              BufferPtr &visBuf) {
+                              BufferPtr &visBuf, BufferPtr &lodBuf,
+                              BufferPtr &meshletDrawBuf,
+                              uint32_t meshletCount) {
           if (count == 0) {
             return;
           }
@@ -250,7 +349,28 @@ void CullingPass::prepare(const RenderPassContext &ctx) {
               visBuf.isValid()
                   ? m_renderer->getBufferDeviceAddress(visBuf.handle())
                   : 0;
-          pushConstants.drawCount = count;
+          pushConstants.lods =
+              lodBuf.isValid()
+                  ? m_renderer->getBufferDeviceAddress(lodBuf.handle())
+                  : 0;
+          const bool clusters = meshletDrawBuf.isValid() &&
+                                ctx.model != nullptr &&
+                                m_clusterPipeline.isValid() &&
+                                ctx.model->meshletBuffer().isValid();
+          if (clusters) {
+            pushConstants.meshletDraws =
+                m_renderer->getBufferDeviceAddress(meshletDrawBuf.handle());
+            pushConstants.meshlets = m_renderer->getBufferDeviceAddress(
+                ctx.model->meshletBuffer().handle());
+            pushConstants.instances = ctx.instanceXformAddr;
+          }
+          pushConstants.drawCount = count + (clusters ? meshletCount : 0U);
+          // LODs follow the view the draw lists were built for, even when
+          // the culling view is frozen.
+          if (ctx.camera != nullptr) {
+            pushConstants.lodParams =
+                glm::vec4(ctx.camera->position(), dodLists->lodErrorScale);
+          }
 
           ctx.cmd->bindPipeline(
               m_renderer->getPipeline(m_cullingPipeline.handle()));
@@ -272,6 +392,20 @@ void CullingPass::prepare(const RenderPassContext &ctx) {
           }
 
           ctx.cmd->dispatch(groupCount, 1, 1);
+
+          // One group per draw expands the draws computeMain skipped. Both
+          // dispatches only append through the same counter, so they need
+          // no barrier between them. The groups fold into rows so large
+          // buckets stay under the per-dimension group count limit.
+          if (clusters) {
+            const uint32_t groupsX = std::min(count, kMaxComputeGroupsX);
+            const uint32_t groupsY = (count + groupsX - 1) / groupsX;
+            pushConstants.clusterGroupsX = groupsX;
+            ctx.cmd->bindPipeline(
+                m_renderer->getPipeline(m_clusterPipeline.handle()));
+            ctx.cmd->pushConstants(rhi::ShaderStage::Compute, pushConstants);
+            ctx.cmd->dispatch(groupsX, groupsY, 1);
+          }
         };
 
         cullBucket(dodLists->opaqueBoundsCount,
@@ -279,13 +413,19 @@ void CullingPass::prepare(const RenderPassContext &ctx) {
                    ctx.frameBuffers.opaqueCompactedSlice,
                    ctx.frameBuffers.gpuWorldBounds,
                    res.cullingBuffer,
-                   res.visibilityBuffer);
+                   res.visibilityBuffer,
+                   res.lodBuffer,
+                   res.meshletDrawBuffer,
+                   dodLists->opaqueMeshletCount);
 
         cullBucket(dodLists->opaqueDoubleSidedBoundsCount,
                    ctx.frameBuffers.indirectOpaqueDoubleSidedBuffer,
                    ctx.frameBuffers.opaqueDoubleSidedCompactedSlice,
                    ctx.frameBuffers.gpuWorldBoundsDoubleSided,
                    res.cullingBufferDoubleSided,
-                   res.visibilityBufferDoubleSided);
+                   res.visibilityBufferDoubleSided,
+                   res.lodBufferDoubleSided,
+                   res.meshletDrawBufferDoubleSided,
+                   dodLists->opaqueDoubleSidedMeshletCount);
     }
 }
@@ -264,9 +264,13 @@ namespace pnkr::renderer
           ctx.cmd->pushConstants(
               rhi::ShaderStage::Vertex | rhi::ShaderStage::Fragment, pc);
 
+          // Culling may expand draws into one command per meshlet.
           const uint32_t maxDrawCount =
               (ctx.resources.drawLists != nullptr)
-                  ? ctx.resources.drawLists->opaqueBoundsCount
+                  ? ctx.resources.drawLists->opaqueBoundsCount +
+                        (ctx.settings.clusterCulling
+                             ? ctx.resources.drawLists->opaqueMeshletCount
+                             : 0U)
                   : 0U;
 
           const auto &s = ctx.frameBuffers.opaqueCompactedSlice;
@@ -305,7 +309,11 @@ namespace pnkr::renderer
 
           const uint32_t maxDrawCountDS =
               (ctx.resources.drawLists != nullptr)
-                  ? ctx.resources.drawLists->opaqueDoubleSidedBoundsCount
+                  ? ctx.resources.drawLists->opaqueDoubleSidedBoundsCount +
+                        (ctx.settings.clusterCulling
+                             ? ctx.resources.drawLists
+                                   ->opaqueDoubleSidedMeshletCount
+                             : 0U)
                   : 0U;
 
           const auto &s = ctx.frameBuffers.opaqueDoubleSidedCompactedSlice;
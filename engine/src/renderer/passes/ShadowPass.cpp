@@ -12,6 +12,7 @@
 
 #include "pnkr/rhi/BindlessManager.hpp"
 #include "pnkr/renderer/geometry/Frustum.hpp"
+#include "pnkr/renderer/scene/Bounds.hpp"
 
 namespace pnkr::renderer
 {
@@ -233,25 +234,9 @@ namespace pnkr::renderer
                     // ============================================================
                     const auto& shadowSettings = ctx.settings.shadow;
 
-                    // Step 1: Compute world-space AABB of ALL shadow casters (cookbook style)
-                    // Transform each mesh's local bounds by its world transform, then combine
-                    scene::BoundingBox sceneAABB;
-                    const auto& meshBounds = ctx.model->meshBounds();
-                    
-                    auto meshView = scene.registry().view<scene::MeshRenderer, scene::WorldTransform>();
-                    meshView.each([&](ecs::Entity, const scene::MeshRenderer& mr, const scene::WorldTransform& wt)
-                    {
-                        if (mr.meshID >= 0 && static_cast<size_t>(mr.meshID) < meshBounds.size())
-                        {
-                            const auto& localBounds = meshBounds[mr.meshID];
-                            if (localBounds.isValid())
-                            {
-                                // Transform the 8 corners of local bounds to world space
-                                scene::BoundingBox worldBounds = scene::transformAabbFast(localBounds, wt.matrix);
-                                sceneAABB.combine(worldBounds);
-                            }
-                        }
-                    });
+                    // Step 1: World-space AABB of all shadow casters, from the
+                    // world bounds kept current by updateWorldBounds.
+                    scene::BoundingBox sceneAABB = scene::shadowCasterBounds(scene);
 
                     if (!sceneAABB.isValid())
                     {
@@ -251,6 +251,46 @@ void GPUProfilerImGui::draw(const char* windowName, GPUTimeQueriesManager* profi
               ImGui::TextColored(poolColor, "%.1f MB / %.1f MB (Budget)",
                                  s.streamingPoolUsed / (1024.0 * 1024.0),
                                  s.streamingPoolBudget / (1024.0 * 1024.0));
+              ImGui::Text("Stalls: %llu (%.1f ms) | Fragmentation: %.1f%%",
+                          (unsigned long long)s.stagingStalls, s.stagingStallMs,
+                          s.stagingFragmentationPercent);
+              ImGui::Text("Failed: %llu | Contention: %llu | Temp: %llu",
+                          (unsigned long long)s.stagingFailedReservations,
+                          (unsigned long long)s.stagingHeadRetries,
+                          (unsigned long long)s.temporaryStagingAllocations);
+
+              ImGui::Spacing();
+              ImGui::Text("Texture Residency");
+              ImGui::Separator();
+              ImGui::ProgressBar(s.textureResidencyBudget > 0
+                                     ? (float)s.textureResidentBytes /
+                                           s.textureResidencyBudget
+                                     : 0.0F,
+                                 ImVec2(-1, 0), "##TextureResidency");
+              ImVec4 residencyColor = s.residencyOverBudget
+                                          ? ImVec4(1, 0.3F, 0.3F, 1)
+                                          : ImVec4(0.3F, 1, 0.3F, 1);
+              ImGui::TextColored(residencyColor, "%.1f MB / %.1f MB (Budget)",
+                                 s.textureResidentBytes / (1024.0 * 1024.0),
+                                 s.textureResidencyBudget / (1024.0 * 1024.0));
+              ImGui::Text("Target: %.1f MB",
+                          s.textureTargetBytes / (1024.0 * 1024.0));
+              ImGui::Text("Streamed: %u | Demoted: %u", s.streamedTextures,
+                          s.texturesDemoted);
+              ImGui::Text("Mip Requests: %u", s.mipRequestsInFlight);
+
+              ImGui::Spacing();
+              ImGui::Text("File Reads (%s)", s.fileReaderBackend);
+              ImGui::Separator();
+              ImGui::Text("Read: %.2f MB | Avg Batch: %.2f ms",
+                          s.totalFileReadBytes / (1024.0 * 1024.0),
+                          s.avgFileReadTimeMs);
+              ImGui::Text("Syscalls/Batch: %.1f",
+                          s.fileReadBatches > 0
+                              ? double(s.fileReadSyscalls) / s.fileReadBatches
+                              : 0.0);
+              ImGui::Text("Inflated to Staging: %.2f MB",
+                          s.bytesInflatedTotal / (1024.0 * 1024.0));
 
               ImGui::Spacing();
               ImGui::Text("Transfer Thread");
@@ -258,6 +298,16 @@ void GPUProfilerImGui::draw(const char* windowName, GPUTimeQueriesManager* profi
               ImGui::Text("Utilization: %.1f%%", s.transferThreadUtilization);
               ImGui::Text("Batches: %u submitted", s.batchesSubmittedTotal);
               ImGui::Text("Avg Batch: %.2f MB", s.avgBatchSizeMB);
+              ImGui::Text("Pacing: %s | Budget: %.2f MB/frame | %.0f MB/s",
+                          s.uploadPacingAdaptive ? "Adaptive" : "Fixed",
+                          s.uploadFrameBudgetBytes / (1024.0 * 1024.0),
+                          s.uploadThroughputMBps);
+              ImGui::Text("Deferred: %llu | Copies: %llu (%.1f regions each)",
+                          (unsigned long long)s.uploadDeferredBatches,
+                          (unsigned long long)s.copyCommandsTotal,
+                          s.copyCommandsTotal > 0
+                              ? double(s.copyRegionsTotal) / s.copyCommandsTotal
+                              : 0.0);
               ImGui::Text("Failed: %u", s.failedLoads);
 
               if (s.activeTempBuffers > 0) {
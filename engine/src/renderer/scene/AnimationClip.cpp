@@ -0,0 +1,239 @@
+#include "pnkr/renderer/scene/AnimationClip.hpp"
+#include "pnkr/core/common.hpp"
+#include "pnkr/renderer/scene/Components.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace pnkr::renderer::scene
+{
+    namespace
+    {
+        // Keys stepped linearly before falling back to a binary search.
+        constexpr uint32_t kLinearProbe = 4;
+
+        uint32_t pathOrder(AnimationPath path)
+        {
+            return static_cast<uint32_t>(path);
+        }
+    }
+
+    CompiledAnimationClip CompiledAnimationClip::compile(const Animation& anim)
+    {
+        CompiledAnimationClip clip;
+        clip.m_duration = anim.duration;
+
+        auto usable = [&](const AnimationChannel& ch) {
+            return ch.samplerIndex >= 0 &&
+                   static_cast<size_t>(ch.samplerIndex) < anim.samplers.size() &&
+                   !anim.samplers[ch.samplerIndex].inputs.empty();
+        };
+
+        for (const auto& ch : anim.channels) {
+            if (ch.path != AnimationPath::Weights && usable(ch)) {
+                clip.m_targets.push_back(ch.targetNode);
+            }
+        }
+        std::ranges::sort(clip.m_targets);
+        auto duplicates = std::ranges::unique(clip.m_targets);
+        clip.m_targets.erase(duplicates.begin(), duplicates.end());
+        clip.m_channelMasks.assign(clip.m_targets.size(), 0);
+
+        // Group tracks by path so a batch mostly evaluates one kind of channel.
+        std::vector<uint32_t> order(anim.channels.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::ranges::stable_sort(order, {}, [&](uint32_t i) { return pathOrder(anim.channels[i].path); });
+
+        for (uint32_t channelIndex : order) {
+            const auto& ch = anim.channels[channelIndex];
+            if (!usable(ch)) {
+                continue;
+            }
+            const auto& sampler = anim.samplers[ch.samplerIndex];
+
+            AnimationTrack track;
+            track.path = ch.path;
+            track.interpolation = sampler.interpolation;
+            track.samplerIndex = ch.samplerIndex;
+            track.firstKey = util::u32(clip.m_times.size());
+            track.keyCount = util::u32(sampler.inputs.size());
+
+            if (ch.path == AnimationPath::Weights) {
+                track.target = ch.targetNode;
+            } else {
+                const size_t stride = sampler.interpolation == InterpolationType::CubicSpline ? 3 : 1;
+                const size_t valueCount = sampler.inputs.size() * stride;
+                if (sampler.outputs.size() < valueCount) {
+                    continue;
+                }
+
+                track.target = util::u32(std::distance(
+                    clip.m_targets.begin(), std::ranges::lower_bound(clip.m_targets, ch.targetNode)));
+                track.firstValue = util::u32(clip.m_valuesX.size());
+                for (size_t i = 0; i < valueCount; ++i) {
+                    const glm::vec4& v = sampler.outputs[i];
+                    clip.m_valuesX.push_back(v.x);
+                    clip.m_valuesY.push_back(v.y);
+                    clip.m_valuesZ.push_back(v.z);
+                    clip.m_valuesW.push_back(v.w);
+                }
+                clip.m_channelMasks[track.target] |= channelBit(ch.path);
+                ++clip.m_trsTrackCount;
+            }
+
+            clip.m_times.insert(clip.m_times.end(), sampler.inputs.begin(), sampler.inputs.end());
+            clip.m_tracks.push_back(track);
+        }
+
+        return clip;
+    }
+
+    void CompiledAnimationClip::bindCursor(AnimationCursor& cursor) const
+    {
+        if (cursor.clip != this || cursor.keys.size() != m_tracks.size()) {
+            cursor.keys.assign(m_tracks.size(), 0);
+            cursor.clip = this;
+        }
+    }
+
+    KeyframeSpan CompiledAnimationClip::locate(const AnimationTrack& track, float time,
+                                               uint32_t& cachedKey) const
+    {
+        const float* times = m_times.data() + track.firstKey;
+        const uint32_t last = track.keyCount - 1;
+        uint32_t k = std::min(cachedKey, last);
+
+        if (time < times[k]) {
+            // Looped or scrubbed backwards: search the keys before the cached one.
+            const float* it = std::upper_bound(times, times + k, time);
+            k = it == times ? 0 : util::u32(std::distance(times, it) - 1);
+        } else {
+            uint32_t steps = 0;
+            while (k < last && times[k + 1] <= time) {
+                ++k;
+                if (++steps == kLinearProbe) {
+                    const float* it = std::upper_bound(times + k, times + last + 1, time);
+                    k = util::u32(std::distance(times, it) - 1);
+                    break;
+                }
+            }
+        }
+        cachedKey = k;
+
+        KeyframeSpan span;
+        span.k0 = k;
+        span.k1 = std::min(k + 1, last);
+        span.dt = times[span.k1] - times[span.k0];
+        span.factor = span.dt > 0.0f ? std::clamp((time - times[span.k0]) / span.dt, 0.0f, 1.0f) : 0.0f;
+        return span;
+    }
+
+    void CompiledAnimationClip::sampleBatches(uint32_t firstBatch, uint32_t lastBatch, float time,
+                                              AnimationCursor& cursor,
+                                              std::span<LocalTRS* const> pose) const
+    {
+        constexpr uint32_t W = kBatchWidth;
+        const float* values[4] = {m_valuesX.data(), m_valuesY.data(), m_valuesZ.data(), m_valuesW.data()};
+
+        for (uint32_t batch = firstBatch; batch < lastBatch; ++batch) {
+            const uint32_t begin = batch * W;
+            const uint32_t lanes = std::min(W, m_trsTrackCount - begin);
+
+            // Every interpolation mode reduces to h00*p0 + h10*m0 + h01*p1 + h11*m1,
+            // so the per-lane work is just picking keys and weights; the combine
+            // below is uniform over all lanes and vectorizes.
+            alignas(32) float p0[4][W] = {};
+            alignas(32) float m0[4][W] = {};
+            alignas(32) float p1[4][W] = {};
+            alignas(32) float m1[4][W] = {};
+            alignas(32) float h00[W] = {};
+            alignas(32) float h10[W] = {};
+            alignas(32) float h01[W] = {};
+            alignas(32) float h11[W] = {};
+
+            for (uint32_t lane = 0; lane < lanes; ++lane) {
+                const AnimationTrack& track = m_tracks[begin + lane];
+                const KeyframeSpan span = locate(track, time, cursor.keys[begin + lane]);
+                const float t = span.factor;
+
+                if (track.interpolation == InterpolationType::CubicSpline) {
+                    const uint32_t i0 = track.firstValue + span.k0 * 3;
+                    const uint32_t i1 = track.firstValue + span.k1 * 3;
+                    for (int c = 0; c < 4; ++c) {
+                        p0[c][lane] = values[c][i0 + 1];
+                        m0[c][lane] = values[c][i0 + 2] * span.dt;
+                        p1[c][lane] = values[c][i1 + 1];
+                        m1[c][lane] = values[c][i1 + 0] * span.dt;
+                    }
+                    const float t2 = t * t;
+                    const float t3 = t2 * t;
+                    h00[lane] = 2.0f * t3 - 3.0f * t2 + 1.0f;
+                    h10[lane] = t3 - 2.0f * t2 + t;
+                    h01[lane] = -2.0f * t3 + 3.0f * t2;
+                    h11[lane] = t3 - t2;
+                    continue;
+                }
+
+                const uint32_t i0 = track.firstValue + span.k0;
+                const uint32_t i1 = track.firstValue + span.k1;
+                for (int c = 0; c < 4; ++c) {
+                    p0[c][lane] = values[c][i0];
+                    p1[c][lane] = values[c][i1];
+                }
+
+                if (track.interpolation == InterpolationType::Step) {
+                    h00[lane] = 1.0f;
+                } else if (track.path == AnimationPath::Rotation) {
+                    // Shortest-path slerp expressed as weights on the two keys.
+                    float cosTheta = p0[0][lane] * p1[0][lane] + p0[1][lane] * p1[1][lane] +
+                                     p0[2][lane] * p1[2][lane] + p0[3][lane] * p1[3][lane];
+                    const float sign = cosTheta < 0.0f ? -1.0f : 1.0f;
+                    cosTheta *= sign;
+                    if (cosTheta > 1.0f - std::numeric_limits<float>::epsilon()) {
+                        h00[lane] = 1.0f - t;
+                        h01[lane] = sign * t;
+                    } else {
+                        const float angle = std::acos(cosTheta);
+                        const float invSin = 1.0f / std::sin(angle);
+                        h00[lane] = std::sin((1.0f - t) * angle) * invSin;
+                        h01[lane] = sign * std::sin(t * angle) * invSin;
+                    }
+                } else {
+                    h00[lane] = 1.0f - t;
+                    h01[lane] = t;
+                }
+            }
+
+            alignas(32) float out[4][W];
+            for (int c = 0; c < 4; ++c) {
+                for (uint32_t lane = 0; lane < W; ++lane) {
+                    out[c][lane] = h00[lane] * p0[c][lane] + h10[lane] * m0[c][lane] +
+                                   h01[lane] * p1[c][lane] + h11[lane] * m1[c][lane];
+                }
+            }
+
+            for (uint32_t lane = 0; lane < lanes; ++lane) {
+                const AnimationTrack& track = m_tracks[begin + lane];
+                LocalTRS* trs = pose[track.target];
+                if (trs == nullptr) {
+                    continue;
+                }
+                const glm::vec3 v(out[0][lane], out[1][lane], out[2][lane]);
+                switch (track.path) {
+                case AnimationPath::Translation:
+                    trs->translation = v;
+                    break;
+                case AnimationPath::Rotation:
+                    trs->rotation = glm::normalize(glm::quat(out[3][lane], v.x, v.y, v.z));
+                    break;
+                case AnimationPath::Scale:
+                    trs->scale = v;
+                    break;
+                case AnimationPath::Weights:
+                    break;
+                }
+            }
+        }
+    }
+}
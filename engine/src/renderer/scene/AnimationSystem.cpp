@@ -3,22 +3,67 @@
 #include "pnkr/core/profiler.hpp"
 #include "pnkr/renderer/scene/Bounds.hpp"
 #include <algorithm>
-#include <array>
-#include <glm/gtx/compatibility.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <limits>
-#include <mutex>
-#include <set>
-#include <unordered_map>
 
+namespace pnkr::renderer::scene {
 namespace {
 constexpr uint32_t kAnimationParallelMinRange = 64;
-constexpr uint32_t kAnimationMutexCount = 256;
-std::array<std::mutex, kAnimationMutexCount> s_animationMutexes;
+// Minimum batches handed to one task; a batch is kBatchWidth tracks.
+constexpr uint32_t kAnimationBatchesPerTask = 8;
+
+// Per-thread scratch so steady-state playback does not allocate.
+thread_local std::vector<LocalTRS *> t_poseA;
+thread_local std::vector<LocalTRS *> t_poseB;
+thread_local std::vector<LocalTRS *> t_scratchA;
+thread_local std::vector<LocalTRS *> t_scratchB;
+thread_local std::vector<LocalTRS> t_sampledA;
+thread_local std::vector<LocalTRS> t_sampledB;
+
+void sampleClip(const CompiledAnimationClip &clip, float time,
+                AnimationCursor &cursor, std::span<LocalTRS *const> pose) {
+  clip.bindCursor(cursor);
+  const uint32_t batches = clip.batchCount();
+  if (core::TaskSystem::isInitialized() &&
+      clip.trsTrackCount() >= kAnimationParallelMinRange) {
+    core::TaskSystem::parallelFor(
+        batches,
+        [&](enki::TaskSetPartition range, uint32_t) {
+          clip.sampleBatches(range.start, range.end, time, cursor, pose);
+        },
+        kAnimationBatchesPerTask);
+  } else {
+    clip.sampleBatches(0, batches, time, cursor, pose);
+  }
+}
+
+// Seeds a scratch pose with the current component values so channels the
+// clip does not animate keep their value when blended.
+void seedScratch(std::span<LocalTRS *const> pose, std::vector<LocalTRS> &sampled,
+                 std::vector<LocalTRS *> &scratch) {
+  sampled.resize(pose.size());
+  scratch.resize(pose.size());
+  for (size_t i = 0; i < pose.size(); ++i) {
+    sampled[i] = pose[i] != nullptr ? *pose[i] : LocalTRS{};
+    scratch[i] = pose[i] != nullptr ? &sampled[i] : nullptr;
+  }
+}
 } // namespace
 
-namespace pnkr::renderer::scene {
+void AnimationSystem::advanceTime(AnimationState &state, float duration,
+                                  float dt) {
+  state.currentTime += dt;
+  if (state.currentTime > duration) {
+    if (state.isLooping) {
+      state.currentTime = std::fmod(state.currentTime, duration);
+    } else {
+      state.currentTime = duration;
+      state.isPlaying = false;
+    }
+  }
+}
+
 void AnimationSystem::update(ModelDOD &model, float dt) {
   PNKR_PROFILE_FUNCTION();
   auto &state = model.animationState();
@@ -29,18 +74,22 @@ void AnimationSystem::update(ModelDOD &model, float dt) {
     stateA.currentTime = state.currentTime;
     stateA.isLooping = state.isLooping;
     stateA.isPlaying = state.isPlaying;
+    stateA.cursor = std::move(state.cursor);
 
     AnimationState stateB;
     stateB.animIndex = state.animIndexB;
     stateB.currentTime = state.currentTimeB;
     stateB.isLooping = state.isLooping;
     stateB.isPlaying = true;
+    stateB.cursor = std::move(state.cursorB);
 
     updateBlending(model, stateA, stateB, state.blendWeight, dt);
 
     state.currentTime = stateA.currentTime;
     state.currentTimeB = stateB.currentTime;
     state.isPlaying = stateA.isPlaying;
+    state.cursor = std::move(stateA.cursor);
+    state.cursorB = std::move(stateB.cursor);
     return;
   }
 
@@ -48,25 +97,8 @@ void AnimationSystem::update(ModelDOD &model, float dt) {
     return;
   }
 
-  const auto &anim = model.animations()[state.animIndex];
-
-  state.currentTime += dt;
-  if (state.currentTime > anim.duration) {
-    if (state.isLooping) {
-      state.currentTime = std::fmod(state.currentTime, anim.duration);
-    } else {
-      state.currentTime = anim.duration;
-      state.isPlaying = false;
-    }
-  }
-
-  applyAnimation(model, anim, state.currentTime);
-
-  for (const auto &ch : anim.channels) {
-    model.scene().markAsChanged(ch.targetNode);
-  }
-
-  model.scene().setHierarchyDirty(true);
+  advanceTime(state, model.animations()[state.animIndex].duration, dt);
+  applyAnimation(model, state.animIndex, state.cursor, state.currentTime);
 }
 
 BoundingBox AnimationSystem::calculateSkinnedBounds(const ModelDOD &model) {
@@ -114,144 +146,187 @@ void AnimationSystem::updateBlending(ModelDOD &model, AnimationState &stateA,
     return;
   }
 
-  auto advance = [&](AnimationState &state, const Animation &anim) {
-    state.currentTime += dt;
-    if (state.currentTime > anim.duration) {
-      if (state.isLooping) {
-        state.currentTime = std::fmod(state.currentTime, anim.duration);
-      } else {
-        state.currentTime = anim.duration;
-        state.isPlaying = false;
-      }
-    }
-  };
+  if (hasA) {
+    advanceTime(stateA, model.animations()[stateA.animIndex].duration, dt);
+  }
+  if (hasB) {
+    advanceTime(stateB, model.animations()[stateB.animIndex].duration, dt);
+  }
 
   if (hasA && hasB) {
-    const auto &animA = model.animations()[stateA.animIndex];
-    const auto &animB = model.animations()[stateB.animIndex];
-    advance(stateA, animA);
-    advance(stateB, animB);
-    applyBlending(model, animA, stateA.currentTime, animB, stateB.currentTime,
+    applyBlending(model, stateA.animIndex, stateA.cursor, stateA.currentTime,
+                  stateB.animIndex, stateB.cursor, stateB.currentTime,
                   blendWeight);
   } else if (hasA) {
-    const auto &animA = model.animations()[stateA.animIndex];
-    advance(stateA, animA);
-    applyAnimation(model, animA, stateA.currentTime);
-    for (const auto &ch : animA.channels) {
-      model.scene().markAsChanged(ch.targetNode);
-    }
-  } else if (hasB) {
-    const auto &animB = model.animations()[stateB.animIndex];
-    advance(stateB, animB);
-    applyAnimation(model, animB, stateB.currentTime);
-    for (const auto &ch : animB.channels) {
-      model.scene().markAsChanged(ch.targetNode);
-    }
+    applyAnimation(model, stateA.animIndex, stateA.cursor, stateA.currentTime);
+  } else {
+    applyAnimation(model, stateB.animIndex, stateB.cursor, stateB.currentTime);
   }
+}
 
-  model.scene().setHierarchyDirty(true);
+void AnimationSystem::prepareTargets(SceneGraphDOD &scene,
+                                     const CompiledAnimationClip &clip) {
+  auto &registry = scene.registry();
+
+  // Decompose once when a node is first animated; afterwards LocalTRS holds
+  // the pose and syncEditedChannels() picks up outside edits.
+  for (uint32_t node : clip.targets()) {
+    if (registry.has<LocalTransform>(node) && !registry.has<LocalTRS>(node)) {
+      LocalTRS trs;
+      glm::vec3 skew;
+      glm::vec4 perspective;
+      glm::decompose(registry.get<LocalTransform>(node).matrix, trs.scale,
+                     trs.rotation, trs.translation, skew, perspective);
+      registry.emplace<LocalTRS>(node, trs);
+    }
+  }
 }
 
-void AnimationSystem::applyBlending(ModelDOD &model, const Animation &animA,
-                                    float timeA, const Animation &animB,
-                                    float timeB, float weight) {
-  auto &scene = model.scene();
+void AnimationSystem::bindTargets(SceneGraphDOD &scene,
+                                  const CompiledAnimationClip &clip,
+                                  std::vector<LocalTRS *> &pose) {
+  auto &registry = scene.registry();
+  const auto targets = clip.targets();
+  pose.resize(targets.size());
+  for (size_t i = 0; i < targets.size(); ++i) {
+    pose[i] = registry.has<LocalTRS>(targets[i])
+                  ? &registry.get<LocalTRS>(targets[i])
+                  : nullptr;
+  }
+}
 
-  struct NodeTRS {
-    glm::vec3 m_t{};
-    bool m_hasT = false;
-    glm::quat m_r{};
-    bool m_hasR = false;
-    glm::vec3 m_s{};
-    bool m_hasS = false;
-  };
-
-  std::unordered_map<uint32_t, NodeTRS> sampledA;
-  std::unordered_map<uint32_t, NodeTRS> sampledB;
-  std::set<uint32_t> affectedNodes;
-
-  for (const auto &ch : animA.channels) {
-    if (ch.path == AnimationPath::Weights) {
+void AnimationSystem::syncEditedChannels(SceneGraphDOD &scene,
+                                         const CompiledAnimationClip &clip,
+                                         std::span<LocalTRS *const> pose) {
+  auto &registry = scene.registry();
+  const auto targets = clip.targets();
+  const auto masks = clip.channelMasks();
+  for (size_t i = 0; i < targets.size(); ++i) {
+    LocalTRS *trs = pose[i];
+    if (trs == nullptr || masks[i] == CompiledAnimationClip::kAllChannels) {
       continue;
     }
-    auto &trs = sampledA[ch.targetNode];
-    const auto &sampler = animA.samplers[ch.samplerIndex];
-    if (ch.path == AnimationPath::Translation) {
-      trs.m_t = interpolateTranslation(sampler, timeA);
-      trs.m_hasT = true;
-    } else if (ch.path == AnimationPath::Rotation) {
-      trs.m_r = interpolateRotation(sampler, timeA);
-      trs.m_hasR = true;
-    } else if (ch.path == AnimationPath::Scale) {
-      trs.m_s = interpolateScale(sampler, timeA);
-      trs.m_hasS = true;
+    // Unchanged since the last commit wrote it, so nothing was edited.
+    const glm::mat4 &local = registry.get<LocalTransform>(targets[i]).matrix;
+    if (local == trs->toMatrix()) {
+      continue;
     }
-    affectedNodes.insert(ch.targetNode);
-  }
 
-  for (const auto &ch : animB.channels) {
-    if (ch.path == AnimationPath::Weights) {
-      continue;
+    LocalTRS edited;
+    glm::vec3 skew;
+    glm::vec4 perspective;
+    glm::decompose(local, edited.scale, edited.rotation, edited.translation,
+                   skew, perspective);
+    if ((masks[i] & CompiledAnimationClip::channelBit(
+                        AnimationPath::Translation)) == 0) {
+      trs->translation = edited.translation;
     }
-    auto &trs = sampledB[ch.targetNode];
-    const auto &sampler = animB.samplers[ch.samplerIndex];
-    if (ch.path == AnimationPath::Translation) {
-      trs.m_t = interpolateTranslation(sampler, timeB);
-      trs.m_hasT = true;
-    } else if (ch.path == AnimationPath::Rotation) {
-      trs.m_r = interpolateRotation(sampler, timeB);
-      trs.m_hasR = true;
-    } else if (ch.path == AnimationPath::Scale) {
-      trs.m_s = interpolateScale(sampler, timeB);
-      trs.m_hasS = true;
+    if ((masks[i] & CompiledAnimationClip::channelBit(
+                        AnimationPath::Rotation)) == 0) {
+      trs->rotation = edited.rotation;
+    }
+    if ((masks[i] & CompiledAnimationClip::channelBit(AnimationPath::Scale)) ==
+        0) {
+      trs->scale = edited.scale;
     }
-    affectedNodes.insert(ch.targetNode);
   }
+}
 
-  for (uint32_t nodeIndex : affectedNodes) {
-    ecs::Entity entity = nodeIndex;
-    if (!scene.registry().has<LocalTransform>(entity)) {
+void AnimationSystem::commitPose(SceneGraphDOD &scene,
+                                 const CompiledAnimationClip &clip,
+                                 std::span<LocalTRS *const> pose) {
+  auto &registry = scene.registry();
+  const auto targets = clip.targets();
+  for (size_t i = 0; i < targets.size(); ++i) {
+    if (pose[i] == nullptr) {
       continue;
     }
+    registry.get<LocalTransform>(targets[i]).matrix = pose[i]->toMatrix();
+    scene.markAsChanged(targets[i]);
+  }
+}
 
-    const uint32_t lockIndex =
-        static_cast<uint32_t>(entity) % kAnimationMutexCount;
-    std::lock_guard<std::mutex> lock(s_animationMutexes[lockIndex]);
-
-    glm::mat4 &localMat = scene.registry().get<LocalTransform>(entity).matrix;
-
-    glm::vec3 t;
-    glm::quat r;
-    glm::vec3 s;
-    glm::vec3 skew;
-    glm::vec4 perspective;
-    glm::decompose(localMat, s, r, t, skew, perspective);
-
-    auto itA = sampledA.find(nodeIndex);
-    auto itB = sampledB.find(nodeIndex);
-
-    glm::vec3 tA =
-        (itA != sampledA.end() && itA->second.m_hasT) ? itA->second.m_t : t;
-    glm::vec3 tB =
-        (itB != sampledB.end() && itB->second.m_hasT) ? itB->second.m_t : t;
-    t = glm::mix(tA, tB, weight);
+void AnimationSystem::applyAnimation(ModelDOD &model, uint32_t animIndex,
+                                     AnimationCursor &cursor, float time) {
+  const auto &clip = model.compiledAnimation(animIndex);
+  if (clip.tracks().empty()) {
+    return;
+  }
 
-    glm::quat rA =
-        (itA != sampledA.end() && itA->second.m_hasR) ? itA->second.m_r : r;
-    glm::quat rB =
-        (itB != sampledB.end() && itB->second.m_hasR) ? itB->second.m_r : r;
-    r = glm::normalize(glm::slerp(rA, rB, weight));
+  prepareTargets(model.scene(), clip);
+  bindTargets(model.scene(), clip, t_poseA);
+  syncEditedChannels(model.scene(), clip, t_poseA);
+  sampleClip(clip, time, cursor, t_poseA);
+  commitPose(model.scene(), clip, t_poseA);
+  applyWeights(model, model.animations()[animIndex], clip, cursor, time);
+}
 
-    glm::vec3 sA =
-        (itA != sampledA.end() && itA->second.m_hasS) ? itA->second.m_s : s;
-    glm::vec3 sB =
-        (itB != sampledB.end() && itB->second.m_hasS) ? itB->second.m_s : s;
-    s = glm::mix(sA, sB, weight);
+void AnimationSystem::applyBlending(ModelDOD &model, uint32_t animIndexA,
+                                    AnimationCursor &cursorA, float timeA,
+                                    uint32_t animIndexB,
+                                    AnimationCursor &cursorB, float timeB,
+                                    float weight) {
+  auto &scene = model.scene();
+  auto &registry = scene.registry();
+  const auto &clipA = model.compiledAnimation(animIndexA);
+  const auto &clipB = model.compiledAnimation(animIndexB);
+
+  // Targets only clip B animates would otherwise be emplaced after t_poseA
+  // points into the pool.
+  prepareTargets(scene, clipA);
+  prepareTargets(scene, clipB);
+  bindTargets(scene, clipA, t_poseA);
+  bindTargets(scene, clipB, t_poseB);
+  syncEditedChannels(scene, clipA, t_poseA);
+  syncEditedChannels(scene, clipB, t_poseB);
+  seedScratch(t_poseA, t_sampledA, t_scratchA);
+  seedScratch(t_poseB, t_sampledB, t_scratchB);
+  sampleClip(clipA, timeA, cursorA, t_scratchA);
+  sampleClip(clipB, timeB, cursorB, t_scratchB);
+
+  // Both target lists are sorted, so nodes animated by either clip are
+  // visited once by a merge walk.
+  const auto targetsA = clipA.targets();
+  const auto targetsB = clipB.targets();
+  size_t i = 0;
+  size_t j = 0;
+  while (i < targetsA.size() || j < targetsB.size()) {
+    uint32_t node = 0;
+    LocalTRS *current = nullptr;
+    const LocalTRS *a = nullptr;
+    const LocalTRS *b = nullptr;
+    if (j == targetsB.size() ||
+        (i < targetsA.size() && targetsA[i] < targetsB[j])) {
+      node = targetsA[i];
+      current = t_poseA[i];
+      a = &t_sampledA[i];
+      b = current;
+      ++i;
+    } else if (i == targetsA.size() || targetsB[j] < targetsA[i]) {
+      node = targetsB[j];
+      current = t_poseB[j];
+      a = current;
+      b = &t_sampledB[j];
+      ++j;
+    } else {
+      node = targetsA[i];
+      current = t_poseA[i];
+      a = &t_sampledA[i];
+      b = &t_sampledB[j];
+      ++i;
+      ++j;
+    }
+    if (current == nullptr) {
+      continue;
+    }
 
-    localMat = glm::translate(glm::mat4(1.0F), t) * glm::toMat4(r) *
-               glm::scale(glm::mat4(1.0F), s);
+    current->translation = glm::mix(a->translation, b->translation, weight);
+    current->rotation =
+        glm::normalize(glm::slerp(a->rotation, b->rotation, weight));
+    current->scale = glm::mix(a->scale, b->scale, weight);
 
-    scene.markAsChanged(entity);
+    registry.get<LocalTransform>(node).matrix = current->toMatrix();
+    scene.markAsChanged(node);
   }
 }
 
@@ -285,26 +360,42 @@ std::vector<glm::mat4> AnimationSystem::updateSkinning(const ModelDOD &model) {
   return jointMatrices;
 }
 
-size_t AnimationSystem::getKeyframeIndex(const std::vector<float> &inputs,
-                                         float time) {
+void AnimationSystem::applyWeights(ModelDOD &model, const Animation &anim,
+                                   const CompiledAnimationClip &clip,
+                                   AnimationCursor &cursor, float time) {
+  auto &registry = model.scene().registry();
+  const auto weightTracks = clip.weightTracks();
+  for (size_t i = 0; i < weightTracks.size(); ++i) {
+    const AnimationTrack &track = weightTracks[i];
+    const ecs::Entity entity = track.target;
+    if (!registry.has<MeshRenderer>(entity)) {
+      continue;
+    }
 
-  auto it = std::ranges::upper_bound(inputs, time);
-  if (it == inputs.begin()) {
-    return 0;
-  }
-  return (size_t)std::distance(inputs.begin(), it) - 1;
-}
+    const int32_t meshIdx = registry.get<MeshRenderer>(entity).meshID;
+    if (meshIdx < 0 || (size_t)meshIdx >= model.morphTargetInfos().size()) {
+      continue;
+    }
+    const auto &info = model.morphTargetInfos()[meshIdx];
+    const uint32_t numTargets =
+        static_cast<uint32_t>(info.targetOffsets.size());
+    if (numTargets == 0) {
+      continue;
+    }
 
-AnimationSystem::InterpolationContext
-AnimationSystem::getInterpolationContext(const std::vector<float> &inputs,
-                                         float time) {
-  size_t idx0 = getKeyframeIndex(inputs, time);
-  size_t idx1 = std::min(idx0 + 1, inputs.size() - 1);
-  float t0 = inputs[idx0];
-  float t1 = inputs[idx1];
-  float dt = t1 - t0;
-  float factor = (dt != 0.0F) ? (time - t0) / dt : 0.0F;
-  return {.idx0 = idx0, .idx1 = idx1, .factor = factor, .dt = dt};
+    const KeyframeSpan span =
+        clip.locate(track, time, cursor.keys[clip.trsTrackCount() + i]);
+    std::vector<float> weights(numTargets);
+    interpolateWeights(anim.samplers[track.samplerIndex], span, numTargets,
+                       weights.data());
+
+    gpu::MorphState &state = model.morphStates()[meshIdx];
+    state.meshIndex = static_cast<uint32_t>(meshIdx);
+    for (uint32_t t = 0; t < std::min(8U, numTargets); ++t) {
+      state.activeTargets[t] = info.targetOffsets[t];
+      state.weights[t] = weights[t];
+    }
+  }
 }
 
 template <typename T> static T cubicSpline(float t, T p0, T m0, T p1, T m1) {
@@ -314,213 +405,25 @@ template <typename T> static T cubicSpline(float t, T p0, T m0, T p1, T m1) {
          ((-2.0F * t3 + 3.0F * t2) * p1) + ((t3 - t2) * m1);
 }
 
-glm::vec3
-AnimationSystem::interpolateTranslation(const AnimationSampler &sampler,
-                                        float time) {
-  if (sampler.inputs.empty()) {
-    return glm::vec3(0.0F);
-  }
-  if (sampler.inputs.size() == 1) {
-    return glm::vec3(sampler.outputs[0]);
-  }
-
-  auto ctx = getInterpolationContext(sampler.inputs, time);
-
-  if (sampler.interpolation == InterpolationType::Step) {
-    return glm::vec3(sampler.outputs[ctx.idx0]);
-  }
-
-  if (sampler.interpolation == InterpolationType::CubicSpline) {
-
-    size_t stride = 3;
-    size_t i0 = ctx.idx0 * stride;
-    size_t i1 = ctx.idx1 * stride;
-
-    auto p0 = glm::vec3(sampler.outputs[i0 + 1]);
-    glm::vec3 m0 = glm::vec3(sampler.outputs[i0 + 2]) * ctx.dt;
-    auto p1 = glm::vec3(sampler.outputs[i1 + 1]);
-    glm::vec3 m1 = glm::vec3(sampler.outputs[i1 + 0]) * ctx.dt;
-
-    return cubicSpline(ctx.factor, p0, m0, p1, m1);
-  }
-
-  return glm::mix(glm::vec3(sampler.outputs[ctx.idx0]),
-                  glm::vec3(sampler.outputs[ctx.idx1]), ctx.factor);
-}
-
-glm::quat AnimationSystem::interpolateRotation(const AnimationSampler &sampler,
-                                               float time) {
-  PNKR_PROFILE_FUNCTION();
-  if (sampler.inputs.empty()) {
-    return {1, 0, 0, 0};
-  }
-
-  auto ctx = getInterpolationContext(sampler.inputs, time);
-
-  if (sampler.interpolation != InterpolationType::CubicSpline) {
-    if (sampler.inputs.size() == 1) {
-      const auto &v = sampler.outputs[0];
-      return glm::normalize(glm::quat(v.w, v.x, v.y, v.z));
-    }
-
-    const auto &v0 = sampler.outputs[ctx.idx0];
-    glm::quat q0(v0.w, v0.x, v0.y, v0.z);
-
-    if (sampler.interpolation == InterpolationType::Step) {
-      return glm::normalize(q0);
-    }
-
-    const auto &v1 = sampler.outputs[ctx.idx1];
-    glm::quat q1(v1.w, v1.x, v1.y, v1.z);
-    return glm::normalize(glm::slerp(q0, q1, ctx.factor));
-  }
-
-  size_t stride = 3;
-  size_t i0 = ctx.idx0 * stride;
-  size_t i1 = ctx.idx1 * stride;
-
-  auto vP0 = sampler.outputs[i0 + 1];
-  auto vM0 = sampler.outputs[i0 + 2];
-  auto vP1 = sampler.outputs[i1 + 1];
-  auto vM1 = sampler.outputs[i1 + 0];
-
-  glm::quat p0(vP0.w, vP0.x, vP0.y, vP0.z);
-  glm::quat m0(vM0.w, vM0.x, vM0.y, vM0.z);
-  glm::quat p1(vP1.w, vP1.x, vP1.y, vP1.z);
-  glm::quat m1(vM1.w, vM1.x, vM1.y, vM1.z);
-
-  m0 *= ctx.dt;
-  m1 *= ctx.dt;
-
-  glm::quat result;
-  result.x = cubicSpline(ctx.factor, p0.x, m0.x, p1.x, m1.x);
-  result.y = cubicSpline(ctx.factor, p0.y, m0.y, p1.y, m1.y);
-  result.z = cubicSpline(ctx.factor, p0.z, m0.z, p1.z, m1.z);
-  result.w = cubicSpline(ctx.factor, p0.w, m0.w, p1.w, m1.w);
-
-  return glm::normalize(result);
-}
-
-glm::vec3 AnimationSystem::interpolateScale(const AnimationSampler &sampler,
-                                            float time) {
-  return interpolateTranslation(sampler, time);
-}
-
 void AnimationSystem::interpolateWeights(const AnimationSampler &sampler,
-                                         float time, uint32_t numTargets,
+                                         const KeyframeSpan &span,
+                                         uint32_t numTargets,
                                          float *outWeights) {
-  if (sampler.inputs.empty() || numTargets == 0) {
-    return;
-  }
-
-  auto ctx = getInterpolationContext(sampler.inputs, time);
-
   for (uint32_t i = 0; i < numTargets; ++i) {
     if (sampler.interpolation == InterpolationType::Step) {
-      outWeights[i] = sampler.outputs[(ctx.idx0 * numTargets) + i].x;
+      outWeights[i] = sampler.outputs[(span.k0 * numTargets) + i].x;
     } else if (sampler.interpolation == InterpolationType::CubicSpline) {
-      float p0 = sampler.outputs[((ctx.idx0 * 3 + 1) * numTargets) + i].x;
+      float p0 = sampler.outputs[((span.k0 * 3 + 1) * numTargets) + i].x;
       float m0 =
-          sampler.outputs[((ctx.idx0 * 3 + 2) * numTargets) + i].x * ctx.dt;
-      float p1 = sampler.outputs[((ctx.idx1 * 3 + 1) * numTargets) + i].x;
+          sampler.outputs[((span.k0 * 3 + 2) * numTargets) + i].x * span.dt;
+      float p1 = sampler.outputs[((span.k1 * 3 + 1) * numTargets) + i].x;
       float m1 =
-          sampler.outputs[((ctx.idx1 * 3 + 0) * numTargets) + i].x * ctx.dt;
-      outWeights[i] = cubicSpline(ctx.factor, p0, m0, p1, m1);
+          sampler.outputs[((span.k1 * 3 + 0) * numTargets) + i].x * span.dt;
+      outWeights[i] = cubicSpline(span.factor, p0, m0, p1, m1);
     } else {
-      float v0 = sampler.outputs[(ctx.idx0 * numTargets) + i].x;
-      float v1 = sampler.outputs[(ctx.idx1 * numTargets) + i].x;
-      outWeights[i] = glm::mix(v0, v1, ctx.factor);
-    }
-  }
-}
-
-void AnimationSystem::applyAnimation(ModelDOD &model, const Animation &anim,
-                                     float time) {
-  auto &scene = model.scene();
-
-  if (anim.channels.empty()) {
-    return;
-  }
-
-  auto applyChannel = [&](const AnimationChannel &ch) {
-    const auto &sampler = anim.samplers[ch.samplerIndex];
-    ecs::Entity entity = ch.targetNode;
-
-    if (ch.path == AnimationPath::Weights) {
-      if (scene.registry().has<MeshRenderer>(entity)) {
-        int32_t meshIdx = scene.registry().get<MeshRenderer>(entity).meshID;
-        if (meshIdx >= 0 && (size_t)meshIdx < model.morphTargetInfos().size()) {
-          const auto &info = model.morphTargetInfos()[meshIdx];
-          const uint32_t numTargets =
-              static_cast<uint32_t>(info.targetOffsets.size());
-          if (numTargets == 0) {
-            return;
-          }
-
-          std::vector<float> weights(numTargets);
-          interpolateWeights(sampler, time, numTargets, weights.data());
-
-          const uint32_t lockIndex =
-              static_cast<uint32_t>(meshIdx) % kAnimationMutexCount;
-          std::lock_guard<std::mutex> lock(s_animationMutexes[lockIndex]);
-
-          gpu::MorphState &state = model.morphStates()[meshIdx];
-          state.meshIndex = static_cast<uint32_t>(meshIdx);
-
-          for (uint32_t i = 0; i < std::min(8U, numTargets); ++i) {
-            state.activeTargets[i] = info.targetOffsets[i];
-            state.weights[i] = weights[i];
-          }
-        }
-      }
-      return;
-    }
-
-    if (!scene.registry().has<LocalTransform>(entity)) {
-      return;
-    }
-
-    const uint32_t lockIndex =
-        static_cast<uint32_t>(entity) % kAnimationMutexCount;
-    std::lock_guard<std::mutex> lock(s_animationMutexes[lockIndex]);
-
-    glm::mat4 &localMat = scene.registry().get<LocalTransform>(entity).matrix;
-
-    glm::vec3 translation;
-    glm::quat rotation;
-    glm::vec3 scale;
-    glm::vec3 skew;
-    glm::vec4 perspective;
-
-    glm::decompose(localMat, scale, rotation, translation, skew, perspective);
-
-    if (ch.path == AnimationPath::Translation) {
-      translation = interpolateTranslation(sampler, time);
-    } else if (ch.path == AnimationPath::Rotation) {
-      rotation = interpolateRotation(sampler, time);
-    } else if (ch.path == AnimationPath::Scale) {
-      scale = interpolateScale(sampler, time);
-    }
-
-    localMat = glm::translate(glm::mat4(1.0F), translation) *
-               glm::toMat4(rotation) * glm::scale(glm::mat4(1.0F), scale);
-
-    model.scene().markAsChanged(entity);
-  };
-
-  if (core::TaskSystem::isInitialized() &&
-      anim.channels.size() >= kAnimationParallelMinRange) {
-    core::TaskSystem::parallelFor(
-        static_cast<uint32_t>(anim.channels.size()),
-        [&](enki::TaskSetPartition range, uint32_t) {
-          for (uint32_t i = range.start; i < range.end; ++i) {
-            applyChannel(anim.channels[i]);
-          }
-        },
-        kAnimationParallelMinRange);
-  } else {
-    for (const auto &ch : anim.channels) {
-      applyChannel(ch);
+      float v0 = sampler.outputs[(span.k0 * numTargets) + i].x;
+      float v1 = sampler.outputs[(span.k1 * numTargets) + i].x;
+      outWeights[i] = glm::mix(v0, v1, span.factor);
     }
   }
 }
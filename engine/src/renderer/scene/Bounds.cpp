@@ -4,34 +4,63 @@
 
 namespace pnkr::renderer::scene {
 void updateWorldBounds(SceneGraphDOD &scene) {
-  auto view =
-      scene.registry()
-          .view<BoundsDirtyTag, LocalBounds, WorldTransform, WorldBounds>();
-  std::vector<ecs::Entity> dirtyEntities;
-  dirtyEntities.reserve(scene.registry().getPool<BoundsDirtyTag>().size());
-  for (ecs::Entity entity : view) {
-    dirtyEntities.push_back(entity);
-  }
-
-  if (dirtyEntities.empty()) {
+  auto &registry = scene.registry();
+  if (registry.count<BoundsDirtyTag>() == 0) {
     return;
   }
 
-  core::TaskSystem::parallelFor(
-      static_cast<uint32_t>(dirtyEntities.size()),
-      [&](enki::TaskSetPartition range, uint32_t) {
-        for (uint32_t i = range.start; i < range.end; ++i) {
-          ecs::Entity e = dirtyEntities[i];
-          const auto &lb = scene.registry().get<LocalBounds>(e);
-          const auto &wt = scene.registry().get<WorldTransform>(e);
-          auto &wb = scene.registry().get<WorldBounds>(e);
-          wb.aabb = transformAabbFast(lb.aabb, wt.matrix);
+  // Cull slots are handed out serially so the parallel pass below only
+  // writes its own lane of the SoA.
+  registry.view<BoundsDirtyTag, MeshRenderer, Visibility, WorldBounds>().each(
+      [&scene](ecs::Entity e, BoundsDirtyTag &, const MeshRenderer &,
+               const Visibility &, const WorldBounds &) {
+        scene.acquireCullSlot(e);
+      });
+
+  registry.view<BoundsDirtyTag, LocalBounds, WorldTransform, WorldBounds>()
+      .parallelEach(
+          [&scene](ecs::Entity e, BoundsDirtyTag &, const LocalBounds &lb,
+                   const WorldTransform &wt, WorldBounds &wb) {
+            wb.aabb = transformAabbFast(lb.aabb, wt.matrix);
+            const uint32_t slot = scene.cullSlotOf(e);
+            if (slot != SceneGraphDOD::kNoSlot) {
+              scene.setCullBounds(slot, wb.aabb);
+            }
+          },
+          256);
+
+  // Leaf updates are serial; refit() then walks only the changed paths.
+  auto &bvh = scene.bvh();
+  registry.view<BoundsDirtyTag, WorldBounds>().each(
+      [&](ecs::Entity e, BoundsDirtyTag &, const WorldBounds &wb) {
+        if (scene.cullSlotOf(e) != SceneGraphDOD::kNoSlot) {
+          bvh.update(e, wb.aabb);
         }
-      },
-      256);
+      });
+  bvh.refit();
 
-  for (auto e : dirtyEntities) {
-    scene.registry().remove<BoundsDirtyTag>(e);
-  }
+  // Views can't change structure while iterating, so the removals are
+  // deferred. Tags on entities without bounds stay until they gain them.
+  ecs::EntityCommandBuffer commands(registry);
+  commands.reserve(registry.count<BoundsDirtyTag>());
+  registry.view<BoundsDirtyTag, LocalBounds, WorldTransform, WorldBounds>()
+      .each([&commands](ecs::Entity e, BoundsDirtyTag &, const LocalBounds &,
+                        const WorldTransform &, const WorldBounds &) {
+        commands.remove<BoundsDirtyTag>(e);
+      });
+  commands.execute();
+}
+
+BoundingBox shadowCasterBounds(const SceneGraphDOD &scene) {
+  return scene.registry().view<MeshRenderer, WorldBounds>().parallelReduce(
+      BoundingBox{},
+      [](ecs::Entity, const MeshRenderer &mr, const WorldBounds &wb) {
+        return mr.meshID >= 0 && wb.aabb.isValid() ? wb.aabb : BoundingBox{};
+      },
+      [](BoundingBox a, const BoundingBox &b) {
+        a.combine(b);
+        return a;
+      },
+      1024);
 }
 } // namespace pnkr::renderer::scene
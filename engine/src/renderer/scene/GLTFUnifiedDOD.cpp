@@ -37,7 +37,10 @@ namespace pnkr::renderer::scene
             cameraPos,
             allocator,
             ctx.ignoreVisibility,
-            ctx.vertexBufferOverride
+            ctx.vertexBufferOverride,
+            ctx.visibleMeshes,
+            ctx.lodErrorScale,
+            ctx.skinnedSlotStride
         );
 
         // Copy results back to context
@@ -67,6 +70,15 @@ namespace pnkr::renderer::scene
         ctx.transmissionDoubleSidedBounds = batchResult.transmissionDoubleSidedBounds;
         ctx.transparentBounds = batchResult.transparentBounds;
 
+        ctx.opaqueLods = batchResult.opaqueLods;
+        ctx.opaqueDoubleSidedLods = batchResult.opaqueDoubleSidedLods;
+        ctx.opaqueMeshletDraws = batchResult.opaqueMeshletDraws;
+        ctx.opaqueDoubleSidedMeshletDraws = batchResult.opaqueDoubleSidedMeshletDraws;
+        ctx.opaqueMeshletCount = batchResult.opaqueMeshletCount;
+        ctx.opaqueDoubleSidedMeshletCount = batchResult.opaqueDoubleSidedMeshletCount;
+        ctx.lodDraws = batchResult.lodDraws;
+        ctx.lodTriangles = batchResult.lodTriangles;
+
         ctx.opaqueBoundsCount = ctx.opaqueCount;
         ctx.opaqueDoubleSidedBoundsCount = ctx.opaqueDoubleSidedCount;
         ctx.transmissionBoundsCount = ctx.transmissionCount;
@@ -0,0 +1,335 @@
+#include "pnkr/renderer/scene/GlobalInstanceBuffer.hpp"
+#include "pnkr/core/TaskSystem.hpp"
+#include "pnkr/core/logger.hpp"
+#include "pnkr/core/profiler.hpp"
+#include "pnkr/renderer/FrameManager.hpp"
+#include "pnkr/renderer/RenderResourceManager.h"
+#include "pnkr/renderer/scene/ModelDOD.hpp"
+#include "pnkr/rhi/rhi_command_buffer.hpp"
+#include "pnkr/rhi/rhi_pipeline_builder.hpp"
+#include "pnkr/rhi/rhi_shader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace pnkr::renderer
+{
+    namespace
+    {
+        constexpr uint32_t kScatterGroupSize = 64;
+        constexpr uint32_t kMinCapacity = 1024;
+
+        using scene::MeshRenderer;
+        using scene::SkinnedMeshRenderer;
+        using scene::WorldTransform;
+
+        void packInstance(const InstanceUpdateRequest& request, ecs::Entity e, ::gpu::InstanceData& inst)
+        {
+            const auto& registry = request.model.scene().registry();
+
+            inst.world = glm::mat4(1.0F);
+            inst.worldIT = glm::mat4(1.0F);
+            inst.vertexBufferPtr = 0;
+            inst.materialIndex = 0;
+            inst.meshIndex = 0;
+            inst.posDequant = glm::vec4(0.0F);
+
+            if (registry.has<WorldTransform>(e))
+            {
+                const auto& wt = registry.get<WorldTransform>(e);
+                inst.world = wt.matrix;
+                inst.worldIT = glm::transpose(glm::inverse(wt.matrix));
+            }
+
+            if (registry.has<MeshRenderer>(e))
+            {
+                const auto& mr = registry.get<MeshRenderer>(e);
+                inst.materialIndex = (mr.materialOverride >= 0) ? static_cast<uint32_t>(mr.materialOverride) : 0;
+                inst.meshIndex = (mr.meshID >= 0) ? static_cast<uint32_t>(mr.meshID) : 0;
+                inst.vertexBufferPtr = request.vertexBufferAddr;
+                inst.posDequant = request.model.positionDequant(inst.meshIndex);
+            }
+            else if (registry.has<SkinnedMeshRenderer>(e))
+            {
+                const auto& smr = registry.get<SkinnedMeshRenderer>(e);
+                inst.materialIndex = (smr.materialOverride >= 0) ? static_cast<uint32_t>(smr.materialOverride) : 0;
+                inst.meshIndex = 0;
+                inst.vertexBufferPtr = request.skinnedVertexBufferAddr;
+            }
+        }
+
+        bool isSkinnedOnly(const ecs::Registry& registry, ecs::Entity e)
+        {
+            return registry.has<SkinnedMeshRenderer>(e) && !registry.has<MeshRenderer>(e);
+        }
+    }
+
+    GlobalInstanceBuffer::GlobalInstanceBuffer() = default;
+
+    GlobalInstanceBuffer::~GlobalInstanceBuffer()
+    {
+      if ((m_renderer != nullptr) && m_gpuBuffer != INVALID_BUFFER_HANDLE) {
+        m_renderer->destroyBuffer(m_gpuBuffer);
+      }
+    }
+
+    void GlobalInstanceBuffer::initialize(RHIRenderer* renderer, RenderResourceManager* resourceMgr)
+    {
+        m_renderer = renderer;
+        m_resourceMgr = resourceMgr;
+        m_needsFullUpload = true;
+
+        auto comp = rhi::Shader::load(rhi::ShaderStage::Compute, "shaders/instance_scatter.spv");
+        rhi::RHIPipelineBuilder builder;
+        m_scatterPipeline = m_renderer->createComputePipeline(
+            builder.setComputeShader(comp.get()).setName("InstanceScatter").buildCompute());
+    }
+
+    bool GlobalInstanceBuffer::ensureCapacity(uint32_t count)
+    {
+        if (count <= m_capacity && m_gpuBuffer != INVALID_BUFFER_HANDLE)
+        {
+            return false;
+        }
+
+        if (m_gpuBuffer != INVALID_BUFFER_HANDLE)
+        {
+            // Frames in flight may still read the old buffer.
+            if (m_resourceMgr != nullptr)
+            {
+                m_resourceMgr->destroyBufferDeferred(m_gpuBuffer, "GlobalInstanceBuffer");
+            }
+            else
+            {
+                m_renderer->destroyBuffer(m_gpuBuffer);
+            }
+            m_gpuBuffer = INVALID_BUFFER_HANDLE;
+        }
+
+        m_capacity = std::max(kMinCapacity, count + count / 2);
+        const size_t bufferSize = static_cast<size_t>(m_capacity) * sizeof(::gpu::InstanceData);
+
+        m_gpuBuffer = m_renderer->createBuffer("GlobalInstanceBuffer", {
+            .size = bufferSize,
+            .usage = rhi::BufferUsage::StorageBuffer | rhi::BufferUsage::ShaderDeviceAddress |
+                     rhi::BufferUsage::TransferDst,
+            .memoryUsage = rhi::MemoryUsage::GPUOnly,
+            .debugName = "GlobalInstanceBuffer"
+        }).release();
+
+        core::Logger::Render.info("GlobalInstanceBuffer resized to {} instances ({:.2f} MB)",
+                          m_capacity, static_cast<double>(bufferSize) / (1024.0 * 1024.0));
+        return true;
+    }
+
+    void GlobalInstanceBuffer::update(const InstanceUpdateRequest& request)
+    {
+        PNKR_PROFILE_FUNCTION();
+        m_stats = {};
+
+        auto& sceneGraph = request.model.scene();
+        const auto& topoOrder = sceneGraph.topoOrder();
+        if (topoOrder.empty())
+        {
+            return;
+        }
+
+        const bool topologyChanged = m_scene != &sceneGraph ||
+                                     m_topologyVersion != sceneGraph.topologyVersion();
+        if (topologyChanged)
+        {
+            // Entity ids only change with the topology, so the slot count is
+            // not rescanned on frames that merely move nodes.
+            uint32_t maxEntityId = 0;
+            for (ecs::Entity e : topoOrder)
+            {
+                maxEntityId = std::max(maxEntityId, static_cast<uint32_t>(e));
+            }
+            m_slotCount = maxEntityId + 1;
+        }
+
+        const bool resized = ensureCapacity(m_slotCount);
+        if (resized || topologyChanged || m_needsFullUpload ||
+            m_vertexBufferAddr != request.vertexBufferAddr)
+        {
+            uploadAll(request, m_slotCount);
+        }
+        else
+        {
+            scatterDirty(request);
+        }
+
+        m_scene = &sceneGraph;
+        m_topologyVersion = sceneGraph.topologyVersion();
+        m_vertexBufferAddr = request.vertexBufferAddr;
+        m_skinnedVertexBufferAddr = request.skinnedVertexBufferAddr;
+
+        // Views can't change structure while iterating, so the removals are
+        // deferred until the walk is done.
+        auto& registry = sceneGraph.registry();
+        ecs::EntityCommandBuffer commands(registry);
+        commands.reserve(registry.count<scene::InstanceDirtyTag>());
+        registry.view<scene::InstanceDirtyTag>().each(
+            [&](ecs::Entity e, scene::InstanceDirtyTag&) { commands.remove<scene::InstanceDirtyTag>(e); });
+        commands.execute();
+    }
+
+    void GlobalInstanceBuffer::uploadAll(const InstanceUpdateRequest& request, uint32_t count)
+    {
+        const auto& topoOrder = request.model.scene().topoOrder();
+        const size_t dataSize = static_cast<size_t>(count) * sizeof(::gpu::InstanceData);
+        m_needsFullUpload = true;
+
+        auto staging = request.frameManager.allocateUpload(dataSize, 16);
+        if (staging.mappedPtr == nullptr || staging.buffer == INVALID_BUFFER_HANDLE)
+        {
+            return;
+        }
+
+        auto* dst = reinterpret_cast<::gpu::InstanceData*>(staging.mappedPtr);
+        // Slots of destroyed entities keep whatever was staged; zero them so
+        // stale pointers never reach the GPU.
+        std::memset(dst, 0, dataSize);
+        core::TaskSystem::parallelFor(
+            static_cast<uint32_t>(topoOrder.size()),
+            [&](enki::TaskSetPartition range, uint32_t) {
+                for (uint32_t i = range.start; i < range.end; ++i)
+                {
+                    const ecs::Entity e = topoOrder[i];
+                    packInstance(request, e, dst[e]);
+                }
+            });
+
+        auto* srcBuf = request.renderer.getBuffer(staging.buffer);
+        auto* dstBuf = request.renderer.getBuffer(m_gpuBuffer);
+        if ((srcBuf == nullptr) || (dstBuf == nullptr))
+        {
+            return;
+        }
+
+        const auto readers = rhi::ShaderStage::Vertex | rhi::ShaderStage::Fragment | rhi::ShaderStage::Compute;
+        request.cmd.pipelineBarrier(readers, rhi::ShaderStage::Transfer,
+                                    rhi::RHIMemoryBarrier{.buffer = dstBuf,
+                                                          .srcAccessStage = readers,
+                                                          .dstAccessStage = rhi::ShaderStage::Transfer});
+        request.cmd.copyBuffer(srcBuf, dstBuf, staging.offset, 0, dataSize);
+        request.cmd.pipelineBarrier(rhi::ShaderStage::Transfer, readers,
+                                    rhi::RHIMemoryBarrier{.buffer = dstBuf,
+                                                          .srcAccessStage = rhi::ShaderStage::Transfer,
+                                                          .dstAccessStage = readers});
+
+        m_needsFullUpload = false;
+        m_stats.instancesUploaded = static_cast<uint32_t>(topoOrder.size());
+        m_stats.bytesUploaded = dataSize;
+        m_stats.fullUpload = true;
+    }
+
+    void GlobalInstanceBuffer::scatterDirty(const InstanceUpdateRequest& request)
+    {
+        const auto& registry = request.model.scene().registry();
+
+        // m_queued stays all-zero between frames; only the entries set below
+        // are cleared again, so the cost follows the dirty count.
+        m_dirty.clear();
+        m_queued.resize(m_capacity, 0);
+        const auto queue = [this](ecs::Entity e) {
+            if (e < m_capacity && m_queued[e] == 0)
+            {
+                m_queued[e] = 1;
+                m_dirty.push_back(e);
+            }
+        };
+
+        registry.view<scene::InstanceDirtyTag>().each(
+            [&](ecs::Entity e, scene::InstanceDirtyTag&) { queue(e); });
+
+        // The skinned vertex buffer is per frame, so its address rotates even
+        // when no skinned node moved.
+        if (m_skinnedVertexBufferAddr != request.skinnedVertexBufferAddr)
+        {
+            registry.view<SkinnedMeshRenderer>().each(
+                [&](ecs::Entity e, SkinnedMeshRenderer&) {
+                    if (isSkinnedOnly(registry, e))
+                    {
+                        queue(e);
+                    }
+                });
+        }
+
+        for (ecs::Entity e : m_dirty)
+        {
+            m_queued[e] = 0;
+        }
+        if (m_dirty.empty())
+        {
+            return;
+        }
+
+        const auto count = static_cast<uint32_t>(m_dirty.size());
+        const size_t dataSize = static_cast<size_t>(count) * sizeof(::gpu::InstanceData);
+        const size_t indexSize = static_cast<size_t>(count) * sizeof(uint32_t);
+
+        auto data = request.frameManager.allocateUpload(dataSize, 16);
+        auto indices = request.frameManager.allocateUpload(indexSize, 16);
+        if (data.mappedPtr == nullptr || indices.mappedPtr == nullptr)
+        {
+            m_needsFullUpload = true;
+            return;
+        }
+
+        auto* dst = reinterpret_cast<::gpu::InstanceData*>(data.mappedPtr);
+        auto* dstIndices = reinterpret_cast<uint32_t*>(indices.mappedPtr);
+        core::TaskSystem::parallelFor(
+            count,
+            [&](enki::TaskSetPartition range, uint32_t) {
+                for (uint32_t i = range.start; i < range.end; ++i)
+                {
+                    dstIndices[i] = m_dirty[i];
+                    packInstance(request, m_dirty[i], dst[i]);
+                }
+            },
+            256);
+
+        auto* dstBuf = request.renderer.getBuffer(m_gpuBuffer);
+        if (dstBuf == nullptr)
+        {
+            // The dirty tags are dropped after this frame, so only a full
+            // upload can recover the skipped instances.
+            m_needsFullUpload = true;
+            return;
+        }
+
+        const auto readers = rhi::ShaderStage::Vertex | rhi::ShaderStage::Fragment | rhi::ShaderStage::Compute;
+        request.cmd.pipelineBarrier(readers, rhi::ShaderStage::Compute,
+                                    rhi::RHIMemoryBarrier{.buffer = dstBuf,
+                                                          .srcAccessStage = readers,
+                                                          .dstAccessStage = rhi::ShaderStage::Compute});
+
+        ::gpu::InstanceScatterPushConstants pc{};
+        pc.src = data.deviceAddress;
+        pc.dstIndices = indices.deviceAddress;
+        pc.dst = dstBuf->getDeviceAddress();
+        pc.count = count;
+
+        request.cmd.bindPipeline(request.renderer.getPipeline(m_scatterPipeline.handle()));
+        request.cmd.pushConstants(rhi::ShaderStage::Compute, pc);
+        request.cmd.dispatch((count + kScatterGroupSize - 1) / kScatterGroupSize, 1, 1);
+
+        request.cmd.pipelineBarrier(rhi::ShaderStage::Compute, readers,
+                                    rhi::RHIMemoryBarrier{.buffer = dstBuf,
+                                                          .srcAccessStage = rhi::ShaderStage::Compute,
+                                                          .dstAccessStage = readers});
+
+        m_stats.instancesUploaded = count;
+        m_stats.bytesUploaded = dataSize + indexSize;
+    }
+
+    uint64_t GlobalInstanceBuffer::getDeviceAddress() const
+    {
+      if (m_gpuBuffer == INVALID_BUFFER_HANDLE || (m_renderer == nullptr)) {
+        return 0;
+      }
+        auto* buf = m_renderer->getBuffer(m_gpuBuffer);
+        return (buf != nullptr) ? buf->getDeviceAddress() : 0;
+    }
+}
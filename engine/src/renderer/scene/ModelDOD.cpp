@@ -104,7 +104,7 @@ namespace pnkr::renderer::scene
         ecs::Entity nodeId = sceneGraph.createNode(parent);
 
         const auto lightIndex = static_cast<int32_t>(
-            sceneGraph.registry().getPool<LightSource>().size());
+            sceneGraph.registry().count<LightSource>());
         auto& ls = sceneGraph.registry().emplace<LightSource>(nodeId);
         ls.type = light.m_type;
         ls.color = light.m_color;
@@ -130,9 +130,8 @@ namespace pnkr::renderer::scene
 
     void ModelDOD::removeLight(int32_t lightIndex)
     {
-        const auto& lightPool = scene().registry().getPool<LightSource>();
         if (lightIndex < 0 ||
-            static_cast<size_t>(lightIndex) >= lightPool.size()) {
+            static_cast<size_t>(lightIndex) >= scene().registry().count<LightSource>()) {
             return;
         }
 
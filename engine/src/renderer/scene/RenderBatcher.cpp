@@ -2,8 +2,11 @@
 #include "pnkr/core/profiler.hpp"
 #include "pnkr/core/logger.hpp"
 #include "pnkr/renderer/SystemMeshes.hpp"
+#include "pnkr/renderer/geometry/ClusterCull.hpp"
 #include <algorithm>
+#include <cmath>
 #include <execution>
+#include <functional>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtx/norm.hpp>
 #include <vector>
@@ -17,7 +20,10 @@ namespace pnkr::renderer::scene
             const glm::vec3& cameraPos,
             core::LinearAllocator& allocator,
             bool ignoreVisibility,
-            uint64_t vertexBufferOverride
+            uint64_t vertexBufferOverride,
+            const std::vector<ecs::Entity>* visibleMeshes,
+            float lodErrorScale,
+            uint64_t skinnedSlotStride
         )
     {
         PNKR_PROFILE_FUNCTION();
@@ -30,6 +36,10 @@ namespace pnkr::renderer::scene
         result.transmissionDoubleSidedCount = 0;
         result.transparentCount = 0;
         result.volumetricMaterial = false;
+        result.opaqueMeshletCount = 0;
+        result.opaqueDoubleSidedMeshletCount = 0;
+        result.lodDraws.fill(0);
+        result.lodTriangles.fill(0);
 
         const auto& scene = model.scene();
         const auto& meshes = model.meshes();
@@ -78,31 +88,58 @@ namespace pnkr::renderer::scene
                                  : SortingType::Opaque;
         };
 
+        static_assert(assets::kMaxPrimitiveLods == 4, "DrawLodGPU holds four levels");
+        auto singleLod = [](const gpu::DrawIndexedIndirectCommandGPU &cmd) {
+          gpu::DrawLodGPU lod{};
+          lod.firstIndex[0] = cmd.firstIndex;
+          lod.indexCount[0] = cmd.indexCount;
+          lod.lodCount = 1U;
+          return lod;
+        };
+
         auto meshView = scene.registry().view<MeshRenderer, WorldTransform, Visibility, WorldBounds>();
         auto sysView = scene.registry().view<SystemMeshRenderer, WorldTransform, Visibility, WorldBounds>();
 
-        uint32_t totalInstances = 0;
-        uint32_t currentTransformIndex = 0;
         const uint32_t systemMeshCount = (uint32_t)SystemMeshType::Count;
-        meshView.each([&](ecs::Entity, MeshRenderer &meshComp, WorldTransform &,
-                          Visibility &vis, WorldBounds &) {
-          if (!ignoreVisibility && !vis.visible) {
-            return;
-          }
+        // A culled list replaces the per-entity Visibility test for meshes.
+        const bool useVisibleList = !ignoreVisibility && visibleMeshes != nullptr;
+
+        auto instancesOf = [&](const MeshRenderer &meshComp) -> uint32_t {
           if (meshComp.meshID < 0) {
-            totalInstances += 1;
-          } else if (static_cast<size_t>(meshComp.meshID) < meshes.size()) {
-            totalInstances +=
-                util::u32(meshes[meshComp.meshID].primitives.size());
+            return 1U;
           }
-        });
-        sysView.each([&](ecs::Entity, SystemMeshRenderer&, WorldTransform&,
-                         Visibility& vis, WorldBounds&) {
-          if (!ignoreVisibility && !vis.visible) {
-            return;
+          if (static_cast<size_t>(meshComp.meshID) < meshes.size()) {
+            return util::u32(meshes[meshComp.meshID].primitives.size());
+          }
+          return 0U;
+        };
+
+        uint32_t totalInstances = 0;
+        if (useVisibleList) {
+          for (const ecs::Entity entity : *visibleMeshes) {
+            totalInstances += instancesOf(scene.registry().get<MeshRenderer>(entity));
           }
-          totalInstances += 1;
-        });
+        } else {
+          totalInstances = meshView.parallelReduce<uint32_t>(
+              0U,
+              [&](ecs::Entity, const MeshRenderer &meshComp,
+                  const WorldTransform &, const Visibility &vis,
+                  const WorldBounds &) -> uint32_t {
+                if (!ignoreVisibility && !vis.visible) {
+                  return 0U;
+                }
+                return instancesOf(meshComp);
+              },
+              std::plus<>{}, 1024);
+        }
+        totalInstances += sysView.parallelReduce<uint32_t>(
+            0U,
+            [&](ecs::Entity, const SystemMeshRenderer &,
+                const WorldTransform &, const Visibility &vis,
+                const WorldBounds &) -> uint32_t {
+              return (ignoreVisibility || vis.visible) ? 1U : 0U;
+            },
+            std::plus<>{}, 1024);
 
         if (totalInstances == 0) {
           return;
@@ -129,6 +166,11 @@ namespace pnkr::renderer::scene
         result.transmissionDoubleSidedBounds = allocator.alloc<BoundingBox>(totalInstances);
         result.transparentBounds = allocator.alloc<BoundingBox>(totalInstances);
 
+        result.opaqueLods = allocator.alloc<gpu::DrawLodGPU>(totalInstances);
+        result.opaqueDoubleSidedLods = allocator.alloc<gpu::DrawLodGPU>(totalInstances);
+        result.opaqueMeshletDraws = allocator.alloc<gpu::MeshletDrawGPU>(totalInstances);
+        result.opaqueDoubleSidedMeshletDraws = allocator.alloc<gpu::MeshletDrawGPU>(totalInstances);
+
         if ((result.transforms == nullptr) || (result.indirectOpaque == nullptr)) {
             // Allocation failed
             return;
@@ -140,13 +182,10 @@ namespace pnkr::renderer::scene
 
         {
             PNKR_PROFILE_SCOPE("Batch Collect Phase");
-            meshView.each([&](ecs::Entity entity, MeshRenderer &meshComp,
-                              WorldTransform &world, Visibility &vis,
-                              WorldBounds &bounds) {
-              if (!ignoreVisibility && !vis.visible) {
-                return;
-              }
-
+            auto collectMesh = [&](ecs::Entity entity,
+                                   const MeshRenderer &meshComp,
+                                   const WorldTransform &world,
+                                   const WorldBounds &bounds) {
               const bool isSystemMesh = (meshComp.meshID < 0);
               if (!isSystemMesh &&
                   static_cast<size_t>(meshComp.meshID) >= meshes.size()) {
@@ -156,10 +195,15 @@ namespace pnkr::renderer::scene
               const glm::mat4 &m = world.matrix;
               const glm::mat4 n = glm::inverseTranspose(m);
 
-              bool isSkinned = scene.registry().has<SkinnedMeshRenderer>(entity);
+              // Nodes loaded with a skin draw the model's own pose in slot 0.
+              const auto *smr = scene.registry().has<SkinnedMeshRenderer>(entity)
+                                    ? &scene.registry().get<SkinnedMeshRenderer>(entity)
+                                    : nullptr;
+              bool isSkinned = smr != nullptr || scene.registry().has<SkinComponent>(entity);
               uint64_t instanceVertexBufferPtr =
                   (isSkinned && vertexBufferOverride != 0)
-                      ? vertexBufferOverride
+                      ? vertexBufferOverride +
+                            ((smr != nullptr ? smr->vertexSlot : 0U) * skinnedSlotStride)
                       : vertexBufferAddress;
 
               if (isSystemMesh) {
@@ -193,7 +237,7 @@ namespace pnkr::renderer::scene
                     .vertexBufferPtr = instanceVertexBufferPtr,
                     .materialIndex = matIndex,
                     .meshIndex = util::u32(systemMeshIndex),
-                    ._pad = {0}};
+                    .posDequant = glm::vec4(0.0F)};
 
                 uint32_t meshOrDepth = util::u32(systemMeshIndex);
                 if (st == SortingType::Transparent) {
@@ -201,18 +245,44 @@ namespace pnkr::renderer::scene
                   meshOrDepth = ~floatToOrderedInt(dist2);
                 }
 
+                const gpu::DrawIndexedIndirectCommandGPU cmd{
+                    .indexCount = prim.indexCount,
+                    .instanceCount = 1U,
+                    .firstIndex = prim.firstIndex,
+                    .vertexOffset = prim.vertexOffset,
+                    .firstInstance = firstInstance};
+                result.lodDraws[0]++;
+                result.lodTriangles[0] += cmd.indexCount / 3;
                 renderQueue.push_back(
                     {.sortKey = buildSortKey(st, matIndex, meshOrDepth),
-                     .cmd = {.indexCount = prim.indexCount,
-                             .instanceCount = 1U,
-                             .firstIndex = prim.firstIndex,
-                             .vertexOffset = prim.vertexOffset,
-                             .firstInstance = firstInstance},
+                     .cmd = cmd,
                      .bounds = bounds.aabb,
-                     .meshIndex = util::u32(systemMeshIndex)});
+                     .meshIndex = util::u32(systemMeshIndex),
+                     .lod = singleLod(cmd),
+                     .meshlets = {}});
               } else {
                 const uint32_t meshId = util::u32(meshComp.meshID);
                 const auto &mesh = meshes[meshId];
+                const glm::vec4 meshDequant =
+                    (instanceVertexBufferPtr == vertexBufferAddress)
+                        ? model.positionDequant(meshId)
+                        : glm::vec4(0.0F);
+
+                // Errors are in object space; scale them to the instance
+                // and measure from the nearest point of its bounds.
+                const float instanceScale = geometry::maxScale(m);
+                const glm::vec3 center =
+                    (bounds.aabb.m_min + bounds.aabb.m_max) * 0.5F;
+                const float radius =
+                    glm::length(bounds.aabb.m_max - bounds.aabb.m_min) * 0.5F;
+                const float lodDistance =
+                    std::max(glm::length(cameraPos - center) - radius, 0.0F);
+
+                // Meshlet bounds are in bind pose, so skinned instances draw
+                // whole. Normal cones only survive similarity transforms.
+                const bool useMeshlets =
+                    instanceVertexBufferPtr == vertexBufferAddress;
+                const bool conesValid = geometry::preservesNormalCones(m);
 
                 for (auto prim : mesh.primitives) {
                   uint32_t matIndex = (prim.materialIndex < materials.size())
@@ -230,7 +300,7 @@ namespace pnkr::renderer::scene
                       .vertexBufferPtr = instanceVertexBufferPtr,
                       .materialIndex = matIndex,
                       .meshIndex = meshId + systemMeshCount,
-                      ._pad = {0}};
+                      .posDequant = meshDequant};
 
                   uint32_t meshOrDepth = meshId + systemMeshCount;
                   if (st == SortingType::Transparent) {
@@ -238,18 +308,64 @@ namespace pnkr::renderer::scene
                     meshOrDepth = ~floatToOrderedInt(dist2);
                   }
 
+                  gpu::DrawLodGPU lod{};
+                  lod.lodCount = 1U + prim.lodCount;
+                  for (uint32_t level = 0; level < lod.lodCount; ++level) {
+                    const PrimitiveLod chain = prim.level(level);
+                    lod.firstIndex[level] = chain.firstIndex;
+                    lod.indexCount[level] = chain.indexCount;
+                    lod.error[level] = chain.error * instanceScale;
+                  }
+
+                  const uint32_t selected =
+                      lodErrorScale > 0.0F
+                          ? prim.selectLod(lodErrorScale * instanceScale,
+                                           lodDistance)
+                          : 0U;
+                  const PrimitiveLod level = prim.level(selected);
+
+                  gpu::MeshletDrawGPU meshlets{};
+                  if (useMeshlets) {
+                    meshlets.firstMeshlet = prim.firstMeshlet;
+                    meshlets.meshletCount = prim.meshletCount;
+                    meshlets.coneCulling =
+                        (conesValid && st == SortingType::Opaque) ? 1U : 0U;
+                  }
+                  result.lodDraws[selected]++;
+                  result.lodTriangles[selected] += level.indexCount / 3;
+
                   renderQueue.push_back(
                       {.sortKey = buildSortKey(st, matIndex, meshOrDepth),
-                       .cmd = {.indexCount = prim.indexCount,
+                       .cmd = {.indexCount = level.indexCount,
                                .instanceCount = 1U,
-                               .firstIndex = prim.firstIndex,
+                               .firstIndex = level.firstIndex,
                                .vertexOffset = prim.vertexOffset,
                                .firstInstance = firstInstance},
                        .bounds = bounds.aabb,
-                       .meshIndex = meshId + systemMeshCount});
+                       .meshIndex = meshId + systemMeshCount,
+                       .lod = lod,
+                       .meshlets = meshlets});
                 }
               }
-            });
+            };
+
+            if (useVisibleList) {
+              const auto &registry = scene.registry();
+              for (const ecs::Entity entity : *visibleMeshes) {
+                collectMesh(entity, registry.get<MeshRenderer>(entity),
+                            registry.get<WorldTransform>(entity),
+                            registry.get<WorldBounds>(entity));
+              }
+            } else {
+              meshView.each([&](ecs::Entity entity, MeshRenderer &meshComp,
+                                WorldTransform &world, Visibility &vis,
+                                WorldBounds &bounds) {
+                if (!ignoreVisibility && !vis.visible) {
+                  return;
+                }
+                collectMesh(entity, meshComp, world, bounds);
+              });
+            }
 
             sysView.each([&](ecs::Entity, SystemMeshRenderer& sysComp,
                              WorldTransform& world, Visibility& vis,
@@ -289,7 +405,7 @@ namespace pnkr::renderer::scene
                   .vertexBufferPtr = systemMeshVertexBufferAddress,
                   .materialIndex = matIndex,
                   .meshIndex = util::u32(systemMeshIndex),
-                  ._pad = {0}};
+                  .posDequant = glm::vec4(0.0F)};
 
               uint32_t meshOrDepth = util::u32(systemMeshIndex);
               if (st == SortingType::Transparent) {
@@ -297,15 +413,21 @@ namespace pnkr::renderer::scene
                 meshOrDepth = ~floatToOrderedInt(dist2);
               }
 
+              const gpu::DrawIndexedIndirectCommandGPU cmd{
+                  .indexCount = prim.indexCount,
+                  .instanceCount = 1U,
+                  .firstIndex = prim.firstIndex,
+                  .vertexOffset = prim.vertexOffset,
+                  .firstInstance = firstInstance};
+              result.lodDraws[0]++;
+              result.lodTriangles[0] += cmd.indexCount / 3;
               renderQueue.push_back(
                   {.sortKey = buildSortKey(st, matIndex, meshOrDepth),
-                   .cmd = {.indexCount = prim.indexCount,
-                           .instanceCount = 1U,
-                           .firstIndex = prim.firstIndex,
-                           .vertexOffset = prim.vertexOffset,
-                           .firstInstance = firstInstance},
+                   .cmd = cmd,
                    .bounds = bounds.aabb,
-                   .meshIndex = util::u32(systemMeshIndex)});
+                   .meshIndex = util::u32(systemMeshIndex),
+                   .lod = singleLod(cmd),
+                   .meshlets = {}});
             });
         }
 
@@ -325,6 +447,9 @@ namespace pnkr::renderer::scene
                 uint32_t* outCount = nullptr;
                 uint32_t* outMeshIndices = nullptr;
                 BoundingBox* outBounds = nullptr;
+                gpu::DrawLodGPU* outLods = nullptr;
+                gpu::MeshletDrawGPU* outMeshlets = nullptr;
+                uint32_t* outMeshletCount = nullptr;
 
                 switch (layer) {
                     case SortingType::Opaque:
@@ -332,12 +457,18 @@ namespace pnkr::renderer::scene
                         outCount = &result.opaqueCount;
                         outMeshIndices = result.opaqueMeshIndices;
                         outBounds = result.opaqueBounds;
+                        outLods = result.opaqueLods;
+                        outMeshlets = result.opaqueMeshletDraws;
+                        outMeshletCount = &result.opaqueMeshletCount;
                         break;
                     case SortingType::OpaqueDoubleSided:
                         outCmds = result.indirectOpaqueDoubleSided;
                         outCount = &result.opaqueDoubleSidedCount;
                         outMeshIndices = result.opaqueDoubleSidedMeshIndices;
                         outBounds = result.opaqueDoubleSidedBounds;
+                        outLods = result.opaqueDoubleSidedLods;
+                        outMeshlets = result.opaqueDoubleSidedMeshletDraws;
+                        outMeshletCount = &result.opaqueDoubleSidedMeshletCount;
                         break;
                     case SortingType::Transmission:
                         outCmds = result.indirectTransmission;
@@ -367,6 +498,13 @@ namespace pnkr::renderer::scene
                 outCmds[cmdIdx] = item.cmd;
                 outMeshIndices[cmdIdx] = item.meshIndex;
                 outBounds[cmdIdx] = item.bounds;
+                if (outLods != nullptr) {
+                  outLods[cmdIdx] = item.lod;
+                }
+                if (outMeshlets != nullptr) {
+                  outMeshlets[cmdIdx] = item.meshlets;
+                  *outMeshletCount += item.meshlets.meshletCount;
+                }
             };
 
             for (const auto& item : renderQueue) {
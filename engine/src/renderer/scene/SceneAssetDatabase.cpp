@@ -1,6 +1,8 @@
 #include "pnkr/renderer/scene/SceneAssetDatabase.hpp"
 #include "pnkr/renderer/rhi_renderer.hpp"
 #include "pnkr/rhi/rhi_buffer.hpp"
+#include "pnkr/core/logger.hpp"
+#include <algorithm>
 #include <limits>
 #include <glm/common.hpp>
 
@@ -73,15 +75,42 @@ namespace pnkr::renderer::scene
         if (indexBuffer.isValid()) {
             renderer.deferDestroyBuffer(indexBuffer.handle());
         }
+        m_vertexFormat = hasDeformation() ? geometry::VertexFormat::Full : m_requestedVertexFormat;
+        m_meshDequant.clear();
+        m_vertexUploadStats = {};
+        buildOccluderMeshes();
+
         if (!m_cpuVertices.empty()) {
+            std::vector<gpu::VertexCompactGPU> compact;
+            std::span<const std::byte> vertexBytes = std::as_bytes(std::span(m_cpuVertices));
+            if (m_vertexFormat == geometry::VertexFormat::Compact) {
+                geometry::encodeCompactVertices(m_cpuVertices, compact, m_meshDequant);
+                vertexBytes = std::as_bytes(std::span(compact));
+            } else if (m_requestedVertexFormat == geometry::VertexFormat::Compact) {
+                core::Logger::Asset.info("ModelDOD: model has skins or morph targets, keeping the full vertex layout");
+            }
+
             vertexBuffer = renderer.createBuffer("ModelDOD_UnifiedVBO", {
-                .size = m_cpuVertices.size() * sizeof(Vertex),
+                .size = vertexBytes.size(),
                 .usage = rhi::BufferUsage::VertexBuffer | rhi::BufferUsage::StorageBuffer |
                          rhi::BufferUsage::ShaderDeviceAddress | rhi::BufferUsage::TransferDst,
                 .memoryUsage = rhi::MemoryUsage::CPUToGPU,
                 .debugName = "ModelDOD Unified VBO"
             });
-            renderer.getBuffer(vertexBuffer.handle())->uploadData(std::as_bytes(std::span(m_cpuVertices)));
+            renderer.getBuffer(vertexBuffer.handle())->uploadData(vertexBytes);
+
+            m_vertexUploadStats.vertexCount = util::u32(m_cpuVertices.size());
+            m_vertexUploadStats.bytes = vertexBytes.size();
+            m_vertexUploadStats.fullBytes = m_cpuVertices.size() * sizeof(Vertex);
+            if (m_vertexFormat == geometry::VertexFormat::Compact) {
+                constexpr double kMiB = 1024.0 * 1024.0;
+                core::Logger::Asset.info("ModelDOD: {} compact vertices, {:.2f} MiB instead of {:.2f} MiB ({:.0f}% saved)",
+                    m_vertexUploadStats.vertexCount,
+                    static_cast<double>(m_vertexUploadStats.bytes) / kMiB,
+                    static_cast<double>(m_vertexUploadStats.fullBytes) / kMiB,
+                    100.0 * (1.0 - static_cast<double>(m_vertexUploadStats.bytes) /
+                                   static_cast<double>(m_vertexUploadStats.fullBytes)));
+            }
         }
 
 
@@ -108,5 +137,106 @@ namespace pnkr::renderer::scene
             });
             renderer.getBuffer(boundsBuffer.handle())->uploadData(std::as_bytes(std::span(m_meshBounds)));
         }
+
+        if (meshletBuffer.isValid()) {
+            renderer.deferDestroyBuffer(meshletBuffer.handle());
+            meshletBuffer = {};
+        }
+        if (!m_meshlets.empty()) {
+            meshletBuffer = renderer.createBuffer("ModelDOD_Meshlets", {
+                .size = m_meshlets.size() * sizeof(gpu::MeshletGPU),
+                .usage = rhi::BufferUsage::StorageBuffer | rhi::BufferUsage::ShaderDeviceAddress | rhi::BufferUsage::TransferDst,
+                .memoryUsage = rhi::MemoryUsage::CPUToGPU,
+                .debugName = "ModelDOD Meshlets"
+            });
+            renderer.getBuffer(meshletBuffer.handle())->uploadData(std::as_bytes(std::span(m_meshlets)));
+        }
+    }
+
+    void SceneAssetDatabase::buildOccluderMeshes()
+    {
+        m_occluderMeshes.assign(m_meshes.size(), {});
+        if (m_cpuVertices.empty() || m_cpuIndices.empty()) {
+            return;
+        }
+
+        uint32_t occluders = 0;
+        for (uint32_t meshId = 0; meshId < m_meshes.size(); ++meshId) {
+            const MeshDOD& mesh = m_meshes[meshId];
+            const bool morphed = std::ranges::any_of(m_morphTargetInfos, [meshId](const MorphTargetInfo& info) {
+                return info.meshIndex == meshId && !info.targetOffsets.empty();
+            });
+            uint64_t triangles = 0;
+            bool usable = !morphed && !mesh.primitives.empty();
+            for (const PrimitiveDOD& prim : mesh.primitives) {
+                triangles += prim.indexCount / 3;
+                // Only surfaces nothing can be seen through may hide others:
+                // masked and blended alpha, transmission and volumes all let
+                // what is behind them show.
+                bool opaque = true;
+                if (prim.materialIndex < m_materials.size()) {
+                    const MaterialData& mat = m_materials[prim.materialIndex];
+                    opaque = mat.alphaMode == 0U && mat.transmissionFactor <= 0.0F &&
+                             mat.volumeThicknessFactor <= 0.0F;
+                }
+                usable = usable && opaque &&
+                         static_cast<size_t>(prim.firstIndex) + prim.indexCount <= m_cpuIndices.size();
+            }
+            if (!usable || triangles == 0 || triangles > kMaxOccluderTriangles) {
+                continue;
+            }
+
+            OccluderMesh occluder;
+            for (const PrimitiveDOD& prim : mesh.primitives) {
+                const auto indices = std::span(m_cpuIndices).subspan(prim.firstIndex, prim.indexCount - prim.indexCount % 3);
+                if (indices.empty()) {
+                    continue;
+                }
+                const auto [minIt, maxIt] = std::ranges::minmax_element(indices);
+                const size_t first = static_cast<size_t>(prim.vertexOffset) + *minIt;
+                const size_t last = static_cast<size_t>(prim.vertexOffset) + *maxIt;
+                if (last >= m_cpuVertices.size()) {
+                    usable = false;
+                    break;
+                }
+
+                const auto base = util::u32(occluder.positions.size());
+                for (size_t v = first; v <= last; ++v) {
+                    // Skinned vertices move every frame; the copy would be stale.
+                    usable = usable && m_cpuVertices[v].weights == glm::vec4(0.0f);
+                    occluder.positions.emplace_back(m_cpuVertices[v].position);
+                }
+                for (const uint32_t idx : indices) {
+                    occluder.indices.push_back(base + (idx - *minIt));
+                }
+            }
+            if (usable) {
+                m_occluderMeshes[meshId] = std::move(occluder);
+                ++occluders;
+            }
+        }
+        core::Logger::Asset.info("ModelDOD: {} of {} meshes kept as occluders", occluders, m_meshes.size());
+    }
+
+    bool SceneAssetDatabase::hasDeformation() const
+    {
+        if (!m_skins.empty()) {
+            return true;
+        }
+        return std::ranges::any_of(m_morphTargetInfos, [](const MorphTargetInfo& info) {
+            return !info.targetOffsets.empty();
+        });
+    }
+
+    const CompiledAnimationClip& SceneAssetDatabase::compiledAnimation(uint32_t index)
+    {
+        if (m_compiledAnimations.size() != m_animations.size()) {
+            m_compiledAnimations.clear();
+            m_compiledAnimations.reserve(m_animations.size());
+            for (const auto& anim : m_animations) {
+                m_compiledAnimations.push_back(CompiledAnimationClip::compile(anim));
+            }
+        }
+        return m_compiledAnimations[index];
     }
 }
@@ -0,0 +1,644 @@
+#include "pnkr/renderer/scene/SceneBVH.hpp"
+
+#include "pnkr/core/TaskSystem.hpp"
+#include "pnkr/core/profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace pnkr::renderer::scene {
+
+    namespace {
+        constexpr uint32_t kSahBins = 16;
+        // Below this many leaves a serial build beats task overhead.
+        constexpr uint32_t kParallelBuildLeaves = 4096;
+        constexpr uint32_t kMinSubtreeLeaves = 512;
+        // Inserts before the first rebuild are placed incrementally.
+        constexpr uint32_t kMinRebuildChurn = 32;
+        // Refit only grows boxes around moved leaves; once the root has grown
+        // this much since the last build the partition is stale.
+        constexpr float kMaxRootGrowth = 2.0f;
+
+        struct BuildItem {
+            BoundingBox box;
+            glm::vec3 centroid;
+            ecs::Entity entity;
+        };
+
+        struct BuildJob {
+            uint32_t begin;
+            uint32_t end;
+            uint32_t node;
+        };
+
+        BoundingBox merge(const BoundingBox& a, const BoundingBox& b) {
+            BoundingBox out;
+            out.m_min = glm::min(a.m_min, b.m_min);
+            out.m_max = glm::max(a.m_max, b.m_max);
+            return out;
+        }
+
+        bool sameBox(const BoundingBox& a, const BoundingBox& b) {
+            return a.m_min == b.m_min && a.m_max == b.m_max;
+        }
+
+        float surfaceArea(const BoundingBox& box) {
+            if (!box.isValid()) {
+                return 0.0f;
+            }
+            const glm::vec3 d = box.m_max - box.m_min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        // Plane test shared with geometry::cullBoxes: the box is out when its
+        // extent projected on the normal cannot reach the positive side.
+        enum class PlaneSide { Outside, Intersecting, Inside };
+
+        PlaneSide classify(const glm::vec4& plane, const BoundingBox& box) {
+            const glm::vec3 n(plane);
+            const glm::vec3 c = (box.m_min + box.m_max) * 0.5f;
+            const glm::vec3 e = (box.m_max - box.m_min) * 0.5f;
+            const float d = glm::dot(n, c) + plane.w;
+            const float r = glm::dot(glm::abs(n), e);
+            if (d + r < 0.0f) {
+                return PlaneSide::Outside;
+            }
+            return (d - r >= 0.0f) ? PlaneSide::Inside : PlaneSide::Intersecting;
+        }
+
+        bool overlapsSphere(const BoundingBox& box, const glm::vec3& center, float radiusSq) {
+            const glm::vec3 closest = glm::min(glm::max(center, box.m_min), box.m_max);
+            const glm::vec3 d = closest - center;
+            return glm::dot(d, d) <= radiusSq;
+        }
+
+        // Slab test; tNear may be negative when the origin is inside the box.
+        bool intersectSlabs(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& invDir,
+                            float& tNear, float& tFar) {
+            const glm::vec3 t0 = (box.m_min - origin) * invDir;
+            const glm::vec3 t1 = (box.m_max - origin) * invDir;
+            const glm::vec3 tmin = glm::min(t0, t1);
+            const glm::vec3 tmax = glm::max(t0, t1);
+            tNear = std::max(std::max(tmin.x, tmin.y), tmin.z);
+            tFar = std::min(std::min(tmax.x, tmax.y), tmax.z);
+            return tFar >= 0.0f && tNear <= tFar;
+        }
+
+        // Picks a split of [begin, end) by binned SAH along the longest centroid
+        // axis and partitions the items around it. The result is always
+        // strictly inside the range.
+        uint32_t partitionSah(std::vector<BuildItem>& items, uint32_t begin, uint32_t end,
+                              const BoundingBox& centroids) {
+            const glm::vec3 extent = centroids.m_max - centroids.m_min;
+            int axis = extent.x > extent.y ? 0 : 1;
+            axis = extent[axis] > extent.z ? axis : 2;
+
+            const uint32_t half = begin + (end - begin) / 2;
+            if (!(extent[axis] > 0.0f)) {
+                // Every centroid coincides; any split is as good as another.
+                return half;
+            }
+
+            const float minC = centroids.m_min[axis];
+            const float scale = static_cast<float>(kSahBins) / extent[axis];
+            const auto binOf = [&](const BuildItem& item) {
+                return std::min(static_cast<uint32_t>((item.centroid[axis] - minC) * scale), kSahBins - 1);
+            };
+
+            std::array<BoundingBox, kSahBins> binBoxes{};
+            std::array<uint32_t, kSahBins> binCounts{};
+            for (uint32_t i = begin; i < end; ++i) {
+                const uint32_t bin = binOf(items[i]);
+                ++binCounts[bin];
+                binBoxes[bin] = merge(binBoxes[bin], items[i].box);
+            }
+
+            // The lowest and highest centroids land in the first and last bin,
+            // so every candidate split below has items on both sides.
+            std::array<float, kSahBins> rightCost{};
+            BoundingBox accum;
+            uint32_t count = 0;
+            for (uint32_t b = kSahBins - 1; b > 0; --b) {
+                accum = merge(accum, binBoxes[b]);
+                count += binCounts[b];
+                rightCost[b] = surfaceArea(accum) * static_cast<float>(count);
+            }
+
+            float bestCost = std::numeric_limits<float>::max();
+            uint32_t bestBin = kSahBins / 2;
+            accum = {};
+            count = 0;
+            for (uint32_t b = 0; b + 1 < kSahBins; ++b) {
+                accum = merge(accum, binBoxes[b]);
+                count += binCounts[b];
+                const float cost = surfaceArea(accum) * static_cast<float>(count) + rightCost[b + 1];
+                if (count != 0 && cost < bestCost) {
+                    bestCost = cost;
+                    bestBin = b + 1;
+                }
+            }
+
+            auto* first = items.data() + begin;
+            auto* mid = std::partition(first, items.data() + end,
+                                       [&](const BuildItem& item) { return binOf(item) < bestBin; });
+            const auto split = static_cast<uint32_t>(mid - items.data());
+            if (split == begin || split == end) {
+                std::nth_element(first, items.data() + half, items.data() + end,
+                                 [axis](const BuildItem& a, const BuildItem& b) {
+                                     return a.centroid[axis] < b.centroid[axis];
+                                 });
+                return half;
+            }
+            return split;
+        }
+
+        // Builds the subtree for job.node (already allocated in nodes) without
+        // recursion. Ranges of at most deferLimit items are handed back in
+        // deferred instead of being built.
+        template <typename NodeT>
+        void buildSubtree(std::vector<BuildItem>& items, const BuildJob& rootJob, std::vector<NodeT>& nodes,
+                          uint32_t deferLimit, std::vector<BuildJob>* deferred) {
+            std::vector<BuildJob> stack;
+            stack.push_back(rootJob);
+            while (!stack.empty()) {
+                const BuildJob job = stack.back();
+                stack.pop_back();
+
+                if (deferred != nullptr && job.end - job.begin <= deferLimit) {
+                    deferred->push_back(job);
+                    continue;
+                }
+
+                BoundingBox box;
+                BoundingBox centroids;
+                for (uint32_t i = job.begin; i < job.end; ++i) {
+                    box = merge(box, items[i].box);
+                    centroids.combine(items[i].centroid);
+                }
+                nodes[job.node].box = box;
+
+                if (job.end - job.begin == 1) {
+                    nodes[job.node].entity = items[job.begin].entity;
+                    continue;
+                }
+
+                const uint32_t mid = partitionSah(items, job.begin, job.end, centroids);
+                const auto left = static_cast<uint32_t>(nodes.size());
+                nodes.emplace_back();
+                nodes.emplace_back();
+                nodes[left].parent = job.node;
+                nodes[left + 1].parent = job.node;
+                nodes[job.node].left = left;
+                nodes[job.node].right = left + 1;
+                stack.push_back({mid, job.end, left + 1});
+                stack.push_back({job.begin, mid, left});
+            }
+        }
+    }
+
+    void SceneBVH::clear() {
+        m_nodes.clear();
+        m_freeNodes.clear();
+        m_leafOf.clear();
+        m_changedLeaves.clear();
+        m_root = kNullNode;
+        m_rebuildPending = false;
+        m_builtRootArea = 0.0f;
+        m_stats = {};
+    }
+
+    uint32_t SceneBVH::allocateNode() {
+        if (!m_freeNodes.empty()) {
+            const uint32_t index = m_freeNodes.back();
+            m_freeNodes.pop_back();
+            m_nodes[index] = {};
+            return index;
+        }
+        m_nodes.emplace_back();
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+
+    void SceneBVH::freeNode(uint32_t index) {
+        m_nodes[index] = {};
+        m_freeNodes.push_back(index);
+    }
+
+    bool SceneBVH::needsRebuild() const noexcept {
+        return m_stats.churn > kMinRebuildChurn && m_stats.churn * 4 > m_stats.leafCount;
+    }
+
+    void SceneBVH::update(ecs::Entity entity, const BoundingBox& box) {
+        if (!box.isValid()) {
+            remove(entity);
+            return;
+        }
+
+        if (contains(entity)) {
+            const uint32_t leaf = m_leafOf[entity];
+            m_nodes[leaf].box = box;
+            m_changedLeaves.push_back(leaf);
+            return;
+        }
+
+        if (entity >= m_leafOf.size()) {
+            m_leafOf.resize(static_cast<size_t>(entity) + 1, kNullNode);
+        }
+        const uint32_t leaf = allocateNode();
+        m_nodes[leaf].box = box;
+        m_nodes[leaf].entity = entity;
+        m_leafOf[entity] = leaf;
+        ++m_stats.leafCount;
+        ++m_stats.churn;
+
+        // Past the churn limit the leaf waits unlinked for the rebuild.
+        if (m_rebuildPending || needsRebuild()) {
+            m_rebuildPending = true;
+            return;
+        }
+        insertLeaf(leaf);
+    }
+
+    void SceneBVH::remove(ecs::Entity entity) {
+        if (!contains(entity)) {
+            return;
+        }
+        const uint32_t leaf = m_leafOf[entity];
+        detachLeaf(leaf);
+        freeNode(leaf);
+        m_leafOf[entity] = kNullNode;
+        --m_stats.leafCount;
+        ++m_stats.churn;
+        m_rebuildPending = m_rebuildPending || needsRebuild();
+    }
+
+    void SceneBVH::insertLeaf(uint32_t leaf) {
+        if (m_root == kNullNode) {
+            m_root = leaf;
+            m_nodes[leaf].parent = kNullNode;
+            return;
+        }
+
+        // Descend towards the sibling with the smallest SAH increase, as in
+        // Box2D's dynamic tree.
+        const BoundingBox box = m_nodes[leaf].box;
+        uint32_t index = m_root;
+        while (!m_nodes[index].isLeaf()) {
+            const Node& node = m_nodes[index];
+            const float area = surfaceArea(node.box);
+            const float combinedArea = surfaceArea(merge(node.box, box));
+            const float cost = 2.0f * combinedArea;
+            const float inheritance = 2.0f * (combinedArea - area);
+
+            const auto descendCost = [&](uint32_t child) {
+                const Node& c = m_nodes[child];
+                const float grown = surfaceArea(merge(c.box, box));
+                return (c.isLeaf() ? grown : grown - surfaceArea(c.box)) + inheritance;
+            };
+            const float costLeft = descendCost(node.left);
+            const float costRight = descendCost(node.right);
+            if (cost < costLeft && cost < costRight) {
+                break;
+            }
+            index = costLeft < costRight ? node.left : node.right;
+        }
+
+        const uint32_t sibling = index;
+        const uint32_t parent = allocateNode();
+        const uint32_t oldParent = m_nodes[sibling].parent;
+        m_nodes[parent].box = merge(box, m_nodes[sibling].box);
+        m_nodes[parent].parent = oldParent;
+        m_nodes[parent].left = sibling;
+        m_nodes[parent].right = leaf;
+        m_nodes[sibling].parent = parent;
+        m_nodes[leaf].parent = parent;
+
+        if (oldParent == kNullNode) {
+            m_root = parent;
+            return;
+        }
+        Node& old = m_nodes[oldParent];
+        (old.left == sibling ? old.left : old.right) = parent;
+        refitUpwards(oldParent);
+    }
+
+    void SceneBVH::detachLeaf(uint32_t leaf) {
+        if (leaf == m_root) {
+            m_root = kNullNode;
+            return;
+        }
+        const uint32_t parent = m_nodes[leaf].parent;
+        if (parent == kNullNode) {
+            return;
+        }
+
+        const uint32_t grandParent = m_nodes[parent].parent;
+        const uint32_t sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+        m_nodes[sibling].parent = grandParent;
+        if (grandParent == kNullNode) {
+            m_root = sibling;
+        } else {
+            Node& gp = m_nodes[grandParent];
+            (gp.left == parent ? gp.left : gp.right) = sibling;
+            refitUpwards(grandParent);
+        }
+        freeNode(parent);
+        m_nodes[leaf].parent = kNullNode;
+    }
+
+    void SceneBVH::refitUpwards(uint32_t index) {
+        while (index != kNullNode) {
+            Node& node = m_nodes[index];
+            const BoundingBox box = merge(m_nodes[node.left].box, m_nodes[node.right].box);
+            if (sameBox(box, node.box)) {
+                // Ancestors already contain this box.
+                return;
+            }
+            node.box = box;
+            index = node.parent;
+        }
+    }
+
+    void SceneBVH::refit() {
+        PNKR_PROFILE_FUNCTION();
+        m_stats.refitLeaves = 0;
+        if (m_rebuildPending) {
+            rebuild();
+            return;
+        }
+
+        for (const uint32_t leaf : m_changedLeaves) {
+            const Node& node = m_nodes[leaf];
+            // Skip entries whose leaf was removed (and possibly reused) since.
+            if (!node.isLeaf() || node.entity == ecs::kNullEntity || m_leafOf[node.entity] != leaf) {
+                continue;
+            }
+            ++m_stats.refitLeaves;
+            refitUpwards(node.parent);
+        }
+        m_changedLeaves.clear();
+
+        if (m_root != kNullNode && m_builtRootArea > 0.0f &&
+            surfaceArea(m_nodes[m_root].box) > kMaxRootGrowth * m_builtRootArea) {
+            rebuild();
+        }
+    }
+
+    void SceneBVH::rebuild() {
+        PNKR_PROFILE_FUNCTION();
+
+        std::vector<BuildItem> items;
+        items.reserve(m_stats.leafCount);
+        for (size_t e = 0; e < m_leafOf.size(); ++e) {
+            if (m_leafOf[e] != kNullNode) {
+                const BoundingBox& box = m_nodes[m_leafOf[e]].box;
+                items.push_back({box, (box.m_min + box.m_max) * 0.5f, static_cast<ecs::Entity>(e)});
+            }
+        }
+
+        m_nodes.clear();
+        m_freeNodes.clear();
+        m_changedLeaves.clear();
+        m_root = kNullNode;
+        m_rebuildPending = false;
+        m_stats.churn = 0;
+        ++m_stats.rebuilds;
+
+        const auto count = static_cast<uint32_t>(items.size());
+        if (count == 0) {
+            m_builtRootArea = 0.0f;
+            m_stats.nodeCount = 0;
+            m_stats.sahCost = 0.0f;
+            return;
+        }
+
+        m_nodes.reserve(2 * static_cast<size_t>(count) - 1);
+        m_nodes.emplace_back();
+        m_root = 0;
+
+        if (count < kParallelBuildLeaves) {
+            buildSubtree(items, {0, count, 0}, m_nodes, 0, nullptr);
+        } else {
+            // Split the top of the tree serially, then build the remaining
+            // disjoint item ranges as independent subtrees.
+            const uint32_t deferLimit = std::max(kMinSubtreeLeaves, count / 64);
+            std::vector<BuildJob> deferred;
+            buildSubtree(items, {0, count, 0}, m_nodes, deferLimit, &deferred);
+
+            std::vector<std::vector<Node>> subtrees(deferred.size());
+            core::TaskSystem::parallelFor(
+                static_cast<uint32_t>(deferred.size()),
+                [&](enki::TaskSetPartition range, uint32_t) {
+                    for (uint32_t i = range.start; i < range.end; ++i) {
+                        const BuildJob& job = deferred[i];
+                        auto& local = subtrees[i];
+                        local.reserve(2 * static_cast<size_t>(job.end - job.begin) - 1);
+                        local.emplace_back();
+                        buildSubtree(items, {job.begin, job.end, 0}, local, 0, nullptr);
+                    }
+                });
+
+            // Local node 0 lands on the placeholder; the rest are appended.
+            for (size_t i = 0; i < deferred.size(); ++i) {
+                const auto& local = subtrees[i];
+                const uint32_t placeholder = deferred[i].node;
+                const auto base = static_cast<uint32_t>(m_nodes.size());
+                const auto remap = [&](uint32_t index) {
+                    if (index == kNullNode) {
+                        return kNullNode;
+                    }
+                    return index == 0 ? placeholder : base + index - 1;
+                };
+
+                for (size_t n = 1; n < local.size(); ++n) {
+                    Node node = local[n];
+                    node.parent = remap(node.parent);
+                    node.left = remap(node.left);
+                    node.right = remap(node.right);
+                    m_nodes.push_back(node);
+                }
+                Node& root = m_nodes[placeholder];
+                root.box = local[0].box;
+                root.entity = local[0].entity;
+                root.left = remap(local[0].left);
+                root.right = remap(local[0].right);
+            }
+        }
+
+        float areaSum = 0.0f;
+        for (uint32_t n = 0; n < m_nodes.size(); ++n) {
+            const Node& node = m_nodes[n];
+            if (node.isLeaf()) {
+                m_leafOf[node.entity] = n;
+            }
+            areaSum += surfaceArea(node.box);
+        }
+        const float rootArea = surfaceArea(m_nodes[m_root].box);
+        m_builtRootArea = rootArea;
+        m_stats.nodeCount = static_cast<uint32_t>(m_nodes.size());
+        m_stats.sahCost = rootArea > 0.0f ? areaSum / rootArea : 0.0f;
+    }
+
+    BoundingBox SceneBVH::bounds() const {
+        return m_root == kNullNode ? BoundingBox{} : m_nodes[m_root].box;
+    }
+
+    void SceneBVH::appendSubtree(uint32_t index, std::vector<ecs::Entity>& out) const {
+        std::vector<uint32_t> stack{index};
+        while (!stack.empty()) {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+            if (node.isLeaf()) {
+                out.push_back(node.entity);
+            } else {
+                stack.push_back(node.right);
+                stack.push_back(node.left);
+            }
+        }
+    }
+
+    void SceneBVH::queryFrustum(const geometry::Frustum& frustum, std::vector<ecs::Entity>& out) const {
+        PNKR_PROFILE_FUNCTION();
+        if (m_root == kNullNode) {
+            return;
+        }
+
+        // Each entry carries the planes its box still straddles; a subtree
+        // fully inside every plane is emitted without further tests.
+        struct Entry {
+            uint32_t node;
+            uint8_t planeMask;
+        };
+        std::vector<Entry> stack;
+        stack.reserve(64);
+        stack.push_back({m_root, 0x3F});
+
+        while (!stack.empty()) {
+            const Entry entry = stack.back();
+            stack.pop_back();
+            const Node& node = m_nodes[entry.node];
+
+            uint8_t mask = entry.planeMask;
+            bool outside = false;
+            for (uint32_t p = 0; p < 6 && !outside; ++p) {
+                if ((mask & (1U << p)) == 0) {
+                    continue;
+                }
+                const PlaneSide side = classify(frustum.planes[p], node.box);
+                outside = side == PlaneSide::Outside;
+                if (side == PlaneSide::Inside) {
+                    mask = static_cast<uint8_t>(mask & ~(1U << p));
+                }
+            }
+            if (outside) {
+                continue;
+            }
+
+            if (node.isLeaf()) {
+                out.push_back(node.entity);
+            } else if (mask == 0) {
+                appendSubtree(entry.node, out);
+            } else {
+                stack.push_back({node.right, mask});
+                stack.push_back({node.left, mask});
+            }
+        }
+    }
+
+    void SceneBVH::queryAabb(const BoundingBox& box, std::vector<ecs::Entity>& out) const {
+        if (m_root == kNullNode || !box.isValid()) {
+            return;
+        }
+        std::vector<uint32_t> stack{m_root};
+        while (!stack.empty()) {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+            if (!node.box.intersects(box)) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                out.push_back(node.entity);
+            } else {
+                stack.push_back(node.right);
+                stack.push_back(node.left);
+            }
+        }
+    }
+
+    void SceneBVH::querySphere(const glm::vec3& center, float radius, std::vector<ecs::Entity>& out) const {
+        if (m_root == kNullNode || radius < 0.0f) {
+            return;
+        }
+        const float radiusSq = radius * radius;
+        std::vector<uint32_t> stack{m_root};
+        while (!stack.empty()) {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+            if (!overlapsSphere(node.box, center, radiusSq)) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                out.push_back(node.entity);
+            } else {
+                stack.push_back(node.right);
+                stack.push_back(node.left);
+            }
+        }
+    }
+
+    BvhRayHit SceneBVH::raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT) const {
+        BvhRayHit best;
+        best.t = maxT;
+        if (m_root == kNullNode) {
+            return best;
+        }
+
+        const glm::vec3 invDir = 1.0f / dir;
+        struct Entry {
+            uint32_t node;
+            float entry;
+        };
+        std::vector<Entry> stack;
+        stack.reserve(64);
+
+        float tNear = 0.0f;
+        float tFar = 0.0f;
+        if (!intersectSlabs(m_nodes[m_root].box, origin, invDir, tNear, tFar)) {
+            return best;
+        }
+        stack.push_back({m_root, std::max(tNear, 0.0f)});
+
+        while (!stack.empty()) {
+            const Entry entry = stack.back();
+            stack.pop_back();
+            if (entry.entry > best.t) {
+                continue;
+            }
+            const Node& node = m_nodes[entry.node];
+            if (node.isLeaf()) {
+                intersectSlabs(node.box, origin, invDir, tNear, tFar);
+                const float t = tNear >= 0.0f ? tNear : tFar;
+                if (t <= best.t) {
+                    best = {node.entity, t};
+                }
+                continue;
+            }
+
+            // Visit the nearer child first so the far one is usually pruned.
+            Entry children[2];
+            uint32_t hits = 0;
+            for (const uint32_t child : {node.left, node.right}) {
+                if (intersectSlabs(m_nodes[child].box, origin, invDir, tNear, tFar) && tNear <= best.t) {
+                    children[hits++] = {child, std::max(tNear, 0.0f)};
+                }
+            }
+            if (hits == 2 && children[0].entry < children[1].entry) {
+                std::swap(children[0], children[1]);
+            }
+            for (uint32_t i = 0; i < hits; ++i) {
+                stack.push_back(children[i]);
+            }
+        }
+        return best;
+    }
+}
@@ -1,7 +1,10 @@
 #include "pnkr/renderer/scene/SceneGraph.hpp"
+#include "pnkr/core/TaskSystem.hpp"
+#include "pnkr/core/profiler.hpp"
+#include "pnkr/renderer/geometry/SimdMath.hpp"
 #include "pnkr/renderer/scene/Bounds.hpp"
 #include <algorithm>
-#include <stack>
+#include <atomic>
 
 namespace pnkr::renderer::scene {
 
@@ -79,52 +82,219 @@ namespace pnkr::renderer::scene {
           m_root = ecs::kNullEntity;
         }
 
+        releaseCullSlot(entity);
+        m_bvh.remove(entity);
         m_registry.destroy(entity);
         m_hierarchyDirty = true;
     }
 
-    void SceneGraphDOD::updateTopoOrder() {
-        m_topoOrder.clear();
-        std::stack<ecs::Entity> stack;
-        for (auto it = m_roots.rbegin(); it != m_roots.rend(); ++it) {
-            stack.push(*it);
+    uint32_t SceneGraphDOD::acquireCullSlot(ecs::Entity entity) {
+        if (entity >= m_cullSlots.size()) {
+          m_cullSlots.resize(static_cast<size_t>(entity) + 1, kNoSlot);
+        }
+        if (m_cullSlots[entity] == kNoSlot) {
+          m_cullSlots[entity] = static_cast<uint32_t>(m_cullEntities.size());
+          m_cullEntities.push_back(entity);
+          m_cullBounds.resize(static_cast<uint32_t>(m_cullEntities.size()));
         }
+        return m_cullSlots[entity];
+    }
 
-        while (!stack.empty()) {
-            ecs::Entity e = stack.top();
-            stack.pop();
-            m_topoOrder.push_back(e);
+    void SceneGraphDOD::releaseCullSlot(ecs::Entity entity) {
+        const uint32_t slot = cullSlotOf(entity);
+        if (slot == kNoSlot) {
+          return;
+        }
+        const ecs::Entity moved = m_cullEntities.back();
+        m_cullEntities[slot] = moved;
+        m_cullEntities.pop_back();
+        m_cullSlots[moved] = slot;
+        m_cullSlots[entity] = kNoSlot;
+        m_cullBounds.swapRemove(slot);
+    }
 
-            auto &rel = m_registry.get<Relationship>(e);
+    namespace {
+        // Levels smaller than this are propagated inline; dispatch overhead dominates below it.
+        constexpr uint32_t kMinParallelLevelSize = 1024;
+    }
 
-            ecs::Entity child = rel.firstChild();
-            std::vector<ecs::Entity> children;
-            while (child != ecs::kNullEntity) {
-                children.push_back(child);
-                child = m_registry.get<Relationship>(child).nextSibling();
-            }
-            for (auto it = children.rbegin(); it != children.rend(); ++it) {
-                stack.push(*it);
+    void SceneGraphDOD::updateTopoOrder() {
+        m_topoOrder.assign(m_roots.begin(), m_roots.end());
+        m_parentSlots.assign(m_topoOrder.size(), kNoSlot);
+        m_levelOffsets.assign(1, 0);
+
+        // Breadth-first walk straight into m_topoOrder: each pass appends the next level's bucket.
+        size_t levelBegin = 0;
+        uint16_t level = 0;
+        while (levelBegin < m_topoOrder.size()) {
+            const size_t levelEnd = m_topoOrder.size();
+            m_levelOffsets.push_back(util::u32(levelEnd));
+            for (size_t slot = levelBegin; slot < levelEnd; ++slot) {
+                auto &rel = m_registry.get<Relationship>(m_topoOrder[slot]);
+                rel.setLevel(level);
+                for (ecs::Entity child = rel.firstChild(); child != ecs::kNullEntity;
+                     child = m_registry.get<Relationship>(child).nextSibling()) {
+                    m_topoOrder.push_back(child);
+                    m_parentSlots.push_back(util::u32(slot));
+                }
             }
+            levelBegin = levelEnd;
+            ++level;
         }
+
+        ecs::Entity maxEntity = 0;
+        for (ecs::Entity e : m_topoOrder) {
+            maxEntity = std::max(maxEntity, e);
+        }
+        m_entitySlots.assign(m_topoOrder.empty() ? 0 : size_t(maxEntity) + 1, kNoSlot);
+        for (size_t slot = 0; slot < m_topoOrder.size(); ++slot) {
+            m_entitySlots[m_topoOrder[slot]] = util::u32(slot);
+        }
+
+        resolveComponentSlots();
+        ++m_topologyVersion;
+
+        const auto &worldPool = m_registry.getPool<WorldTransform>();
+        m_worldMatrices.resize(m_topoOrder.size());
+        for (size_t slot = 0; slot < m_topoOrder.size(); ++slot) {
+            const size_t worldIndex = m_worldIndices[slot];
+            m_worldMatrices[slot] = worldIndex != ecs::SparseSet<WorldTransform>::npos
+                                        ? worldPool.data()[worldIndex].matrix
+                                        : glm::mat4(1.0f);
+        }
+
         m_hierarchyDirty = false;
     }
 
-    void SceneGraphDOD::recalculateGlobalTransformsFull() {
-      if (m_hierarchyDirty) {
-        updateTopoOrder();
-      }
+    void SceneGraphDOD::resolveComponentSlots() {
+        // Slots index the transform pools' dense arrays, which archetype chunks don't have.
+        PNKR_ASSERT(m_registry.storageMode() == ecs::StorageMode::SparseSet,
+                    "SceneGraphDOD requires sparse set storage");
+        const auto &localPool = m_registry.getPool<LocalTransform>();
+        const auto &worldPool = m_registry.getPool<WorldTransform>();
+
+        m_localIndices.resize(m_topoOrder.size());
+        m_worldIndices.resize(m_topoOrder.size());
+        for (size_t slot = 0; slot < m_topoOrder.size(); ++slot) {
+            m_localIndices[slot] = localPool.indexOf(m_topoOrder[slot]);
+            m_worldIndices[slot] = worldPool.indexOf(m_topoOrder[slot]);
+        }
+        m_resolvedLocalVersion = localPool.version();
+        m_resolvedWorldVersion = worldPool.version();
+    }
 
-        for (ecs::Entity e : m_topoOrder) {
-            const Relationship& rel = m_registry.get<Relationship>(e);
-            const glm::mat4& local = m_registry.get<LocalTransform>(e).matrix;
+    uint32_t SceneGraphDOD::seedDirtySlots() {
+        m_dirtySlots.assign(m_topoOrder.size(), 0);
 
-            if (rel.parent() != ecs::kNullEntity) {
-                m_registry.get<WorldTransform>(e).matrix = m_registry.get<WorldTransform>(rel.parent()).matrix * local;
-            } else {
-                m_registry.get<WorldTransform>(e).matrix = local;
+        uint32_t firstSlot = kNoSlot;
+        for (ecs::Entity e : m_registry.getPool<TransformDirtyTag>().entities()) {
+            const uint32_t slot = slotOf(e);
+            if (slot != kNoSlot) {
+                m_dirtySlots[slot] = 1;
+                firstSlot = std::min(firstSlot, slot);
+            }
+        }
+
+        if (firstSlot == kNoSlot) {
+            return util::u32(m_levelOffsets.size() - 1);
+        }
+        auto it = std::ranges::upper_bound(m_levelOffsets, firstSlot);
+        return util::u32(std::distance(m_levelOffsets.begin(), it) - 1);
+    }
+
+    uint32_t SceneGraphDOD::propagateLevels(uint32_t firstLevel, bool full) {
+        const auto &localPool = m_registry.getPool<LocalTransform>();
+        auto &worldPool = m_registry.getPool<WorldTransform>();
+        if (m_localIndices.size() != m_topoOrder.size() ||
+            localPool.version() != m_resolvedLocalVersion ||
+            worldPool.version() != m_resolvedWorldVersion) {
+            resolveComponentSlots();
+        }
+
+        constexpr size_t npos = ecs::SparseSet<LocalTransform>::npos;
+        const LocalTransform *locals = localPool.data();
+        WorldTransform *worlds = worldPool.data();
+        uint8_t *dirty = m_dirtySlots.data();
+        const glm::mat4 identity(1.0f);
+
+        // Parents live in earlier levels, so every slot of a level can be computed independently.
+        std::atomic<uint32_t> touched{0};
+        auto kernel = [&](uint32_t first, uint32_t last) {
+            uint32_t localTouched = 0;
+            for (uint32_t slot = first; slot < last; ++slot) {
+                const uint32_t parent = m_parentSlots[slot];
+                if (parent != kNoSlot && dirty[parent]) {
+                    dirty[slot] = 1;
+                }
+                if (!full && !dirty[slot]) {
+                    continue;
+                }
+
+                const size_t localIndex = m_localIndices[slot];
+                const glm::mat4 &local = localIndex != npos ? locals[localIndex].matrix : identity;
+                glm::mat4 &world = m_worldMatrices[slot];
+                if (parent != kNoSlot) {
+                    geometry::mulMat4(m_worldMatrices[parent], local, world);
+                } else {
+                    world = local;
+                }
+
+                const size_t worldIndex = m_worldIndices[slot];
+                if (worldIndex != npos) {
+                    worlds[worldIndex].matrix = world;
+                }
+                ++localTouched;
+            }
+            touched.fetch_add(localTouched, std::memory_order_relaxed);
+        };
+
+        for (size_t level = firstLevel; level + 1 < m_levelOffsets.size(); ++level) {
+            const uint32_t begin = m_levelOffsets[level];
+            const uint32_t count = m_levelOffsets[level + 1] - begin;
+            if (count < kMinParallelLevelSize) {
+                kernel(begin, begin + count);
+                continue;
+            }
+            core::TaskSystem::parallelFor(
+                count,
+                [&](enki::TaskSetPartition range, uint32_t) {
+                    kernel(begin + range.start, begin + range.end);
+                },
+                kMinParallelLevelSize / 4);
+        }
+        return touched.load(std::memory_order_relaxed);
+    }
+
+    void SceneGraphDOD::markDependentsDirty(uint32_t firstLevel) {
+        if (firstLevel + 1 >= m_levelOffsets.size()) {
+            return;
+        }
+        for (size_t slot = m_levelOffsets[firstLevel]; slot < m_topoOrder.size(); ++slot) {
+            if (!m_dirtySlots[slot]) {
+                continue;
+            }
+            const ecs::Entity e = m_topoOrder[slot];
+            if (!m_registry.has<BoundsDirtyTag>(e)) {
+                m_registry.emplace<BoundsDirtyTag>(e);
+            }
+            if (!m_registry.has<InstanceDirtyTag>(e)) {
+                m_registry.emplace<InstanceDirtyTag>(e);
             }
         }
+    }
+
+    void SceneGraphDOD::recalculateGlobalTransformsFull() {
+        PNKR_PROFILE_FUNCTION();
+        m_transformStats = {};
+        if (m_hierarchyDirty || levelsStale()) {
+            updateTopoOrder();
+            m_transformStats.topoRebuilt = true;
+        }
+
+        const uint32_t firstDirtyLevel = seedDirtySlots();
+        m_transformStats.nodesTouched = propagateLevels(0, true);
+        m_transformStats.levelsVisited = util::u32(m_levelOffsets.size() - 1);
+        markDependentsDirty(firstDirtyLevel);
         m_registry.getPool<TransformDirtyTag>().clear();
     }
 
@@ -134,37 +304,21 @@ namespace pnkr::renderer::scene {
             return;
         }
 
-        if (m_registry.getPool<TransformDirtyTag>().size() == 0) {
+        m_transformStats = {};
+        if (m_registry.count<TransformDirtyTag>() == 0) {
           return;
         }
 
-        for (ecs::Entity e : m_topoOrder) {
-          auto &rel = m_registry.get<Relationship>(e);
-          bool isDirty = m_registry.has<TransformDirtyTag>(e);
-
-          if (!isDirty && rel.parent() != ecs::kNullEntity) {
-            if (m_registry.has<TransformDirtyTag>(rel.parent())) {
-              m_registry.emplace<TransformDirtyTag>(e);
-              if (!m_registry.has<BoundsDirtyTag>(e)) {
-                m_registry.emplace<BoundsDirtyTag>(e);
-              }
-              isDirty = true;
-            }
-            }
-
-            if (isDirty) {
-                if (!m_registry.has<BoundsDirtyTag>(e)) {
-                    m_registry.emplace<BoundsDirtyTag>(e);
-                }
-                const glm::mat4& local = m_registry.get<LocalTransform>(e).matrix;
-                if (rel.parent() != ecs::kNullEntity) {
-                    m_registry.get<WorldTransform>(e).matrix = m_registry.get<WorldTransform>(rel.parent()).matrix * local;
-                } else {
-                    m_registry.get<WorldTransform>(e).matrix = local;
-                }
-            }
+        PNKR_PROFILE_FUNCTION();
+        if (levelsStale()) {
+            updateTopoOrder();
+            m_transformStats.topoRebuilt = true;
         }
 
+        const uint32_t firstDirtyLevel = seedDirtySlots();
+        m_transformStats.nodesTouched = propagateLevels(firstDirtyLevel, false);
+        m_transformStats.levelsVisited = util::u32(m_levelOffsets.size() - 1 - firstDirtyLevel);
+        markDependentsDirty(firstDirtyLevel);
         m_registry.getPool<TransformDirtyTag>().clear();
     }
 
@@ -175,6 +329,9 @@ namespace pnkr::renderer::scene {
         if (!m_registry.has<BoundsDirtyTag>(entity)) {
             m_registry.emplace<BoundsDirtyTag>(entity);
         }
+        if (!m_registry.has<InstanceDirtyTag>(entity)) {
+            m_registry.emplace<InstanceDirtyTag>(entity);
+        }
     }
 
     void SceneGraphDOD::onHierarchyChanged() {
@@ -186,7 +343,7 @@ namespace pnkr::renderer::scene {
       if (entity == parent) {
         return;
       }
-        if (parent != ecs::kNullEntity && m_registry.getPool<Relationship>().has(parent)) {
+        if (parent != ecs::kNullEntity && m_registry.has<Relationship>(parent)) {
             ecs::Entity current = parent;
             while (current != ecs::kNullEntity) {
               if (current == entity) {
@@ -196,7 +353,7 @@ namespace pnkr::renderer::scene {
               current = rel.parent();
             }
         }
-        Relationship& rel = m_registry.getPool<Relationship>().has(entity) ?
+        Relationship& rel = m_registry.has<Relationship>(entity) ?
             m_registry.get<Relationship>(entity) :
             m_registry.emplace<Relationship>(entity);
 
@@ -226,7 +383,7 @@ namespace pnkr::renderer::scene {
 
         rel.setParent(parent);
         if (parent != ecs::kNullEntity) {
-            Relationship& parentRel = m_registry.getPool<Relationship>().has(parent) ?
+            Relationship& parentRel = m_registry.has<Relationship>(parent) ?
                 m_registry.get<Relationship>(parent) :
                 m_registry.emplace<Relationship>(parent);
 
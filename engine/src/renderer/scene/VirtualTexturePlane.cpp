@@ -0,0 +1,85 @@
+#include "pnkr/renderer/scene/VirtualTexturePlane.hpp"
+#include "pnkr/core/logger.hpp"
+#include "pnkr/renderer/passes/RenderPassUtils.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "pnkr/rhi/rhi_pipeline_builder.hpp"
+#include "pnkr/renderer/gpu_shared/VirtualTextureShared.h"
+
+namespace pnkr::renderer::scene
+{
+    static_assert(sizeof(gpu::VirtualTexturePlanePushConstants) <= 128,
+                  "VirtualTexturePlanePushConstants must fit the guaranteed push constant range");
+
+    void VirtualTexturePlane::init(RHIRenderer& renderer)
+    {
+        m_renderer = &renderer;
+
+        createPipeline();
+    }
+
+    void VirtualTexturePlane::destroy()
+    {
+        m_pipeline = {};
+    }
+
+    void VirtualTexturePlane::createPipeline()
+    {
+        using namespace passes::utils;
+        auto shaders = loadGraphicsShaders("shaders/virtual_texture.vert.spv",
+                                           "shaders/virtual_texture.frag.spv",
+                                           "VirtualTexturePlane");
+        if (!shaders.success)
+        {
+            return;
+        }
+
+        rhi::RHIPipelineBuilder builder;
+
+        builder.setShaders(shaders.vertex.get(), shaders.fragment.get(), nullptr)
+               .setTopology(rhi::PrimitiveTopology::TriangleList)
+               .setPolygonMode(rhi::PolygonMode::Fill)
+               .enableDepthTest(true, rhi::CompareOp::LessOrEqual)
+               .setCullMode(rhi::CullMode::None)
+               .setColorFormat(m_renderer->getDrawColorFormat())
+               .setDepthFormat(m_renderer->getDrawDepthFormat());
+
+        auto desc = builder.buildGraphics();
+
+        desc.depthFormat = m_renderer->getDrawDepthFormat();
+
+        m_pipeline = m_renderer->createGraphicsPipeline(desc);
+    }
+
+    void VirtualTexturePlane::draw(rhi::RHICommandList* cmd, const Camera& camera,
+                                   const VirtualTextureSystem& virtualTextures,
+                                   VirtualTextureId id, float size) const
+    {
+        if (!m_pipeline || (m_renderer == nullptr))
+        {
+            return;
+        }
+
+        rhi::RHIPipeline* rhiPipe = m_renderer->getPipeline(m_pipeline);
+        if (rhiPipe == nullptr)
+        {
+            return;
+        }
+
+        cmd->bindPipeline(rhiPipe);
+
+        gpu::VirtualTexturePlanePushConstants pc{};
+        pc.mvp = camera.proj() * camera.view() *
+                 glm::scale(glm::mat4(1.0F), glm::vec3(size, 1.0F, size));
+        pc.vt = virtualTextures.gpuData(id);
+        cmd->pushConstants(rhi::ShaderStage::Vertex | rhi::ShaderStage::Fragment, pc);
+
+        if (m_renderer->isBindlessEnabled())
+        {
+            rhi::RHIDescriptorSet* bindlessSet = m_renderer->device()->getBindlessDescriptorSet();
+            cmd->bindDescriptorSet(1, bindlessSet);
+        }
+
+        cmd->draw(6, 1, 0, 0);
+    }
+}
@@ -0,0 +1,153 @@
+#include "pnkr/renderer/skinning/AnimationInstancer.hpp"
+#include "pnkr/core/profiler.hpp"
+#include "pnkr/renderer/scene/AnimationSystem.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+
+namespace pnkr::renderer
+{
+    uint32_t AnimationInstancer::addInstance(scene::ModelDOD& prototype, const scene::AnimationState& state,
+                                             ecs::Entity entity)
+    {
+        Instance instance;
+        instance.prototype = &prototype;
+        instance.state = state;
+        instance.entity = entity;
+        instance.state.isBlending = false;
+        m_instances.push_back(std::move(instance));
+        return static_cast<uint32_t>(m_instances.size() - 1);
+    }
+
+    void AnimationInstancer::clear()
+    {
+        m_instances.clear();
+        m_keys.clear();
+        m_poses.clear();
+        m_palettes.clear();
+        m_cursor.reset();
+        m_allocation = {};
+        m_stats = {};
+    }
+
+    uint64_t AnimationInstancer::timeTick(float time) const
+    {
+        if (m_timeQuantum > 0.0f) {
+            return static_cast<uint64_t>(std::llround(std::max(time, 0.0f) / m_timeQuantum));
+        }
+        // Non-negative floats order the same as their bit patterns.
+        return std::bit_cast<uint32_t>(std::max(time, 0.0f));
+    }
+
+    void AnimationInstancer::update(float dt)
+    {
+        PNKR_PROFILE_FUNCTION();
+        m_keys.clear();
+        m_poses.clear();
+        m_palettes.clear();
+        m_allocation = {};
+        m_stats = {};
+        m_stats.instances = instanceCount();
+
+        for (uint32_t i = 0; i < m_instances.size(); ++i) {
+            Instance& instance = m_instances[i];
+            instance.pose = kNoPose;
+
+            const auto& animations = instance.prototype->animations();
+            auto& state = instance.state;
+            if (state.animIndex >= animations.size() || instance.prototype->skins().empty()) {
+                continue;
+            }
+            if (state.isPlaying) {
+                scene::AnimationSystem::advanceTime(state, animations[state.animIndex].duration, dt);
+            }
+            m_keys.push_back({.prototype = instance.prototype,
+                              .animIndex = state.animIndex,
+                              .tick = timeTick(state.currentTime),
+                              .instance = i});
+        }
+
+        // Sorting groups equal poses together and walks each clip forwards in
+        // time, so the shared cursor only ever steps ahead.
+        std::ranges::sort(m_keys, [](const PoseKey& a, const PoseKey& b) {
+            if (a.prototype != b.prototype) {
+                return std::less<>{}(a.prototype, b.prototype);
+            }
+            if (a.animIndex != b.animIndex) {
+                return a.animIndex < b.animIndex;
+            }
+            return a.tick < b.tick;
+        });
+
+        const PoseKey* previous = nullptr;
+        for (const PoseKey& key : m_keys) {
+            Instance& instance = m_instances[key.instance];
+            const bool samePose = previous != nullptr && previous->prototype == key.prototype &&
+                                  previous->animIndex == key.animIndex && previous->tick == key.tick;
+            if (!samePose) {
+                scene::ModelDOD& prototype = *key.prototype;
+                const float duration = prototype.animations()[key.animIndex].duration;
+                const float time = m_timeQuantum > 0.0f
+                                       ? std::min(static_cast<float>(key.tick) * m_timeQuantum, duration)
+                                       : instance.state.currentTime;
+
+                scene::AnimationSystem::applyAnimation(prototype, key.animIndex, m_cursor, time);
+                prototype.scene().updateTransforms();
+                const auto joints = scene::AnimationSystem::updateSkinning(prototype);
+
+                m_poses.push_back({.paletteOffset = static_cast<uint32_t>(m_palettes.size()),
+                                   .jointCount = static_cast<uint32_t>(joints.size())});
+                m_palettes.insert(m_palettes.end(), joints.begin(), joints.end());
+            }
+
+            instance.pose = static_cast<uint32_t>(m_poses.size() - 1);
+            m_stats.jointsReferenced += m_poses.back().jointCount;
+            previous = &key;
+        }
+
+        m_stats.uniquePoses = static_cast<uint32_t>(m_poses.size());
+        m_stats.jointsEvaluated = static_cast<uint32_t>(m_palettes.size());
+    }
+
+    void AnimationInstancer::uploadPalettes(RHIRenderer& renderer, rhi::RHICommandList& cmd,
+                                            FrameManager& frameManager, GlobalJointBuffer& jointBuffer)
+    {
+        m_allocation = {};
+        if (m_palettes.empty()) {
+            return;
+        }
+
+        m_allocation = jointBuffer.allocate(static_cast<uint32_t>(m_palettes.size()));
+        if (m_allocation.count == 0) {
+            return;
+        }
+
+        jointBuffer.uploadJoints(UploadJointsRequest{
+            .renderer = renderer,
+            .cmd = cmd,
+            .frameManager = frameManager,
+            .alloc = m_allocation,
+            .matrices = m_palettes});
+    }
+
+    std::span<const glm::mat4> AnimationInstancer::palette(uint32_t pose) const
+    {
+        if (pose >= m_poses.size()) {
+            return {};
+        }
+        return std::span(m_palettes).subspan(m_poses[pose].paletteOffset, m_poses[pose].jointCount);
+    }
+
+    JointAllocation AnimationInstancer::jointAllocation(uint32_t instance) const
+    {
+        const uint32_t pose = m_instances[instance].pose;
+        if (pose == kNoPose || m_allocation.count == 0) {
+            return {.offset = 0, .count = 0, .globalIndex = 0};
+        }
+        const Pose& p = m_poses[pose];
+        return {.offset = m_allocation.offset + p.paletteOffset,
+                .count = p.jointCount,
+                .globalIndex = m_allocation.globalIndex + p.paletteOffset};
+    }
+}
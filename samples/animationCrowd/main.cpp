@@ -0,0 +1,326 @@
+#include "pnkr/app/Application.hpp"
+#include "pnkr/assets/AssetImporter.hpp"
+#include "pnkr/core/TaskSystem.hpp"
+#include "pnkr/core/logger.hpp"
+#include "pnkr/renderer/IndirectRenderer.hpp"
+#include "pnkr/renderer/io/ModelUploader.hpp"
+#include "pnkr/renderer/scene/AnimationSystem.hpp"
+#include "pnkr/renderer/scene/Camera.hpp"
+#include "pnkr/renderer/scene/CameraController.hpp"
+#include "pnkr/renderer/scene/Components.hpp"
+#include "pnkr/renderer/scene/ModelDOD.hpp"
+#include "pnkr/renderer/skinning/AnimationInstancer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <memory>
+#include <random>
+#include <string_view>
+
+using namespace pnkr;
+using namespace pnkr::renderer;
+using namespace pnkr::renderer::scene;
+
+// Crowd of identical skinned characters playing the same clip with random
+// phases. Compares one AnimationSystem::update per ModelDOD against
+// AnimationInstancer at several time-quantization tolerances.
+// Usage: pnkr_animation_crowd [characters] [frames]
+//
+// With --render, draws a grid of copies of a skinned glTF through
+// IndirectRenderer, which skins one vertex copy per shared palette.
+// Usage: pnkr_animation_crowd --render <model.gltf> [characters] [quantum]
+
+namespace {
+
+constexpr uint32_t kJointCount = 64;
+constexpr uint32_t kKeyCount = 30;
+constexpr float kClipDuration = 1.0f;
+constexpr float kFrameDt = 1.0f / 60.0f;
+
+// Spine of 16 joints with three 16-joint limbs hanging off it, each joint
+// rotating about a different axis. Roughly the shape of a game skeleton.
+std::unique_ptr<ModelDOD> buildCharacter() {
+  auto model = std::make_unique<ModelDOD>();
+  auto &scene = model->scene();
+
+  Skin skin;
+  skin.name = "crowd";
+  std::vector<ecs::Entity> joints;
+  ecs::Entity root = scene.createNode();
+  for (uint32_t i = 0; i < kJointCount; ++i) {
+    const ecs::Entity parent = i == 0            ? root
+                               : i % 16 == 0     ? joints[(i / 16) * 4]
+                                                 : joints.back();
+    const ecs::Entity joint = scene.createNode(parent);
+    scene.registry().get<LocalTransform>(joint).matrix =
+        glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.1f, 0.0f));
+    joints.push_back(joint);
+    skin.joints.push_back(joint);
+    skin.inverseBindMatrices.emplace_back(1.0f);
+  }
+  model->skinsMutable().push_back(std::move(skin));
+
+  Animation anim;
+  anim.name = "sway";
+  anim.duration = kClipDuration;
+  for (uint32_t j = 0; j < kJointCount; ++j) {
+    AnimationSampler sampler;
+    sampler.interpolation = InterpolationType::Linear;
+    const glm::vec3 axis = glm::normalize(glm::vec3(float(j % 3), 1.0f, float(j % 5)));
+    for (uint32_t k = 0; k < kKeyCount; ++k) {
+      const float t = kClipDuration * float(k) / float(kKeyCount - 1);
+      const glm::quat q = glm::angleAxis(0.3f * std::sin(6.2831853f * t + float(j)), axis);
+      sampler.inputs.push_back(t);
+      sampler.outputs.emplace_back(q.x, q.y, q.z, q.w);
+    }
+    anim.channels.push_back({.samplerIndex = static_cast<int>(anim.samplers.size()),
+                             .targetNode = joints[j],
+                             .path = AnimationPath::Rotation});
+    anim.samplers.push_back(std::move(sampler));
+  }
+  model->animationsMutable().push_back(std::move(anim));
+
+  scene.recalculateGlobalTransformsFull();
+  return model;
+}
+
+AnimationState randomState(std::mt19937 &rng) {
+  AnimationState state;
+  state.animIndex = 0;
+  state.isPlaying = true;
+  state.isLooping = true;
+  state.currentTime = std::uniform_real_distribution<float>(0.0f, kClipDuration)(rng);
+  return state;
+}
+
+template <typename Func> double timeFrames(uint32_t frames, Func &&func) {
+  func();
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t f = 0; f < frames; ++f) {
+    func();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+double runPerModel(uint32_t characters, uint32_t frames) {
+  std::mt19937 rng(7);
+  std::vector<std::unique_ptr<ModelDOD>> models;
+  for (uint32_t i = 0; i < characters; ++i) {
+    models.push_back(buildCharacter());
+    models.back()->animationState() = randomState(rng);
+  }
+
+  const double ms = timeFrames(frames, [&] {
+    for (auto &model : models) {
+      AnimationSystem::update(*model, kFrameDt);
+      model->scene().updateTransforms();
+      AnimationSystem::updateSkinning(*model);
+    }
+  });
+  core::Logger::info("{:>24} | {:8.3f} ms/frame | {:6} poses", "per-model update", ms, characters);
+  return ms;
+}
+
+void runInstanced(uint32_t characters, uint32_t frames, float quantum, const char *label,
+                  double baselineMs) {
+  std::mt19937 rng(7);
+  auto prototype = buildCharacter();
+  AnimationInstancer instancer;
+  instancer.setTimeQuantum(quantum);
+  for (uint32_t i = 0; i < characters; ++i) {
+    instancer.addInstance(*prototype, randomState(rng));
+  }
+
+  const double ms = timeFrames(frames, [&] { instancer.update(kFrameDt); });
+  const auto &stats = instancer.stats();
+  core::Logger::info("{:>24} | {:8.3f} ms/frame | {:6} poses | {:5.2f}x | joints uploaded {} of {}",
+                     label, ms, stats.uniquePoses, baselineMs / ms, stats.jointsEvaluated,
+                     stats.jointsReferenced);
+}
+
+class CrowdViewer : public app::Application {
+public:
+  CrowdViewer(std::filesystem::path path, uint32_t characters, float quantum)
+      : Application({.title = "Animation Crowd", .width = 1600, .height = 900, .rendererConfig = {}}),
+        m_path(std::move(path)), m_characters(characters) {
+    m_instancer.setTimeQuantum(quantum);
+  }
+
+protected:
+  void onInit() override {
+    auto imported = assets::AssetImporter::loadGLTF(m_path);
+    if (!imported) {
+      core::Logger::error("Failed to load {}", m_path.string());
+      return;
+    }
+    m_model = renderer::io::ModelUploader::upload(*m_renderer, std::move(*imported));
+    if (m_model->skins().empty() || m_model->animations().empty()) {
+      core::Logger::error("{} has no skinned animation to instance", m_path.string());
+      m_model.reset();
+      return;
+    }
+
+    if (m_model->scene().registry().count<LightSource>() == 0) {
+      Light sun{};
+      sun.m_type = LightType::Directional;
+      sun.m_intensity = 3.0f;
+      sun.m_direction = glm::normalize(glm::vec3(-1.0f, -3.0f, -1.0f));
+      m_model->addLight(sun, glm::mat4(1.0f), "Sun");
+    }
+
+    spawnCrowd();
+
+    m_indirectRenderer = std::make_unique<renderer::IndirectRenderer>();
+    m_indirectRenderer->init(m_renderer.get(), m_model);
+    m_indirectRenderer->setAnimationInstancer(&m_instancer);
+
+    m_renderer->setRecordFunc([this](const renderer::RHIFrameContext &ctx) { onRecord(ctx); });
+  }
+
+  void onShutdown() override {
+    if (m_renderer && m_renderer->device()) {
+      m_renderer->device()->waitIdle();
+    }
+    m_indirectRenderer.reset();
+    m_instancer.clear();
+    m_model.reset();
+    Application::onShutdown();
+  }
+
+  void onUpdate(float dt) override {
+    if (!m_indirectRenderer) {
+      return;
+    }
+    m_camera.setPerspective(glm::radians(60.0f),
+                            static_cast<float>(m_config.width) / static_cast<float>(m_config.height),
+                            0.1f, 1000.0f);
+    m_cameraController.update(m_input, dt);
+    m_cameraController.applyToCamera(m_camera);
+
+    // The model is its own prototype: the instancer poses it once per
+    // distinct (clip, time) and the renderer skins each pose once.
+    m_instancer.update(dt);
+    m_indirectRenderer->update(dt);
+  }
+
+  void onImGui() override {
+    if (!m_indirectRenderer) {
+      return;
+    }
+    const auto &stats = m_instancer.stats();
+    ImGui::Begin("Crowd");
+    ImGui::Text("Characters: %u", m_characters);
+    ImGui::Text("Unique poses: %u", stats.uniquePoses);
+    ImGui::Text("Joints uploaded: %u of %u", stats.jointsEvaluated, stats.jointsReferenced);
+    float quantum = m_instancer.timeQuantum() * 1000.0f;
+    if (ImGui::SliderFloat("Time quantum (ms)", &quantum, 0.0f, 100.0f)) {
+      m_instancer.setTimeQuantum(quantum / 1000.0f);
+    }
+    ImGui::End();
+  }
+
+  void onRecord(const renderer::RHIFrameContext &ctx) override {
+    if (!m_indirectRenderer) {
+      return;
+    }
+    m_indirectRenderer->draw(ctx.commandBuffer, m_camera, ctx.backBuffer->extent().width,
+                             ctx.backBuffer->extent().height, nullptr,
+                             [&](renderer::rhi::RHICommandList *cmd) { m_imgui.render(cmd); });
+  }
+
+private:
+  // Every character copies the model's skinned mesh nodes onto a grid cell.
+  // Each copy is its own instancer instance; copies of one character share
+  // its AnimationState and therefore its pose.
+  void spawnCrowd() {
+    auto &scene = m_model->scene();
+    auto &registry = scene.registry();
+    scene.updateTransforms();
+
+    struct SkinnedNode {
+      int32_t meshID;
+      LocalBounds bounds;
+      glm::mat4 world;
+    };
+    std::vector<SkinnedNode> nodes;
+    registry.view<SkinComponent, MeshRenderer, LocalBounds, WorldTransform>().each(
+        [&](ecs::Entity, SkinComponent &, MeshRenderer &mr, LocalBounds &lb, WorldTransform &wt) {
+          nodes.push_back({.meshID = mr.meshID, .bounds = lb, .world = wt.matrix});
+        });
+
+    float spacing = 1.0f;
+    if (!nodes.empty()) {
+      const auto &aabb = nodes.front().bounds.aabb;
+      spacing = std::max(glm::length(aabb.m_max - aabb.m_min), 1.0f);
+    }
+    const auto columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(m_characters))));
+    std::mt19937 rng(7);
+    for (uint32_t c = 0; c < m_characters; ++c) {
+      AnimationState state;
+      state.animIndex = c % static_cast<uint32_t>(m_model->animations().size());
+      state.isPlaying = true;
+      state.isLooping = true;
+      state.currentTime = std::uniform_real_distribution<float>(
+          0.0f, m_model->animations()[state.animIndex].duration)(rng);
+
+      const glm::vec3 offset(static_cast<float>(c % columns) * spacing, 0.0f,
+                             static_cast<float>(c / columns) * spacing);
+      for (const SkinnedNode &node : nodes) {
+        const ecs::Entity e = scene.createNode();
+        registry.get<LocalTransform>(e).matrix = glm::translate(glm::mat4(1.0f), offset) * node.world;
+        registry.emplace<MeshRenderer>(e, node.meshID);
+        registry.emplace<LocalBounds>(e, node.bounds);
+        registry.emplace<WorldBounds>(e);
+        registry.emplace<Visibility>(e);
+        registry.emplace<BoundsDirtyTag>(e);
+        registry.emplace<SkinnedMeshRenderer>(e);
+        m_instancer.addInstance(*m_model, state, e);
+      }
+    }
+    scene.updateTransforms();
+    core::Logger::info("Spawned {} characters x {} skinned meshes", m_characters, nodes.size());
+  }
+
+  std::filesystem::path m_path;
+  uint32_t m_characters = 0;
+  std::shared_ptr<ModelDOD> m_model;
+  std::unique_ptr<renderer::IndirectRenderer> m_indirectRenderer;
+  AnimationInstancer m_instancer;
+  Camera m_camera;
+  CameraController m_cameraController{{0.0f, 3.0f, 12.0f}, -90.0f, -10.0f};
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc > 2 && std::string_view(argv[1]) == "--render") {
+    const uint32_t characters = argc > 3 ? static_cast<uint32_t>(std::max(std::atoi(argv[3]), 1)) : 100U;
+    const float quantum = argc > 4 ? static_cast<float>(std::atof(argv[4])) : 1.0f / 60.0f;
+    CrowdViewer app(argv[2], characters, quantum);
+    return app.run();
+  }
+
+  core::Logger::init();
+  core::TaskSystem::init();
+
+  const uint32_t characters = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 500U;
+  const uint32_t frames = argc > 2 ? static_cast<uint32_t>(std::max(std::atoi(argv[2]), 1)) : 60U;
+  core::Logger::info("{} characters x {} joints, {} keys per channel, {} frames",
+                     characters, kJointCount, kKeyCount, frames);
+
+  const double baselineMs = runPerModel(characters, frames);
+  runInstanced(characters, frames, 0.0f, "instanced, exact time", baselineMs);
+  runInstanced(characters, frames, 1.0f / 120.0f, "instanced, 1/120 s", baselineMs);
+  runInstanced(characters, frames, 1.0f / 60.0f, "instanced, 1/60 s", baselineMs);
+  runInstanced(characters, frames, 1.0f / 30.0f, "instanced, 1/30 s", baselineMs);
+
+  core::TaskSystem::shutdown();
+  core::Logger::shutdown();
+  return 0;
+}
@@ -0,0 +1,116 @@
+#include "pnkr/assets/BC7Encoder.hpp"
+#include "pnkr/core/TaskSystem.hpp"
+#include "pnkr/core/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace pnkr;
+using namespace pnkr::assets;
+
+// Encodes a synthetic texture and its full mip chain at every BC7Quality
+// preset and reports throughput. Arguments: [size] [--serial]. --serial skips
+// TaskSystem::init so parallelFor runs inline, giving the single-thread baseline.
+
+namespace {
+
+std::vector<uint8_t> makeImage(uint32_t size) {
+  // Smooth gradients, hard edges and some noise so every BC7 mode gets work.
+  std::vector<uint8_t> rgba(static_cast<size_t>(size) * size * 4);
+  uint32_t seed = 0x9E3779B9U;
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      seed = seed * 1664525U + 1013904223U;
+      const uint8_t noise = static_cast<uint8_t>(seed >> 27);
+      const bool checker = ((x / 32) + (y / 32)) % 2 == 0;
+      uint8_t *p = rgba.data() + (static_cast<size_t>(y) * size + x) * 4;
+      p[0] = static_cast<uint8_t>((x * 255) / size);
+      p[1] = static_cast<uint8_t>(checker ? 200 : 40) + noise;
+      p[2] = static_cast<uint8_t>(127.5f + 127.5f * std::sin(float(x + y) * 0.05f));
+      p[3] = static_cast<uint8_t>((y * 255) / size);
+    }
+  }
+  return rgba;
+}
+
+std::vector<std::vector<uint8_t>> makeMipChain(std::vector<uint8_t> base, uint32_t size) {
+  std::vector<std::vector<uint8_t>> levels;
+  levels.push_back(std::move(base));
+  while (size > 1) {
+    const uint32_t next = size / 2;
+    const auto &src = levels.back();
+    std::vector<uint8_t> dst(static_cast<size_t>(next) * next * 4);
+    for (uint32_t y = 0; y < next; ++y) {
+      for (uint32_t x = 0; x < next; ++x) {
+        for (uint32_t c = 0; c < 4; ++c) {
+          const auto at = [&](uint32_t sx, uint32_t sy) {
+            return static_cast<uint32_t>(src[(static_cast<size_t>(sy) * size + sx) * 4 + c]);
+          };
+          dst[(static_cast<size_t>(y) * next + x) * 4 + c] = static_cast<uint8_t>(
+              (at(x * 2, y * 2) + at(x * 2 + 1, y * 2) + at(x * 2, y * 2 + 1) +
+               at(x * 2 + 1, y * 2 + 1) + 2) / 4);
+        }
+      }
+    }
+    levels.push_back(std::move(dst));
+    size = next;
+  }
+  return levels;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  core::Logger::init();
+
+  uint32_t size = 2048;
+  bool serial = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--serial") == 0) {
+      serial = true;
+    } else {
+      size = std::max(4U, static_cast<uint32_t>(std::atoi(argv[i])));
+    }
+  }
+  if (!serial) {
+    core::TaskSystem::init();
+  }
+
+  const auto levels = makeMipChain(makeImage(size), size);
+  std::vector<BC7SourceImage> images;
+  uint64_t pixels = 0;
+  for (size_t i = 0; i < levels.size(); ++i) {
+    const uint32_t dim = std::max(1U, size >> i);
+    images.push_back({levels[i].data(), dim, dim});
+    pixels += static_cast<uint64_t>(dim) * dim;
+  }
+
+  core::Logger::info("BC7 {}x{} + {} mips ({:.2f} MPix), {}", size, size,
+                     levels.size() - 1, double(pixels) / 1e6,
+                     serial ? "serial" : "TaskSystem");
+
+  for (uint32_t q = 0; q < static_cast<uint32_t>(BC7Quality::Count); ++q) {
+    const auto quality = static_cast<BC7Quality>(q);
+    BC7EncoderConfig config;
+    config.quality = quality;
+
+    std::vector<std::vector<uint8_t>> out;
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = BC7Encoder::compressLevels(images, config, out);
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+
+    core::Logger::info("{:>8} | {:8.1f} ms | {:8.2f} MPix/s{}",
+                       bc7QualityPreset(quality).name, seconds * 1e3,
+                       double(pixels) / 1e6 / seconds, ok ? "" : " (FAILED)");
+  }
+
+  if (!serial) {
+    core::TaskSystem::shutdown();
+  }
+  core::Logger::shutdown();
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include "pnkr/core/TaskSystem.hpp"
+#include "pnkr/core/logger.hpp"
+#include "pnkr/renderer/geometry/FrustumCull.hpp"
+#include "pnkr/renderer/geometry/SimdMath.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace pnkr;
+using namespace pnkr::renderer;
+
+// Frustum culling throughput at 10k/100k/1M boxes: the per-box isBoxInFrustum
+// test over an AoS array against the SoA plane kernel, scalar, SIMD and split
+// across the TaskSystem. Arguments: [iterations] [--serial].
+
+namespace {
+
+std::vector<scene::BoundingBox> makeBoxes(uint32_t count) {
+  // Scattered through a 2km cube so about a quarter lands in the frustum.
+  std::vector<scene::BoundingBox> boxes(count);
+  uint32_t seed = 0x9E3779B9U;
+  const auto next = [&seed] {
+    seed = seed * 1664525U + 1013904223U;
+    return static_cast<float>(seed >> 8) / static_cast<float>(1U << 24);
+  };
+  for (auto &box : boxes) {
+    const glm::vec3 c(next() * 2000.0f - 1000.0f, next() * 2000.0f - 1000.0f,
+                      next() * 2000.0f - 1000.0f);
+    const glm::vec3 e(0.5f + next() * 4.0f);
+    box.m_min = c - e;
+    box.m_max = c + e;
+  }
+  return boxes;
+}
+
+template <typename Func>
+double timeMs(uint32_t iterations, Func &&func) {
+  func();
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t it = 0; it < iterations; ++it) {
+    func();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+void runCase(uint32_t count, uint32_t iterations, const geometry::Frustum &frustum) {
+  const auto boxes = makeBoxes(count);
+  geometry::AabbSoA soa;
+  soa.resize(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    soa.set(i, boxes[i]);
+  }
+
+  std::vector<uint32_t> visible;
+  visible.reserve(count);
+  std::vector<uint8_t> flags(count);
+  geometry::FrustumCuller culler;
+
+  size_t aosVisible = 0;
+  const double aosMs = timeMs(iterations, [&] {
+    aosVisible = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+      flags[i] = geometry::isBoxInFrustum(frustum, boxes[i]) ? 1 : 0;
+      aosVisible += flags[i];
+    }
+  });
+  const double scalarMs = timeMs(iterations, [&] {
+    visible.clear();
+    geometry::cullBoxesScalar(frustum, soa, 0, count, visible);
+  });
+  const size_t scalarVisible = visible.size();
+  const double simdMs = timeMs(iterations, [&] {
+    visible.clear();
+    geometry::cullBoxes(frustum, soa, 0, count, visible);
+  });
+  const size_t simdVisible = visible.size();
+  const double taskMs = timeMs(iterations, [&] { culler.cull(frustum, soa); });
+
+  const auto rate = [count](double ms) { return double(count) / 1e3 / ms; };
+  core::Logger::info("{:>8} boxes | AoS {:7.3f} ms | SoA scalar {:7.3f} ms | SIMD {:7.3f} ms ({:6.0f} Mbox/s) | "
+                     "tasks {:7.3f} ms ({:6.0f} Mbox/s) | visible {}/{}{}",
+                     count, aosMs, scalarMs, simdMs, rate(simdMs), taskMs, rate(taskMs),
+                     simdVisible, aosVisible,
+                     (simdVisible == scalarVisible && culler.visible().size() == simdVisible)
+                         ? ""
+                         : " (MISMATCH)");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  core::Logger::init();
+
+  uint32_t iterations = 20;
+  bool serial = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--serial") == 0) {
+      serial = true;
+    } else {
+      iterations = static_cast<uint32_t>(std::max(1, std::atoi(argv[i])));
+    }
+  }
+  if (!serial) {
+    core::TaskSystem::init();
+  }
+
+#if defined(__AVX2__)
+  const char *isa = "AVX2 x8";
+#elif defined(PNKR_SIMD_SSE)
+  const char *isa = "SSE x4";
+#elif defined(PNKR_SIMD_NEON)
+  const char *isa = "NEON x4";
+#else
+  const char *isa = "scalar";
+#endif
+  core::Logger::info("Frustum culling, {} iterations, kernel {}, {}", iterations, isa,
+                     serial ? "serial" : "TaskSystem");
+
+  const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1500.0f);
+  const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, -1000.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+  const auto frustum = geometry::createFrustum(proj * view);
+
+  for (uint32_t count : {10'000U, 100'000U, 1'000'000U}) {
+    runCase(count, iterations, frustum);
+  }
+
+  if (!serial) {
+    core::TaskSystem::shutdown();
+  }
+  core::Logger::shutdown();
+  return 0;
+}
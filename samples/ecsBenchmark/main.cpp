@@ -0,0 +1,90 @@
+#include "pnkr/core/ECS.hpp"
+#include "pnkr/core/logger.hpp"
+#include "pnkr/renderer/scene/Bounds.hpp"
+#include "pnkr/renderer/scene/Components.hpp"
+
+#include <chrono>
+#include <cstdlib>
+
+using namespace pnkr;
+using namespace pnkr::renderer::scene;
+
+// Compares RenderBatcher's 4-component view over sparse set storage against
+// archetype (chunked SoA) storage. Pass an iteration count as the first argument.
+
+namespace {
+
+void populate(ecs::Registry& reg, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    ecs::Entity e = reg.create();
+    reg.emplace<LocalTransform>(e);
+    reg.emplace<WorldTransform>(e).matrix[3] =
+        glm::vec4(static_cast<float>(i % 1000), 0.0f, static_cast<float>(i / 1000), 1.0f);
+    reg.emplace<Relationship>(e);
+
+    // Interleave renderable and non-renderable nodes so the sparse pools are not
+    // accidentally ordered the same way, as in an imported glTF hierarchy.
+    if (i % 4 != 3) {
+      reg.emplace<MeshRenderer>(e, static_cast<int32_t>(i % 64));
+      reg.emplace<Visibility>(e).visible = (i % 8 != 0) ? 1 : 0;
+      reg.emplace<WorldBounds>(e);
+      reg.emplace<LocalBounds>(e);
+    }
+    if (i % 16 == 0) {
+      reg.emplace<StaticTag>(e);
+    }
+  }
+}
+
+double runView(ecs::Registry& reg, uint32_t iterations, uint64_t& checksum) {
+  auto view = reg.view<MeshRenderer, WorldTransform, Visibility, WorldBounds>();
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t it = 0; it < iterations; ++it) {
+    view.each([&](ecs::Entity, MeshRenderer& mesh, WorldTransform& world,
+                  Visibility& vis, WorldBounds& bounds) {
+      if (!vis.visible) {
+        return;
+      }
+      bounds.aabb.m_min = glm::vec3(world.matrix[3]) - glm::vec3(0.5f);
+      bounds.aabb.m_max = glm::vec3(world.matrix[3]) + glm::vec3(0.5f);
+      checksum += static_cast<uint64_t>(mesh.meshID);
+    });
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+void runCase(uint32_t entityCount, uint32_t iterations) {
+  ecs::Registry sparse(ecs::StorageMode::SparseSet);
+  ecs::Registry archetype(ecs::StorageMode::Archetype);
+  populate(sparse, entityCount);
+  populate(archetype, entityCount);
+
+  uint64_t sparseChecksum = 0;
+  uint64_t archetypeChecksum = 0;
+  runView(sparse, 1, sparseChecksum);
+  runView(archetype, 1, archetypeChecksum);
+
+  const double sparseMs = runView(sparse, iterations, sparseChecksum);
+  const double archetypeMs = runView(archetype, iterations, archetypeChecksum);
+
+  core::Logger::info("{:>8} entities | sparse set {:8.3f} ms | archetype {:8.3f} ms | speedup {:5.2f}x{}",
+                     entityCount, sparseMs, archetypeMs, sparseMs / archetypeMs,
+                     sparseChecksum == archetypeChecksum ? "" : " (CHECKSUM MISMATCH)");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  core::Logger::init();
+
+  const uint32_t iterations = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 20U;
+  core::Logger::info("View<MeshRenderer, WorldTransform, Visibility, WorldBounds>::each, {} iterations", iterations);
+
+  for (uint32_t count : {100'000U, 1'000'000U}) {
+    runCase(count, iterations > 0 ? iterations : 1U);
+  }
+
+  core::Logger::shutdown();
+  return 0;
+}
@@ -0,0 +1,165 @@
+#include "pnkr/core/FileReader.hpp"
+#include "pnkr/core/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace pnkr;
+
+// Streamed texture reads through each FileReader backend: every texture is a
+// file holding a BC7-sized mip chain, read as one batch of per-mip ranges into
+// a registered staging buffer, the way GPUTransferQueue reads KTX2 levels.
+// Arguments: [textures] [resolution] [--cold]. --cold drops the files from the
+// page cache before each pass (Linux only).
+
+namespace {
+
+struct Texture {
+  std::string path;
+  std::vector<std::pair<uint64_t, uint64_t>> mips; // offset, size
+  uint64_t bytes = 0;
+};
+
+std::vector<Texture> writeTextures(const std::filesystem::path &dir,
+                                   uint32_t count, uint32_t resolution) {
+  std::vector<Texture> textures(count);
+  std::vector<char> bytes;
+  for (uint32_t t = 0; t < count; ++t) {
+    Texture &tex = textures[t];
+    tex.path = (dir / ("texture_" + std::to_string(t) + ".bin")).string();
+    // KTX2 stores the smallest level first; 1 byte per texel like BC7.
+    uint64_t offset = 0;
+    for (uint32_t size = 1; size <= resolution; size *= 2) {
+      const uint64_t levelBytes = std::max<uint64_t>(16, uint64_t(size) * size);
+      tex.mips.emplace_back(offset, levelBytes);
+      offset += levelBytes;
+    }
+    tex.bytes = offset;
+
+    bytes.resize(offset);
+    std::fill(bytes.begin(), bytes.end(), static_cast<char>(t));
+    std::ofstream out(tex.path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+  return textures;
+}
+
+void dropFromCache(const std::vector<Texture> &textures) {
+#ifdef __linux__
+  for (const Texture &tex : textures) {
+    const int fd = ::open(tex.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+      ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      ::close(fd);
+    }
+  }
+#else
+  (void)textures;
+#endif
+}
+
+void warmCache(const std::vector<Texture> &textures) {
+  std::vector<char> bytes;
+  for (const Texture &tex : textures) {
+    bytes.resize(tex.bytes);
+    std::ifstream in(tex.path, std::ios::binary);
+    in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+}
+
+void runBackend(core::FileReaderBackend backend,
+                const std::vector<Texture> &textures, bool cold) {
+  auto reader = core::FileReader::create(backend);
+  if (backend != core::FileReaderBackend::Blocking &&
+      reader->backend() != backend) {
+    core::Logger::info("{:>9} | unavailable", "io_uring");
+    return;
+  }
+
+  uint64_t largest = 0;
+  for (const Texture &tex : textures) {
+    largest = std::max(largest, tex.bytes);
+  }
+  std::vector<uint8_t> staging(largest);
+  const bool registered = reader->registerBuffer(staging);
+
+  if (cold) {
+    dropFromCache(textures);
+  }
+
+  std::vector<core::FileReadRequest> requests;
+  uint64_t failed = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (const Texture &tex : textures) {
+    requests.clear();
+    uint64_t stagingOffset = 0;
+    for (const auto &[offset, size] : tex.mips) {
+      requests.push_back({tex.path, offset, size, staging.data() + stagingOffset});
+      stagingOffset += size;
+    }
+    failed += reader->read(requests) ? 0 : 1;
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+  const core::FileReaderStats stats = reader->stats();
+  core::Logger::info("{:>9} | {:8.1f} ms | {:8.1f} MB/s | {:5.1f} syscalls/texture | "
+                     "{:5.1f} reads/texture | registered {}{}",
+                     reader->name(), ms,
+                     double(stats.bytesRead) / (1024.0 * 1024.0) / (ms / 1e3),
+                     double(stats.syscalls) / textures.size(),
+                     double(stats.requests) / textures.size(),
+                     registered ? "yes" : "no",
+                     failed > 0 ? " (FAILED READS)" : "");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  core::Logger::init();
+
+  uint32_t count = 256;
+  uint32_t resolution = 2048;
+  bool cold = false;
+  uint32_t positional = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--cold") == 0) {
+      cold = true;
+    } else if (positional++ == 0) {
+      count = static_cast<uint32_t>(std::max(1, std::atoi(argv[i])));
+    } else {
+      resolution = static_cast<uint32_t>(std::max(1, std::atoi(argv[i])));
+    }
+  }
+
+  const auto dir = std::filesystem::temp_directory_path() / "pnkr_io_benchmark";
+  std::filesystem::create_directories(dir);
+  const auto textures = writeTextures(dir, count, resolution);
+
+  core::Logger::info("Streamed texture reads, {} textures of {}^2 ({} mips), {} cache",
+                     count, resolution, textures.front().mips.size(),
+                     cold ? "cold" : "warm");
+
+  // Warm the cache so the first backend doesn't pay for the files just
+  // written back while the second one hits memory.
+  if (!cold) {
+    warmCache(textures);
+  }
+  runBackend(core::FileReaderBackend::Blocking, textures, cold);
+  runBackend(core::FileReaderBackend::IoUring, textures, cold);
+
+  std::filesystem::remove_all(dir);
+  core::Logger::shutdown();
+  return 0;
+}
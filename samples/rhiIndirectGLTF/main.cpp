@@ -3,8 +3,11 @@
 #include "pnkr/renderer/physics/ClothSystem.hpp"
 #include "pnkr/renderer/RenderSettings.hpp"
 #include "pnkr/renderer/BRDFLutGenerator.hpp"
+#include "pnkr/renderer/TextureStreamingScheduler.hpp"
+#include "pnkr/renderer/UploadPacer.hpp"
 #include "pnkr/renderer/io/GLTFLoader.hpp"
 #include "pnkr/assets/AssetImporter.hpp"
+#include "pnkr/assets/TextureDiskCache.hpp"
 #include "pnkr/renderer/io/ModelUploader.hpp"
 #include "pnkr/core/TaskSystem.hpp"
 #include "pnkr/app/Application.hpp"
@@ -33,6 +36,7 @@ namespace
     AUTO_CVAR_STRING(s_lastModelPath, "Last loaded model path", "");
     AUTO_CVAR_STRING(s_lastSkyboxPath, "Last loaded skybox path", "", core::CVarFlags::save);
     AUTO_CVAR_BOOL(b_skyboxFlipY, "Flip skybox vertically", true, core::CVarFlags::save);
+    AUTO_CVAR_BOOL(b_compactVertices, "Upload static models with the 32-byte vertex layout", true, core::CVarFlags::save);
     AUTO_CVAR_FLOAT(r_camPosX, "Camera X position", -19.2609997f, core::CVarFlags::save);
     AUTO_CVAR_FLOAT(r_camPosY, "Camera Y position", 8.46500015f, core::CVarFlags::save);
     AUTO_CVAR_FLOAT(r_camPosZ, "Camera Z position", -7.31699991f, core::CVarFlags::save);
@@ -335,13 +339,15 @@ public:
             return;
         }
 
-        m_model = io::ModelUploader::upload(*m_renderer, std::move(*loaded));
+        m_model = io::ModelUploader::upload(*m_renderer, std::move(*loaded),
+                                            b_compactVertices.get() ? renderer::geometry::VertexFormat::Compact
+                                                                    : renderer::geometry::VertexFormat::Full);
 
 
         m_model->dropCpuGeometry();
 
         // Add a default light if the model has none
-        if (m_model->scene().registry().getPool<LightSource>().size() == 0)
+        if (m_model->scene().registry().count<LightSource>() == 0)
         {
             Light l{};
             l.m_type = LightType::Directional;
@@ -570,6 +576,39 @@ public:
                 ImGui::Text("%u", m_indirectRenderer->getVisibleMeshCount());
                 ImGui::NextColumn();
 
+                const auto& occlusionStats = m_indirectRenderer->getOcclusionStats();
+                ImGui::Text("Occluded Meshes:"); ImGui::NextColumn();
+                ImGui::Text("%u / %u (%u occluders, %u tris)", occlusionStats.occludedBoxes,
+                            occlusionStats.testedBoxes, occlusionStats.occluders,
+                            occlusionStats.rasterizedTriangles);
+                ImGui::NextColumn();
+
+                const auto& lodDraws = m_indirectRenderer->getLodDraws();
+                const auto& lodTriangles = m_indirectRenderer->getLodTriangles();
+                for (size_t lod = 0; lod < lodDraws.size(); ++lod) {
+                    ImGui::Text("LOD%zu Triangles:", lod); ImGui::NextColumn();
+                    ImGui::Text("%llu (%u draws)", static_cast<unsigned long long>(lodTriangles[lod]), lodDraws[lod]);
+                    ImGui::NextColumn();
+                }
+
+                ImGui::Text("Transforms Touched:"); ImGui::NextColumn();
+                ImGui::Text("%u", m_indirectRenderer->getTransformNodesTouched());
+                ImGui::NextColumn();
+
+                const auto& instanceStats = m_indirectRenderer->getInstanceUploadStats();
+                ImGui::Text("Instance Upload:"); ImGui::NextColumn();
+                ImGui::Text("%u (%.1f KB)%s", instanceStats.instancesUploaded,
+                            static_cast<double>(instanceStats.bytesUploaded) / 1024.0,
+                            instanceStats.fullUpload ? " full" : "");
+                ImGui::NextColumn();
+
+                const auto& vertexStats = m_model->assets().vertexUploadStats();
+                ImGui::Text("Vertex Buffer:"); ImGui::NextColumn();
+                ImGui::Text("%.1f MB (%.1f MB full)",
+                            static_cast<double>(vertexStats.bytes) / (1024.0 * 1024.0),
+                            static_cast<double>(vertexStats.fullBytes) / (1024.0 * 1024.0));
+                ImGui::NextColumn();
+
                 auto streamStats = m_renderer->assets()->getStreamingStatistics();
                 ImGui::Text("Streaming:"); ImGui::NextColumn();
                 if (streamStats.queuedAssets > 0) {
@@ -579,6 +618,13 @@ public:
                 }
                 ImGui::NextColumn();
 
+                ImGui::Text("Texture Residency:"); ImGui::NextColumn();
+                ImGui::Text("%.1f / %.1f MB (%u demoted)",
+                            static_cast<double>(streamStats.textureResidentBytes) / (1024.0 * 1024.0),
+                            static_cast<double>(streamStats.textureResidencyBudget) / (1024.0 * 1024.0),
+                            streamStats.texturesDemoted);
+                ImGui::NextColumn();
+
                 ImGui::Columns(1);
                 ImGui::Separator();
 
@@ -587,6 +633,12 @@ public:
 
                 ImGui::Checkbox("GPU Profiler", &m_showGpuProfiler);
 
+                bool compactVertices = b_compactVertices.get();
+                if (ImGui::Checkbox("Compact Vertices (next load)", &compactVertices))
+                {
+                    b_compactVertices.set(compactVertices);
+                }
+
                 ImGui::Separator();
 
                 // MSAA Controls
@@ -630,6 +682,7 @@ public:
                 if (ImGui::Button("Wipe Asset Cache")) {
                     std::error_code ec;
                     std::filesystem::remove_all(resolveBasePath() / ".cache", ec);
+                    pnkr::assets::TextureDiskCache::global().clear();
                 }
                 ImGui::SameLine();
                 if (ImGui::Button("Clear Debug Lines")) {
@@ -712,6 +765,42 @@ public:
                 if (ImGui::Combo("Culling Mode", &currentMode, cullingModes, 3)) {
                     m_indirectRenderer->setCullingMode(static_cast<renderer::CullingMode>(currentMode));
                 }
+                ImGui::Checkbox("CPU Culling via BVH", &settings.bvhCulling);
+                ImGui::Checkbox("CPU Occlusion Culling", &settings.occlusionCulling);
+                ImGui::Checkbox("LOD Selection", &settings.lodSelection);
+                ImGui::SliderFloat("LOD Error (px)", &settings.lodErrorPixels, 0.25f, 16.0f, "%.2f");
+                ImGui::Checkbox("GPU Cluster Culling", &settings.clusterCulling);
+                ImGui::Checkbox("Texture Streaming", &settings.textureStreaming);
+                if (auto* streaming = m_renderer->assets()->textureStreaming())
+                {
+                    auto streamingSettings = streaming->settings();
+                    int budgetMB = static_cast<int>(streamingSettings.residencyBudgetBytes / (1024 * 1024));
+                    if (ImGui::SliderInt("Texture Budget (MB)", &budgetMB, 16, 4096))
+                    {
+                        streamingSettings.residencyBudgetBytes = static_cast<uint64_t>(budgetMB) * 1024 * 1024;
+                        streaming->setSettings(streamingSettings);
+                    }
+                }
+                if (auto* pacer = m_renderer->assets()->uploadPacing())
+                {
+                    auto pacing = pacer->settings();
+                    bool adaptive = pacing.mode == renderer::UploadPacingMode::Adaptive;
+                    bool changed = ImGui::Checkbox("Adaptive Upload Pacing", &adaptive);
+                    ImGui::BeginDisabled(!adaptive);
+                    float overheadMs = static_cast<float>(pacing.targetFrameOverheadMs);
+                    if (ImGui::SliderFloat("Upload Time (ms/frame)", &overheadMs, 0.25f, 8.0f, "%.2f"))
+                    {
+                        pacing.targetFrameOverheadMs = overheadMs;
+                        changed = true;
+                    }
+                    ImGui::EndDisabled();
+                    if (changed)
+                    {
+                        pacing.mode = adaptive ? renderer::UploadPacingMode::Adaptive
+                                               : renderer::UploadPacingMode::Fixed;
+                        pacer->setSettings(pacing);
+                    }
+                }
                 ImGui::Checkbox("Freeze Culling View (P)", &settings.freezeCulling);
             }
 
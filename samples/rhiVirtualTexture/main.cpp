@@ -0,0 +1,181 @@
+#include "pnkr/app/Application.hpp"
+#include "pnkr/core/logger.hpp"
+#include "pnkr/renderer/AssetManager.hpp"
+#include "pnkr/renderer/AsyncLoader.hpp"
+#include "pnkr/renderer/VirtualTextureSystem.hpp"
+#include "pnkr/renderer/scene/Camera.hpp"
+#include "pnkr/renderer/scene/CameraController.hpp"
+#include "pnkr/renderer/scene/VirtualTexturePlane.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <filesystem>
+#include <ktx.h>
+#include <memory>
+#include <vector>
+
+using namespace pnkr;
+using namespace pnkr::renderer;
+using namespace pnkr::renderer::scene;
+
+// Flies over a plane textured with one large virtual texture. The shader
+// reports the tiles it wanted and VirtualTextureSystem streams them into the
+// shared atlas a few frames later.
+// Usage: pnkr_rhi_virtual_texture [texture.ktx2]
+//
+// The texture must be an uncompressed-on-disk KTX2 with power of two
+// dimensions and a mip chain. Without a path, a generated test pattern is
+// written next to the executable and used instead.
+
+namespace {
+
+constexpr uint32_t kPatternSize = 4096;
+constexpr float kPlaneSize = 100.0f;
+
+// Every level has its own tint and dark lines on the tile boundaries, so
+// finer tiles arriving show up as the tint changing under the camera.
+bool writeTestPattern(const std::filesystem::path &path, uint32_t size, uint32_t tileSize) {
+  constexpr ktx_uint32_t kVkFormatR8G8B8A8Unorm = 37;
+  constexpr std::array<std::array<uint8_t, 3>, 6> kTints = {{{230, 80, 70},
+                                                             {240, 170, 60},
+                                                             {220, 220, 80},
+                                                             {90, 200, 110},
+                                                             {70, 160, 230},
+                                                             {170, 110, 220}}};
+
+  ktxTextureCreateInfo ci{};
+  ci.vkFormat = kVkFormatR8G8B8A8Unorm;
+  ci.baseWidth = size;
+  ci.baseHeight = size;
+  ci.baseDepth = 1;
+  ci.numDimensions = 2;
+  ci.numLevels = static_cast<uint32_t>(std::bit_width(size));
+  ci.numLayers = 1;
+  ci.numFaces = 1;
+  ci.isArray = KTX_FALSE;
+  ci.generateMipmaps = KTX_FALSE;
+
+  ktxTexture2 *tex = nullptr;
+  if (ktxTexture2_Create(&ci, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &tex) != KTX_SUCCESS) {
+    return false;
+  }
+
+  std::vector<uint8_t> pixels;
+  for (uint32_t level = 0; level < ci.numLevels; ++level) {
+    const uint32_t dim = size >> level;
+    const auto &tint = kTints[level % kTints.size()];
+    pixels.resize(static_cast<size_t>(dim) * dim * 4);
+    for (uint32_t y = 0; y < dim; ++y) {
+      for (uint32_t x = 0; x < dim; ++x) {
+        uint8_t *texel = &pixels[(static_cast<size_t>(y) * dim + x) * 4];
+        // Checker cells of 256 level-0 texels, the same on every level.
+        const bool light = (((x << level) / 256) + ((y << level) / 256)) % 2 == 0;
+        const bool edge = x % tileSize == 0 || y % tileSize == 0;
+        for (uint32_t c = 0; c < 3; ++c) {
+          texel[c] = edge ? 20 : static_cast<uint8_t>(light ? tint[c] : tint[c] * 7 / 10);
+        }
+        texel[3] = 255;
+      }
+    }
+    ktxTexture_SetImageFromMemory(ktxTexture(tex), level, 0, 0, pixels.data(), pixels.size());
+  }
+
+  const auto result = ktxTexture_WriteToNamedFile(ktxTexture(tex), path.string().c_str());
+  ktxTexture_Destroy(ktxTexture(tex));
+  return result == KTX_SUCCESS;
+}
+
+class VirtualTextureApp : public app::Application {
+public:
+  explicit VirtualTextureApp(std::filesystem::path path)
+      : Application({.title = "RHI Virtual Texture", .width = 1600, .height = 900, .rendererConfig = {}}),
+        m_path(std::move(path)) {}
+
+protected:
+  void onInit() override {
+    AsyncLoader *loader = m_renderer->assets()->asyncLoader();
+    if (loader == nullptr) {
+      core::Logger::error("Virtual textures stream through the AsyncLoader, which is disabled");
+      return;
+    }
+
+    const VirtualTextureSettings settings{};
+    if (m_path.empty()) {
+      m_path = baseDir() / "virtual_texture_pattern.ktx2";
+      if (!std::filesystem::exists(m_path)) {
+        core::Logger::info("Writing a {}x{} test pattern to {}", kPatternSize, kPatternSize, m_path.string());
+        if (!writeTestPattern(m_path, kPatternSize, settings.tileSize)) {
+          core::Logger::error("Failed to write {}", m_path.string());
+          return;
+        }
+      }
+    }
+
+    m_virtualTextures = std::make_unique<VirtualTextureSystem>(*m_renderer, *loader, settings);
+    m_texture = m_virtualTextures->registerTexture(m_path);
+    if (m_texture == VirtualTextureSystem::kInvalidId) {
+      m_virtualTextures.reset();
+      return;
+    }
+    m_plane.init(*m_renderer);
+  }
+
+  void onShutdown() override {
+    if (m_renderer && m_renderer->device()) {
+      m_renderer->device()->waitIdle();
+    }
+    m_plane.destroy();
+    m_virtualTextures.reset();
+    Application::onShutdown();
+  }
+
+  void onUpdate(float dt) override {
+    m_camera.setPerspective(glm::radians(60.0f),
+                            static_cast<float>(m_config.width) / static_cast<float>(m_config.height),
+                            0.1f, 1000.0f);
+    m_cameraController.update(m_input, dt);
+    m_cameraController.applyToCamera(m_camera);
+  }
+
+  void onImGui() override {
+    if (!m_virtualTextures) {
+      return;
+    }
+    const VirtualTextureStats stats = m_virtualTextures->stats();
+    ImGui::Begin("Virtual Texture");
+    ImGui::Text("%s", m_path.filename().string().c_str());
+    ImGui::Text("Resident tiles: %u of %u slots", stats.residentTiles, stats.atlasSlots);
+    ImGui::Text("Pending: %u | Deferred: %llu", stats.pendingTiles,
+                static_cast<unsigned long long>(stats.deferredTiles));
+    ImGui::Text("Requested: %llu | Uploaded: %llu", static_cast<unsigned long long>(stats.requestedTiles),
+                static_cast<unsigned long long>(stats.uploadedTiles));
+    ImGui::Text("Evictions: %llu", static_cast<unsigned long long>(stats.evictions));
+    ImGui::End();
+  }
+
+  void onRecord(const RHIFrameContext &ctx) override {
+    if (!m_virtualTextures) {
+      return;
+    }
+    // Reads the feedback of the frame that last used this frame slot and
+    // queues the tiles it asked for.
+    m_virtualTextures->update();
+    m_plane.draw(ctx.commandBuffer, m_camera, *m_virtualTextures, m_texture, kPlaneSize);
+  }
+
+private:
+  std::filesystem::path m_path;
+  std::unique_ptr<VirtualTextureSystem> m_virtualTextures;
+  VirtualTextureId m_texture = VirtualTextureSystem::kInvalidId;
+  VirtualTexturePlane m_plane;
+  Camera m_camera;
+  CameraController m_cameraController{{0.0f, 10.0f, 45.0f}, -90.0f, -15.0f};
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  VirtualTextureApp app(argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::path{});
+  return app.run();
+}
@@ -4,6 +4,7 @@
 #include <imgui.h>
 #include "pnkr/core/logger.hpp"
 #include "pnkr/renderer/io/GLTFLoader.hpp"
+#include "pnkr/renderer/scene/Bounds.hpp"
 #include <filesystem>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -56,54 +57,6 @@ namespace
 
         return Ray{origin, dir};
     }
-
-    static bool intersectRayAABB(const glm::vec3& ro, const glm::vec3& rd,
-                                 const glm::vec3& bmin, const glm::vec3& bmax,
-                                 float& outT)
-    {
-
-        const glm::vec3 invD = 1.0f / rd;
-
-        glm::vec3 t0 = (bmin - ro) * invD;
-        glm::vec3 t1 = (bmax - ro) * invD;
-
-        glm::vec3 tmin = glm::min(t0, t1);
-        glm::vec3 tmax = glm::max(t0, t1);
-
-        float tNear = glm::max(glm::max(tmin.x, tmin.y), tmin.z);
-        float tFar = glm::min(glm::min(tmax.x, tmax.y), tmax.z);
-
-        if (tFar < 0.0f || tNear > tFar) return false;
-
-        outT = (tNear >= 0.0f) ? tNear : tFar;
-        return true;
-    }
-
-    static void transformAABB(const glm::vec3& localMin, const glm::vec3& localMax,
-                              const glm::mat4& M,
-                              glm::vec3& outMin, glm::vec3& outMax)
-    {
-        glm::vec3 corners[8] = {
-            {localMin.x, localMin.y, localMin.z},
-            {localMax.x, localMin.y, localMin.z},
-            {localMin.x, localMax.y, localMin.z},
-            {localMax.x, localMax.y, localMin.z},
-            {localMin.x, localMin.y, localMax.z},
-            {localMax.x, localMin.y, localMax.z},
-            {localMin.x, localMax.y, localMax.z},
-            {localMax.x, localMax.y, localMax.z},
-        };
-
-        outMin = glm::vec3(std::numeric_limits<float>::infinity());
-        outMax = glm::vec3(-std::numeric_limits<float>::infinity());
-
-        for (glm::vec3 c : corners)
-        {
-            glm::vec3 w = glm::vec3(M * glm::vec4(c, 1.0f));
-            outMin = glm::min(outMin, w);
-            outMax = glm::max(outMax, w);
-        }
-    }
 }
 
 SceneEditorApp::SceneEditorApp() : pnkr::app::Application({
@@ -161,7 +114,7 @@ void SceneEditorApp::onUpdate(float dt)
     if (m_sceneDirty)
     {
         m_model->scene().recalculateGlobalTransformsFull();
-        m_indirectRenderer->updateGlobalTransforms();
+        m_indirectRenderer->invalidateInstances();
         m_sceneDirty = false;
     }
 
@@ -465,34 +418,11 @@ void SceneEditorApp::tryPick()
     Ray ray = makeMouseRay_WorkRect(m_camera, io.MousePos, pos, size);
     if (glm::length2(ray.dir) < 0.5f) return;
 
-    const auto& scene = m_model->scene();
-    const auto& bounds = m_model->meshBounds();
-
-    int bestNode = -1;
-    float bestT = std::numeric_limits<float>::infinity();
-
-    auto meshView = scene.registry().view<MeshRenderer, WorldTransform>();
-
-    meshView.each([&](ecs::Entity nodeId, MeshRenderer& mr, WorldTransform& world)
-    {
-        int32_t meshIdx = mr.meshID;
-        if (meshIdx < 0 || static_cast<size_t>(meshIdx) >= bounds.size()) return;
-
-        const auto& box = bounds[meshIdx];
-
-        glm::vec3 wmin, wmax;
-        transformAABB(box.m_min, box.m_max, world.matrix, wmin, wmax);
-
-        float t = 0.0f;
-        if (intersectRayAABB(ray.origin, ray.dir, wmin, wmax, t))
-        {
-            if (t < bestT)
-            {
-                bestT = t;
-                bestNode = (int)nodeId;
-            }
-        }
-    });
+    // The editor does not run IndirectRenderer::update, so bring the world
+    // bounds and their BVH up to date here before casting.
+    updateWorldBounds(m_model->scene());
+    const BvhRayHit hit = m_model->scene().bvh().raycast(ray.origin, ray.dir);
+    const int bestNode = hit.hit() ? static_cast<int>(hit.entity) : -1;
 
     if (bestNode != -1)
     {
@@ -0,0 +1,130 @@
+#include <doctest/doctest.h>
+#include "pnkr/assets/BC7Encoder.hpp"
+
+#include "cmp_core.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace pnkr::assets;
+
+namespace {
+    std::vector<uint8_t> makeNoise(uint32_t width, uint32_t height, uint32_t seed) {
+        std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+        for (auto& c : rgba) {
+            seed = seed * 1664525U + 1013904223U;
+            c = static_cast<uint8_t>(seed >> 24);
+        }
+        return rgba;
+    }
+
+    // Copies the image into a multiple-of-4 canvas, repeating the last
+    // column and row into the padding.
+    std::vector<uint8_t> padToBlocks(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height,
+                                     uint32_t& paddedWidth, uint32_t& paddedHeight) {
+        paddedWidth = (width + 3) / 4 * 4;
+        paddedHeight = (height + 3) / 4 * 4;
+        std::vector<uint8_t> padded(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+        for (uint32_t y = 0; y < paddedHeight; ++y) {
+            for (uint32_t x = 0; x < paddedWidth; ++x) {
+                const uint32_t sx = std::min(x, width - 1);
+                const uint32_t sy = std::min(y, height - 1);
+                std::memcpy(&padded[(static_cast<size_t>(y) * paddedWidth + x) * 4],
+                            &rgba[(static_cast<size_t>(sy) * width + sx) * 4], 4);
+            }
+        }
+        return padded;
+    }
+
+    // Serial block-by-block encode straight through Compressonator, sharing
+    // no code with BC7Encoder beyond the quality preset.
+    std::vector<uint8_t> encodeReference(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height,
+                                         BC7Quality quality) {
+        uint32_t paddedWidth = 0;
+        uint32_t paddedHeight = 0;
+        const std::vector<uint8_t> padded = padToBlocks(rgba, width, height, paddedWidth, paddedHeight);
+
+        const BC7QualityPreset& preset = bc7QualityPreset(quality);
+        void* options = nullptr;
+        CreateOptionsBC7(&options);
+        SetErrorThresholdBC7(options, preset.minThreshold, preset.maxThreshold);
+        SetQualityBC7(options, preset.quality);
+        SetMaskBC7(options, preset.modeMask);
+
+        std::vector<uint8_t> blocks;
+        const uint32_t stride = paddedWidth * 4;
+        for (uint32_t by = 0; by < paddedHeight / 4; ++by) {
+            for (uint32_t bx = 0; bx < paddedWidth / 4; ++bx) {
+                unsigned char block[16];
+                CompressBlockBC7(&padded[by * 4 * stride + bx * 16], stride, block, options);
+                blocks.insert(blocks.end(), block, block + 16);
+            }
+        }
+        DestroyOptionsBC7(options);
+        return blocks;
+    }
+}
+
+TEST_CASE("BC7 quality presets are ordered fastest to best") {
+    for (uint32_t q = 1; q < static_cast<uint32_t>(BC7Quality::Count); ++q) {
+        CHECK(bc7QualityPreset(static_cast<BC7Quality>(q)).quality >
+              bc7QualityPreset(static_cast<BC7Quality>(q - 1)).quality);
+    }
+    CHECK(bc7QualityPreset(BC7Quality::Max).quality == 1.0f);
+}
+
+TEST_CASE("BC7 mip levels encoded together match a serial encode of each level") {
+    // Non-multiple-of-4 sizes exercise the clamped edge blocks.
+    const std::vector<std::pair<uint32_t, uint32_t>> sizes = {{37, 21}, {18, 10}, {9, 5}, {1, 1}};
+    std::vector<std::vector<uint8_t>> pixels;
+    std::vector<BC7SourceImage> images;
+    for (const auto& [w, h] : sizes) {
+        pixels.push_back(makeNoise(w, h, w * 31 + h));
+        images.push_back({pixels.back().data(), w, h});
+    }
+
+    BC7EncoderConfig config;
+    config.quality = BC7Quality::Fastest;
+
+    std::vector<std::vector<uint8_t>> levels;
+    REQUIRE(BC7Encoder::compressLevels(images, config, levels));
+    REQUIRE(levels.size() == images.size());
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        CAPTURE(i);
+        const std::vector<uint8_t> reference =
+            encodeReference(pixels[i], images[i].width, images[i].height, config.quality);
+        CHECK(reference.size() == ((images[i].width + 3) / 4) * ((images[i].height + 3) / 4) * 16);
+        CHECK(levels[i] == reference);
+    }
+}
+
+TEST_CASE("BC7 edge blocks of unaligned images clamp to the last row and column") {
+    BC7EncoderConfig config;
+    config.quality = BC7Quality::Fastest;
+
+    for (const auto& [w, h] : std::vector<std::pair<uint32_t, uint32_t>>{{5, 3}, {13, 6}, {2, 9}, {3, 3}}) {
+        CAPTURE(w);
+        CAPTURE(h);
+        const std::vector<uint8_t> rgba = makeNoise(w, h, w * 7 + h);
+        uint32_t paddedWidth = 0;
+        uint32_t paddedHeight = 0;
+        const std::vector<uint8_t> padded = padToBlocks(rgba, w, h, paddedWidth, paddedHeight);
+
+        std::vector<uint8_t> unaligned;
+        std::vector<uint8_t> aligned;
+        REQUIRE(BC7Encoder::compress(rgba.data(), w, h, config, unaligned));
+        REQUIRE(BC7Encoder::compress(padded.data(), paddedWidth, paddedHeight, config, aligned));
+        CHECK(unaligned.size() == (paddedWidth / 4) * (paddedHeight / 4) * 16);
+        CHECK(unaligned == aligned);
+    }
+}
+
+TEST_CASE("BC7 encoder rejects empty input") {
+    std::vector<uint8_t> out;
+    CHECK_FALSE(BC7Encoder::compress(nullptr, 4, 4, {}, out));
+
+    std::vector<std::vector<uint8_t>> levels;
+    CHECK_FALSE(BC7Encoder::compressLevels({}, {}, levels));
+}
@@ -0,0 +1,167 @@
+#include <doctest/doctest.h>
+#include "pnkr/assets/GLTFParser.hpp"
+#include "pnkr/core/TaskSystem.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace pnkr;
+using namespace pnkr::assets;
+
+namespace {
+    constexpr size_t kMeshes = 8;
+    constexpr size_t kPrimitivesPerMesh = 6;
+
+    // Every primitive has its own vertex count and positions that encode
+    // (mesh, primitive, vertex), so a primitive landing in the wrong slot
+    // shows up in its data.
+    uint32_t vertexCount(size_t mesh, size_t prim) {
+        return 3 + static_cast<uint32_t>((mesh * kPrimitivesPerMesh + prim) * 7 % 29);
+    }
+    glm::vec3 vertexPosition(size_t mesh, size_t prim, uint32_t i) {
+        return {float(mesh), float(prim), float(i)};
+    }
+    // Odd meshes have a primitive without POSITION, which the parser drops.
+    bool hasPositions(size_t mesh, size_t prim) {
+        return mesh % 2 == 0 || prim != 2;
+    }
+
+    // Writes a .gltf with one node per mesh and its .bin into dir.
+    std::filesystem::path writeScene(const std::filesystem::path& dir) {
+        std::vector<uint8_t> bin;
+        std::string views;
+        std::string accessors;
+        uint32_t viewCount = 0;
+        // One buffer view per accessor, so both share an index.
+        const auto addAccessor = [&](const void* data, size_t size, const std::string& layout) {
+            const size_t offset = bin.size();
+            bin.resize(offset + size);
+            std::memcpy(bin.data() + offset, data, size);
+            const char* sep = viewCount == 0 ? "" : ",";
+            views += std::format(R"({}{{"buffer":0,"byteOffset":{},"byteLength":{}}})", sep, offset, size);
+            accessors += std::format(R"({}{{"bufferView":{},{}}})", sep, viewCount, layout);
+            return viewCount++;
+        };
+
+        std::string meshes;
+        std::string nodes;
+        std::string sceneNodes;
+        for (size_t m = 0; m < kMeshes; ++m) {
+            std::string prims;
+            for (size_t p = 0; p < kPrimitivesPerMesh; ++p) {
+                const uint32_t n = vertexCount(m, p);
+                std::vector<glm::vec3> positions(n);
+                std::vector<uint32_t> indices(n);
+                for (uint32_t i = 0; i < n; ++i) {
+                    positions[i] = vertexPosition(m, p, i);
+                    indices[i] = n - 1 - i;
+                }
+                const uint32_t position = addAccessor(positions.data(), positions.size() * sizeof(glm::vec3),
+                    std::format(R"("componentType":5126,"count":{},"type":"VEC3","min":[{},{},0],"max":[{},{},{}])",
+                                n, m, p, m, p, n - 1));
+                const uint32_t index = addAccessor(indices.data(), indices.size() * sizeof(uint32_t),
+                    std::format(R"("componentType":5125,"count":{},"type":"SCALAR")", n));
+                prims += std::format(R"({}{{"attributes":{{"{}":{}}},"indices":{}}})", p == 0 ? "" : ",",
+                                     hasPositions(m, p) ? "POSITION" : "NORMAL", position, index);
+            }
+            const char* sep = m == 0 ? "" : ",";
+            meshes += std::format(R"({}{{"name":"mesh{}","primitives":[{}]}})", sep, m, prims);
+            nodes += std::format(R"({}{{"mesh":{}}})", sep, m);
+            sceneNodes += std::format("{}{}", sep, m);
+        }
+
+        const std::filesystem::path binPath = dir / "primitives.bin";
+        {
+            std::ofstream out(binPath, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(bin.data()), static_cast<std::streamsize>(bin.size()));
+        }
+        const std::filesystem::path path = dir / "primitives.gltf";
+        {
+            std::ofstream out(path, std::ios::trunc);
+            out << std::format(
+                R"({{"asset":{{"version":"2.0"}},"buffers":[{{"uri":"primitives.bin","byteLength":{}}}],)"
+                R"("bufferViews":[{}],"accessors":[{}],"meshes":[{}],"nodes":[{}],)"
+                R"("scenes":[{{"nodes":[{}]}}],"scene":0}})",
+                bin.size(), views, accessors, meshes, nodes, sceneNodes);
+        }
+        return path;
+    }
+
+    ImportedModel parse(const std::filesystem::path& path) {
+        fastgltf::Parser parser;
+        auto data = fastgltf::GltfDataBuffer::FromPath(path);
+        REQUIRE(data.error() == fastgltf::Error::None);
+        auto asset = parser.loadGltf(data.get(), path.parent_path(), fastgltf::Options::LoadExternalBuffers);
+        REQUIRE(asset.error() == fastgltf::Error::None);
+
+        ImportedModel model;
+        GLTFParser::populateModel(model, asset.get(), nullptr);
+        return model;
+    }
+}
+
+TEST_CASE("Parallel primitive decode is deterministic and keeps glTF order") {
+    if (!core::TaskSystem::isInitialized()) {
+        core::TaskSystem::Config tsConfig;
+        tsConfig.numThreads = 4;
+        core::TaskSystem::init(tsConfig);
+    }
+
+    const auto dir = std::filesystem::temp_directory_path() / "pnkr_test_gltf_primitives";
+    std::filesystem::create_directories(dir);
+    const auto path = writeScene(dir);
+
+    // The first decode must hold exactly what a serial walk of the file
+    // produces: primitives in glTF order, minus the ones without positions.
+    const ImportedModel reference = parse(path);
+    REQUIRE(reference.meshes.size() == kMeshes);
+    for (size_t m = 0; m < kMeshes; ++m) {
+        CAPTURE(m);
+        const auto& prims = reference.meshes[m].primitives;
+        size_t kept = 0;
+        for (size_t p = 0; p < kPrimitivesPerMesh; ++p) {
+            if (!hasPositions(m, p)) {
+                continue;
+            }
+            CAPTURE(p);
+            REQUIRE(kept < prims.size());
+            const ImportedPrimitive& prim = prims[kept++];
+            const uint32_t n = vertexCount(m, p);
+            REQUIRE(prim.vertices.size() == n);
+            REQUIRE(prim.indices.size() == n);
+            for (uint32_t i = 0; i < n; ++i) {
+                CHECK(glm::vec3(prim.vertices[i].position) == vertexPosition(m, p, i));
+                CHECK(prim.vertices[i].meshIndex == m);
+                CHECK(prim.vertices[i].localIndex == i);
+                CHECK(prim.indices[i] == n - 1 - i);
+            }
+        }
+        CHECK(kept == prims.size());
+    }
+
+    // Later decodes schedule the primitives differently but must produce
+    // the same slots byte for byte.
+    for (int run = 0; run < 8; ++run) {
+        CAPTURE(run);
+        const ImportedModel model = parse(path);
+        REQUIRE(model.meshes.size() == reference.meshes.size());
+        for (size_t m = 0; m < kMeshes; ++m) {
+            const auto& expected = reference.meshes[m].primitives;
+            const auto& actual = model.meshes[m].primitives;
+            REQUIRE(actual.size() == expected.size());
+            for (size_t p = 0; p < expected.size(); ++p) {
+                REQUIRE(actual[p].vertices.size() == expected[p].vertices.size());
+                CHECK(std::memcmp(actual[p].vertices.data(), expected[p].vertices.data(),
+                                  expected[p].vertices.size() * sizeof(renderer::Vertex)) == 0);
+                CHECK(actual[p].indices == expected[p].indices);
+                CHECK(actual[p].materialIndex == expected[p].materialIndex);
+            }
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+}
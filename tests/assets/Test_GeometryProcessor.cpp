@@ -0,0 +1,210 @@
+#include <doctest/doctest.h>
+#include "pnkr/assets/GeometryProcessor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace pnkr;
+using namespace pnkr::assets;
+
+namespace {
+    // A unit quad as an unindexed triangle list: (0, 0) and (1, 1) appear twice.
+    ImportedPrimitive makeQuad() {
+        const glm::vec2 corners[] = {{0, 0}, {1, 0}, {1, 1}, {1, 1}, {0, 1}, {0, 0}};
+        ImportedPrimitive prim;
+        for (uint32_t i = 0; i < 6; ++i) {
+            renderer::Vertex v{};
+            v.position = glm::vec4(corners[i], 0.0f, 1.0f);
+            v.uv0 = corners[i];
+            v.localIndex = i;
+            prim.vertices.push_back(v);
+            prim.indices.push_back(i);
+        }
+        return prim;
+    }
+
+    // A flat n x n grid of quads in the XY plane.
+    ImportedPrimitive makeGrid(uint32_t n) {
+        ImportedPrimitive prim;
+        for (uint32_t y = 0; y <= n; ++y) {
+            for (uint32_t x = 0; x <= n; ++x) {
+                renderer::Vertex v{};
+                v.position = glm::vec4(float(x), float(y), 0.0f, 1.0f);
+                v.localIndex = static_cast<uint32_t>(prim.vertices.size());
+                prim.vertices.push_back(v);
+            }
+        }
+        for (uint32_t y = 0; y < n; ++y) {
+            for (uint32_t x = 0; x < n; ++x) {
+                const uint32_t i = y * (n + 1) + x;
+                prim.indices.insert(prim.indices.end(), {i, i + 1, i + n + 2, i, i + n + 2, i + n + 1});
+            }
+        }
+        return prim;
+    }
+
+    float windingZ(const ImportedPrimitive& prim, size_t tri) {
+        const glm::vec3 a(prim.vertices[prim.indices[tri * 3 + 0]].position);
+        const glm::vec3 b(prim.vertices[prim.indices[tri * 3 + 1]].position);
+        const glm::vec3 c(prim.vertices[prim.indices[tri * 3 + 2]].position);
+        return glm::cross(b - a, c - a).z;
+    }
+}
+
+TEST_CASE("GeometryProcessor::optimize merges duplicate vertices") {
+    auto prim = makeQuad();
+    const auto stats = GeometryProcessor::optimize(prim);
+
+    CHECK(stats.optimized);
+    CHECK(stats.verticesBefore == 6);
+    CHECK(stats.verticesAfter == 4);
+    CHECK(stats.triangles == 2);
+    CHECK(stats.acmrAfter <= stats.acmrBefore);
+    CHECK(stats.overfetchAfter <= stats.overfetchBefore);
+
+    REQUIRE(prim.vertices.size() == 4);
+    REQUIRE(prim.indices.size() == 6);
+    for (size_t i = 0; i < prim.vertices.size(); ++i) {
+        CHECK(prim.vertices[i].localIndex == i);
+    }
+    // First-use order, and winding is kept.
+    CHECK(prim.indices[0] == 0);
+    for (size_t tri = 0; tri < 2; ++tri) {
+        CHECK(windingZ(prim, tri) > 0.0f);
+    }
+}
+
+TEST_CASE("GeometryProcessor::optimize keeps vertices apart when their morph deltas differ") {
+    auto prim = makeQuad();
+    auto& target = prim.targets.emplace_back();
+    for (const auto& v : prim.vertices) {
+        target.positionDeltas.push_back(glm::vec3(v.position) * 2.0f);
+    }
+    // The second copy of corner (1, 1) moves differently.
+    target.positionDeltas[3] = glm::vec3(9.0f);
+
+    const auto stats = GeometryProcessor::optimize(prim);
+    CHECK(stats.optimized);
+    REQUIRE(prim.vertices.size() == 5);
+    REQUIRE(target.positionDeltas.size() == 5);
+    CHECK(target.normalDeltas.empty());
+
+    size_t moved = 0;
+    for (size_t i = 0; i < prim.vertices.size(); ++i) {
+        const glm::vec3 delta = target.positionDeltas[i];
+        if (delta == glm::vec3(9.0f)) {
+            ++moved;
+            CHECK(glm::vec3(prim.vertices[i].position) == glm::vec3(1.0f, 1.0f, 0.0f));
+        } else {
+            CHECK(delta == glm::vec3(prim.vertices[i].position) * 2.0f);
+        }
+    }
+    CHECK(moved == 1);
+}
+
+TEST_CASE("GeometryProcessor::optimize leaves non-triangle-lists alone") {
+    auto prim = makeQuad();
+    prim.indices.pop_back();
+    const auto before = prim.indices;
+
+    const auto stats = GeometryProcessor::optimize(prim);
+    CHECK_FALSE(stats.optimized);
+    CHECK(prim.vertices.size() == 6);
+    CHECK(prim.indices == before);
+}
+
+TEST_CASE("GeometryProcessor::generateLods builds a shrinking chain") {
+    auto prim = makeGrid(32);
+    GeometryProcessor::generateLods(prim);
+
+    REQUIRE_FALSE(prim.lods.empty());
+    CHECK(prim.lods.size() < kMaxPrimitiveLods);
+    size_t previousCount = prim.indices.size();
+    float previousError = 0.0f;
+    uint32_t expectedFirst = 0;
+    for (const auto& lod : prim.lods) {
+        CHECK(lod.firstIndex == expectedFirst);
+        CHECK(lod.indexCount % 3 == 0);
+        CHECK(lod.indexCount < previousCount);
+        CHECK(lod.indexCount >= 64 * 3);
+        CHECK(lod.error >= previousError);
+        expectedFirst += lod.indexCount;
+        previousCount = lod.indexCount;
+        previousError = lod.error;
+    }
+    CHECK(prim.lodIndices.size() == expectedFirst);
+    CHECK(std::ranges::all_of(prim.lodIndices, [&](uint32_t i) { return i < prim.vertices.size(); }));
+}
+
+TEST_CASE("GeometryProcessor::generateLods skips small primitives") {
+    auto prim = makeQuad();
+    GeometryProcessor::generateLods(prim);
+    CHECK(prim.lods.empty());
+    CHECK(prim.lodIndices.empty());
+}
+
+TEST_CASE("GeometryProcessor::optimize remaps LOD indices with the vertices") {
+    auto prim = makeGrid(16);
+    GeometryProcessor::generateLods(prim, {.minTriangles = 16});
+    REQUIRE_FALSE(prim.lods.empty());
+    std::vector<glm::vec4> before;
+    for (const uint32_t i : prim.lodIndices) {
+        before.push_back(prim.vertices[i].position);
+    }
+
+    GeometryProcessor::optimize(prim);
+    REQUIRE(prim.lodIndices.size() == before.size());
+    for (size_t i = 0; i < before.size(); ++i) {
+        CHECK(prim.vertices[prim.lodIndices[i]].position == before[i]);
+    }
+}
+
+TEST_CASE("GeometryProcessor::buildMeshlets splits LOD 0 into bounded clusters") {
+    auto prim = makeGrid(32);
+    auto triangles = [](const std::vector<uint32_t>& indices, size_t first, size_t count) {
+        std::vector<std::array<uint32_t, 3>> out;
+        for (size_t i = first; i < first + count; i += 3) {
+            // Rotate so the smallest index leads; keeps winding comparable.
+            std::array<uint32_t, 3> tri{indices[i], indices[i + 1], indices[i + 2]};
+            std::ranges::rotate(tri, std::ranges::min_element(tri));
+            out.push_back(tri);
+        }
+        std::ranges::sort(out);
+        return out;
+    };
+    const auto before = triangles(prim.indices, 0, prim.indices.size());
+
+    GeometryProcessor::buildMeshlets(prim);
+    REQUIRE(prim.meshlets.size() > 1);
+    CHECK(triangles(prim.indices, 0, prim.indices.size()) == before);
+
+    uint32_t expectedFirst = 0;
+    for (const auto& meshlet : prim.meshlets) {
+        CHECK(meshlet.firstIndex == expectedFirst);
+        CHECK(meshlet.indexCount % 3 == 0);
+        CHECK(meshlet.indexCount <= kMeshletMaxTriangles * 3);
+        expectedFirst += meshlet.indexCount;
+
+        std::vector<uint32_t> used(prim.indices.begin() + meshlet.firstIndex,
+                                   prim.indices.begin() + meshlet.firstIndex + meshlet.indexCount);
+        std::ranges::sort(used);
+        used.erase(std::unique(used.begin(), used.end()), used.end());
+        CHECK(used.size() <= kMeshletMaxVertices);
+        for (const uint32_t i : used) {
+            CHECK(glm::length(glm::vec3(prim.vertices[i].position) - meshlet.center) <= meshlet.radius + 1e-3f);
+        }
+        // A flat grid faces +z throughout.
+        CHECK(std::abs(meshlet.coneAxis.z) == doctest::Approx(1.0f));
+        CHECK(meshlet.coneCutoff < 1.0f);
+    }
+    CHECK(expectedFirst == prim.indices.size());
+}
+
+TEST_CASE("GeometryProcessor::buildMeshlets skips primitives that fit one cluster") {
+    auto prim = makeQuad();
+    const auto before = prim.indices;
+    GeometryProcessor::buildMeshlets(prim);
+    CHECK(prim.meshlets.empty());
+    CHECK(prim.indices == before);
+}
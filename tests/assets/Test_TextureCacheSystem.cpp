@@ -0,0 +1,76 @@
+#include <doctest/doctest.h>
+#include "pnkr/assets/TextureCacheSystem.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace pnkr::assets;
+
+namespace {
+    std::vector<uint8_t> makeNoise(uint32_t width, uint32_t height, uint32_t seed) {
+        std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+        for (auto& c : rgba) {
+            seed = seed * 1664525U + 1013904223U;
+            c = static_cast<uint8_t>(seed >> 24);
+        }
+        return rgba;
+    }
+
+    std::vector<char> readFile(const std::filesystem::path& path) {
+        std::ifstream is(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+    }
+}
+
+TEST_CASE("Texture encode stages run level by level match the one-shot writer") {
+    constexpr int kWidth = 100;
+    constexpr int kHeight = 60;
+    constexpr uint32_t kMaxSize = 64;
+    const auto source = makeNoise(kWidth, kHeight, 7U);
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto staged = dir / "pnkr_test_stage_chain_staged.ktx2";
+    const auto oneShot = dir / "pnkr_test_stage_chain_oneshot.ktx2";
+
+    for (const bool srgb : {false, true}) {
+        CAPTURE(srgb);
+        // The same order the import pipeline's tasks run in: every level is
+        // resized from the one above and encoded on its own.
+        const TextureMipChain chain = TextureCacheSystem::planMipChain(kWidth, kHeight, kMaxSize);
+        REQUIRE(chain.width == kMaxSize);
+        REQUIRE(chain.height < kMaxSize);
+        REQUIRE(chain.levels == 7);
+
+        std::vector<std::vector<uint8_t>> levelRGBA(chain.levels);
+        std::vector<std::vector<uint8_t>> levelBC7(chain.levels);
+        for (uint32_t level = 0; level < chain.levels; ++level) {
+            const uint32_t w = chain.levelWidth(level);
+            const uint32_t h = chain.levelHeight(level);
+            levelRGBA[level].resize(static_cast<size_t>(w) * h * 4);
+            if (level == 0) {
+                TextureCacheSystem::resizeLevel(source.data(), kWidth, kHeight, levelRGBA[0].data(), w, h, srgb);
+            } else {
+                TextureCacheSystem::resizeLevel(levelRGBA[level - 1].data(), chain.levelWidth(level - 1),
+                                                chain.levelHeight(level - 1), levelRGBA[level].data(), w, h, srgb);
+            }
+            REQUIRE(TextureCacheSystem::encodeLevelBC7(levelRGBA[level].data(), w, h, srgb, levelBC7[level]));
+            CHECK(levelBC7[level].size() == static_cast<size_t>((w + 3) / 4) * ((h + 3) / 4) * 16);
+        }
+
+        // A level missing from the chain is refused.
+        CHECK_FALSE(TextureCacheSystem::writeKtx2BC7LevelsAtomic(
+            staged, chain, std::span(levelBC7).first(chain.levels - 1), srgb, 0));
+
+        REQUIRE(TextureCacheSystem::writeKtx2BC7LevelsAtomic(staged, chain, levelBC7, srgb, 0));
+        REQUIRE(TextureCacheSystem::writeKtx2RGBA8MipmappedAtomic(oneShot, source.data(), kWidth, kHeight,
+                                                                  kMaxSize, srgb, 0));
+        const auto stagedBytes = readFile(staged);
+        CHECK_FALSE(stagedBytes.empty());
+        CHECK(stagedBytes == readFile(oneShot));
+    }
+
+    std::filesystem::remove(staged);
+    std::filesystem::remove(oneShot);
+}
@@ -0,0 +1,174 @@
+#include <doctest/doctest.h>
+#include "pnkr/assets/TextureDiskCache.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace pnkr::assets;
+
+namespace {
+    std::filesystem::path freshDir(const char* name) {
+        const auto dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(dir);
+        return dir;
+    }
+
+    void writeFile(const std::filesystem::path& path, size_t size) {
+        std::ofstream os(path, std::ios::binary);
+        const std::vector<char> bytes(size, 'k');
+        os.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+}
+
+TEST_CASE("TextureDiskCache keys depend on content and encoder settings") {
+    const std::vector<uint8_t> a = {1, 2, 3, 4};
+    const std::vector<uint8_t> b = {1, 2, 3, 5};
+    const auto hashA = TextureDiskCache::hashContent(a);
+
+    TextureCacheSettings settings{.srgb = true, .maxSize = 2048};
+    const auto key = TextureDiskCache::makeKey(hashA, settings);
+    CHECK(key == TextureDiskCache::makeKey(TextureDiskCache::hashContent(a), settings));
+    CHECK(key != TextureDiskCache::makeKey(TextureDiskCache::hashContent(b), settings));
+
+    auto linear = settings;
+    linear.srgb = false;
+    CHECK(key != TextureDiskCache::makeKey(hashA, linear));
+    auto smaller = settings;
+    smaller.maxSize = 1024;
+    CHECK(key != TextureDiskCache::makeKey(hashA, smaller));
+    auto best = settings;
+    best.quality = BC7Quality::Max;
+    CHECK(key != TextureDiskCache::makeKey(hashA, best));
+}
+
+TEST_CASE("TextureDiskCache entries survive a reopen through the index") {
+    const auto dir = freshDir("pnkr_test_texcache_index");
+    const uint64_t key = 0x1234;
+    {
+        TextureDiskCache cache({.directory = dir});
+        CHECK_FALSE(cache.lookup(key).has_value());
+        writeFile(cache.pathFor(key), 100);
+        REQUIRE(cache.insert(key));
+        CHECK(cache.lookup(key) == cache.pathFor(key));
+        CHECK(cache.stats().residentBytes == 100);
+    }
+    CHECK(std::filesystem::exists(dir / "index.bin"));
+    {
+        TextureDiskCache cache({.directory = dir});
+        CHECK(cache.stats().entries == 1);
+        CHECK(cache.lookup(key).has_value());
+        CHECK(cache.touch(cache.pathFor(key)));
+        CHECK_FALSE(cache.touch(dir / "albedo.ktx2"));
+        cache.clear();
+        CHECK_FALSE(cache.lookup(key).has_value());
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("TextureDiskCache drops entries whose file is gone") {
+    const auto dir = freshDir("pnkr_test_texcache_missing");
+    TextureDiskCache cache({.directory = dir});
+    const uint64_t key = 0x5678;
+    writeFile(cache.pathFor(key), 64);
+    REQUIRE(cache.insert(key));
+    std::filesystem::remove(cache.pathFor(key));
+
+    CHECK_FALSE(cache.lookup(key).has_value());
+    CHECK(cache.stats().entries == 0);
+    CHECK(cache.stats().residentBytes == 0);
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("TextureDiskCache rescans when the index count is corrupt") {
+    const auto dir = freshDir("pnkr_test_texcache_corrupt");
+    const uint64_t key = 0x9abc;
+    {
+        TextureDiskCache cache({.directory = dir});
+        writeFile(cache.pathFor(key), 32);
+        REQUIRE(cache.insert(key));
+    }
+    {
+        // Overwrite the entry count with something far past the file's end.
+        std::fstream index(dir / "index.bin", std::ios::binary | std::ios::in | std::ios::out);
+        REQUIRE(index);
+        const uint64_t count = ~0ULL / 2;
+        index.seekp(8);
+        index.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+    {
+        TextureDiskCache cache({.directory = dir});
+        CHECK(cache.stats().entries == 1);
+        CHECK(cache.lookup(key).has_value());
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("TextureDiskCache evicts least recently used files from earlier sessions") {
+    const auto dir = freshDir("pnkr_test_texcache_lru");
+    std::filesystem::create_directories(dir);
+
+    // No index: the cache rebuilds it from the files, using mtime as last use.
+    const auto now = std::filesystem::file_time_type::clock::now();
+    for (uint64_t key = 1; key <= 4; ++key) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.ktx2", static_cast<unsigned long long>(key));
+        writeFile(dir / name, 1000);
+        std::filesystem::last_write_time(dir / name, now - std::chrono::hours(10 - key));
+    }
+
+    {
+        TextureDiskCache cache({.directory = dir, .maxBytes = 2500});
+        CHECK(cache.stats().residentBytes <= 2500);
+        CHECK(cache.stats().evictions == 2);
+        CHECK_FALSE(cache.lookup(1).has_value());
+        CHECK_FALSE(cache.lookup(2).has_value());
+        CHECK(cache.lookup(3).has_value());
+        CHECK(cache.lookup(4).has_value());
+
+        // 3 and 4 are now in use this session, so going over the cap keeps them.
+        writeFile(cache.pathFor(5), 1000);
+        REQUIRE(cache.insert(5));
+        CHECK(cache.lookup(3).has_value());
+        CHECK(cache.lookup(5).has_value());
+        CHECK(cache.stats().evictions == 2);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("TextureDiskCache handles concurrent inserts and lookups") {
+    const auto dir = freshDir("pnkr_test_texcache_mt");
+    {
+        TextureDiskCache cache({.directory = dir, .capacity = 1024});
+
+        constexpr uint64_t kKeys = 256;
+        for (uint64_t key = 1; key <= kKeys; ++key) {
+            writeFile(cache.pathFor(key), 16);
+        }
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < 4; ++t) {
+            threads.emplace_back([&cache, t] {
+                for (uint64_t key = 1; key <= kKeys; ++key) {
+                    if ((key + t) % 2 == 0) {
+                        cache.insert(key);
+                    } else {
+                        (void)cache.lookup(key);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        CHECK(cache.stats().entries == kKeys);
+        CHECK(cache.stats().residentBytes == kKeys * 16);
+        for (uint64_t key = 1; key <= kKeys; ++key) {
+            CHECK(cache.lookup(key).has_value());
+        }
+    }
+    std::filesystem::remove_all(dir);
+}
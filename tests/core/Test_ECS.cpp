@@ -0,0 +1,146 @@
+#include <doctest/doctest.h>
+#include "pnkr/core/ECS.hpp"
+
+#include <functional>
+#include <string>
+
+using namespace pnkr::ecs;
+
+namespace {
+    struct Position { float x = 0.0f; float y = 0.0f; float z = 0.0f; };
+    struct Label { std::string text; };
+    struct Tagged {};
+}
+
+TEST_CASE("Registry storage modes agree") {
+    for (StorageMode mode : {StorageMode::SparseSet, StorageMode::Archetype}) {
+        CAPTURE(static_cast<int>(mode));
+        Registry reg(mode);
+
+        std::vector<Entity> entities;
+        for (int i = 0; i < 5000; ++i) {
+            Entity e = reg.create();
+            entities.push_back(e);
+            reg.emplace<Position>(e, static_cast<float>(i), 0.0f, 0.0f);
+            if (i % 3 == 0) {
+                reg.emplace<Label>(e, Label{std::to_string(i)});
+            }
+            if (i % 5 == 0) {
+                reg.emplace<Tagged>(e);
+            }
+        }
+
+        for (size_t i = 0; i < entities.size(); i += 7) {
+            reg.remove<Position>(entities[i]);
+        }
+        for (size_t i = 0; i < entities.size(); i += 11) {
+            reg.destroy(entities[i]);
+        }
+
+        SUBCASE("Component data survives archetype moves") {
+            for (size_t i = 0; i < entities.size(); ++i) {
+                if (i % 11 == 0) {
+                    CHECK_FALSE(reg.has<Position>(entities[i]));
+                    continue;
+                }
+                CHECK(reg.has<Position>(entities[i]) == (i % 7 != 0));
+                CHECK(reg.has<Tagged>(entities[i]) == (i % 5 == 0));
+                if (i % 3 == 0) {
+                    CHECK(reg.get<Label>(entities[i]).text == std::to_string(i));
+                }
+            }
+        }
+
+        SUBCASE("Views visit exactly the matching entities") {
+            size_t visited = 0;
+            reg.view<Position, Label>().each([&](Entity, Position& pos, Label& label) {
+                CHECK(std::to_string(static_cast<int>(pos.x)) == label.text);
+                ++visited;
+            });
+
+            size_t expected = 0;
+            for (size_t i = 0; i < entities.size(); ++i) {
+                if (i % 3 == 0 && i % 7 != 0 && i % 11 != 0) {
+                    ++expected;
+                }
+            }
+            CHECK(visited == expected);
+
+            size_t iterated = 0;
+            for (Entity e : reg.view<Position, Tagged>()) {
+                CHECK(reg.has<Tagged>(e));
+                ++iterated;
+            }
+
+            size_t expectedTagged = 0;
+            for (size_t i = 0; i < entities.size(); ++i) {
+                if (i % 5 == 0 && i % 7 != 0 && i % 11 != 0) {
+                    ++expectedTagged;
+                }
+            }
+            CHECK(iterated == expectedTagged);
+        }
+
+        SUBCASE("Command buffers remove tags queued from a view") {
+            EntityCommandBuffer commands(reg);
+            reg.view<Position, Tagged>().each([&](Entity e, Position&, Tagged&) {
+                commands.remove<Tagged>(e);
+            });
+            CHECK(reg.count<Tagged>() > 0);
+            commands.execute();
+
+            for (size_t i = 0; i < entities.size(); ++i) {
+                const bool keptTag = i % 5 == 0 && i % 7 == 0 && i % 11 != 0;
+                CHECK(reg.has<Tagged>(entities[i]) == keptTag);
+            }
+        }
+    }
+}
+
+TEST_CASE("Archetype chunks pack rows contiguously") {
+    Registry reg(StorageMode::Archetype);
+    for (int i = 0; i < 10000; ++i) {
+        Entity e = reg.create();
+        reg.emplace<Position>(e, static_cast<float>(i));
+    }
+
+    const auto& archetypes = reg.archetypes().archetypes();
+    REQUIRE(archetypes.size() == 1);
+    const Archetype& archetype = *archetypes.front();
+    CHECK(archetype.size() == 10000);
+    CHECK(archetype.rowsPerChunk() == (ArchetypeChunk::kSize - alignof(Position)) / (sizeof(Entity) + sizeof(Position)));
+    CHECK(archetype.chunkCount() == (10000 + archetype.rowsPerChunk() - 1) / archetype.rowsPerChunk());
+}
+
+TEST_CASE("Parallel views match serial iteration") {
+    for (StorageMode mode : {StorageMode::SparseSet, StorageMode::Archetype}) {
+        CAPTURE(static_cast<int>(mode));
+        Registry reg(mode);
+        for (int i = 0; i < 4096; ++i) {
+            Entity e = reg.create();
+            reg.emplace<Position>(e, static_cast<float>(i));
+            if (i % 2 == 0) {
+                reg.emplace<Tagged>(e);
+            }
+        }
+
+        reg.view<Position, Tagged>().parallelEach([](Entity, Position& pos, Tagged&) {
+            pos.y = pos.x * 2.0f;
+        }, 64);
+
+        const double parallelSum = reg.view<Position, Tagged>().parallelReduce<double>(
+            0.0, [](Entity, const Position& pos, const Tagged&) { return static_cast<double>(pos.y); },
+            std::plus<>{}, 64);
+
+        double serialSum = 0.0;
+        reg.view<Position, Tagged>().each([&](Entity, Position& pos, Tagged&) {
+            CHECK(pos.y == pos.x * 2.0f);
+            serialSum += pos.y;
+        });
+        CHECK(parallelSum == serialSum);
+
+        const uint32_t count = reg.view<Position>().parallelReduce<uint32_t>(
+            0U, [](Entity, const Position&) { return 1U; }, std::plus<>{});
+        CHECK(count == 4096U);
+    }
+}
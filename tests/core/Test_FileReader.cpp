@@ -0,0 +1,97 @@
+#include <doctest/doctest.h>
+#include "pnkr/core/FileReader.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace pnkr::core;
+
+namespace {
+    std::vector<uint8_t> makePattern(size_t size) {
+        std::vector<uint8_t> bytes(size);
+        uint32_t seed = 0x12345678U;
+        for (auto& b : bytes) {
+            seed = seed * 1664525U + 1013904223U;
+            b = static_cast<uint8_t>(seed >> 24);
+        }
+        return bytes;
+    }
+
+    std::string writeFile(const char* name, const std::vector<uint8_t>& bytes) {
+        const auto path = std::filesystem::temp_directory_path() / name;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return path.string();
+    }
+
+    void checkBackend(FileReaderBackend backend) {
+        const auto a = makePattern(3 * 1024 * 1024 + 17);
+        const auto b = makePattern(4096);
+        const std::string pathA = writeFile("pnkr_test_reader_a.bin", a);
+        const std::string pathB = writeFile("pnkr_test_reader_b.bin", b);
+        const std::string missing = (std::filesystem::temp_directory_path() / "pnkr_test_reader_missing.bin").string();
+
+        auto reader = FileReader::create(backend, 8);
+        REQUIRE(reader);
+        CAPTURE(reader->name());
+
+        // Half the reads land in a registered staging buffer, half outside it.
+        std::vector<uint8_t> staging(2 * 1024 * 1024);
+        std::vector<uint8_t> loose(a.size());
+        reader->registerBuffer(staging);
+
+        std::vector<FileReadRequest> requests;
+        uint64_t stagingOffset = 0;
+        for (uint64_t offset = 0; offset + 65536 <= 1024 * 1024; offset += 65536 + 512) {
+            requests.push_back({pathA, offset, 65536, staging.data() + stagingOffset});
+            stagingOffset += 65536;
+        }
+        requests.push_back({pathB, 100, 3000, staging.data() + stagingOffset});
+        requests.push_back({pathA, 0, a.size(), loose.data()});
+        // Past the end of the file: a short read, not an error.
+        std::vector<uint8_t> tail(64);
+        requests.push_back({pathB, b.size() - 16, 64, tail.data()});
+        requests.push_back({missing, 0, 64, tail.data()});
+
+        CHECK_FALSE(reader->read(requests));
+
+        const size_t loaded = requests.size() - 4;
+        for (size_t i = 0; i < loaded; ++i) {
+            const FileReadRequest& req = requests[i];
+            REQUIRE(req.result == 65536);
+            CHECK(std::equal(req.dst, req.dst + req.size, a.begin() + static_cast<ptrdiff_t>(req.offset)));
+        }
+        CHECK(requests[loaded].result == 3000);
+        CHECK(std::equal(requests[loaded].dst, requests[loaded].dst + 3000, b.begin() + 100));
+        CHECK(requests[loaded + 1].result == static_cast<int64_t>(a.size()));
+        CHECK(loose == a);
+        CHECK(requests[loaded + 2].result == 16);
+        CHECK(requests[loaded + 3].result < 0);
+
+        const FileReaderStats stats = reader->stats();
+        CHECK(stats.batches == 1);
+        CHECK(stats.requests == requests.size());
+        CHECK(stats.filesOpened == 3);
+        CHECK(stats.bytesRead == 65536 * loaded + 3000 + a.size() + 16);
+        CHECK(stats.syscalls > 0);
+
+        // A clean batch reports success.
+        std::vector<FileReadRequest> again{{pathB, 0, b.size(), loose.data()}};
+        CHECK(reader->read(again));
+        CHECK(std::equal(b.begin(), b.end(), loose.begin()));
+
+        std::filesystem::remove(pathA);
+        std::filesystem::remove(pathB);
+    }
+}
+
+TEST_CASE("FileReader blocking backend reads batches") {
+    checkBackend(FileReaderBackend::Blocking);
+}
+
+TEST_CASE("FileReader default backend reads batches") {
+    // io_uring where available; otherwise this repeats the blocking path.
+    checkBackend(FileReaderBackend::Auto);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pnkr/renderer/geometry/Frustum.hpp"
+
+#include <cstdint>
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+
+namespace pnkr::tests {
+
+    inline renderer::scene::BoundingBox makeBox(glm::vec3 center, float halfSize) {
+        renderer::scene::BoundingBox box;
+        box.m_min = center - glm::vec3(halfSize);
+        box.m_max = center + glm::vec3(halfSize);
+        return box;
+    }
+
+    // Camera on the +z axis looking at the origin, 60 degree vertical FOV, 3:2 aspect.
+    inline renderer::geometry::Frustum makeFrustum(float eyeZ = 10.0f, float farPlane = 100.0f) {
+        const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, farPlane);
+        const glm::mat4 view =
+            glm::lookAt(glm::vec3(0.0f, 0.0f, eyeZ), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        return renderer::geometry::createFrustum(proj * view);
+    }
+
+    // Deterministic boxes centred in [-100, 100)^3 with half sizes in [0.1, 5.1).
+    inline std::vector<renderer::scene::BoundingBox> makeScatter(uint32_t count, uint32_t seed = 12345U) {
+        std::vector<renderer::scene::BoundingBox> boxes;
+        const auto next = [&seed] {
+            seed = seed * 1664525U + 1013904223U;
+            return static_cast<float>(seed >> 8) / static_cast<float>(1U << 24);
+        };
+        for (uint32_t i = 0; i < count; ++i) {
+            const glm::vec3 c(next() * 200.0f - 100.0f, next() * 200.0f - 100.0f, next() * 200.0f - 100.0f);
+            boxes.push_back(makeBox(c, 0.1f + next() * 5.0f));
+        }
+        return boxes;
+    }
+}
@@ -0,0 +1,89 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/scene/AnimationClip.hpp"
+#include "pnkr/renderer/scene/Components.hpp"
+
+#include <glm/gtc/epsilon.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+using namespace pnkr::renderer::scene;
+
+namespace {
+    AnimationSampler makeSampler(InterpolationType type, std::vector<float> times, std::vector<glm::vec4> values) {
+        AnimationSampler sampler;
+        sampler.interpolation = type;
+        sampler.inputs = std::move(times);
+        sampler.outputs = std::move(values);
+        return sampler;
+    }
+
+    glm::vec4 quatAsVec(const glm::quat& q) { return {q.x, q.y, q.z, q.w}; }
+}
+
+TEST_CASE("Compiled clip matches reference interpolation") {
+    const glm::quat r0 = glm::angleAxis(0.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::quat r1 = glm::angleAxis(2.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    Animation anim;
+    anim.duration = 2.0f;
+    anim.samplers.push_back(makeSampler(InterpolationType::Linear, {0.0f, 1.0f, 2.0f},
+                                        {glm::vec4(0.0f), glm::vec4(10.0f, 0.0f, 0.0f, 0.0f),
+                                         glm::vec4(10.0f, 20.0f, 0.0f, 0.0f)}));
+    anim.samplers.push_back(makeSampler(InterpolationType::Linear, {0.0f, 2.0f},
+                                        {quatAsVec(r0), quatAsVec(r1)}));
+    anim.samplers.push_back(makeSampler(InterpolationType::Step, {0.0f, 1.0f},
+                                        {glm::vec4(1.0f), glm::vec4(3.0f)}));
+    anim.channels.push_back({.samplerIndex = 2, .targetNode = 7, .path = AnimationPath::Scale});
+    anim.channels.push_back({.samplerIndex = 0, .targetNode = 7, .path = AnimationPath::Translation});
+    anim.channels.push_back({.samplerIndex = 1, .targetNode = 3, .path = AnimationPath::Rotation});
+
+    const auto clip = CompiledAnimationClip::compile(anim);
+    REQUIRE(clip.targets().size() == 2);
+    CHECK(clip.targets()[0] == 3);
+    CHECK(clip.targets()[1] == 7);
+    REQUIRE(clip.trsTrackCount() == 3);
+    CHECK(clip.tracks()[0].path == AnimationPath::Translation);
+    CHECK(clip.tracks()[2].path == AnimationPath::Scale);
+    REQUIRE(clip.channelMasks().size() == 2);
+    CHECK(clip.channelMasks()[0] == CompiledAnimationClip::channelBit(AnimationPath::Rotation));
+    CHECK(clip.channelMasks()[1] == (CompiledAnimationClip::channelBit(AnimationPath::Translation) |
+                                     CompiledAnimationClip::channelBit(AnimationPath::Scale)));
+
+    LocalTRS pose[2];
+    LocalTRS* targets[2] = {&pose[0], &pose[1]};
+    AnimationCursor cursor;
+
+    // Sweep forwards, then jump back as a looping clip would.
+    for (float time : {0.25f, 0.5f, 1.5f, 1.75f, 0.1f}) {
+        CAPTURE(time);
+        clip.sample(time, cursor, targets);
+
+        const glm::vec3 expectedT = time < 1.0f ? glm::vec3(10.0f * time, 0.0f, 0.0f)
+                                                : glm::vec3(10.0f, 20.0f * (time - 1.0f), 0.0f);
+        CHECK(glm::all(glm::epsilonEqual(pose[1].translation, expectedT, 1e-4f)));
+        CHECK(pose[1].scale.x == doctest::Approx(time < 1.0f ? 1.0f : 3.0f));
+
+        const glm::quat expectedR = glm::slerp(r0, r1, time / 2.0f);
+        CHECK(std::abs(glm::dot(pose[0].rotation, expectedR)) == doctest::Approx(1.0f).epsilon(1e-4));
+    }
+}
+
+TEST_CASE("Compiled clip skips unbound targets and empty samplers") {
+    Animation anim;
+    anim.samplers.push_back(makeSampler(InterpolationType::Linear, {}, {}));
+    anim.samplers.push_back(makeSampler(InterpolationType::Linear, {0.0f}, {glm::vec4(5.0f)}));
+    anim.channels.push_back({.samplerIndex = 0, .targetNode = 1, .path = AnimationPath::Translation});
+    anim.channels.push_back({.samplerIndex = 1, .targetNode = 2, .path = AnimationPath::Translation});
+
+    const auto clip = CompiledAnimationClip::compile(anim);
+    REQUIRE(clip.targets().size() == 1);
+
+    LocalTRS* targets[1] = {nullptr};
+    AnimationCursor cursor;
+    clip.sample(1.0f, cursor, targets);
+    CHECK(cursor.keys.size() == 1);
+
+    LocalTRS pose;
+    targets[0] = &pose;
+    clip.sample(1.0f, cursor, targets);
+    CHECK(pose.translation.x == doctest::Approx(5.0f));
+}
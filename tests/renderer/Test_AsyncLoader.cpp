@@ -7,6 +7,7 @@
 #include <thread>
 #include <chrono>
 #include <filesystem>
+#include <ktx.h>
 #include <fstream>
 #include <vector>
 
@@ -280,3 +281,80 @@ TEST_CASE("AsyncLoader: Large Asset (Temporary Buffer Fallback)") {
     
     CHECK_MESSAGE(found, "Failed to load large asset that requires temporary buffer fallback");
 }
+
+TEST_CASE("AsyncLoader: Truncated zstd level fails the request") {
+    if (!pnkr::core::TaskSystem::isInitialized()) {
+        pnkr::core::TaskSystem::Config tsConfig;
+        tsConfig.numThreads = 2;
+        pnkr::core::TaskSystem::init(tsConfig);
+    }
+
+    Window window("TestWindow", 1280, 720, SDL_WINDOW_HIDDEN);
+    RendererConfig config{};
+    config.m_backend = rhi::RHIBackend::Null;
+    config.m_enableAsyncTextureLoading = true;
+
+    RHIRenderer renderer(window, config);
+    AsyncLoader loader(renderer);
+
+    // Noise barely compresses, so the file stays above the 2MB header-only
+    // threshold and its level is inflated by the transfer queue.
+    const uint32_t kWidth = 1024;
+    const uint32_t kHeight = 1024;
+    std::vector<uint8_t> pixels(static_cast<size_t>(kWidth) * kHeight * 4);
+    uint32_t seed = 7;
+    for (auto& p : pixels) {
+        seed = seed * 1664525U + 1013904223U;
+        p = static_cast<uint8_t>(seed >> 24);
+    }
+
+    const std::string fname = "truncated_zstd.ktx2";
+    {
+        ktxTextureCreateInfo ci{};
+        ci.vkFormat = 37; // VK_FORMAT_R8G8B8A8_UNORM
+        ci.baseWidth = kWidth;
+        ci.baseHeight = kHeight;
+        ci.baseDepth = 1;
+        ci.numDimensions = 2;
+        ci.numLevels = 1;
+        ci.numLayers = 1;
+        ci.numFaces = 1;
+        ci.generateMipmaps = KTX_FALSE;
+
+        ktxTexture2* tex = nullptr;
+        REQUIRE(ktxTexture2_Create(&ci, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &tex) == KTX_SUCCESS);
+        ktxTexture_SetImageFromMemory(ktxTexture(tex), 0, 0, 0, pixels.data(), pixels.size());
+        REQUIRE(ktxTexture2_DeflateZstd(tex, 1) == KTX_SUCCESS);
+        REQUIRE(ktxTexture_WriteToNamedFile(ktxTexture(tex), fname.c_str()) == KTX_SUCCESS);
+        ktxTexture_Destroy(ktxTexture(tex));
+    }
+
+    struct FileGuard {
+        std::string p;
+        ~FileGuard() { if(std::filesystem::exists(p)) std::filesystem::remove(p); }
+    } guard{fname};
+
+    // The only level is last in the file; cut the tail off it so the
+    // header still parses but inflating the level runs out of input.
+    const auto fullSize = std::filesystem::file_size(fname);
+    std::filesystem::resize_file(fname, fullSize - (256 * 1024));
+    REQUIRE(std::filesystem::file_size(fname) > 2 * 1024 * 1024);
+
+    rhi::TextureDescriptor desc{};
+    desc.extent = {1, 1, 1};
+    auto ptr = renderer.resourceManager()->createTexture("TruncatedTex", desc, false);
+    loader.requestTexture(fname, ptr.handle(), false);
+
+    bool failed = false;
+    for (int i = 0; i < 500; ++i) { // 5 seconds
+        try { loader.syncToGPU(); } catch(...) {}
+        loader.consumeCompletedTextures();
+        if (loader.getStatistics().failedLoads == 1) {
+            failed = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    CHECK_MESSAGE(failed, "A level that fails to inflate must fail the request instead of retrying it forever");
+}
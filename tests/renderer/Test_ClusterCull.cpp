@@ -0,0 +1,93 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/geometry/ClusterCull.hpp"
+#include "CullTestHelpers.hpp"
+
+using namespace pnkr::renderer;
+using namespace pnkr::renderer::geometry;
+using pnkr::tests::makeFrustum;
+
+namespace {
+    // Eye position of makeFrustum().
+    const glm::vec3 kCamera(0.0f, 0.0f, 10.0f);
+
+    // A flat cluster at the origin facing +z, towards the camera.
+    gpu::MeshletGPU makeMeshlet(glm::vec3 center = glm::vec3(0.0f), float radius = 1.0f) {
+        gpu::MeshletGPU meshlet{};
+        meshlet.sphere = glm::vec4(center, radius);
+        meshlet.coneApex = glm::vec4(center, 0.0f);
+        meshlet.coneAxis = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
+        meshlet.indexCount = 3;
+        return meshlet;
+    }
+}
+
+TEST_CASE("isSphereInFrustum keeps spheres touching the frustum") {
+    const Frustum frustum = makeFrustum();
+    CHECK(isSphereInFrustum(frustum, glm::vec3(0.0f), 1.0f));
+    CHECK_FALSE(isSphereInFrustum(frustum, glm::vec3(100.0f, 0.0f, 0.0f), 1.0f));
+    CHECK_FALSE(isSphereInFrustum(frustum, glm::vec3(0.0f, 0.0f, 20.0f), 1.0f));
+    // The far plane is at z = -90.
+    CHECK(isSphereInFrustum(frustum, glm::vec3(0.0f, 0.0f, -91.0f), 2.0f));
+    CHECK_FALSE(isSphereInFrustum(frustum, glm::vec3(0.0f, 0.0f, -91.0f), 0.5f));
+}
+
+TEST_CASE("isClusterBackfacing tests the normal cone against the camera") {
+    ClusterBounds cluster{.center = glm::vec3(0.0f),
+                          .radius = 1.0f,
+                          .coneApex = glm::vec3(0.0f),
+                          .coneAxis = glm::vec3(0.0f, 0.0f, 1.0f),
+                          .coneCutoff = 0.5f};
+    CHECK_FALSE(isClusterBackfacing(cluster, kCamera));
+    CHECK(isClusterBackfacing(cluster, -kCamera));
+    // Seen edge-on from inside the cone's spread, some triangles may face the camera.
+    CHECK_FALSE(isClusterBackfacing(cluster, glm::vec3(-10.0f, 0.0f, -1.0f)));
+    // A cone that spans every direction is never culled.
+    cluster.coneCutoff = 1.0f;
+    CHECK_FALSE(isClusterBackfacing(cluster, -kCamera));
+}
+
+TEST_CASE("cullClusters moves meshlet bounds into world space") {
+    const Frustum frustum = makeFrustum();
+    const std::vector<gpu::MeshletGPU> meshlets = {makeMeshlet(), makeMeshlet(glm::vec3(3.0f, 0.0f, 0.0f))};
+    std::vector<uint32_t> visible;
+
+    cullClusters(frustum, kCamera, meshlets, glm::mat4(1.0f), true, visible);
+    CHECK(visible == std::vector<uint32_t>{0, 1});
+
+    SUBCASE("Translation and scale move and grow the spheres") {
+        const glm::mat4 offset = glm::translate(glm::mat4(1.0f), glm::vec3(12.0f, 0.0f, 0.0f));
+        visible.clear();
+        cullClusters(frustum, kCamera, meshlets, offset, true, visible);
+        CHECK(visible.empty());
+
+        visible.clear();
+        cullClusters(frustum, kCamera, meshlets, glm::scale(offset, glm::vec3(4.0f)), true, visible);
+        CHECK(visible == std::vector<uint32_t>{0});
+    }
+
+    SUBCASE("Rotation turns the cones away from the camera") {
+        const glm::mat4 turned = glm::rotate(glm::mat4(1.0f), glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const ClusterBounds cluster = transformCluster(meshlets[1], turned);
+        CHECK(cluster.center.x == doctest::Approx(-3.0f));
+        CHECK(cluster.coneAxis.z == doctest::Approx(-1.0f));
+
+        visible.clear();
+        cullClusters(frustum, kCamera, meshlets, turned, true, visible);
+        CHECK(visible.empty());
+
+        visible.clear();
+        cullClusters(frustum, kCamera, meshlets, turned, false, visible);
+        CHECK(visible == std::vector<uint32_t>{0, 1});
+    }
+}
+
+TEST_CASE("preservesNormalCones accepts only rotation, uniform scale and translation") {
+    const glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(37.0f), glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+    CHECK(preservesNormalCones(glm::mat4(1.0f)));
+    CHECK(preservesNormalCones(glm::scale(glm::translate(rotation, glm::vec3(5.0f)), glm::vec3(2.0f))));
+    CHECK_FALSE(preservesNormalCones(glm::scale(rotation, glm::vec3(1.0f, 2.0f, 1.0f))));
+    CHECK_FALSE(preservesNormalCones(glm::scale(glm::mat4(1.0f), glm::vec3(-1.0f, 1.0f, 1.0f))));
+    CHECK_FALSE(preservesNormalCones(glm::scale(glm::mat4(1.0f), glm::vec3(0.0f))));
+
+    CHECK(maxScale(glm::scale(rotation, glm::vec3(1.0f, 3.0f, 2.0f))) == doctest::Approx(3.0f));
+}
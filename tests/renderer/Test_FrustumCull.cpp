@@ -0,0 +1,121 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/geometry/FrustumCull.hpp"
+#include "CullTestHelpers.hpp"
+
+using namespace pnkr::renderer;
+using namespace pnkr::renderer::geometry;
+using pnkr::tests::makeBox;
+using pnkr::tests::makeFrustum;
+using pnkr::tests::makeScatter;
+
+namespace {
+    // Reference: the plane half of isBoxInFrustum, one corner at a time.
+    bool behindAnyPlane(const Frustum& f, const scene::BoundingBox& b) {
+        for (const auto& plane : f.planes) {
+            bool allOut = true;
+            for (int c = 0; c < 8; ++c) {
+                const glm::vec3 p((c & 1) ? b.m_max.x : b.m_min.x, (c & 2) ? b.m_max.y : b.m_min.y,
+                                  (c & 4) ? b.m_max.z : b.m_min.z);
+                allOut = allOut && glm::dot(glm::vec3(plane), p) + plane.w < 0.0f;
+            }
+            if (allOut) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+TEST_CASE("SoA frustum kernel matches the per-corner plane test") {
+    const Frustum frustum = makeFrustum();
+    // Not a multiple of kCullBatch or the task chunk size, so both tails run.
+    const auto boxes = makeScatter(10'003);
+
+    AabbSoA soa;
+    soa.resize(static_cast<uint32_t>(boxes.size()));
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        soa.set(i, boxes[i]);
+    }
+    CHECK(soa.paddedSize() % kCullBatch == 0);
+
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        if (!behindAnyPlane(frustum, boxes[i])) {
+            expected.push_back(i);
+        }
+    }
+    REQUIRE_FALSE(expected.empty());
+    REQUIRE(expected.size() < boxes.size());
+
+    std::vector<uint32_t> simd;
+    cullBoxes(frustum, soa, 0, soa.size(), simd);
+    CHECK(simd == expected);
+
+    std::vector<uint32_t> scalar;
+    cullBoxesScalar(frustum, soa, 0, soa.size(), scalar);
+    CHECK(scalar == expected);
+
+    FrustumCuller culler;
+    const auto parallel = culler.cull(frustum, soa);
+    CHECK(std::vector<uint32_t>(parallel.begin(), parallel.end()) == expected);
+
+    for (uint32_t i : expected) {
+        CHECK(isBoxInFrustum(frustum, boxes[i]) == isBoxInFrustum(frustum, soa.get(i)));
+    }
+}
+
+TEST_CASE("Empty boxes and padding lanes never pass") {
+    const Frustum frustum = makeFrustum();
+    AabbSoA soa;
+    // Fill a whole batch with visible boxes first so shrinking has to reset the tail.
+    soa.resize(kCullBatch);
+    for (uint32_t i = 0; i < kCullBatch; ++i) {
+        soa.set(i, makeBox(glm::vec3(0.0f), 1.0f));
+    }
+    soa.resize(3);
+    soa.set(1, scene::BoundingBox{});
+    soa.set(2, makeBox(glm::vec3(0.0f, 0.0f, 500.0f), 1.0f));
+    REQUIRE(soa.paddedSize() == kCullBatch);
+
+    std::vector<uint32_t> visible;
+    cullBoxes(frustum, soa, 0, soa.size(), visible);
+    CHECK(visible == std::vector<uint32_t>{0});
+    CHECK_FALSE(soa.get(1).isValid());
+
+    // cullBoxes clamps to size(), but the SIMD loads still cover the padding
+    // lanes, so every one of them must fail some plane on its own.
+    for (uint32_t i = soa.size(); i < soa.paddedSize(); ++i) {
+        const glm::vec3 c(soa.cx()[i], soa.cy()[i], soa.cz()[i]);
+        const glm::vec3 e(soa.ex()[i], soa.ey()[i], soa.ez()[i]);
+        bool outside = false;
+        for (const auto& plane : frustum.planes) {
+            const glm::vec3 n(plane);
+            outside = outside || glm::dot(n, c) + glm::dot(glm::abs(n), e) + plane.w < 0.0f;
+        }
+        CHECK(outside);
+    }
+
+    // A full batch of empty lanes, run through both kernels without a tail mask.
+    AabbSoA empty;
+    empty.resize(kCullBatch);
+    cullBoxes(frustum, empty, 0, empty.size(), visible);
+    cullBoxesScalar(frustum, empty, 0, empty.size(), visible);
+    CHECK(visible == std::vector<uint32_t>{0});
+}
+
+TEST_CASE("Swap-remove keeps the remaining boxes addressable") {
+    const Frustum frustum = makeFrustum();
+    AabbSoA soa;
+    soa.resize(9);
+    for (uint32_t i = 0; i < 9; ++i) {
+        soa.set(i, makeBox(glm::vec3(float(i) - 4.0f, 0.0f, 0.0f), 0.25f));
+    }
+    soa.swapRemove(2);
+    REQUIRE(soa.size() == 8);
+    CHECK(soa.paddedSize() == 8);
+    CHECK(soa.get(2).m_min.x == doctest::Approx(4.0f - 0.25f));
+
+    std::vector<uint32_t> visible;
+    cullBoxes(frustum, soa, 0, soa.size(), visible);
+    CHECK(visible.size() == 8);
+}
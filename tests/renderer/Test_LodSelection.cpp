@@ -0,0 +1,62 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/scene/RenderBatcher.hpp"
+
+using namespace pnkr::renderer;
+using namespace pnkr::renderer::scene;
+
+namespace {
+    PrimitiveDOD makeChain() {
+        PrimitiveDOD prim;
+        prim.firstIndex = 100;
+        prim.indexCount = 3000;
+        prim.lodCount = 3;
+        prim.lods[0] = {.firstIndex = 3100, .indexCount = 1500, .error = 0.01f};
+        prim.lods[1] = {.firstIndex = 4600, .indexCount = 600, .error = 0.1f};
+        prim.lods[2] = {.firstIndex = 5200, .indexCount = 300, .error = 1.0f};
+        return prim;
+    }
+}
+
+TEST_CASE("PrimitiveDOD::level maps LOD 0 to the full index range") {
+    const auto prim = makeChain();
+    CHECK(prim.level(0).firstIndex == 100);
+    CHECK(prim.level(0).indexCount == 3000);
+    CHECK(prim.level(0).error == 0.0f);
+    CHECK(prim.level(2).firstIndex == 4600);
+    CHECK(prim.level(3).indexCount == 300);
+}
+
+TEST_CASE("PrimitiveDOD::selectLod keeps projected error under the threshold") {
+    const auto prim = makeChain();
+    // 1000 pixels tall, proj[1][1] of 1 (90 degree FOV), one pixel of error.
+    const float scale = RenderBatcher::lodErrorScale(1.0f, 1000.0f, 1.0f);
+    CHECK(scale == doctest::Approx(500.0f));
+
+    CHECK(prim.selectLod(scale, 0.0f) == 0);
+    CHECK(prim.selectLod(scale, 4.9f) == 0);
+    CHECK(prim.selectLod(scale, 10.0f) == 1);
+    CHECK(prim.selectLod(scale, 100.0f) == 2);
+    CHECK(prim.selectLod(scale, 1000.0f) == 3);
+
+    for (const float distance : {1.0f, 7.0f, 60.0f, 2000.0f}) {
+        CAPTURE(distance);
+        const auto level = prim.level(prim.selectLod(scale, distance));
+        const float pixels = level.error * 0.5f * 1000.0f / distance;
+        CHECK(pixels <= 1.0f);
+    }
+
+    SUBCASE("Larger instances switch later") {
+        CHECK(prim.selectLod(scale * 10.0f, 10.0f) == 0);
+        CHECK(prim.selectLod(scale * 10.0f, 100.0f) == 1);
+    }
+
+    SUBCASE("Primitives without a chain always use LOD 0") {
+        PrimitiveDOD plain;
+        plain.indexCount = 30;
+        CHECK(plain.selectLod(scale, 1.0e6f) == 0);
+    }
+}
+
+TEST_CASE("RenderBatcher::lodErrorScale disables selection without a pixel budget") {
+    CHECK(RenderBatcher::lodErrorScale(1.0f, 1000.0f, 0.0f) == 0.0f);
+}
@@ -0,0 +1,101 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/geometry/OcclusionCull.hpp"
+#include "CullTestHelpers.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+
+using namespace pnkr::renderer;
+using namespace pnkr::renderer::geometry;
+using pnkr::tests::makeBox;
+
+namespace {
+    // Camera at z = 10 looking down -z.
+    glm::mat4 makeViewProj() {
+        const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        return proj * view;
+    }
+
+    // A 10 x 10 wall in the z = 0 plane, facing the camera.
+    const std::vector<glm::vec3> kWall = {
+        {-5.0f, -5.0f, 0.0f}, {5.0f, -5.0f, 0.0f}, {5.0f, 5.0f, 0.0f}, {-5.0f, 5.0f, 0.0f}};
+    const std::vector<uint32_t> kWallIndices = {0, 1, 2, 0, 2, 3};
+
+    void drawWall(OcclusionCuller& culler, const glm::mat4& world = glm::mat4(1.0f)) {
+        culler.resize(320, 180);
+        culler.begin(makeViewProj());
+        culler.addOccluder(kWall, kWallIndices, world);
+        culler.rasterize();
+    }
+}
+
+TEST_CASE("OcclusionCuller hides boxes behind an occluder") {
+    OcclusionCuller culler;
+    drawWall(culler);
+    CHECK(culler.stats().occluders == 1);
+    CHECK(culler.stats().rasterizedTriangles == 2);
+
+    // Directly behind the wall.
+    CHECK(culler.isOccluded(makeBox(glm::vec3(0.0f, 0.0f, -5.0f), 1.0f)));
+    CHECK(culler.isOccluded(makeBox(glm::vec3(2.0f, -2.0f, -20.0f), 3.0f)));
+    // In front of the wall, beside it, or poking through it.
+    CHECK_FALSE(culler.isOccluded(makeBox(glm::vec3(0.0f, 0.0f, 5.0f), 1.0f)));
+    CHECK_FALSE(culler.isOccluded(makeBox(glm::vec3(10.0f, 0.0f, -5.0f), 0.5f)));
+    CHECK_FALSE(culler.isOccluded(makeBox(glm::vec3(0.0f, 0.0f, -1.0f), 1.5f)));
+    // Straddling the wall's silhouette.
+    CHECK_FALSE(culler.isOccluded(makeBox(glm::vec3(7.5f, 0.0f, -5.0f), 1.0f)));
+    // Crossing the near plane or behind the camera.
+    CHECK_FALSE(culler.isOccluded(makeBox(glm::vec3(0.0f, 0.0f, 10.0f), 1.0f)));
+    CHECK_FALSE(culler.isOccluded(makeBox(glm::vec3(0.0f, 0.0f, 20.0f), 1.0f)));
+}
+
+TEST_CASE("OcclusionCuller::cull matches isOccluded and is repeatable") {
+    std::vector<scene::BoundingBox> boxes;
+    for (int z = 0; z < 8; ++z) {
+        for (int x = -12; x <= 12; ++x) {
+            boxes.push_back(makeBox(glm::vec3(float(x), float(z % 3) - 1.0f, -2.0f - 3.0f * float(z)), 0.4f));
+        }
+    }
+    boxes.push_back(scene::BoundingBox{});
+
+    OcclusionCuller culler;
+    drawWall(culler);
+    const auto survivors = culler.cull(boxes);
+    const std::vector<uint32_t> first(survivors.begin(), survivors.end());
+
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        if (!culler.isOccluded(boxes[i])) {
+            expected.push_back(i);
+        }
+    }
+    CHECK(first == expected);
+    CHECK(culler.stats().testedBoxes == boxes.size());
+    CHECK(culler.stats().occludedBoxes == boxes.size() - expected.size());
+    CHECK(culler.stats().occludedBoxes > 0);
+    // The invalid box is never reported as occluded.
+    CHECK(first.back() == boxes.size() - 1);
+
+    // Same occluders give a bit-identical depth buffer and result.
+    OcclusionCuller again;
+    drawWall(again);
+    CHECK(std::vector<float>(again.depth().begin(), again.depth().end()) ==
+          std::vector<float>(culler.depth().begin(), culler.depth().end()));
+    const auto second = again.cull(boxes);
+    CHECK(std::vector<uint32_t>(second.begin(), second.end()) == first);
+}
+
+TEST_CASE("OcclusionCuller drops occluders that cross the near plane") {
+    OcclusionCuller culler;
+    // Moved onto the camera, the wall straddles the near plane.
+    drawWall(culler, glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 10.0f)));
+    CHECK(culler.stats().occluderTriangles == 2);
+    CHECK(culler.stats().rasterizedTriangles == 0);
+    CHECK_FALSE(culler.isOccluded(makeBox(glm::vec3(0.0f, 0.0f, -5.0f), 1.0f)));
+
+    // Every pixel is still at the far plane.
+    for (const float d : culler.depth()) {
+        REQUIRE(d == 1.0f);
+    }
+}
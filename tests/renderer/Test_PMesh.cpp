@@ -0,0 +1,190 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/io/ModelSerializer.hpp"
+#include "pnkr/renderer/io/PMeshFormat.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+using namespace pnkr;
+using namespace pnkr::renderer;
+
+namespace {
+    assets::ImportedPrimitive makePrimitive(uint32_t vertexCount, uint32_t material) {
+        assets::ImportedPrimitive prim;
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            Vertex v{};
+            v.position = glm::vec4(float(i), float(material), 0.0f, 1.0f);
+            v.uv0 = glm::vec2(float(i) * 0.5f);
+            prim.vertices.push_back(v);
+            prim.indices.push_back(vertexCount - 1 - i);
+        }
+        prim.materialIndex = material;
+        prim.minPos = glm::vec3(0.0f);
+        prim.maxPos = glm::vec3(float(vertexCount), float(material), 0.0f);
+        return prim;
+    }
+
+    assets::ImportedModel makeModel() {
+        assets::ImportedModel model;
+        model.textures.push_back({.sourcePath = "albedo.ktx2", .isSrgb = true, .isKtx = true});
+        model.materials.resize(2);
+
+        assets::ImportedMesh a;
+        a.name = "a";
+        a.primitives.push_back(makePrimitive(5, 0));
+        a.primitives.push_back(makePrimitive(3, 1));
+        auto& target = a.primitives[1].targets.emplace_back();
+        target.positionDeltas = {glm::vec3(1.0f), glm::vec3(2.0f), glm::vec3(3.0f)};
+        target.normalDeltas = {glm::vec3(0.5f), glm::vec3(0.5f), glm::vec3(0.5f)};
+
+        assets::ImportedMesh b;
+        b.name = "b";
+        b.primitives.push_back(makePrimitive(7, 1));
+
+        model.meshes = {a, b};
+        model.nodes.push_back({.name = "root", .meshIndex = 1});
+        model.rootNodes = {0};
+        return model;
+    }
+}
+
+TEST_CASE("PMESH v2 round-trips geometry as spans into the mapped file") {
+    const auto path = std::filesystem::temp_directory_path() / "pnkr_test_roundtrip.pmesh";
+    const auto source = makeModel();
+    REQUIRE(io::ModelSerializer::savePMESH(source, path));
+    CHECK(std::filesystem::file_size(path) % io::pmesh::kBlobAlignment == 0);
+
+    assets::ImportedModel loaded;
+    REQUIRE(io::ModelSerializer::loadPMESH(loaded, path));
+    REQUIRE(loaded.mappedFile != nullptr);
+    REQUIRE(loaded.meshes.size() == 2);
+    CHECK(loaded.meshes[1].name == "b");
+    CHECK(loaded.textures[0].sourcePath == "albedo.ktx2");
+    CHECK(loaded.materials.size() == 2);
+    CHECK(loaded.nodes[0].meshIndex == 1);
+    CHECK(loaded.rootNodes == std::vector<int>{0});
+
+    for (size_t m = 0; m < source.meshes.size(); ++m) {
+        REQUIRE(loaded.meshes[m].primitives.size() == source.meshes[m].primitives.size());
+        for (size_t p = 0; p < source.meshes[m].primitives.size(); ++p) {
+            const auto& src = source.meshes[m].primitives[p];
+            const auto& dst = loaded.meshes[m].primitives[p];
+            CAPTURE(m);
+            CAPTURE(p);
+            CHECK(dst.vertices.empty());
+            REQUIRE(dst.vertexData().size() == src.vertices.size());
+            REQUIRE(dst.indexData().size() == src.indices.size());
+            CHECK(std::memcmp(dst.vertexData().data(), src.vertices.data(), src.vertices.size() * sizeof(Vertex)) == 0);
+            CHECK(std::equal(src.indices.begin(), src.indices.end(), dst.indexData().begin()));
+            CHECK(dst.materialIndex == src.materialIndex);
+            CHECK(dst.maxPos == src.maxPos);
+        }
+    }
+
+    const auto* mapBegin = loaded.mappedFile->data();
+    const auto* firstVertex = reinterpret_cast<const uint8_t*>(loaded.meshes[0].primitives[0].vertexData().data());
+    CHECK(firstVertex >= mapBegin);
+    CHECK((firstVertex - mapBegin) % io::pmesh::kBlobAlignment == 0);
+
+    const auto& target = loaded.meshes[0].primitives[1].targets;
+    REQUIRE(target.size() == 1);
+    CHECK(target[0].positionDeltas[2] == glm::vec3(3.0f));
+    CHECK(target[0].normalDeltas.size() == 3);
+    CHECK(target[0].tangentDeltas.empty());
+
+    loaded = {};
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Truncated PMESH caches are rejected and deleted") {
+    const auto path = std::filesystem::temp_directory_path() / "pnkr_test_truncated.pmesh";
+    REQUIRE(io::ModelSerializer::savePMESH(makeModel(), path));
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - io::pmesh::kBlobAlignment);
+
+    assets::ImportedModel loaded;
+    CHECK_FALSE(io::ModelSerializer::loadPMESH(loaded, path));
+    CHECK(loaded.meshes.empty());
+    CHECK_FALSE(std::filesystem::exists(path));
+}
+
+TEST_CASE("PMESH caches remember whether geometry was optimized") {
+    const auto path = std::filesystem::temp_directory_path() / "pnkr_test_optimized.pmesh";
+    auto source = makeModel();
+    for (const bool optimized : {false, true}) {
+        source.meshesOptimized = optimized;
+        REQUIRE(io::ModelSerializer::savePMESH(source, path));
+
+        assets::ImportedModel loaded;
+        REQUIRE(io::ModelSerializer::loadPMESH(loaded, path));
+        CHECK(loaded.meshesOptimized == optimized);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("PMESH round-trips LOD chains per primitive") {
+    const auto path = std::filesystem::temp_directory_path() / "pnkr_test_lods.pmesh";
+    auto source = makeModel();
+    // Two levels on the first primitive, one on the last, none in between.
+    auto& first = source.meshes[0].primitives[0];
+    first.lodIndices = {4, 2, 0, 2, 0, 4};
+    first.lods = {{.firstIndex = 0, .indexCount = 3, .error = 0.25f},
+                  {.firstIndex = 3, .indexCount = 3, .error = 0.5f}};
+    auto& last = source.meshes[1].primitives[0];
+    last.lodIndices = {6, 3, 0};
+    last.lods = {{.firstIndex = 0, .indexCount = 3, .error = 1.0f}};
+    REQUIRE(io::ModelSerializer::savePMESH(source, path));
+
+    assets::ImportedModel loaded;
+    REQUIRE(io::ModelSerializer::loadPMESH(loaded, path));
+    for (size_t m = 0; m < source.meshes.size(); ++m) {
+        for (size_t p = 0; p < source.meshes[m].primitives.size(); ++p) {
+            const auto& src = source.meshes[m].primitives[p];
+            const auto& dst = loaded.meshes[m].primitives[p];
+            CAPTURE(m);
+            CAPTURE(p);
+            CHECK(dst.lodIndices.empty());
+            REQUIRE(dst.lods.size() == src.lods.size());
+            for (size_t l = 0; l < src.lods.size(); ++l) {
+                CHECK(dst.lods[l].firstIndex == src.lods[l].firstIndex);
+                CHECK(dst.lods[l].indexCount == src.lods[l].indexCount);
+                CHECK(dst.lods[l].error == src.lods[l].error);
+            }
+            CHECK(std::ranges::equal(dst.lodIndexData(), src.lodIndices));
+        }
+    }
+
+    loaded = {};
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("PMESH round-trips meshlets per primitive") {
+    const auto path = std::filesystem::temp_directory_path() / "pnkr_test_meshlets.pmesh";
+    auto source = makeModel();
+    auto& last = source.meshes[1].primitives[0];
+    last.indices.resize(6);
+    last.meshlets = {{.firstIndex = 0, .indexCount = 3, .center = glm::vec3(1.0f), .radius = 2.0f,
+                      .coneApex = glm::vec3(0.5f), .coneAxis = glm::vec3(0.0f, 0.0f, 1.0f), .coneCutoff = 0.25f},
+                     {.firstIndex = 3, .indexCount = 3, .center = glm::vec3(3.0f), .radius = 1.0f}};
+    REQUIRE(io::ModelSerializer::savePMESH(source, path));
+
+    assets::ImportedModel loaded;
+    REQUIRE(io::ModelSerializer::loadPMESH(loaded, path));
+    CHECK(loaded.meshes[0].primitives[0].meshlets.empty());
+    CHECK(loaded.meshes[0].primitives[1].meshlets.empty());
+    const auto& meshlets = loaded.meshes[1].primitives[0].meshlets;
+    REQUIRE(meshlets.size() == 2);
+    for (size_t i = 0; i < meshlets.size(); ++i) {
+        const auto& src = last.meshlets[i];
+        CHECK(meshlets[i].firstIndex == src.firstIndex);
+        CHECK(meshlets[i].indexCount == src.indexCount);
+        CHECK(meshlets[i].center == src.center);
+        CHECK(meshlets[i].radius == src.radius);
+        CHECK(meshlets[i].coneApex == src.coneApex);
+        CHECK(meshlets[i].coneAxis == src.coneAxis);
+        CHECK(meshlets[i].coneCutoff == src.coneCutoff);
+    }
+
+    loaded = {};
+    std::filesystem::remove(path);
+}
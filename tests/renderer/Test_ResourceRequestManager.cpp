@@ -34,6 +34,34 @@ TEST_CASE("ResourceRequestManager") {
         CHECK_FALSE(manager.hasPendingFileRequests());
     }
 
+    SUBCASE("File Request Reordering") {
+        const char* paths[] = {"a.ktx", "b.ktx", "c.ktx", "d.ktx"};
+        for (const char* path : paths) {
+            LoadRequest req{};
+            req.path = path;
+            manager.addFileRequest(req);
+        }
+        LoadRequest urgent{};
+        urgent.path = "urgent.ktx";
+        urgent.priority = LoadPriority::High;
+        manager.addFileRequest(urgent);
+
+        // c scores highest; a and d tie and keep their arrival order.
+        manager.reorderFileRequests([](const LoadRequest& req) {
+            if (req.path == "c.ktx") return 10.0f;
+            if (req.path == "b.ktx") return 0.0f;
+            return 1.0f;
+        });
+
+        CHECK(manager.getPendingFileCount() == 5);
+        CHECK(manager.popFileRequest().path == "urgent.ktx");
+        CHECK(manager.popFileRequest().path == "c.ktx");
+        CHECK(manager.popFileRequest().path == "a.ktx");
+        CHECK(manager.popFileRequest().path == "d.ktx");
+        CHECK(manager.popFileRequest().path == "b.ktx");
+        CHECK_FALSE(manager.hasPendingFileRequests());
+    }
+
     SUBCASE("Upload Queue Priorities") {
         CHECK(manager.getUploadQueueSize() == 0);
         CHECK(manager.getHighPriorityQueueSize() == 0);
@@ -0,0 +1,165 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/scene/SceneBVH.hpp"
+#include "CullTestHelpers.hpp"
+
+#include <algorithm>
+
+using namespace pnkr;
+using namespace pnkr::renderer;
+using namespace pnkr::renderer::scene;
+using pnkr::tests::makeBox;
+using pnkr::tests::makeScatter;
+
+namespace {
+    // Same plane test as the BVH and cullBoxes, applied to every box.
+    std::vector<ecs::Entity> bruteFrustum(const geometry::Frustum& f, const std::vector<BoundingBox>& boxes) {
+        std::vector<ecs::Entity> out;
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            const glm::vec3 c = (boxes[i].m_min + boxes[i].m_max) * 0.5f;
+            const glm::vec3 e = (boxes[i].m_max - boxes[i].m_min) * 0.5f;
+            bool outside = false;
+            for (const auto& plane : f.planes) {
+                const glm::vec3 n(plane);
+                outside = outside || glm::dot(n, c) + glm::dot(glm::abs(n), e) + plane.w < 0.0f;
+            }
+            if (!outside) {
+                out.push_back(i);
+            }
+        }
+        return out;
+    }
+
+    std::vector<ecs::Entity> sorted(std::vector<ecs::Entity> v) {
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    void fill(SceneBVH& bvh, const std::vector<BoundingBox>& boxes) {
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            bvh.update(i, boxes[i]);
+        }
+        bvh.refit();
+    }
+}
+
+TEST_CASE("SceneBVH frustum, AABB and sphere queries match a linear scan") {
+    // Large enough for the parallel subtree build.
+    const auto boxes = makeScatter(20'000, 7U);
+    SceneBVH bvh;
+    fill(bvh, boxes);
+    REQUIRE(bvh.size() == boxes.size());
+    CHECK(bvh.stats().rebuilds == 1);
+    CHECK(bvh.stats().nodeCount == 2 * boxes.size() - 1);
+
+    const auto frustum = pnkr::tests::makeFrustum(60.0f, 120.0f);
+    std::vector<ecs::Entity> result;
+    bvh.queryFrustum(frustum, result);
+    CHECK(sorted(result) == bruteFrustum(frustum, boxes));
+
+    const BoundingBox region = makeBox(glm::vec3(10.0f, -5.0f, 0.0f), 20.0f);
+    std::vector<ecs::Entity> expected;
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        if (boxes[i].intersects(region)) {
+            expected.push_back(i);
+        }
+    }
+    result.clear();
+    bvh.queryAabb(region, result);
+    CHECK(sorted(result) == expected);
+
+    const glm::vec3 center(-30.0f, 12.0f, 4.0f);
+    const float radius = 25.0f;
+    expected.clear();
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        const glm::vec3 d = glm::min(glm::max(center, boxes[i].m_min), boxes[i].m_max) - center;
+        if (glm::dot(d, d) <= radius * radius) {
+            expected.push_back(i);
+        }
+    }
+    result.clear();
+    bvh.querySphere(center, radius, result);
+    CHECK(sorted(result) == expected);
+
+    const BoundingBox all = bvh.bounds();
+    for (const auto& box : boxes) {
+        CHECK(all.intersects(box));
+    }
+}
+
+TEST_CASE("SceneBVH refits moved leaves and tracks inserts and removals") {
+    auto boxes = makeScatter(3'000, 99U);
+    SceneBVH bvh;
+    fill(bvh, boxes);
+
+    // Move a handful far outside the old bounds; refit must grow the root.
+    for (uint32_t i = 0; i < 10; ++i) {
+        boxes[i * 37] = makeBox(glm::vec3(500.0f + float(i), 0.0f, 0.0f), 1.0f);
+        bvh.update(i * 37, boxes[i * 37]);
+    }
+    bvh.refit();
+    CHECK(bvh.stats().refitLeaves == 10);
+    CHECK(bvh.bounds().m_max.x == doctest::Approx(510.0f));
+
+    std::vector<ecs::Entity> result;
+    bvh.queryAabb(makeBox(glm::vec3(505.0f, 0.0f, 0.0f), 10.0f), result);
+    CHECK(result.size() == 10);
+
+    // A few removals stay incremental; the tree keeps answering correctly.
+    const uint32_t rebuilds = bvh.stats().rebuilds;
+    bvh.remove(0);
+    bvh.remove(1);
+    bvh.update(2, BoundingBox{});
+    bvh.update(5000, makeBox(glm::vec3(0.0f), 1.0f));
+    bvh.refit();
+    CHECK(bvh.stats().rebuilds == rebuilds);
+    CHECK_FALSE(bvh.contains(0));
+    CHECK_FALSE(bvh.contains(2));
+    CHECK(bvh.contains(5000));
+    CHECK(bvh.size() == boxes.size() - 2);
+
+    boxes[0] = boxes[1] = boxes[2] = BoundingBox{};
+    boxes.resize(5001);
+    boxes[5000] = makeBox(glm::vec3(0.0f), 1.0f);
+    const auto frustum = pnkr::tests::makeFrustum(60.0f, 120.0f);
+    auto expected = bruteFrustum(frustum, boxes);
+    expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                  [&](ecs::Entity e) { return !boxes[e].isValid(); }),
+                   expected.end());
+    result.clear();
+    bvh.queryFrustum(frustum, result);
+    CHECK(sorted(result) == expected);
+
+    // Churning most of the tree triggers a full rebuild on the next refit.
+    for (uint32_t i = 3; i < 2'000; ++i) {
+        bvh.remove(i);
+    }
+    bvh.refit();
+    CHECK(bvh.stats().rebuilds == rebuilds + 1);
+    CHECK(bvh.stats().churn == 0);
+}
+
+TEST_CASE("SceneBVH raycast returns the closest box") {
+    SceneBVH bvh;
+    for (uint32_t i = 0; i < 64; ++i) {
+        bvh.update(i, makeBox(glm::vec3(float(i) * 4.0f, 0.0f, 0.0f), 1.0f));
+    }
+    bvh.refit();
+
+    auto hit = bvh.raycast(glm::vec3(-10.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    REQUIRE(hit.hit());
+    CHECK(hit.entity == 0);
+    CHECK(hit.t == doctest::Approx(9.0f));
+
+    hit = bvh.raycast(glm::vec3(300.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f));
+    REQUIRE(hit.hit());
+    CHECK(hit.entity == 63);
+
+    // Starting inside a box reports its exit distance.
+    hit = bvh.raycast(glm::vec3(40.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    REQUIRE(hit.hit());
+    CHECK(hit.entity == 10);
+    CHECK(hit.t == doctest::Approx(1.0f));
+
+    CHECK_FALSE(bvh.raycast(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f)).hit());
+    CHECK_FALSE(bvh.raycast(glm::vec3(-10.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 5.0f).hit());
+}
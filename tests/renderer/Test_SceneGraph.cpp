@@ -0,0 +1,152 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/scene/SceneGraph.hpp"
+#include "pnkr/renderer/scene/Bounds.hpp"
+#include "pnkr/renderer/scene/Components.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace pnkr;
+using namespace pnkr::renderer::scene;
+
+namespace {
+    // Builds a root with `fanout` children, each carrying a chain of `depth` descendants.
+    std::vector<ecs::Entity> buildForest(SceneGraphDOD& scene, uint32_t fanout, uint32_t depth) {
+        std::vector<ecs::Entity> nodes;
+        ecs::Entity root = scene.createNode();
+        nodes.push_back(root);
+        for (uint32_t i = 0; i < fanout; ++i) {
+            ecs::Entity parent = root;
+            for (uint32_t d = 0; d < depth; ++d) {
+                ecs::Entity node = scene.createNode(parent);
+                scene.registry().get<LocalTransform>(node).matrix =
+                    glm::translate(glm::mat4(1.0f), glm::vec3(float(i), 1.0f, float(d)));
+                nodes.push_back(node);
+                parent = node;
+            }
+        }
+        return nodes;
+    }
+
+    glm::mat4 referenceWorld(const SceneGraphDOD& scene, ecs::Entity e) {
+        const auto& reg = scene.registry();
+        glm::mat4 m = reg.get<LocalTransform>(e).matrix;
+        for (ecs::Entity p = reg.get<Relationship>(e).parent(); p != ecs::kNullEntity;
+             p = reg.get<Relationship>(p).parent()) {
+            m = reg.get<LocalTransform>(p).matrix * m;
+        }
+        return m;
+    }
+
+    bool nearlyEqual(const glm::mat4& a, const glm::mat4& b) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                if (std::abs(a[c][r] - b[c][r]) > 1e-4f) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE("Scene graph groups topo order by level") {
+    SceneGraphDOD scene;
+    auto nodes = buildForest(scene, 4, 3);
+    scene.recalculateGlobalTransformsFull();
+
+    auto offsets = scene.levelOffsets();
+    REQUIRE(offsets.size() == 5);
+    CHECK(offsets.back() == nodes.size());
+
+    const auto& topo = scene.topoOrder();
+    for (size_t level = 0; level + 1 < offsets.size(); ++level) {
+        for (uint32_t slot = offsets[level]; slot < offsets[level + 1]; ++slot) {
+            CHECK(scene.registry().get<Relationship>(topo[slot]).level() == level);
+        }
+    }
+
+    for (ecs::Entity e : nodes) {
+        CHECK(nearlyEqual(scene.registry().get<WorldTransform>(e).matrix, referenceWorld(scene, e)));
+    }
+}
+
+TEST_CASE("Incremental transform update only touches dirty subtrees") {
+    SceneGraphDOD scene;
+    auto nodes = buildForest(scene, 8, 4);
+    scene.recalculateGlobalTransformsFull();
+    scene.registry().getPool<BoundsDirtyTag>().clear();
+
+    // nodes[1] heads the first chain: itself plus three descendants.
+    ecs::Entity animated = nodes[1];
+    scene.registry().get<LocalTransform>(animated).matrix =
+        glm::rotate(glm::mat4(1.0f), 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+    scene.markAsChanged(animated);
+    scene.updateTransforms();
+
+    CHECK_FALSE(scene.transformStats().topoRebuilt);
+    CHECK(scene.transformStats().nodesTouched == 4);
+    for (ecs::Entity e : nodes) {
+        CHECK(nearlyEqual(scene.registry().get<WorldTransform>(e).matrix, referenceWorld(scene, e)));
+    }
+    CHECK(scene.registry().getPool<BoundsDirtyTag>().size() == 4);
+    CHECK(scene.registry().getPool<TransformDirtyTag>().size() == 0);
+
+    scene.updateTransforms();
+    CHECK(scene.transformStats().nodesTouched == 0);
+
+    // Reparenting is the only thing that forces the topo order to be rebuilt.
+    scene.setParent(nodes[2], nodes[5]);
+    scene.updateTransforms();
+    CHECK(scene.transformStats().topoRebuilt);
+    for (ecs::Entity e : nodes) {
+        CHECK(nearlyEqual(scene.registry().get<WorldTransform>(e).matrix, referenceWorld(scene, e)));
+    }
+}
+
+TEST_CASE("Incremental update re-resolves slots after a remove and add") {
+    SceneGraphDOD scene;
+    auto nodes = buildForest(scene, 4, 3);
+    scene.recalculateGlobalTransformsFull();
+
+    // Same pool size afterwards, but the removal swapped the last component
+    // into nodes[2]'s place and the re-added one went to the end.
+    auto& reg = scene.registry();
+    const glm::mat4 moved = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 5.0f, 0.0f));
+    const size_t before = reg.getPool<LocalTransform>().size();
+    reg.remove<LocalTransform>(nodes[2]);
+    reg.emplace<LocalTransform>(nodes[2]).matrix = moved;
+    REQUIRE(reg.getPool<LocalTransform>().size() == before);
+
+    scene.markAsChanged(nodes[2]);
+    scene.markAsChanged(nodes.back());
+    scene.updateTransforms();
+    for (ecs::Entity e : nodes) {
+        CHECK(nearlyEqual(reg.get<WorldTransform>(e).matrix, referenceWorld(scene, e)));
+    }
+}
+
+TEST_CASE("Shadow caster bounds skip system meshes and empty boxes") {
+    SceneGraphDOD scene;
+    auto& reg = scene.registry();
+    const auto addMesh = [&](int32_t meshID, const BoundingBox& box) {
+        ecs::Entity e = scene.createNode();
+        reg.emplace<MeshRenderer>(e, meshID);
+        reg.emplace<WorldBounds>(e, WorldBounds{box});
+    };
+
+    BoundingBox caster;
+    caster.m_min = glm::vec3(-1.0f);
+    caster.m_max = glm::vec3(1.0f);
+    BoundingBox helper;
+    helper.m_min = glm::vec3(-500.0f);
+    helper.m_max = glm::vec3(500.0f);
+
+    addMesh(0, caster);
+    addMesh(-1, helper);
+    addMesh(1, BoundingBox{});
+
+    const BoundingBox bounds = shadowCasterBounds(scene);
+    REQUIRE(bounds.isValid());
+    CHECK(bounds.m_min == caster.m_min);
+    CHECK(bounds.m_max == caster.m_max);
+}
@@ -0,0 +1,116 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/StagingRingAllocator.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace pnkr::renderer;
+
+TEST_CASE("StagingRingAllocator reserves, wraps and waits on batch fences") {
+    // Four 1 KB pages.
+    StagingRingAllocator ring(4000, 1024);
+    CHECK(ring.size() == 4096);
+    CHECK(ring.pageCount() == 4);
+
+    const uint64_t first = ring.beginBatch();
+    CHECK(ring.reserve(100, first, false) == 0);
+    CHECK(ring.reserve(100, first, false) == StagingRingAllocator::kAlignment);
+    CHECK(ring.reserve(3000, first, false) == 512);
+    CHECK(ring.usedBytes() == 4096);
+
+    SUBCASE("A batch never wraps onto its own pages") {
+        CHECK(ring.reserve(512, first, false) == 3584);
+        CHECK_FALSE(ring.reserve(1024, first, true).has_value());
+        CHECK(ring.stats().failedReservations == 1);
+        CHECK(ring.stats().stalls == 0);
+    }
+
+    SUBCASE("The next lap waits for the fence of the previous one") {
+        const uint64_t second = ring.beginBatch();
+        CHECK_FALSE(ring.reserve(1024, second, false).has_value());
+
+        ring.notifyBatchComplete(first);
+        CHECK(ring.usedBytes() == 0);
+        // 3584 + 1024 would straddle the end, so the range starts the next lap.
+        CHECK(ring.reserve(1024, second, false) == 0);
+        const StagingRingStats stats = ring.stats();
+        CHECK(stats.reservations == 4);
+        CHECK(stats.wrapBytes == 4096 - 3584);
+        CHECK(stats.alignmentBytes == (256 - 100) + (512 - 356) + (3584 - 3512));
+    }
+
+    SUBCASE("A waiting reservation resumes when the batch completes") {
+        const uint64_t second = ring.beginBatch();
+        std::thread completer([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            ring.notifyBatchComplete(first);
+        });
+        CHECK(ring.reserve(2048, second, true) == 0);
+        completer.join();
+        CHECK(ring.stats().stalls == 1);
+        CHECK(ring.stats().stallNs > 0);
+    }
+
+    SUBCASE("Batches may complete out of order") {
+        const uint64_t second = ring.beginBatch();
+        const uint64_t third = ring.beginBatch();
+        ring.notifyBatchComplete(third);
+        CHECK(ring.completedBatchId() == 0);
+        ring.notifyBatchComplete(first);
+        CHECK(ring.completedBatchId() == first);
+        ring.notifyBatchComplete(second);
+        CHECK(ring.completedBatchId() == third);
+    }
+}
+
+TEST_CASE("StagingRingAllocator hands out disjoint ranges to concurrent producers") {
+    constexpr uint32_t kProducers = 8;
+    constexpr uint32_t kBatchesPerProducer = 200;
+    StagingRingAllocator ring(64 * 1024, 4096);
+
+    // Each producer stamps its bytes and checks nobody overwrote them before
+    // retiring the batch.
+    std::vector<std::atomic<uint32_t>> owner(ring.size());
+    std::atomic<uint32_t> overlaps{0};
+    std::atomic<uint32_t> reserved{0};
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            uint32_t seed = 0x9E3779B9U * (p + 1);
+            for (uint32_t b = 0; b < kBatchesPerProducer; ++b) {
+                const uint64_t batch = ring.beginBatch();
+                seed = seed * 1664525U + 1013904223U;
+                const uint64_t size = 64 + (seed >> 20) % 6000;
+                const auto offset = ring.reserve(size, batch, true);
+                if (offset) {
+                    reserved.fetch_add(1, std::memory_order_relaxed);
+                    const uint32_t stamp = (p << 16) | b;
+                    for (uint64_t i = *offset; i < *offset + size; i += 64) {
+                        owner[i].store(stamp, std::memory_order_relaxed);
+                    }
+                    std::this_thread::yield();
+                    for (uint64_t i = *offset; i < *offset + size; i += 64) {
+                        if (owner[i].load(std::memory_order_relaxed) != stamp) {
+                            overlaps.fetch_add(1, std::memory_order_relaxed);
+                            break;
+                        }
+                    }
+                }
+                ring.notifyBatchComplete(batch);
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    CHECK(overlaps.load() == 0);
+    CHECK(reserved.load() > kProducers * kBatchesPerProducer / 2);
+    CHECK(ring.completedBatchId() == kProducers * kBatchesPerProducer);
+    CHECK(ring.usedBytes() == 0);
+    const StagingRingStats stats = ring.stats();
+    CHECK(stats.reservations == reserved.load());
+    CHECK(stats.reservations + stats.failedReservations == kProducers * kBatchesPerProducer);
+}
@@ -0,0 +1,195 @@
+#include "doctest/doctest.h"
+#include "pnkr/renderer/TextureStreamingScheduler.hpp"
+
+#include <utility>
+#include <vector>
+
+using namespace pnkr::renderer;
+
+namespace {
+    // 1024 x 1024 with a full chain: 11 mips, 4 MiB at mip 0.
+    constexpr uint64_t kFullBytes = 4ULL * 1024 * 1024;
+
+    TextureHandle makeHandle(uint32_t index) {
+        return TextureHandle{index, 1};
+    }
+
+    void addTexture(TextureStreamingScheduler& scheduler, TextureHandle handle, uint32_t baseMip = 0) {
+        scheduler.registerTexture(handle, "tex.ktx2", true, pnkr::assets::LoadPriority::Medium);
+        scheduler.onUploaded(handle, 1024, 1024, 11, kFullBytes, baseMip, true);
+    }
+
+    void report(TextureStreamingScheduler& scheduler, TextureHandle handle, float pixels) {
+        const std::pair<TextureHandle, float> size{handle, pixels};
+        scheduler.reportScreenSizes({&size, 1});
+    }
+}
+
+TEST_CASE("TextureStreamingScheduler picks the mip from screen size") {
+    TextureStreamingScheduler scheduler;
+    const TextureHandle tex = makeHandle(1);
+    addTexture(scheduler, tex);
+
+    std::vector<TextureStreamRequest> requests;
+    report(scheduler, tex, 1024.0f);
+    scheduler.update(requests);
+    CHECK(scheduler.targetMip(tex) == 0);
+    CHECK(requests.empty());
+
+    // A quarter of the texture's size on screen needs mip 2.
+    report(scheduler, tex, 256.0f);
+    scheduler.update(requests);
+    CHECK(scheduler.targetMip(tex) == 2);
+    REQUIRE(requests.size() == 1);
+    CHECK(requests[0].handle == tex);
+    CHECK(requests[0].baseMip == 2);
+
+    // Nothing new is issued while the change is in flight.
+    requests.clear();
+    report(scheduler, tex, 1024.0f);
+    scheduler.update(requests);
+    CHECK(requests.empty());
+    CHECK(scheduler.stats().requestsInFlight == 1);
+
+    scheduler.onUploaded(tex, 1024, 1024, 11, kFullBytes, 2, true);
+    CHECK(scheduler.residentMip(tex) == 2);
+    CHECK(scheduler.stats().residentBytes == kFullBytes / 16);
+
+    // Growing on screen again promotes back to mip 0.
+    report(scheduler, tex, 2048.0f);
+    scheduler.update(requests);
+    REQUIRE(requests.size() == 1);
+    CHECK(requests[0].baseMip == 0);
+
+    // A positive bias trades one mip of sharpness.
+    TextureStreamingSettings settings;
+    settings.mipBias = 1.0f;
+    scheduler.setSettings(settings);
+    report(scheduler, tex, 1024.0f);
+    scheduler.update(requests);
+    CHECK(scheduler.targetMip(tex) == 1);
+}
+
+TEST_CASE("TextureStreamingScheduler demotes least recently visible under budget") {
+    TextureStreamingScheduler scheduler;
+    const TextureHandle stale = makeHandle(1);
+    const TextureHandle small = makeHandle(2);
+    const TextureHandle large = makeHandle(3);
+    addTexture(scheduler, stale);
+    addTexture(scheduler, small);
+    addTexture(scheduler, large);
+
+    // Everything fits the default budget.
+    std::vector<TextureStreamRequest> requests;
+    report(scheduler, stale, 4096.0f);
+    report(scheduler, small, 2048.0f);
+    report(scheduler, large, 4096.0f);
+    scheduler.update(requests);
+    CHECK(requests.empty());
+    CHECK(scheduler.stats().demotedTextures == 0);
+
+    // 12 MiB wanted, 8.5 MiB allowed. Only small and large are on screen,
+    // so stale gives up two mips and the others keep full resolution.
+    TextureStreamingSettings settings;
+    settings.residencyBudgetBytes = 2 * kFullBytes + kFullBytes / 8;
+    settings.minResidentSize = 64;
+    scheduler.setSettings(settings);
+    report(scheduler, small, 2048.0f);
+    report(scheduler, large, 4096.0f);
+    scheduler.update(requests);
+
+    CHECK(scheduler.targetMip(stale) == 2);
+    CHECK(scheduler.targetMip(small) == 0);
+    CHECK(scheduler.targetMip(large) == 0);
+    const TextureStreamingStats stats = scheduler.stats();
+    CHECK(stats.targetBytes <= settings.residencyBudgetBytes);
+    CHECK(stats.residentBytes == 3 * kFullBytes);
+    CHECK(stats.budgetBytes == settings.residencyBudgetBytes);
+    CHECK(stats.demotedTextures == 1);
+    REQUIRE(requests.size() == 1);
+    CHECK(requests[0].handle == stale);
+    CHECK(requests[0].baseMip == 2);
+
+    // Next in line is the smaller of the visible textures.
+    settings.residencyBudgetBytes = 2 * kFullBytes;
+    scheduler.setSettings(settings);
+    report(scheduler, small, 2048.0f);
+    report(scheduler, large, 4096.0f);
+    scheduler.update(requests);
+    CHECK(scheduler.targetMip(stale) == 4);
+    CHECK(scheduler.targetMip(small) == 1);
+    CHECK(scheduler.targetMip(large) == 0);
+
+    // The floor stops demotion at 64 texels even when still over budget.
+    settings.residencyBudgetBytes = 1;
+    scheduler.setSettings(settings);
+    scheduler.update(requests);
+    CHECK(scheduler.targetMip(stale) == 4);
+    CHECK(scheduler.targetMip(small) == 4);
+    CHECK(scheduler.targetMip(large) == 4);
+}
+
+TEST_CASE("TextureStreamingScheduler orders requests by on-screen importance") {
+    TextureStreamingScheduler scheduler;
+    TextureStreamingSettings settings;
+    settings.maxRequestsPerUpdate = 2;
+    scheduler.setSettings(settings);
+
+    std::vector<TextureHandle> handles;
+    for (uint32_t i = 0; i < 4; ++i) {
+        handles.push_back(makeHandle(i + 1));
+        addTexture(scheduler, handles.back(), 5);
+    }
+    report(scheduler, handles[0], 128.0f);
+    report(scheduler, handles[1], 1024.0f);
+    report(scheduler, handles[2], 512.0f);
+    report(scheduler, handles[3], 256.0f);
+
+    std::vector<TextureStreamRequest> requests;
+    scheduler.update(requests);
+    REQUIRE(requests.size() == 2);
+    CHECK(requests[0].handle == handles[1]);
+    CHECK(requests[1].handle == handles[2]);
+    CHECK(scheduler.priorityOf(handles[1]) > scheduler.priorityOf(handles[3]));
+
+    // The rest follow on the next update.
+    requests.clear();
+    scheduler.update(requests);
+    REQUIRE(requests.size() == 2);
+    CHECK(requests[0].handle == handles[3]);
+    CHECK(requests[1].handle == handles[0]);
+
+    // Textures that drop out of view lose priority over time.
+    const float before = scheduler.priorityOf(handles[1]);
+    scheduler.update(requests);
+    CHECK(scheduler.priorityOf(handles[1]) < before);
+    CHECK(scheduler.priorityOf(makeHandle(99)) == 0.0f);
+}
+
+TEST_CASE("TextureStreamingScheduler keeps resident mips on failed reloads") {
+    TextureStreamingScheduler scheduler;
+    const TextureHandle tex = makeHandle(1);
+    scheduler.registerTexture(tex, "tex.ktx2", true, pnkr::assets::LoadPriority::Medium);
+    CHECK_FALSE(scheduler.onFailed(tex));
+
+    addTexture(scheduler, tex);
+    std::vector<TextureStreamRequest> requests;
+    report(scheduler, tex, 128.0f);
+    scheduler.update(requests);
+    REQUIRE(requests.size() == 1);
+    CHECK(scheduler.onFailed(tex));
+    CHECK(scheduler.residentMip(tex) == 0);
+
+    // Raw images without a stored chain never stream.
+    const TextureHandle raw = makeHandle(2);
+    scheduler.registerTexture(raw, "tex.png", true, pnkr::assets::LoadPriority::Medium);
+    scheduler.onUploaded(raw, 512, 512, 10, kFullBytes, 0, false);
+    requests.clear();
+    report(scheduler, raw, 16.0f);
+    scheduler.update(requests);
+    CHECK(requests.empty());
+    CHECK(scheduler.targetMip(raw) == 0);
+
+    scheduler.unregisterTexture(tex);
+    CHECK(scheduler.residentMip(tex) == TextureStreamingScheduler::kNoMip);
+}
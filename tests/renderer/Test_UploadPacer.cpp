@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/UploadPacer.hpp"
+
+#include <thread>
+
+using namespace pnkr::renderer;
+
+namespace {
+    constexpr uint64_t kMB = 1024 * 1024;
+}
+
+TEST_CASE("UploadPacer fixed mode caps each batch") {
+    UploadPacer pacer;
+    UploadPacingSettings settings;
+    settings.maxBytesPerFrame = 32 * kMB;
+    pacer.setSettings(settings);
+
+    CHECK(pacer.batchBudget() == 32 * kMB);
+    pacer.onBatchRecorded(64 * kMB, 1000000);
+    // Fixed pacing doesn't track frames.
+    CHECK(pacer.batchBudget() == 32 * kMB);
+    CHECK(pacer.stats().deferredBatches == 0);
+}
+
+TEST_CASE("UploadPacer adaptive mode follows the measured throughput") {
+    UploadPacer pacer;
+    UploadPacingSettings settings;
+    settings.mode = UploadPacingMode::Adaptive;
+    settings.targetFrameOverheadMs = 2.0;
+    settings.minBytesPerFrame = 1 * kMB;
+    settings.maxBytesPerFrame = 64 * kMB;
+    pacer.setSettings(settings);
+
+    // Uncalibrated: the first frame only gets the minimum.
+    pacer.beginFrame();
+    CHECK(pacer.batchBudget() == 1 * kMB);
+
+    // 2 bytes per ns: 2 ms of work per frame is 4 million bytes.
+    pacer.onBatchRecorded(1 * kMB, kMB / 2);
+    CHECK(pacer.stats().frameBudgetBytes == 4000000);
+    CHECK(pacer.batchBudget() == 4000000 - kMB);
+
+    pacer.onBatchRecorded(3 * kMB, 3 * kMB / 2);
+    CHECK(pacer.batchBudget() == 0);
+    CHECK(pacer.stats().deferredBatches == 1);
+
+    // A new frame restores the budget.
+    pacer.beginFrame();
+    CHECK(pacer.batchBudget() == 4000000);
+
+    SUBCASE("Slower batches shrink the budget down to the minimum") {
+        for (int i = 0; i < 32; ++i) {
+            pacer.onBatchRecorded(1 * kMB, 100000000);
+        }
+        CHECK(pacer.stats().frameBudgetBytes == 1 * kMB);
+    }
+
+    SUBCASE("Faster batches grow it up to the maximum") {
+        for (int i = 0; i < 32; ++i) {
+            pacer.onBatchRecorded(64 * kMB, 100000);
+        }
+        CHECK(pacer.stats().frameBudgetBytes == 64 * kMB);
+    }
+}
+
+TEST_CASE("UploadPacer doesn't stall without frames") {
+    UploadPacer pacer;
+    UploadPacingSettings settings;
+    settings.mode = UploadPacingMode::Adaptive;
+    settings.minBytesPerFrame = 1 * kMB;
+    settings.maxBytesPerFrame = 1 * kMB;
+    pacer.setSettings(settings);
+
+    CHECK(pacer.batchBudget() == 1 * kMB);
+    pacer.onBatchRecorded(1 * kMB, 1000000);
+    CHECK(pacer.batchBudget() == 0);
+
+    std::this_thread::sleep_for(UploadPacer::kMaxFrameInterval + std::chrono::milliseconds(10));
+    CHECK(pacer.batchBudget() > 0);
+}
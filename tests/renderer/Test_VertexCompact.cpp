@@ -0,0 +1,70 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/geometry/VertexCompact.hpp"
+
+#include <glm/gtc/epsilon.hpp>
+
+using namespace pnkr::renderer;
+using namespace pnkr::renderer::geometry;
+
+namespace {
+    Vertex makeVertex(uint32_t meshIndex, glm::vec3 pos, glm::vec3 normal, glm::vec4 tangent, glm::vec2 uv) {
+        Vertex v{};
+        v.position = glm::vec4(pos, 1.0f);
+        v.normal = glm::vec4(glm::normalize(normal), 0.0f);
+        v.tangent = glm::vec4(glm::normalize(glm::vec3(tangent)), tangent.w);
+        v.uv0 = uv;
+        v.uv1 = uv * 2.0f;
+        v.color = glm::vec4(0.25f, 0.5f, 0.75f, 1.0f);
+        v.meshIndex = meshIndex;
+        return v;
+    }
+}
+
+TEST_CASE("Compact vertex layout is 32 bytes") {
+    CHECK(sizeof(gpu::VertexCompactGPU) == 32);
+    CHECK(vertexStride(VertexFormat::Compact) * 4 < vertexStride(VertexFormat::Full));
+}
+
+TEST_CASE("Octahedral encoding round-trips unit vectors") {
+    for (const glm::vec3 n : {glm::vec3(0, 0, 1), glm::vec3(0, 0, -1), glm::vec3(1, 0, 0), glm::vec3(0, -1, 0),
+                              glm::normalize(glm::vec3(1, -2, -3)), glm::normalize(glm::vec3(-0.1f, 0.7f, 0.2f))}) {
+        CAPTURE(n);
+        CHECK(glm::dot(octDecode(octEncode(n)), n) > 0.99999f);
+    }
+}
+
+TEST_CASE("Compact vertices decode within quantization error of their mesh bounds") {
+    const std::vector<Vertex> vertices = {
+        makeVertex(0, {-1.0f, 0.0f, 2.0f}, {0, 1, 0}, {1, 0, 0, 1}, {0.0f, 1.0f}),
+        makeVertex(0, {3.0f, 0.5f, -2.0f}, {1, 1, -1}, {0, 0, 1, -1}, {0.5f, 0.25f}),
+        makeVertex(1, {100.0f, 100.0f, 100.0f}, {0, 0, -1}, {0, 1, 0, 1}, {-3.5f, 12.0f}),
+        makeVertex(1, {100.01f, 100.0f, 100.02f}, {-1, 0, 0}, {0, 0, -1, -1}, {0.125f, 0.0f}),
+    };
+
+    std::vector<gpu::VertexCompactGPU> compact;
+    std::vector<glm::vec4> meshDequant;
+    encodeCompactVertices(vertices, compact, meshDequant);
+
+    REQUIRE(compact.size() == vertices.size());
+    REQUIRE(meshDequant.size() == 2);
+    CHECK(meshDequant[0].w > 0.0f);
+    CHECK(meshDequant[1].w > 0.0f);
+    // A small mesh far from the origin keeps a small step.
+    CHECK(meshDequant[1].w < 1e-6f);
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        CAPTURE(i);
+        const Vertex& src = vertices[i];
+        const glm::vec4 dequant = meshDequant[src.meshIndex];
+        const Vertex out = decodeCompactVertex(compact[i], dequant);
+
+        CHECK(out.meshIndex == src.meshIndex);
+        CHECK(glm::all(glm::epsilonEqual(glm::vec3(out.position), glm::vec3(src.position), dequant.w * 0.5f + 1e-4f)));
+        CHECK(glm::dot(glm::vec3(out.normal), glm::vec3(src.normal)) > 0.9999f);
+        CHECK(glm::dot(glm::vec3(out.tangent), glm::vec3(src.tangent)) > 0.9999f);
+        CHECK(out.tangent.w == src.tangent.w);
+        CHECK(glm::all(glm::epsilonEqual(out.uv0, src.uv0, 1e-2f)));
+        CHECK(glm::all(glm::epsilonEqual(out.uv1, src.uv1, 2e-2f)));
+        CHECK(glm::all(glm::epsilonEqual(out.color, src.color, 1.0f / 255.0f)));
+    }
+}
@@ -0,0 +1,156 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/VirtualTexture.hpp"
+
+using namespace pnkr::renderer;
+
+namespace {
+    uint32_t residentSlot(uint32_t entry) { return entry & 0xFFFF; }
+    uint32_t residentMip(uint32_t entry) { return (entry >> 16) & 0xFF; }
+    bool hasFallback(uint32_t entry) { return (entry >> 24) != 0; }
+}
+
+TEST_CASE("VirtualTileId packs into the feedback format") {
+    const VirtualTileId tile{.texture = 200, .mip = 11, .x = 1023, .y = 517};
+    CHECK(VirtualTileId::unpack(tile.pack()) == tile);
+    const VirtualTileId small{.texture = 1, .mip = 2, .x = 3, .y = 4};
+    CHECK(small.pack() == (3U | (4U << 10) | (2U << 20) | (1U << 24)));
+}
+
+TEST_CASE("VirtualPageTable falls back to the finest resident ancestor") {
+    // 8x4 tiles at mip 0, down to 2x1 at mip 2.
+    VirtualPageTable table(8, 4, 3);
+    REQUIRE(table.mipLevels() == 3);
+    CHECK(table.tilesX(2) == 2);
+    CHECK(table.tilesY(2) == 1);
+    CHECK(table.entries(0).size() == 32);
+
+    // Nothing resident: no fallback anywhere.
+    CHECK_FALSE(hasFallback(table.entry(0, 5, 3)));
+
+    table.map(2, 1, 0, 7);
+    CHECK(table.slot(2, 1, 0) == 7);
+    // Every tile under the right half of mip 2 now uses slot 7 ...
+    for (uint32_t y = 0; y < 4; ++y) {
+        for (uint32_t x = 4; x < 8; ++x) {
+            const uint32_t entry = table.entry(0, x, y);
+            CHECK(hasFallback(entry));
+            CHECK(residentSlot(entry) == 7);
+            CHECK(residentMip(entry) == 2);
+        }
+    }
+    // ... and the left half still has nothing.
+    CHECK_FALSE(hasFallback(table.entry(0, 0, 0)));
+    CHECK(table.slot(0, 5, 1) == VirtualPageTable::kNoSlot);
+
+    // A finer tile overrides the fallback for its own subtree only.
+    table.map(1, 2, 1, 9);
+    CHECK(residentSlot(table.entry(0, 4, 2)) == 9);
+    CHECK(residentSlot(table.entry(0, 5, 3)) == 9);
+    CHECK(residentMip(table.entry(0, 5, 3)) == 1);
+    CHECK(residentSlot(table.entry(0, 6, 2)) == 7);
+
+    table.map(0, 5, 3, 11);
+    CHECK(residentSlot(table.entry(0, 5, 3)) == 11);
+
+    SUBCASE("Unmapping restores the parent's fallback but keeps resident children") {
+        table.unmap(1, 2, 1);
+        CHECK(residentSlot(table.entry(0, 4, 2)) == 7);
+        CHECK(residentMip(table.entry(1, 2, 1)) == 2);
+        CHECK(residentSlot(table.entry(0, 5, 3)) == 11);
+        CHECK(table.slot(1, 2, 1) == VirtualPageTable::kNoSlot);
+    }
+
+    SUBCASE("Unmapping the root clears tiles without a resident ancestor") {
+        table.unmap(2, 1, 0);
+        CHECK_FALSE(hasFallback(table.entry(0, 7, 0)));
+        CHECK_FALSE(hasFallback(table.entry(1, 3, 1)));
+        CHECK(residentSlot(table.entry(0, 4, 2)) == 9);
+    }
+
+    SUBCASE("Changes mark the table dirty") {
+        table.clearDirty();
+        CHECK_FALSE(table.dirty());
+        table.map(0, 0, 0, 3);
+        CHECK(table.dirty());
+    }
+}
+
+TEST_CASE("VirtualTileCache evicts the least recently used slot") {
+    VirtualTileCache cache(3);
+    uint32_t evicted = 0;
+
+    const auto a = cache.allocate(100, 1, evicted);
+    const auto b = cache.allocate(101, 1, evicted);
+    const auto c = cache.allocate(102, 2, evicted);
+    REQUIRE(a);
+    REQUIRE(b);
+    REQUIRE(c);
+    CHECK(evicted == VirtualTileCache::kNoTile);
+    CHECK(cache.usedSlots() == 3);
+
+    // a was used again, so b is now the oldest.
+    cache.touch(*a, 3);
+    const auto d = cache.allocate(103, 4, evicted);
+    REQUIRE(d);
+    CHECK(*d == *b);
+    CHECK(evicted == 101);
+    CHECK(cache.tileAt(*d) == 103);
+    CHECK(cache.evictions() == 1);
+
+    SUBCASE("Pinned slots are skipped") {
+        cache.setPinned(*c, true);
+        const auto e = cache.allocate(104, 5, evicted);
+        REQUIRE(e);
+        CHECK(*e == *a);
+        CHECK(evicted == 100);
+        CHECK(cache.isPinned(*c));
+    }
+
+    SUBCASE("Slots used this frame are never evicted") {
+        cache.touch(*a, 5);
+        cache.touch(*c, 5);
+        cache.touch(*d, 5);
+        const auto e = cache.allocate(104, 5, evicted);
+        CHECK_FALSE(e);
+        CHECK(evicted == VirtualTileCache::kNoTile);
+        CHECK(cache.evictions() == 1);
+    }
+
+    SUBCASE("Released slots are reused before evicting") {
+        cache.release(*c);
+        CHECK(cache.usedSlots() == 2);
+        const auto e = cache.allocate(104, 5, evicted);
+        REQUIRE(e);
+        CHECK(*e == *c);
+        CHECK(evicted == VirtualTileCache::kNoTile);
+    }
+}
+
+TEST_CASE("VirtualTileCache keeps slots used by frames in flight") {
+    VirtualTileCache cache(2, 3);
+    uint32_t evicted = 0;
+    const auto a = cache.allocate(100, 10, evicted);
+    const auto b = cache.allocate(101, 11, evicted);
+    REQUIRE(a);
+    REQUIRE(b);
+
+    // Frame 12 may still be drawing with a (frame 10) and b (frame 11).
+    CHECK_FALSE(cache.allocate(102, 12, evicted));
+    CHECK(evicted == VirtualTileCache::kNoTile);
+
+    // By frame 13 the frame that used a has completed; b is still in flight.
+    const auto c = cache.allocate(102, 13, evicted);
+    REQUIRE(c);
+    CHECK(*c == *a);
+    CHECK(evicted == 100);
+    CHECK_FALSE(cache.allocate(103, 13, evicted));
+
+    // b and c were both last used by frame 13, so neither goes before
+    // frame 16; c was touched first.
+    cache.touch(*b, 13);
+    CHECK_FALSE(cache.allocate(103, 15, evicted));
+    const auto d = cache.allocate(103, 16, evicted);
+    REQUIRE(d);
+    CHECK(*d == *c);
+    CHECK(evicted == 102);
+}
@@ -0,0 +1,101 @@
+#include <doctest/doctest.h>
+#include "pnkr/renderer/ZstdLevelStream.hpp"
+
+#include <zstd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace pnkr;
+using namespace pnkr::renderer;
+
+namespace {
+    std::vector<uint8_t> makeLevel(size_t size, uint32_t seed) {
+        // Runs of repeated bytes so the level actually compresses.
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i) {
+            if (i % 61 == 0) {
+                seed = seed * 1664525U + 1013904223U;
+            }
+            bytes[i] = static_cast<uint8_t>(seed >> 24);
+        }
+        return bytes;
+    }
+
+    std::vector<uint8_t> compress(const std::vector<uint8_t>& bytes) {
+        std::vector<uint8_t> out(ZSTD_compressBound(bytes.size()));
+        const size_t size = ZSTD_compress(out.data(), out.size(), bytes.data(), bytes.size(), 3);
+        REQUIRE(ZSTD_isError(size) == 0U);
+        out.resize(size);
+        return out;
+    }
+}
+
+TEST_CASE("ZstdLevelStream inflates levels in chunks") {
+    const auto level0 = makeLevel(1024 * 1024 + 300, 1);
+    const auto level1 = makeLevel(200 * 1000, 2);
+    const auto packed0 = compress(level0);
+    const auto packed1 = compress(level1);
+
+    // A fake KTX2 layout: a header, then each supercompressed level.
+    const uint64_t offset0 = 80;
+    const uint64_t offset1 = offset0 + packed0.size();
+    const std::string path = (std::filesystem::temp_directory_path() / "pnkr_test_zstd_levels.bin").string();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        const std::vector<char> header(offset0, 'K');
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out.write(reinterpret_cast<const char*>(packed0.data()), static_cast<std::streamsize>(packed0.size()));
+        out.write(reinterpret_cast<const char*>(packed1.data()), static_cast<std::streamsize>(packed1.size()));
+    }
+
+    auto reader = core::FileReader::create(core::FileReaderBackend::Blocking);
+    ZstdLevelStream stream(*reader);
+    const ZstdLevelStream::Level first{path, 0, offset0, packed0.size()};
+    const ZstdLevelStream::Level second{path, 1, offset1, packed1.size()};
+
+    SUBCASE("Sequential chunks of uneven size") {
+        std::vector<uint8_t> out(level0.size());
+        uint64_t done = 0;
+        uint64_t chunk = 1;
+        while (done < out.size()) {
+            const uint64_t size = std::min<uint64_t>(chunk, out.size() - done);
+            REQUIRE(stream.read(first, done, std::span(out).subspan(done, size)));
+            done += size;
+            chunk = chunk * 3 + 7;
+        }
+        CHECK(out == level0);
+        CHECK(stream.bytesInflated() == level0.size());
+        CHECK(stream.levelRestarts() == 0);
+    }
+
+    SUBCASE("Switching level or seeking back restarts the level") {
+        std::vector<uint8_t> out(4096);
+        REQUIRE(stream.read(second, 10000, out));
+        CHECK(std::equal(out.begin(), out.end(), level1.begin() + 10000));
+
+        REQUIRE(stream.read(first, 500000, out));
+        CHECK(std::equal(out.begin(), out.end(), level0.begin() + 500000));
+
+        REQUIRE(stream.read(first, 100, out));
+        CHECK(std::equal(out.begin(), out.end(), level0.begin() + 100));
+        CHECK(stream.levelRestarts() == 2);
+    }
+
+    SUBCASE("Reading past the level or a truncated level fails") {
+        std::vector<uint8_t> out(64);
+        CHECK_FALSE(stream.read(second, level1.size() - 32, out));
+
+        const ZstdLevelStream::Level truncated{path, 0, offset0, packed0.size() / 2};
+        std::vector<uint8_t> all(level0.size());
+        CHECK_FALSE(stream.read(truncated, 0, all));
+
+        // The stream recovers on the next valid request.
+        REQUIRE(stream.read(second, 0, out));
+        CHECK(std::equal(out.begin(), out.end(), level1.begin()));
+    }
+
+    std::filesystem::remove(path);
+}